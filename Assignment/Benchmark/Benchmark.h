@@ -0,0 +1,124 @@
+//--------------------------------------------------------------------------------------
+// Benchmark support - timing, allocation tracking and JSON output shared by all benchmarks
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_BENCHMARK_H_INCLUDED
+#define CO2409_BENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <string>
+#include <stdio.h>
+using namespace std;
+
+//--------------------------------------------------------------------------------------
+// Allocation tracking
+//--------------------------------------------------------------------------------------
+// Every call to the global operator new/delete in the benchmark executable is counted (see
+// BenchmarkMain.cpp), so each benchmark can report allocations and peak heap use per case
+
+struct AllocStats
+{
+	unsigned long long allocations; // Number of allocations since last reset
+	unsigned long long bytes;       // Bytes currently allocated
+	unsigned long long peakBytes;   // Most bytes allocated at one time since last reset
+};
+
+// Get allocation statistics since the last reset
+AllocStats GetAllocStats();
+
+// Reset the allocation count to zero and the peak to the bytes currently allocated
+void ResetAllocStats();
+
+
+//--------------------------------------------------------------------------------------
+// Timing
+//--------------------------------------------------------------------------------------
+
+// Simple stopwatch, starts on construction
+class BenchTimer
+{
+public:
+	BenchTimer() { Reset(); }
+
+	// Restart timing from zero
+	void Reset() { mStart = chrono::high_resolution_clock::now(); }
+
+	// Seconds passed since construction or last reset
+	double Seconds() const
+	{
+		return chrono::duration<double>( chrono::high_resolution_clock::now() - mStart ).count();
+	}
+
+private:
+	chrono::high_resolution_clock::time_point mStart;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Results output
+//--------------------------------------------------------------------------------------
+// Results are written as a single JSON object: { "benchmarks": [ { record }, ... ] }, where each
+// record is a flat set of named values for one benchmark case. Flat records keep the output easy
+// to compare between runs to track regressions
+
+class JsonWriter
+{
+public:
+	// Write to an already open file (e.g. stdout)
+	JsonWriter( FILE* file );
+
+	// Close the list of records - must be called once all benchmarks have run
+	void Finish();
+
+	// Start/end a record, named by its benchmark suite and case. Fields are added in between
+	void BeginRecord( const string& suite, const string& name );
+	void EndRecord();
+
+	// Add named fields to the current record
+	void Field( const string& key, double value );
+	void Field( const string& key, unsigned long long value );
+	void Field( const string& key, const string& value );
+	void Field( const string& key, bool value );
+
+private:
+	void Key( const string& key );
+
+	FILE* mFile;
+	bool  mFirstRecord;
+	bool  mFirstField;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Benchmark suites
+//--------------------------------------------------------------------------------------
+// Each suite runs all its cases and writes one record per case
+
+// Importer stages (parse, face list matching, mesh splitting, tangents, adjacency, interleave)
+// for the project's .X files and synthetic meshes, and silhouette edge extraction (checked against
+// a per-face loop) on imported models
+void RunImportBenchmark( JsonWriter& json );
+
+// Texture file decoding for the project's textures, single files and the whole set in parallel
+void RunTextureBenchmark( JsonWriter& json );
+
+// Block compression quality (PSNR, normal angle error) and speed for the project's texture maps
+void RunCompressBenchmark( JsonWriter& json );
+
+// CMatrix4x4 multiply, transform, transpose and inverse - SIMD against the original scalar code
+void RunMatrixBenchmark( JsonWriter& json );
+
+// Polynomial sin, cos, atan2, exp, log and 1/sqrt (FastMath.h) - speed and error against <math.h>
+void RunFastMathBenchmark( JsonWriter& json );
+
+// Latency, throughput and batch throughput of the hot operations of the maths library (matrices,
+// quaternions, vectors, 1/sqrt, sin/cos) - compare builds with and without SIMD
+void RunMathBenchmark( JsonWriter& json );
+
+// Entity store transform updates, render gathering and entity replacement for a scene of tens of
+// thousands of objects, against separately allocated objects
+void RunSceneBenchmark( JsonWriter& json );
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,231 @@
+//--------------------------------------------------------------------------------------
+// File: BenchmarkMain.cpp
+//
+// Command line benchmark runner - selects benchmark suites and writes their results as JSON
+//    Usage: Benchmark [suite ...] [-o results.json]
+// Runs all suites if none are named. Results go to stdout unless an output file is given
+// Run from the project folder so the model and texture files are found
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+//--------------------------------------------------------------------------------------
+// Allocation tracking
+//--------------------------------------------------------------------------------------
+
+// Counters updated by every allocation in the process (may be from several threads)
+static atomic<unsigned long long> AllocCount( 0 );
+static atomic<unsigned long long> AllocBytes( 0 );
+static atomic<unsigned long long> AllocPeakBytes( 0 );
+
+// Each allocation is prefixed with its size so delete can update the byte count. The prefix is
+// 16 bytes to keep the returned memory as aligned as malloc would have made it
+static const size_t kAllocHeader = 16;
+
+void* operator new( size_t size )
+{
+	unsigned char* block = static_cast<unsigned char*>(malloc( size + kAllocHeader ));
+	if (!block)
+	{
+		throw bad_alloc();
+	}
+	*reinterpret_cast<size_t*>(block) = size;
+
+	++AllocCount;
+	unsigned long long bytes = (AllocBytes += size);
+	unsigned long long peak = AllocPeakBytes;
+	while (bytes > peak && !AllocPeakBytes.compare_exchange_weak( peak, bytes )) {}
+
+	return block + kAllocHeader;
+}
+
+void operator delete( void* memory ) noexcept
+{
+	if (!memory)
+	{
+		return;
+	}
+	unsigned char* block = static_cast<unsigned char*>(memory) - kAllocHeader;
+	AllocBytes -= *reinterpret_cast<size_t*>(block);
+	free( block );
+}
+
+// Array and sized forms use the same tracking - the size prefix is used rather than the size given
+void* operator new[]( size_t size )    { return operator new( size ); }
+void operator delete[]( void* memory ) noexcept { operator delete( memory ); }
+void operator delete( void* memory, size_t ) noexcept   { operator delete( memory ); }
+void operator delete[]( void* memory, size_t ) noexcept { operator delete( memory ); }
+
+// Get allocation statistics since the last reset
+AllocStats GetAllocStats()
+{
+	AllocStats stats;
+	stats.allocations = AllocCount;
+	stats.bytes = AllocBytes;
+	stats.peakBytes = AllocPeakBytes;
+	return stats;
+}
+
+// Reset the allocation count to zero and the peak to the bytes currently allocated
+void ResetAllocStats()
+{
+	AllocCount = 0;
+	AllocPeakBytes = AllocBytes.load();
+}
+
+
+//--------------------------------------------------------------------------------------
+// JSON output
+//--------------------------------------------------------------------------------------
+
+JsonWriter::JsonWriter( FILE* file )
+{
+	mFile = file;
+	mFirstRecord = true;
+	mFirstField = true;
+	fprintf( mFile, "{\n  \"benchmarks\": [" );
+}
+
+// Close the list of records - must be called once all benchmarks have run
+void JsonWriter::Finish()
+{
+	fprintf( mFile, "\n  ]\n}\n" );
+	fflush( mFile );
+}
+
+// Start a record, named by its benchmark suite and case
+void JsonWriter::BeginRecord( const string& suite, const string& name )
+{
+	fprintf( mFile, mFirstRecord ? "\n    {" : ",\n    {" );
+	mFirstRecord = false;
+	mFirstField = true;
+	Field( "suite", suite );
+	Field( "name", name );
+}
+
+void JsonWriter::EndRecord()
+{
+	fprintf( mFile, " }" );
+	fflush( mFile ); // Keep partial results if a later case crashes or is killed
+}
+
+// Add named fields to the current record
+void JsonWriter::Field( const string& key, double value )
+{
+	Key( key );
+	fprintf( mFile, "%.9g", value );
+}
+void JsonWriter::Field( const string& key, unsigned long long value )
+{
+	Key( key );
+	fprintf( mFile, "%llu", value );
+}
+void JsonWriter::Field( const string& key, bool value )
+{
+	Key( key );
+	fprintf( mFile, value ? "true" : "false" );
+}
+void JsonWriter::Field( const string& key, const string& value )
+{
+	Key( key );
+	fputc( '"', mFile );
+	for (size_t i = 0; i < value.length(); ++i)
+	{
+		// Names are file names and identifiers, only need to escape the path separators and quotes
+		if (value[i] == '\\' || value[i] == '"')  fputc( '\\', mFile );
+		fputc( value[i], mFile );
+	}
+	fputc( '"', mFile );
+}
+
+void JsonWriter::Key( const string& key )
+{
+	fprintf( mFile, mFirstField ? " \"%s\": " : ", \"%s\": ", key.c_str() );
+	mFirstField = false;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point
+//--------------------------------------------------------------------------------------
+
+// Table of available benchmark suites
+struct BenchmarkSuite
+{
+	const char* name;
+	void (*run)( JsonWriter& json );
+};
+static const BenchmarkSuite Suites[] =
+{
+#if defined(_WIN32) // The .X file importer uses DirectX
+	{ "import",   RunImportBenchmark },
+#endif
+	{ "texture",  RunTextureBenchmark },
+	{ "compress", RunCompressBenchmark },
+	{ "matrix",   RunMatrixBenchmark },
+	{ "fastmath", RunFastMathBenchmark },
+	{ "math",     RunMathBenchmark },
+	{ "scene",    RunSceneBenchmark },
+};
+static const int SUITE_COUNT = sizeof(Suites) / sizeof(Suites[0]);
+
+int main( int argc, char* argv[] )
+{
+	// Read command line - suite names and optional output file
+	bool runSuite[SUITE_COUNT] = {};
+	bool anySuite = false;
+	const char* outputName = NULL;
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (strcmp( argv[arg], "-o" ) == 0 && arg + 1 < argc)
+		{
+			outputName = argv[++arg];
+			continue;
+		}
+
+		bool found = false;
+		for (int i = 0; i < SUITE_COUNT; ++i)
+		{
+			if (strcmp( argv[arg], Suites[i].name ) == 0)
+			{
+				runSuite[i] = found = anySuite = true;
+			}
+		}
+		if (!found)
+		{
+			fprintf( stderr, "Unknown benchmark suite '%s'. Available suites:", argv[arg] );
+			for (int i = 0; i < SUITE_COUNT; ++i)  fprintf( stderr, " %s", Suites[i].name );
+			fprintf( stderr, "\n" );
+			return EXIT_FAILURE;
+		}
+	}
+
+	FILE* output = stdout;
+	if (outputName)
+	{
+		output = fopen( outputName, "w" );
+		if (!output)
+		{
+			fprintf( stderr, "Cannot open output file '%s'\n", outputName );
+			return EXIT_FAILURE;
+		}
+	}
+
+	JsonWriter json( output );
+	for (int i = 0; i < SUITE_COUNT; ++i)
+	{
+		if (!anySuite || runSuite[i])
+		{
+			fprintf( stderr, "Running %s benchmarks...\n", Suites[i].name );
+			Suites[i].run( json );
+		}
+	}
+	json.Finish();
+
+	if (output != stdout)  fclose( output );
+	return EXIT_SUCCESS;
+}
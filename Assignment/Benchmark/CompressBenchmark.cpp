@@ -0,0 +1,170 @@
+//--------------------------------------------------------------------------------------
+// Texture compression benchmark - quality and speed of block compressing the project's
+// diffuse/specular maps (BC3/BC1) and normal/depth maps (BC5 + BC4)
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "ImageCompress.h"
+#include <math.h>
+#include <thread>
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Project texture maps to compress (paths relative to the working directory - the project folder)
+static const char* DiffuseSpecularFiles[] =
+{
+	"BrainDiffuseSpecular.dds", "CobbleDiffuseSpecular.dds", "PatternDiffuseSpecular.dds", "TechDiffuseSpecular.dds",
+	"WallDiffuseSpecular.dds", "brick1.jpg", "Moogle.png",
+};
+static const int DIFFUSE_SPECULAR_FILE_COUNT = sizeof(DiffuseSpecularFiles) / sizeof(DiffuseSpecularFiles[0]);
+
+static const char* NormalDepthFiles[] =
+{
+	"BrainNormalDepth.dds", "CobbleNormalDepth.dds", "PatternNormalDepth.dds", "TechNormalDepth.dds", "WallNormalDepth.dds",
+};
+static const int NORMAL_DEPTH_FILE_COUNT = sizeof(NormalDepthFiles) / sizeof(NormalDepthFiles[0]);
+
+// Each case is repeated to reduce noise, with the fastest time kept
+static const double TARGET_CASE_SECONDS = 1.0;
+static const int    MAX_ITERATIONS = 10;
+
+
+//--------------------------------------------------------------------------------------
+// Helpers
+//--------------------------------------------------------------------------------------
+
+// Time a compression function on one thread and on all hardware threads, keeping the fastest of
+// several runs for each. The function takes the number of threads to use
+template <typename Compress>
+static void TimeCompression( Compress compress, double* singleThread, double* allThreads )
+{
+	unsigned int threadCounts[2] = { 1, thread::hardware_concurrency() };
+	double* results[2] = { singleThread, allThreads };
+	for (int i = 0; i < 2; ++i)
+	{
+		BenchTimer caseTimer;
+		for (int iteration = 0; iteration < MAX_ITERATIONS && (iteration == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+		{
+			BenchTimer timer;
+			compress( threadCounts[i] );
+			double seconds = timer.Seconds();
+			if (iteration == 0 || seconds < *results[i])  *results[i] = seconds;
+		}
+	}
+}
+
+// Number of texels in all mip levels of an image
+static double MipChainTexels( const Image& image )
+{
+	double texels = 0.0;
+	for (size_t mip = 0; mip < image.mips.size(); ++mip)  texels += static_cast<double>(image.mips[mip].width) * image.mips[mip].height;
+	return texels;
+}
+
+// Angle in degrees between the normals in the red and green channels of two RGBA8 images, with z
+// rebuilt as the shader does. The reference is normalised first, the way it is before compression
+static void NormalAngleError( const Image& reference, const Image& test, double* meanAngle, double* maxAngle )
+{
+	const uint8_t* referenceData = reference.MipData( 0 );
+	const uint8_t* testData = test.MipData( 0 );
+	size_t numTexels = static_cast<size_t>(reference.width) * reference.height;
+	double total = 0.0;
+	*maxAngle = 0.0;
+	for (size_t texel = 0; texel < numTexels; ++texel)
+	{
+		const uint8_t* r = referenceData + texel * 4;
+		double x0 = r[0] / 127.5 - 1.0, y0 = r[1] / 127.5 - 1.0, z0 = r[2] / 127.5 - 1.0;
+		double length = sqrt( x0 * x0 + y0 * y0 + z0 * z0 );
+		if (length < 1e-3)  continue;
+		x0 /= length;  y0 /= length;  z0 /= length;
+
+		const uint8_t* t = testData + texel * 4;
+		double x1 = t[0] / 127.5 - 1.0, y1 = t[1] / 127.5 - 1.0;
+		double z1 = sqrt( fmax( 0.0, 1.0 - x1 * x1 - y1 * y1 ) );
+		length = sqrt( x1 * x1 + y1 * y1 + z1 * z1 );
+
+		double cosAngle = (x0 * x1 + y0 * y1 + z0 * z1) / length;
+		double angle = acos( fmin( 1.0, fmax( -1.0, cosAngle ) ) ) * 180.0 / 3.14159265358979;
+		total += angle;
+		if (angle > *maxAngle)  *maxAngle = angle;
+	}
+	*meanAngle = total / numTexels;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunCompressBenchmark( JsonWriter& json )
+{
+	for (int i = 0; i < DIFFUSE_SPECULAR_FILE_COUNT; ++i)
+	{
+		Image source, original, compressed, decompressed;
+		string error;
+		json.BeginRecord( "compress", DiffuseSpecularFiles[i] );
+		bool success = LoadImageFile( DiffuseSpecularFiles[i], &source, &error ) && DecompressImage( source, &original ) &&
+		               CompressDiffuseSpecular( original, &compressed ) && DecompressImage( compressed, &decompressed );
+		json.Field( "success", success );
+		if (success)
+		{
+			double singleThread = 0.0, allThreads = 0.0;
+			TimeCompression( [&]( unsigned int threads ) { CompressDiffuseSpecular( original, &compressed, threads ); }, &singleThread, &allThreads );
+
+			json.Field( "format", string(compressed.format == ImageFormatBC1 ? "BC1" : compressed.format == ImageFormatBC3 ? "BC3" : "RGBA8") );
+			json.Field( "width", static_cast<unsigned long long>(original.width) );
+			json.Field( "height", static_cast<unsigned long long>(original.height) );
+			json.Field( "uncompressed_bytes", static_cast<unsigned long long>(original.mips[0].size * 4 / 3) ); // With mips
+			json.Field( "compressed_bytes", static_cast<unsigned long long>(compressed.data.size()) );
+			json.Field( "psnr_rgb", ImagePSNR( original, 0, decompressed, 0, 3 ) );
+			json.Field( "psnr_specular", ImagePSNR( original, 3, decompressed, 3, 1 ) );
+			json.Field( "single_thread_s", singleThread );
+			json.Field( "all_threads_s", allThreads );
+			json.Field( "threads", static_cast<unsigned long long>(thread::hardware_concurrency()) );
+			json.Field( "mpixels_per_s", MipChainTexels( compressed ) / allThreads / 1e6 );
+		}
+		else
+		{
+			json.Field( "error", error );
+		}
+		json.EndRecord();
+	}
+
+	for (int i = 0; i < NORMAL_DEPTH_FILE_COUNT; ++i)
+	{
+		Image source, original, normals, depths, decompressedNormals, decompressedDepths;
+		string error;
+		json.BeginRecord( "compress", NormalDepthFiles[i] );
+		bool success = LoadImageFile( NormalDepthFiles[i], &source, &error ) && DecompressImage( source, &original ) &&
+		               CompressNormalDepth( original, &normals, &depths ) &&
+		               DecompressImage( normals, &decompressedNormals ) && DecompressImage( depths, &decompressedDepths );
+		json.Field( "success", success );
+		if (success)
+		{
+			double singleThread = 0.0, allThreads = 0.0;
+			TimeCompression( [&]( unsigned int threads ) { CompressNormalDepth( original, &normals, &depths, threads ); }, &singleThread, &allThreads );
+
+			double meanAngle, maxAngle;
+			NormalAngleError( original, decompressedNormals, &meanAngle, &maxAngle );
+			json.Field( "format", string("BC5+BC4") );
+			json.Field( "width", static_cast<unsigned long long>(original.width) );
+			json.Field( "height", static_cast<unsigned long long>(original.height) );
+			json.Field( "uncompressed_bytes", static_cast<unsigned long long>(original.mips[0].size * 4 / 3) );
+			json.Field( "compressed_bytes", static_cast<unsigned long long>(normals.data.size() + depths.data.size()) );
+			json.Field( "normal_mean_angle_deg", meanAngle );
+			json.Field( "normal_max_angle_deg", maxAngle );
+			json.Field( "psnr_depth", ImagePSNR( original, 3, decompressedDepths, 0, 1 ) );
+			json.Field( "single_thread_s", singleThread );
+			json.Field( "all_threads_s", allThreads );
+			json.Field( "threads", static_cast<unsigned long long>(thread::hardware_concurrency()) );
+			json.Field( "mpixels_per_s", MipChainTexels( normals ) / allThreads / 1e6 );
+		}
+		else
+		{
+			json.Field( "error", error );
+		}
+		json.EndRecord();
+	}
+}
@@ -0,0 +1,200 @@
+//--------------------------------------------------------------------------------------
+// Fast math benchmark - speed of the polynomial approximations in FastMath.h against the
+// <math.h> functions they replace, with their largest error in ULP and relative to the result
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "FastMath.h"
+#include <math.h>
+#include <float.h>
+#include <vector>
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Number of values operated on in each pass, small enough that the inputs and outputs stay in the
+// cache so the arithmetic is measured rather than memory speed
+static const int NUM_VALUES = 4096;
+
+// Each case is repeated to reduce noise, with the fastest pass kept. Each pass runs the operation
+// on all values several times so it is long enough to time accurately
+static const double TARGET_CASE_SECONDS = 0.25;
+static const int    MAX_ITERATIONS = 1000;
+static const int    REPEATS_PER_PASS = 16;
+
+
+//--------------------------------------------------------------------------------------
+// Support functions
+//--------------------------------------------------------------------------------------
+
+// Fill a list with random values in the given range
+static void RandomValues( vector<TFloat32>& values, TFloat32 min, TFloat32 max )
+{
+	for (size_t i = 0; i < values.size(); ++i)  values[i] = Random( min, max );
+}
+
+// Fill a list with random positive values spread evenly over powers of ten in the given range
+static void RandomPositiveValues( vector<TFloat32>& values, TFloat32 minPower, TFloat32 maxPower )
+{
+	for (size_t i = 0; i < values.size(); ++i)  values[i] = powf( 10.0f, Random( minPower, maxPower ) );
+}
+
+// Size of one unit in the last place of a float near the given value
+static double Ulp( double value )
+{
+	float f = fabsf( static_cast<float>(value) );
+	if (f < FLT_MIN)  f = FLT_MIN;
+	return nextafterf( f, FLT_MAX ) - f;
+}
+
+// Largest error of a list of results against double precision reference results, in ULP and relative
+// to the reference. Results smaller than minResult are skipped - sin & cos lose relative precision
+// close to their zeros, as the reference does
+struct SError
+{
+	double ulp;
+	double relative;
+};
+static SError MaxError( const vector<double>& reference, const vector<TFloat32>& test, double minResult = 0.0 )
+{
+	SError maxError = { 0.0, 0.0 };
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		if (fabs( reference[i] ) < minResult || reference[i] == 0.0)  continue;
+		double error = fabs( test[i] - reference[i] );
+		maxError.ulp = fmax( maxError.ulp, error / Ulp( reference[i] ) );
+		maxError.relative = fmax( maxError.relative, error / fabs( reference[i] ) );
+	}
+	return maxError;
+}
+
+// Fastest time in nanoseconds to run an operation on all values, divided by the number of values
+template <typename Operation>
+static double TimePerValue( Operation operation )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int iteration = 0; iteration < MAX_ITERATIONS && (iteration == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+	{
+		BenchTimer timer;
+		for (int repeat = 0; repeat < REPEATS_PER_PASS; ++repeat)  operation();
+		double seconds = timer.Seconds();
+		if (iteration == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / (static_cast<double>(REPEATS_PER_PASS) * NUM_VALUES);
+}
+
+// Write a record comparing the <math.h> and fast versions of a function
+static void WriteRecord( JsonWriter& json, const string& name, double libNs, double fastNs, SError maxError )
+{
+#if defined(GEN_SIMD_AVX) && defined(GEN_SIMD_FMA)
+	const char* simd = "AVX+FMA";
+#elif defined(GEN_SIMD_AVX)
+	const char* simd = "AVX";
+#elif defined(GEN_SIMD_FMA)
+	const char* simd = "SSE+FMA";
+#elif defined(GEN_SIMD_SSE)
+	const char* simd = "SSE";
+#elif defined(GEN_SIMD_NEON)
+	const char* simd = "NEON";
+#else
+	const char* simd = "None";
+#endif
+	json.BeginRecord( "fastmath", name );
+	json.Field( "simd", string(simd) );
+	json.Field( "lib_ns", libNs );
+	json.Field( "fast_ns", fastNs );
+	json.Field( "speedup", libNs / fastNs );
+	json.Field( "max_ulp_error", maxError.ulp );
+	json.Field( "max_relative_error", maxError.relative );
+	json.EndRecord();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunFastMathBenchmark( JsonWriter& json )
+{
+	srand( 1 );
+	vector<TFloat32> x( NUM_VALUES ), y( NUM_VALUES ), libOut( NUM_VALUES ), fastOut( NUM_VALUES ), fastOut2( NUM_VALUES );
+	vector<double> reference( NUM_VALUES ), reference2( NUM_VALUES );
+	const char* tierNames[] = { "_fast", "_full" };
+	const EMathPrecision tiers[] = { kPrecisionFast, kPrecisionFull };
+	double libNs, fastNs;
+
+	// Sin and sin/cos together, over many turns
+	RandomValues( x, -100.0f, 100.0f );
+	for (int i = 0; i < NUM_VALUES; ++i)
+	{
+		reference[i] = sin( static_cast<double>(x[i]) );
+		reference2[i] = cos( static_cast<double>(x[i]) );
+	}
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  libOut[i] = Sin( x[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { SinArray( &x[0], &fastOut[0], NUM_VALUES, tiers[tier] ); } );
+		WriteRecord( json, string("sin") + tierNames[tier], libNs, fastNs, MaxError( reference, fastOut, 0.001 ) );
+	}
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  SinCos( x[i], &libOut[i], &fastOut2[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { SinCosArray( &x[0], &fastOut[0], &fastOut2[0], NUM_VALUES, tiers[tier] ); } );
+		SError sinError = MaxError( reference, fastOut, 0.001 );
+		SError cosError = MaxError( reference2, fastOut2, 0.001 );
+		SError maxError = { fmax( sinError.ulp, cosError.ulp ), fmax( sinError.relative, cosError.relative ) };
+		WriteRecord( json, string("sincos") + tierNames[tier], libNs, fastNs, maxError );
+	}
+
+	// ATan2 of points in all quadrants
+	RandomValues( x, -100.0f, 100.0f );
+	RandomValues( y, -100.0f, 100.0f );
+	for (int i = 0; i < NUM_VALUES; ++i)  reference[i] = atan2( static_cast<double>(y[i]), static_cast<double>(x[i]) );
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  libOut[i] = atan2f( y[i], x[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { ATan2Array( &y[0], &x[0], &fastOut[0], NUM_VALUES, tiers[tier] ); } );
+		WriteRecord( json, string("atan2") + tierNames[tier], libNs, fastNs, MaxError( reference, fastOut ) );
+	}
+
+	// Exp over most of the float range
+	RandomValues( x, -80.0f, 80.0f );
+	for (int i = 0; i < NUM_VALUES; ++i)  reference[i] = exp( static_cast<double>(x[i]) );
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  libOut[i] = expf( x[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { ExpArray( &x[0], &fastOut[0], NUM_VALUES, tiers[tier] ); } );
+		WriteRecord( json, string("exp") + tierNames[tier], libNs, fastNs, MaxError( reference, fastOut ) );
+	}
+
+	// Log and 1 / sqrt over most of the float range
+	RandomPositiveValues( x, -30.0f, 30.0f );
+	for (int i = 0; i < NUM_VALUES; ++i)  reference[i] = log( static_cast<double>(x[i]) );
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  libOut[i] = logf( x[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { LogArray( &x[0], &fastOut[0], NUM_VALUES, tiers[tier] ); } );
+		WriteRecord( json, string("log") + tierNames[tier], libNs, fastNs, MaxError( reference, fastOut ) );
+	}
+
+	for (int i = 0; i < NUM_VALUES; ++i)  reference[i] = 1.0 / sqrt( static_cast<double>(x[i]) );
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  libOut[i] = InvSqrt( x[i] ); } );
+	for (int tier = 0; tier < 2; ++tier)
+	{
+		fastNs = TimePerValue( [&]() { InvSqrtArray( &x[0], &fastOut[0], NUM_VALUES, tiers[tier] ); } );
+		WriteRecord( json, string("invsqrt") + tierNames[tier], libNs, fastNs, MaxError( reference, fastOut ) );
+	}
+
+	// Scalar fast paths against the BaseMath.h functions, one value at a time
+	fastNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  fastOut[i] = InvSqrtFast( x[i] ); } );
+	WriteRecord( json, "invsqrt_scalar", libNs, fastNs, MaxError( reference, fastOut ) );
+
+	RandomValues( x, -100.0f, 100.0f );
+	for (int i = 0; i < NUM_VALUES; ++i)  reference[i] = sin( static_cast<double>(x[i]) );
+	libNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  SinCos( x[i], &libOut[i], &fastOut2[i] ); } );
+	fastNs = TimePerValue( [&]() { for (int i = 0; i < NUM_VALUES; ++i)  SinCosFast( x[i], &fastOut[i], &fastOut2[i] ); } );
+	WriteRecord( json, "sincos_scalar", libNs, fastNs, MaxError( reference, fastOut, 0.001 ) );
+}
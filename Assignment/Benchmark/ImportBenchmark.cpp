@@ -0,0 +1,493 @@
+//--------------------------------------------------------------------------------------
+// Importer benchmark - time each stage of CImportXFile on the project's .X files and on
+// synthetic meshes from 1k to 1M triangles, and silhouette edge extraction from the
+// imported meshes against a per-face loop
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "CImportXFile.h"
+#include "CSilhouetteEdges.h"
+#include <math.h>
+#include <vector>
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Project models to import (paths relative to the working directory - the project folder)
+static const char* ImportFiles[] = { "Cube.x", "Sphere.x", "Teapot.x", "Hills.x", "Troll.x" };
+static const int IMPORT_FILE_COUNT = sizeof(ImportFiles) / sizeof(ImportFiles[0]);
+
+// Sizes of synthetic meshes, in triangles
+static const unsigned int SyntheticSizes[] = { 1000, 10000, 100000, 1000000 };
+static const int SYNTHETIC_SIZE_COUNT = sizeof(SyntheticSizes) / sizeof(SyntheticSizes[0]);
+
+// Synthetic meshes are built from square grid patches, each a separate mesh in the file. Sub-meshes
+// use 16-bit indices so a patch must stay under 65536 vertices. 64x64 quads = 8192 triangles
+static const unsigned int PATCH_QUADS = 64;
+
+// Adjacency calculation is brute force (quadratic in faces per mesh), so it is only run up to this
+// size. Larger cases are still reported, but with the adjacency stage marked as skipped
+static const unsigned int MAX_ADJACENCY_TRIANGLES = 100000;
+
+// Each case is repeated to reduce noise, with the fastest time kept for each stage. Fewer repeats
+// for larger meshes keep the total run time reasonable
+static const double TARGET_CASE_SECONDS = 1.0;
+static const int    MAX_ITERATIONS = 20;
+
+// Project models to find silhouette edges on, and the number of lights each is tested against. The
+// lights are spread around the model, the last one directional
+static const char* SilhouetteFiles[] = { "Teapot.x", "Troll.x" };
+static const int SILHOUETTE_FILE_COUNT = sizeof(SilhouetteFiles) / sizeof(SilhouetteFiles[0]);
+static const int SILHOUETTE_LIGHTS = 16;
+
+
+//--------------------------------------------------------------------------------------
+// Synthetic meshes
+//--------------------------------------------------------------------------------------
+
+// Write a text .X file containing a flat grid of about the given number of triangles, with normals,
+// UVs and one material, split into patches of up to PATCH_QUADS x PATCH_QUADS quads
+static bool WriteSyntheticMesh( const string& fileName, unsigned int triangles )
+{
+	FILE* file = fopen( fileName.c_str(), "w" );
+	if (!file)
+	{
+		return false;
+	}
+	fprintf( file, "xof 0303txt 0032\n\n" );
+
+	unsigned int quadsLeft = (triangles + 1) / 2;
+	unsigned int patch = 0;
+	while (quadsLeft > 0)
+	{
+		// Patch dimensions in quads - full width rows up to a square, any remainder of less than a
+		// row goes in a final single-row patch
+		unsigned int width = PATCH_QUADS;
+		unsigned int rows = quadsLeft / width;
+		if (rows > PATCH_QUADS)  rows = PATCH_QUADS;
+		if (rows == 0)
+		{
+			width = quadsLeft;
+			rows = 1;
+		}
+		unsigned int quads = width * rows;
+		unsigned int vertCount = (width + 1) * (rows + 1);
+		float originX = static_cast<float>(patch * PATCH_QUADS);
+
+		fprintf( file, "Mesh patch%u {\n %u;\n", patch, vertCount );
+		for (unsigned int v = 0; v < vertCount; ++v)
+		{
+			unsigned int x = v % (width + 1), z = v / (width + 1);
+			fprintf( file, " %f;0.0;%f;%s\n", originX + x, static_cast<float>(z), v + 1 < vertCount ? "," : ";" );
+		}
+
+		fprintf( file, " %u;\n", quads * 2 );
+		for (unsigned int q = 0; q < quads; ++q)
+		{
+			unsigned int x = q % width, z = q / width;
+			unsigned int i0 = z * (width + 1) + x, i1 = i0 + 1, i2 = i0 + width + 1, i3 = i2 + 1;
+			fprintf( file, " 3;%u,%u,%u;,\n 3;%u,%u,%u;%s\n", i0, i2, i1, i1, i2, i3, q + 1 < quads ? "," : ";" );
+		}
+
+		// Single shared normal, so normal faces all index it
+		fprintf( file, " MeshNormals {\n  1;\n  0.0;1.0;0.0;;\n  %u;\n", quads * 2 );
+		for (unsigned int f = 0; f < quads * 2; ++f)
+		{
+			fprintf( file, "  3;0,0,0;%s\n", f + 1 < quads * 2 ? "," : ";" );
+		}
+		fprintf( file, " }\n" );
+
+		fprintf( file, " MeshTextureCoords {\n  %u;\n", vertCount );
+		for (unsigned int v = 0; v < vertCount; ++v)
+		{
+			unsigned int x = v % (width + 1), z = v / (width + 1);
+			fprintf( file, "  %f;%f;%s\n", static_cast<float>(x) / width, static_cast<float>(z) / rows, v + 1 < vertCount ? "," : ";" );
+		}
+		fprintf( file, " }\n" );
+
+		fprintf( file, " MeshMaterialList {\n  1;\n  1;\n  0;\n  Material {\n   1.0;1.0;1.0;1.0;;\n   0.0;\n   0.0;0.0;0.0;;\n   0.0;0.0;0.0;;\n  }\n }\n}\n" );
+
+		quadsLeft -= quads;
+		++patch;
+	}
+
+	fclose( file );
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Import timing
+//--------------------------------------------------------------------------------------
+
+// Totals for one complete import of a file (ImportFile followed by GetSubMesh on every sub-mesh)
+struct ImportResult
+{
+	bool               success;
+	unsigned long long triangles;
+	unsigned long long vertices;
+	double             parse, matchFaceLists, splitMeshes, tangents, adjacency, interleave, total;
+	AllocStats         allocs;
+};
+
+// Import the given file once with the given options, collecting stage timings and allocations
+static ImportResult ImportOnce( const string& fileName, bool tangents, bool adjacency )
+{
+	ImportResult result = {};
+	ResetAllocStats();
+	BenchTimer timer;
+
+	gen::CImportXFile mesh;
+	if (mesh.ImportFile( fileName, adjacency ) != gen::kSuccess)
+	{
+		return result;
+	}
+	const gen::SImportTimings& timings = mesh.GetTimings();
+	result.parse = timings.fParse;
+	result.matchFaceLists = timings.fMatchFaceLists;
+	result.splitMeshes = timings.fSplitMeshes;
+	result.adjacency = timings.fAdjacency;
+
+	for (gen::TUInt32 i = 0; i < mesh.GetNumSubMeshes(); ++i)
+	{
+		gen::SSubMesh subMesh;
+		if (mesh.GetSubMesh( i, &subMesh, tangents, adjacency ) != gen::kSuccess)
+		{
+			return result;
+		}
+		result.tangents += timings.fTangents;
+		result.interleave += timings.fInterleave;
+		result.triangles += subMesh.numFaces;
+		result.vertices += subMesh.numVertices;
+
+		// Sub-mesh data is owned by the caller
+		delete[] subMesh.vertices;
+		delete[] subMesh.faces;
+		delete[] subMesh.faceAdjacency;
+	}
+
+	result.total = timer.Seconds();
+	result.allocs = GetAllocStats();
+	result.success = true;
+	return result;
+}
+
+// Import a file repeatedly with the given options and write a result record
+static void BenchmarkFile( JsonWriter& json, const string& name, const string& fileName, bool tangents, bool adjacency )
+{
+	ImportResult best = ImportOnce( fileName, tangents, adjacency );
+	int iterations = 1;
+	if (best.success && best.total > 0.0)
+	{
+		// Repeat, keeping fastest time for each stage. Allocation counts don't vary between runs
+		int repeats = static_cast<int>(TARGET_CASE_SECONDS / best.total);
+		if (repeats > MAX_ITERATIONS - 1)  repeats = MAX_ITERATIONS - 1;
+		for (int i = 0; i < repeats; ++i)
+		{
+			ImportResult result = ImportOnce( fileName, tangents, adjacency );
+			if (result.parse < best.parse)                    best.parse = result.parse;
+			if (result.matchFaceLists < best.matchFaceLists)  best.matchFaceLists = result.matchFaceLists;
+			if (result.splitMeshes < best.splitMeshes)        best.splitMeshes = result.splitMeshes;
+			if (result.tangents < best.tangents)              best.tangents = result.tangents;
+			if (result.adjacency < best.adjacency)            best.adjacency = result.adjacency;
+			if (result.interleave < best.interleave)          best.interleave = result.interleave;
+			if (result.total < best.total)                    best.total = result.total;
+			++iterations;
+		}
+	}
+
+	json.BeginRecord( "import", name );
+	json.Field( "tangents", tangents );
+	json.Field( "adjacency", adjacency );
+	json.Field( "success", best.success );
+	if (best.success)
+	{
+		json.Field( "triangles", best.triangles );
+		json.Field( "vertices", best.vertices );
+		json.Field( "iterations", static_cast<unsigned long long>(iterations) );
+		json.Field( "parse_s", best.parse );
+		json.Field( "match_face_lists_s", best.matchFaceLists );
+		json.Field( "split_meshes_s", best.splitMeshes );
+		json.Field( "tangents_s", best.tangents );
+		json.Field( "adjacency_s", best.adjacency );
+		json.Field( "interleave_s", best.interleave );
+		json.Field( "total_s", best.total );
+		json.Field( "allocations", best.allocs.allocations );
+		json.Field( "peak_bytes", best.allocs.peakBytes );
+	}
+	json.EndRecord();
+}
+
+// Run all four combinations of tangents and adjacency on a file
+static void BenchmarkAllOptions( JsonWriter& json, const string& name, const string& fileName, bool allowAdjacency )
+{
+	for (int tangents = 0; tangents < 2; ++tangents)
+	{
+		BenchmarkFile( json, name, fileName, tangents != 0, false );
+		if (allowAdjacency)
+		{
+			BenchmarkFile( json, name, fileName, tangents != 0, true );
+		}
+		else
+		{
+			json.BeginRecord( "import", name );
+			json.Field( "tangents", tangents != 0 );
+			json.Field( "adjacency", true );
+			json.Field( "skipped", string("adjacency too slow at this size") );
+			json.EndRecord();
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------
+// Silhouette edges
+//--------------------------------------------------------------------------------------
+
+// A face and its neighbours prepared for the per-face silhouette loop: the face's own plane then
+// the plane of the neighbour across each edge, (0,0,0,-1) for open edges. Planes are calculated
+// exactly as CSilhouetteMesh::Prepare does, so the facing tests give identical results
+struct SilhouetteFace
+{
+	gen::CVector4  aPlanes[4];
+	gen::SMeshFace face;
+};
+
+// Prepare the faces of a sub-mesh for the per-face silhouette loop
+static void PrepareSilhouetteFaces( const gen::SSubMesh& subMesh, vector<SilhouetteFace>* faces )
+{
+	faces->resize( subMesh.numFaces );
+	for (gen::TUInt32 iFace = 0; iFace < subMesh.numFaces; ++iFace)
+	{
+		SilhouetteFace& out = (*faces)[iFace];
+		const gen::SMeshFace& face = subMesh.faces[iFace];
+		const gen::SMeshFace& adjacency = subMesh.faceAdjacency[iFace];
+		out.face = face;
+
+		// Planes through three vertices, with normals from the winding of the vertices
+		gen::TUInt16 aiTriangles[4][3] = { { face.aiVertex[0], face.aiVertex[1], face.aiVertex[2] } };
+		for (int iEdge = 0; iEdge < 3; ++iEdge)
+		{
+			aiTriangles[1 + iEdge][0] = face.aiVertex[(iEdge + 1) % 3];
+			aiTriangles[1 + iEdge][1] = face.aiVertex[iEdge];
+			aiTriangles[1 + iEdge][2] = adjacency.aiVertex[iEdge];
+		}
+		for (int iPlane = 0; iPlane < 4; ++iPlane)
+		{
+			if (iPlane > 0 && adjacency.aiVertex[iPlane - 1] == face.aiVertex[iPlane - 1])
+			{
+				out.aPlanes[iPlane] = gen::CVector4( 0.0f, 0.0f, 0.0f, -1.0f ); // Open edge
+				continue;
+			}
+			const gen::CVector3* p[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				p[i] = reinterpret_cast<const gen::CVector3*>(subMesh.vertices + aiTriangles[iPlane][i] * subMesh.vertexSize);
+			}
+			gen::CVector3 normal = gen::Cross( *p[1] - *p[0], *p[2] - *p[0] );
+			out.aPlanes[iPlane] = gen::CVector4( normal, -gen::Dot( normal, *p[0] ) );
+		}
+	}
+}
+
+// Distance of a light from a plane (scaled by the length of the plane normal), summed in the same
+// order as CSilhouetteMesh::FindEdges
+static inline gen::TFloat32 LightDistance( const gen::CVector4& plane, const gen::CVector4& light )
+{
+	return (plane.x * light.x + plane.y * light.y) + (plane.z * light.z + plane.w * light.w);
+}
+
+// Find silhouette edges one face at a time - the loop that CSilhouetteMesh::FindEdges replaces
+static void SilhouetteEdgesPerFace( const vector<SilhouetteFace>& faces, const gen::CVector4& light,
+                                    gen::TSilhouetteEdges* pOutEdges )
+{
+	pOutEdges->clear();
+	for (size_t iFace = 0; iFace < faces.size(); ++iFace)
+	{
+		const SilhouetteFace& face = faces[iFace];
+		if (!(LightDistance( face.aPlanes[0], light ) > 0.0f))  continue;
+		for (int iEdge = 0; iEdge < 3; ++iEdge)
+		{
+			if (!(LightDistance( face.aPlanes[1 + iEdge], light ) > 0.0f))
+			{
+				gen::SSilhouetteEdge edge;
+				edge.aiVertex[0] = face.face.aiVertex[iEdge];
+				edge.aiVertex[1] = face.face.aiVertex[(iEdge + 1) % 3];
+				pOutEdges->push_back( edge );
+			}
+		}
+	}
+}
+
+// Are two lists of silhouette edges the same, in the same order
+static bool SameEdges( const gen::TSilhouetteEdges& a, const gen::TSilhouetteEdges& b )
+{
+	if (a.size() != b.size())  return false;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].aiVertex[0] != b[i].aiVertex[0] || a[i].aiVertex[1] != b[i].aiVertex[1])  return false;
+	}
+	return true;
+}
+
+// Fastest time in seconds to run an operation, repeated for about TARGET_CASE_SECONDS
+template <typename Operation>
+static double FastestTime( Operation operation )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int iteration = 0; iteration == 0 || (iteration < MAX_ITERATIONS * 50 && caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+	{
+		BenchTimer timer;
+		operation();
+		double seconds = timer.Seconds();
+		if (iteration == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest;
+}
+
+// Find the silhouette edges of every sub-mesh of a file from each of a set of lights, with
+// CSilhouetteMesh::FindEdges, with FindSilhouetteEdges (all sub-meshes at once, over threads) and
+// with the per-face loop. Checks all three find the same edges and writes their times
+static void BenchmarkSilhouettes( JsonWriter& json, const string& fileName )
+{
+	json.BeginRecord( "import", "silhouette_" + fileName );
+	gen::CImportXFile mesh;
+	if (mesh.ImportFile( fileName, true ) != gen::kSuccess)
+	{
+		json.Field( "success", false );
+		json.EndRecord();
+		return;
+	}
+
+	// Prepare each sub-mesh for both methods, and find the centre and radius of the whole model
+	gen::TUInt32 numSubMeshes = mesh.GetNumSubMeshes();
+	vector<gen::CSilhouetteMesh> silhouetteMeshes( numSubMeshes );
+	vector<const gen::CSilhouetteMesh*> silhouetteMeshPtrs( numSubMeshes );
+	vector<vector<SilhouetteFace> > perFaceMeshes( numSubMeshes );
+	gen::CVector3 minBound( 1e30f, 1e30f, 1e30f ), maxBound( -1e30f, -1e30f, -1e30f );
+	unsigned long long triangles = 0;
+	for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)
+	{
+		gen::SSubMesh subMesh;
+		if (mesh.GetSubMesh( i, &subMesh, false, true ) != gen::kSuccess || !silhouetteMeshes[i].Prepare( subMesh ))
+		{
+			json.Field( "success", false );
+			json.EndRecord();
+			return;
+		}
+		silhouetteMeshPtrs[i] = &silhouetteMeshes[i];
+		PrepareSilhouetteFaces( subMesh, &perFaceMeshes[i] );
+		triangles += subMesh.numFaces;
+		for (gen::TUInt32 v = 0; v < subMesh.numVertices; ++v)
+		{
+			const gen::CVector3& position = *reinterpret_cast<const gen::CVector3*>(subMesh.vertices + v * subMesh.vertexSize);
+			minBound = gen::CVector3( gen::Min( minBound.x, position.x ), gen::Min( minBound.y, position.y ), gen::Min( minBound.z, position.z ) );
+			maxBound = gen::CVector3( gen::Max( maxBound.x, position.x ), gen::Max( maxBound.y, position.y ), gen::Max( maxBound.z, position.z ) );
+		}
+		delete[] subMesh.vertices;
+		delete[] subMesh.faces;
+		delete[] subMesh.faceAdjacency;
+	}
+	gen::CVector3 centre = (minBound + maxBound) * 0.5f;
+	gen::TFloat32 radius = gen::Length( maxBound - centre );
+
+	// Point lights on a spiral around the model at twice its radius, then one directional light
+	vector<gen::CVector4> lights( SILHOUETTE_LIGHTS );
+	for (int i = 0; i < SILHOUETTE_LIGHTS - 1; ++i)
+	{
+		gen::TFloat32 height = 1.0f - 2.0f * (i + 0.5f) / (SILHOUETTE_LIGHTS - 1);
+		gen::TFloat32 ring = sqrtf( 1.0f - height * height );
+		gen::TFloat32 angle = 2.4f * i;
+		gen::CVector3 direction( ring * cosf( angle ), height, ring * sinf( angle ) );
+		lights[i] = gen::CVector4( centre + direction * (2.0f * radius), 1.0f );
+	}
+	lights[SILHOUETTE_LIGHTS - 1] = gen::CVector4( gen::Normalise( gen::CVector3( 1.0f, 2.0f, -1.5f ) ), 0.0f );
+
+	// Check all methods find the same edges, for every sub-mesh and light
+	unsigned long long edges = 0, mismatches = 0;
+	vector<gen::TSilhouetteEdges> blockEdges( numSubMeshes ), perFaceEdges( numSubMeshes ), batchEdges( numSubMeshes );
+	vector<gen::CVector4> meshLights( numSubMeshes );
+	for (int iLight = 0; iLight < SILHOUETTE_LIGHTS; ++iLight)
+	{
+		for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)  meshLights[i] = lights[iLight];
+		gen::FindSilhouetteEdges( &silhouetteMeshPtrs[0], &meshLights[0], &batchEdges[0], numSubMeshes );
+		for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)
+		{
+			silhouetteMeshes[i].FindEdges( lights[iLight], &blockEdges[i] );
+			SilhouetteEdgesPerFace( perFaceMeshes[i], lights[iLight], &perFaceEdges[i] );
+			if (!SameEdges( blockEdges[i], perFaceEdges[i] ) || !SameEdges( blockEdges[i], batchEdges[i] ))  ++mismatches;
+			edges += blockEdges[i].size();
+		}
+	}
+
+	// Time each method over all lights and sub-meshes
+	double perFaceSeconds = FastestTime( [&]()
+	{
+		for (int iLight = 0; iLight < SILHOUETTE_LIGHTS; ++iLight)
+		{
+			for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)  SilhouetteEdgesPerFace( perFaceMeshes[i], lights[iLight], &perFaceEdges[i] );
+		}
+	} );
+	double blockSeconds = FastestTime( [&]()
+	{
+		for (int iLight = 0; iLight < SILHOUETTE_LIGHTS; ++iLight)
+		{
+			for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)  silhouetteMeshes[i].FindEdges( lights[iLight], &blockEdges[i] );
+		}
+	} );
+	double batchSeconds = FastestTime( [&]()
+	{
+		for (int iLight = 0; iLight < SILHOUETTE_LIGHTS; ++iLight)
+		{
+			for (gen::TUInt32 i = 0; i < numSubMeshes; ++i)  meshLights[i] = lights[iLight];
+			gen::FindSilhouetteEdges( &silhouetteMeshPtrs[0], &meshLights[0], &batchEdges[0], numSubMeshes );
+		}
+	} );
+
+	double faceTests = static_cast<double>(triangles) * SILHOUETTE_LIGHTS;
+	json.Field( "success", true );
+	json.Field( "sub_meshes", static_cast<unsigned long long>(numSubMeshes) );
+	json.Field( "triangles", triangles );
+	json.Field( "lights", static_cast<unsigned long long>(SILHOUETTE_LIGHTS) );
+	json.Field( "edges", edges );
+	json.Field( "mismatches", mismatches );
+	json.Field( "per_face_ns", perFaceSeconds * 1e9 / faceTests );
+	json.Field( "find_edges_ns", blockSeconds * 1e9 / faceTests );
+	json.Field( "find_silhouette_edges_ns", batchSeconds * 1e9 / faceTests );
+	json.Field( "speedup", perFaceSeconds / blockSeconds );
+	json.EndRecord();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunImportBenchmark( JsonWriter& json )
+{
+	for (int i = 0; i < IMPORT_FILE_COUNT; ++i)
+	{
+		BenchmarkAllOptions( json, ImportFiles[i], ImportFiles[i], true );
+	}
+
+	for (int i = 0; i < SYNTHETIC_SIZE_COUNT; ++i)
+	{
+		char name[64];
+		sprintf( name, "synthetic_%u", SyntheticSizes[i] );
+		string fileName = string(name) + ".x";
+		if (!WriteSyntheticMesh( fileName, SyntheticSizes[i] ))
+		{
+			fprintf( stderr, "Cannot write synthetic mesh '%s'\n", fileName.c_str() );
+			continue;
+		}
+		BenchmarkAllOptions( json, name, fileName, SyntheticSizes[i] <= MAX_ADJACENCY_TRIANGLES );
+		remove( fileName.c_str() );
+	}
+
+	for (int i = 0; i < SILHOUETTE_FILE_COUNT; ++i)
+	{
+		BenchmarkSilhouettes( json, SilhouetteFiles[i] );
+	}
+}
@@ -0,0 +1,424 @@
+//--------------------------------------------------------------------------------------
+// Math benchmark - latency and throughput of the hot operations in the gen maths library, and the
+// throughput of their batch versions where they exist. Build with and without SIMD (GEN_NO_SIMD)
+// and compare the records of the same name to see the gain from SIMD, or before and after a change
+// to see its effect
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "CMatrix4x4.h"
+#include "CMatrix3x3.h"
+#include "CVector4.h"
+#include "CQuatTransform.h"
+#include "CRandom.h"
+#include "CSplinePath.h"
+#include "FastMath.h"
+#include "Intersection.h"
+#include "MathIO.h"
+#include <sstream>
+#include <vector>
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Number of items operated on in each pass (about the bones in a large skeleton), small enough that
+// all the inputs and outputs stay in the cache so the arithmetic is measured rather than memory speed
+static const int NUM_ITEMS = 256;
+
+// Each case is repeated to reduce noise, with the fastest pass kept. Each pass runs the operation
+// on all items several times so it is long enough to time accurately
+static const double TARGET_CASE_SECONDS = 0.1;
+static const int    MAX_ITERATIONS = 1000;
+static const int    REPEATS_PER_PASS = 16;
+
+
+//--------------------------------------------------------------------------------------
+// Support functions
+//--------------------------------------------------------------------------------------
+// Each operation is timed in up to three ways:
+// - Latency: each call uses the result of the previous one, so calls cannot overlap. This is the
+//   cost of one call on the critical path, e.g. walking down a hierarchy
+// - Throughput: calls on independent items in a loop, which the CPU can overlap
+// - Batch: the batch (array) version of the function on the same items, if there is one
+
+typedef vector<CMatrix4x4, CAlignedAllocator<CMatrix4x4> > Matrices;
+
+// Results of the final operation of each latency chain are written here so the chain cannot be
+// optimised away
+static volatile TFloat32 Sink;
+
+// Fastest time in nanoseconds to run an operation, divided by the number of items it works on
+template <typename Operation>
+static double TimePerItem( Operation operation, int numItems )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int iteration = 0; iteration < MAX_ITERATIONS && (iteration == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+	{
+		BenchTimer timer;
+		for (int repeat = 0; repeat < REPEATS_PER_PASS; ++repeat)  operation();
+		double seconds = timer.Seconds();
+		if (iteration == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / (static_cast<double>(REPEATS_PER_PASS) * numItems);
+}
+
+// Time per call of a chain of dependent calls. The step function makes one call, updating the
+// state the next call uses
+template <typename Step>
+static double TimeLatency( Step step )
+{
+	return TimePerItem( [&]() { for (int i = 0; i < NUM_ITEMS; ++i)  step( i ); }, NUM_ITEMS );
+}
+
+// Time per item of a loop of single calls on independent items. The call function works on the
+// item with the given index
+template <typename Call>
+static double TimeThroughput( Call call )
+{
+	return TimePerItem( [&]() { for (int i = 0; i < NUM_ITEMS; ++i)  call( i ); }, NUM_ITEMS );
+}
+
+// Time per item of a batch function working on all items
+template <typename Batch>
+static double TimeBatch( Batch batch )
+{
+	return TimePerItem( batch, NUM_ITEMS );
+}
+
+// Write a record for one operation. Times that were not measured (zero) are left out, the batch
+// speedup is against the throughput of single calls
+static void WriteRecord( JsonWriter& json, const string& name, double latencyNs, double throughputNs, double batchNs = 0.0 )
+{
+#if defined(GEN_SIMD_AVX) && defined(GEN_SIMD_FMA)
+	const char* simd = "AVX+FMA";
+#elif defined(GEN_SIMD_AVX)
+	const char* simd = "AVX";
+#elif defined(GEN_SIMD_FMA)
+	const char* simd = "SSE+FMA";
+#elif defined(GEN_SIMD_SSE)
+	const char* simd = "SSE";
+#elif defined(GEN_SIMD_NEON)
+	const char* simd = "NEON";
+#else
+	const char* simd = "None";
+#endif
+	json.BeginRecord( "math", name );
+	json.Field( "simd", string(simd) );
+	if (latencyNs > 0.0)  json.Field( "latency_ns", latencyNs );
+	json.Field( "throughput_ns", throughputNs );
+	if (batchNs > 0.0)
+	{
+		json.Field( "batch_ns", batchNs );
+		json.Field( "batch_speedup", throughputNs / batchNs );
+	}
+	json.EndRecord();
+}
+
+// Random normalised quaternion
+static CQuaternion RandomQuaternion()
+{
+	CQuaternion q( Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ) );
+	q.Normalise();
+	return q;
+}
+
+// Random vector with each element in the given range
+static CVector3 RandomVector( TFloat32 range )
+{
+	return CVector3( Random( -range, range ), Random( -range, range ), Random( -range, range ) );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunMathBenchmark( JsonWriter& json )
+{
+	srand( 1 );
+
+	// Test data - rotations keep the latency chains from growing or shrinking towards overflow or
+	// denormals, the other data are general affine transforms
+	vector<CQuaternion> quats( NUM_ITEMS ), quats2( NUM_ITEMS ), quatsOut( NUM_ITEMS );
+	vector<CQuatTransform> transforms( NUM_ITEMS );
+	vector<CVector3> vectors( NUM_ITEMS ), vectors2( NUM_ITEMS ), vectorsOut( NUM_ITEMS );
+	vector<CVector4> vectors4( NUM_ITEMS ), vectors4Out( NUM_ITEMS );
+	vector<CMatrix3x3> matrices3( NUM_ITEMS ), matrices3Out( NUM_ITEMS );
+	Matrices matrices( NUM_ITEMS ), matricesOut( NUM_ITEMS );
+	vector<TFloat32> values( NUM_ITEMS ), valuesOut( NUM_ITEMS ), valuesOut2( NUM_ITEMS );
+	for (int i = 0; i < NUM_ITEMS; ++i)
+	{
+		quats[i] = RandomQuaternion();
+		quats2[i] = RandomQuaternion();
+		if (Dot( quats[i], quats2[i] ) < 0.0f)  quats2[i] = -quats2[i]; // Short route, see below
+		CVector3 scale( Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ) );
+		transforms[i] = CQuatTransform( quats[i], RandomVector( 100.0f ), scale );
+		vectors[i] = RandomVector( 100.0f );
+		vectors2[i] = RandomVector( 100.0f );
+		vectors4[i] = CVector4( vectors[i], 1.0f );
+		matrices3[i] = CMatrix3x3( quats2[i], scale );
+		transforms[i].GetMatrix( matrices[i] );
+	}
+	const CQuaternion rotationQuat = RandomQuaternion();
+	const CMatrix4x4 rotation( rotationQuat );
+	const CMatrix3x3 rotation3( rotationQuat );
+	const CVector3 axis = Normalise( RandomVector( 1.0f ) );
+	const CVector3 halves( 0.5f, 0.25f, 0.125f ); // Dot product chain converges with this
+
+	double latencyNs, throughputNs, batchNs;
+
+	//////////////////////////////////
+	// CMatrix4x4
+
+	CMatrix4x4 m = matrices[0];
+	latencyNs    = TimeLatency( [&]( int ) { m = m * rotation; } );
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = matrices[i] * rotation; } );
+	batchNs      = TimeBatch( [&]() { TransformMatrices( rotation, &matrices[0], &matricesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "matrix4x4_multiply", latencyNs, throughputNs, batchNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { m = MultiplyAffine( m, rotation ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = MultiplyAffine( matrices[i], rotation ); } );
+	WriteRecord( json, "matrix4x4_multiply_affine", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { m = Inverse( m ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = Inverse( matrices[i] ); } );
+	WriteRecord( json, "matrix4x4_inverse", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { m = InverseAffine( m ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = InverseAffine( matrices[i] ); } );
+	WriteRecord( json, "matrix4x4_inverse_affine", latencyNs, throughputNs );
+	Sink = m.e00;
+
+	CVector4 v4 = vectors4[0];
+	latencyNs    = TimeLatency( [&]( int ) { v4 = rotation.Transform( v4 ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectors4Out[i] = matrices[0].Transform( vectors4[i] ); } );
+	batchNs      = TimeBatch( [&]() { Transform( matrices[0], &vectors4[0], &vectors4Out[0], NUM_ITEMS ); } );
+	WriteRecord( json, "matrix4x4_transform", latencyNs, throughputNs, batchNs );
+	Sink = v4.x;
+
+	CVector3 v = vectors[0];
+	latencyNs    = TimeLatency( [&]( int ) { v = rotation.TransformPoint( v ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = matrices[0].TransformPoint( vectors[i] ); } );
+	batchNs      = TimeBatch( [&]() { TransformPoints( matrices[0], &vectors[0], &vectorsOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "matrix4x4_transform_point", latencyNs, throughputNs, batchNs );
+
+	//////////////////////////////////
+	// CMatrix3x3
+
+	CMatrix3x3 m3 = matrices3[0];
+	latencyNs    = TimeLatency( [&]( int ) { m3 = m3 * rotation3; } );
+	throughputNs = TimeThroughput( [&]( int i ) { matrices3Out[i] = matrices3[i] * rotation3; } );
+	WriteRecord( json, "matrix3x3_multiply", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { m3 = Inverse( m3 ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { matrices3Out[i] = Inverse( matrices3[i] ); } );
+	WriteRecord( json, "matrix3x3_inverse", latencyNs, throughputNs );
+	Sink = m3.e00;
+
+	latencyNs    = TimeLatency( [&]( int ) { v = rotation3.Transform( v ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = matrices3[0].Transform( vectors[i] ); } );
+	WriteRecord( json, "matrix3x3_transform", latencyNs, throughputNs );
+
+	//////////////////////////////////
+	// CQuaternion & CQuatTransform
+
+	CQuaternion q = quats[0];
+	latencyNs    = TimeLatency( [&]( int ) { q = q * rotationQuat; } );
+	throughputNs = TimeThroughput( [&]( int i ) { quatsOut[i] = quats[i] * quats2[i]; } );
+	WriteRecord( json, "quaternion_multiply", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { q = Normalise( q ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { quatsOut[i] = Normalise( quats[i] ); } );
+	WriteRecord( json, "quaternion_normalise", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { v = rotationQuat.Rotate( v ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = quats[i].Rotate( vectors[i] ); } );
+	WriteRecord( json, "quaternion_rotate", latencyNs, throughputNs );
+
+	// The latency chains blend half way towards one of two targets in turn, so never settle on one.
+	// The second quaternion of each pair is on the short route from the first, which the single
+	// NLerp does not choose itself
+	latencyNs    = TimeLatency( [&]( int i ) { Slerp( q, quats[i & 1], 0.5f, q ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { Slerp( quats[i], quats2[i], 0.3f, quatsOut[i] ); } );
+	batchNs      = TimeBatch( [&]() { SlerpArray( &quats[0], &quats2[0], 0.3f, &quatsOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "quaternion_slerp", latencyNs, throughputNs, batchNs );
+
+	latencyNs    = TimeLatency( [&]( int i ) { NLerp( q, quats[i & 1], 0.5f, q ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { NLerp( quats[i], quats2[i], 0.3f, quatsOut[i] ); } );
+	batchNs      = TimeBatch( [&]() { NLerpArray( &quats[0], &quats2[0], 0.3f, &quatsOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "quaternion_nlerp", latencyNs, throughputNs, batchNs );
+	Sink = q.w;
+
+	// Conversions to matrices have no natural chain, so only throughput is measured
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = CMatrix4x4( quats[i] ); } );
+	WriteRecord( json, "quaternion_to_matrix", 0.0, throughputNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { transforms[i].GetMatrix( matricesOut[i] ); } );
+	batchNs      = TimeBatch( [&]() { GetMatrices( &transforms[0], &matricesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "quat_transform_to_matrix", 0.0, throughputNs, batchNs );
+
+	//////////////////////////////////
+	// CVector3
+
+	latencyNs    = TimeLatency( [&]( int ) { v = Normalise( v ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = Normalise( vectors[i] ); } );
+	WriteRecord( json, "vector3_normalise", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { v.x = Dot( v, halves ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { valuesOut[i] = Dot( vectors[i], vectors2[i] ); } );
+	WriteRecord( json, "vector3_dot", latencyNs, throughputNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { v = Cross( v, axis ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = Cross( vectors[i], vectors2[i] ); } );
+	WriteRecord( json, "vector3_cross", latencyNs, throughputNs );
+	Sink = v.x;
+
+	//////////////////////////////////
+	// Random numbers
+
+	// The C library rand based Random is included for comparison
+	CRandom random( 1 );
+	throughputNs = TimeThroughput( [&]( int i ) { valuesOut[i] = Random( -1.0f, 1.0f ); } );
+	WriteRecord( json, "random_float_rand", 0.0, throughputNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { valuesOut[i] = random.Float( -1.0f, 1.0f ); } );
+	batchNs      = TimeBatch( [&]() { random.Floats( -1.0f, 1.0f, &valuesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "random_float", 0.0, throughputNs, batchNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = random.UnitVector(); } );
+	batchNs      = TimeBatch( [&]() { random.UnitVectors( &vectorsOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "random_unit_vector", 0.0, throughputNs, batchNs );
+
+	//////////////////////////////////
+	// Text and binary IO
+
+	// Single calls are the stream operators, the batch times are the fast text functions on each
+	// item in turn and the binary functions on the whole array. Output streams are reused so only
+	// the first pass allocates
+	vector<char> text( NUM_ITEMS * 16 * kMaxTextPerFloat );
+	char* pTextEnd = 0;
+	ostringstream textOut;
+	throughputNs = TimeThroughput( [&]( int i ) { if (i == 0) textOut.seekp( 0 );  textOut << matrices[i] << '\n'; } );
+	batchNs      = TimeBatch( [&]()
+	{
+		pTextEnd = &text[0];
+		for (int i = 0; i < NUM_ITEMS; ++i)
+		{
+			pTextEnd = FormatText( pTextEnd, &text[0] + text.size(), matrices[i] );
+			*pTextEnd++ = '\n';
+		}
+	} );
+	WriteRecord( json, "matrix4x4_text_write", 0.0, throughputNs, batchNs );
+
+	istringstream textIn( string( &text[0], pTextEnd ) );
+	throughputNs = TimeThroughput( [&]( int i ) { if (i == 0) textIn.seekg( 0 );  textIn >> matricesOut[i]; } );
+	batchNs      = TimeBatch( [&]()
+	{
+		const char* pText = &text[0];
+		for (int i = 0; i < NUM_ITEMS; ++i)  pText = ParseText( pText, pTextEnd, matricesOut[i] );
+	} );
+	WriteRecord( json, "matrix4x4_text_read", 0.0, throughputNs, batchNs );
+
+	stringstream binary;
+	throughputNs = TimeThroughput( [&]( int i ) { if (i == 0) textOut.seekp( 0 );  textOut << matrices[i] << '\n'; } );
+	batchNs      = TimeBatch( [&]() { binary.seekp( 0 );  WriteBinary( binary, &matrices[0], NUM_ITEMS ); } );
+	WriteRecord( json, "matrix4x4_binary_write", 0.0, throughputNs, batchNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { if (i == 0) textIn.seekg( 0 );  textIn >> matricesOut[i]; } );
+	batchNs      = TimeBatch( [&]() { binary.seekg( 0 );  ReadBinary( binary, &matricesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "matrix4x4_binary_read", 0.0, throughputNs, batchNs );
+	Sink = matricesOut[NUM_ITEMS - 1].e33;
+
+	//////////////////////////////////
+	// Intersection
+
+	// Volumes scattered around a camera at the origin looking down z, so about a third are visible
+	CMatrix4x4 projection;
+	projection.MakeIdentity();
+	projection.e22 = 1000.0f / (1000.0f - 1.0f);
+	projection.e23 = 1.0f;
+	projection.e32 = -projection.e22;
+	projection.e33 = 0.0f;
+	const CFrustum frustum( projection );
+	vector<SSphere> spheres( NUM_ITEMS );
+	vector<SAABB> boxes( NUM_ITEMS );
+	vector<CVector3> triangles( 3 * NUM_ITEMS );
+	bool visible[NUM_ITEMS];
+	for (int i = 0; i < NUM_ITEMS; ++i)
+	{
+		spheres[i].centre = vectors[i];
+		spheres[i].radius = Random( 1.0f, 10.0f );
+		boxes[i].minPoint = vectors[i] - CVector3( 5.0f, 5.0f, 5.0f );
+		boxes[i].maxPoint = vectors[i] + CVector3( 5.0f, 5.0f, 5.0f );
+		for (int j = 0; j < 3; ++j)  triangles[3 * i + j] = vectors2[i] + RandomVector( 20.0f );
+	}
+	const CVector3 rayOrigin( 0.0f, 0.0f, -200.0f );
+	const CVector3 rayDirection( 0.0f, 0.0f, 1.0f );
+
+	// Single tests have no natural chain, so only throughput is measured
+	throughputNs = TimeThroughput( [&]( int i ) { visible[i] = frustum.IsSphereVisible( spheres[i] ); } );
+	batchNs      = TimeBatch( [&]() { frustum.CullSpheres( &spheres[0], visible, NUM_ITEMS ); } );
+	WriteRecord( json, "frustum_spheres", 0.0, throughputNs, batchNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { visible[i] = frustum.IsAABBVisible( boxes[i] ); } );
+	batchNs      = TimeBatch( [&]() { frustum.CullAABBs( &boxes[0], visible, NUM_ITEMS ); } );
+	WriteRecord( json, "frustum_aabbs", 0.0, throughputNs, batchNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { IntersectRayAABB( rayOrigin, rayDirection, boxes[i], &valuesOut[i] ); } );
+	batchNs      = TimeBatch( [&]() { IntersectRayAABBs( rayOrigin, rayDirection, &boxes[0], &valuesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "ray_aabbs", 0.0, throughputNs, batchNs );
+
+	TFloat32 distance;
+	throughputNs = TimeThroughput( [&]( int i ) { visible[i] = IntersectRayTriangle( rayOrigin, rayDirection, triangles[3 * i],
+	                                                                                 triangles[3 * i + 1], triangles[3 * i + 2], &distance ); } );
+	batchNs      = TimeBatch( [&]() { IntersectRayTriangles( rayOrigin, rayDirection, &triangles[0], NUM_ITEMS, &distance ); } );
+	WriteRecord( json, "ray_triangles", 0.0, throughputNs, batchNs );
+	Sink = distance;
+
+	//////////////////////////////////
+	// Spline paths
+
+	// Objects spread along a closed Catmull-Rom path through the test vectors
+	const CSplinePath path( &vectors[0], 16, kCatmullRom, true );
+	for (int i = 0; i < NUM_ITEMS; ++i)  values[i] = Random( 0.0f, path.GetLength() );
+
+	throughputNs = TimeThroughput( [&]( int i ) { vectorsOut[i] = path.GetPosition( values[i] ); } );
+	batchNs      = TimeBatch( [&]() { path.GetPositions( &values[0], &vectorsOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "spline_position", 0.0, throughputNs, batchNs );
+
+	throughputNs = TimeThroughput( [&]( int i ) { matricesOut[i] = path.GetMatrix( values[i] ); } );
+	batchNs      = TimeBatch( [&]() { path.GetMatrices( &values[0], &matricesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "spline_matrix", 0.0, throughputNs, batchNs );
+	Sink = matricesOut[NUM_ITEMS - 1].e30;
+
+	//////////////////////////////////
+	// Scalar functions
+
+	for (int i = 0; i < NUM_ITEMS; ++i)  values[i] = Random( 0.01f, 100.0f );
+	TFloat32 x = values[0];
+	latencyNs    = TimeLatency( [&]( int ) { x = InvSqrt( x ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { valuesOut[i] = InvSqrt( values[i] ); } );
+	batchNs      = TimeBatch( [&]() { InvSqrtArray( &values[0], &valuesOut[0], NUM_ITEMS ); } );
+	WriteRecord( json, "invsqrt", latencyNs, throughputNs, batchNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { x = InvSqrtFast( x ); } );
+	throughputNs = TimeThroughput( [&]( int i ) { valuesOut[i] = InvSqrtFast( values[i] ); } );
+	batchNs      = TimeBatch( [&]() { InvSqrtArray( &values[0], &valuesOut[0], NUM_ITEMS, kPrecisionFast ); } );
+	WriteRecord( json, "invsqrt_fast", latencyNs, throughputNs, batchNs );
+
+	for (int i = 0; i < NUM_ITEMS; ++i)  values[i] = Random( -kfPi, kfPi );
+	TFloat32 s, c;
+	latencyNs    = TimeLatency( [&]( int ) { SinCos( x, &s, &c );  x = s + c; } );
+	throughputNs = TimeThroughput( [&]( int i ) { SinCos( values[i], &valuesOut[i], &valuesOut2[i] ); } );
+	batchNs      = TimeBatch( [&]() { SinCosArray( &values[0], &valuesOut[0], &valuesOut2[0], NUM_ITEMS ); } );
+	WriteRecord( json, "sincos", latencyNs, throughputNs, batchNs );
+
+	latencyNs    = TimeLatency( [&]( int ) { SinCosFast( x, &s, &c );  x = s + c; } );
+	throughputNs = TimeThroughput( [&]( int i ) { SinCosFast( values[i], &valuesOut[i], &valuesOut2[i] ); } );
+	batchNs      = TimeBatch( [&]() { SinCosArray( &values[0], &valuesOut[0], &valuesOut2[0], NUM_ITEMS, kPrecisionFast ); } );
+	WriteRecord( json, "sincos_fast", latencyNs, throughputNs, batchNs );
+	Sink = x;
+}
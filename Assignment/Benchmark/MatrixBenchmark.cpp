@@ -0,0 +1,521 @@
+//--------------------------------------------------------------------------------------
+// Matrix benchmark - speed of the SIMD CMatrix4x4 functions against the scalar code they
+// replaced, and of the batch transforms and quaternion blends against loops of single operations,
+// with the largest difference between the two results
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "CMatrix4x4.h"
+#include "CVector4.h"
+#include "CQuatTransform.h"
+#include "MathSIMD.h"
+#include <math.h>
+#include <vector>
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Number of matrices operated on in each pass, small enough that all the inputs and outputs stay
+// in the cache so the arithmetic is measured rather than memory speed
+static const int NUM_MATRICES = 256;
+
+// Number of vectors in each batch transform, also kept in the cache. The threaded batch is large
+// enough to be split over threads, so is limited by memory bandwidth as real uses would be
+static const int NUM_BATCH_VECTORS = 4096;
+static const int NUM_THREADED_VECTORS = 1 << 20;
+
+// Each case is repeated to reduce noise, with the fastest pass kept. Each pass runs the operation
+// on all matrices several times so it is long enough to time accurately
+static const double TARGET_CASE_SECONDS = 0.25;
+static const int    MAX_ITERATIONS = 1000;
+static const int    REPEATS_PER_PASS = 16;
+
+
+//--------------------------------------------------------------------------------------
+// Scalar reference
+//--------------------------------------------------------------------------------------
+// The element-by-element code used by CMatrix4x4 before SIMD was added, kept out of line and
+// returning by value as those functions did. Compilers auto-vectorise some of these (GCC at -O2
+// turns the multiply into the same shuffles and products as the SSE code), so where the speedup is
+// near 1 it is the library's SIMD code matching what the compiler already managed for the scalar
+
+#if defined(_MSC_VER)
+	#define NOINLINE __declspec(noinline)
+#else
+	#define NOINLINE __attribute__((noinline))
+#endif
+
+static NOINLINE CMatrix4x4 ScalarMultiply( const CMatrix4x4& m1, const CMatrix4x4& m2 )
+{
+	CMatrix4x4 mOut;
+
+	mOut.e00 = m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20 + m1.e03*m2.e30;
+	mOut.e01 = m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21 + m1.e03*m2.e31;
+	mOut.e02 = m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22 + m1.e03*m2.e32;
+	mOut.e03 = m1.e00*m2.e03 + m1.e01*m2.e13 + m1.e02*m2.e23 + m1.e03*m2.e33;
+
+	mOut.e10 = m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20 + m1.e13*m2.e30;
+	mOut.e11 = m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21 + m1.e13*m2.e31;
+	mOut.e12 = m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22 + m1.e13*m2.e32;
+	mOut.e13 = m1.e10*m2.e03 + m1.e11*m2.e13 + m1.e12*m2.e23 + m1.e13*m2.e33;
+
+	mOut.e20 = m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20 + m1.e23*m2.e30;
+	mOut.e21 = m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21 + m1.e23*m2.e31;
+	mOut.e22 = m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22 + m1.e23*m2.e32;
+	mOut.e23 = m1.e20*m2.e03 + m1.e21*m2.e13 + m1.e22*m2.e23 + m1.e23*m2.e33;
+
+	mOut.e30 = m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m1.e33*m2.e30;
+	mOut.e31 = m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m1.e33*m2.e31;
+	mOut.e32 = m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m1.e33*m2.e32;
+	mOut.e33 = m1.e30*m2.e03 + m1.e31*m2.e13 + m1.e32*m2.e23 + m1.e33*m2.e33;
+
+	return mOut;
+}
+
+static NOINLINE CMatrix4x4 ScalarMultiplyAffine( const CMatrix4x4& m1, const CMatrix4x4& m2 )
+{
+	CMatrix4x4 mOut;
+
+	mOut.e00 = m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20;
+	mOut.e01 = m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21;
+	mOut.e02 = m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22;
+	mOut.e03 = 0.0f;
+
+	mOut.e10 = m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20;
+	mOut.e11 = m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21;
+	mOut.e12 = m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22;
+	mOut.e13 = 0.0f;
+
+	mOut.e20 = m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20;
+	mOut.e21 = m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21;
+	mOut.e22 = m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22;
+	mOut.e23 = 0.0f;
+
+	mOut.e30 = m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m2.e30;
+	mOut.e31 = m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m2.e31;
+	mOut.e32 = m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m2.e32;
+	mOut.e33 = 1.0f;
+
+	return mOut;
+}
+
+static NOINLINE CVector4 ScalarTransform( const CMatrix4x4& m, const CVector4& v )
+{
+	CVector4 vOut;
+
+	vOut.x = v.x*m.e00 + v.y*m.e10 + v.z*m.e20 + v.w*m.e30;
+	vOut.y = v.x*m.e01 + v.y*m.e11 + v.z*m.e21 + v.w*m.e31;
+	vOut.z = v.x*m.e02 + v.y*m.e12 + v.z*m.e22 + v.w*m.e32;
+	vOut.w = v.x*m.e03 + v.y*m.e13 + v.z*m.e23 + v.w*m.e33;
+
+	return vOut;
+}
+
+static NOINLINE CMatrix4x4 ScalarTranspose( const CMatrix4x4& m )
+{
+	CMatrix4x4 mOut;
+
+	mOut.e00 = m.e00;  mOut.e01 = m.e10;  mOut.e02 = m.e20;  mOut.e03 = m.e30;
+	mOut.e10 = m.e01;  mOut.e11 = m.e11;  mOut.e12 = m.e21;  mOut.e13 = m.e31;
+	mOut.e20 = m.e02;  mOut.e21 = m.e12;  mOut.e22 = m.e22;  mOut.e23 = m.e32;
+	mOut.e30 = m.e03;  mOut.e31 = m.e13;  mOut.e32 = m.e23;  mOut.e33 = m.e33;
+
+	return mOut;
+}
+
+static NOINLINE CMatrix4x4 ScalarInverseAffine( const CMatrix4x4& m )
+{
+	CMatrix4x4 mOut;
+
+	TFloat32 det0 = m.e11*m.e22 - m.e12*m.e21;
+	TFloat32 det1 = m.e12*m.e20 - m.e10*m.e22;
+	TFloat32 det2 = m.e10*m.e21 - m.e11*m.e20;
+	TFloat32 det = m.e00*det0 + m.e01*det1 + m.e02*det2;
+
+	TFloat32 invDet = 1.0f / det;
+	mOut.e00 = invDet * det0;
+	mOut.e10 = invDet * det1;
+	mOut.e20 = invDet * det2;
+	mOut.e01 = invDet * (m.e21*m.e02 - m.e22*m.e01);
+	mOut.e11 = invDet * (m.e22*m.e00 - m.e20*m.e02);
+	mOut.e21 = invDet * (m.e20*m.e01 - m.e21*m.e00);
+	mOut.e02 = invDet * (m.e01*m.e12 - m.e02*m.e11);
+	mOut.e12 = invDet * (m.e02*m.e10 - m.e00*m.e12);
+	mOut.e22 = invDet * (m.e00*m.e11 - m.e01*m.e10);
+
+	mOut.e30 = -m.e30*mOut.e00 - m.e31*mOut.e10 - m.e32*mOut.e20;
+	mOut.e31 = -m.e30*mOut.e01 - m.e31*mOut.e11 - m.e32*mOut.e21;
+	mOut.e32 = -m.e30*mOut.e02 - m.e31*mOut.e12 - m.e32*mOut.e22;
+
+	mOut.e03 = 0.0f;
+	mOut.e13 = 0.0f;
+	mOut.e23 = 0.0f;
+	mOut.e33 = 1.0f;
+
+	return mOut;
+}
+
+static NOINLINE CMatrix4x4 ScalarInverse( const CMatrix4x4& m )
+{
+	CMatrix4x4 mOut;
+
+	TFloat32 det = m.e00 * Cofactor( m, 0, 0 ) + m.e01 * Cofactor( m, 0, 1 ) +
+	               m.e02 * Cofactor( m, 0, 2 ) + m.e03 * Cofactor( m, 0, 3 );
+
+	TFloat32 invDet = 1.0f / det;
+	for (TUInt32 i = 0; i < 4; ++i)
+	{
+		for (TUInt32 j = 0; j < 4; ++j)
+		{
+			mOut[i][j] = invDet * Cofactor( m, j, i );
+		}
+	}
+
+	return mOut;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Helpers
+//--------------------------------------------------------------------------------------
+
+typedef vector<CMatrix4x4, CAlignedAllocator<CMatrix4x4> > Matrices;
+
+// Fill a list with random affine matrices (scale, rotation and translation)
+static void RandomAffineMatrices( Matrices& matrices )
+{
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		CVector3 position( Random( -100.0f, 100.0f ), Random( -100.0f, 100.0f ), Random( -100.0f, 100.0f ) );
+		CVector3 angles( Random( -kfPi, kfPi ), Random( -kfPi, kfPi ), Random( -kfPi, kfPi ) );
+		CVector3 scale( Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ) );
+		matrices[i] = CMatrix4x4( position, angles, kZXY, scale );
+	}
+}
+
+// Fill a list with random general matrices, each the product of an affine matrix and a perspective
+// projection (as a view-projection matrix), so they are well conditioned
+static void RandomGeneralMatrices( Matrices& matrices )
+{
+	RandomAffineMatrices( matrices );
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		TFloat32 nearClip = Random( 0.1f, 1.0f ), farClip = Random( 100.0f, 1000.0f );
+		TFloat32 q = farClip / (farClip - nearClip);
+		CMatrix4x4 projection( Random( 1.0f, 2.0f ), 0.0f, 0.0f, 0.0f,
+		                       0.0f, Random( 1.0f, 2.0f ), 0.0f, 0.0f,
+		                       0.0f, 0.0f, q, 1.0f,
+		                       0.0f, 0.0f, -q * nearClip, 0.0f );
+		matrices[i] = matrices[i] * projection;
+	}
+}
+
+// Largest difference between corresponding elements of two lists of matrices, relative to the
+// largest element of the reference matrix
+static double MaxRelativeError( const Matrices& reference, const Matrices& test )
+{
+	double maxError = 0.0;
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		double largest = 0.0, error = 0.0;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int col = 0; col < 4; ++col)
+			{
+				largest = fmax( largest, fabs( reference[i][row][col] ) );
+				error = fmax( error, fabs( reference[i][row][col] - test[i][row][col] ) );
+			}
+		}
+		maxError = fmax( maxError, error / largest );
+	}
+	return maxError;
+}
+
+// Fastest time in nanoseconds to run an operation on all matrices, divided by the number of matrices.
+// The operation takes the index of the matrix to process
+template <typename Operation>
+static double TimePerMatrix( Operation operation )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int iteration = 0; iteration < MAX_ITERATIONS && (iteration == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+	{
+		BenchTimer timer;
+		for (int repeat = 0; repeat < REPEATS_PER_PASS; ++repeat)
+		{
+			for (int i = 0; i < NUM_MATRICES; ++i)  operation( i );
+		}
+		double seconds = timer.Seconds();
+		if (iteration == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / (REPEATS_PER_PASS * NUM_MATRICES);
+}
+
+// Fill a list with random vectors, each element in the given range
+static void RandomVectors( vector<CVector3>& vectors, TFloat32 range )
+{
+	for (size_t i = 0; i < vectors.size(); ++i)
+	{
+		vectors[i] = CVector3( Random( -range, range ), Random( -range, range ), Random( -range, range ) );
+	}
+}
+
+// Largest difference between corresponding vectors of two lists, relative to the largest element
+// of the reference vector
+static double MaxRelativeError( const vector<CVector3>& reference, const vector<CVector3>& test )
+{
+	double maxError = 0.0;
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		double largest = fmax( fabs( reference[i].x ), fmax( fabs( reference[i].y ), fabs( reference[i].z ) ) );
+		double error = fmax( fabs( reference[i].x - test[i].x ),
+		                     fmax( fabs( reference[i].y - test[i].y ), fabs( reference[i].z - test[i].z ) ) );
+		if (largest > 0.0)  maxError = fmax( maxError, error / largest );
+	}
+	return maxError;
+}
+
+// Fill a list with random normalised quaternions
+static void RandomQuaternions( vector<CQuaternion>& quats )
+{
+	for (size_t i = 0; i < quats.size(); ++i)
+	{
+		quats[i] = CQuaternion( Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ) );
+		quats[i].Normalise();
+	}
+}
+
+// Largest difference between corresponding elements of two lists of normalised quaternions
+static double MaxError( const vector<CQuaternion>& reference, const vector<CQuaternion>& test )
+{
+	double maxError = 0.0;
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		maxError = fmax( maxError, fabs( reference[i].w - test[i].w ) );
+		maxError = fmax( maxError, fabs( reference[i].x - test[i].x ) );
+		maxError = fmax( maxError, fabs( reference[i].y - test[i].y ) );
+		maxError = fmax( maxError, fabs( reference[i].z - test[i].z ) );
+	}
+	return maxError;
+}
+
+// Fastest time in nanoseconds to run an operation on a whole batch, divided by the number of items
+template <typename Operation>
+static double TimePerItem( Operation operation, int numItems )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int iteration = 0; iteration < MAX_ITERATIONS && (iteration == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++iteration)
+	{
+		BenchTimer timer;
+		for (int repeat = 0; repeat < REPEATS_PER_PASS; ++repeat)  operation();
+		double seconds = timer.Seconds();
+		if (iteration == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / (static_cast<double>(REPEATS_PER_PASS) * numItems);
+}
+
+// Write a record comparing the scalar and SIMD versions of an operation
+static void WriteRecord( JsonWriter& json, const string& name, double scalarNs, double simdNs, double maxError )
+{
+#if defined(GEN_SIMD_AVX) && defined(GEN_SIMD_FMA)
+	const char* simd = "AVX+FMA";
+#elif defined(GEN_SIMD_AVX)
+	const char* simd = "AVX";
+#elif defined(GEN_SIMD_FMA)
+	const char* simd = "SSE+FMA";
+#elif defined(GEN_SIMD_SSE)
+	const char* simd = "SSE";
+#elif defined(GEN_SIMD_NEON)
+	const char* simd = "NEON";
+#else
+	const char* simd = "None";
+#endif
+	json.BeginRecord( "matrix", name );
+	json.Field( "simd", string(simd) );
+	json.Field( "scalar_ns", scalarNs );
+	json.Field( "simd_ns", simdNs );
+	json.Field( "speedup", scalarNs / simdNs );
+	json.Field( "max_relative_error", maxError );
+	json.EndRecord();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunMatrixBenchmark( JsonWriter& json )
+{
+	srand( 1 );
+	Matrices affine1( NUM_MATRICES ), affine2( NUM_MATRICES ), general1( NUM_MATRICES ), general2( NUM_MATRICES );
+	RandomAffineMatrices( affine1 );
+	RandomAffineMatrices( affine2 );
+	RandomGeneralMatrices( general1 );
+	RandomGeneralMatrices( general2 );
+	Matrices scalarOut( NUM_MATRICES ), simdOut( NUM_MATRICES );
+
+	double scalarNs, simdNs;
+
+	// General multiply
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = ScalarMultiply( general1[i], general2[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = general1[i] * general2[i]; } );
+	WriteRecord( json, "multiply", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Multiply in place
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = general1[i];  scalarOut[i] = ScalarMultiply( scalarOut[i], general2[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = general1[i];  simdOut[i] *= general2[i]; } );
+	WriteRecord( json, "multiply_in_place", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Affine multiply
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = ScalarMultiplyAffine( affine1[i], affine2[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = MultiplyAffine( affine1[i], affine2[i] ); } );
+	WriteRecord( json, "multiply_affine", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Vector transform - the vectors are taken from the rows of the second list of matrices, and
+	// the results stored in the rows of the output matrices
+	scalarNs = TimePerMatrix( [&]( int i )
+	{
+		for (int row = 0; row < 4; ++row)  scalarOut[i][row] = ScalarTransform( general1[i], general2[i][row] );
+	} );
+	simdNs = TimePerMatrix( [&]( int i )
+	{
+		for (int row = 0; row < 4; ++row)  simdOut[i][row] = general1[i].Transform( general2[i][row] );
+	} );
+	WriteRecord( json, "transform_x4", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Transpose
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = ScalarTranspose( general1[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = Transpose( general1[i] ); } );
+	WriteRecord( json, "transpose", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Affine inverse
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = ScalarInverseAffine( affine1[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = InverseAffine( affine1[i] ); } );
+	WriteRecord( json, "inverse_affine", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// General inverse
+	scalarNs = TimePerMatrix( [&]( int i ) { scalarOut[i] = ScalarInverse( general1[i] ); } );
+	simdNs   = TimePerMatrix( [&]( int i ) { simdOut[i] = Inverse( general1[i] ); } );
+	WriteRecord( json, "inverse", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Model and camera matrices from position, Euler angles and scale, built as products of separate
+	// scaling, rotation and translation matrices (with a general inverse for the camera view matrix)
+	// against the matrix built directly (with the rotation and translation inverse)
+	vector<CVector3> eulerPositions( NUM_MATRICES ), eulerAngles( NUM_MATRICES ), eulerScales( NUM_MATRICES );
+	RandomVectors( eulerPositions, 100.0f );
+	RandomVectors( eulerAngles, kfPi );
+	for (int i = 0; i < NUM_MATRICES; ++i)
+	{
+		eulerScales[i] = CVector3( Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ) );
+	}
+	scalarNs = TimePerMatrix( [&]( int i )
+	{
+		scalarOut[i] = MatrixScaling( eulerScales[i] ) * MatrixRotationZ( eulerAngles[i].z ) * MatrixRotationX( eulerAngles[i].x ) *
+		               MatrixRotationY( eulerAngles[i].y ) * MatrixTranslation( eulerPositions[i] );
+	} );
+	simdNs = TimePerMatrix( [&]( int i ) { simdOut[i].MakeAffineEuler( eulerPositions[i], eulerAngles[i], kZXY, eulerScales[i] ); } );
+	WriteRecord( json, "model_world_matrix", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	scalarNs = TimePerMatrix( [&]( int i )
+	{
+		scalarOut[i] = Inverse( MatrixRotationZ( eulerAngles[i].z ) * MatrixRotationX( eulerAngles[i].x ) *
+		                        MatrixRotationY( eulerAngles[i].y ) * MatrixTranslation( eulerPositions[i] ) );
+	} );
+	simdNs = TimePerMatrix( [&]( int i )
+	{
+		simdOut[i].MakeAffineEuler( eulerPositions[i], eulerAngles[i] );
+		simdOut[i] = InverseRotTrans( simdOut[i] );
+	} );
+	WriteRecord( json, "camera_view_matrix", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Batch transforms against loops of the single transform functions (times are per vector or
+	// matrix). The threaded record compares the single threaded batch against the same batch
+	// split over the hardware concurrency
+	vector<CVector3> vectors( NUM_BATCH_VECTORS ), loopVectors( NUM_BATCH_VECTORS ), batchVectors( NUM_BATCH_VECTORS );
+	RandomVectors( vectors, 100.0f );
+	const CMatrix4x4& m = affine1[0];
+
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_BATCH_VECTORS; ++i)  loopVectors[i] = m.TransformPoint( vectors[i] );
+	}, NUM_BATCH_VECTORS );
+	simdNs = TimePerItem( [&]() { TransformPoints( m, &vectors[0], &batchVectors[0], NUM_BATCH_VECTORS ); }, NUM_BATCH_VECTORS );
+	WriteRecord( json, "batch_points", scalarNs, simdNs, MaxRelativeError( loopVectors, batchVectors ) );
+
+	scalarNs = TimePerItem( [&]()
+	{
+		CMatrix4x4 normalMatrix = Transpose( InverseAffine( m ) );
+		for (int i = 0; i < NUM_BATCH_VECTORS; ++i)  loopVectors[i] = Normalise( normalMatrix.TransformVector( vectors[i] ) );
+	}, NUM_BATCH_VECTORS );
+	simdNs = TimePerItem( [&]() { TransformNormals( m, &vectors[0], &batchVectors[0], NUM_BATCH_VECTORS ); }, NUM_BATCH_VECTORS );
+	WriteRecord( json, "batch_normals", scalarNs, simdNs, MaxRelativeError( loopVectors, batchVectors ) );
+
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_MATRICES; ++i)  scalarOut[i] = general1[i] * m;
+	}, NUM_MATRICES );
+	simdNs = TimePerItem( [&]() { TransformMatrices( m, &general1[0], &simdOut[0], NUM_MATRICES ); }, NUM_MATRICES );
+	WriteRecord( json, "batch_matrices", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	// Batch quaternion and quaternion-transform blends, and conversion of quaternion-transforms to
+	// matrices, for as many items as bones in a large skeleton. The second quaternion of each pair is
+	// on the short route from the first, which the single NLerp does not choose itself
+	vector<CQuaternion> quats0( NUM_MATRICES ), quats1( NUM_MATRICES ), loopQuats( NUM_MATRICES ), batchQuats( NUM_MATRICES );
+	RandomQuaternions( quats0 );
+	RandomQuaternions( quats1 );
+	for (int i = 0; i < NUM_MATRICES; ++i)
+	{
+		if (Dot( quats0[i], quats1[i] ) < 0.0f)  quats1[i] = -quats1[i];
+	}
+
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_MATRICES; ++i)  Slerp( quats0[i], quats1[i], 0.3f, loopQuats[i] );
+	}, NUM_MATRICES );
+	simdNs = TimePerItem( [&]() { SlerpArray( &quats0[0], &quats1[0], 0.3f, &batchQuats[0], NUM_MATRICES ); }, NUM_MATRICES );
+	WriteRecord( json, "batch_slerp", scalarNs, simdNs, MaxError( loopQuats, batchQuats ) );
+
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_MATRICES; ++i)  NLerp( quats0[i], quats1[i], 0.3f, loopQuats[i] );
+	}, NUM_MATRICES );
+	simdNs = TimePerItem( [&]() { NLerpArray( &quats0[0], &quats1[0], 0.3f, &batchQuats[0], NUM_MATRICES ); }, NUM_MATRICES );
+	WriteRecord( json, "batch_nlerp", scalarNs, simdNs, MaxError( loopQuats, batchQuats ) );
+
+	vector<CQuatTransform> transforms0( NUM_MATRICES ), transforms1( NUM_MATRICES ), loopTransforms( NUM_MATRICES ), batchTransforms( NUM_MATRICES );
+	vector<CVector3> positions( NUM_MATRICES );
+	RandomVectors( positions, 100.0f );
+	for (int i = 0; i < NUM_MATRICES; ++i)
+	{
+		CVector3 scale( Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ), Random( 0.5f, 2.0f ) );
+		transforms0[i] = CQuatTransform( quats0[i], positions[i], scale );
+		transforms1[i] = CQuatTransform( quats1[i], positions[NUM_MATRICES - 1 - i], CVector3::kOne );
+	}
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_MATRICES; ++i)  Slerp( transforms0[i], transforms1[i], 0.3f, loopTransforms[i] );
+	}, NUM_MATRICES );
+	simdNs = TimePerItem( [&]() { SlerpArray( &transforms0[0], &transforms1[0], 0.3f, &batchTransforms[0], NUM_MATRICES ); }, NUM_MATRICES );
+	for (int i = 0; i < NUM_MATRICES; ++i)
+	{
+		loopQuats[i] = loopTransforms[i].quat;
+		batchQuats[i] = batchTransforms[i].quat;
+	}
+	WriteRecord( json, "batch_slerp_transforms", scalarNs, simdNs, MaxError( loopQuats, batchQuats ) );
+
+	scalarNs = TimePerItem( [&]()
+	{
+		for (int i = 0; i < NUM_MATRICES; ++i)  transforms0[i].GetMatrix( scalarOut[i] );
+	}, NUM_MATRICES );
+	simdNs = TimePerItem( [&]() { GetMatrices( &transforms0[0], &simdOut[0], NUM_MATRICES ); }, NUM_MATRICES );
+	WriteRecord( json, "batch_transform_matrices", scalarNs, simdNs, MaxRelativeError( scalarOut, simdOut ) );
+
+	vector<CVector3> threadedIn( NUM_THREADED_VECTORS ), singleOut( NUM_THREADED_VECTORS ), threadedOut( NUM_THREADED_VECTORS );
+	RandomVectors( threadedIn, 100.0f );
+	scalarNs = TimePerItem( [&]() { TransformPoints( m, &threadedIn[0], &singleOut[0], NUM_THREADED_VECTORS ); }, NUM_THREADED_VECTORS );
+	simdNs = TimePerItem( [&]() { TransformPoints( m, &threadedIn[0], &threadedOut[0], NUM_THREADED_VECTORS, 0 ); }, NUM_THREADED_VECTORS );
+	WriteRecord( json, "batch_points_threaded", scalarNs, simdNs, MaxRelativeError( singleOut, threadedOut ) );
+}
@@ -0,0 +1,481 @@
+//--------------------------------------------------------------------------------------
+// Scene benchmark - per-frame cost of the entity store's systems for scenes of tens of
+// thousands of objects, against the same work on separately allocated objects each holding
+// their own transform (as the Model class does). Also the time to load scene files of
+// that size in their text and compiled binary forms
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "EntityStore.h"
+#include "SceneFile.h"
+#include "Intersection.h"
+#include "AlignedAllocator.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Number of objects in the scene, enough that the transforms do not fit in the cache
+static const int NUM_ENTITIES = 50000;
+
+// Fraction of objects that move each frame in the partly moving case
+static const int MOVING_ONE_IN = 100;
+
+// Each case is repeated to reduce noise, with the fastest frame kept
+static const double TARGET_CASE_SECONDS = 0.25;
+static const int    MAX_FRAMES = 1000;
+
+// Number of models in the generated scene files, and materials shared between them
+static const int SceneFileSizes[] = { 5000, 50000 };
+static const int SCENE_FILE_SIZE_COUNT = sizeof(SceneFileSizes) / sizeof(SceneFileSizes[0]);
+static const int SCENE_FILE_MATERIALS = 16;
+
+
+//--------------------------------------------------------------------------------------
+// Separately allocated objects
+//--------------------------------------------------------------------------------------
+
+// An object with its own transform and rendering data, allocated on its own as Model objects are.
+// The allocations are interleaved with others and visited in a shuffled order, as objects created
+// over the life of a program end up scattered through memory
+struct SceneObject
+{
+	GEN_ALIGNED_NEW( 16 );
+
+	CVector3   position;
+	CVector3   rotation;
+	CVector3   scale;
+	CMatrix4x4 worldMatrix;
+	bool       matrixDirty;
+	void*      geometry;
+	void*      technique;
+	int        diffuseTexture;
+	int        normalTexture;
+	CVector3   tintColour;
+};
+
+// Create the objects with the given positions and rotations, scattered through memory
+static void CreateObjects( vector<SceneObject*>& objects, vector<char*>& clutter,
+                           const vector<CVector3>& positions, const vector<CVector3>& rotations )
+{
+	mt19937 random( 1 );
+	for (int i = 0; i < NUM_ENTITIES; ++i)
+	{
+		SceneObject* object = new SceneObject;
+		object->position = positions[i];
+		object->rotation = rotations[i];
+		object->scale = CVector3( 1.0f, 1.0f, 1.0f );
+		object->worldMatrix.MakeAffineEuler( object->position, object->rotation, kZXY, object->scale );
+		object->matrixDirty = false;
+		objects.push_back( object );
+		clutter.push_back( new char[16 + random() % 256] );
+	}
+	shuffle( objects.begin(), objects.end(), random );
+}
+
+static void DeleteObjects( vector<SceneObject*>& objects, vector<char*>& clutter )
+{
+	for (size_t i = 0; i < objects.size(); ++i)  delete objects[i];
+	for (size_t i = 0; i < clutter.size(); ++i)  delete[] clutter[i];
+	objects.clear();
+	clutter.clear();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Timing
+//--------------------------------------------------------------------------------------
+
+// Time a frame operation, returning the nanoseconds per entity of the fastest frame
+template <class Operation>
+static double TimePerEntity( Operation operation )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int frame = 0; frame < MAX_FRAMES && (frame == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++frame)
+	{
+		BenchTimer timer;
+		operation( frame );
+		double seconds = timer.Seconds();
+		if (frame == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / NUM_ENTITIES;
+}
+
+// Write a record comparing separate objects against the entity store for one frame operation
+static void WriteRecord( JsonWriter& json, const string& name, double objectsNs, double storeNs, unsigned int matrixUpdates )
+{
+	json.BeginRecord( "scene", name );
+	json.Field( "entities", static_cast<unsigned long long>(NUM_ENTITIES) );
+	json.Field( "threads", static_cast<unsigned long long>(thread::hardware_concurrency()) );
+	json.Field( "objects_ns", objectsNs );
+	json.Field( "store_ns", storeNs );
+	json.Field( "speedup", objectsNs / storeNs );
+	json.Field( "matrix_updates", static_cast<unsigned long long>(matrixUpdates) );
+	json.EndRecord();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Scene files
+//--------------------------------------------------------------------------------------
+
+// Text of a scene with the given number of models, each with its own name and transform. The
+// models share a few materials and geometry files, some have controls or orbit the model before
+static string GenerateSceneText( int numModels )
+{
+	mt19937 random( 3 );
+	uniform_real_distribution<float> distribution( -1000.0f, 1000.0f );
+	char line[256];
+
+	string text = "background (0.2, 0.2, 0.3)\nambient (0.2, 0.2, 0.3)\nlightmodel Light.x\nlightmap Flare.jpg\n";
+	for (int i = 0; i < SCENE_FILE_MATERIALS; ++i)
+	{
+		snprintf( line, sizeof(line), "\nmaterial Material%d\n  technique Parallax\n  diffuse Diffuse%d.dds\n"
+		                              "  normal Normal%d.dds\n", i, i, i );
+		text += line;
+	}
+	for (int i = 0; i < numModels; ++i)
+	{
+		snprintf( line, sizeof(line), "\nmodel Model%d\n  geometry Mesh%d.x\n  material Material%d\n  tangents\n"
+		                              "  position (%.9g, %.9g, %.9g)\n  rotation (0, %d, 0)\n  scale 1.5\n",
+		          i, i % 8, i % SCENE_FILE_MATERIALS, distribution( random ), distribution( random ),
+		          distribution( random ), i % 360 );
+		text += line;
+		if (i % 100 == 0)  text += "  controls IKJLUO,.\n";
+		if (i % 50 == 1)
+		{
+			snprintf( line, sizeof(line), "  orbit Model%d 10 30\n", i - 1 );
+			text += line;
+		}
+	}
+	text += "\nlight Sun\n  type directional\n  direction (0, 1, 0)\n";
+	text += "\nlight Lamp\n  position (0, 50, 0)\n  animate pulse\n";
+	text += "\ncamera Main\n  position (0, 100, -500)\n  controls WSADEQZX\n";
+	return text;
+}
+
+// Are two scenes exactly the same (bit for bit, CVector3 comparison allows a small difference)
+static bool SameScene( const SceneDescription& a, const SceneDescription& b )
+{
+	auto Same = []( const auto& x, const auto& y )
+	{
+		return x.size() == y.size() && (x.empty() || memcmp( &x[0], &y[0], x.size() * sizeof(x[0]) ) == 0);
+	};
+	return memcmp( &a.backgroundColour, &b.backgroundColour, sizeof(CVector3) ) == 0 &&
+	       memcmp( &a.ambientColour, &b.ambientColour, sizeof(CVector3) ) == 0 &&
+	       a.lightGeometry == b.lightGeometry && a.lightMap == b.lightMap && Same( a.strings, b.strings ) &&
+	       Same( a.materials, b.materials ) && Same( a.models, b.models ) && Same( a.lights, b.lights ) &&
+	       Same( a.cameras, b.cameras ) && Same( a.portals, b.portals ) && Same( a.controls, b.controls ) &&
+	       Same( a.orbits, b.orbits );
+}
+
+// Time loading a scene file, returning the nanoseconds per model of the fastest load and the
+// allocations made by one load
+template <class Load>
+static double TimeSceneLoad( int numModels, unsigned long long* allocations, Load load )
+{
+	double fastest = 0.0;
+	BenchTimer caseTimer;
+	for (int i = 0; i < MAX_FRAMES && (i == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS); ++i)
+	{
+		SceneDescription scene;
+		ResetAllocStats();
+		BenchTimer timer;
+		bool ok = load( &scene );
+		double seconds = timer.Seconds();
+		*allocations = GetAllocStats().allocations;
+		if (!ok)  return 0.0;
+		if (i == 0 || seconds < fastest)  fastest = seconds;
+	}
+	return fastest * 1e9 / numModels;
+}
+
+// Load generated scenes of each size from their text and binary forms
+static void BenchmarkSceneFiles( JsonWriter& json )
+{
+	const string textFileName = "scene_benchmark.scene";
+	const string binaryFileName = "scene_benchmark.sceneb";
+	for (int size = 0; size < SCENE_FILE_SIZE_COUNT; ++size)
+	{
+		int numModels = SceneFileSizes[size];
+		string text = GenerateSceneText( numModels );
+		SceneDescription scene;
+		string error;
+		FILE* file = fopen( textFileName.c_str(), "wb" );
+		bool written = file && fwrite( text.data(), 1, text.size(), file ) == text.size();
+		if (file)  fclose( file );
+		if (!written || !LoadSceneText( textFileName, &scene, &error ) || !SaveSceneBinary( binaryFileName, scene, &error ))
+		{
+			fprintf( stderr, "Cannot create scene file: %s\n", error.c_str() );
+			remove( textFileName.c_str() );
+			continue;
+		}
+
+		// The binary form must load exactly the scene it was compiled from, and the text written from a
+		// scene must read back as the same scene (angles apart, which are written in degrees)
+		SceneDescription binaryScene, textScene;
+		bool binaryRoundTrip = LoadSceneBinary( binaryFileName, &binaryScene ) && SameScene( scene, binaryScene );
+		bool textRoundTrip = SaveSceneText( textFileName, scene ) && LoadSceneText( textFileName, &textScene ) &&
+		                     textScene.strings == scene.strings && textScene.models.size() == scene.models.size();
+		for (size_t i = 0; textRoundTrip && i < scene.models.size(); ++i)
+		{
+			textRoundTrip = memcmp( &textScene.models[i].position, &scene.models[i].position, sizeof(CVector3) ) == 0 &&
+			                textScene.models[i].orbit == scene.models[i].orbit &&
+			                textScene.models[i].material == scene.models[i].material;
+		}
+
+		unsigned long long textAllocations = 0, binaryAllocations = 0;
+		double textNs = TimeSceneLoad( numModels, &textAllocations, [&]( SceneDescription* loaded )
+		{
+			return LoadSceneText( textFileName, loaded );
+		} );
+		double binaryNs = TimeSceneLoad( numModels, &binaryAllocations, [&]( SceneDescription* loaded )
+		{
+			return LoadSceneBinary( binaryFileName, loaded );
+		} );
+
+		FILE* binaryFile = fopen( binaryFileName.c_str(), "rb" );
+		long binaryBytes = 0;
+		if (binaryFile)
+		{
+			fseek( binaryFile, 0, SEEK_END );
+			binaryBytes = ftell( binaryFile );
+			fclose( binaryFile );
+		}
+
+		json.BeginRecord( "scene", "load_scene_file" );
+		json.Field( "models", static_cast<unsigned long long>(numModels) );
+		json.Field( "text_bytes", static_cast<unsigned long long>(text.size()) );
+		json.Field( "binary_bytes", static_cast<unsigned long long>(binaryBytes) );
+		json.Field( "text_ns_per_model", textNs );
+		json.Field( "binary_ns_per_model", binaryNs );
+		json.Field( "speedup", binaryNs > 0.0 ? textNs / binaryNs : 0.0 );
+		json.Field( "text_allocations", textAllocations );
+		json.Field( "binary_allocations", binaryAllocations );
+		json.Field( "binary_round_trip", binaryRoundTrip );
+		json.Field( "text_round_trip", textRoundTrip );
+		json.EndRecord();
+
+		remove( textFileName.c_str() );
+		remove( binaryFileName.c_str() );
+	}
+}
+
+
+//--------------------------------------------------------------------------------------
+// Benchmark
+//--------------------------------------------------------------------------------------
+
+void RunSceneBenchmark( JsonWriter& json )
+{
+	vector<CVector3> positions( NUM_ENTITIES ), rotations( NUM_ENTITIES );
+	mt19937 random( 2 );
+	uniform_real_distribution<float> distribution( -100.0f, 100.0f );
+	for (int i = 0; i < NUM_ENTITIES; ++i)
+	{
+		positions[i] = CVector3( distribution( random ), distribution( random ), distribution( random ) );
+		rotations[i] = CVector3( distribution( random ), distribution( random ), distribution( random ) ) * 0.01f;
+	}
+
+	vector<SceneObject*> objects;
+	vector<char*> clutter;
+	CreateObjects( objects, clutter, positions, rotations );
+
+	struct SRenderable
+	{
+		void* geometry;
+		void* technique;
+		int   diffuseTexture;
+		int   normalTexture;
+		CVector3 tintColour;
+	};
+	EntityStore entities;
+	ComponentPool<SRenderable> renderables;
+	entities.Reserve( NUM_ENTITIES );
+	for (int i = 0; i < NUM_ENTITIES; ++i)
+	{
+		EntityHandle entity = entities.Create( positions[i], rotations[i] );
+		SRenderable renderable = { NULL, NULL, i, i, CVector3::kZero };
+		renderables.Add( entity, renderable );
+	}
+	entities.UpdateWorldMatrices();
+
+	// Every object turns then has its world matrix rebuilt
+	double objectsNs = TimePerEntity( [&]( int )
+	{
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			objects[i]->rotation.y += 0.01f;
+			objects[i]->matrixDirty = true;
+		}
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			SceneObject& object = *objects[i];
+			if (object.matrixDirty)
+			{
+				object.worldMatrix.MakeAffineEuler( object.position, object.rotation, kZXY, object.scale );
+				object.matrixDirty = false;
+			}
+		}
+	} );
+	double storeNs = TimePerEntity( [&]( int )
+	{
+		for (unsigned int i = 0; i < renderables.Size(); ++i)
+		{
+			EntityHandle entity = renderables.Owner( i );
+			CVector3 rotation = entities.Rotation( entity );
+			rotation.y += 0.01f;
+			entities.SetRotation( entity, rotation );
+		}
+		entities.UpdateWorldMatrices();
+	} );
+	WriteRecord( json, "update_all_moving", objectsNs, storeNs, entities.MatrixUpdates() );
+
+	// A few objects move, the rest only have their dirty flags checked
+	objectsNs = TimePerEntity( [&]( int frame )
+	{
+		for (size_t i = frame % MOVING_ONE_IN; i < objects.size(); i += MOVING_ONE_IN)
+		{
+			objects[i]->position.x += 0.01f;
+			objects[i]->matrixDirty = true;
+		}
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			SceneObject& object = *objects[i];
+			if (object.matrixDirty)
+			{
+				object.worldMatrix.MakeAffineEuler( object.position, object.rotation, kZXY, object.scale );
+				object.matrixDirty = false;
+			}
+		}
+	} );
+	storeNs = TimePerEntity( [&]( int frame )
+	{
+		for (unsigned int i = frame % MOVING_ONE_IN; i < renderables.Size(); i += MOVING_ONE_IN)
+		{
+			EntityHandle entity = renderables.Owner( i );
+			entities.SetPosition( entity, entities.Position( entity ) + CVector3( 0.01f, 0.0f, 0.0f ) );
+		}
+		entities.UpdateWorldMatrices();
+	} );
+	WriteRecord( json, "update_few_moving", objectsNs, storeNs, entities.MatrixUpdates() );
+
+	// Render loop: gather each object's world matrix and rendering data, as sent to the shaders
+	volatile float sink = 0.0f;
+	objectsNs = TimePerEntity( [&]( int )
+	{
+		float total = 0.0f;
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			const SceneObject& object = *objects[i];
+			total += object.worldMatrix.e30 + object.tintColour.x + static_cast<float>(object.diffuseTexture);
+		}
+		sink = total;
+	} );
+	storeNs = TimePerEntity( [&]( int )
+	{
+		float total = 0.0f;
+		for (unsigned int i = 0; i < renderables.Size(); ++i)
+		{
+			const SRenderable& renderable = renderables[i];
+			total += entities.WorldMatrix( renderables.Owner( i ) ).e30 + renderable.tintColour.x +
+			         static_cast<float>(renderable.diffuseTexture);
+		}
+		sink = total;
+	} );
+	WriteRecord( json, "render_gather", objectsNs, storeNs, 0 );
+
+	// Render loop with frustum culling, as each camera pass does: the bounding spheres of all entities are tested against
+	// the frustum, then only the visible entities are gathered. The camera is at the origin looking down z with a 90
+	// degree field of view, so sees part of the scene around it. Culling one sphere at a time is timed for comparison
+	CMatrix4x4 projection;
+	projection.MakeIdentity();
+	projection.e22 = 1000.0f / (1000.0f - 1.0f);
+	projection.e23 = 1.0f;
+	projection.e32 = -projection.e22;
+	projection.e33 = 0.0f;
+	const CFrustum frustum( projection );
+	const float boundingRadius = 2.0f;
+	vector<SSphere> spheres( renderables.Size() );
+	for (unsigned int i = 0; i < renderables.Size(); ++i)
+	{
+		EntityHandle entity = renderables.Owner( i );
+		spheres[i].centre = entities.WorldMatrix( entity ).TransformPoint( CVector3::kOrigin );
+		spheres[i].radius = boundingRadius * entities.MaxScale( entity );
+	}
+	vector<char> visibleStorage( spheres.size() ); // Not vector<bool>, which has no array of bools
+	bool* visible = reinterpret_cast<bool*>(&visibleStorage[0]);
+	size_t numVisible = frustum.CullSpheres( &spheres[0], visible, spheres.size() );
+	double singleCullNs = TimePerEntity( [&]( int )
+	{
+		for (size_t i = 0; i < spheres.size(); ++i)  visible[i] = frustum.IsSphereVisible( spheres[i] );
+	} );
+	double batchCullNs = TimePerEntity( [&]( int )
+	{
+		frustum.CullSpheres( &spheres[0], visible, spheres.size() );
+	} );
+	double culledNs = TimePerEntity( [&]( int )
+	{
+		frustum.CullSpheres( &spheres[0], visible, spheres.size() );
+		float total = 0.0f;
+		for (unsigned int i = 0; i < renderables.Size(); ++i)
+		{
+			if (!visible[i])  continue;
+			const SRenderable& renderable = renderables[i];
+			total += entities.WorldMatrix( renderables.Owner( i ) ).e30 + renderable.tintColour.x +
+			         static_cast<float>(renderable.diffuseTexture);
+		}
+		sink = total;
+	} );
+	json.BeginRecord( "scene", "render_gather_culled" );
+	json.Field( "entities", static_cast<unsigned long long>(NUM_ENTITIES) );
+	json.Field( "visible", static_cast<unsigned long long>(numVisible) );
+	json.Field( "culled", static_cast<unsigned long long>(spheres.size() - numVisible) );
+	json.Field( "single_cull_ns", singleCullNs );
+	json.Field( "batch_cull_ns", batchCullNs );
+	json.Field( "cull_speedup", singleCullNs / batchCullNs );
+	json.Field( "all_ns", storeNs );
+	json.Field( "culled_ns", culledNs );
+	json.Field( "speedup", storeNs / culledNs );
+	json.EndRecord();
+
+	// Creating and destroying objects - one in a hundred replaced each frame
+	objectsNs = TimePerEntity( [&]( int frame )
+	{
+		for (size_t i = frame % MOVING_ONE_IN; i < objects.size(); i += MOVING_ONE_IN)
+		{
+			delete objects[i];
+			objects[i] = new SceneObject;
+			objects[i]->position = positions[i];
+			objects[i]->rotation = rotations[i];
+			objects[i]->scale = CVector3( 1.0f, 1.0f, 1.0f );
+			objects[i]->matrixDirty = true;
+		}
+	} );
+	vector<EntityHandle> handles;
+	for (unsigned int i = 0; i < renderables.Size(); ++i)  handles.push_back( renderables.Owner( i ) );
+	storeNs = TimePerEntity( [&]( int frame )
+	{
+		for (size_t i = frame % MOVING_ONE_IN; i < handles.size(); i += MOVING_ONE_IN)
+		{
+			SRenderable renderable = *renderables.Get( handles[i] );
+			renderables.Remove( handles[i] );
+			entities.Destroy( handles[i] );
+			handles[i] = entities.Create( positions[i], rotations[i] );
+			renderables.Add( handles[i], renderable );
+		}
+	} );
+	WriteRecord( json, "replace_entities", objectsNs, storeNs, 0 );
+
+	DeleteObjects( objects, clutter );
+
+	BenchmarkSceneFiles( json );
+}
@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------------------------
+// Texture loading benchmark - decode time for each of the project's texture files, and the
+// time to load the whole set with different numbers of threads
+//--------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "Image.h"
+#include "ImageMips.h"
+#include <string.h>
+#include <thread>
+
+//--------------------------------------------------------------------------------------
+// Benchmark settings
+//--------------------------------------------------------------------------------------
+
+// Project textures to load (paths relative to the working directory - the project folder)
+static const char* TextureFiles[] =
+{
+	"BrainDiffuseSpecular.dds", "BrainNormalDepth.dds", "CobbleDiffuseSpecular.dds", "CobbleNormalDepth.dds",
+	"PatternDiffuseSpecular.dds", "PatternNormalDepth.dds", "TechDiffuseSpecular.dds", "TechNormalDepth.dds",
+	"WallDiffuseSpecular.dds", "WallNormalDepth.dds", "Flare.jpg", "Glass.jpg", "brick1.jpg", "stone1.jpg",
+	"tech02.jpg", "tiles1.jpg", "wood2.jpg", "Lines.png", "Moogle.png", "Smoke.png",
+};
+static const int TEXTURE_FILE_COUNT = sizeof(TextureFiles) / sizeof(TextureFiles[0]);
+
+// Thread counts for loading the whole set, 0 means one per hardware thread
+static const unsigned int LoadThreadCounts[] = { 1, 2, 4, 0 };
+static const int LOAD_THREAD_COUNT_COUNT = sizeof(LoadThreadCounts) / sizeof(LoadThreadCounts[0]);
+
+// Each case is repeated to reduce noise, with the fastest time kept
+static const double TARGET_CASE_SECONDS = 1.0;
+static const int    MAX_ITERATIONS = 20;
+
+
+//--------------------------------------------------------------------------------------
+// Suite entry point
+//--------------------------------------------------------------------------------------
+
+void RunTextureBenchmark( JsonWriter& json )
+{
+	// Single file loads on this thread, includes reading the file
+	for (int i = 0; i < TEXTURE_FILE_COUNT; ++i)
+	{
+		Image image;
+		string error;
+		double best = 0.0;
+		bool success = true;
+		int iterations = 0;
+		BenchTimer caseTimer;
+		while (success && iterations < MAX_ITERATIONS && (iterations == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS))
+		{
+			BenchTimer timer;
+			success = LoadImageFile( TextureFiles[i], &image, &error );
+			double seconds = timer.Seconds();
+			if (iterations == 0 || seconds < best)  best = seconds;
+			++iterations;
+		}
+
+		json.BeginRecord( "texture", TextureFiles[i] );
+		json.Field( "success", success );
+		if (success)
+		{
+			json.Field( "width", static_cast<unsigned long long>(image.width) );
+			json.Field( "height", static_cast<unsigned long long>(image.height) );
+			json.Field( "mips", static_cast<unsigned long long>(image.mips.size()) );
+			json.Field( "compressed", IsBlockCompressed( image.format ) );
+			json.Field( "bytes", static_cast<unsigned long long>(image.data.size()) );
+			json.Field( "iterations", static_cast<unsigned long long>(iterations) );
+			json.Field( "load_s", best );
+			json.Field( "mpixels_per_s", image.width * static_cast<double>(image.height) / best / 1e6 );
+		}
+		else
+		{
+			json.Field( "error", error );
+		}
+		json.EndRecord();
+	}
+
+	// Whole set loaded in parallel, as the scene does at startup
+	vector<string> fileNames( TextureFiles, TextureFiles + TEXTURE_FILE_COUNT );
+	double singleThread = 0.0;
+	for (int i = 0; i < LOAD_THREAD_COUNT_COUNT; ++i)
+	{
+		unsigned int threads = LoadThreadCounts[i] ? LoadThreadCounts[i] : thread::hardware_concurrency();
+		double best = 0.0;
+		bool success = true;
+		int iterations = 0;
+		BenchTimer caseTimer;
+		while (success && iterations < MAX_ITERATIONS && (iterations == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS))
+		{
+			vector<Image> images;
+			BenchTimer timer;
+			success = LoadImageFiles( fileNames, &images, NULL, threads );
+			double seconds = timer.Seconds();
+			if (iterations == 0 || seconds < best)  best = seconds;
+			++iterations;
+		}
+		if (i == 0)  singleThread = best;
+
+		char name[64];
+		if (LoadThreadCounts[i])  sprintf( name, "load_all_%u_threads", threads );
+		else                      sprintf( name, "load_all_hardware_threads" );
+		json.BeginRecord( "texture", name );
+		json.Field( "threads", static_cast<unsigned long long>(threads) );
+		json.Field( "success", success );
+		json.Field( "files", static_cast<unsigned long long>(fileNames.size()) );
+		json.Field( "iterations", static_cast<unsigned long long>(iterations) );
+		json.Field( "total_s", best );
+		json.Field( "speedup", singleThread / best );
+		json.EndRecord();
+	}
+
+	// Mip generation for the whole set, as colour or normal maps by file name, with each filter
+	vector<Image> images;
+	LoadImageFiles( fileNames, &images );
+	vector<MipContent> contents;
+	for (int i = 0; i < TEXTURE_FILE_COUNT; ++i)
+	{
+		contents.push_back( strstr( TextureFiles[i], "NormalDepth" ) ? MipContentNormalDepth : MipContentColour );
+	}
+	const MipFilter filters[2] = { MipFilterBox, MipFilterKaiser };
+	const char* filterNames[2] = { "mips_box", "mips_kaiser" };
+	for (int i = 0; i < 2; ++i)
+	{
+		double times[2] = { 0.0, 0.0 };
+		unsigned int threadCounts[2] = { 1, thread::hardware_concurrency() };
+		int iterations = 0;
+		for (int threads = 0; threads < 2; ++threads)
+		{
+			iterations = 0;
+			BenchTimer caseTimer;
+			while (iterations < MAX_ITERATIONS && (iterations == 0 || caseTimer.Seconds() < TARGET_CASE_SECONDS))
+			{
+				vector<Image> mipped = images;
+				vector<Image*> pointers;
+				for (size_t image = 0; image < mipped.size(); ++image)  pointers.push_back( &mipped[image] );
+				BenchTimer timer;
+				GenerateMips( pointers, contents, filters[i], threadCounts[threads] );
+				double seconds = timer.Seconds();
+				if (iterations == 0 || seconds < times[threads])  times[threads] = seconds;
+				++iterations;
+			}
+		}
+
+		json.BeginRecord( "texture", filterNames[i] );
+		json.Field( "files", static_cast<unsigned long long>(fileNames.size()) );
+		json.Field( "iterations", static_cast<unsigned long long>(iterations) );
+		json.Field( "single_thread_s", times[0] );
+		json.Field( "all_threads_s", times[1] );
+		json.Field( "threads", static_cast<unsigned long long>(threadCounts[1]) );
+		json.EndRecord();
+	}
+}
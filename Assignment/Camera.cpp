@@ -12,69 +12,70 @@
 
 // Constructor - initialise all camera settings - look at the constructor declaration in the
 // header file to see that there are defaults provided for everything
-Camera::Camera( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float fov, float nearClip, float farClip )
+Camera::Camera( const gen::CVector3& position, const gen::CVector3& rotation, float fov, float nearClip, float farClip )
 {
 	mPosition = position;
 	mRotation = rotation;
-	UpdateMatrices();
-
 	SetFOV( fov );
 	SetNearClip( nearClip );
 	SetFarClip( farClip );
+	mAspect = 1.33f;
+
+	mViewDirty = true;
+	mProjDirty = true;
+	UpdateMatrices();
 }
 
 
 //-------------------------------------
 // Camera Usage
 
-// Update the matrices used for the camera in the rendering pipeline. 
+// Update the matrices and frustum used for the camera in the rendering pipeline. Call once per
+// frame after moving the camera and before rendering
 void Camera::UpdateMatrices()
 {
 	// Treat the camera like a model and create a world matrix for it. Then convert that into the
 	// view matrix that the rendering pipeline actually uses. Also create the projection matrix,
 	// a second matrix that models don't have. It is used to project geometry from 3D into 2D
+	if (!mViewDirty && !mProjDirty)
+	{
+		return;
+	}
 
-	// Make matrices for position and rotations, then multiply together to get a "camera world matrix"
-	D3DXMATRIXA16 matrixXRot, matrixYRot, matrixZRot, matrixTranslation;
-	D3DXMatrixRotationX( &matrixXRot, mRotation.x );
-	D3DXMatrixRotationY( &matrixYRot, mRotation.y );
-	D3DXMatrixRotationZ( &matrixZRot, mRotation.z );
-	D3DXMatrixTranslation( &matrixTranslation, mPosition.x, mPosition.y, mPosition.z);
-	mWorldMatrix = matrixZRot * matrixXRot * matrixYRot * matrixTranslation;
-
-	// The rendering pipeline actually needs the inverse of the camera world matrix - called the
-	// view matrix. Creating an inverse is easy with DirectX:
-	D3DXMatrixInverse( &mViewMatrix, NULL, &mWorldMatrix );
+	if (mViewDirty)
+	{
+		// Build the "camera world matrix" ZRotation * XRotation * YRotation * Translation directly from
+		// the position and rotations, with one sine/cosine per rotation axis
+		mWorldMatrix.MakeAffineEuler( mPosition, mRotation, gen::kZXY );
+
+		// The rendering pipeline actually needs the inverse of the camera world matrix - called the
+		// view matrix. The camera has only rotation and translation, so the inverse is the transposed
+		// rotation and the translation rotated back - much cheaper than a general inverse
+		mViewMatrix = gen::InverseRotTrans( mWorldMatrix );
+	}
 
-	// Initialize the projection matrix. This determines viewing properties of the camera such as
-	// field of view (FOV) and near clip distance. One other factor in the projection matrix is the
-	// aspect ratio of screen (width/height) - used to adjust FOV between horizontal and vertical
-	float aspect = (float)ViewportWidth / ViewportHeight; 
-	D3DXMatrixPerspectiveFovLH( &mProjMatrix, mFOV, 1.33f, mNearClip, mFarClip );
+	if (mProjDirty)
+	{
+		// Initialize the projection matrix. This determines viewing properties of the camera such as
+		// field of view (FOV) and near clip distance. One other factor in the projection matrix is the
+		// aspect ratio of screen (width/height) - used to adjust FOV between horizontal and vertical.
+		// Left-handed perspective projection as D3DXMatrixPerspectiveFovLH
+		float yScale = 1.0f / tanf( mFOV * 0.5f );
+		float depthScale = mFarClip / (mFarClip - mNearClip);
+		mProjMatrix = gen::CMatrix4x4( yScale / mAspect, 0.0f,   0.0f,                     0.0f,
+		                               0.0f,             yScale, 0.0f,                     0.0f,
+		                               0.0f,             0.0f,   depthScale,               1.0f,
+		                               0.0f,             0.0f,   -mNearClip * depthScale,  0.0f );
+	}
 
 	// Combine the view and projection matrix into a single matrix - which can (optionally) be used
-	// in the vertex shaders to save one matrix multiply per vertex
+	// in the vertex shaders to save one matrix multiply per vertex. The frustum planes come from the
+	// same matrix
 	mViewProjMatrix = mViewMatrix * mProjMatrix;
-}
+	mFrustum = gen::CFrustum( mViewProjMatrix );
 
-// Read only access to camera matrices, created every frame from position, rotation and camera settings
-D3DXMATRIX Camera::ViewMatrix()
-{
-	// Everytime there is a request for a matrix, it is recalculated from the current position, scale etc.
-	UpdateMatrices();
-	return mViewMatrix;
-}
-D3DXMATRIX Camera::ProjectionMatrix()
-{
-	// Everytime there is a request for a matrix, it is recalculated from the current position, scale etc.
-	UpdateMatrices();
-	return mProjMatrix;
-}
-D3DXMATRIX Camera::ViewProjectionMatrix()
-{
-	// Everytime there is a request for a matrix, it is recalculated from the current position, scale etc.
-	UpdateMatrices();
-	return mViewProjMatrix;
+	mViewDirty = false;
+	mProjDirty = false;
 }
 
 
@@ -85,45 +86,45 @@ void Camera::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyC
 	if (KeyHeld( turnDown ))
 	{
 		mRotation.x += kRotationSpeed * frameTime;
+		mViewDirty = true;
 	}
 	if (KeyHeld( turnUp ))
 	{
 		mRotation.x -= kRotationSpeed * frameTime;
+		mViewDirty = true;
 	}
 	if (KeyHeld( turnRight ))
 	{
 		mRotation.y += kRotationSpeed * frameTime;
+		mViewDirty = true;
 	}
 	if (KeyHeld( turnLeft ))
 	{
 		mRotation.y -= kRotationSpeed * frameTime;
+		mViewDirty = true;
 	}
 
 	// Local X movement - move in the direction of the X axis, get axis from camera's "world" matrix
 	if (KeyHeld( moveRight ))
 	{
-		mPosition.x += mWorldMatrix._11 * kMovementSpeed * frameTime;
-		mPosition.y += mWorldMatrix._12 * kMovementSpeed * frameTime;
-		mPosition.z += mWorldMatrix._13 * kMovementSpeed * frameTime;
+		mPosition += mWorldMatrix.XAxis() * kMovementSpeed * frameTime;
+		mViewDirty = true;
 	}
 	if (KeyHeld( moveLeft ))
 	{
-		mPosition.x -= mWorldMatrix._11 * kMovementSpeed * frameTime;
-		mPosition.y -= mWorldMatrix._12 * kMovementSpeed * frameTime;
-		mPosition.z -= mWorldMatrix._13 * kMovementSpeed * frameTime;
+		mPosition -= mWorldMatrix.XAxis() * kMovementSpeed * frameTime;
+		mViewDirty = true;
 	}
 
 	// Local Z movement - move in the direction of the Z axis, get axis from view matrix
 	if (KeyHeld( moveForward ))
 	{
-		mPosition.x += mWorldMatrix._31 * kMovementSpeed * frameTime;
-		mPosition.y += mWorldMatrix._32 * kMovementSpeed * frameTime;
-		mPosition.z += mWorldMatrix._33 * kMovementSpeed * frameTime;
+		mPosition += mWorldMatrix.ZAxis() * kMovementSpeed * frameTime;
+		mViewDirty = true;
 	}
 	if (KeyHeld( moveBackward ))
 	{
-		mPosition.x -= mWorldMatrix._31 * kMovementSpeed * frameTime;
-		mPosition.y -= mWorldMatrix._32 * kMovementSpeed * frameTime;
-		mPosition.z -= mWorldMatrix._33 * kMovementSpeed * frameTime;
+		mPosition -= mWorldMatrix.ZAxis() * kMovementSpeed * frameTime;
+		mViewDirty = true;
 	}
 }
@@ -9,30 +9,47 @@
 #include "Input.h"
 #include <d3d10.h>
 #include <d3dx10.h>
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "Intersection.h"
+#include "AlignedAllocator.h"
 
 class Camera
 {
+	// The matrices are 16-byte aligned gen::CMatrix4x4s, so cameras created with new must be aligned
+	// too
+	GEN_ALIGNED_NEW( 16 );
+
 //-------------------------------------
 // Private member variables
 //-------------------------------------
 private:
 
 	// Postition and rotations for the camera (rarely scale cameras)
-	D3DXVECTOR3 mPosition;
-	D3DXVECTOR3 mRotation;
+	gen::CVector3 mPosition;
+	gen::CVector3 mRotation;
 
-	// Camera settings: field of view, near and far clip plane distances.
-	// Note that the FOV angle is measured in radians (radians = degrees * PI/180)
+	// Camera settings: field of view, near and far clip plane distances, and aspect ratio of the
+	// viewport (width / height). Note that the FOV angle is measured in radians (radians = degrees * PI/180)
 	float mFOV;
 	float mNearClip;
 	float mFarClip;
+	float mAspect;
+
+	// Current view, projection and combined view-projection matrices (same layout as DirectX matrices)
+	gen::CMatrix4x4 mWorldMatrix;    // Easiest to treat the camera like a model and give it a "world" matrix...
+	gen::CMatrix4x4 mViewMatrix;     // ... the view matrix used in the pipeline is the inverse of its world matrix
+	gen::CMatrix4x4 mProjMatrix;     // Projection matrix to set field of view and near/far clip distances
+	gen::CMatrix4x4 mViewProjMatrix; // Combine (multiply) the view and projection matrices together, which
+	                                 // saves a matrix multiply in the shader (optional optimisation)
+
+	// Planes of the volume the camera can see, from the view-projection matrix, for culling
+	gen::CFrustum mFrustum;
 
-	// Current view, projection and combined view-projection matrices (DirectX matrix type)
-	D3DXMATRIX mWorldMatrix;    // Easiest to treat the camera like a model and give it a "world" matrix...
-	D3DXMATRIX mViewMatrix;     // ... the view matrix used in the pipeline is the inverse of its world matrix
-	D3DXMATRIX mProjMatrix;     // Projection matrix to set field of view and near/far clip distances
-	D3DXMATRIX mViewProjMatrix; // Combine (multiply) the view and projection matrices together, which
-	                             // saves a matrix multiply in the shader (optional optimisation)
+	// Which matrices are out of date: the view matrix when the position or rotation has changed, the
+	// projection matrix when the FOV, clip distances or aspect have changed
+	bool mViewDirty;
+	bool mProjDirty;
 
 
 //-------------------------------------
@@ -44,36 +61,42 @@ public:
 	// Constructors / Destructors
 
 	// Constructor - initialise all settings, sensible defaults provided for everything.
-	Camera( D3DXVECTOR3 position = D3DXVECTOR3(0,0,0), D3DXVECTOR3 rotation = D3DXVECTOR3(0,0,0),
-	        float fov = D3DX_PI/4, float nearClip = 0.1f, float farClip = 10000.0f );
+	Camera( const gen::CVector3& position = gen::CVector3::kOrigin, const gen::CVector3& rotation = gen::CVector3::kZero,
+	        float fov = gen::kfPi/4, float nearClip = 0.1f, float farClip = 10000.0f );
 
 
 	//-------------------------------------
 	// Data access
 
 	// Getters / setters for data we want to expose
-	D3DXVECTOR3 Position()  { return mPosition; }
-	D3DXVECTOR3 Rotation()  { return mRotation;	}
-	void SetPosition( D3DXVECTOR3 position )  { mPosition = position; }
-	void SetRotation( D3DXVECTOR3 rotation )  { mRotation = rotation; }
-
-	float FOV()       { return mFOV;      }
-	float NearClip()  { return mNearClip; }
-	float FarClip()   { return mFarClip;  }
-	void SetFOV     ( float fov      )  { mFOV      = fov;      }
-	void SetNearClip( float nearClip )  { mNearClip = nearClip; }
-	void SetFarClip ( float farClip  )  { mFarClip  = farClip;  }
-
-	// Read only access to camera matrices, created every frame from position, rotation and camera settings
-	D3DXMATRIX ViewMatrix();
-	D3DXMATRIX ProjectionMatrix();
-	D3DXMATRIX ViewProjectionMatrix();
+	gen::CVector3 Position() const  { return mPosition; }
+	gen::CVector3 Rotation() const  { return mRotation;	}
+	void SetPosition( const gen::CVector3& position )  { mPosition = position;  mViewDirty = true; }
+	void SetRotation( const gen::CVector3& rotation )  { mRotation = rotation;  mViewDirty = true; }
+
+	float FOV() const       { return mFOV;      }
+	float NearClip() const  { return mNearClip; }
+	float FarClip() const   { return mFarClip;  }
+	float Aspect() const    { return mAspect;   }
+	void SetFOV     ( float fov      )  { mFOV      = fov;       mProjDirty = true; }
+	void SetNearClip( float nearClip )  { mNearClip = nearClip;  mProjDirty = true; }
+	void SetFarClip ( float farClip  )  { mFarClip  = farClip;   mProjDirty = true; }
+	void SetAspect  ( float aspect   )  { if (aspect != mAspect)  { mAspect = aspect;  mProjDirty = true; } }
+
+	// Read only access to the camera matrices and frustum as of the last call to UpdateMatrices. They
+	// do not change during a frame however many renderers use them
+	const gen::CMatrix4x4& ViewMatrix() const            { return mViewMatrix;     }
+	const gen::CMatrix4x4& ProjectionMatrix() const      { return mProjMatrix;     }
+	const gen::CMatrix4x4& ViewProjectionMatrix() const  { return mViewProjMatrix; }
+	const gen::CFrustum&   Frustum() const               { return mFrustum;        }
 
 	
 	//-------------------------------------
 	// Camera Usage
 
-	// Update the matrices used for the camera in the rendering pipeline
+	// Update the matrices and frustum used for the camera in the rendering pipeline. Call once per
+	// frame after moving the camera and before rendering. Only the matrices affected by changes
+	// since the last call are recalculated, so a camera that has not changed costs nothing
 	void UpdateMatrices();
 
 	// Control the camera's position and rotation using keys provided
@@ -0,0 +1,164 @@
+//--------------------------------------------------------------------------------------
+//	Data-oriented storage for the objects in a scene. Each entity is just a handle, its
+//	components (transform, rendering, light, control...) are held in dense arrays with
+//	no gaps, so the systems that update and render the scene run through contiguous
+//	memory however many thousands of entities there are
+//--------------------------------------------------------------------------------------
+
+#include "EntityStore.h"
+#include "Parallel.h"
+#include <atomic>
+
+// Fewest world matrices given to each thread by UpdateWorldMatrices. Starting a thread costs about
+// as much as building a few thousand matrices, so typical scenes update on the calling thread
+static const size_t kMinMatricesPerThread = 8192;
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+EntityStore::EntityStore()
+{
+	mMatrixUpdates = 0;
+}
+
+
+///////////////////////////////
+// Entities
+
+// Create an entity with the given transform, returning its handle
+EntityHandle EntityStore::Create( const gen::CVector3& position, const gen::CVector3& rotation, float scale )
+{
+	// Reuse the slot of a destroyed entity if there is one - its generation was increased when the
+	// entity was destroyed, so old handles to the slot stay invalid
+	EntityHandle entity;
+	if (!mFreeSlots.empty())
+	{
+		entity.index = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		entity.index = static_cast<unsigned int>(mDense.size());
+		mDense.push_back( kNoIndex );
+		mGenerations.push_back( 0 );
+	}
+	entity.generation = mGenerations[entity.index];
+
+	// The new transform goes on the end of the dense arrays
+	mDense[entity.index] = static_cast<unsigned int>(mEntities.size());
+	mPositions.push_back( position );
+	mRotations.push_back( rotation );
+	mScales.push_back( gen::CVector3( scale, scale, scale ) );
+	mWorldMatrices.push_back( gen::CMatrix4x4::kIdentity );
+	mMatrixDirty.push_back( 1 );
+	mEntities.push_back( entity );
+	return entity;
+}
+
+// Destroy an entity. The last transform moves into the gap so the arrays stay dense
+void EntityStore::Destroy( EntityHandle entity )
+{
+	if (!IsValid( entity ))
+	{
+		return;
+	}
+
+	unsigned int dense = mDense[entity.index];
+	unsigned int last = Count() - 1;
+	if (dense != last)
+	{
+		mPositions[dense]     = mPositions[last];
+		mRotations[dense]     = mRotations[last];
+		mScales[dense]        = mScales[last];
+		mWorldMatrices[dense] = mWorldMatrices[last];
+		mMatrixDirty[dense]   = mMatrixDirty[last];
+		mEntities[dense]      = mEntities[last];
+		mDense[mEntities[dense].index] = dense;
+	}
+	mPositions.pop_back();
+	mRotations.pop_back();
+	mScales.pop_back();
+	mWorldMatrices.pop_back();
+	mMatrixDirty.pop_back();
+	mEntities.pop_back();
+
+	mDense[entity.index] = kNoIndex;
+	++mGenerations[entity.index];
+	mFreeSlots.push_back( entity.index );
+}
+
+// Destroy all entities. The slots are kept with increased generations so all old handles are invalid
+void EntityStore::Clear()
+{
+	mFreeSlots.clear();
+	for (unsigned int slot = 0; slot < mDense.size(); ++slot)
+	{
+		if (mDense[slot] != kNoIndex)
+		{
+			mDense[slot] = kNoIndex;
+			++mGenerations[slot];
+		}
+		mFreeSlots.push_back( slot );
+	}
+	mPositions.clear();
+	mRotations.clear();
+	mScales.clear();
+	mWorldMatrices.clear();
+	mMatrixDirty.clear();
+	mEntities.clear();
+}
+
+// Reserve space for the given number of entities
+void EntityStore::Reserve( unsigned int count )
+{
+	mPositions.reserve( count );
+	mRotations.reserve( count );
+	mScales.reserve( count );
+	mWorldMatrices.reserve( count );
+	mMatrixDirty.reserve( count );
+	mEntities.reserve( count );
+	mDense.reserve( count );
+	mGenerations.reserve( count );
+}
+
+
+///////////////////////////////
+// Transforms
+
+// Largest scale on any axis of an entity. Scaling may differ on each axis, so bounding spheres
+// must use the largest
+float EntityStore::MaxScale( EntityHandle entity ) const
+{
+	const gen::CVector3& scale = Scale( entity );
+	return gen::Max( gen::Abs( scale.x ), gen::Max( gen::Abs( scale.y ), gen::Abs( scale.z ) ) );
+}
+
+
+///////////////////////////////
+// Systems
+
+// Rebuild the world matrices of all entities whose position, rotation or scale has changed
+unsigned int EntityStore::UpdateWorldMatrices()
+{
+	// Each matrix is the combination Scaling * ZRotation * XRotation * YRotation * Translation, as
+	// for the Model class. Each thread works on its own range of the arrays so needs no locking,
+	// only the count of rebuilt matrices is shared
+	atomic<unsigned int> updates( 0 );
+	gen::ParallelRanges( mEntities.size(), kMinMatricesPerThread, 0, [&]( size_t begin, size_t end )
+	{
+		unsigned int rangeUpdates = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (mMatrixDirty[i])
+			{
+				mWorldMatrices[i].MakeAffineEuler( mPositions[i], mRotations[i], gen::kZXY, mScales[i] );
+				mMatrixDirty[i] = 0;
+				++rangeUpdates;
+			}
+		}
+		updates += rangeUpdates;
+	} );
+	mMatrixUpdates = updates;
+	return mMatrixUpdates;
+}
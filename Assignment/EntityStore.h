@@ -0,0 +1,291 @@
+//--------------------------------------------------------------------------------------
+//	Data-oriented storage for the objects in a scene. Each entity is just a handle, its
+//	components (transform, rendering, light, control...) are held in dense arrays with
+//	no gaps, so the systems that update and render the scene run through contiguous
+//	memory however many thousands of entities there are
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_ENTITY_STORE_H_INCLUDED
+#define CO2409_ENTITY_STORE_H_INCLUDED
+
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "AlignedAllocator.h"
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+//--------------------------------------------------------------------------------------
+// Entity handles
+//--------------------------------------------------------------------------------------
+
+// Handle to an entity. Handles stay valid while their entity exists, however many other entities
+// are created or destroyed. Each slot's generation is increased when its entity is destroyed, so a
+// handle kept after that is detected (IsValid) rather than referring to a later entity
+struct EntityHandle
+{
+	unsigned int index;      // Slot in the entity store's handle table
+	unsigned int generation; // Generation of that slot when the entity was created
+};
+
+inline bool operator==( const EntityHandle& a, const EntityHandle& b )
+{
+	return a.index == b.index && a.generation == b.generation;
+}
+inline bool operator!=( const EntityHandle& a, const EntityHandle& b )
+{
+	return !(a == b);
+}
+
+// A handle that never refers to an entity
+const EntityHandle kNoEntity = { 0xffffffff, 0 };
+
+// Marks an unused entry in the index tables of entity stores and component pools
+const unsigned int kNoIndex = 0xffffffff;
+
+
+//--------------------------------------------------------------------------------------
+// Component pools
+//--------------------------------------------------------------------------------------
+
+// Dense array of one type of component, each belonging to an entity. Components are stored with
+// no gaps in the order they were added (or as sorted), and removal moves the last component into
+// the gap. Systems iterate over the components by index from 0 to Size() - 1, with Owner giving
+// the entity of each. A component is looked up from its entity in constant time. Pools are
+// separate from the entity store, so an entity's components should be removed before it is
+// destroyed - components of a destroyed entity are not found by Get, but remain in the pool
+template <class T>
+class ComponentPool
+{
+//-------------------------------------
+// Private member variables
+//-------------------------------------
+private:
+	vector<T>            mComponents; // Dense array of components...
+	vector<EntityHandle> mOwners;     // ...and the entity each one belongs to
+	vector<unsigned int> mLookup;     // Index in the arrays above for each entity slot, kNoIndex if none
+
+
+//-------------------------------------
+// Public member functions
+//-------------------------------------
+public:
+
+	//-------------------------------------
+	// Adding / removing components
+
+	// Give an entity a component, replacing any it already has. Returns the stored component
+	T& Add( EntityHandle entity, const T& component )
+	{
+		if (entity.index >= mLookup.size())  mLookup.resize( entity.index + 1, kNoIndex );
+		unsigned int dense = mLookup[entity.index];
+		if (dense != kNoIndex)
+		{
+			mComponents[dense] = component;
+			mOwners[dense] = entity;
+			return mComponents[dense];
+		}
+		mLookup[entity.index] = static_cast<unsigned int>(mComponents.size());
+		mComponents.push_back( component );
+		mOwners.push_back( entity );
+		return mComponents.back();
+	}
+
+	// Remove an entity's component, if it has one. The last component moves into its place
+	void Remove( EntityHandle entity )
+	{
+		if (entity.index >= mLookup.size() || mLookup[entity.index] == kNoIndex)  return;
+		unsigned int dense = mLookup[entity.index];
+		if (mOwners[dense].generation != entity.generation)  return; // Belongs to a later entity in the slot
+		unsigned int last = static_cast<unsigned int>(mComponents.size()) - 1;
+		if (dense != last)
+		{
+			mComponents[dense] = mComponents[last];
+			mOwners[dense] = mOwners[last];
+			mLookup[mOwners[dense].index] = dense;
+		}
+		mComponents.pop_back();
+		mOwners.pop_back();
+		mLookup[entity.index] = kNoIndex;
+	}
+
+	// Remove all components
+	void Clear()
+	{
+		mComponents.clear();
+		mOwners.clear();
+		mLookup.clear();
+	}
+
+
+	//-------------------------------------
+	// Component access
+
+	// The component of an entity, NULL if it has none (or the handle is out of date)
+	T* Get( EntityHandle entity )
+	{
+		if (entity.index >= mLookup.size() || mLookup[entity.index] == kNoIndex)  return NULL;
+		unsigned int dense = mLookup[entity.index];
+		return mOwners[dense].generation == entity.generation ? &mComponents[dense] : NULL;
+	}
+
+	// Dense access for systems, index from 0 to Size() - 1. Indexes change when components are
+	// removed or sorted
+	unsigned int Size() const                   { return static_cast<unsigned int>(mComponents.size()); }
+	T&           operator[]( unsigned int i )   { return mComponents[i]; }
+	EntityHandle Owner( unsigned int i ) const  { return mOwners[i]; }
+
+
+	//-------------------------------------
+	// Ordering
+
+	// Put the components in order using the given comparison of two components (a stable sort), e.g.
+	// to render components that share state one after another
+	template <class Less>
+	void Sort( Less less )
+	{
+		vector<unsigned int> order( mComponents.size() );
+		for (unsigned int i = 0; i < order.size(); ++i)  order[i] = i;
+		stable_sort( order.begin(), order.end(), [&]( unsigned int a, unsigned int b )
+		{
+			return less( mComponents[a], mComponents[b] );
+		} );
+
+		vector<T> components;
+		vector<EntityHandle> owners;
+		components.reserve( order.size() );
+		owners.reserve( order.size() );
+		for (unsigned int i = 0; i < order.size(); ++i)
+		{
+			components.push_back( mComponents[order[i]] );
+			owners.push_back( mOwners[order[i]] );
+			mLookup[owners.back().index] = i;
+		}
+		mComponents.swap( components );
+		mOwners.swap( owners );
+	}
+};
+
+
+//--------------------------------------------------------------------------------------
+// Entity store
+//--------------------------------------------------------------------------------------
+
+// Creates and destroys entities, and holds the transform that every entity has: position, rotation,
+// scale and world matrix. Each part of the transform is in its own dense array (structure of
+// arrays), so updating the world matrices reads only the data it needs. Other components are held
+// in ComponentPools alongside the store
+class EntityStore
+{
+//-------------------------------------
+// Private member variables
+//-------------------------------------
+private:
+	// Transforms, one per entity, without gaps. The world matrix is built from the position,
+	// rotation and scale by UpdateWorldMatrices, only when they have changed
+	vector<gen::CVector3> mPositions;
+	vector<gen::CVector3> mRotations;
+	vector<gen::CVector3> mScales;
+	vector<gen::CMatrix4x4, gen::CAlignedAllocator<gen::CMatrix4x4> > mWorldMatrices;
+	vector<unsigned char> mMatrixDirty; // Non-zero if the position, rotation or scale changed since
+	                                    // the matrix was built (not vector<bool>, which threads cannot share)
+	vector<EntityHandle>  mEntities;    // Entity of each transform
+
+	// Handle table: for each slot the index of its entity's transform (if it has an entity) and the
+	// current generation. Slots of destroyed entities are reused, most recent first
+	vector<unsigned int> mDense;
+	vector<unsigned int> mGenerations;
+	vector<unsigned int> mFreeSlots;
+
+	// Number of world matrices rebuilt by the last UpdateWorldMatrices
+	unsigned int mMatrixUpdates;
+
+
+//-------------------------------------
+// Public member functions
+//-------------------------------------
+public:
+
+	//-------------------------------------
+	// Constructors / Destructors
+
+	EntityStore();
+
+
+	//-------------------------------------
+	// Entities
+
+	// Create an entity with the given transform, returning its handle. Its world matrix is built
+	// by the next UpdateWorldMatrices
+	EntityHandle Create( const gen::CVector3& position = gen::CVector3::kOrigin,
+	                     const gen::CVector3& rotation = gen::CVector3::kZero, float scale = 1 );
+
+	// Destroy an entity. Its transform is replaced by the last one, so dense indexes change. Does
+	// nothing if the handle is out of date. Remove the entity's components from any pools first
+	void Destroy( EntityHandle entity );
+
+	// Destroy all entities, all existing handles become invalid
+	void Clear();
+
+	// Does the handle refer to an existing entity
+	bool IsValid( EntityHandle entity ) const
+	{
+		return entity.index < mDense.size() && mDense[entity.index] != kNoIndex &&
+		       mGenerations[entity.index] == entity.generation;
+	}
+
+	// Number of entities, also the number of transforms
+	unsigned int Count() const  { return static_cast<unsigned int>(mEntities.size()); }
+
+	// Reserve space for the given number of entities, to avoid reallocating when creating many
+	void Reserve( unsigned int count );
+
+
+	//-------------------------------------
+	// Transforms
+
+	// Getters / setters for an entity's transform. The handle must be valid
+	const gen::CVector3& Position( EntityHandle entity ) const  { return mPositions[mDense[entity.index]]; }
+	const gen::CVector3& Rotation( EntityHandle entity ) const  { return mRotations[mDense[entity.index]]; }
+	const gen::CVector3& Scale   ( EntityHandle entity ) const  { return mScales   [mDense[entity.index]]; }
+	void SetPosition( EntityHandle entity, const gen::CVector3& position )  { SetTransformPart( mPositions, entity, position ); }
+	void SetRotation( EntityHandle entity, const gen::CVector3& rotation )  { SetTransformPart( mRotations, entity, rotation ); }
+	// Two ways to set scale: x,y,z separately, or all to the same value
+	void SetScale   ( EntityHandle entity, const gen::CVector3& scale    )  { SetTransformPart( mScales, entity, scale ); }
+	void SetScale   ( EntityHandle entity, float scale                   )  { SetTransformPart( mScales, entity, gen::CVector3( scale, scale, scale ) ); }
+
+	// World matrix of an entity as of the last UpdateWorldMatrices
+	const gen::CMatrix4x4& WorldMatrix( EntityHandle entity ) const  { return mWorldMatrices[mDense[entity.index]]; }
+
+	// Largest scale on any axis of an entity, e.g. to scale a bounding radius
+	float MaxScale( EntityHandle entity ) const;
+
+
+	//-------------------------------------
+	// Systems
+
+	// Rebuild the world matrices of all entities whose position, rotation or scale has changed, in
+	// one pass through the transform arrays. Large numbers of entities are split over threads. Call
+	// once per frame after everything has moved. Returns the number of matrices rebuilt
+	unsigned int UpdateWorldMatrices();
+
+	// Number of world matrices rebuilt by the last UpdateWorldMatrices
+	unsigned int MatrixUpdates() const  { return mMatrixUpdates; }
+
+
+//-------------------------------------
+// Private member functions
+//-------------------------------------
+private:
+	// Set part of an entity's transform and mark its world matrix as out of date
+	void SetTransformPart( vector<gen::CVector3>& part, EntityHandle entity, const gen::CVector3& value )
+	{
+		unsigned int dense = mDense[entity.index];
+		part[dense] = value;
+		mMatrixDirty[dense] = 1;
+	}
+};
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,532 @@
+//--------------------------------------------------------------------------------------
+//	The geometry class holds the vertex and index data loaded from a file, ready to render.
+//	Loaded geometry is shared: models using the same file and import options refer to a
+//	single reference-counted geometry object rather than each loading their own copy
+//--------------------------------------------------------------------------------------
+
+#include "Geometry.h"
+#include "Device.h"
+#include "CImportXFile.h" // Class to load meshes (taken from another graphics engine)
+#include <map>
+
+//-------------------------------------
+// Geometry registry
+
+// All loaded geometry, keyed by file name and import options (just tangents at present)
+typedef pair<string, bool> GeometryKey;
+static map<GeometryKey, Geometry*> LoadedGeometry;
+
+
+/////////////////////////////
+// Shared geometry
+
+// Get the geometry for the given file and import options, loading it only if no other model is
+// already using it. Each successful call must be matched by a call to Release
+Geometry* Geometry::Acquire( const string& fileName, bool tangents, bool progressive )
+{
+	// Share existing geometry if possible
+	GeometryKey key( fileName, tangents );
+	map<GeometryKey, Geometry*>::iterator existing = LoadedGeometry.find( key );
+	if (existing != LoadedGeometry.end())
+	{
+		++existing->second->mRefCount;
+		return existing->second;
+	}
+
+	// Otherwise load it
+	Geometry* geometry = new Geometry( fileName, tangents );
+	if (progressive)
+	{
+		geometry->LoadProgressive();
+	}
+	else if (!geometry->Load())
+	{
+		delete geometry;
+		return NULL;
+	}
+	LoadedGeometry[key] = geometry;
+	return geometry;
+}
+
+// Finish using this geometry, it is deleted when no models are using it
+void Geometry::Release()
+{
+	if (--mRefCount == 0)
+	{
+		// Failed progressive loads are already removed from the registry
+		map<GeometryKey, Geometry*>::iterator entry = LoadedGeometry.find( GeometryKey( mFileName, mTangents ) );
+		if (entry != LoadedGeometry.end() && entry->second == this)
+		{
+			LoadedGeometry.erase( entry );
+		}
+		delete this;
+	}
+}
+
+// Number of geometry objects currently loaded
+unsigned int Geometry::LoadedCount()
+{
+	return static_cast<unsigned int>(LoadedGeometry.size());
+}
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+Geometry::Geometry( const string& fileName, bool tangents )
+{
+	mFileName = fileName;
+	mTangents = tangents;
+	mRefCount = 1;
+
+	// Good practice to ensure all private data is sensibly initialised
+	mVertexBuffer = NULL;
+	mNumVertices = 0;
+	mNumVertexElts = 0;
+	mVertexSize = 0;
+
+	mIndexBuffer = NULL;
+	mNumIndices = 0;
+
+	mBoundingCentre = D3DXVECTOR3( 0, 0, 0 );
+	mBoundingRadius = 0.0f;
+	mUVDensity = 0.0f;
+
+	mLoadState = NotLoading;
+	mLoadMesh = NULL;
+	mLoadedFaces = 0;
+	mLoadedVertices = 0;
+
+	mHasGeometry = false;
+}
+
+Geometry::~Geometry()
+{
+	// Stop any progressive load before releasing what it is filling
+	CancelLoading();
+
+	for (unsigned int i = 0; i < mVertexLayouts.size(); ++i)
+	{
+		mVertexLayouts[i].layout->Release();
+	}
+	if (mIndexBuffer )  mIndexBuffer ->Release();
+	if (mVertexBuffer)  mVertexBuffer->Release();
+}
+
+
+/////////////////////////////
+// Loading
+
+// The loading and parsing of ".X" files is supported using a class taken from another application.
+// We will not look at the process (more to do with parsing than graphics). Ultimately we end up
+// with arrays of data just like the previous labs where the geometry was typed in to the code
+
+// Load the geometry from the file. This function only reads the geometry using the first material
+// in the file, so multi-material models will load but will have parts missing. Returns true if the
+// load was successful
+bool Geometry::Load()
+{
+	// Use CImportXFile class (from another application) to load the given file. The import code is wrapped in the namespace 'gen'
+	gen::CImportXFile mesh;
+	if (mesh.ImportFile( mFileName.c_str() ) != gen::kSuccess)
+	{
+		return false;
+	}
+
+	// Get first sub-mesh from loaded file
+	gen::SSubMesh subMesh;
+	if (mesh.GetSubMesh( 0, &subMesh, mTangents ) != gen::kSuccess)
+	{
+		return false;
+	}
+
+	// Create the vertex description and buffers from the imported data, the imported data is no
+	// longer needed after that
+	CreateVertexElements( subMesh );
+	CalculateBounds( subMesh );
+	bool success = CreateBuffers( subMesh, true );
+	delete[] subMesh.vertices;
+	delete[] subMesh.faces;
+	if (!success)
+	{
+		return false;
+	}
+	mNumIndices = static_cast<unsigned int>(subMesh.numFaces) * 3;
+
+	mHasGeometry = true;
+	return true;
+}
+
+// Start loading the geometry in the background. The file is imported on a background thread, then
+// UpdateLoading must be called each frame to upload the geometry to the GPU a chunk at a time
+void Geometry::LoadProgressive()
+{
+	mLoadMesh = new gen::SSubMesh;
+	mLoadMesh->vertices = NULL;
+	mLoadMesh->faces = NULL;
+	mLoadMesh->faceAdjacency = NULL;
+	mLoadedFaces = 0;
+	mLoadedVertices = 0;
+
+	// Import on a background thread. The thread only touches the import data and the load state,
+	// all Direct3D work is done by UpdateLoading on the main thread
+	mLoadState = Importing;
+	mLoadThread = thread( [this]()
+	{
+		bool success = false;
+		try
+		{
+			gen::CImportXFile mesh;
+			success = mesh.ImportFile( mFileName ) == gen::kSuccess &&
+			          mesh.GetSubMesh( 0, mLoadMesh, mTangents ) == gen::kSuccess;
+		}
+		catch (...) // Import errors must not escape the thread, report them as a failed load
+		{
+		}
+		mLoadState = success ? Imported : ImportFailed;
+	});
+}
+
+// Continue a progressive load - upload up to the given number of faces (and the vertices they
+// use) if the import has finished. Returns false if the load failed
+bool Geometry::UpdateLoading( unsigned int maxFaces )
+{
+	if (mLoadState == NotLoading || mLoadState == Importing)
+	{
+		return true;
+	}
+	if (mLoadState == ImportFailed)
+	{
+		// Remove from the registry so any later request will try loading again
+		LoadedGeometry.erase( GeometryKey( mFileName, mTangents ) );
+		CancelLoading();
+		return false;
+	}
+
+	// First update after the import - create the vertex description and empty buffers of full size
+	if (!mHasGeometry)
+	{
+		CreateVertexElements( *mLoadMesh );
+		CalculateBounds( *mLoadMesh );
+		if (!CreateBuffers( *mLoadMesh, false ))
+		{
+			LoadedGeometry.erase( GeometryKey( mFileName, mTangents ) );
+			CancelLoading();
+			return false;
+		}
+		mNumIndices = 0;
+		mHasGeometry = true;
+	}
+
+	// Upload the next chunk of faces, preceded by any vertices they use that aren't uploaded yet.
+	// Vertices are uploaded in order, up to the highest one used so far
+	unsigned int numFaces = mLoadMesh->numFaces - mLoadedFaces;
+	if (numFaces > maxFaces)  numFaces = maxFaces;
+	const gen::SMeshFace* faces = mLoadMesh->faces + mLoadedFaces;
+	unsigned int numVertices = mLoadedVertices;
+	for (unsigned int face = 0; face < numFaces; ++face)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			if (faces[face].aiVertex[i] >= numVertices)  numVertices = faces[face].aiVertex[i] + 1;
+		}
+	}
+
+	// Buffers are updated with a box giving the byte range to write
+	D3D10_BOX box;
+	box.top = 0;    box.bottom = 1;
+	box.front = 0;  box.back = 1;
+	if (numVertices > mLoadedVertices)
+	{
+		box.left  = mLoadedVertices * mVertexSize;
+		box.right = numVertices * mVertexSize;
+		Device->UpdateSubresource( mVertexBuffer, 0, &box, mLoadMesh->vertices + box.left, 0, 0 );
+		mLoadedVertices = numVertices;
+	}
+	if (numFaces > 0)
+	{
+		box.left  = mLoadedFaces * sizeof(gen::SMeshFace);
+		box.right = (mLoadedFaces + numFaces) * sizeof(gen::SMeshFace);
+		Device->UpdateSubresource( mIndexBuffer, 0, &box, faces, 0, 0 );
+		mLoadedFaces += numFaces;
+	}
+
+	// Draw everything uploaded so far, finish when all faces are uploaded
+	mNumIndices = mLoadedFaces * 3;
+	if (mLoadedFaces == mLoadMesh->numFaces)
+	{
+		CancelLoading();
+	}
+	return true;
+}
+
+// Wait for a progressive load to finish its import then upload all the geometry. Returns false if
+// the load failed
+bool Geometry::FinishLoading()
+{
+	if (mLoadState == NotLoading)
+	{
+		return true;
+	}
+	if (mLoadThread.joinable())
+	{
+		mLoadThread.join();
+	}
+	return UpdateLoading( 0xffffffff );
+}
+
+// Wait for any background import to finish and free the imported geometry
+void Geometry::CancelLoading()
+{
+	if (mLoadThread.joinable())
+	{
+		mLoadThread.join();
+	}
+	if (mLoadMesh)
+	{
+		delete[] mLoadMesh->vertices;
+		delete[] mLoadMesh->faces;
+		delete[] mLoadMesh->faceAdjacency;
+		delete mLoadMesh;
+		mLoadMesh = NULL;
+	}
+	mLoadState = NotLoading;
+}
+
+
+// Build the vertex element list for the given imported geometry
+void Geometry::CreateVertexElements( const gen::SSubMesh& subMesh )
+{
+	// Create vertex element list & layout. We need a vertex layout to say what data we have per vertex in this model (e.g. position, normal, uv, etc.)
+	// In previous projects the element list was a manually typed in array as we knew what data we would provide. However, as we can load models with
+	// different vertex data this time we need flexible code. The array is built up one element at a time: ask the import class if it loaded normals, 
+	// if so then add a normal line to the array, then ask if it loaded UVS...etc
+	mNumVertexElts = 0;
+	unsigned int offset = 0;
+	// Position is always required
+	mVertexElts[mNumVertexElts].SemanticName = "POSITION";   // Semantic in HLSL (what is this data for)
+	mVertexElts[mNumVertexElts].SemanticIndex = 0;           // Index to add to semantic (a count for this kind of data, when using multiple of the same type, e.g. TEXCOORD0, TEXCOORD1)
+	mVertexElts[mNumVertexElts].Format = DXGI_FORMAT_R32G32B32_FLOAT; // Type of data - this one will be a float3 in the shader. Most data communicated as though it were colours
+	mVertexElts[mNumVertexElts].AlignedByteOffset = offset;  // Offset of element from start of vertex data (e.g. if we have position (float3), uv (float2) then normal, the normal's offset is 5 floats = 5*4 = 20)
+	mVertexElts[mNumVertexElts].InputSlot = 0;               // For when using multiple vertex buffers (e.g. instancing - an advanced topic)
+	mVertexElts[mNumVertexElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA; // Use this value for most cases (only changed for instancing)
+	mVertexElts[mNumVertexElts].InstanceDataStepRate = 0;                     // --"--
+	offset += 12;
+	++mNumVertexElts;
+	// Repeat for each kind of vertex data
+	if (subMesh.hasNormals)
+	{
+		mVertexElts[mNumVertexElts].SemanticName = "NORMAL";
+		mVertexElts[mNumVertexElts].SemanticIndex = 0;
+		mVertexElts[mNumVertexElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		mVertexElts[mNumVertexElts].AlignedByteOffset = offset;
+		mVertexElts[mNumVertexElts].InputSlot = 0;
+		mVertexElts[mNumVertexElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
+		mVertexElts[mNumVertexElts].InstanceDataStepRate = 0;
+		offset += 12;
+		++mNumVertexElts;
+	}
+	if (subMesh.hasTangents)
+	{
+		mVertexElts[mNumVertexElts].SemanticName = "TANGENT";
+		mVertexElts[mNumVertexElts].SemanticIndex = 0;
+		mVertexElts[mNumVertexElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		mVertexElts[mNumVertexElts].AlignedByteOffset = offset;
+		mVertexElts[mNumVertexElts].InputSlot = 0;
+		mVertexElts[mNumVertexElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
+		mVertexElts[mNumVertexElts].InstanceDataStepRate = 0;
+		offset += 12;
+		++mNumVertexElts;
+	}
+	if (subMesh.hasTextureCoords)
+	{
+		mVertexElts[mNumVertexElts].SemanticName = "TEXCOORD";
+		mVertexElts[mNumVertexElts].SemanticIndex = 0;
+		mVertexElts[mNumVertexElts].Format = DXGI_FORMAT_R32G32_FLOAT;
+		mVertexElts[mNumVertexElts].AlignedByteOffset = offset;
+		mVertexElts[mNumVertexElts].InputSlot = 0;
+		mVertexElts[mNumVertexElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
+		mVertexElts[mNumVertexElts].InstanceDataStepRate = 0;
+		offset += 8;
+		++mNumVertexElts;
+	}
+	if (subMesh.hasVertexColours)
+	{
+		mVertexElts[mNumVertexElts].SemanticName = "COLOR";
+		mVertexElts[mNumVertexElts].SemanticIndex = 0;
+		mVertexElts[mNumVertexElts].Format = DXGI_FORMAT_R8G8B8A8_UNORM; // A RGBA colour with 1 byte (0-255) per component
+		mVertexElts[mNumVertexElts].AlignedByteOffset = offset;
+		mVertexElts[mNumVertexElts].InputSlot = 0;
+		mVertexElts[mNumVertexElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
+		mVertexElts[mNumVertexElts].InstanceDataStepRate = 0;
+		offset += 4;
+		++mNumVertexElts;
+	}
+	mVertexSize = offset;
+}
+
+// Calculate the bounding sphere and UV density of the given imported geometry
+void Geometry::CalculateBounds( const gen::SSubMesh& subMesh )
+{
+	if (subMesh.numVertices == 0)
+	{
+		return;
+	}
+
+	// Positions are at the start of each vertex, texture coordinates follow any normals and tangents
+	// (see CreateVertexElements)
+	unsigned int uvOffset = 12 + (subMesh.hasNormals ? 12 : 0) + (subMesh.hasTangents ? 12 : 0);
+	const float* position = reinterpret_cast<const float*>(subMesh.vertices);
+
+	// The bounding sphere is centred on the middle of the bounding box
+	D3DXVECTOR3 minBound( position[0], position[1], position[2] );
+	D3DXVECTOR3 maxBound = minBound;
+	for (unsigned int vertex = 1; vertex < subMesh.numVertices; ++vertex)
+	{
+		position = reinterpret_cast<const float*>(subMesh.vertices + vertex * subMesh.vertexSize);
+		D3DXVECTOR3 point( position[0], position[1], position[2] );
+		D3DXVec3Minimize( &minBound, &minBound, &point );
+		D3DXVec3Maximize( &maxBound, &maxBound, &point );
+	}
+	mBoundingCentre = (minBound + maxBound) * 0.5f;
+	mBoundingRadius = 0.0f;
+	for (unsigned int vertex = 0; vertex < subMesh.numVertices; ++vertex)
+	{
+		position = reinterpret_cast<const float*>(subMesh.vertices + vertex * subMesh.vertexSize);
+		D3DXVECTOR3 offset = D3DXVECTOR3( position[0], position[1], position[2] ) - mBoundingCentre;
+		float radius = D3DXVec3Length( &offset );
+		if (radius > mBoundingRadius)  mBoundingRadius = radius;
+	}
+
+	// UV density compares the total area of the faces in texture space with their area in model
+	// space. Texture space area is in UVs squared, so the square root gives UVs per unit of distance
+	mUVDensity = 0.0f;
+	if (!subMesh.hasTextureCoords)
+	{
+		return;
+	}
+	double surfaceArea = 0.0, uvArea = 0.0;
+	for (unsigned int face = 0; face < subMesh.numFaces; ++face)
+	{
+		const gen::TUInt8* vertices[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			vertices[i] = subMesh.vertices + subMesh.faces[face].aiVertex[i] * subMesh.vertexSize;
+		}
+		const float* p0 = reinterpret_cast<const float*>(vertices[0]);
+		const float* p1 = reinterpret_cast<const float*>(vertices[1]);
+		const float* p2 = reinterpret_cast<const float*>(vertices[2]);
+		D3DXVECTOR3 edge1( p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] );
+		D3DXVECTOR3 edge2( p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] );
+		D3DXVECTOR3 normal;
+		D3DXVec3Cross( &normal, &edge1, &edge2 );
+		surfaceArea += D3DXVec3Length( &normal ) * 0.5;
+
+		const float* uv0 = reinterpret_cast<const float*>(vertices[0] + uvOffset);
+		const float* uv1 = reinterpret_cast<const float*>(vertices[1] + uvOffset);
+		const float* uv2 = reinterpret_cast<const float*>(vertices[2] + uvOffset);
+		float uvCross = (uv1[0] - uv0[0]) * (uv2[1] - uv0[1]) - (uv1[1] - uv0[1]) * (uv2[0] - uv0[0]);
+		uvArea += fabs( uvCross ) * 0.5;
+	}
+	if (surfaceArea > 0.0)
+	{
+		mUVDensity = static_cast<float>(sqrt( uvArea / surfaceArea ));
+	}
+}
+
+// Get the vertex layout matching the given example technique, creating it on first use
+ID3D10InputLayout* Geometry::VertexLayout( ID3D10EffectTechnique* exampleTechnique )
+{
+	for (unsigned int i = 0; i < mVertexLayouts.size(); ++i)
+	{
+		if (mVertexLayouts[i].exampleTechnique == exampleTechnique)
+		{
+			return mVertexLayouts[i].layout;
+		}
+	}
+
+	// Given the vertex element list, pass it to DirectX to create a vertex layout. We also need to pass an example of a technique that will
+	// render this model. We will only be able to render this model with techniques that have the same vertex input as the example we use here
+	Layout newLayout;
+	newLayout.exampleTechnique = exampleTechnique;
+	D3D10_PASS_DESC PassDesc;
+	exampleTechnique->GetPassByIndex( 0 )->GetDesc( &PassDesc );
+	if (FAILED( Device->CreateInputLayout( mVertexElts, mNumVertexElts, PassDesc.pIAInputSignature, PassDesc.IAInputSignatureSize, &newLayout.layout ) ))
+	{
+		return NULL;
+	}
+	mVertexLayouts.push_back( newLayout );
+	return newLayout.layout;
+}
+
+// Create vertex and index buffers for the given imported geometry. If initialise is false the
+// buffers are left empty, to be filled in parts with UpdateSubresource
+bool Geometry::CreateBuffers( const gen::SSubMesh& subMesh, bool initialise )
+{
+	// Create the vertex buffer and fill it with the loaded vertex data
+	mNumVertices = subMesh.numVertices;
+	D3D10_BUFFER_DESC bufferDesc;
+	bufferDesc.BindFlags = D3D10_BIND_VERTEX_BUFFER;
+	bufferDesc.Usage = D3D10_USAGE_DEFAULT; // Not a dynamic buffer
+	bufferDesc.ByteWidth = mNumVertices * mVertexSize; // Buffer size
+	bufferDesc.CPUAccessFlags = 0;   // Indicates that CPU won't access this buffer at all after creation
+	bufferDesc.MiscFlags = 0;
+	D3D10_SUBRESOURCE_DATA initData; // Initial data
+	initData.pSysMem = subMesh.vertices;   
+	if (FAILED( Device->CreateBuffer( &bufferDesc, initialise ? &initData : NULL, &mVertexBuffer )))
+	{
+		return false;
+	}
+
+
+	// Create the index buffer - assuming 2-byte (WORD) index data
+	bufferDesc.BindFlags = D3D10_BIND_INDEX_BUFFER;
+	bufferDesc.Usage = D3D10_USAGE_DEFAULT;
+	bufferDesc.ByteWidth = static_cast<unsigned int>(subMesh.numFaces) * 3 * sizeof(WORD);
+	bufferDesc.CPUAccessFlags = 0;
+	bufferDesc.MiscFlags = 0;
+	initData.pSysMem = subMesh.faces;   
+	if (FAILED( Device->CreateBuffer( &bufferDesc, initialise ? &initData : NULL, &mIndexBuffer )))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+/////////////////////////////
+// Usage
+
+// Render the geometry with the given technique, using the vertex layout for the given example
+// technique. Assumes any shader variables for the technique have already been set up
+void Geometry::Render( ID3D10EffectTechnique* technique, ID3D10EffectTechnique* exampleTechnique )
+{
+	// Don't render if no geometry
+	if (!mHasGeometry)
+	{
+		return;
+	}
+	ID3D10InputLayout* layout = VertexLayout( exampleTechnique );
+	if (!layout)
+	{
+		return;
+	}
+
+	// Select vertex and index buffer - assuming all data will be as triangle lists
+	UINT offset = 0;
+	Device->IASetVertexBuffers( 0, 1, &mVertexBuffer, &mVertexSize, &offset );
+	Device->IASetInputLayout( layout );
+	Device->IASetIndexBuffer( mIndexBuffer, DXGI_FORMAT_R16_UINT, 0 );
+	Device->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+
+	// Render the geometry. Vertex buffers are prepared above, calling code must have prepared textures,
+	// states, shaders and shader variables.
+	D3D10_TECHNIQUE_DESC techDesc;
+	technique->GetDesc( &techDesc );
+	for( UINT p = 0; p < techDesc.Passes; ++p )
+	{
+		technique->GetPassByIndex( p )->Apply( 0 );
+		Device->DrawIndexed( mNumIndices, 0, 0 );
+	}
+}
@@ -0,0 +1,179 @@
+//--------------------------------------------------------------------------------------
+//	The geometry class holds the vertex and index data loaded from a file, ready to render.
+//	Loaded geometry is shared: models using the same file and import options refer to a
+//	single reference-counted geometry object rather than each loading their own copy
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_GEOMETRY_H_INCLUDED
+#define CO2409_GEOMETRY_H_INCLUDED
+
+#include <d3d10.h>
+#include <d3dx10.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+using namespace std;
+
+// Forward declaration of import types, only needed in the .cpp file
+namespace gen { struct SSubMesh; }
+
+class Geometry
+{
+//-------------------------------------
+// Public member functions
+//-------------------------------------
+public:
+
+	//-------------------------------------
+	// Shared geometry
+
+	// Get the geometry for the given file and import options, loading it only if no other model
+	// is already using it. May optionally request tangents (for normal or parallax mapping). If
+	// progressive is true a new load happens in the background, see UpdateLoading. Each successful
+	// call must be matched by a call to Release. Returns NULL if the load fails
+	static Geometry* Acquire( const string& fileName, bool tangents, bool progressive = false );
+
+	// Share geometry already acquired with another model, without looking it up again. Must be
+	// matched by a call to Release
+	void AddRef()  { ++mRefCount; }
+
+	// Finish using this geometry, it is deleted when no models are using it
+	void Release();
+
+	// Number of geometry objects currently loaded
+	static unsigned int LoadedCount();
+
+
+	//-------------------------------------
+	// Progressive loading
+
+	// Continue a progressive load - upload up to the given number of faces (and the vertices they
+	// use) if the background import has finished. Returns false if the load failed, does nothing
+	// if the geometry is not loading progressively
+	bool UpdateLoading( unsigned int maxFaces );
+
+	// Wait for a progressive load to finish its import then upload all the geometry, e.g. to start
+	// several imports in parallel but render them only when complete. Returns false if the load
+	// failed, does nothing if the geometry is not loading progressively
+	bool FinishLoading();
+
+	// Is a progressive load still in progress (i.e. not all geometry can be rendered yet)
+	bool IsLoading()  { return mLoadState != NotLoading; }
+
+
+	//-------------------------------------
+	// Bounds and texture mapping
+
+	// Centre and radius of a sphere enclosing the geometry, in model space. The radius is 0 until
+	// the geometry has loaded (including the import of a progressive load)
+	D3DXVECTOR3 BoundingCentre()  { return mBoundingCentre; }
+	float       BoundingRadius()  { return mBoundingRadius; }
+
+	// Average distance in texture coordinates (UVs) covered by one unit of distance across the
+	// surface of the geometry, in model space. Used to judge how much texture detail is visible at
+	// a given screen size. 0 if the geometry has no texture coordinates or has not loaded yet
+	float UVDensity()  { return mUVDensity; }
+
+
+	//-------------------------------------
+	// Usage
+
+	// Render the geometry with the given technique. We need to pass an example technique that the
+	// geometry will use to help DirectX understand how to connect this data with the vertex shaders
+	// (only techniques with the same vertex input as the example can be used). Assumes any shader
+	// variables for the technique have already been set up (e.g. matrices and textures)
+	void Render( ID3D10EffectTechnique* technique, ID3D10EffectTechnique* exampleTechnique );
+
+
+//-------------------------------------
+// Private member functions
+//-------------------------------------
+private:
+	// Geometry is only created and destroyed through Acquire and Release
+	Geometry( const string& fileName, bool tangents );
+	~Geometry();
+	Geometry( const Geometry& );
+	Geometry& operator=( const Geometry& );
+
+	// Load synchronously, or start a background load
+	bool Load();
+	void LoadProgressive();
+
+	// Build the vertex element list for the given imported geometry
+	void CreateVertexElements( const gen::SSubMesh& subMesh );
+
+	// Calculate the bounding sphere and UV density of the given imported geometry
+	void CalculateBounds( const gen::SSubMesh& subMesh );
+
+	// Get the vertex layout matching the given example technique, creating it on first use
+	ID3D10InputLayout* VertexLayout( ID3D10EffectTechnique* exampleTechnique );
+
+	// Create vertex and index buffers for the given imported geometry. If initialise is false the
+	// buffers are left empty, to be filled in parts with UpdateSubresource
+	bool CreateBuffers( const gen::SSubMesh& subMesh, bool initialise );
+
+	// Wait for any background import to finish and free the imported geometry
+	void CancelLoading();
+
+
+//-------------------------------------
+// Private member variables
+//-------------------------------------
+private:
+	// File and import options identifying this geometry, and the number of models using it
+	string                   mFileName;
+	bool                     mTangents;
+	unsigned int             mRefCount;
+
+	// Does this geometry have any data to render
+	bool                     mHasGeometry;
+
+	// Vertices a stored in a vertex buffer and the number of the vertices in the buffer
+	ID3D10Buffer*            mVertexBuffer;
+	unsigned int             mNumVertices;
+
+	// Description of the elements in a single vertex (position, normal, UVs etc.)
+	static const int         MAX_VERTEX_ELTS = 64;
+	D3D10_INPUT_ELEMENT_DESC mVertexElts[MAX_VERTEX_ELTS];
+	unsigned int             mNumVertexElts;
+	unsigned int             mVertexSize;   // Size of vertex calculated from contained elements
+
+	// Vertex layouts derived from the above, one for each different example technique used
+	struct Layout
+	{
+		ID3D10EffectTechnique* exampleTechnique;
+		ID3D10InputLayout*     layout;
+	};
+	vector<Layout>           mVertexLayouts;
+
+	// Index data stored in a index buffer and the number of indices in the buffer
+	ID3D10Buffer*            mIndexBuffer;
+	unsigned int             mNumIndices;
+
+	// Bounding sphere and average texture coordinate distance per unit of surface distance
+	D3DXVECTOR3              mBoundingCentre;
+	float                    mBoundingRadius;
+	float                    mUVDensity;
+
+
+	//-------------------------------------
+	// Progressive loading
+
+	// State of a progressive load
+	enum ELoadState { NotLoading, Importing, Imported, ImportFailed };
+
+	// The file is imported on a background thread, which sets the state when it has finished
+	thread                   mLoadThread;
+	atomic<int>              mLoadState;
+
+	// Imported geometry waiting to be uploaded, and how much has been uploaded so far. Only
+	// mNumIndices indices are drawn, so the geometry draws a growing part of itself
+	gen::SSubMesh*           mLoadMesh;
+	unsigned int             mLoadedFaces;
+	unsigned int             mLoadedVertices;
+};
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,166 @@
+//--------------------------------------------------------------------------------------
+//	DDS file loading. DDS data is already in a GPU texture layout, so block compressed data
+//	and mip levels are copied directly. Uncompressed pixels are reordered to RGBA
+//--------------------------------------------------------------------------------------
+
+#include "ImageDecoders.h"
+#include <string.h>
+
+//--------------------------------------------------------------------------------------
+// DDS file format
+//--------------------------------------------------------------------------------------
+
+// Read a little-endian 32-bit value
+static uint32_t ReadDDSUInt( const uint8_t* data )
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// Sizes and offsets within the file (after the "DDS " signature)
+static const size_t kDDSHeaderSize = 124;
+static const size_t kDDSHeaderDX10Size = 20;
+static const size_t kDDSHeightOffset = 8;
+static const size_t kDDSWidthOffset = 12;
+static const size_t kDDSMipCountOffset = 24;
+static const size_t kDDSPixelFormatOffset = 72;
+
+// Pixel format flags
+static const uint32_t kDDSAlphaPixels = 0x1;
+static const uint32_t kDDSFourCC      = 0x4;
+static const uint32_t kDDSRGB         = 0x40;
+static const uint32_t kDDSLuminance   = 0x20000;
+
+// Four character codes for compressed formats
+#define DDS_FOURCC(a, b, c, d) (static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | \
+                                (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24))
+
+
+// Get the shift and number of bits of a colour channel from its mask. Only whole-byte channels
+// are supported, returns false otherwise
+static bool ChannelFromMask( uint32_t mask, int* shift )
+{
+	*shift = -1; // Missing channel
+	if (mask == 0)  return true;
+
+	int lowBit = 0;
+	while (!(mask & (1u << lowBit)))  ++lowBit;
+	if ((lowBit % 8) != 0 || (mask >> lowBit) != 0xFF)  return false;
+	*shift = lowBit;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// DDS loading
+//--------------------------------------------------------------------------------------
+
+bool DecodeDDS( const uint8_t* fileData, size_t fileSize, Image* image, string* error )
+{
+	if (fileSize < 4 + kDDSHeaderSize)  return ImageError( error, "DDS file is truncated" );
+	const uint8_t* header = fileData + 4;
+	if (ReadDDSUInt( header ) != kDDSHeaderSize)  return ImageError( error, "Invalid DDS header" );
+
+	unsigned int width  = ReadDDSUInt( header + kDDSWidthOffset );
+	unsigned int height = ReadDDSUInt( header + kDDSHeightOffset );
+	unsigned int numMips = ReadDDSUInt( header + kDDSMipCountOffset );
+	if (numMips == 0)  numMips = 1; // Mip count is optional, 0 means a single level
+	if (width == 0 || height == 0 || width > 16384 || height > 16384 || numMips > 15)
+	{
+		return ImageError( error, "Unsupported DDS dimensions" );
+	}
+
+	// Pixel format
+	const uint8_t* pixelFormat = header + kDDSPixelFormatOffset;
+	uint32_t flags     = ReadDDSUInt( pixelFormat + 4 );
+	uint32_t fourCC    = ReadDDSUInt( pixelFormat + 8 );
+	uint32_t bitCount  = ReadDDSUInt( pixelFormat + 12 );
+	uint32_t redMask   = ReadDDSUInt( pixelFormat + 16 );
+	uint32_t greenMask = ReadDDSUInt( pixelFormat + 20 );
+	uint32_t blueMask  = ReadDDSUInt( pixelFormat + 24 );
+	uint32_t alphaMask = ReadDDSUInt( pixelFormat + 28 );
+	size_t dataOffset = 4 + kDDSHeaderSize;
+
+	ImageFormat format = ImageFormatUnknown;
+	if (flags & kDDSFourCC)
+	{
+		switch (fourCC)
+		{
+			case DDS_FOURCC('D','X','T','1'):  format = ImageFormatBC1;  break;
+			case DDS_FOURCC('D','X','T','2'):
+			case DDS_FOURCC('D','X','T','3'):  format = ImageFormatBC2;  break;
+			case DDS_FOURCC('D','X','T','4'):
+			case DDS_FOURCC('D','X','T','5'):  format = ImageFormatBC3;  break;
+			case DDS_FOURCC('A','T','I','1'):
+			case DDS_FOURCC('B','C','4','U'):  format = ImageFormatBC4;  break;
+			case DDS_FOURCC('A','T','I','2'):
+			case DDS_FOURCC('B','C','5','U'):  format = ImageFormatBC5;  break;
+			case DDS_FOURCC('D','X','1','0'):
+			{
+				// Extended header gives a DXGI format, only accept those we have in ImageFormat
+				if (fileSize < dataOffset + kDDSHeaderDX10Size)  return ImageError( error, "DDS file is truncated" );
+				uint32_t dxgiFormat = ReadDDSUInt( fileData + dataOffset );
+				dataOffset += kDDSHeaderDX10Size;
+				if (dxgiFormat == ImageFormatRGBA8 || dxgiFormat == ImageFormatBC1 || dxgiFormat == ImageFormatBC2 ||
+				    dxgiFormat == ImageFormatBC3 || dxgiFormat == ImageFormatBC4 || dxgiFormat == ImageFormatBC5)
+				{
+					format = static_cast<ImageFormat>(dxgiFormat);
+				}
+				break;
+			}
+		}
+		if (format == ImageFormatUnknown)  return ImageError( error, "Unsupported DDS compressed format" );
+	}
+	else if (!(flags & (kDDSRGB | kDDSLuminance)) || (bitCount != 8 && bitCount != 16 && bitCount != 24 && bitCount != 32))
+	{
+		return ImageError( error, "Unsupported DDS pixel format" );
+	}
+
+	// Compressed and RGBA8 data is used as it is, one mip level after another
+	if (format != ImageFormatUnknown)
+	{
+		image->Allocate( format, width, height, numMips );
+		if (fileSize - dataOffset < image->data.size())  return ImageError( error, "DDS file is truncated" );
+		memcpy( &image->data[0], fileData + dataOffset, image->data.size() );
+		return true;
+	}
+
+	// Otherwise reorder uncompressed channels to RGBA. Luminance formats use the red mask for all
+	// of red, green and blue
+	int redShift, greenShift, blueShift, alphaShift;
+	if (!(flags & kDDSAlphaPixels))  alphaMask = 0;
+	if (flags & kDDSLuminance)  greenMask = blueMask = redMask;
+	if (!ChannelFromMask( redMask, &redShift ) || !ChannelFromMask( greenMask, &greenShift ) ||
+	    !ChannelFromMask( blueMask, &blueShift ) || !ChannelFromMask( alphaMask, &alphaShift ))
+	{
+		return ImageError( error, "Unsupported DDS pixel format" );
+	}
+
+	image->Allocate( ImageFormatRGBA8, width, height, numMips );
+	unsigned int bytesPerPixel = bitCount / 8;
+	const uint8_t* source = fileData + dataOffset;
+	size_t sourceSize = fileSize - dataOffset;
+	for (unsigned int mip = 0; mip < numMips; ++mip)
+	{
+		const ImageMip& mipInfo = image->mips[mip];
+		size_t pixels = static_cast<size_t>(mipInfo.width) * mipInfo.height;
+		if (sourceSize < pixels * bytesPerPixel)  return ImageError( error, "DDS file is truncated" );
+
+		uint8_t* dest = image->MipData( mip );
+		for (size_t pixel = 0; pixel < pixels; ++pixel)
+		{
+			uint32_t value = 0;
+			for (unsigned int byte = 0; byte < bytesPerPixel; ++byte)
+			{
+				value |= static_cast<uint32_t>(source[byte]) << (byte * 8);
+			}
+			dest[0] = redShift   < 0 ? 0   : static_cast<uint8_t>(value >> redShift);
+			dest[1] = greenShift < 0 ? 0   : static_cast<uint8_t>(value >> greenShift);
+			dest[2] = blueShift  < 0 ? 0   : static_cast<uint8_t>(value >> blueShift);
+			dest[3] = alphaShift < 0 ? 255 : static_cast<uint8_t>(value >> alphaShift);
+			source += bytesPerPixel;
+			dest += 4;
+		}
+		sourceSize -= pixels * bytesPerPixel;
+	}
+	return true;
+}
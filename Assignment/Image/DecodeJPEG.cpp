@@ -0,0 +1,782 @@
+//--------------------------------------------------------------------------------------
+//	JPG file decoding - baseline and progressive Huffman coded images, greyscale or colour,
+//	converted to RGBA8
+//--------------------------------------------------------------------------------------
+
+#include "ImageDecoders.h"
+#include <string.h>
+#include <math.h>
+
+//--------------------------------------------------------------------------------------
+// Huffman decoding
+//--------------------------------------------------------------------------------------
+
+// Order of coefficients in the file (zig-zag through the block). Padded for coefficient positions
+// past the end of a block in corrupt data
+static const uint8_t kZigZag[64 + 16] =
+{
+	 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+	63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+// Huffman code table. Codes up to kFastBits long are decoded with one table lookup, longer codes
+// by comparing against the largest code of each length
+static const int kFastBits = 9;
+struct JPEGHuffman
+{
+	uint8_t fastLength[1 << kFastBits]; // 0 for codes longer than kFastBits
+	uint8_t fastValue[1 << kFastBits];
+	int32_t maxCode[18];                // Largest code of each length, -1 if no codes of that length
+	int32_t valueOffset[17];            // Add to a code of each length to get the index of its value
+	uint8_t values[256];
+};
+
+// Build a Huffman table from the number of codes of each length and the values in code order.
+// Returns false if the table is invalid
+static bool BuildHuffman( JPEGHuffman* table, const uint8_t* lengthCounts, const uint8_t* values, int numValues )
+{
+	memset( table->fastLength, 0, sizeof(table->fastLength) );
+	memcpy( table->values, values, numValues );
+
+	int32_t code = 0;
+	int index = 0;
+	for (int length = 1; length <= 16; ++length)
+	{
+		int count = lengthCounts[length - 1];
+		if (code + count > (1 << length))  return false; // Too many codes for this length, would overrun the tables below
+		table->valueOffset[length] = index - code;
+		table->maxCode[length] = count ? code + count - 1 : -1;
+		for (int i = 0; i < count; ++i, ++code, ++index)
+		{
+			if (length <= kFastBits)
+			{
+				int first = code << (kFastBits - length);
+				for (int fill = 0; fill < (1 << (kFastBits - length)); ++fill)
+				{
+					table->fastLength[first + fill] = static_cast<uint8_t>(length);
+					table->fastValue[first + fill] = values[index];
+				}
+			}
+		}
+		code <<= 1;
+	}
+	table->maxCode[17] = 0x7FFFFFFF;
+	return true;
+}
+
+
+// Reads the entropy coded data of a scan, highest bit first. Stuffed zero bytes after 0xFF are
+// removed, and zeros are read once a marker is reached
+class JPEGReader
+{
+public:
+	JPEGReader( const uint8_t* data, const uint8_t* end ) : mData( data ), mEnd( end ), mBits( 0 ), mNumBits( 0 ), mMarker( false ) {}
+
+	// Position of the next unread byte (a marker once the scan data has all been read)
+	const uint8_t* Position()  { return mData; }
+
+	// Make sure at least 25 bits are in the buffer
+	void Fill()
+	{
+		while (mNumBits <= 24)
+		{
+			uint32_t byte = 0;
+			if (!mMarker && mData < mEnd)
+			{
+				byte = *mData;
+				if (byte != 0xFF)
+				{
+					++mData;
+				}
+				else if (mData + 1 < mEnd && mData[1] == 0)
+				{
+					mData += 2;
+				}
+				else
+				{
+					mMarker = true;
+					byte = 0;
+				}
+			}
+			mBits |= byte << (24 - mNumBits);
+			mNumBits += 8;
+		}
+	}
+
+	uint32_t Bits( int numBits )
+	{
+		if (numBits == 0)  return 0;
+		if (mNumBits < numBits)  Fill();
+		uint32_t value = mBits >> (32 - numBits);
+		mBits <<= numBits;
+		mNumBits -= numBits;
+		return value;
+	}
+
+	// Read a value of the given number of bits, extending it to a signed value as JPEG stores them
+	int SignedBits( int numBits )
+	{
+		if (numBits == 0)  return 0;
+		int value = static_cast<int>(Bits( numBits ));
+		return value < (1 << (numBits - 1)) ? value - (1 << numBits) + 1 : value;
+	}
+
+	// Decode a value with the given table, returns -1 for an invalid code
+	int Decode( const JPEGHuffman& table )
+	{
+		if (mNumBits < 16)  Fill();
+		int index = mBits >> (32 - kFastBits);
+		int length = table.fastLength[index];
+		if (length)
+		{
+			mBits <<= length;
+			mNumBits -= length;
+			return table.fastValue[index];
+		}
+
+		for (length = kFastBits + 1; length <= 16; ++length)
+		{
+			int32_t code = static_cast<int32_t>(mBits >> (32 - length));
+			if (code <= table.maxCode[length])
+			{
+				mBits <<= length;
+				mNumBits -= length;
+				return table.values[(code + table.valueOffset[length]) & 255];
+			}
+		}
+		return -1;
+	}
+
+	// Move past a restart marker and start reading again from an empty bit buffer
+	void Restart()
+	{
+		while (mData + 1 < mEnd && !(mData[0] == 0xFF && mData[1] >= 0xD0 && mData[1] <= 0xD7))  ++mData;
+		if (mData + 1 < mEnd)  mData += 2;
+		mBits = 0;
+		mNumBits = 0;
+		mMarker = false;
+	}
+
+private:
+	const uint8_t* mData;
+	const uint8_t* mEnd;
+	uint32_t       mBits;    // Unread bits, the next bit is the highest
+	int            mNumBits;
+	bool           mMarker;  // Reached a marker, no more data in this scan
+};
+
+
+//--------------------------------------------------------------------------------------
+// Decoder state
+//--------------------------------------------------------------------------------------
+
+struct JPEGComponent
+{
+	int  id;
+	int  h, v;              // Sampling factors
+	int  quantTable;
+	int  dcTable, acTable;  // Huffman tables used in the current scan
+	int  width, height;     // Size in pixels
+	int  blocksX, blocksY;  // Blocks in the coefficient grid, padded to a whole number of MCUs
+	int  dcPredictor;
+	vector<int16_t> coefs;  // 64 per block, in natural (not zig-zag) order
+	vector<uint8_t> pixels; // blocksX*8 by blocksY*8 pixels after the inverse DCT
+};
+
+struct JPEGDecoder
+{
+	uint16_t      quant[4][64];  // Quantisation tables, in natural order
+	JPEGHuffman   dcTables[4];
+	JPEGHuffman   acTables[4];
+	JPEGComponent components[3];
+	int           numComponents;
+	int           width, height;
+	int           maxH, maxV;
+	int           mcusX, mcusY;
+	bool          progressive;
+	int           restartInterval;
+	int           adobeTransform; // -1 if there is no Adobe marker
+
+	// Current scan
+	JPEGComponent* scanComponents[3];
+	int            numScanComponents;
+	int            spectralStart, spectralEnd;
+	int            approxHigh, approxLow;
+	int            eobRun;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Block decoding
+//--------------------------------------------------------------------------------------
+
+// Decode a block of a baseline (sequential) scan - all coefficients at full precision
+static bool DecodeBlockBaseline( JPEGDecoder& decoder, JPEGReader& reader, JPEGComponent& component, int16_t* coefs )
+{
+	int size = reader.Decode( decoder.dcTables[component.dcTable] );
+	if (size < 0 || size > 16)  return false;
+	component.dcPredictor += reader.SignedBits( size );
+	coefs[0] = static_cast<int16_t>(component.dcPredictor);
+
+	const JPEGHuffman& acTable = decoder.acTables[component.acTable];
+	for (int k = 1; k < 64; ++k)
+	{
+		int runSize = reader.Decode( acTable );
+		if (runSize < 0)  return false;
+		int run = runSize >> 4;
+		size = runSize & 15;
+		if (size == 0)
+		{
+			if (run != 15)  break; // End of block
+			k += 15;               // Sixteen zeros
+			continue;
+		}
+		k += run;
+		coefs[kZigZag[k]] = static_cast<int16_t>(reader.SignedBits( size ));
+	}
+	return true;
+}
+
+// Decode the DC coefficient of a block in a progressive scan - first scan or refinement
+static bool DecodeBlockDC( JPEGDecoder& decoder, JPEGReader& reader, JPEGComponent& component, int16_t* coefs )
+{
+	if (decoder.approxHigh == 0)
+	{
+		int size = reader.Decode( decoder.dcTables[component.dcTable] );
+		if (size < 0 || size > 16)  return false;
+		component.dcPredictor += reader.SignedBits( size );
+		coefs[0] = static_cast<int16_t>(component.dcPredictor * (1 << decoder.approxLow));
+	}
+	else if (reader.Bits( 1 ))
+	{
+		coefs[0] |= static_cast<int16_t>(1 << decoder.approxLow);
+	}
+	return true;
+}
+
+// Decode a band of AC coefficients of a block in a progressive scan, first scan for the band
+static bool DecodeBlockACFirst( JPEGDecoder& decoder, JPEGReader& reader, JPEGComponent& component, int16_t* coefs )
+{
+	// Blocks may be skipped entirely by a run of end-of-bands
+	if (decoder.eobRun > 0)
+	{
+		--decoder.eobRun;
+		return true;
+	}
+
+	const JPEGHuffman& acTable = decoder.acTables[component.acTable];
+	for (int k = decoder.spectralStart; k <= decoder.spectralEnd; ++k)
+	{
+		int runSize = reader.Decode( acTable );
+		if (runSize < 0)  return false;
+		int run = runSize >> 4;
+		int size = runSize & 15;
+		if (size == 0)
+		{
+			if (run < 15)
+			{
+				// End of band, for this block and (1 << run) - 1 + extra bits more
+				decoder.eobRun = (1 << run) - 1 + reader.Bits( run );
+				break;
+			}
+			k += 15;
+			continue;
+		}
+		k += run;
+		coefs[kZigZag[k]] = static_cast<int16_t>(reader.SignedBits( size ) * (1 << decoder.approxLow));
+	}
+	return true;
+}
+
+// Decode a band of AC coefficients of a block in a progressive scan, refinement scan adding one bit
+// of precision. Coefficients that are already non-zero get a correction bit, newly non-zero
+// coefficients are coded with runs of zero coefficients as in the first scan
+static bool DecodeBlockACRefine( JPEGDecoder& decoder, JPEGReader& reader, JPEGComponent& component, int16_t* coefs )
+{
+	const int bit = 1 << decoder.approxLow;
+	int k = decoder.spectralStart;
+
+	// Add a correction bit to an existing non-zero coefficient, increasing its magnitude if set
+	auto refine = [&]( int16_t* coef )
+	{
+		if (reader.Bits( 1 ) && (*coef & bit) == 0)
+		{
+			*coef = static_cast<int16_t>(*coef >= 0 ? *coef + bit : *coef - bit);
+		}
+	};
+
+	if (decoder.eobRun == 0)
+	{
+		const JPEGHuffman& acTable = decoder.acTables[component.acTable];
+		for (; k <= decoder.spectralEnd; ++k)
+		{
+			int runSize = reader.Decode( acTable );
+			if (runSize < 0)  return false;
+			int run = runSize >> 4;
+			int size = runSize & 15;
+			int newValue = 0;
+			if (size)
+			{
+				// New coefficients are always +/- one bit
+				newValue = reader.Bits( 1 ) ? bit : -bit;
+			}
+			else if (run != 15)
+			{
+				// End of band - the rest of this block is handled below
+				decoder.eobRun = (1 << run) + reader.Bits( run );
+				break;
+			}
+
+			// Skip the given number of zero coefficients (refining any non-zero ones passed)
+			while (k <= decoder.spectralEnd)
+			{
+				int16_t* coef = &coefs[kZigZag[k]];
+				if (*coef != 0)
+				{
+					refine( coef );
+				}
+				else
+				{
+					if (run == 0)  break;
+					--run;
+				}
+				++k;
+			}
+			if (newValue && k <= decoder.spectralEnd)
+			{
+				coefs[kZigZag[k]] = static_cast<int16_t>(newValue);
+			}
+		}
+	}
+
+	// In an end-of-band run, remaining non-zero coefficients still get correction bits
+	if (decoder.eobRun > 0)
+	{
+		for (; k <= decoder.spectralEnd; ++k)
+		{
+			int16_t* coef = &coefs[kZigZag[k]];
+			if (*coef != 0)  refine( coef );
+		}
+		--decoder.eobRun;
+	}
+	return true;
+}
+
+// Decode one block of the current scan
+static bool DecodeBlock( JPEGDecoder& decoder, JPEGReader& reader, JPEGComponent& component, int blockX, int blockY )
+{
+	int16_t* coefs = &component.coefs[(blockY * component.blocksX + blockX) * 64];
+	if (!decoder.progressive)            return DecodeBlockBaseline( decoder, reader, component, coefs );
+	if (decoder.spectralStart == 0)      return DecodeBlockDC( decoder, reader, component, coefs );
+	if (decoder.approxHigh == 0)         return DecodeBlockACFirst( decoder, reader, component, coefs );
+	return DecodeBlockACRefine( decoder, reader, component, coefs );
+}
+
+// Decode the entropy coded data of a scan, returning the position of the marker after it or NULL
+// on error
+static const uint8_t* DecodeScan( JPEGDecoder& decoder, const uint8_t* data, const uint8_t* end )
+{
+	JPEGReader reader( data, end );
+	decoder.eobRun = 0;
+	for (int i = 0; i < decoder.numComponents; ++i)  decoder.components[i].dcPredictor = 0;
+
+	// A single component scan covers the blocks of that component only, in raster order, and each
+	// block is an MCU. Otherwise each MCU contains h*v blocks from each component
+	int mcusX, mcusY;
+	if (decoder.numScanComponents == 1)
+	{
+		mcusX = (decoder.scanComponents[0]->width + 7) / 8;
+		mcusY = (decoder.scanComponents[0]->height + 7) / 8;
+	}
+	else
+	{
+		mcusX = decoder.mcusX;
+		mcusY = decoder.mcusY;
+	}
+
+	int mcusToRestart = decoder.restartInterval;
+	for (int mcuY = 0; mcuY < mcusY; ++mcuY)
+	{
+		for (int mcuX = 0; mcuX < mcusX; ++mcuX)
+		{
+			if (decoder.restartInterval && mcusToRestart-- == 0)
+			{
+				reader.Restart();
+				decoder.eobRun = 0;
+				for (int i = 0; i < decoder.numComponents; ++i)  decoder.components[i].dcPredictor = 0;
+				mcusToRestart = decoder.restartInterval - 1;
+			}
+
+			if (decoder.numScanComponents == 1)
+			{
+				if (!DecodeBlock( decoder, reader, *decoder.scanComponents[0], mcuX, mcuY ))  return NULL;
+				continue;
+			}
+			for (int i = 0; i < decoder.numScanComponents; ++i)
+			{
+				JPEGComponent& component = *decoder.scanComponents[i];
+				for (int v = 0; v < component.v; ++v)
+				{
+					for (int h = 0; h < component.h; ++h)
+					{
+						if (!DecodeBlock( decoder, reader, component, mcuX * component.h + h, mcuY * component.v + v ))  return NULL;
+					}
+				}
+			}
+		}
+	}
+
+	// Find the marker following the scan
+	const uint8_t* position = reader.Position();
+	while (position + 1 < end && !(position[0] == 0xFF && position[1] != 0 && position[1] != 0xFF &&
+	                               !(position[1] >= 0xD0 && position[1] <= 0xD7)))
+	{
+		++position;
+	}
+	return position;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Output
+//--------------------------------------------------------------------------------------
+
+// Inverse DCT basis matrix: idct[x][u] = c(u)/2 * cos((2x+1)u*pi/16), c(0) = 1/sqrt(2), otherwise 1
+struct JPEGBasis
+{
+	float idct[8][8];
+	JPEGBasis()
+	{
+		for (int x = 0; x < 8; ++x)
+		{
+			for (int u = 0; u < 8; ++u)
+			{
+				idct[x][u] = (u == 0 ? 0.70710678f : 1.0f) * 0.5f * cosf( (2 * x + 1) * u * 3.14159265f / 16.0f );
+			}
+		}
+	}
+};
+
+// Dequantise the coefficients and perform the inverse DCT on every block of a component
+static void InverseDCT( const JPEGDecoder& decoder, JPEGComponent& component )
+{
+	// Static initialisation is thread safe, several images may be decoded at once
+	static const JPEGBasis basis;
+	const float (*idct)[8] = basis.idct;
+
+	const uint16_t* quant = decoder.quant[component.quantTable];
+	int stride = component.blocksX * 8;
+	component.pixels.resize( static_cast<size_t>(stride) * component.blocksY * 8 );
+	for (int blockY = 0; blockY < component.blocksY; ++blockY)
+	{
+		for (int blockX = 0; blockX < component.blocksX; ++blockX)
+		{
+			const int16_t* coefs = &component.coefs[(blockY * component.blocksX + blockX) * 64];
+
+			// Rows then columns, skipping all-zero rows (common after quantisation)
+			float rows[64];
+			for (int v = 0; v < 8; ++v)
+			{
+				float dequant[8];
+				bool zero = true;
+				for (int u = 0; u < 8; ++u)
+				{
+					dequant[u] = static_cast<float>(coefs[v * 8 + u] * quant[v * 8 + u]);
+					if (coefs[v * 8 + u])  zero = false;
+				}
+				for (int x = 0; x < 8; ++x)
+				{
+					float sum = 0.0f;
+					if (!zero)
+					{
+						for (int u = 0; u < 8; ++u)  sum += idct[x][u] * dequant[u];
+					}
+					rows[v * 8 + x] = sum;
+				}
+			}
+
+			uint8_t* pixels = &component.pixels[static_cast<size_t>(blockY) * 8 * stride + blockX * 8];
+			for (int x = 0; x < 8; ++x)
+			{
+				for (int y = 0; y < 8; ++y)
+				{
+					float sum = 128.5f; // Level shift, and 0.5 to round below
+					for (int v = 0; v < 8; ++v)  sum += idct[y][v] * rows[v * 8 + x];
+					pixels[y * stride + x] = static_cast<uint8_t>(sum < 0.0f ? 0 : (sum > 255.0f ? 255 : static_cast<int>(sum)));
+				}
+			}
+		}
+	}
+}
+
+// Upsample a subsampled component to the full image size, with linear filtering between sample
+// centres. Full size components are just copied
+static void UpsampleComponent( const JPEGDecoder& decoder, const JPEGComponent& component, vector<uint8_t>* output )
+{
+	int width = decoder.width, height = decoder.height;
+	int stride = component.blocksX * 8;
+	output->resize( static_cast<size_t>(width) * height );
+	if (component.h == decoder.maxH && component.v == decoder.maxV)
+	{
+		for (int y = 0; y < height; ++y)  memcpy( &(*output)[static_cast<size_t>(y) * width], &component.pixels[static_cast<size_t>(y) * stride], width );
+		return;
+	}
+
+	// Source position and weight (of 256) of the second sample for each output column and row
+	vector<int> x0( width ), x1( width ), xWeight( width ), y0( height ), y1( height ), yWeight( height );
+	auto samples = [&]( int size, int factor, int maxFactor, int sourceSize, vector<int>& s0, vector<int>& s1, vector<int>& weight )
+	{
+		for (int i = 0; i < size; ++i)
+		{
+			float source = (i + 0.5f) * factor / maxFactor - 0.5f;
+			if (source < 0.0f)  source = 0.0f;
+			int first = static_cast<int>(source);
+			s0[i] = first < sourceSize - 1 ? first : sourceSize - 1;
+			s1[i] = first + 1 < sourceSize - 1 ? first + 1 : sourceSize - 1;
+			weight[i] = static_cast<int>((source - first) * 256.0f + 0.5f);
+		}
+	};
+	samples( width, component.h, decoder.maxH, component.width, x0, x1, xWeight );
+	samples( height, component.v, decoder.maxV, component.height, y0, y1, yWeight );
+
+	for (int y = 0; y < height; ++y)
+	{
+		const uint8_t* row0 = &component.pixels[static_cast<size_t>(y0[y]) * stride];
+		const uint8_t* row1 = &component.pixels[static_cast<size_t>(y1[y]) * stride];
+		uint8_t* dest = &(*output)[static_cast<size_t>(y) * width];
+		for (int x = 0; x < width; ++x)
+		{
+			int top    = row0[x0[x]] * (256 - xWeight[x]) + row0[x1[x]] * xWeight[x];
+			int bottom = row1[x0[x]] * (256 - xWeight[x]) + row1[x1[x]] * xWeight[x];
+			dest[x] = static_cast<uint8_t>((top * (256 - yWeight[y]) + bottom * yWeight[y] + 32768) >> 16);
+		}
+	}
+}
+
+// Clamp a fixed point colour value (16 fractional bits) to a byte
+static uint8_t ClampColour( int value )
+{
+	value = (value + 32768) >> 16;
+	return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Convert the decoded components to an RGBA image
+static void OutputImage( JPEGDecoder& decoder, Image* image )
+{
+	vector<uint8_t> planes[3];
+	for (int i = 0; i < decoder.numComponents; ++i)
+	{
+		InverseDCT( decoder, decoder.components[i] );
+		UpsampleComponent( decoder, decoder.components[i], &planes[i] );
+		decoder.components[i].coefs.clear();
+		decoder.components[i].coefs.shrink_to_fit();
+	}
+
+	// Colour images are YCbCr unless an Adobe marker or the component ids say they are RGB
+	bool rgb = decoder.adobeTransform == 0 ||
+	           (decoder.adobeTransform < 0 && decoder.numComponents == 3 && decoder.components[0].id == 'R' &&
+	            decoder.components[1].id == 'G' && decoder.components[2].id == 'B');
+
+	image->Allocate( ImageFormatRGBA8, decoder.width, decoder.height );
+	uint8_t* dest = image->MipData( 0 );
+	size_t pixels = static_cast<size_t>(decoder.width) * decoder.height;
+	for (size_t i = 0; i < pixels; ++i, dest += 4)
+	{
+		if (decoder.numComponents == 1)
+		{
+			dest[0] = dest[1] = dest[2] = planes[0][i];
+		}
+		else if (rgb)
+		{
+			dest[0] = planes[0][i];  dest[1] = planes[1][i];  dest[2] = planes[2][i];
+		}
+		else
+		{
+			// YCbCr to RGB (JFIF) in 16.16 fixed point
+			int y = (planes[0][i] << 16);
+			int cb = planes[1][i] - 128;
+			int cr = planes[2][i] - 128;
+			dest[0] = ClampColour( y + 91881 * cr );
+			dest[1] = ClampColour( y - 22554 * cb - 46802 * cr );
+			dest[2] = ClampColour( y + 116130 * cb );
+		}
+		dest[3] = 255;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------
+// JPG file decoding
+//--------------------------------------------------------------------------------------
+
+bool DecodeJPEG( const uint8_t* fileData, size_t fileSize, Image* image, string* error )
+{
+	JPEGDecoder decoder;
+	memset( decoder.quant, 0, sizeof(decoder.quant) );
+	memset( decoder.dcTables, 0, sizeof(decoder.dcTables) );
+	memset( decoder.acTables, 0, sizeof(decoder.acTables) );
+	decoder.numComponents = 0;
+	decoder.restartInterval = 0;
+	decoder.adobeTransform = -1;
+	decoder.progressive = false;
+	bool hasFrame = false, hasScan = false;
+
+	const uint8_t* end = fileData + fileSize;
+	const uint8_t* position = fileData + 2; // After start of image marker
+	for (;;)
+	{
+		// Find the next marker, skipping any fill bytes
+		while (position < end && *position == 0xFF && position + 1 < end && position[1] == 0xFF)  ++position;
+		if (end - position < 2 || position[0] != 0xFF)
+		{
+			// Accept a file missing its end, as long as some image data has been read
+			if (hasScan)  break;
+			return ImageError( error, "JPG file is truncated" );
+		}
+		int marker = position[1];
+		position += 2;
+		if (marker == 0xD9)  break; // End of image
+		if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7))  continue; // Markers without data
+
+		// All other markers are followed by a segment with its length
+		if (end - position < 2)  return ImageError( error, "JPG file is truncated" );
+		int length = (position[0] << 8) | position[1];
+		if (length < 2 || end - position < length)  return ImageError( error, "JPG file is truncated" );
+		const uint8_t* segment = position + 2;
+		const uint8_t* segmentEnd = position + length;
+		position = segmentEnd;
+
+		if (marker == 0xDB) // Quantisation tables
+		{
+			while (segment < segmentEnd)
+			{
+				int precision = segment[0] >> 4, table = segment[0] & 15;
+				int tableSize = precision ? 128 : 64;
+				if (table > 3 || precision > 1 || segmentEnd - segment < 1 + tableSize)  return ImageError( error, "Invalid JPG quantisation table" );
+				for (int i = 0; i < 64; ++i)
+				{
+					decoder.quant[table][kZigZag[i]] = static_cast<uint16_t>(precision ? (segment[1 + i * 2] << 8) | segment[2 + i * 2] : segment[1 + i]);
+				}
+				segment += 1 + tableSize;
+			}
+		}
+		else if (marker == 0xC4) // Huffman tables
+		{
+			while (segment < segmentEnd)
+			{
+				if (segmentEnd - segment < 17)  return ImageError( error, "Invalid JPG Huffman table" );
+				int tableClass = segment[0] >> 4, table = segment[0] & 15;
+				int numValues = 0;
+				for (int i = 0; i < 16; ++i)  numValues += segment[1 + i];
+				if (tableClass > 1 || table > 3 || numValues > 256 || segmentEnd - segment < 17 + numValues)
+				{
+					return ImageError( error, "Invalid JPG Huffman table" );
+				}
+				JPEGHuffman* huffman = tableClass ? &decoder.acTables[table] : &decoder.dcTables[table];
+				if (!BuildHuffman( huffman, segment + 1, segment + 17, numValues ))  return ImageError( error, "Invalid JPG Huffman table" );
+				segment += 17 + numValues;
+			}
+		}
+		else if (marker == 0xDD) // Restart interval
+		{
+			if (length < 4)  return ImageError( error, "Invalid JPG restart interval" );
+			decoder.restartInterval = (segment[0] << 8) | segment[1];
+		}
+		else if (marker == 0xEE) // Adobe application marker, gives the colour transform
+		{
+			if (length >= 14 && memcmp( segment, "Adobe", 5 ) == 0)  decoder.adobeTransform = segment[11];
+		}
+		else if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2) // Start of frame - baseline, extended or progressive
+		{
+			if (hasFrame || length < 8)  return ImageError( error, "Invalid JPG frame" );
+			decoder.progressive = marker == 0xC2;
+			decoder.height = (segment[1] << 8) | segment[2];
+			decoder.width = (segment[3] << 8) | segment[4];
+			decoder.numComponents = segment[5];
+			if (segment[0] != 8)  return ImageError( error, "Unsupported JPG precision" );
+			if (decoder.width == 0 || decoder.height == 0)  return ImageError( error, "Unsupported JPG dimensions" );
+			if (decoder.numComponents != 1 && decoder.numComponents != 3)  return ImageError( error, "Unsupported JPG colour format" );
+			if (length < 8 + 3 * decoder.numComponents)  return ImageError( error, "Invalid JPG frame" );
+
+			decoder.maxH = decoder.maxV = 1;
+			for (int i = 0; i < decoder.numComponents; ++i)
+			{
+				JPEGComponent& component = decoder.components[i];
+				component.id = segment[6 + i * 3];
+				component.h = segment[7 + i * 3] >> 4;
+				component.v = segment[7 + i * 3] & 15;
+				component.quantTable = segment[8 + i * 3];
+				if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quantTable > 3)
+				{
+					return ImageError( error, "Invalid JPG frame" );
+				}
+				if (component.h > decoder.maxH)  decoder.maxH = component.h;
+				if (component.v > decoder.maxV)  decoder.maxV = component.v;
+			}
+			decoder.mcusX = (decoder.width + decoder.maxH * 8 - 1) / (decoder.maxH * 8);
+			decoder.mcusY = (decoder.height + decoder.maxV * 8 - 1) / (decoder.maxV * 8);
+			for (int i = 0; i < decoder.numComponents; ++i)
+			{
+				JPEGComponent& component = decoder.components[i];
+				component.width  = (decoder.width  * component.h + decoder.maxH - 1) / decoder.maxH;
+				component.height = (decoder.height * component.v + decoder.maxV - 1) / decoder.maxV;
+				component.blocksX = decoder.mcusX * component.h;
+				component.blocksY = decoder.mcusY * component.v;
+				component.coefs.assign( static_cast<size_t>(component.blocksX) * component.blocksY * 64, 0 );
+			}
+			hasFrame = true;
+		}
+		else if ((marker >= 0xC3 && marker <= 0xCF) && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+		{
+			return ImageError( error, "Unsupported JPG coding (lossless, hierarchical or arithmetic)" );
+		}
+		else if (marker == 0xDA) // Start of scan
+		{
+			if (!hasFrame || length < 6)  return ImageError( error, "Invalid JPG scan" );
+			decoder.numScanComponents = segment[0];
+			if (decoder.numScanComponents < 1 || decoder.numScanComponents > decoder.numComponents ||
+			    length != 6 + 2 * decoder.numScanComponents)
+			{
+				return ImageError( error, "Invalid JPG scan" );
+			}
+			for (int i = 0; i < decoder.numScanComponents; ++i)
+			{
+				int id = segment[1 + i * 2];
+				JPEGComponent* component = NULL;
+				for (int c = 0; c < decoder.numComponents; ++c)
+				{
+					if (decoder.components[c].id == id)  component = &decoder.components[c];
+				}
+				if (!component)  return ImageError( error, "Invalid JPG scan" );
+				component->dcTable = segment[2 + i * 2] >> 4;
+				component->acTable = segment[2 + i * 2] & 15;
+				if (component->dcTable > 3 || component->acTable > 3)  return ImageError( error, "Invalid JPG scan" );
+				decoder.scanComponents[i] = component;
+			}
+			const uint8_t* scanParams = segment + 1 + 2 * decoder.numScanComponents;
+			decoder.spectralStart = scanParams[0];
+			decoder.spectralEnd = scanParams[1];
+			decoder.approxHigh = scanParams[2] >> 4;
+			decoder.approxLow = scanParams[2] & 15;
+			if (decoder.progressive)
+			{
+				bool validDC = decoder.spectralStart == 0 && decoder.spectralEnd == 0;
+				bool validAC = decoder.spectralStart > 0 && decoder.spectralEnd >= decoder.spectralStart &&
+				               decoder.spectralEnd < 64 && decoder.numScanComponents == 1;
+				if ((!validDC && !validAC) || decoder.approxLow > 13)  return ImageError( error, "Invalid JPG scan" );
+			}
+
+			position = DecodeScan( decoder, position, end );
+			if (!position)  return ImageError( error, "Corrupt JPG image data" );
+			hasScan = true;
+		}
+		// Other markers (application data, comments etc.) are skipped
+	}
+
+	if (!hasScan)  return ImageError( error, "JPG file has no image data" );
+	OutputImage( decoder, image );
+	return true;
+}
@@ -0,0 +1,568 @@
+//--------------------------------------------------------------------------------------
+//	PNG file decoding, including the zlib (deflate) decompression it needs. All colour
+//	types and bit depths are converted to RGBA8
+//--------------------------------------------------------------------------------------
+
+#include "ImageDecoders.h"
+#include <string.h>
+
+//--------------------------------------------------------------------------------------
+// Deflate decompression
+//--------------------------------------------------------------------------------------
+
+// Huffman code table for deflate. Codes up to kFastBits long are decoded with one table lookup,
+// longer codes are found from the range of canonical codes of each length
+static const int kFastBits = 9;
+struct InflateHuffman
+{
+	uint16_t fast[1 << kFastBits]; // (code length << 9) | symbol, 0 for codes longer than kFastBits
+	uint16_t firstCode[17];        // First canonical code of each length
+	uint16_t firstSymbol[17];      // Index in symbols of the first code of each length
+	uint32_t maxCode[18];          // One past the last code of each length, shifted up to 16 bits
+	uint16_t symbols[288];         // Symbols in canonical code order
+};
+
+// Reverse the lowest given number of bits (deflate stores Huffman codes with their first bit lowest)
+static uint32_t ReverseBits( uint32_t value, int numBits )
+{
+	uint32_t result = 0;
+	for (int bit = 0; bit < numBits; ++bit)
+	{
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+	return result;
+}
+
+// Build a Huffman table from a list of code lengths for each symbol. Returns false if the lengths
+// do not make a valid code
+static bool BuildHuffman( InflateHuffman* table, const uint8_t* lengths, int numSymbols )
+{
+	int lengthCounts[17] = {};
+	for (int symbol = 0; symbol < numSymbols; ++symbol)  ++lengthCounts[lengths[symbol]];
+	lengthCounts[0] = 0;
+
+	memset( table->fast, 0, sizeof(table->fast) );
+	uint32_t nextCode[16];
+	uint32_t code = 0;
+	int symbolIndex = 0;
+	for (int length = 1; length < 16; ++length)
+	{
+		nextCode[length] = code;
+		table->firstCode[length] = static_cast<uint16_t>(code);
+		table->firstSymbol[length] = static_cast<uint16_t>(symbolIndex);
+		code += lengthCounts[length];
+		if (lengthCounts[length] && code - 1 >= (1u << length))  return false; // Over-subscribed
+		table->maxCode[length] = code << (16 - length);
+		code <<= 1;
+		symbolIndex += lengthCounts[length];
+	}
+	table->maxCode[16] = 0x10000;
+
+	for (int symbol = 0; symbol < numSymbols; ++symbol)
+	{
+		int length = lengths[symbol];
+		if (length == 0)  continue;
+		int index = nextCode[length] - table->firstCode[length] + table->firstSymbol[length];
+		table->symbols[index] = static_cast<uint16_t>(symbol);
+		if (length <= kFastBits)
+		{
+			uint16_t entry = static_cast<uint16_t>((length << 9) | symbol);
+			for (uint32_t fill = ReverseBits( nextCode[length], length ); fill < (1u << kFastBits); fill += (1u << length))
+			{
+				table->fast[fill] = entry;
+			}
+		}
+		++nextCode[length];
+	}
+	return true;
+}
+
+
+// Reads the deflate bit stream, lowest bit first
+class InflateReader
+{
+public:
+	InflateReader( const uint8_t* data, size_t size ) : mData( data ), mEnd( data + size ), mBits( 0 ), mNumBits( 0 ), mOverrun( 0 ) {}
+
+	// Make sure at least 32 bits are available, reading past the end gives zeros (and is an error
+	// only if those bits are actually used, see Overrun)
+	void Fill()
+	{
+		while (mNumBits <= 56)
+		{
+			if (mData < mEnd)  mBits |= static_cast<uint64_t>(*mData++) << mNumBits;
+			else               ++mOverrun;
+			mNumBits += 8;
+		}
+	}
+
+	uint32_t Bits( int numBits )
+	{
+		if (mNumBits < numBits)  Fill();
+		uint32_t value = static_cast<uint32_t>(mBits & ((1ull << numBits) - 1));
+		mBits >>= numBits;
+		mNumBits -= numBits;
+		return value;
+	}
+
+	// Decode a symbol with the given table, returns -1 for an invalid code
+	int Decode( const InflateHuffman& table )
+	{
+		if (mNumBits < 16)  Fill();
+		uint16_t entry = table.fast[mBits & ((1 << kFastBits) - 1)];
+		if (entry)
+		{
+			int length = entry >> 9;
+			mBits >>= length;
+			mNumBits -= length;
+			return entry & 511;
+		}
+
+		uint32_t code = ReverseBits( static_cast<uint32_t>(mBits & 0xFFFF), 16 );
+		int length = kFastBits + 1;
+		while (length < 16 && code >= table.maxCode[length])  ++length;
+		if (length >= 16)  return -1;
+		int index = (code >> (16 - length)) - table.firstCode[length] + table.firstSymbol[length];
+		mBits >>= length;
+		mNumBits -= length;
+		return table.symbols[index];
+	}
+
+	// Discard bits up to the next byte boundary, for stored blocks
+	void AlignToByte()  { Bits( mNumBits % 8 ); }
+
+	// Read whole bytes (after AlignToByte) - takes bytes already in the bit buffer first
+	bool Bytes( uint8_t* dest, size_t count )
+	{
+		while (count > 0 && mNumBits > 0)
+		{
+			if (mNumBits <= mOverrun * 8)  return false; // Only zeros from past the end left in the buffer
+			*dest++ = static_cast<uint8_t>(Bits( 8 ));
+			--count;
+		}
+		if (static_cast<size_t>(mEnd - mData) < count)  return false;
+		memcpy( dest, mData, count );
+		mData += count;
+		return true;
+	}
+
+	// Have more bits been used than there were in the data
+	bool Overrun()  { return mOverrun * 8 > mNumBits; }
+
+private:
+	const uint8_t* mData;
+	const uint8_t* mEnd;
+	uint64_t       mBits;
+	int            mNumBits;
+	int            mOverrun; // Bytes of zeros added past the end of the data
+};
+
+
+// Base values and extra bits for deflate lengths and distances
+static const uint16_t kLengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+static const uint8_t  kLengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+static const uint16_t kDistBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,
+                                        4097,6145,8193,12289,16385,24577 };
+static const uint8_t  kDistExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+// Decompress a zlib stream (as used in PNG files) into the output, which is appended to. The
+// expected output size is reserved in advance, and data that decompresses to more is rejected
+static bool Inflate( const uint8_t* data, size_t size, size_t expectedSize, vector<uint8_t>* output, string* error )
+{
+	if (size < 2 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20))
+	{
+		return ImageError( error, "Invalid PNG compressed data header" );
+	}
+	InflateReader reader( data + 2, size - 2 );
+	output->reserve( expectedSize );
+
+	InflateHuffman literals, distances;
+	bool finalBlock = false;
+	while (!finalBlock)
+	{
+		finalBlock = reader.Bits( 1 ) != 0;
+		uint32_t blockType = reader.Bits( 2 );
+		if (blockType == 0)
+		{
+			// Stored block - length, its complement, then raw bytes
+			reader.AlignToByte();
+			uint32_t length = reader.Bits( 16 );
+			uint32_t lengthCheck = reader.Bits( 16 );
+			if ((length ^ 0xFFFF) != lengthCheck)  return ImageError( error, "Corrupt PNG compressed data" );
+			size_t start = output->size();
+			if (start + length > expectedSize)  return ImageError( error, "PNG compressed data is larger than the image" );
+			output->resize( start + length );
+			if (length > 0 && !reader.Bytes( &(*output)[start], length ))  return ImageError( error, "PNG compressed data is truncated" );
+			continue;
+		}
+
+		if (blockType == 1)
+		{
+			// Fixed Huffman codes
+			uint8_t lengths[288 + 32];
+			memset( lengths, 8, 144 );
+			memset( lengths + 144, 9, 112 );
+			memset( lengths + 256, 7, 24 );
+			memset( lengths + 280, 8, 8 );
+			memset( lengths + 288, 5, 32 );
+			BuildHuffman( &literals, lengths, 288 );
+			BuildHuffman( &distances, lengths + 288, 32 );
+		}
+		else if (blockType == 2)
+		{
+			// Dynamic Huffman codes - code lengths are themselves Huffman coded
+			static const uint8_t kCodeLengthOrder[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+			int numLiterals = reader.Bits( 5 ) + 257;
+			int numDistances = reader.Bits( 5 ) + 1;
+			int numCodeLengths = reader.Bits( 4 ) + 4;
+			uint8_t codeLengthLengths[19] = {};
+			for (int i = 0; i < numCodeLengths; ++i)  codeLengthLengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(reader.Bits( 3 ));
+			InflateHuffman codeLengths;
+			if (!BuildHuffman( &codeLengths, codeLengthLengths, 19 ))  return ImageError( error, "Corrupt PNG compressed data" );
+
+			uint8_t lengths[288 + 32];
+			int count = 0;
+			while (count < numLiterals + numDistances)
+			{
+				int symbol = reader.Decode( codeLengths );
+				if (symbol < 0)  return ImageError( error, "Corrupt PNG compressed data" );
+				if (symbol < 16)
+				{
+					lengths[count++] = static_cast<uint8_t>(symbol);
+					continue;
+				}
+				int repeat;
+				uint8_t value = 0;
+				if (symbol == 16)
+				{
+					if (count == 0)  return ImageError( error, "Corrupt PNG compressed data" );
+					repeat = reader.Bits( 2 ) + 3;
+					value = lengths[count - 1];
+				}
+				else if (symbol == 17)  repeat = reader.Bits( 3 ) + 3;
+				else                    repeat = reader.Bits( 7 ) + 11;
+				if (count + repeat > numLiterals + numDistances)  return ImageError( error, "Corrupt PNG compressed data" );
+				memset( lengths + count, value, repeat );
+				count += repeat;
+			}
+			if (!BuildHuffman( &literals, lengths, numLiterals ) || !BuildHuffman( &distances, lengths + numLiterals, numDistances ))
+			{
+				return ImageError( error, "Corrupt PNG compressed data" );
+			}
+		}
+		else
+		{
+			return ImageError( error, "Corrupt PNG compressed data" );
+		}
+
+		// Decode literals and back references until the end of block symbol. Past the end of the data
+		// the reader supplies zeros, which may decode as back references for ever, so the reader is
+		// checked after every symbol and the output may not grow beyond the expected size
+		for (;;)
+		{
+			int symbol = reader.Decode( literals );
+			if (reader.Overrun())  return ImageError( error, "PNG compressed data is truncated" );
+			if (symbol < 256)
+			{
+				if (symbol < 0)  return ImageError( error, "Corrupt PNG compressed data" );
+				if (output->size() >= expectedSize)  return ImageError( error, "PNG compressed data is larger than the image" );
+				output->push_back( static_cast<uint8_t>(symbol) );
+				continue;
+			}
+			if (symbol == 256)  break;
+
+			symbol -= 257;
+			if (symbol >= 29)  return ImageError( error, "Corrupt PNG compressed data" );
+			size_t length = kLengthBase[symbol] + reader.Bits( kLengthExtra[symbol] );
+			int distSymbol = reader.Decode( distances );
+			if (distSymbol < 0 || distSymbol >= 30)  return ImageError( error, "Corrupt PNG compressed data" );
+			size_t distance = kDistBase[distSymbol] + reader.Bits( kDistExtra[distSymbol] );
+			if (reader.Overrun())  return ImageError( error, "PNG compressed data is truncated" );
+			if (distance > output->size())  return ImageError( error, "Corrupt PNG compressed data" );
+			if (output->size() + length > expectedSize)  return ImageError( error, "PNG compressed data is larger than the image" );
+
+			// Copy byte by byte, the source may overlap the bytes being written
+			size_t start = output->size();
+			output->resize( start + length );
+			uint8_t* dest = &(*output)[start];
+			const uint8_t* source = dest - distance;
+			for (size_t i = 0; i < length; ++i)  dest[i] = source[i];
+		}
+		if (reader.Overrun())  return ImageError( error, "PNG compressed data is truncated" );
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// PNG decoding
+//--------------------------------------------------------------------------------------
+
+// Read a big-endian 32-bit value
+static uint32_t ReadPNGUInt( const uint8_t* data )
+{
+	return (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+// PNG colour types
+static const int kPNGGrey = 0;
+static const int kPNGRGB = 2;
+static const int kPNGPalette = 3;
+static const int kPNGGreyAlpha = 4;
+static const int kPNGRGBA = 6;
+
+// Information from the header and palette chunks needed to decode the pixels
+struct PNGInfo
+{
+	unsigned int width, height;
+	int          bitDepth;
+	int          colourType;
+	int          channels;
+	uint8_t      palette[256][4];
+	bool         hasColourKey;    // Transparent colour given for grey or RGB images
+	uint16_t     colourKey[3];
+};
+
+// Paeth predictor used by PNG filter type 4
+static uint8_t Paeth( int a, int b, int c )
+{
+	int p = a + b - c;
+	int pa = p > a ? p - a : a - p;
+	int pb = p > b ? p - b : b - p;
+	int pc = p > c ? p - c : c - p;
+	if (pa <= pb && pa <= pc)  return static_cast<uint8_t>(a);
+	if (pb <= pc)  return static_cast<uint8_t>(b);
+	return static_cast<uint8_t>(c);
+}
+
+// Decode one (sub-)image from the decompressed data: undo the filter on each row then convert to
+// RGBA. The pixels are written to the image at (startX + x*stepX, startY + y*stepY), which lets
+// the same code place the pixels of interlaced passes. Returns the number of bytes used, or 0 on
+// error
+static size_t DecodePNGPass( const PNGInfo& info, const uint8_t* data, size_t size, unsigned int width, unsigned int height,
+                             unsigned int startX, unsigned int startY, unsigned int stepX, unsigned int stepY, Image* image )
+{
+	size_t bitsPerPixel = info.bitDepth * info.channels;
+	size_t rowBytes = (width * bitsPerPixel + 7) / 8;
+	size_t filterStep = (bitsPerPixel + 7) / 8; // Byte distance to corresponding byte of the previous pixel
+	if (size < (rowBytes + 1) * height)  return 0;
+
+	vector<uint8_t> previousRow( rowBytes, 0 ), row( rowBytes );
+	for (unsigned int y = 0; y < height; ++y)
+	{
+		// Undo row filter
+		int filter = *data++;
+		const uint8_t* prior = &previousRow[0];
+		for (size_t i = 0; i < rowBytes; ++i)
+		{
+			int left = i >= filterStep ? row[i - filterStep] : 0;
+			int upLeft = i >= filterStep ? prior[i - filterStep] : 0;
+			switch (filter)
+			{
+				case 0:  row[i] = data[i];  break;
+				case 1:  row[i] = static_cast<uint8_t>(data[i] + left);  break;
+				case 2:  row[i] = static_cast<uint8_t>(data[i] + prior[i]);  break;
+				case 3:  row[i] = static_cast<uint8_t>(data[i] + ((left + prior[i]) >> 1));  break;
+				case 4:  row[i] = static_cast<uint8_t>(data[i] + Paeth( left, prior[i], upLeft ));  break;
+				default: return 0;
+			}
+		}
+		data += rowBytes;
+
+		// Convert row to RGBA
+		uint8_t* dest = image->MipData( 0 ) + (static_cast<size_t>(startY + y * stepY) * info.width + startX) * 4;
+		size_t destStep = stepX * 4;
+		for (unsigned int x = 0; x < width; ++x, dest += destStep)
+		{
+			// Read channel values, 16-bit values are kept for the colour key test
+			uint16_t values[4];
+			for (int channel = 0; channel < info.channels; ++channel)
+			{
+				if (info.bitDepth == 8)
+				{
+					values[channel] = row[x * info.channels + channel];
+				}
+				else if (info.bitDepth == 16)
+				{
+					const uint8_t* source = &row[(x * info.channels + channel) * 2];
+					values[channel] = static_cast<uint16_t>((source[0] << 8) | source[1]);
+				}
+				else // 1, 2 or 4 bits, only single channel images
+				{
+					int pixelsPerByte = 8 / info.bitDepth;
+					int shift = 8 - info.bitDepth * (x % pixelsPerByte + 1);
+					values[channel] = (row[x / pixelsPerByte] >> shift) & ((1 << info.bitDepth) - 1);
+				}
+			}
+
+			if (info.colourType == kPNGPalette)
+			{
+				memcpy( dest, info.palette[values[0]], 4 );
+				continue;
+			}
+
+			// Scale to 8 bits
+			uint8_t scaled[4];
+			for (int channel = 0; channel < info.channels; ++channel)
+			{
+				if (info.bitDepth == 16)      scaled[channel] = static_cast<uint8_t>(values[channel] >> 8);
+				else if (info.bitDepth == 8)  scaled[channel] = static_cast<uint8_t>(values[channel]);
+				else                          scaled[channel] = static_cast<uint8_t>(values[channel] * 255 / ((1 << info.bitDepth) - 1));
+			}
+			switch (info.colourType)
+			{
+				case kPNGGrey:
+					dest[0] = dest[1] = dest[2] = scaled[0];
+					dest[3] = (info.hasColourKey && values[0] == info.colourKey[0]) ? 0 : 255;
+					break;
+				case kPNGGreyAlpha:
+					dest[0] = dest[1] = dest[2] = scaled[0];
+					dest[3] = scaled[1];
+					break;
+				case kPNGRGB:
+					dest[0] = scaled[0];  dest[1] = scaled[1];  dest[2] = scaled[2];
+					dest[3] = (info.hasColourKey && values[0] == info.colourKey[0] && values[1] == info.colourKey[1] &&
+					           values[2] == info.colourKey[2]) ? 0 : 255;
+					break;
+				default: // RGBA
+					memcpy( dest, scaled, 4 );
+			}
+		}
+
+		previousRow.swap( row );
+	}
+	return (rowBytes + 1) * height;
+}
+
+
+bool DecodePNG( const uint8_t* fileData, size_t fileSize, Image* image, string* error )
+{
+	PNGInfo info;
+	int interlace = 0;
+	bool hasHeader = false, hasPalette = false;
+	memset( info.palette, 0, sizeof(info.palette) );
+	for (int i = 0; i < 256; ++i)  info.palette[i][3] = 255;
+	info.hasColourKey = false;
+
+	// Read chunks, joining together all the compressed image data
+	vector<uint8_t> compressed;
+	size_t position = 8;
+	for (;;)
+	{
+		if (fileSize - position < 12)  return ImageError( error, "PNG file is truncated" );
+		uint32_t length = ReadPNGUInt( fileData + position );
+		const uint8_t* type = fileData + position + 4;
+		const uint8_t* chunk = fileData + position + 8;
+		if (fileSize - position - 12 < length)  return ImageError( error, "PNG file is truncated" );
+		position += 12 + length; // Length, type, data and CRC (not checked)
+
+		if (memcmp( type, "IHDR", 4 ) == 0)
+		{
+			if (length < 13)  return ImageError( error, "Invalid PNG header" );
+			info.width = ReadPNGUInt( chunk );
+			info.height = ReadPNGUInt( chunk + 4 );
+			info.bitDepth = chunk[8];
+			info.colourType = chunk[9];
+			interlace = chunk[12];
+			if (info.width == 0 || info.height == 0 || info.width > 16384 || info.height > 16384 || chunk[10] != 0 || chunk[11] != 0 || interlace > 1)
+			{
+				return ImageError( error, "Unsupported PNG file" );
+			}
+			switch (info.colourType)
+			{
+				case kPNGGrey:       info.channels = 1;  break;
+				case kPNGRGB:        info.channels = 3;  break;
+				case kPNGPalette:    info.channels = 1;  break;
+				case kPNGGreyAlpha:  info.channels = 2;  break;
+				case kPNGRGBA:       info.channels = 4;  break;
+				default: return ImageError( error, "Unsupported PNG colour type" );
+			}
+			bool validDepth = info.bitDepth == 8 || (info.bitDepth == 16 && info.colourType != kPNGPalette) ||
+			                  ((info.bitDepth == 1 || info.bitDepth == 2 || info.bitDepth == 4) && info.channels == 1);
+			if (!validDepth)  return ImageError( error, "Unsupported PNG bit depth" );
+			hasHeader = true;
+		}
+		else if (memcmp( type, "PLTE", 4 ) == 0)
+		{
+			if (length > 256 * 3 || length % 3 != 0)  return ImageError( error, "Invalid PNG palette" );
+			for (uint32_t i = 0; i < length / 3; ++i)  memcpy( info.palette[i], chunk + i * 3, 3 );
+			hasPalette = true;
+		}
+		else if (memcmp( type, "tRNS", 4 ) == 0 && hasHeader)
+		{
+			if (info.colourType == kPNGPalette)
+			{
+				for (uint32_t i = 0; i < length && i < 256; ++i)  info.palette[i][3] = chunk[i];
+			}
+			else if ((info.colourType == kPNGGrey && length >= 2) || (info.colourType == kPNGRGB && length >= 6))
+			{
+				info.hasColourKey = true;
+				for (int i = 0; i < info.channels; ++i)  info.colourKey[i] = static_cast<uint16_t>((chunk[i * 2] << 8) | chunk[i * 2 + 1]);
+			}
+		}
+		else if (memcmp( type, "IDAT", 4 ) == 0)
+		{
+			compressed.insert( compressed.end(), chunk, chunk + length );
+		}
+		else if (memcmp( type, "IEND", 4 ) == 0)
+		{
+			break;
+		}
+		else if (!(type[0] & 0x20)) // Unknown critical chunk (upper case first letter)
+		{
+			return ImageError( error, "Unsupported PNG chunk" );
+		}
+	}
+	if (!hasHeader || compressed.empty())  return ImageError( error, "PNG file has no image data" );
+	if (info.colourType == kPNGPalette && !hasPalette)  return ImageError( error, "PNG file has no palette" );
+
+	// Decompress then decode all rows, or each of the seven interlaced passes in turn. Each row of
+	// each pass has a filter byte in front. Decompressed data beyond this size is rejected
+	static const unsigned int kPassStartX[7] = { 0, 4, 0, 2, 0, 1, 0 };
+	static const unsigned int kPassStartY[7] = { 0, 0, 4, 0, 2, 0, 1 };
+	static const unsigned int kPassStepX[7]  = { 8, 8, 4, 4, 2, 2, 1 };
+	static const unsigned int kPassStepY[7]  = { 8, 8, 8, 4, 4, 2, 2 };
+	size_t bitsPerPixel = info.bitDepth * info.channels;
+	size_t expectedSize = 0;
+	if (interlace == 0)
+	{
+		expectedSize = ((info.width * bitsPerPixel + 7) / 8 + 1) * info.height;
+	}
+	else
+	{
+		for (int pass = 0; pass < 7; ++pass)
+		{
+			if (info.width <= kPassStartX[pass] || info.height <= kPassStartY[pass])  continue; // Empty pass
+			size_t passWidth  = (info.width  + kPassStepX[pass] - 1 - kPassStartX[pass]) / kPassStepX[pass];
+			size_t passHeight = (info.height + kPassStepY[pass] - 1 - kPassStartY[pass]) / kPassStepY[pass];
+			expectedSize += ((passWidth * bitsPerPixel + 7) / 8 + 1) * passHeight;
+		}
+	}
+	vector<uint8_t> filtered;
+	if (!Inflate( &compressed[0], compressed.size(), expectedSize, &filtered, error ))  return false;
+	if (filtered.empty())  return ImageError( error, "PNG image data is truncated" );
+
+	image->Allocate( ImageFormatRGBA8, info.width, info.height );
+	if (interlace == 0)
+	{
+		if (!DecodePNGPass( info, &filtered[0], filtered.size(), info.width, info.height, 0, 0, 1, 1, image ))
+		{
+			return ImageError( error, "Corrupt PNG image data" );
+		}
+		return true;
+	}
+
+	size_t used = 0;
+	for (int pass = 0; pass < 7; ++pass)
+	{
+		unsigned int passWidth  = (info.width  + kPassStepX[pass] - 1 - kPassStartX[pass]) / kPassStepX[pass];
+		unsigned int passHeight = (info.height + kPassStepY[pass] - 1 - kPassStartY[pass]) / kPassStepY[pass];
+		if (info.width <= kPassStartX[pass] || info.height <= kPassStartY[pass])  continue; // Empty pass
+		size_t passSize = DecodePNGPass( info, filtered.data() + used, filtered.size() - used, passWidth, passHeight,
+		                                 kPassStartX[pass], kPassStartY[pass], kPassStepX[pass], kPassStepY[pass], image );
+		if (!passSize)  return ImageError( error, "Corrupt PNG image data" );
+		used += passSize;
+	}
+	return true;
+}
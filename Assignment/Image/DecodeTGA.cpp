@@ -0,0 +1,138 @@
+//--------------------------------------------------------------------------------------
+//	TGA file decoding - true colour, greyscale and colour mapped images, uncompressed or
+//	run-length encoded, converted to RGBA8
+//--------------------------------------------------------------------------------------
+
+#include "ImageDecoders.h"
+#include <string.h>
+
+//--------------------------------------------------------------------------------------
+// TGA decoding
+//--------------------------------------------------------------------------------------
+
+// Image types, run-length encoded types are these plus 8
+static const int kTGAColourMapped = 1;
+static const int kTGATrueColour = 2;
+static const int kTGAGrey = 3;
+static const int kTGARunLength = 8;
+
+// Size of the fixed header
+static const size_t kTGAHeaderSize = 18;
+
+// Convert a stored pixel or colour map entry (BGR(A) or 15/16-bit) to RGBA
+static void TGAPixel( const uint8_t* source, int bytesPerPixel, bool grey, uint8_t* dest )
+{
+	if (grey)
+	{
+		dest[0] = dest[1] = dest[2] = source[0];
+		dest[3] = bytesPerPixel == 2 ? source[1] : 255;
+	}
+	else if (bytesPerPixel == 2)
+	{
+		// 5 bits per channel, top bit is alpha (but often unused, so treat as opaque)
+		int value = source[0] | (source[1] << 8);
+		dest[0] = static_cast<uint8_t>(((value >> 10) & 31) * 255 / 31);
+		dest[1] = static_cast<uint8_t>(((value >> 5) & 31) * 255 / 31);
+		dest[2] = static_cast<uint8_t>((value & 31) * 255 / 31);
+		dest[3] = 255;
+	}
+	else
+	{
+		dest[0] = source[2];
+		dest[1] = source[1];
+		dest[2] = source[0];
+		dest[3] = bytesPerPixel == 4 ? source[3] : 255;
+	}
+}
+
+bool DecodeTGA( const uint8_t* fileData, size_t fileSize, Image* image, string* error )
+{
+	if (fileSize < kTGAHeaderSize)  return ImageError( error, "Unknown image file type" );
+	int idLength     = fileData[0];
+	int colourMapType = fileData[1];
+	int imageType    = fileData[2];
+	int mapFirst     = fileData[3] | (fileData[4] << 8);
+	int mapLength    = fileData[5] | (fileData[6] << 8);
+	int mapBits      = fileData[7];
+	unsigned int width  = fileData[12] | (fileData[13] << 8);
+	unsigned int height = fileData[14] | (fileData[15] << 8);
+	int pixelBits    = fileData[16];
+	int descriptor   = fileData[17];
+
+	// There is no signature, so check the header carefully to reject other file types
+	bool runLength = (imageType & kTGARunLength) != 0;
+	int baseType = imageType & ~kTGARunLength;
+	bool validType = (baseType == kTGAColourMapped && colourMapType == 1 && pixelBits == 8 && (mapBits == 24 || mapBits == 32)) ||
+	                 (baseType == kTGATrueColour && (pixelBits == 15 || pixelBits == 16 || pixelBits == 24 || pixelBits == 32)) ||
+	                 (baseType == kTGAGrey && (pixelBits == 8 || pixelBits == 16));
+	if (!validType || colourMapType > 1 || (imageType & ~(kTGARunLength | 3)) != 0 || width == 0 || height == 0)
+	{
+		return ImageError( error, "Unknown or unsupported image file type" );
+	}
+
+	// Skip image id, read colour map if present
+	const uint8_t* data = fileData + kTGAHeaderSize + idLength;
+	const uint8_t* end = fileData + fileSize;
+	vector<uint8_t> colourMap;
+	if (colourMapType == 1)
+	{
+		int entryBytes = (mapBits + 7) / 8;
+		if (end - data < mapLength * entryBytes)  return ImageError( error, "TGA file is truncated" );
+		if (baseType == kTGAColourMapped)
+		{
+			colourMap.resize( 256 * 4, 0 );
+			for (int i = 0; i < mapLength; ++i)
+			{
+				if (mapFirst + i < 256)  TGAPixel( data + i * entryBytes, entryBytes, false, &colourMap[(mapFirst + i) * 4] );
+			}
+		}
+		data += mapLength * entryBytes; // Colour maps in true colour files are ignored
+	}
+
+	// Read pixels in file order then place them in the image, which is stored bottom-up unless the
+	// descriptor says otherwise
+	image->Allocate( ImageFormatRGBA8, width, height );
+	int bytesPerPixel = (pixelBits + 7) / 8;
+	bool grey = baseType == kTGAGrey;
+	bool topDown = (descriptor & 0x20) != 0;
+	bool rightToLeft = (descriptor & 0x10) != 0;
+	size_t numPixels = static_cast<size_t>(width) * height;
+	uint8_t pixel[4];
+	size_t runLeft = 0;
+	bool runRepeats = false;
+	auto readPixel = [&]()
+	{
+		if (baseType == kTGAColourMapped)  memcpy( pixel, &colourMap[*data * 4], 4 );
+		else                               TGAPixel( data, bytesPerPixel, grey, pixel );
+		data += bytesPerPixel;
+	};
+	for (size_t i = 0; i < numPixels; ++i)
+	{
+		// Run-length encoded data has a count before each run of repeated or literal pixels
+		if (runLength && runLeft == 0)
+		{
+			if (data >= end)  return ImageError( error, "TGA file is truncated" );
+			runRepeats = (*data & 0x80) != 0;
+			runLeft = (*data & 0x7F) + 1;
+			++data;
+			if (runRepeats)
+			{
+				if (end - data < bytesPerPixel)  return ImageError( error, "TGA file is truncated" );
+				readPixel();
+			}
+		}
+		if (!runLength || !runRepeats)
+		{
+			if (end - data < bytesPerPixel)  return ImageError( error, "TGA file is truncated" );
+			readPixel();
+		}
+		if (runLength)  --runLeft;
+
+		unsigned int x = static_cast<unsigned int>(i % width);
+		unsigned int y = static_cast<unsigned int>(i / width);
+		if (rightToLeft)  x = width - 1 - x;
+		if (!topDown)     y = height - 1 - y;
+		memcpy( image->MipData( 0 ) + (static_cast<size_t>(y) * width + x) * 4, pixel, 4 );
+	}
+	return true;
+}
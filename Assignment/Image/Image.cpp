@@ -0,0 +1,185 @@
+//--------------------------------------------------------------------------------------
+//	Portable image loading - decodes DDS, PNG, JPG and TGA texture files into memory ready
+//	for texture creation
+//--------------------------------------------------------------------------------------
+
+#include "Image.h"
+#include "ImageDecoders.h"
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+
+//--------------------------------------------------------------------------------------
+// Image data
+//--------------------------------------------------------------------------------------
+
+// Is the format block compressed (data stored in 4x4 pixel blocks rather than rows of pixels)
+bool IsBlockCompressed( ImageFormat format )
+{
+	return format == ImageFormatBC1 || format == ImageFormatBC2 || format == ImageFormatBC3 ||
+	       format == ImageFormatBC4 || format == ImageFormatBC5;
+}
+
+// Bytes in a row of pixels (or a row of 4x4 blocks for block compressed formats)
+unsigned int ImageRowPitch( ImageFormat format, unsigned int width )
+{
+	unsigned int blocks = (width + 3) / 4;
+	switch (format)
+	{
+		case ImageFormatBC1:
+		case ImageFormatBC4:
+			return blocks * 8;
+		case ImageFormatBC2:
+		case ImageFormatBC3:
+		case ImageFormatBC5:
+			return blocks * 16;
+		default:
+			return width * 4;
+	}
+}
+
+// Number of rows of pixels (or rows of 4x4 blocks) in an image
+unsigned int ImageRowCount( ImageFormat format, unsigned int height )
+{
+	return IsBlockCompressed( format ) ? (height + 3) / 4 : height;
+}
+
+
+// Set the size and format of the image and allocate space for the given number of mip levels
+void Image::Allocate( ImageFormat newFormat, unsigned int newWidth, unsigned int newHeight, unsigned int numMips )
+{
+	format = newFormat;
+	width = newWidth;
+	height = newHeight;
+
+	mips.resize( numMips );
+	size_t offset = 0;
+	for (unsigned int mip = 0; mip < numMips; ++mip)
+	{
+		mips[mip].width  = newWidth  >> mip ? newWidth  >> mip : 1;
+		mips[mip].height = newHeight >> mip ? newHeight >> mip : 1;
+		mips[mip].rowPitch = ImageRowPitch( format, mips[mip].width );
+		mips[mip].offset = offset;
+		mips[mip].size = static_cast<size_t>(mips[mip].rowPitch) * ImageRowCount( format, mips[mip].height );
+		offset += mips[mip].size;
+	}
+	data.resize( offset );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Image loading
+//--------------------------------------------------------------------------------------
+
+// Set an error description (if an error string was given) and return false, for use in decoders
+bool ImageError( string* error, const char* message )
+{
+	if (error)  *error = message;
+	return false;
+}
+
+// Decode an image from file data in memory. The file type is detected from the data
+bool DecodeImage( const uint8_t* fileData, size_t fileSize, Image* image, string* error )
+{
+	image->format = ImageFormatUnknown;
+	image->width = image->height = 0;
+	image->mips.clear();
+	image->data.clear();
+
+	static const uint8_t PNGSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+	if (fileSize >= 4 && memcmp( fileData, "DDS ", 4 ) == 0)
+	{
+		return DecodeDDS( fileData, fileSize, image, error );
+	}
+	if (fileSize >= 8 && memcmp( fileData, PNGSignature, 8 ) == 0)
+	{
+		return DecodePNG( fileData, fileSize, image, error );
+	}
+	if (fileSize >= 3 && fileData[0] == 0xFF && fileData[1] == 0xD8 && fileData[2] == 0xFF)
+	{
+		return DecodeJPEG( fileData, fileSize, image, error );
+	}
+
+	// TGA files have no signature, so anything else is tried as a TGA (which checks its header)
+	return DecodeTGA( fileData, fileSize, image, error );
+}
+
+// Load and decode an image file
+bool LoadImageFile( const string& fileName, Image* image, string* error )
+{
+	FILE* file = fopen( fileName.c_str(), "rb" );
+	if (!file)
+	{
+		image->mips.clear();
+		return ImageError( error, "Cannot open file" );
+	}
+
+	vector<uint8_t> fileData;
+	fseek( file, 0, SEEK_END );
+	long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	if (fileSize > 0)
+	{
+		fileData.resize( fileSize );
+		if (fread( &fileData[0], 1, fileSize, file ) != static_cast<size_t>(fileSize))
+		{
+			fileData.clear();
+		}
+	}
+	fclose( file );
+	if (fileData.empty())
+	{
+		image->mips.clear();
+		return ImageError( error, "Cannot read file" );
+	}
+
+	return DecodeImage( &fileData[0], fileData.size(), image, error );
+}
+
+// Load and decode several image files in parallel
+bool LoadImageFiles( const vector<string>& fileNames, vector<Image>* images, vector<string>* errors, unsigned int numThreads )
+{
+	images->resize( fileNames.size() );
+	vector<string> fileErrors( fileNames.size() );
+	vector<char> success( fileNames.size(), 0 );
+
+	// Each thread takes the next file until there are none left - files vary a lot in decode time
+	// so this balances better than giving each thread a fixed share. The current thread takes part
+	atomic<size_t> nextFile( 0 );
+	auto worker = [&]()
+	{
+		for (size_t file = nextFile++; file < fileNames.size(); file = nextFile++)
+		{
+			try
+			{
+				success[file] = LoadImageFile( fileNames[file], &(*images)[file], &fileErrors[file] );
+			}
+			catch (...) // Out of memory for example, must not escape the thread
+			{
+				fileErrors[file] = "Exception while loading file";
+			}
+		}
+	};
+
+	if (numThreads == 0)  numThreads = thread::hardware_concurrency();
+	if (numThreads > fileNames.size())  numThreads = static_cast<unsigned int>(fileNames.size());
+	vector<thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i)
+	{
+		threads.push_back( thread( worker ) );
+	}
+	worker();
+	for (unsigned int i = 0; i < threads.size(); ++i)
+	{
+		threads[i].join();
+	}
+
+	bool allLoaded = true;
+	for (size_t file = 0; file < fileNames.size(); ++file)
+	{
+		if (!success[file])  allLoaded = false;
+	}
+	if (errors)  errors->swap( fileErrors );
+	return allLoaded;
+}
@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------
+//	Portable image loading - decodes DDS, PNG, JPG and TGA texture files into memory ready
+//	for texture creation. Has no dependency on DirectX or Windows so it can also be used
+//	in the asset pipeline and benchmarks on other platforms
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_IMAGE_H_INCLUDED
+#define CO2409_IMAGE_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+//--------------------------------------------------------------------------------------
+// Image data
+//--------------------------------------------------------------------------------------
+
+// Pixel formats of loaded images. Values are the matching DXGI_FORMAT so the renderer can
+// use them directly, but are defined here so image code does not depend on DirectX
+enum ImageFormat
+{
+	ImageFormatUnknown = 0,
+	ImageFormatRGBA8   = 28, // DXGI_FORMAT_R8G8B8A8_UNORM - all decoded images use this format
+	ImageFormatBC1     = 71, // DXGI_FORMAT_BC1_UNORM - block compressed formats only come from DDS files
+	ImageFormatBC2     = 74, // DXGI_FORMAT_BC2_UNORM
+	ImageFormatBC3     = 77, // DXGI_FORMAT_BC3_UNORM
+	ImageFormatBC4     = 80, // DXGI_FORMAT_BC4_UNORM
+	ImageFormatBC5     = 83, // DXGI_FORMAT_BC5_UNORM
+};
+
+// Is the format block compressed (data stored in 4x4 pixel blocks rather than rows of pixels)
+bool IsBlockCompressed( ImageFormat format );
+
+// Bytes in a row of pixels (or a row of 4x4 blocks for block compressed formats)
+unsigned int ImageRowPitch( ImageFormat format, unsigned int width );
+
+// Number of rows of pixels (or rows of 4x4 blocks) in an image
+unsigned int ImageRowCount( ImageFormat format, unsigned int height );
+
+
+// A single mip level within an image's data
+struct ImageMip
+{
+	unsigned int width;
+	unsigned int height;
+	unsigned int rowPitch; // Bytes from one row of pixels/blocks to the next
+	size_t       offset;   // Offset of the mip level in the image data
+	size_t       size;     // Size of the mip level in bytes
+};
+
+// An image loaded from a file, with one or more mip levels stored one after another
+struct Image
+{
+	ImageFormat      format;
+	unsigned int     width;
+	unsigned int     height;
+	vector<ImageMip> mips;  // At least one mip level (the full size image) in a successfully loaded image
+	vector<uint8_t>  data;
+
+	// Access the pixels/blocks of a mip level
+	uint8_t*       MipData( unsigned int mip )        { return &data[mips[mip].offset]; }
+	const uint8_t* MipData( unsigned int mip ) const  { return &data[mips[mip].offset]; }
+
+	// Set the size and format of the image and allocate space for the given number of mip levels,
+	// which are laid out one after another with no padding between rows
+	void Allocate( ImageFormat newFormat, unsigned int newWidth, unsigned int newHeight, unsigned int numMips = 1 );
+};
+
+
+//--------------------------------------------------------------------------------------
+// Image loading
+//--------------------------------------------------------------------------------------
+
+// Decode an image from file data in memory. The file type is detected from the data, DDS files
+// are copied without decoding (apart from reordering uncompressed pixels to RGBA), other file
+// types are decoded to RGBA8 with a single mip level. Returns false on failure, with a description
+// of the problem in the error string if one is given
+bool DecodeImage( const uint8_t* fileData, size_t fileSize, Image* image, string* error = NULL );
+
+// Load and decode an image file. Returns false on failure, see DecodeImage
+bool LoadImageFile( const string& fileName, Image* image, string* error = NULL );
+
+// Load and decode several image files in parallel. Files are shared between the given number of
+// threads (0 to use all hardware threads). The output lists are resized to match the file list.
+// Returns false if any file failed, the errors list gives a description for each failed file
+// (empty for those that loaded)
+bool LoadImageFiles( const vector<string>& fileNames, vector<Image>* images, vector<string>* errors = NULL,
+                     unsigned int numThreads = 0 );
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,797 @@
+//--------------------------------------------------------------------------------------
+//	Block compression of images to BC1, BC3, BC4 and BC5, and decompression back to RGBA8.
+//	Colour blocks are fitted along their principal axis then refined with a least squares
+//	fit, single channel blocks use their range then refine the same way. Texel matching for
+//	each candidate is done four colour texels at a time with MathSIMD.h, or sixteen single
+//	channel texels at a time with SSE2 where available
+//--------------------------------------------------------------------------------------
+
+#include "ImageCompress.h"
+#include "ImageMips.h"
+#include "MathSIMD.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Block palettes - shared by the encoder and decoder so the encoder measures errors against
+// exactly the colours that will be decoded
+//--------------------------------------------------------------------------------------
+
+// Expand 5 and 6 bit colour channels to 8 bits
+static inline int Expand5( int value )  { return (value << 3) | (value >> 2); }
+static inline int Expand6( int value )  { return (value << 2) | (value >> 4); }
+
+// Unpack a 565 colour to 8-bit red, green and blue
+static void Unpack565( uint16_t colour, int* rgb )
+{
+	rgb[0] = Expand5( colour >> 11 );
+	rgb[1] = Expand6( (colour >> 5) & 63 );
+	rgb[2] = Expand5( colour & 31 );
+}
+
+// Pack 8-bit colour channels (already quantised to 5/6/5 bits) into a 565 colour
+static inline uint16_t Pack565( int red, int green, int blue )
+{
+	return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+// Quantise a floating point colour (0->255 range) to 565, rounding to nearest
+static uint16_t Quantise565( float red, float green, float blue )
+{
+	int r = static_cast<int>(red   * (31.0f / 255.0f) + 0.5f);
+	int g = static_cast<int>(green * (63.0f / 255.0f) + 0.5f);
+	int b = static_cast<int>(blue  * (31.0f / 255.0f) + 0.5f);
+	r = r < 0 ? 0 : (r > 31 ? 31 : r);
+	g = g < 0 ? 0 : (g > 63 ? 63 : g);
+	b = b < 0 ? 0 : (b > 31 ? 31 : b);
+	return Pack565( r, g, b );
+}
+
+// Get the four colours of a BC1 block from its endpoints. When the first endpoint is not greater
+// than the second the block has three colours and transparent black (alpha returned as 0)
+static void BC1Palette( uint16_t colour0, uint16_t colour1, int palette[4][4] )
+{
+	Unpack565( colour0, palette[0] );
+	Unpack565( colour1, palette[1] );
+	palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		int value0 = palette[0][channel], value1 = palette[1][channel];
+		if (colour0 > colour1)
+		{
+			palette[2][channel] = (2 * value0 + value1) / 3;
+			palette[3][channel] = (value0 + 2 * value1) / 3;
+		}
+		else
+		{
+			palette[2][channel] = (value0 + value1) / 2;
+			palette[3][channel] = 0;
+		}
+	}
+	if (colour0 <= colour1)  palette[3][3] = 0;
+}
+
+// Get the eight values of a BC4 block (also used for BC3 alpha and BC5) from its endpoints. When the
+// first endpoint is greater there are six interpolated values, otherwise four plus 0 and 255
+static void BC4Palette( int value0, int value1, int palette[8] )
+{
+	palette[0] = value0;
+	palette[1] = value1;
+	if (value0 > value1)
+	{
+		for (int i = 2; i < 8; ++i)  palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+	}
+	else
+	{
+		for (int i = 2; i < 6; ++i)  palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+
+//--------------------------------------------------------------------------------------
+// Colour block encoding (BC1, and the colour half of BC3)
+//--------------------------------------------------------------------------------------
+
+// Best pair of endpoints for each 8-bit value when a whole block is a single colour. The block uses
+// the 2/3 + 1/3 palette entry, which reaches values that a single 5 or 6 bit endpoint cannot
+struct SingleColourTables
+{
+	uint8_t match5[256][2];
+	uint8_t match6[256][2];
+
+	SingleColourTables()
+	{
+		Build( match5, 31, Expand5 );
+		Build( match6, 63, Expand6 );
+	}
+
+	static void Build( uint8_t match[256][2], int maxValue, int (*expand)( int ) )
+	{
+		for (int value = 0; value < 256; ++value)
+		{
+			int bestError = 256 * 3;
+			for (int end0 = 0; end0 <= maxValue; ++end0)
+			{
+				for (int end1 = 0; end1 <= maxValue; ++end1)
+				{
+					// Prefer closer endpoints on a tie, they are more robust to decoder rounding
+					int error = abs( (2 * expand( end0 ) + expand( end1 )) / 3 - value ) * 3 + (abs( end0 - end1 ) > 0);
+					if (error < bestError)
+					{
+						bestError = error;
+						match[value][0] = static_cast<uint8_t>(end0);
+						match[value][1] = static_cast<uint8_t>(end1);
+					}
+				}
+			}
+		}
+	}
+};
+
+// Thread-safe construction on first use
+static const SingleColourTables& GetSingleColourTables()
+{
+	static const SingleColourTables tables;
+	return tables;
+}
+
+
+// The 16 texels of a block as floats, four texels per SIMD register, ready for matching
+struct ColourBlock
+{
+	TFloat32x4 red[4];
+	TFloat32x4 green[4];
+	TFloat32x4 blue[4];
+};
+
+// Find the nearest palette colour to each texel for the given endpoints, treating the block as four
+// colour whatever the endpoint order. Returns the squared error and packed 2-bit indices
+static float MatchColours( const ColourBlock& block, uint16_t colour0, uint16_t colour1, uint32_t* indices )
+{
+	// Four colour palette in the order of the endpoints given. The interpolation is symmetric so the
+	// colours are the same as the decoder will use once the endpoints are put in four colour order
+	int palette[4][3];
+	Unpack565( colour0, palette[0] );
+	Unpack565( colour1, palette[1] );
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+		palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+	}
+	TFloat32x4 paletteRed[4], paletteGreen[4], paletteBlue[4], paletteIndex[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		paletteRed[i]   = Splat4( static_cast<float>(palette[i][0]) );
+		paletteGreen[i] = Splat4( static_cast<float>(palette[i][1]) );
+		paletteBlue[i]  = Splat4( static_cast<float>(palette[i][2]) );
+		paletteIndex[i] = Splat4( static_cast<float>(i) );
+	}
+
+	TFloat32x4 totalError = Zero4();
+	uint32_t packed = 0;
+	for (int group = 0; group < 4; ++group)
+	{
+		TFloat32x4 bestError = Zero4();
+		TFloat32x4 bestIndex = Zero4(); // Indices held as floats, exact for these small values
+		for (int i = 0; i < 4; ++i)
+		{
+			TFloat32x4 dRed   = Sub4( block.red[group],   paletteRed[i] );
+			TFloat32x4 dGreen = Sub4( block.green[group], paletteGreen[i] );
+			TFloat32x4 dBlue  = Sub4( block.blue[group],  paletteBlue[i] );
+			TFloat32x4 error = Add4( Add4( Mul4( dRed, dRed ), Mul4( dGreen, dGreen ) ), Mul4( dBlue, dBlue ) );
+			if (i == 0)
+			{
+				bestError = error;
+				continue;
+			}
+			bestIndex = Select4( Greater4( bestError, error ), paletteIndex[i], bestIndex );
+			bestError = Min4( error, bestError );
+		}
+		totalError = Add4( totalError, bestError );
+
+		// Pack the four indices into 2-bit fields, texel 0 in the lowest bits
+		float groupIndices[4];
+		Store4Unaligned( groupIndices, bestIndex );
+		for (int texel = 0; texel < 4; ++texel)
+		{
+			packed |= static_cast<uint32_t>(groupIndices[texel]) << (group * 8 + texel * 2);
+		}
+	}
+	*indices = packed;
+
+	float errors[4];
+	Store4Unaligned( errors, totalError );
+	return errors[0] + errors[1] + errors[2] + errors[3];
+}
+
+// Least squares fit of endpoints to the block given the palette index of each texel. Returns false
+// if the indices do not constrain both endpoints (e.g. all texels use the same index)
+static bool FitColourEndpoints( const uint8_t* texels, uint32_t indices, uint16_t* colour0, uint16_t* colour1 )
+{
+	// Weight of the first endpoint for each index in four colour mode
+	static const float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[3] = { 0.0f, 0.0f, 0.0f };
+	float bx[3] = { 0.0f, 0.0f, 0.0f };
+	for (int texel = 0; texel < 16; ++texel)
+	{
+		float a = Weights[(indices >> (texel * 2)) & 3];
+		float b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int channel = 0; channel < 3; ++channel)
+		{
+			ax[channel] += a * texels[texel * 4 + channel];
+			bx[channel] += b * texels[texel * 4 + channel];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (fabsf( determinant ) < 1e-6f)
+	{
+		return false;
+	}
+
+	float end0[3], end1[3];
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		end0[channel] = (ax[channel] * bb - bx[channel] * ab) / determinant;
+		end1[channel] = (bx[channel] * aa - ax[channel] * ab) / determinant;
+	}
+	*colour0 = Quantise565( end0[0], end0[1], end0[2] );
+	*colour1 = Quantise565( end1[0], end1[1], end1[2] );
+	return true;
+}
+
+// Encode the colour of 16 RGBA texels as an 8-byte BC1 block (always four colour, i.e. opaque)
+static void EncodeColourBlock( const uint8_t* texels, uint8_t* output )
+{
+	uint16_t colour0, colour1;
+	uint32_t indices;
+
+	bool singleColour = true;
+	for (int texel = 1; texel < 16 && singleColour; ++texel)
+	{
+		singleColour = texels[texel * 4] == texels[0] && texels[texel * 4 + 1] == texels[1] && texels[texel * 4 + 2] == texels[2];
+	}
+	if (singleColour)
+	{
+		// Use the 2/3 + 1/3 palette entry with endpoints from the tables
+		const SingleColourTables& tables = GetSingleColourTables();
+		colour0 = Pack565( tables.match5[texels[0]][0], tables.match6[texels[1]][0], tables.match5[texels[2]][0] );
+		colour1 = Pack565( tables.match5[texels[0]][1], tables.match6[texels[1]][1], tables.match5[texels[2]][1] );
+		indices = 0xAAAAAAAA;
+	}
+	else
+	{
+		ColourBlock block;
+		for (int group = 0; group < 4; ++group)
+		{
+			const uint8_t* t = texels + group * 16;
+			block.red[group]   = Set4( t[0], t[4], t[8],  t[12] );
+			block.green[group] = Set4( t[1], t[5], t[9],  t[13] );
+			block.blue[group]  = Set4( t[2], t[6], t[10], t[14] );
+		}
+
+		// Principal axis of the colours by power iteration on their covariance, starting from the
+		// direction of the colour range
+		float mean[3] = { 0.0f, 0.0f, 0.0f };
+		float minimum[3] = { 255.0f, 255.0f, 255.0f }, maximum[3] = { 0.0f, 0.0f, 0.0f };
+		for (int texel = 0; texel < 16; ++texel)
+		{
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				float value = texels[texel * 4 + channel];
+				mean[channel] += value;
+				if (value < minimum[channel])  minimum[channel] = value;
+				if (value > maximum[channel])  maximum[channel] = value;
+			}
+		}
+		for (int channel = 0; channel < 3; ++channel)  mean[channel] /= 16.0f;
+
+		float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }; // rr, rg, rb, gg, gb, bb
+		for (int texel = 0; texel < 16; ++texel)
+		{
+			float r = texels[texel * 4] - mean[0], g = texels[texel * 4 + 1] - mean[1], b = texels[texel * 4 + 2] - mean[2];
+			covariance[0] += r * r;  covariance[1] += r * g;  covariance[2] += r * b;
+			covariance[3] += g * g;  covariance[4] += g * b;  covariance[5] += b * b;
+		}
+		float axis[3] = { maximum[0] - minimum[0], maximum[1] - minimum[1], maximum[2] - minimum[2] };
+		for (int iteration = 0; iteration < 4; ++iteration)
+		{
+			float x = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+			float y = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+			float z = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+			float largest = fmaxf( fabsf( x ), fmaxf( fabsf( y ), fabsf( z ) ) );
+			if (largest < 1e-6f)  break; // Keep the range direction
+			axis[0] = x / largest;  axis[1] = y / largest;  axis[2] = z / largest;
+		}
+
+		// Endpoints start at the texels furthest along the axis in each direction
+		int minTexel = 0, maxTexel = 0;
+		float minDot = 1e30f, maxDot = -1e30f;
+		for (int texel = 0; texel < 16; ++texel)
+		{
+			float dot = texels[texel * 4] * axis[0] + texels[texel * 4 + 1] * axis[1] + texels[texel * 4 + 2] * axis[2];
+			if (dot < minDot)  { minDot = dot;  minTexel = texel; }
+			if (dot > maxDot)  { maxDot = dot;  maxTexel = texel; }
+		}
+		const uint8_t* maxColour = texels + maxTexel * 4;
+		const uint8_t* minColour = texels + minTexel * 4;
+		colour0 = Quantise565( maxColour[0], maxColour[1], maxColour[2] );
+		colour1 = Quantise565( minColour[0], minColour[1], minColour[2] );
+		float bestError = MatchColours( block, colour0, colour1, &indices );
+
+		// Refine the endpoints to fit the chosen indices, keeping the result if it is better
+		for (int iteration = 0; iteration < 2; ++iteration)
+		{
+			uint16_t fit0, fit1;
+			uint32_t fitIndices;
+			if (!FitColourEndpoints( texels, indices, &fit0, &fit1 ))  break;
+			if (fit0 == colour0 && fit1 == colour1)  break;
+			float error = MatchColours( block, fit0, fit1, &fitIndices );
+			if (error >= bestError)  break;
+			bestError = error;
+			colour0 = fit0;
+			colour1 = fit1;
+			indices = fitIndices;
+		}
+	}
+
+	// Four colour mode needs the first endpoint to be greater, swapping endpoints swaps indices 0/1
+	// and 2/3. Equal endpoints give a single colour, index 0
+	if (colour0 < colour1)
+	{
+		uint16_t swap = colour0;  colour0 = colour1;  colour1 = swap;
+		indices ^= 0x55555555;
+	}
+	else if (colour0 == colour1)
+	{
+		indices = 0;
+	}
+
+	output[0] = static_cast<uint8_t>(colour0);
+	output[1] = static_cast<uint8_t>(colour0 >> 8);
+	output[2] = static_cast<uint8_t>(colour1);
+	output[3] = static_cast<uint8_t>(colour1 >> 8);
+	output[4] = static_cast<uint8_t>(indices);
+	output[5] = static_cast<uint8_t>(indices >> 8);
+	output[6] = static_cast<uint8_t>(indices >> 16);
+	output[7] = static_cast<uint8_t>(indices >> 24);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Single channel block encoding (BC4, the alpha half of BC3 and each half of BC5)
+//--------------------------------------------------------------------------------------
+
+// Find the nearest palette value to each of 16 values for the given endpoints. Returns the squared
+// error, and the 3-bit indices as one byte per texel. MathSIMD.h only has float operations, and
+// bytes are 16 to a register, so this uses SSE2 directly with a scalar version for other platforms
+static int MatchValues( const uint8_t* texels, int value0, int value1, uint8_t* indices )
+{
+	int palette[8];
+	BC4Palette( value0, value1, palette );
+
+#if defined(GEN_SIMD_SSE)
+	__m128i values = _mm_loadu_si128( reinterpret_cast<const __m128i*>(texels) );
+	__m128i bestError = _mm_set1_epi8( -1 );
+	__m128i bestIndex = _mm_setzero_si128();
+	for (int i = 0; i < 8; ++i)
+	{
+		// Unsigned absolute difference, then strictly smaller test using unsigned minimum
+		__m128i entry = _mm_set1_epi8( static_cast<char>(palette[i]) );
+		__m128i error = _mm_or_si128( _mm_subs_epu8( values, entry ), _mm_subs_epu8( entry, values ) );
+		__m128i smallest = _mm_min_epu8( error, bestError );
+		__m128i closer = _mm_andnot_si128( _mm_cmpeq_epi8( error, bestError ), _mm_cmpeq_epi8( smallest, error ) );
+		bestIndex = _mm_or_si128( _mm_andnot_si128( closer, bestIndex ), _mm_and_si128( closer, _mm_set1_epi8( static_cast<char>(i) ) ) );
+		bestError = smallest;
+	}
+	_mm_storeu_si128( reinterpret_cast<__m128i*>(indices), bestIndex );
+
+	// Sum of squares, widening to 16 then 32 bits
+	__m128i zero = _mm_setzero_si128();
+	__m128i low  = _mm_unpacklo_epi8( bestError, zero );
+	__m128i high = _mm_unpackhi_epi8( bestError, zero );
+	__m128i sums = _mm_add_epi32( _mm_madd_epi16( low, low ), _mm_madd_epi16( high, high ) );
+	sums = _mm_add_epi32( sums, _mm_srli_si128( sums, 8 ) );
+	sums = _mm_add_epi32( sums, _mm_srli_si128( sums, 4 ) );
+	return _mm_cvtsi128_si32( sums );
+#else
+	// First of equally near entries, as above
+	int totalError = 0;
+	for (int texel = 0; texel < 16; ++texel)
+	{
+		int bestError = 256, bestIndex = 0;
+		for (int i = 0; i < 8; ++i)
+		{
+			int error = abs( texels[texel] - palette[i] );
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = i;
+			}
+		}
+		indices[texel] = static_cast<uint8_t>(bestIndex);
+		totalError += bestError * bestError;
+	}
+	return totalError;
+#endif
+}
+
+// Encode 16 single channel values as an 8-byte BC4 block
+static void EncodeValueBlock( const uint8_t* values, uint8_t* output )
+{
+	int minimum = 255, maximum = 0;
+	for (int texel = 0; texel < 16; ++texel)
+	{
+		if (values[texel] < minimum)  minimum = values[texel];
+		if (values[texel] > maximum)  maximum = values[texel];
+	}
+
+	int value0 = maximum, value1 = minimum;
+	uint8_t indices[16];
+	if (maximum == minimum)
+	{
+		memset( indices, 0, sizeof(indices) );
+	}
+	else
+	{
+		// Eight value mode over the full range, then refine the endpoints with a least squares fit
+		int bestError = MatchValues( values, value0, value1, indices );
+		for (int iteration = 0; iteration < 2 && bestError > 0; ++iteration)
+		{
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax = 0.0f, bx = 0.0f;
+			for (int texel = 0; texel < 16; ++texel)
+			{
+				int index = indices[texel];
+				float a = index == 0 ? 1.0f : (index == 1 ? 0.0f : (8 - index) / 7.0f);
+				float b = 1.0f - a;
+				aa += a * a;  ab += a * b;  bb += b * b;
+				ax += a * values[texel];
+				bx += b * values[texel];
+			}
+			float determinant = aa * bb - ab * ab;
+			if (fabsf( determinant ) < 1e-6f)  break;
+			int fit0 = static_cast<int>((ax * bb - bx * ab) / determinant + 0.5f);
+			int fit1 = static_cast<int>((bx * aa - ax * ab) / determinant + 0.5f);
+			fit0 = fit0 < 0 ? 0 : (fit0 > 255 ? 255 : fit0);
+			fit1 = fit1 < 0 ? 0 : (fit1 > 255 ? 255 : fit1);
+			if (fit0 <= fit1 || (fit0 == value0 && fit1 == value1))  break; // Must stay in eight value mode
+
+			uint8_t fitIndices[16];
+			int error = MatchValues( values, fit0, fit1, fitIndices );
+			if (error >= bestError)  break;
+			bestError = error;
+			value0 = fit0;
+			value1 = fit1;
+			memcpy( indices, fitIndices, sizeof(indices) );
+		}
+	}
+
+	output[0] = static_cast<uint8_t>(value0);
+	output[1] = static_cast<uint8_t>(value1);
+	uint64_t packed = 0;
+	for (int texel = 0; texel < 16; ++texel)  packed |= static_cast<uint64_t>(indices[texel]) << (texel * 3);
+	for (int byte = 0; byte < 6; ++byte)  output[2 + byte] = static_cast<uint8_t>(packed >> (byte * 8));
+}
+
+
+//--------------------------------------------------------------------------------------
+// Image compression
+//--------------------------------------------------------------------------------------
+
+// Copy a 4x4 block of RGBA texels from a mip level, repeating the edge texels for blocks that
+// overhang the edge of small or odd sized levels
+static void GatherBlock( const uint8_t* data, const ImageMip& mip, unsigned int blockX, unsigned int blockY, uint8_t* texels )
+{
+	for (unsigned int y = 0; y < 4; ++y)
+	{
+		unsigned int sourceY = blockY * 4 + y;
+		if (sourceY >= mip.height)  sourceY = mip.height - 1;
+		for (unsigned int x = 0; x < 4; ++x)
+		{
+			unsigned int sourceX = blockX * 4 + x;
+			if (sourceX >= mip.width)  sourceX = mip.width - 1;
+			memcpy( texels + (y * 4 + x) * 4, data + static_cast<size_t>(sourceY) * mip.rowPitch + sourceX * 4, 4 );
+		}
+	}
+}
+
+// Compress every mip level of an RGBA8 image to the given block compressed format
+bool CompressImage( const Image& source, ImageFormat format, Image* compressed, int channel, unsigned int numThreads )
+{
+	if (source.format != ImageFormatRGBA8 || source.mips.empty() || channel < 0 || channel > 3 ||
+	    (format != ImageFormatBC1 && format != ImageFormatBC3 && format != ImageFormatBC4 && format != ImageFormatBC5) ||
+	    (format == ImageFormatBC5 && channel > 2))
+	{
+		return false;
+	}
+	compressed->Allocate( format, source.width, source.height, static_cast<unsigned int>(source.mips.size()) );
+
+	// Work is shared out a row of blocks at a time, over all mip levels
+	vector<pair<unsigned int, unsigned int>> rows; // Mip level and block row
+	for (unsigned int mip = 0; mip < source.mips.size(); ++mip)
+	{
+		unsigned int numRows = ImageRowCount( format, source.mips[mip].height );
+		for (unsigned int row = 0; row < numRows; ++row)  rows.push_back( make_pair( mip, row ) );
+	}
+
+	atomic<size_t> nextRow( 0 );
+	auto worker = [&]()
+	{
+		uint8_t texels[64];
+		uint8_t values[16];
+		for (size_t job = nextRow++; job < rows.size(); job = nextRow++)
+		{
+			unsigned int mip = rows[job].first, blockY = rows[job].second;
+			const ImageMip& mipInfo = source.mips[mip];
+			uint8_t* output = compressed->MipData( mip ) + static_cast<size_t>(blockY) * compressed->mips[mip].rowPitch;
+			unsigned int numBlocks = (mipInfo.width + 3) / 4;
+			for (unsigned int blockX = 0; blockX < numBlocks; ++blockX)
+			{
+				GatherBlock( source.MipData( mip ), mipInfo, blockX, blockY, texels );
+				switch (format)
+				{
+					case ImageFormatBC1:
+						EncodeColourBlock( texels, output );
+						output += 8;
+						break;
+					case ImageFormatBC3:
+						for (int texel = 0; texel < 16; ++texel)  values[texel] = texels[texel * 4 + 3];
+						EncodeValueBlock( values, output );
+						EncodeColourBlock( texels, output + 8 );
+						output += 16;
+						break;
+					case ImageFormatBC4:
+						for (int texel = 0; texel < 16; ++texel)  values[texel] = texels[texel * 4 + channel];
+						EncodeValueBlock( values, output );
+						output += 8;
+						break;
+					default: // BC5
+						for (int texel = 0; texel < 16; ++texel)  values[texel] = texels[texel * 4 + channel];
+						EncodeValueBlock( values, output );
+						for (int texel = 0; texel < 16; ++texel)  values[texel] = texels[texel * 4 + channel + 1];
+						EncodeValueBlock( values, output + 8 );
+						output += 16;
+						break;
+				}
+			}
+		}
+	};
+
+	GetSingleColourTables(); // Build before the threads start so they don't all wait for it
+	if (numThreads == 0)  numThreads = thread::hardware_concurrency();
+	if (numThreads > rows.size())  numThreads = static_cast<unsigned int>(rows.size());
+	vector<thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i)
+	{
+		threads.push_back( thread( worker ) );
+	}
+	worker();
+	for (unsigned int i = 0; i < threads.size(); ++i)
+	{
+		threads[i].join();
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Decompression and quality
+//--------------------------------------------------------------------------------------
+
+// Decode a BC4 block to 16 values
+static void DecodeValueBlock( const uint8_t* block, uint8_t* values )
+{
+	int palette[8];
+	BC4Palette( block[0], block[1], palette );
+	uint64_t packed = 0;
+	for (int byte = 0; byte < 6; ++byte)  packed |= static_cast<uint64_t>(block[2 + byte]) << (byte * 8);
+	for (int texel = 0; texel < 16; ++texel)  values[texel] = static_cast<uint8_t>(palette[(packed >> (texel * 3)) & 7]);
+}
+
+// Decode a BC1 block to 16 RGBA texels
+static void DecodeColourBlock( const uint8_t* block, uint8_t* texels )
+{
+	int palette[4][4];
+	BC1Palette( static_cast<uint16_t>(block[0] | (block[1] << 8)), static_cast<uint16_t>(block[2] | (block[3] << 8)), palette );
+	uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+	for (int texel = 0; texel < 16; ++texel)
+	{
+		const int* colour = palette[(indices >> (texel * 2)) & 3];
+		for (int channel = 0; channel < 4; ++channel)  texels[texel * 4 + channel] = static_cast<uint8_t>(colour[channel]);
+	}
+}
+
+// Decompress every mip level of a block compressed image to RGBA8
+bool DecompressImage( const Image& compressed, Image* image )
+{
+	if (compressed.format == ImageFormatRGBA8)
+	{
+		*image = compressed;
+		return true;
+	}
+	if (!IsBlockCompressed( compressed.format ) || compressed.mips.empty())
+	{
+		return false;
+	}
+
+	image->Allocate( ImageFormatRGBA8, compressed.width, compressed.height, static_cast<unsigned int>(compressed.mips.size()) );
+	uint8_t texels[64];
+	uint8_t values[16];
+	for (unsigned int mip = 0; mip < compressed.mips.size(); ++mip)
+	{
+		const ImageMip& mipInfo = image->mips[mip];
+		unsigned int blocksX = (mipInfo.width + 3) / 4, blocksY = (mipInfo.height + 3) / 4;
+		for (unsigned int blockY = 0; blockY < blocksY; ++blockY)
+		{
+			const uint8_t* block = compressed.MipData( mip ) + static_cast<size_t>(blockY) * compressed.mips[mip].rowPitch;
+			for (unsigned int blockX = 0; blockX < blocksX; ++blockX)
+			{
+				switch (compressed.format)
+				{
+					case ImageFormatBC1:
+						DecodeColourBlock( block, texels );
+						block += 8;
+						break;
+					case ImageFormatBC2:
+						DecodeColourBlock( block + 8, texels );
+						for (int texel = 0; texel < 16; ++texel)
+						{
+							texels[texel * 4 + 3] = static_cast<uint8_t>(((block[texel / 2] >> ((texel & 1) * 4)) & 15) * 17);
+						}
+						block += 16;
+						break;
+					case ImageFormatBC3:
+						DecodeColourBlock( block + 8, texels );
+						DecodeValueBlock( block, values );
+						for (int texel = 0; texel < 16; ++texel)  texels[texel * 4 + 3] = values[texel];
+						block += 16;
+						break;
+					case ImageFormatBC4:
+						DecodeValueBlock( block, values );
+						for (int texel = 0; texel < 16; ++texel)
+						{
+							texels[texel * 4] = values[texel];
+							texels[texel * 4 + 1] = texels[texel * 4 + 2] = 0;
+							texels[texel * 4 + 3] = 255;
+						}
+						block += 8;
+						break;
+					default: // BC5
+						DecodeValueBlock( block, values );
+						for (int texel = 0; texel < 16; ++texel)  texels[texel * 4] = values[texel];
+						DecodeValueBlock( block + 8, values );
+						for (int texel = 0; texel < 16; ++texel)
+						{
+							texels[texel * 4 + 1] = values[texel];
+							texels[texel * 4 + 2] = 0;
+							texels[texel * 4 + 3] = 255;
+						}
+						block += 16;
+						break;
+				}
+
+				// Copy the texels that lie inside the mip level
+				for (unsigned int y = 0; y < 4 && blockY * 4 + y < mipInfo.height; ++y)
+				{
+					unsigned int width = mipInfo.width - blockX * 4 < 4 ? mipInfo.width - blockX * 4 : 4;
+					memcpy( image->MipData( mip ) + static_cast<size_t>(blockY * 4 + y) * mipInfo.rowPitch + blockX * 16, texels + y * 16, width * 4 );
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Peak signal to noise ratio in dB between channels of the top level of two RGBA8 images
+double ImagePSNR( const Image& reference, int referenceChannel, const Image& test, int testChannel, int numChannels )
+{
+	if (reference.format != ImageFormatRGBA8 || test.format != ImageFormatRGBA8 || reference.mips.empty() || test.mips.empty() ||
+	    reference.width != test.width || reference.height != test.height)
+	{
+		return 0.0;
+	}
+
+	const uint8_t* referenceData = reference.MipData( 0 );
+	const uint8_t* testData = test.MipData( 0 );
+	size_t numTexels = static_cast<size_t>(reference.width) * reference.height;
+	double squaredError = 0.0;
+	for (size_t texel = 0; texel < numTexels; ++texel)
+	{
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			double difference = static_cast<double>(referenceData[texel * 4 + referenceChannel + channel]) - testData[texel * 4 + testChannel + channel];
+			squaredError += difference * difference;
+		}
+	}
+	double meanError = squaredError / (numTexels * numChannels);
+	if (meanError == 0.0)  return 100.0;
+	double psnr = 10.0 * log10( 255.0 * 255.0 / meanError );
+	return psnr < 100.0 ? psnr : 100.0;
+}
+
+// Does every texel in an RGBA8 image have an alpha of 255
+bool IsImageOpaque( const Image& image )
+{
+	if (image.format != ImageFormatRGBA8)
+	{
+		return false;
+	}
+	for (size_t i = 3; i < image.data.size(); i += 4)
+	{
+		if (image.data[i] != 255)  return false;
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Texture map compression
+//--------------------------------------------------------------------------------------
+
+// Compress a diffuse map with specular in alpha to BC3, or to BC1 if there is no specular
+bool CompressDiffuseSpecular( const Image& source, Image* compressed, unsigned int numThreads )
+{
+	// Already compressed maps are used as they are, recompressing would only lose quality
+	if (IsBlockCompressed( source.format ))
+	{
+		*compressed = source;
+		return true;
+	}
+	if (source.format != ImageFormatRGBA8 || source.mips.empty())
+	{
+		return false;
+	}
+
+	Image mipped = source;
+	if (mipped.mips.size() == 1)  GenerateMips( &mipped, MipFilterKaiser, MipContentColour, numThreads );
+
+	// Direct3D only accepts block compressed textures that are a whole number of blocks in size
+	if ((source.width & 3) != 0 || (source.height & 3) != 0)
+	{
+		*compressed = mipped;
+		return true;
+	}
+	return CompressImage( mipped, IsImageOpaque( mipped ) ? ImageFormatBC1 : ImageFormatBC3, compressed, 0, numThreads );
+}
+
+// Split a normal map with depth in alpha into a BC5 normal map and a BC4 depth map
+bool CompressNormalDepth( const Image& source, Image* normals, Image* depths, unsigned int numThreads )
+{
+	// Compressed maps must be decompressed to be split
+	Image mipped;
+	if (!DecompressImage( source, &mipped ))
+	{
+		return false;
+	}
+	if (mipped.mips.size() == 1)  GenerateMips( &mipped, MipFilterKaiser, MipContentNormalDepth, numThreads );
+
+	// BC5 only holds x and y, so make each normal unit length first for z to be rebuilt correctly.
+	// Mip generation renormalises, but the top level (or mips that came with the file) may not be
+	for (size_t texel = 0; texel < mipped.data.size(); texel += 4)
+	{
+		uint8_t* normal = &mipped.data[texel];
+		float x = normal[0] / 127.5f - 1.0f, y = normal[1] / 127.5f - 1.0f, z = normal[2] / 127.5f - 1.0f;
+		float length = sqrtf( x * x + y * y + z * z );
+		if (length < 1e-3f)
+		{
+			x = y = 0.0f; // Degenerate normal, point straight out of the surface
+			length = 1.0f;
+		}
+		normal[0] = static_cast<uint8_t>((x / length + 1.0f) * 127.5f + 0.5f);
+		normal[1] = static_cast<uint8_t>((y / length + 1.0f) * 127.5f + 0.5f);
+	}
+
+	return CompressImage( mipped, ImageFormatBC5, normals, 0, numThreads ) &&
+	       CompressImage( mipped, ImageFormatBC4, depths, 3, numThreads );
+}
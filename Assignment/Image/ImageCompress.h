@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------------
+//	Block compression of images to BC1, BC3, BC4 and BC5 for a smaller GPU footprint,
+//	decompression back to RGBA8, and quality measurement of the result
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_IMAGE_COMPRESS_H_INCLUDED
+#define CO2409_IMAGE_COMPRESS_H_INCLUDED
+
+#include "Image.h"
+
+//--------------------------------------------------------------------------------------
+// Block compression
+//--------------------------------------------------------------------------------------
+
+// Compress every mip level of an RGBA8 image to the given block compressed format. BC1 and BC3
+// use the colour channels (and alpha for BC3). BC4 compresses the single channel given, BC5 the
+// given channel and the one after it (e.g. channel 0 for red and green). Rows of blocks are shared
+// between the given number of threads (0 to use all hardware threads). Returns false if the source
+// is not RGBA8 or the format is not one of the above
+bool CompressImage( const Image& source, ImageFormat format, Image* compressed, int channel = 0,
+                    unsigned int numThreads = 0 );
+
+// Decompress every mip level of a block compressed image to RGBA8, as the GPU would sample it.
+// BC4 gives the value in red and BC5 in red and green, other channels are 0 (alpha 255). RGBA8
+// images are copied. Returns false for unknown formats
+bool DecompressImage( const Image& compressed, Image* image );
+
+// Peak signal to noise ratio in dB between channels of the top level of two RGBA8 images of the
+// same size, e.g. an original image and its compressed then decompressed copy. Compares numChannels
+// channels starting at referenceChannel in the first image and testChannel in the second. Identical
+// channels give 100 dB (rather than infinity)
+double ImagePSNR( const Image& reference, int referenceChannel, const Image& test, int testChannel, int numChannels );
+
+// Does every texel in an RGBA8 image have an alpha of 255
+bool IsImageOpaque( const Image& image );
+
+
+//--------------------------------------------------------------------------------------
+// Texture map compression
+//--------------------------------------------------------------------------------------
+// Diffuse/specular and normal/depth maps are loaded as RGBA8 (or DDS in any format) and are
+// compressed with a full mip chain for rendering
+
+// Compress a diffuse map with specular in alpha to BC3, or to BC1 if there is no specular (alpha
+// is all 255). Mips are generated if the source only has one level (see ImageMips.h). Maps that
+// are not a multiple of 4 texels in size are left uncompressed, as Direct3D requires whole blocks
+bool CompressDiffuseSpecular( const Image& source, Image* compressed, unsigned int numThreads = 0 );
+
+// Split a normal map with depth in alpha into a BC5 normal map, holding the x and y of the unit
+// normal (z is rebuilt in the shader), and a BC4 depth map. Mips are generated if the source only
+// has one level
+bool CompressNormalDepth( const Image& source, Image* normals, Image* depths, unsigned int numThreads = 0 );
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,28 @@
+//--------------------------------------------------------------------------------------
+//	Decoders for each image file type, used by DecodeImage (see Image.h). Each one decodes
+//	a complete file held in memory and reports problems through the error string
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_IMAGE_DECODERS_H_INCLUDED
+#define CO2409_IMAGE_DECODERS_H_INCLUDED
+
+#include "Image.h"
+
+// DDS files - uncompressed and block compressed, with any mip levels in the file
+bool DecodeDDS( const uint8_t* fileData, size_t fileSize, Image* image, string* error );
+
+// PNG files - all colour types and bit depths, interlaced or not
+bool DecodePNG( const uint8_t* fileData, size_t fileSize, Image* image, string* error );
+
+// JPG files - baseline and progressive with Huffman coding, greyscale or colour
+bool DecodeJPEG( const uint8_t* fileData, size_t fileSize, Image* image, string* error );
+
+// TGA files - true colour, greyscale and colour mapped, uncompressed or run-length encoded
+bool DecodeTGA( const uint8_t* fileData, size_t fileSize, Image* image, string* error );
+
+// Set an error description (if an error string was given) and return false, for use in decoders
+bool ImageError( string* error, const char* message );
+
+
+#endif // End of header guard (see top of file)
@@ -0,0 +1,365 @@
+//--------------------------------------------------------------------------------------
+//	Mip chain generation on the CPU, for images that are compressed after loading and so
+//	cannot have their mips generated by the GPU. Each level is filtered from the one above
+//	with a separable filter, one RGBA texel per SIMD register (see MathSIMD.h)
+//--------------------------------------------------------------------------------------
+
+#include "ImageMips.h"
+#include "MathSIMD.h"
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+
+using namespace gen;
+
+//--------------------------------------------------------------------------------------
+// Filter kernels
+//--------------------------------------------------------------------------------------
+
+// Radius of the filters in destination texels
+static const float kBoxRadius = 0.5f;
+static const float kKaiserRadius = 3.0f;
+static const float kKaiserAlpha = 4.0f;
+
+// Modified Bessel function of the first kind, order 0, for the Kaiser window
+static double BesselI0( double x )
+{
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32 && term > sum * 1e-12; ++k)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// Filter weight at a distance from the centre of a destination texel, measured in destination texels
+static float FilterWeight( MipFilter filter, float distance )
+{
+	distance = fabsf( distance );
+	if (filter == MipFilterBox)
+	{
+		return distance < kBoxRadius ? 1.0f : (distance == kBoxRadius ? 0.5f : 0.0f);
+	}
+
+	if (distance >= kKaiserRadius)  return 0.0f;
+	double sinc = distance < 1e-6f ? 1.0 : sin( 3.14159265358979 * distance ) / (3.14159265358979 * distance);
+	double ratio = distance / kKaiserRadius;
+	return static_cast<float>(sinc * BesselI0( kKaiserAlpha * sqrt( 1.0 - ratio * ratio ) ) / BesselI0( kKaiserAlpha ));
+}
+
+// Source texels and weights contributing to each destination texel along one axis. Every destination
+// texel has the same number of taps (unused taps have zero weight) from consecutive source texels
+// starting at its first one. Indexes are wrapped to the source size
+struct MipKernel
+{
+	int           numTaps;
+	vector<int>   first;   // First source texel for each destination texel (before wrapping)
+	vector<float> weights; // numTaps weights for each destination texel
+
+	void Build( MipFilter filter, unsigned int sourceSize, unsigned int destSize )
+	{
+		first.resize( destSize );
+		if (sourceSize == destSize) // Axis that has already reached 1 texel
+		{
+			numTaps = 1;
+			weights.assign( destSize, 1.0f );
+			for (unsigned int i = 0; i < destSize; ++i)  first[i] = i;
+			return;
+		}
+
+		// Find the range of source texels with non-zero weight for each destination texel
+		float scale = static_cast<float>(sourceSize) / destSize;
+		float radius = (filter == MipFilterBox ? kBoxRadius : kKaiserRadius) * scale;
+		vector<int> last( destSize );
+		numTaps = 0;
+		for (unsigned int i = 0; i < destSize; ++i)
+		{
+			float centre = (i + 0.5f) * scale;
+			int start = static_cast<int>(floorf( centre - radius ));
+			int end = static_cast<int>(ceilf( centre + radius ));
+			while (start < end && FilterWeight( filter, (start + 0.5f - centre) / scale ) == 0.0f)  ++start;
+			while (end > start && FilterWeight( filter, (end + 0.5f - centre) / scale ) == 0.0f)    --end;
+			first[i] = start;
+			last[i] = end;
+			if (end - start + 1 > numTaps)  numTaps = end - start + 1;
+		}
+
+		// Normalised weights, so flat areas stay the same value
+		weights.assign( destSize * numTaps, 0.0f );
+		for (unsigned int i = 0; i < destSize; ++i)
+		{
+			float centre = (i + 0.5f) * scale;
+			float total = 0.0f;
+			for (int tap = 0; tap <= last[i] - first[i]; ++tap)
+			{
+				float weight = FilterWeight( filter, (first[i] + tap + 0.5f - centre) / scale );
+				weights[i * numTaps + tap] = weight;
+				total += weight;
+			}
+			for (int tap = 0; tap < numTaps; ++tap)  weights[i * numTaps + tap] /= total;
+		}
+	}
+};
+
+// Wrap a texel index into the range 0 to size-1
+static inline unsigned int WrapIndex( int index, unsigned int size )
+{
+	int wrapped = index % static_cast<int>(size);
+	return static_cast<unsigned int>(wrapped < 0 ? wrapped + size : wrapped);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Texel conversion
+//--------------------------------------------------------------------------------------
+
+// Tables to convert 8-bit channels to the values that are filtered for each content type, and
+// linear colour back to sRGB
+struct MipTables
+{
+	static const int kSRGBSteps = 4096;
+
+	float   decode[3][4][256]; // [content][channel][value]
+	uint8_t linearToSRGB[kSRGBSteps + 1];
+
+	MipTables()
+	{
+		for (int value = 0; value < 256; ++value)
+		{
+			float unit = value / 255.0f;
+			float linear = unit <= 0.04045f ? unit / 12.92f : powf( (unit + 0.055f) / 1.055f, 2.4f );
+			for (int channel = 0; channel < 4; ++channel)
+			{
+				decode[MipContentLinear][channel][value] = unit;
+				decode[MipContentColour][channel][value] = channel < 3 ? linear : unit;
+				decode[MipContentNormalDepth][channel][value] = channel < 3 ? value / 127.5f - 1.0f : unit;
+			}
+		}
+		for (int step = 0; step <= kSRGBSteps; ++step)
+		{
+			float linear = static_cast<float>(step) / kSRGBSteps;
+			float unit = linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf( linear, 1.0f / 2.4f ) - 0.055f;
+			linearToSRGB[step] = static_cast<uint8_t>(unit * 255.0f + 0.5f);
+		}
+	}
+};
+
+// Thread-safe construction on first use
+static const MipTables& GetMipTables()
+{
+	static const MipTables tables;
+	return tables;
+}
+
+// Convert a filtered texel back to 8-bit channels
+static inline void EncodeTexel( TFloat32x4 texel, MipContent content, const MipTables& tables, uint8_t* output )
+{
+	float values[4];
+	if (content == MipContentNormalDepth)
+	{
+		// Renormalise the xyz normal, keep w (depth) as it is
+		Store4Unaligned( values, texel );
+		float length = sqrtf( values[0] * values[0] + values[1] * values[1] + values[2] * values[2] );
+		if (length > 1e-6f)
+		{
+			texel = Mul4( texel, Set4( 1.0f / length, 1.0f / length, 1.0f / length, 1.0f ) );
+		}
+		else
+		{
+			texel = Set4( 0.0f, 0.0f, 1.0f, values[3] );
+		}
+
+		// -1->1 to 0->255 for xyz, 0->1 to 0->255 for w, offset includes 0.5 for rounding
+		texel = MulAdd4( texel, Set4( 127.5f, 127.5f, 127.5f, 255.0f ), Set4( 128.0f, 128.0f, 128.0f, 0.5f ) );
+		texel = Min4( Max4( texel, Zero4() ), Splat4( 255.0f ) );
+	}
+	else
+	{
+		texel = Min4( Max4( texel, Zero4() ), Splat4( 1.0f ) ); // Sharper filters overshoot
+		if (content == MipContentColour)
+		{
+			Store4Unaligned( values, texel );
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				output[channel] = tables.linearToSRGB[static_cast<int>(values[channel] * MipTables::kSRGBSteps + 0.5f)];
+			}
+			output[3] = static_cast<uint8_t>(values[3] * 255.0f + 0.5f);
+			return;
+		}
+		texel = MulAdd4( texel, Splat4( 255.0f ), Splat4( 0.5f ) );
+	}
+
+	Store4Unaligned( values, texel );
+	for (int channel = 0; channel < 4; ++channel)
+	{
+		output[channel] = static_cast<uint8_t>(values[channel]);
+	}
+}
+
+
+//--------------------------------------------------------------------------------------
+// Mip generation
+//--------------------------------------------------------------------------------------
+
+// Destination rows are filtered in bands, each band filtering the source rows it needs horizontally
+// once then combining them vertically
+static const unsigned int kMipBandRows = 16;
+
+// One band of rows of one mip level of one image
+struct MipJob
+{
+	size_t       image;
+	unsigned int firstRow;
+};
+
+// Number of floats of working space FilterBand needs for the horizontally filtered source rows of
+// the band starting at the given row
+static size_t BandBufferSize( const ImageMip& level, unsigned int firstRow, const MipKernel& kernelY )
+{
+	unsigned int lastRow = firstRow + kMipBandRows < level.height ? firstRow + kMipBandRows : level.height;
+	int numSource = kernelY.first[lastRow - 1] + kernelY.numTaps - kernelY.first[firstRow];
+	return static_cast<size_t>(numSource) * level.width * 4;
+}
+
+// Filter rows firstRow to firstRow + kMipBandRows - 1 of a mip level from the level above. The buffer
+// is working space for the horizontally filtered source rows, see BandBufferSize
+static void FilterBand( Image* image, unsigned int mip, unsigned int firstRow, MipContent content,
+                        const MipKernel& kernelX, const MipKernel& kernelY, float* buffer )
+{
+	const MipTables& tables = GetMipTables();
+	const ImageMip& above = image->mips[mip - 1];
+	const ImageMip& level = image->mips[mip];
+	const uint8_t* sourceData = image->MipData( mip - 1 );
+	uint8_t* destData = image->MipData( mip );
+	unsigned int lastRow = firstRow + kMipBandRows < level.height ? firstRow + kMipBandRows : level.height;
+
+	// Horizontal pass over the source rows used by this band
+	int firstSource = kernelY.first[firstRow];
+	int numSource = kernelY.first[lastRow - 1] + kernelY.numTaps - firstSource;
+	const float (*decode)[256] = tables.decode[content];
+	for (int row = 0; row < numSource; ++row)
+	{
+		const uint8_t* source = sourceData + static_cast<size_t>(WrapIndex( firstSource + row, above.height )) * above.rowPitch;
+		float* output = buffer + static_cast<size_t>(row) * level.width * 4;
+		for (unsigned int x = 0; x < level.width; ++x)
+		{
+			TFloat32x4 total = Zero4();
+			const float* weights = &kernelX.weights[x * kernelX.numTaps];
+			for (int tap = 0; tap < kernelX.numTaps; ++tap)
+			{
+				const uint8_t* texel = source + WrapIndex( kernelX.first[x] + tap, above.width ) * 4;
+				TFloat32x4 value = Set4( decode[0][texel[0]], decode[1][texel[1]], decode[2][texel[2]], decode[3][texel[3]] );
+				total = MulAdd4( value, Splat4( weights[tap] ), total );
+			}
+			Store4Unaligned( output + x * 4, total );
+		}
+	}
+
+	// Vertical pass combining those rows
+	for (unsigned int y = firstRow; y < lastRow; ++y)
+	{
+		const float* weights = &kernelY.weights[y * kernelY.numTaps];
+		const float* rows = buffer + static_cast<size_t>(kernelY.first[y] - firstSource) * level.width * 4;
+		uint8_t* output = destData + static_cast<size_t>(y) * level.rowPitch;
+		for (unsigned int x = 0; x < level.width; ++x)
+		{
+			TFloat32x4 total = Zero4();
+			for (int tap = 0; tap < kernelY.numTaps; ++tap)
+			{
+				TFloat32x4 value = Load4Unaligned( rows + (static_cast<size_t>(tap) * level.width + x) * 4 );
+				total = MulAdd4( value, Splat4( weights[tap] ), total );
+			}
+			EncodeTexel( total, content, tables, output + x * 4 );
+		}
+	}
+}
+
+// Generate mip chains for several RGBA8 images together
+bool GenerateMips( const vector<Image*>& images, const vector<MipContent>& contents, MipFilter filter, unsigned int numThreads )
+{
+	// Lay out the full mip chain of each image, keeping the top level
+	bool allGenerated = true;
+	vector<Image*> targets;
+	vector<MipContent> targetContents;
+	unsigned int maxMips = 0;
+	for (size_t i = 0; i < images.size(); ++i)
+	{
+		Image* image = images[i];
+		if (image->format != ImageFormatRGBA8 || image->mips.empty())
+		{
+			allGenerated = false;
+			continue;
+		}
+
+		unsigned int numMips = 1;
+		for (unsigned int size = image->width > image->height ? image->width : image->height; size > 1; size /= 2)  ++numMips;
+		if (numMips > maxMips)  maxMips = numMips;
+
+		vector<uint8_t> topLevel( image->MipData( 0 ), image->MipData( 0 ) + image->mips[0].size );
+		image->Allocate( ImageFormatRGBA8, image->width, image->height, numMips );
+		memcpy( image->MipData( 0 ), &topLevel[0], topLevel.size() );
+		targets.push_back( image );
+		targetContents.push_back( i < contents.size() ? contents[i] : MipContentLinear );
+	}
+
+	GetMipTables(); // Build before the threads start so they don't all wait for it
+	if (numThreads == 0)  numThreads = thread::hardware_concurrency();
+	if (numThreads == 0)  numThreads = 1;
+
+	// Each level depends on the one above, so levels are made in turn, with the bands of that level
+	// of every image shared between the threads
+	for (unsigned int mip = 1; mip < maxMips; ++mip)
+	{
+		vector<MipKernel> kernelsX( targets.size() ), kernelsY( targets.size() );
+		vector<MipJob> jobs;
+		size_t bufferSize = 0;
+		for (size_t i = 0; i < targets.size(); ++i)
+		{
+			if (mip >= targets[i]->mips.size())  continue;
+			const ImageMip& above = targets[i]->mips[mip - 1];
+			const ImageMip& level = targets[i]->mips[mip];
+			kernelsX[i].Build( filter, above.width, level.width );
+			kernelsY[i].Build( filter, above.height, level.height );
+			for (unsigned int row = 0; row < level.height; row += kMipBandRows)
+			{
+				MipJob job = { i, row };
+				jobs.push_back( job );
+				size_t size = BandBufferSize( level, row, kernelsY[i] );
+				if (size > bufferSize)  bufferSize = size;
+			}
+		}
+
+		// Working space for each thread is allocated here so nothing in the threads can throw
+		unsigned int levelThreads = numThreads < jobs.size() ? numThreads : static_cast<unsigned int>(jobs.size());
+		vector<vector<float>> buffers( levelThreads, vector<float>( bufferSize ) );
+		atomic<size_t> nextJob( 0 );
+		auto worker = [&]( unsigned int threadIndex )
+		{
+			for (size_t job = nextJob++; job < jobs.size(); job = nextJob++)
+			{
+				size_t i = jobs[job].image;
+				FilterBand( targets[i], mip, jobs[job].firstRow, targetContents[i], kernelsX[i], kernelsY[i], &buffers[threadIndex][0] );
+			}
+		};
+
+		vector<thread> threads;
+		for (unsigned int i = 1; i < levelThreads; ++i)
+		{
+			threads.push_back( thread( worker, i ) );
+		}
+		worker( 0 );
+		for (unsigned int i = 0; i < threads.size(); ++i)
+		{
+			threads[i].join();
+		}
+	}
+	return allGenerated;
+}
+
+// Replace the mip levels of an RGBA8 image with a full chain down to 1x1
+bool GenerateMips( Image* image, MipFilter filter, MipContent content, unsigned int numThreads )
+{
+	return GenerateMips( vector<Image*>( 1, image ), vector<MipContent>( 1, content ), filter, numThreads );
+}
@@ -0,0 +1,42 @@
+//--------------------------------------------------------------------------------------
+//	Mip chain generation on the CPU, with a choice of filter and handling suited to what the
+//	image holds: colours are filtered in linear space, normals are renormalised and the depth
+//	in a normal map's alpha is filtered on its own
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_IMAGE_MIPS_H_INCLUDED
+#define CO2409_IMAGE_MIPS_H_INCLUDED
+
+#include "Image.h"
+
+// Filter used to make each mip level from the one above
+enum MipFilter
+{
+	MipFilterBox,    // Average of each 2x2 texels - fast, a little blurry and prone to aliasing
+	MipFilterKaiser, // Kaiser windowed sinc over 8x8 texels - sharper with less aliasing, slower
+};
+
+// What the image holds, which decides how it is filtered
+enum MipContent
+{
+	MipContentLinear,      // Plain data, all four channels filtered as they are
+	MipContentColour,      // sRGB colour (e.g. a diffuse map), filtered in linear space. Alpha is linear
+	MipContentNormalDepth, // Normal in RGB, renormalised after filtering. Depth (height) in alpha
+};
+
+// Replace the mip levels of an RGBA8 image with a full chain down to 1x1, each level filtered from
+// the one above. Texture addressing is assumed to wrap at the edges. Rows of each level are shared
+// between the given number of threads (0 to use all hardware threads). Returns false for block
+// compressed images, which cannot be filtered
+bool GenerateMips( Image* image, MipFilter filter = MipFilterKaiser, MipContent content = MipContentLinear,
+                   unsigned int numThreads = 0 );
+
+// Generate mip chains for several RGBA8 images together, each with its own content type. Each level
+// of every image is made at the same time, so small images share the threads with large ones rather
+// than running one after another. Returns false if any image is not RGBA8 (that image is unchanged)
+bool GenerateMips( const vector<Image*>& images, const vector<MipContent>& contents, MipFilter filter = MipFilterKaiser,
+                   unsigned int numThreads = 0 );
+
+
+#endif // End of header guard (see top of file)
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <chrono>
 using namespace std;
 
 #define INITGUID
@@ -17,6 +18,14 @@ using namespace std;
 namespace gen
 {
 
+// Clock used for import stage timings, and the seconds elapsed on it since a given start point
+typedef chrono::high_resolution_clock TImportClock;
+static TFloat32 SecondsSince( const TImportClock::time_point& start )
+{
+	return chrono::duration<TFloat32>( TImportClock::now() - start ).count();
+}
+
+
 /*-----------------------------------------------------------------------------------------
 	CImportXFile public member functions
 -----------------------------------------------------------------------------------------*/
@@ -74,6 +83,7 @@ EImportError CImportXFile::ImportFile
 	m_Frames.clear();
 	m_Meshes.clear();
 	m_bImported = false;
+	memset( &m_Timings, 0, sizeof(m_Timings) );
 
 	// Ensure the file is an X-file
 	if (!IsXFile( sFileName ))
@@ -98,8 +108,11 @@ EImportError CImportXFile::ImportFile
 		return eError;
 	}
 
-	// Parse X file to create frame hierachy and meshes
+	// Parse X file to create frame hierachy and meshes. Face list matching is timed separately
+	// as it happens during parsing
+	TImportClock::time_point stageStart = TImportClock::now();
 	eError = ParseXFile( pXFileEnumer );
+	m_Timings.fParse = SecondsSince( stageStart ) - m_Timings.fMatchFaceLists;
 
 	// Release X-File interfaces
 	pXFileEnumer->Release();
@@ -114,15 +127,19 @@ EImportError CImportXFile::ImportFile
 	}
 
 	// Split into meshes containing only one material each
+	stageStart = TImportClock::now();
 	SplitMeshes();
+	m_Timings.fSplitMeshes = SecondsSince( stageStart );
 
 	// Calculate adjacency data for each mesh
 	if (bAdjacency)
 	{
+		stageStart = TImportClock::now();
 		for (TUInt32 iMesh = 0; iMesh < m_Meshes.size(); ++iMesh)
 		{
 			CalculateAdjacency( iMesh );
 		}
+		m_Timings.fAdjacency = SecondsSince( stageStart );
 	}
 
 	// Mark file as loaded
@@ -186,9 +203,13 @@ EImportError CImportXFile::GetSubMesh
 	// Calculate tangents if required
 	TXFileVectors tangents;
 	pOutSubMesh->hasTangents = bTangents;
+	m_Timings.fTangents = 0.0f;
+	TImportClock::time_point stageStart = TImportClock::now();
 	if (pOutSubMesh->hasTangents)
 	{
 		CalculateTangents( iSubMesh, &tangents );
+		m_Timings.fTangents = SecondsSince( stageStart );
+		stageStart = TImportClock::now();
 	}
 
 	// Find what vertex data there is and calculate total vertex size
@@ -353,6 +374,7 @@ EImportError CImportXFile::GetSubMesh
 
 	// Get material from material map (all faces in sub-mesh have the same material at this point)
 	pOutSubMesh->material = m_Meshes[iSubMesh].materialMap.front();
+	m_Timings.fInterleave = SecondsSince( stageStart );
 
 	return kSuccess;
 
@@ -875,7 +897,9 @@ EImportError CImportXFile::ParseXFileMesh
 	}
 
 	// Match the face lists of vertices and normals, so there is exactly one normal per vertex
+	TImportClock::time_point matchStart = TImportClock::now();
 	MatchFaceLists( iCurrMesh );
+	m_Timings.fMatchFaceLists += SecondsSince( matchStart );
 
 	return kSuccess;
 
@@ -7,6 +7,7 @@
 #define GEN_C_IMPORT_XFILE_H_INCLUDED
 
 #include <vector>
+#include <string.h>
 using namespace std;
 #include <d3d9.h>
 #include <d3dx9.h>
@@ -29,6 +30,19 @@ enum EImportError
 };
 
 
+// Time spent (in seconds) in each stage of the most recent import. ImportFile fills in the parsing
+// stages, GetSubMesh fills in the tangent and interleave stages for the sub-mesh last requested
+struct SImportTimings
+{
+	TFloat32 fParse;          // Reading X-file templates, excluding face list matching below
+	TFloat32 fMatchFaceLists; // Total over all meshes in the file
+	TFloat32 fSplitMeshes;
+	TFloat32 fAdjacency;      // Zero unless adjacency was requested from ImportFile
+	TFloat32 fTangents;       // Zero unless tangents were requested from GetSubMesh
+	TFloat32 fInterleave;     // Writing vertex/face/adjacency data to the output sub-mesh
+};
+
+
 class CImportXFile
 {
 	GEN_CLASS( CImportXFile )
@@ -41,6 +55,7 @@ public:
 	CImportXFile()
 	{
 		m_bImported = false;
+		memset( &m_Timings, 0, sizeof(m_Timings) );
 	}
 
 private:
@@ -148,6 +163,16 @@ public:
 	// TODO: bones
 
 
+	/////////////////////////////////////
+	// Profiling
+
+	// Get time spent in each stage of the most recent ImportFile / GetSubMesh calls
+	const SImportTimings& GetTimings() const
+	{
+		return m_Timings;
+	}
+
+
 /*-----------------------------------------------------------------------------------------
 	Extra public interface for CImportXFile
 -----------------------------------------------------------------------------------------*/
@@ -249,10 +274,10 @@ private:
 		string            sFrameName;   // Name of the frame that drives this bone
 		TUInt32           iFrame;       // Index of the frame that drives this bone
 		TXFileBoneWeights weights;
-		CMatrix4x4        offsetMatrix; // TODO: Would like aligned matrices - but vector can't do it
+		CMatrix4x4        offsetMatrix;
 
 	};
-	typedef vector<SXFileBone>       TXFileBones;
+	typedef vector<SXFileBone, CAlignedAllocator<SXFileBone> > TXFileBones; // Contains aligned matrices
 
 
 	// Frame in an X-file hierarchy
@@ -262,10 +287,10 @@ private:
 		TUInt32    iDepth;
 		TUInt32    iParentIndex;
 		TUInt32    iNumChildren;
-		CMatrix4x4 defaultMatrix; // TODO: Would like aligned matrices - but vector can't do it
+		CMatrix4x4 defaultMatrix;
 		CMatrix4x4 offsetMatrix;
 	};
-	typedef vector<SXFileFrame> TXFileFrames;
+	typedef vector<SXFileFrame, CAlignedAllocator<SXFileFrame> > TXFileFrames; // Contains aligned matrices
 
 
 	// A single mesh in an X-File
@@ -603,6 +628,9 @@ private:
 
 	// Global list of materials used by all the meshes
 	TXFileMaterials m_Materials;
+
+	// Stage timings for the most recent import (GetSubMesh is const but records its own timings)
+	mutable SImportTimings m_Timings;
 };
 
 
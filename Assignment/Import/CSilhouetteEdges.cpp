@@ -0,0 +1,246 @@
+//--------------------------------------------------------------------------------------
+// Silhouette edge extraction from imported meshes with adjacency data
+//--------------------------------------------------------------------------------------
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+#include "CSilhouetteEdges.h"
+#include "MathSIMD.h"
+
+namespace gen
+{
+
+/////////////////////////////////////
+// Preparation
+
+// Write a plane into the given slot of a block of faces - see CSilhouetteMesh for layout
+static void SetBlockPlane
+(
+	TFloat32*       pBlock,
+	const TUInt32   iPlane,
+	const TUInt32   iLane,
+	const CVector3& normal,
+	const TFloat32  fD
+)
+{
+	TFloat32* pPlane = pBlock + iPlane * 16;
+	pPlane[iLane]      = normal.x;
+	pPlane[iLane + 4]  = normal.y;
+	pPlane[iLane + 8]  = normal.z;
+	pPlane[iLane + 12] = fD;
+}
+
+// Prepare the given sub-mesh for silhouette extraction. The sub-mesh must have been imported
+// with adjacency data. Returns false if the sub-mesh has no adjacency data
+bool CSilhouetteMesh::Prepare( const SSubMesh& subMesh )
+{
+	GEN_GUARD;
+
+	if (!subMesh.faceAdjacency)
+	{
+		return false;
+	}
+
+	m_NumFaces = subMesh.numFaces;
+	m_Faces.assign( subMesh.faces, subMesh.faces + m_NumFaces );
+
+	// Unused faces in the last block are given the plane (0,0,0,-1), which never faces any light.
+	// The same plane is used for the neighbour across an open edge, so open edges of faces facing
+	// the light are always found as silhouette edges
+	TUInt32 numBlocks = (m_NumFaces + kiBlockFaces - 1) / kiBlockFaces;
+	m_Planes.assign( numBlocks * kiBlockFloats, 0.0f );
+	for (TUInt32 iBlock = 0; iBlock < numBlocks; ++iBlock)
+	{
+		for (TUInt32 iPlane = 0; iPlane < 4; ++iPlane)
+		{
+			for (TUInt32 iLane = 0; iLane < kiBlockFaces; ++iLane)
+			{
+				SetBlockPlane( &m_Planes[iBlock * kiBlockFloats], iPlane, iLane, CVector3::kZero, -1.0f );
+			}
+		}
+	}
+
+	// Position is always the first element of the raw vertex data
+	const TUInt8* pVertices = subMesh.vertices;
+	const TUInt32 vertexSize = subMesh.vertexSize;
+	#define SILHOUETTE_POSITION( iVertex ) (*reinterpret_cast<const CVector3*>(pVertices + (iVertex) * vertexSize))
+
+	for (TUInt32 iFace = 0; iFace < m_NumFaces; ++iFace)
+	{
+		TFloat32* pBlock = &m_Planes[(iFace / kiBlockFaces) * kiBlockFloats];
+		TUInt32 iLane = iFace % kiBlockFaces;
+
+		// Face plane. The normal is not normalised - only the sign of the light distance is used
+		const SMeshFace& face = m_Faces[iFace];
+		const CVector3& p0 = SILHOUETTE_POSITION( face.aiVertex[0] );
+		const CVector3& p1 = SILHOUETTE_POSITION( face.aiVertex[1] );
+		const CVector3& p2 = SILHOUETTE_POSITION( face.aiVertex[2] );
+		CVector3 normal = Cross( p1 - p0, p2 - p0 );
+		SetBlockPlane( pBlock, 0, iLane, normal, -Dot( normal, p0 ) );
+
+		// Planes of neighbouring faces. Adjacency gives the vertex of the neighbouring face opposite
+		// each edge, or the first vertex of the edge itself if the edge is open. The neighbour shares
+		// the edge in reverse order, which gives its winding
+		const SMeshFace& adjacency = subMesh.faceAdjacency[iFace];
+		for (TUInt32 iEdge = 0; iEdge < 3; ++iEdge)
+		{
+			TUInt16 iVert0 = face.aiVertex[iEdge];
+			TUInt16 iVert1 = face.aiVertex[(iEdge + 1) % 3];
+			TUInt16 iOpposite = adjacency.aiVertex[iEdge];
+			if (iOpposite != iVert0)
+			{
+				const CVector3& q0 = SILHOUETTE_POSITION( iVert1 );
+				const CVector3& q1 = SILHOUETTE_POSITION( iVert0 );
+				const CVector3& q2 = SILHOUETTE_POSITION( iOpposite );
+				CVector3 adjNormal = Cross( q1 - q0, q2 - q0 );
+				SetBlockPlane( pBlock, 1 + iEdge, iLane, adjNormal, -Dot( adjNormal, q0 ) );
+			}
+		}
+	}
+	#undef SILHOUETTE_POSITION
+
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+/////////////////////////////////////
+// Silhouette extraction
+
+// Find the silhouette edges of the mesh as seen from a light, given in the mesh's model space as
+// a position (w = 1) or a direction towards the light (w = 0). Output list is replaced
+void CSilhouetteMesh::FindEdges
+(
+	const CVector4&   light,
+	TSilhouetteEdges* pOutEdges
+) const
+{
+	GEN_GUARD;
+
+	pOutEdges->clear();
+
+	// A face faces the light if n.l + d*w > 0, for light l and plane (n,d). Test four faces at once.
+	// The products are not fused (MulAdd4) so results are the same on every platform
+	const TFloat32x4 lightX = Splat4( light.x );
+	const TFloat32x4 lightY = Splat4( light.y );
+	const TFloat32x4 lightZ = Splat4( light.z );
+	const TFloat32x4 lightW = Splat4( light.w );
+	const TFloat32x4 zero = Zero4();
+
+	TUInt32 numBlocks = static_cast<TUInt32>(m_Planes.size()) / kiBlockFloats;
+	for (TUInt32 iBlock = 0; iBlock < numBlocks; ++iBlock)
+	{
+		// Get a 4-bit mask of facing faces for each plane of the block (faces, then neighbours)
+		const TFloat32* pBlock = &m_Planes[iBlock * kiBlockFloats];
+		int aiFacing[4];
+		for (TUInt32 iPlane = 0; iPlane < 4; ++iPlane)
+		{
+			const TFloat32* pPlane = pBlock + iPlane * 16;
+			TFloat32x4 dist = Add4( Add4( Mul4( Load4( pPlane      ), lightX ),
+			                              Mul4( Load4( pPlane + 4  ), lightY ) ),
+			                        Add4( Mul4( Load4( pPlane + 8  ), lightZ ),
+			                              Mul4( Load4( pPlane + 12 ), lightW ) ) );
+			aiFacing[iPlane] = MoveMask4( Greater4( dist, zero ) );
+		}
+
+		// Most blocks have no silhouette edges, skip them without looking at individual faces
+		int silhouettes = (aiFacing[0] & ~aiFacing[1]) | (aiFacing[0] & ~aiFacing[2]) | (aiFacing[0] & ~aiFacing[3]);
+		if (silhouettes == 0) continue;
+
+		// Output edges where a facing face has a neighbour facing away
+		for (TUInt32 iLane = 0; iLane < kiBlockFaces; ++iLane)
+		{
+			if (!(silhouettes & (1 << iLane))) continue;
+			const SMeshFace& face = m_Faces[iBlock * kiBlockFaces + iLane];
+			for (TUInt32 iEdge = 0; iEdge < 3; ++iEdge)
+			{
+				if (!(aiFacing[1 + iEdge] & (1 << iLane)))
+				{
+					SSilhouetteEdge edge;
+					edge.aiVertex[0] = face.aiVertex[iEdge];
+					edge.aiVertex[1] = face.aiVertex[(iEdge + 1) % 3];
+					pOutEdges->push_back( edge );
+				}
+			}
+		}
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+/////////////////////////////////////
+// Multiple meshes
+
+// Find the silhouette edges of several meshes as seen from a light (one per mesh, in model space),
+// spreading the meshes over a number of threads. If the number of threads is 0 the hardware
+// concurrency is used
+void FindSilhouetteEdges
+(
+	const CSilhouetteMesh* const* apMeshes,
+	const CVector4*               aLights,
+	TSilhouetteEdges*             aOutEdges,
+	const TUInt32                 numMeshes,
+	TUInt32                       numThreads /*= 0*/
+)
+{
+	GEN_GUARD;
+
+	if (numThreads == 0)
+	{
+		numThreads = thread::hardware_concurrency();
+	}
+	if (numThreads > numMeshes)
+	{
+		numThreads = numMeshes;
+	}
+
+	// Each thread takes the next unprocessed mesh until there are none left. Meshes vary greatly in
+	// size so this balances better than giving each thread a fixed range. Each mesh is only
+	// processed by one thread, and writes only its own output list. Exceptions cannot leave a
+	// thread, so the first one is kept and rethrown once all threads have finished
+	atomic<TUInt32> nextMesh( 0 );
+	exception_ptr pException;
+	mutex exceptionMutex;
+	auto worker = [&]()
+	{
+		try
+		{
+			for (TUInt32 iMesh = nextMesh++; iMesh < numMeshes; iMesh = nextMesh++)
+			{
+				apMeshes[iMesh]->FindEdges( aLights[iMesh], &aOutEdges[iMesh] );
+			}
+		}
+		catch (...)
+		{
+			lock_guard<mutex> lock( exceptionMutex );
+			if (!pException)  pException = current_exception();
+			nextMesh = numMeshes; // Stop other threads taking more meshes
+		}
+	};
+
+	// Current thread takes part too, so a single thread needs no extra threads
+	vector<thread> threads;
+	for (TUInt32 iThread = 1; iThread < numThreads; ++iThread)
+	{
+		threads.push_back( thread( worker ) );
+	}
+	worker();
+	for (TUInt32 iThread = 0; iThread < threads.size(); ++iThread)
+	{
+		threads[iThread].join();
+	}
+	if (pException)
+	{
+		rethrow_exception( pException );
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+} // namespace gen
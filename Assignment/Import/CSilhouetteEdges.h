@@ -0,0 +1,128 @@
+//--------------------------------------------------------------------------------------
+// Silhouette edge extraction from imported meshes with adjacency data
+//--------------------------------------------------------------------------------------
+
+
+#ifndef GEN_C_SILHOUETTE_EDGES_H_INCLUDED
+#define GEN_C_SILHOUETTE_EDGES_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "CVector3.h"
+#include "CVector4.h"
+#include "AlignedAllocator.h"
+#include "MeshData.h"
+
+namespace gen
+{
+
+// A silhouette edge, given as two vertex indices into the sub-mesh it was found in. The vertices
+// are in the order they appear in the face that is facing the light, so a quad extruded from the
+// edge away from the light has consistent winding (for shadow volumes). Pairs of indices can also
+// be used directly as a line list index buffer (for outline rendering)
+struct SSilhouetteEdge
+{
+	TUInt16 aiVertex[2];
+};
+typedef vector<SSilhouetteEdge> TSilhouetteEdges;
+
+
+// Mesh data prepared for fast silhouette edge extraction. Face planes are precomputed when the mesh
+// is prepared, along with the plane of the neighbouring face across each edge, and are stored in
+// blocks of four faces so facing tests can be made for four faces at a time with SIMD (see
+// MathSIMD.h)
+class CSilhouetteMesh
+{
+	GEN_CLASS( CSilhouetteMesh )
+
+/*-----------------------------------------------------------------------------------------
+	Constructors/Destructors
+-----------------------------------------------------------------------------------------*/
+public:
+	// Constructor
+	CSilhouetteMesh()
+	{
+		m_NumFaces = 0;
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CSilhouetteMesh( const CSilhouetteMesh& );
+	CSilhouetteMesh& operator=( const CSilhouetteMesh& );
+
+
+/*-----------------------------------------------------------------------------------------
+	Public interface
+-----------------------------------------------------------------------------------------*/
+public:
+
+	/////////////////////////////////////
+	// Preparation
+
+	// Prepare the given sub-mesh for silhouette extraction. The sub-mesh must have been imported
+	// with adjacency data (see CImportXFile::ImportFile and GetSubMesh). The sub-mesh data is not
+	// needed after this call. Returns false if the sub-mesh has no adjacency data
+	bool Prepare( const SSubMesh& subMesh );
+
+	// Return the number of faces in the prepared mesh
+	TUInt32 GetNumFaces() const
+	{
+		return m_NumFaces;
+	}
+
+
+	/////////////////////////////////////
+	// Silhouette extraction
+
+	// Find the silhouette edges of the mesh as seen from a light. The light is given in the mesh's
+	// model space, either as a point light position (w = 1) or as a direction towards a directional
+	// light (w = 0). Edges between a face facing the light and one facing away are returned, along
+	// with open edges (with no neighbouring face) of faces facing the light. Faces facing the light
+	// are those whose front (clockwise winding) is towards it. Output list is replaced
+	void FindEdges
+	(
+		const CVector4&   light,
+		TSilhouetteEdges* pOutEdges
+	) const;
+
+
+/*-----------------------------------------------------------------------------------------
+	Private interface
+-----------------------------------------------------------------------------------------*/
+private:
+
+	// Each block of four faces stores four planes, the faces' own planes then the planes of the
+	// neighbouring face across each of their three edges. Each plane is stored as four x values,
+	// then four y, four z and four d values (planes are n.p + d = 0)
+	static const TUInt32 kiBlockFaces = 4;
+	static const TUInt32 kiBlockFloats = 4 * 4 * kiBlockFaces;
+
+	// Face planes in blocks as described above, aligned for SIMD loads
+	vector<TFloat32, CAlignedAllocator<TFloat32> > m_Planes;
+
+	// Faces copied from the sub-mesh, for output of edge vertex indices
+	vector<SMeshFace> m_Faces;
+	TUInt32           m_NumFaces;
+};
+
+
+/////////////////////////////////////
+// Multiple meshes
+
+// Find the silhouette edges of several meshes as seen from a light, spreading the meshes over a
+// number of threads. Each mesh has its own light, given in that mesh's model space (see
+// CSilhouetteMesh::FindEdges). If the number of threads is 0 the hardware concurrency is used
+void FindSilhouetteEdges
+(
+	const CSilhouetteMesh* const* apMeshes,
+	const CVector4*               aLights,
+	TSilhouetteEdges*             aOutEdges,
+	const TUInt32                 numMeshes,
+	TUInt32                       numThreads = 0
+);
+
+
+} // namespace gen
+
+#endif // GEN_C_SILHOUETTE_EDGES_H_INCLUDED
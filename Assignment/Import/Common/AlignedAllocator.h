@@ -0,0 +1,108 @@
+/**************************************************************************************************
+	Module:       AlignedAllocator.h
+
+	Support for types that must be aligned in memory beyond the default (e.g. for SIMD): an
+	allocator for standard containers and a macro to give a class aligned new/delete operators
+
+	Change history:
+		V1.0    Created for 16-byte aligned matrices
+**************************************************************************************************/
+
+// Types declared with GEN_ALIGN are correctly aligned on the stack and as members of other types,
+// but the default heap allocator only guarantees 8-byte alignment on 32-bit platforms. Standard
+// containers of aligned types should use CAlignedAllocator, e.g.
+//     vector<CMatrix4x4, CAlignedAllocator<CMatrix4x4> > matrices;
+// And classes containing aligned members that are created with new should use GEN_ALIGNED_NEW
+
+#ifndef GEN_ALIGNED_ALLOCATOR_H_INCLUDED
+#define GEN_ALIGNED_ALLOCATOR_H_INCLUDED
+
+#include <new>
+#include <stddef.h>
+
+#include "GenDefines.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Aligned allocator
+ ------------------------------------------------------------------------------------------------*/
+
+// Standard allocator returning memory aligned to a given number of bytes (a power of 2). Defaults
+// to the alignment of the type, or 16 bytes if that is less
+template <class T, size_t Alignment = (__alignof(T) > 16 ? __alignof(T) : 16)>
+class CAlignedAllocator
+{
+public:
+	typedef T         value_type;
+	typedef T*        pointer;
+	typedef const T*  const_pointer;
+	typedef T&        reference;
+	typedef const T&  const_reference;
+	typedef size_t    size_type;
+	typedef ptrdiff_t difference_type;
+
+	// Allocator of another type with the same alignment (containers allocate internal types)
+	template <class U>
+	struct rebind
+	{
+		typedef CAlignedAllocator<U, Alignment> other;
+	};
+
+	CAlignedAllocator() {}
+	template <class U>
+	CAlignedAllocator( const CAlignedAllocator<U, Alignment>& ) {}
+
+	// Allocate aligned memory for n objects, throws bad_alloc on failure as standard allocators
+	T* allocate( const size_t n )
+	{
+		void* p = AlignedAlloc( n * sizeof(T), Alignment );
+		if (!p)
+		{
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(p);
+	}
+
+	// Free memory from allocate
+	void deallocate( T* p, const size_t )
+	{
+		AlignedFree( p );
+	}
+};
+
+// All aligned allocators can free each other's memory
+template <class T, class U, size_t Alignment>
+inline bool operator==( const CAlignedAllocator<T, Alignment>&, const CAlignedAllocator<U, Alignment>& )
+{
+	return true;
+}
+template <class T, class U, size_t Alignment>
+inline bool operator!=( const CAlignedAllocator<T, Alignment>&, const CAlignedAllocator<U, Alignment>& )
+{
+	return false;
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Aligned new/delete
+ ------------------------------------------------------------------------------------------------*/
+
+// Place in a class definition to allocate objects of that class with the given alignment when
+// created with new (single objects and arrays). Leaves public access
+#define GEN_ALIGNED_NEW( alignment ) public:\
+	static void* operator new( size_t size )\
+	{\
+		void* p = gen::AlignedAlloc( size, alignment ); if (!p) throw std::bad_alloc(); return p;\
+	}\
+	static void* operator new[]( size_t size ) { return operator new( size ); }\
+	static void* operator new( size_t, void* p ) { return p; }\
+	static void operator delete( void* p ) { gen::AlignedFree( p ); }\
+	static void operator delete[]( void* p ) { gen::AlignedFree( p ); }\
+	static void operator delete( void*, void* ) {}
+
+
+} // namespace gen
+
+#endif // GEN_ALIGNED_ALLOCATOR_H_INCLUDED
@@ -0,0 +1,36 @@
+/**************************************************************************************************
+	Module:       GCCDefines.cpp
+
+	Utility functions for GCC and Clang on Linux and other POSIX platforms
+
+	Change history:
+		V1.0    Created with a console version of SystemMessageBox
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include "GenDefines.h"
+#include "GCCDefines.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Console support
+ ------------------------------------------------------------------------------------------------*/
+
+// System message box used to display errors or warnings, written to stderr. Return value is true
+// for OK, false when Yes/No buttons were requested as there is no one to answer
+bool SystemMessageBox
+(
+	const string& sMessage, // Main message to display
+	const string& sCaption, // Caption to display at top of box
+	const bool    bYesNo    // Display Yes and No buttons instead of OK
+)
+{
+	fprintf( stderr, "%s: %s\n", sCaption.c_str(), sMessage.c_str() );
+	return !bYesNo;
+}
+
+
+} // namespace gen
@@ -0,0 +1,125 @@
+/**************************************************************************************************
+	Module:       GCCDefines.h
+
+	Definitions for GCC and Clang on Linux and other POSIX platforms, the equivalents of those in
+	MSDefines.h. Covers the maths library, image code and benchmarks - not the DirectX application
+
+	Change history:
+		V1.0    Created with types, alignment and memory functions to match MSDefines.h
+**************************************************************************************************/
+
+#ifndef GEN_GCC_DEFINES_H_INCLUDED
+#define GEN_GCC_DEFINES_H_INCLUDED
+
+#include <string>
+#include <stdlib.h> // For posix_memalign
+using namespace std;
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Compiler settings
+ ------------------------------------------------------------------------------------------------*/
+
+// Check compiler version
+#if __cplusplus < 201703L
+	#error "Compiler version not supported - C++17 or better required (use -std=c++17)"
+#endif
+
+// Check compiler options
+#if !defined(__cpp_exceptions) && !defined(__EXCEPTIONS)
+	#error "Bad compiler option: C++ exception handling must be enabled"
+#endif
+
+
+/*------------------------------------------------------------------------------------------------
+	Macros
+ ------------------------------------------------------------------------------------------------*/
+
+// Prefix to align a structure or class in memory to a multiple of the given amount
+#define GEN_ALIGN(a) __attribute__((aligned(a)))
+
+
+/*------------------------------------------------------------------------------------------------
+	Constants
+ ------------------------------------------------------------------------------------------------*/
+
+// Define compiler name
+#if defined(__clang__)
+	static const string ksCompiler = "Clang";
+#else
+	static const string ksCompiler = "GCC";
+#endif
+
+
+// String locale
+const string ksPathSeparator = "/";
+const string ksNewline = "\n";
+
+
+/*------------------------------------------------------------------------------------------------
+	Types
+ ------------------------------------------------------------------------------------------------*/
+
+// Typedefs for fixed size types
+typedef signed char        TInt8;
+typedef signed short       TInt16;
+typedef signed int         TInt32;
+typedef signed long long   TInt64;
+
+typedef unsigned char      TUInt8;
+typedef unsigned short     TUInt16;
+typedef unsigned int       TUInt32;
+typedef unsigned long long TUInt64;
+
+typedef float              TFloat32;
+typedef double             TFloat64;
+
+
+/*------------------------------------------------------------------------------------------------
+	Memory
+ ------------------------------------------------------------------------------------------------*/
+
+// Allocate memory with the given alignment (a power of 2), returns 0 on failure. Must be freed
+// with AlignedFree
+inline void* AlignedAlloc
+(
+	const size_t size,
+	const size_t alignment
+)
+{
+	// posix_memalign requires at least pointer alignment
+	void* p;
+	if (posix_memalign( &p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size ) != 0)
+	{
+		return 0;
+	}
+	return p;
+}
+
+// Free memory allocated with AlignedAlloc
+inline void AlignedFree( void* p )
+{
+	free( p );
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Console support
+ ------------------------------------------------------------------------------------------------*/
+
+// System message box used to display errors or warnings. There is no GUI, so the message is
+// written to stderr instead. Return value is whether the Yes or OK button was "pressed" - true
+// for OK, false when Yes/No buttons were requested as there is no one to answer
+bool SystemMessageBox
+(
+	const string& sMessage,                       // Main message to display
+	const string& sCaption = "TL-Engine Extreme", // Caption to display at top of box
+	const bool    bYesNo = false                  // Display Yes and No buttons instead of OK
+);
+
+
+} // namespace gen
+
+#endif // GEN_GCC_DEFINES_H_INCLUDED
@@ -18,6 +18,7 @@
 #pragma comment(lib, "shlwapi.lib") 
 
 #include <string>
+#include <malloc.h> // For _aligned_malloc
 using namespace std;
 
 namespace gen
@@ -105,6 +106,28 @@ typedef float            TFloat32;
 typedef double           TFloat64;
 
 
+/*------------------------------------------------------------------------------------------------
+	Memory
+ ------------------------------------------------------------------------------------------------*/
+
+// Allocate memory with the given alignment (a power of 2), returns 0 on failure. Must be freed
+// with AlignedFree
+inline void* AlignedAlloc
+(
+	const size_t size,
+	const size_t alignment
+)
+{
+	return _aligned_malloc( size, alignment );
+}
+
+// Free memory allocated with AlignedAlloc
+inline void AlignedFree( void* p )
+{
+	_aligned_free( p );
+}
+
+
 /*------------------------------------------------------------------------------------------------
 	MS-specific GUI support
  ------------------------------------------------------------------------------------------------*/
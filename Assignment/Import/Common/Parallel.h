@@ -0,0 +1,95 @@
+/**************************************************************************************************
+	Module:       Parallel.h
+
+	Splitting uniform batches of work across threads - only included when needed
+
+	Change history:
+		V1.0    Created for batch math operations
+**************************************************************************************************/
+
+#ifndef GEN_PARALLEL_H_INCLUDED
+#define GEN_PARALLEL_H_INCLUDED
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "GenDefines.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Parallel ranges
+ ------------------------------------------------------------------------------------------------*/
+
+// Call func( begin, end ) for consecutive ranges of items that together cover [0, count), with
+// each range on its own thread. Suitable for work that takes the same time per item (e.g. batch
+// transforms) - work that varies should have threads take items in turn instead. Each thread is
+// given at least minPerThread items, so small counts run entirely on the current thread without
+// the cost of starting any threads. If the number of threads is 0 the hardware concurrency is
+// used. The current thread takes the first range. Exceptions cannot leave a thread, so the first
+// one is kept and rethrown once all threads have finished
+template <class Func>
+void ParallelRanges
+(
+	const size_t  count,
+	const size_t  minPerThread,
+	TUInt32       numThreads,
+	const Func&   func
+)
+{
+	if (numThreads == 0)
+	{
+		numThreads = thread::hardware_concurrency();
+	}
+	const size_t maxThreads = (minPerThread > 0) ? count / minPerThread : count;
+	if (numThreads > maxThreads)
+	{
+		numThreads = static_cast<TUInt32>(maxThreads);
+	}
+	if (numThreads <= 1)
+	{
+		if (count > 0)  func( static_cast<size_t>(0), count );
+		return;
+	}
+
+	const size_t perThread = (count + numThreads - 1) / numThreads;
+	numThreads = static_cast<TUInt32>((count + perThread - 1) / perThread); // Rounding may leave threads unused
+	exception_ptr pException;
+	mutex exceptionMutex;
+	auto worker = [&]( const size_t begin )
+	{
+		try
+		{
+			func( begin, (count - begin < perThread) ? count : begin + perThread );
+		}
+		catch (...)
+		{
+			lock_guard<mutex> lock( exceptionMutex );
+			if (!pException)  pException = current_exception();
+		}
+	};
+
+	vector<thread> threads;
+	for (TUInt32 iThread = 1; iThread < numThreads; ++iThread)
+	{
+		threads.push_back( thread( worker, iThread * perThread ) );
+	}
+	worker( 0 );
+	for (TUInt32 iThread = 0; iThread < threads.size(); ++iThread)
+	{
+		threads[iThread].join();
+	}
+	if (pException)
+	{
+		rethrow_exception( pException );
+	}
+}
+
+
+} // namespace gen
+
+#endif // GEN_PARALLEL_H_INCLUDED
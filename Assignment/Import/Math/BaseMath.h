@@ -17,14 +17,15 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <string.h> // For memcpy
 
 #include "GenDefines.h"
 #include "Error.h"
 
 //TODO
-// Vectors: Hermite / Catmull-Rom, Lerp, Barycentric
+// Vectors: Lerp, Barycentric (Hermite / Catmull-Rom are in CSplinePath.h)
 // Matrices: ReflectioninPlane, shadow, transform plane
-// All: Packing, alignment, improve efficiency (SSE etc)
+// All: Packing, alignment, improve efficiency (SSE etc) - done for CMatrix4x4, see MathSIMD.h
 
 namespace gen
 {
@@ -33,14 +34,14 @@ namespace gen
 	Mathematical constants
 -----------------------------------------------------------------------------------------*/
 
-const TFloat32 kfPi = 3.1415926535897932384626433832795f;
-const TFloat64 kfPi64 = 3.1415926535897932384626433832795;
+constexpr TFloat32 kfPi = 3.1415926535897932384626433832795f;
+constexpr TFloat64 kfPi64 = 3.1415926535897932384626433832795;
 
 // Default epsilon values (margin of error for approximations), suitable for values known
 // to be around 1.0. Provided for convenience, read the extensive commentary below regarding
 // floating point approximation before considering if these values are appropriate
-const TFloat32 kfEpsilon = 0.5e-6f;    // For 32-bit floats
-const TFloat64 kfEpsilon64 = 0.5e-15f; // For 64-bit floats
+constexpr TFloat32 kfEpsilon = 0.5e-6f;    // For 32-bit floats
+constexpr TFloat64 kfEpsilon64 = 0.5e-15f; // For 64-bit floats
 
 
 /*-----------------------------------------------------------------------------------------
@@ -76,7 +77,7 @@ enum ERoundingMethod
 // Many versions provided here to allow mixing of parameter types for these basic functions
 
 inline TUInt32 Abs( const TInt32 x ) { return abs( static_cast<int>(x) ); }
-inline TUInt64 Abs( const TInt64 x ) { return _abs64( x ); }
+inline TUInt64 Abs( const TInt64 x ) { return llabs( x ); }
 inline TFloat32 Abs( const TFloat32 x ) { return fabsf( x ); }
 inline TFloat64 Abs( const TFloat64 x ) { return fabs( x ); }
 
@@ -153,7 +154,7 @@ inline TFloat64 ATan( const TFloat64 x, const TFloat32 y ) { return ATan( x, sta
 	Common variations of basic operations
 -----------------------------------------------------------------------------------------*/
 
-// 1 / Sqrt
+// 1 / Sqrt - see InvSqrtFast in FastMath.h for a faster approximation
 inline TFloat32 InvSqrt( const TFloat32 x )
 {
 	GEN_GUARD_OPT;
@@ -182,7 +183,8 @@ inline TFloat32 InvSqrt( const TInt32 x ) { return InvSqrt(static_cast<TFloat32>
 inline TFloat64 InvSqrt( const TInt64 x ) { return InvSqrt(static_cast<TFloat64>(x)); }
 
 
-// Get both sin and cos of x, more efficient than calling functions seperately
+// Get both sin and cos of x, more efficient than calling functions seperately. See SinCosFast in
+// FastMath.h for a faster approximation, and SinCos4 there for four values at once
 inline void SinCos
 (
 	TFloat32  x,
@@ -212,41 +214,41 @@ inline void SinCos
 -----------------------------------------------------------------------------------------*/
 
 // Convert radians to degrees
-inline TFloat32 ToDegrees( const TFloat32 r )
+constexpr TFloat32 ToDegrees( const TFloat32 r )
 {
 	return (r * 180.0f) / kfPi;
 }
 
 // Convert radians to degrees
-inline TFloat64 ToDegrees( const TFloat64 r )
+constexpr TFloat64 ToDegrees( const TFloat64 r )
 {
 	return (r * 180.0) / kfPi64;
 }
 
 // Convert radians to degrees
-inline TFloat32 ToDegrees( const TInt32 r ) { return ToDegrees(static_cast<TFloat32>(r)); }
+constexpr TFloat32 ToDegrees( const TInt32 r ) { return ToDegrees(static_cast<TFloat32>(r)); }
 
 // Convert radians to degrees
-inline TFloat64 ToDegrees( const TInt64 r ) { return ToDegrees(static_cast<TFloat64>(r)); }
+constexpr TFloat64 ToDegrees( const TInt64 r ) { return ToDegrees(static_cast<TFloat64>(r)); }
 
 
 // Convert degrees to radians
-inline TFloat32 ToRadians( const TFloat32 d )
+constexpr TFloat32 ToRadians( const TFloat32 d )
 {
 	return (d * kfPi) / 180.0f;
 }
 
 // Convert degrees to radians
-inline TFloat64 ToRadians( const TFloat64 d )
+constexpr TFloat64 ToRadians( const TFloat64 d )
 {
 	return (d * kfPi64) / 180.0;
 }
 
 // Convert degrees to radians
-inline TFloat32 ToRadians( const TInt32 d ) { return ToRadians(static_cast<TFloat32>(d)); }
+constexpr TFloat32 ToRadians( const TInt32 d ) { return ToRadians(static_cast<TFloat32>(d)); }
 
 // Convert degrees to radians
-inline TFloat64 ToRadians( const TInt64 d ) { return ToRadians(static_cast<TFloat64>(d)); }
+constexpr TFloat64 ToRadians( const TInt64 d ) { return ToRadians(static_cast<TFloat64>(d)); }
 
 
 /*-----------------------------------------------------------------------------------------
@@ -401,8 +403,10 @@ inline bool AreEqual
 	const TUInt32  iEpsilonFrac = 4
 )
 {
-	// Reinterpret 32-bit float as 32-bit unsigned int
-    TInt32 xInt = *(TInt32*)&x;
+	// Reinterpret 32-bit float as 32-bit unsigned int (memcpy is the portable way to do this and
+	// compiles to a single move)
+    TInt32 xInt;
+    memcpy( &xInt, &x, sizeof(xInt) );
     if (xInt < 0)
 	{
 		// Reorder negative values so we can use integer comparison
@@ -410,7 +414,8 @@ inline bool AreEqual
 	}
 
 	// Same with second value
-    TInt32 yInt = *(TInt32*)&y;
+    TInt32 yInt;
+    memcpy( &yInt, &y, sizeof(yInt) );
     if (yInt < 0)
 	{
         yInt = 0x80000000 - yInt;
@@ -434,7 +439,8 @@ inline bool AreEqual
 )
 {
 	// Reinterpret 64-bit float as 64-bit unsigned int
-    TInt64 xInt = *(TInt64*)&x;
+    TInt64 xInt;
+    memcpy( &xInt, &x, sizeof(xInt) );
     if (xInt < 0)
 	{
 		// Reorder negative values so we can use integer comparison
@@ -442,7 +448,8 @@ inline bool AreEqual
 	}
 
 	// Same with second value
-    TInt64 yInt = *(TInt64*)&y;
+    TInt64 yInt;
+    memcpy( &yInt, &y, sizeof(yInt) );
     if (yInt < 0)
 	{
         yInt = 0x8000000000000000 - yInt;
@@ -462,13 +469,17 @@ inline bool AreEqual
 // Min template function - find minimum of two values of any type that has < operator defined
 // If the values are equivalent, then the first is considered the minimum
 template <class C>
-inline C Min( const C a, const C b ) { return ((b < a) ? b : a); }
+constexpr C Min( const C a, const C b ) { return ((b < a) ? b : a); }
 
 // Max template function - find maximum of two values of any type that has < operator defined
 // If the values are equivalent, then the second is considered the maximum
 template <class C>
-inline C Max( const C a, const C b ) { return (!(b < a) ? b : a); }
+constexpr C Max( const C a, const C b ) { return (!(b < a) ? b : a); }
+
 
+// The Random functions use the C library rand, so all threads share one sequence and calls from
+// different threads are not safe. See CRandom in CRandom.h for a faster generator with its own
+// state and batch functions
 
 // Return random integer from a to b (inclusive)
 // Can only return up to RAND_MAX different values, spread evenly across the given range
@@ -25,20 +25,6 @@ namespace gen
 	Constructors/Destructors
 -----------------------------------------------------------------------------------------*/
 
-// Construct by value
-CMatrix2x2::CMatrix2x2
-(
-	const TFloat32 elt00, const TFloat32 elt01,
-	const TFloat32 elt10, const TFloat32 elt11
-)
-{
-	e00 = elt00;
-	e01 = elt01;
-
-	e10 = elt10;
-	e11 = elt11;
-}
-
 // Construct through pointer to 4 floats, may specify row/column order of data
 CMatrix2x2::CMatrix2x2
 (
@@ -105,7 +91,7 @@ CMatrix2x2::CMatrix2x2
 )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c * scale.x;
 	e01 = s * scale.x;
@@ -115,31 +101,6 @@ CMatrix2x2::CMatrix2x2
 }
 
 
-// Copy constructor
-CMatrix2x2::CMatrix2x2( const CMatrix2x2& m )
-{
-	e00 = m.e00;
-	e01 = m.e01;
-
-	e10 = m.e10;
-	e11 = m.e11;
-}
-
-// Assignment operator
-CMatrix2x2& CMatrix2x2::operator=( const CMatrix2x2& m )
-{
-	if ( this != &m )
-	{
-		e00 = m.e00;
-		e01 = m.e01;
-
-		e10 = m.e10;
-		e11 = m.e11;
-	}
-	return *this;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Setters
 -----------------------------------------------------------------------------------------*/
@@ -295,7 +256,7 @@ void CMatrix2x2::MakeTransform
 )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c * scale.x;
 	e01 = s * scale.x;
@@ -639,7 +600,7 @@ void CMatrix2x2::MakeIdentity()
 void CMatrix2x2::MakeRotation( const TFloat32 fAngle )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c;
 	e01 = s;
@@ -677,19 +638,6 @@ void CMatrix2x2::MakeScaling( const TFloat32 fScale )
 // as temporaries in calculations, e.g.
 //     CMatrix2x2 m = MatrixScaling( 3.0f ) * MatrixRotation( ToRadians(45.0f) );
 
-// Return an identity matrix
-CMatrix2x2 Matrix2x2Identity()
-{
-	CMatrix2x2 m;
-
-	m.e00 = 1.0f;
-	m.e01 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = 1.0f;
-
-	return m;
-}
 
 // Return a matrix that is a rotation of the given angle (radians)
 CMatrix2x2 Matrix2x2Rotation( const TFloat32 fAngle )
@@ -697,7 +645,7 @@ CMatrix2x2 Matrix2x2Rotation( const TFloat32 fAngle )
 	CMatrix2x2 m;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	m.e00 = c;
 	m.e01 = s;
@@ -709,35 +657,6 @@ CMatrix2x2 Matrix2x2Rotation( const TFloat32 fAngle )
 }
 
 
-// Return a matrix that is a scaling in X and Y by the values provided in the given vector
-CMatrix2x2 Matrix2x2Scaling( const CVector2& scale )
-{
-	CMatrix2x2 m;
-
-	m.e00 = scale.x;
-	m.e01 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = scale.y;
-
-	return m;
-}
-
-// Return a matrix that is a uniform scaling of the given amount
-CMatrix2x2 Matrix2x2Scaling( const TFloat32 fScale )
-{
-	CMatrix2x2 m;
-
-	m.e00 = fScale;
-	m.e01 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = fScale;
-
-	return m;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Facing Matrices
 -----------------------------------------------------------------------------------------*/
@@ -1040,13 +959,4 @@ CMatrix2x2 operator*
 }
 
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
-
-// Standard matrices
-const CMatrix2x2 CMatrix2x2::kIdentity(1.0f, 0.0f,
-                                       0.0f, 1.0f);
-
-
 } // namespace gen
@@ -29,6 +29,7 @@
 
 #include "GenDefines.h"
 #include "BaseMath.h"
+#include "FastMath.h"
 #include "CVector2.h"
 
 namespace gen
@@ -49,11 +50,13 @@ public:
 	CMatrix2x2() {}
 
 	// Construct by value
-	CMatrix2x2
+	constexpr CMatrix2x2
 	(
 		const TFloat32 elt00, const TFloat32 elt01,
 		const TFloat32 elt10, const TFloat32 elt11
-	);
+	) : e00( elt00 ), e01( elt01 ),
+	    e10( elt10 ), e11( elt11 )
+	{}
 
 	// Construct through pointer to 4 floats, may specify row/column order of data
 	explicit CMatrix2x2
@@ -84,11 +87,10 @@ public:
 	// Require explicit conversion from angle only (see above)
 
 
-	// Copy constructor
-    CMatrix2x2( const CMatrix2x2& m );
-
-	// Assignment operator
-    CMatrix2x2& operator=( const CMatrix2x2& m );
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CMatrix2x2( const CMatrix2x2& m ) = default;
+	CMatrix2x2& operator=( const CMatrix2x2& m ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -234,7 +236,7 @@ public:
 
 	// Alter the scale of a transformation matrix in the (local) X direction. The effect is
 	// multiplicative, e.g ScaleX( 2.0f ) indicates a doubling of the X scale
-    void ScaleX( const TFloat32 x )
+    constexpr void ScaleX( const TFloat32 x )
 	{
 		e00 *= x;
 		e01 *= x;
@@ -242,7 +244,7 @@ public:
 
 	// Alter the scale of a transformation matrix in the (local) Y direction. The effect is
 	// multiplicative, e.g ScaleY( 2.0f ) indicates a doubling of the Y scale
-    void ScaleY( const TFloat32 y )
+    constexpr void ScaleY( const TFloat32 y )
 	{
 		e10 *= y;
 		e11 *= y;
@@ -251,7 +253,7 @@ public:
 	// Alter the scale of a transformation matrix in the (local) X & Y directions. The effect is
 	// multiplicative, e.g Scale( CVector3(2.0f, 2.0f, 2.0f) ) indicates a doubling of the scale
 	// in all directions
-    void Scale( const CVector2 scale )
+    constexpr void Scale( const CVector2 scale )
 	{
 		e00 *= scale.x;
 		e01 *= scale.x;
@@ -262,7 +264,7 @@ public:
 
 	// Alter the scale of a transformation matrix uniformly in the (local) X & Y directions. The
 	// effect is multiplicative, e.g Scale( 2.0f ) indicates a uniform doubling of the scale
-    void Scale( const TFloat32 fScale )
+    constexpr void Scale( const TFloat32 fScale )
 	{
 		e00 *= fScale;
 		e01 *= fScale;
@@ -277,7 +279,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 s, c;
-		SinCos( fAngle, &s, &c );
+		RotationSinCos( fAngle, &s, &c );
 		TFloat32 t;
 		t   = e00*s + e01*c;
 		e00 = e00*c - e01*s;
@@ -414,6 +416,16 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard matrices
+inline constexpr CMatrix2x2 CMatrix2x2::kIdentity(1.0f, 0.0f,
+                                       0.0f, 1.0f);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -528,7 +540,10 @@ CMatrix2x2 Inverse( const CMatrix2x2& m );
 //     CMatrix2x2 m = MatrixScaling( 3.0f ) * MatrixRotation( ToRadians(45.0f) );
 
 // Return an identity matrix
-CMatrix2x2 Matrix2x2Identity();
+constexpr CMatrix2x2 Matrix2x2Identity()
+{
+	return CMatrix2x2::kIdentity;
+}
 
 
 // Return a rotation matrix of the given angle
@@ -536,10 +551,18 @@ CMatrix2x2 Matrix2x2Rotation( const TFloat32 fAngle );
 
 
 // Return a matrix that is a scaling in X and Y of the values provided in the given vector
-CMatrix2x2 Matrix2x2Scaling( const CVector2& scale );
+constexpr CMatrix2x2 Matrix2x2Scaling( const CVector2& scale )
+{
+	return CMatrix2x2( scale.x, 0.0f,
+	                   0.0f, scale.y );
+}
 
 // Return a matrix that is a uniform scaling of the given amount
-CMatrix2x2 Matrix2x2Scaling( const TFloat32 fScale );
+constexpr CMatrix2x2 Matrix2x2Scaling( const TFloat32 fScale )
+{
+	return CMatrix2x2( fScale, 0.0f,
+	                   0.0f, fScale );
+}
 
 
 /*-----------------------------------------------------------------------------------------
@@ -29,27 +29,6 @@ namespace gen
 	Constructors/Destructors
 -----------------------------------------------------------------------------------------*/
 
-// Construct by value
-CMatrix3x3::CMatrix3x3
-(
-	const TFloat32 elt00, const TFloat32 elt01, const TFloat32 elt02,
-	const TFloat32 elt10, const TFloat32 elt11, const TFloat32 elt12,
-	const TFloat32 elt20, const TFloat32 elt21, const TFloat32 elt22
-)
-{
-	e00 = elt00;
-	e01 = elt01;
-	e02 = elt02;
-
-	e10 = elt10;
-	e11 = elt11;
-	e12 = elt12;
-
-	e20 = elt20;
-	e21 = elt21;
-	e22 = elt22;
-}
-
 // Construct through pointer to 9 floats, may specify row/column order of data
 CMatrix3x3::CMatrix3x3
 (
@@ -291,7 +270,7 @@ CMatrix3x3::CMatrix3x3
 )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c * scale.x;
 	e01 = s * scale.x;
@@ -331,43 +310,6 @@ CMatrix3x3::CMatrix3x3
 }
 
 
-// Copy constructor
-CMatrix3x3::CMatrix3x3( const CMatrix3x3& m )
-{
-	e00 = m.e00;
-	e01 = m.e01;
-	e02 = m.e02;
-
-	e10 = m.e10;
-	e11 = m.e11;
-	e12 = m.e12;
-
-	e20 = m.e20;
-	e21 = m.e21;
-	e22 = m.e22;
-}
-
-// Assignment operator
-CMatrix3x3& CMatrix3x3::operator=( const CMatrix3x3& m )
-{
-	if ( this != &m )
-	{
-		e00 = m.e00;
-		e01 = m.e01;
-		e02 = m.e02;
-
-		e10 = m.e10;
-		e11 = m.e11;
-		e12 = m.e12;
-
-		e20 = m.e20;
-		e21 = m.e21;
-		e22 = m.e22;
-	}
-	return *this;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Setters
 -----------------------------------------------------------------------------------------*/
@@ -1138,7 +1080,7 @@ void CMatrix3x3::MakeAffine2D
 )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c * scale.x;
 	e01 = s * scale.x;
@@ -1904,7 +1846,7 @@ void CMatrix3x3::MakeIdentity()
 void CMatrix3x3::MakeRotationX( const TFloat32 x )
 {
 	TFloat32 sX, cX;
-	SinCos( x, &sX, &cX );
+	RotationSinCos( x, &sX, &cX );
 
 	e00 = 1.0f;
 	e01 = 0.0f;
@@ -1923,7 +1865,7 @@ void CMatrix3x3::MakeRotationX( const TFloat32 x )
 void CMatrix3x3::MakeRotationY( const TFloat32 y )
 {
 	TFloat32 sY, cY;
-	SinCos( y, &sY, &cY );
+	RotationSinCos( y, &sY, &cY );
 
 	e00 = cY;
 	e01 = 0.0f;
@@ -1942,7 +1884,7 @@ void CMatrix3x3::MakeRotationY( const TFloat32 y )
 void CMatrix3x3::MakeRotationZ( const TFloat32 z )
 {
 	TFloat32 sZ, cZ;
-	SinCos( z, &sZ, &cZ );
+	RotationSinCos( z, &sZ, &cZ );
 
 	e00 = cZ;
 	e01 = sZ;
@@ -1968,9 +1910,9 @@ void CMatrix3x3::MakeRotation
 	GEN_GUARD;
 
 	TFloat32 sX, cX, sY, cY, sZ, cZ;
-	SinCos( angles.x, &sX, &cX );
-	SinCos( angles.y, &sY, &cY );
-	SinCos( angles.z, &sZ, &cZ );
+	RotationSinCos( angles.x, &sX, &cX );
+	RotationSinCos( angles.y, &sY, &cY );
+	RotationSinCos( angles.z, &sZ, &cZ );
 
 	switch (eRotOrder)
 	{
@@ -2082,7 +2024,7 @@ void CMatrix3x3::MakeRotation
 	GEN_GUARD;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 	TFloat32 t = 1.0f - c;
 
 	CVector3 axisNorm = Normalise( axis );
@@ -2153,26 +2095,6 @@ void CMatrix3x3::MakeScaling( const TFloat32 fScale )
 // as temporaries in calculations, e.g.
 //     CMatrix3x3 m = MatrixScaling( 3.0f ) * MatrixRotationX( ToRadians(45.0f) );
 
-// Return an identity matrix - non-member function
-CMatrix3x3 Matrix3x3Identity()
-{
-	CMatrix3x3 m;
-
-	m.e00 = 1.0f;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f; 
-
-	m.e10 = 0.0f;
-	m.e11 = 1.0f;
-	m.e12 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = 1.0f;
-
-	return m;
-}
-
 
 // Return an X-axis rotation matrix of the given angle - non-member function
 CMatrix3x3 Matrix3x3RotationX( const TFloat32 x )
@@ -2180,7 +2102,7 @@ CMatrix3x3 Matrix3x3RotationX( const TFloat32 x )
 	CMatrix3x3 m;
 
 	TFloat32 sX, cX;
-	SinCos( x, &sX, &cX );
+	RotationSinCos( x, &sX, &cX );
 
 	m.e00 = 1.0f;
 	m.e01 = 0.0f;
@@ -2203,7 +2125,7 @@ CMatrix3x3 Matrix3x3RotationY( const TFloat32 y )
 	CMatrix3x3 m;
 
 	TFloat32 sY, cY;
-	SinCos( y, &sY, &cY );
+	RotationSinCos( y, &sY, &cY );
 
 	m.e00 = cY;
 	m.e01 = 0.0f;
@@ -2226,7 +2148,7 @@ CMatrix3x3 Matrix3x3RotationZ( const TFloat32 z )
 	CMatrix3x3 m;
 
 	TFloat32 sZ, cZ;
-	SinCos( z, &sZ, &cZ );
+	RotationSinCos( z, &sZ, &cZ );
 
 	m.e00 = cZ;
 	m.e01 = sZ;
@@ -2256,9 +2178,9 @@ CMatrix3x3 Matrix3x3Rotation
 	CMatrix3x3 m;
 
 	TFloat32 sX, cX, sY, cY, sZ, cZ;
-	SinCos( angles.x, &sX, &cX );
-	SinCos( angles.y, &sY, &cY );
-	SinCos( angles.z, &sZ, &cZ );
+	RotationSinCos( angles.x, &sX, &cX );
+	RotationSinCos( angles.y, &sY, &cY );
+	RotationSinCos( angles.z, &sZ, &cZ );
 
 	switch (eRotOrder)
 	{
@@ -2375,7 +2297,7 @@ CMatrix3x3 Matrix3x3Rotation
 	CMatrix3x3 m;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 	TFloat32 t = 1.0f - c;
 
 	CVector3 axisNorm = Normalise( axis );
@@ -2409,48 +2331,6 @@ CMatrix3x3 Matrix3x3Rotation
 }
 
 
-// Return a matrix that is a scaling in X,Y and Z of the values provided in the given vector
-// Non-member function
-CMatrix3x3 Matrix3x3Scaling( const CVector3& scale )
-{
-	CMatrix3x3 m;
-
-	m.e00 = scale.x;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = scale.y;
-	m.e12 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = scale.z;
-
-	return m;
-}
-
-// Return a matrix that is a uniform scaling of the given amount - non-member function
-CMatrix3x3 Matrix3x3Scaling( const TFloat32 fScale )
-{
-	CMatrix3x3 m;
-
-	m.e00 = fScale;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = fScale;
-	m.e12 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = fScale;
-
-	return m;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	2D Affine Transformation Matrices
 -----------------------------------------------------------------------------------------*/
@@ -2476,7 +2356,7 @@ void CMatrix3x3::MakeTranslation2D( const CVector2& translate )
 void CMatrix3x3::MakeRotation2D( const TFloat32 fAngle )
 {
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	e00 = c;
 	e01 = s;
@@ -2530,26 +2410,6 @@ void CMatrix3x3::MakeScaling2D( const TFloat32 fScale )
 -----------------------------------------------------------------------------------------*/
 // Same as class member functions, but these return a new matrix (by value) - see above
 
-// Return a matrix that is a 2D affine translation of the given vector
-CMatrix3x3 MatrixTranslation2D( const CVector2& translate )
-{
-	CMatrix3x3 m;
-
-	m.e00 = 1.0f;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = 1.0f;
-	m.e12 = 0.0f;
-
-	m.e20 = translate.x;
-	m.e21 = translate.y;
-	m.e22 = 1.0f;
-
-	return m;
-}
-
 
 // Return a matrix that is a 2D affine rotation of the given angle (radians)
 CMatrix3x3 MatrixRotation2D( const TFloat32 fAngle )
@@ -2557,7 +2417,7 @@ CMatrix3x3 MatrixRotation2D( const TFloat32 fAngle )
 	CMatrix3x3 m;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 
 	m.e00 = c;
 	m.e01 = s;
@@ -2575,47 +2435,6 @@ CMatrix3x3 MatrixRotation2D( const TFloat32 fAngle )
 }
 
 
-// Return a matrix that is a 2D affine scaling in X and Y by the values provided in the given vector
-CMatrix3x3 MatrixScaling2D( const CVector2& scale )
-{
-	CMatrix3x3 m;
-
-	m.e00 = scale.x;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = scale.y;
-	m.e12 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = 1.0f;
-
-	return m;
-}
-
-// Return a matrix that is a 2D affine uniform scaling of the given amount
-CMatrix3x3 MatrixScaling2D( const TFloat32 fScale )
-{
-	CMatrix3x3 m;
-
-	m.e00 = fScale;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = fScale;
-	m.e12 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = 1.0f;
-
-	return m;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Facing Matrices
 -----------------------------------------------------------------------------------------*/
@@ -3214,14 +3033,4 @@ CMatrix3x3 MultiplyAffine2D
 }
 
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
-
-// Standard matrices
-const CMatrix3x3 CMatrix3x3::kIdentity(1.0f, 0.0f, 0.0f,
-                                       0.0f, 1.0f, 0.0f,
-                                       0.0f, 0.0f, 1.0f);
-
-
 } // namespace gen
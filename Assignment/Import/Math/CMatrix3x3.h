@@ -58,6 +58,7 @@
 
 #include "GenDefines.h"
 #include "BaseMath.h"
+#include "FastMath.h"
 #include "CVector2.h"
 #include "CVector3.h"
 
@@ -84,12 +85,15 @@ public:
 	CMatrix3x3() {}
 
 	// Construct by value
-	CMatrix3x3
+	constexpr CMatrix3x3
 	(
 		const TFloat32 elt00, const TFloat32 elt01, const TFloat32 elt02,
 		const TFloat32 elt10, const TFloat32 elt11, const TFloat32 elt12,
 		const TFloat32 elt20, const TFloat32 elt21, const TFloat32 elt22
-	);
+	) : e00( elt00 ), e01( elt01 ), e02( elt02 ),
+	    e10( elt10 ), e11( elt11 ), e12( elt12 ),
+	    e20( elt20 ), e21( elt21 ), e22( elt22 )
+	{}
 
 	// Construct through pointer to 9 floats, may specify row/column order of data
 	explicit CMatrix3x3
@@ -175,11 +179,10 @@ public:
 	// Require explicit conversion from CMatrix2x2 (see above)
 
 
-	// Copy constructor
-    CMatrix3x3( const CMatrix3x3& m );
-
-	// Assignment operator
-    CMatrix3x3& operator=( const CMatrix3x3& m );
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CMatrix3x3( const CMatrix3x3& m ) = default;
+	CMatrix3x3& operator=( const CMatrix3x3& m ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -494,7 +497,7 @@ public:
 
 	// Alter the scale of a transformation matrix in the (local) X direction. The effect is
 	// multiplicative, e.g ScaleX( 2.0f ) indicates a doubling of the X scale
-    void ScaleX( const TFloat32 x )
+    constexpr void ScaleX( const TFloat32 x )
 	{
 		e00 *= x;
 		e01 *= x;
@@ -503,7 +506,7 @@ public:
 
 	// Alter the scale of a transformation matrix in the (local) Y direction. The effect is
 	// multiplicative, e.g ScaleY( 2.0f ) indicates a doubling of the Y scale
-    void ScaleY( const TFloat32 y )
+    constexpr void ScaleY( const TFloat32 y )
 	{
 		e10 *= y;
 		e11 *= y;
@@ -512,7 +515,7 @@ public:
 
 	// Alter the scale of a transformation matrix in the (local) Z direction. The effect is
 	// multiplicative, e.g ScaleZ( 2.0f ) indicates a doubling of the Z scale
-    void ScaleZ( const TFloat32 z )
+    constexpr void ScaleZ( const TFloat32 z )
 	{
 		e20 *= z;
 		e21 *= z;
@@ -522,7 +525,7 @@ public:
 	// Alter the scale of a transformation matrix in the (local) X, Y & Z directions. The effect
 	// is multiplicative, e.g Scale( CVector3(2.0f, 2.0f, 2.0f) ) indicates a doubling of the scale
 	// in all directions
-    void Scale( const CVector3 scale )
+    constexpr void Scale( const CVector3 scale )
 	{
 		e00 *= scale.x;
 		e01 *= scale.x;
@@ -539,7 +542,7 @@ public:
 
 	// Alter the scale of a transformation matrix uniformly in the (local) X, Y & Z directions.
 	// The effect is multiplicative, e.g Scale( 2.0f ) indicates a uniform doubling of the scale
-    void Scale( const TFloat32 fScale )
+    constexpr void Scale( const TFloat32 fScale )
 	{
 		e00 *= fScale;
 		e01 *= fScale;
@@ -560,7 +563,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sX, cX;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		TFloat32 t;
 		t   = e01*sX + e02*cX;
 		e01 = e01*cX - e02*sX;
@@ -578,7 +581,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sY, cY;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		TFloat32 t;
 		t   = e00*cY + e02*sY;
 		e02 = e02*cY - e00*sY;
@@ -596,7 +599,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sZ, cZ;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		TFloat32 t;
 		t   = e00*sZ + e01*cZ;
 		e00 = e00*cZ - e01*sZ;
@@ -623,7 +626,7 @@ public:
 		TFloat32 scaleYZ = Sqrt( scaleSqY ) * InvSqrt( scaleSqZ );
 
 		TFloat32 sX, cX, sXY, sXZ;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		sXY = sX * scaleYZ;
 		sXZ = sX / scaleYZ;
 
@@ -646,7 +649,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sX, cX;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		TFloat32 t;
 		t   = e10*cX + e20*sX;
 		e20 = e20*cX - e10*sX;
@@ -672,7 +675,7 @@ public:
 		TFloat32 scaleZX = Sqrt( scaleSqZ ) * InvSqrt( scaleSqX );
 
 		TFloat32 sY, cY, sYZ, sYX;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		sYZ = sY * scaleZX;
 		sYX = sY / scaleZX;
 
@@ -695,7 +698,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sY, cY;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		TFloat32 t;
 		t   = e20*cY + e00*sY;
 		e00 = e00*cY - e20*sY;
@@ -721,7 +724,7 @@ public:
 		TFloat32 scaleXY = Sqrt( scaleSqX ) * InvSqrt( scaleSqY );
 
 		TFloat32 sZ, cZ, sZX, sZY;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		sZX = sZ * scaleXY;
 		sZY = sZ / scaleXY;
 
@@ -744,7 +747,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sZ, cZ;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		TFloat32 t;
 		t   = e00*cZ + e10*sZ;
 		e10 = e10*cZ - e00*sZ;
@@ -767,7 +770,7 @@ public:
 
 	// Get the position (translation) of a 2D affine transformation matrix. Similar to GetRow( 2 ),
 	// but returning CVector2. Use of Position2D() function may be more efficient, but non-portable
-	CVector2 GetPosition2D() const
+	constexpr CVector2 GetPosition2D() const
 	{
 		return CVector2(e20, e21);
 	}
@@ -775,53 +778,53 @@ public:
 	// Set the position (translation) of a 2D affine transformation matrix. Will not change other
 	// components of the transformation (rotation, scale etc.). Same as SetRow( 2, p ). Use of
 	// Position2D() function may be more efficient, but non-portable
-	void SetPosition2D( const CVector2& p )
+	constexpr void SetPosition2D( const CVector2& p )
 	{
 		e20 = p.x;
 		e21 = p.y;
 	}
 
 	// Return X position (translation) of a 2D affine transformation matrix
-	TFloat32 GetX2D() const 
+	constexpr TFloat32 GetX2D() const 
 	{
 		return e20;
 	}
 
 	// Return Y position (translation) of a 2D affine transformation matrix
-	TFloat32 GetY2D() const
+	constexpr TFloat32 GetY2D() const
 	{
 		return e21;
 	}
 
 
 	// Set X position (translation) of a 2D affine transformation matrix
-	void SetX2D( const TFloat32 x )
+	constexpr void SetX2D( const TFloat32 x )
 	{
 		e20 = x;
 	}
 
 	// Set Y position (translation) of a 2D affine transformation matrix
-	void SetY2D( const TFloat32 y )
+	constexpr void SetY2D( const TFloat32 y )
 	{
 		e21 = y;
 	}
 
 
 	// Move position (translation) of a 2D affine transformation matrix by the given vector
-	void Move2D( const CVector2 v ) 
+	constexpr void Move2D( const CVector2 v ) 
 	{
 		e20 += v.x;
 		e21 += v.y;
 	}
 
 	// Move X position (translation) of a 2D affine transformation matrix
-	void MoveX2D( const TFloat32 x )
+	constexpr void MoveX2D( const TFloat32 x )
 	{
 		e20 += x;
 	}
 
 	// Move Y position (translation) of a 2D affine transformation matrix
-	void MoveY2D( const TFloat32 y )
+	constexpr void MoveY2D( const TFloat32 y )
 	{
 		e21 += y;
 	}
@@ -841,7 +844,7 @@ public:
 	// local coordinate space. Will move relative to the matrix's scaling, i.e. matrix will move 
 	// v.x * x-scaling units in x, similarly in y. More efficient than MoveLocal if the matrix is
 	// unscaled
-	void MoveLocal2DWithScaling( const CVector2 v ) 
+	constexpr void MoveLocal2DWithScaling( const CVector2 v ) 
 	{
 		e20 += v.x * e00 + v.y * e10;
 		e21 += v.x * e01 + v.y * e11;
@@ -860,7 +863,7 @@ public:
 	// Move X position (translation) of 2D affine transformation matrix along X axis of the matrix
 	// Will move relative to the matrix's x-scaling, i.e. will move x * x-scale units
 	// More efficient than MoveLocalX if matrix is unscaled
-	void MoveLocalX2DWithScaling( const TFloat32 x ) 
+	constexpr void MoveLocalX2DWithScaling( const TFloat32 x ) 
 	{
 		e20 += x * e00;
 		e21 += x * e01;
@@ -879,7 +882,7 @@ public:
 	// Move Y position (translation) of 2D affine transformation matrix along Y axis of the matrix
 	// Will move relative to the matrix's y-scaling, i.e. will move y * y-scale units
 	// More efficient than MoveLocalY if matrix is unscaled
-	void MoveLocalY2DWithScaling( const TFloat32 y ) 
+	constexpr void MoveLocalY2DWithScaling( const TFloat32 y ) 
 	{
 		e20 += y * e10;
 		e21 += y * e11;
@@ -921,7 +924,7 @@ public:
 
 	// Alter the scale of a 2D affine transformation matrix in the (local) X direction. The effect
 	// is multiplicative, e.g ScaleX2D( 2.0f ) indicates a doubling of the X scale
-    void ScaleX2D( const TFloat32 x )
+    constexpr void ScaleX2D( const TFloat32 x )
 	{
 		e00 *= x;
 		e01 *= x;
@@ -929,7 +932,7 @@ public:
 
 	// Alter the scale of a 2D affine transformation matrix in the (local) Y direction. The effect
 	// is multiplicative, e.g ScaleY2D( 2.0f ) indicates a doubling of the Y scale
-    void ScaleY2D( const TFloat32 y )
+    constexpr void ScaleY2D( const TFloat32 y )
 	{
 		e10 *= y;
 		e11 *= y;
@@ -938,7 +941,7 @@ public:
 	// Alter the scale of a 2D affine transformation matrix in the (local) X & Y directions. The
 	// effect is multiplicative, e.g Scale2D( CVector3(2.0f, 2.0f) ) indicates a doubling of
 	// the scale in all directions
-    void Scale2D( const CVector2 scale )
+    constexpr void Scale2D( const CVector2 scale )
 	{
 		e00 *= scale.x;
 		e01 *= scale.x;
@@ -950,7 +953,7 @@ public:
 	// Alter the scale of a 2D affine transformation matrix uniformly in the (local) X & Y
 	// directions. The effect is multiplicative, e.g Scale2D( 2.0f ) indicates a uniform doubling
 	// of the scale
-    void Scale2D( const TFloat32 fScale )
+    constexpr void Scale2D( const TFloat32 fScale )
 	{
 		e00 *= fScale;
 		e01 *= fScale;
@@ -965,7 +968,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 s, c;
-		SinCos( fAngle, &s, &c );
+		RotationSinCos( fAngle, &s, &c );
 		TFloat32 t;
 		t   = e00*s + e01*c;
 		e00 = e00*c - e01*s;
@@ -991,7 +994,7 @@ public:
 		TFloat32 scaleXY = Sqrt( scaleSqX ) * InvSqrt( scaleSqY );
 
 		TFloat32 s, c, sX, sY;
-		SinCos( fAngle, &s, &c );
+		RotationSinCos( fAngle, &s, &c );
 		sX = s * scaleXY;
 		sY = s / scaleXY;
 
@@ -1012,7 +1015,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 s, c;
-		SinCos( fAngle, &s, &c );
+		RotationSinCos( fAngle, &s, &c );
 		TFloat32 t;
 		t   = e00*c + e10*s;
 		e10 = e10*c - e00*s;
@@ -1249,6 +1252,17 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard matrices
+inline constexpr CMatrix3x3 CMatrix3x3::kIdentity(1.0f, 0.0f, 0.0f,
+                                       0.0f, 1.0f, 0.0f,
+                                       0.0f, 0.0f, 1.0f);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -1387,7 +1401,10 @@ CMatrix3x3 Inverse( const CMatrix3x3& m );
 //     CMatrix3x3 m = MatrixScaling( 3.0f ) * MatrixRotationX( ToRadians(45.0f) );
 
 // Return an identity matrix
-CMatrix3x3 Matrix3x3Identity();
+constexpr CMatrix3x3 Matrix3x3Identity()
+{
+	return CMatrix3x3::kIdentity;
+}
 
 
 // Return an X-axis rotation matrix of the given angle
@@ -1417,10 +1434,20 @@ CMatrix3x3 Matrix3x3Rotation
 
 
 // Return a matrix that is a scaling in X,Y and Z of the values provided in the given vector
-CMatrix3x3 Matrix3x3Scaling( const CVector3& scale );
+constexpr CMatrix3x3 Matrix3x3Scaling( const CVector3& scale )
+{
+	return CMatrix3x3( scale.x, 0.0f, 0.0f,
+	                   0.0f, scale.y, 0.0f,
+	                   0.0f, 0.0f, scale.z );
+}
 
 // Return a matrix that is a uniform scaling of the given amount
-CMatrix3x3 Matrix3x3Scaling( const TFloat32 fScale );
+constexpr CMatrix3x3 Matrix3x3Scaling( const TFloat32 fScale )
+{
+	return CMatrix3x3( fScale, 0.0f, 0.0f,
+	                   0.0f, fScale, 0.0f,
+	                   0.0f, 0.0f, fScale );
+}
 
 
 /*-----------------------------------------------------------------------------------------
@@ -1429,7 +1456,12 @@ CMatrix3x3 Matrix3x3Scaling( const TFloat32 fScale );
 // Same as class member functions, but these return a new matrix (by value) - see above
 
 // Return a matrix that is a 2D affine translation of the given vector
-CMatrix3x3 MatrixTranslation2D( const CVector2& translate );
+constexpr CMatrix3x3 MatrixTranslation2D( const CVector2& translate )
+{
+	return CMatrix3x3( 1.0f, 0.0f, 0.0f,
+	                   0.0f, 1.0f, 0.0f,
+	                   translate.x, translate.y, 1.0f );
+}
 
 
 // Return a matrix that is a 2D affine rotation of the given angle (radians)
@@ -1437,10 +1469,20 @@ CMatrix3x3 MatrixRotation2D( const TFloat32 fAngle );
 
 
 // Return a matrix that is a 2D affine scaling in X and Y by the values provided in the given vector
-CMatrix3x3 MatrixScaling2D( const CVector2& scale );
+constexpr CMatrix3x3 MatrixScaling2D( const CVector2& scale )
+{
+	return CMatrix3x3( scale.x, 0.0f, 0.0f,
+	                   0.0f, scale.y, 0.0f,
+	                   0.0f, 0.0f, 1.0f );
+}
 
 // Return a matrix that is a 2D affine uniform scaling of the given amount
-CMatrix3x3 MatrixScaling2D( const TFloat32 fScale );
+constexpr CMatrix3x3 MatrixScaling2D( const TFloat32 fScale )
+{
+	return CMatrix3x3( fScale, 0.0f, 0.0f,
+	                   0.0f, fScale, 0.0f,
+	                   0.0f, 0.0f, 1.0f );
+}
 
 
 /*-----------------------------------------------------------------------------------------
@@ -23,44 +23,102 @@
 #include "CMatrix2x2.h"
 #include "CMatrix3x3.h"
 #include "CQuaternion.h"
+#include "Parallel.h"
 
 namespace gen
 {
 
 /*-----------------------------------------------------------------------------------------
-	Constructors/Destructors
+	SIMD helpers
 -----------------------------------------------------------------------------------------*/
+// Multiplication, transformation, transpose and inverse load matrix rows into SIMD registers
+// (see MathSIMD.h), using the kernels in the header (see CMatrix4x4.h) and those below
 
-// Construct by value
-CMatrix4x4::CMatrix4x4
+// Return a row vector multiplied by the upper three rows of the matrix with the given rows,
+// i.e. a transformation of a vector with 4th element 0 (w element of the result is not used)
+static inline TFloat32x4 MultiplyRow3
 (
-	const TFloat32 elt00, const TFloat32 elt01, const TFloat32 elt02, const TFloat32 elt03,
-	const TFloat32 elt10, const TFloat32 elt11, const TFloat32 elt12, const TFloat32 elt13,
-	const TFloat32 elt20, const TFloat32 elt21, const TFloat32 elt22, const TFloat32 elt23,
-	const TFloat32 elt30, const TFloat32 elt31, const TFloat32 elt32, const TFloat32 elt33
+	const TFloat32x4  v,
+	const TFloat32x4* aRows
 )
 {
-	e00 = elt00;
-	e01 = elt01;
-	e02 = elt02;
-	e03 = elt03;
+	TFloat32x4 v01 = MulAdd4( SplatLane4<1>( v ), aRows[1], Mul4( SplatLane4<0>( v ), aRows[0] ) );
+	return MulAdd4( SplatLane4<2>( v ), aRows[2], v01 );
+}
 
-	e10 = elt10;
-	e11 = elt11;
-	e12 = elt12;
-	e13 = elt13;
+// Return the cross product of the x, y & z elements of two vectors, w element is 0
+static inline TFloat32x4 Cross3
+(
+	const TFloat32x4 v1,
+	const TFloat32x4 v2
+)
+{
+	return NegMulAdd4( Swizzle4<2, 0, 1, 3>( v1 ), Swizzle4<1, 2, 0, 3>( v2 ),
+	                   Mul4( Swizzle4<1, 2, 0, 3>( v1 ), Swizzle4<2, 0, 1, 3>( v2 ) ) );
+}
 
-	e20 = elt20;
-	e21 = elt21;
-	e22 = elt22;
-	e23 = elt23;
+// Multiply two affine matrices, result may be the same object as either input. The right column
+// of the result is only correct if both matrices are affine (as with the scalar code)
+static inline void MultiplyAffineMatrices
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2,
+	CMatrix4x4&       mOut
+)
+{
+	TFloat32x4 aM2Rows[4];
+	LoadMatrixRows( m2, aM2Rows );
+	TFloat32x4 aOut[4];
+	aOut[0] = MultiplyRow3( Load4( &m1.e00 ), aM2Rows );
+	aOut[1] = MultiplyRow3( Load4( &m1.e10 ), aM2Rows );
+	aOut[2] = MultiplyRow3( Load4( &m1.e20 ), aM2Rows );
+	aOut[3] = Add4( MultiplyRow3( Load4( &m1.e30 ), aM2Rows ), aM2Rows[3] );
+	StoreMatrixRows( mOut, aOut );
+}
 
-	e30 = elt30;
-	e31 = elt31;
-	e32 = elt32;
-	e33 = elt33;
+
+// The general inverse works on the four 2x2 sub-matrices of a 4x4 matrix, each held in one SIMD
+// register as (e00, e01, e10, e11). The adjugate of a 2x2 matrix A (written A#) is its inverse
+// multiplied by its determinant |A|, i.e. A# = (e11, -e01, -e10, e00)
+
+// Return 2x2 matrix product AB
+static inline TFloat32x4 Multiply2x2
+(
+	const TFloat32x4 a,
+	const TFloat32x4 b
+)
+{
+	return MulAdd4( Swizzle4<1, 0, 3, 2>( a ), Swizzle4<2, 1, 2, 1>( b ),
+	                Mul4( a, Swizzle4<0, 3, 0, 3>( b ) ) );
+}
+
+// Return 2x2 matrix product (A#)B
+static inline TFloat32x4 AdjugateMultiply2x2
+(
+	const TFloat32x4 a,
+	const TFloat32x4 b
+)
+{
+	return NegMulAdd4( Swizzle4<1, 1, 2, 2>( a ), Swizzle4<2, 3, 0, 1>( b ),
+	                   Mul4( Swizzle4<3, 3, 0, 0>( a ), b ) );
+}
+
+// Return 2x2 matrix product A(B#)
+static inline TFloat32x4 MultiplyAdjugate2x2
+(
+	const TFloat32x4 a,
+	const TFloat32x4 b
+)
+{
+	return NegMulAdd4( Swizzle4<1, 0, 3, 2>( a ), Swizzle4<2, 1, 2, 1>( b ),
+	                   Mul4( a, Swizzle4<3, 0, 3, 0>( b ) ) );
 }
 
+
+/*-----------------------------------------------------------------------------------------
+	Constructors/Destructors
+-----------------------------------------------------------------------------------------*/
+
 // Construct through pointer to 16 floats, may specify row/column order of data
 CMatrix4x4::CMatrix4x4
 (
@@ -233,32 +291,6 @@ CMatrix4x4::CMatrix4x4
 	}
 }
  
-// Construct affine transformation from position (translation) only
-CMatrix4x4::CMatrix4x4( const CVector3& position )
-{
-	// Take most elements from identity
-	e00 = 1.0f;
-	e01 = 0.0f;
-	e02 = 0.0f;
-	e03 = 0.0f;
-
-	e10 = 0.0f;
-	e11 = 1.0f;
-	e12 = 0.0f;
-	e13 = 0.0f;
-
-	e20 = 0.0f;
-	e21 = 0.0f;
-	e22 = 1.0f;
-	e23 = 0.0f;
-
-	// Put position (translation) in bottom row
-	e30 = position.x;
-	e31 = position.y;
-	e32 = position.z;
-	e33 = 1.0f;
-}
-
 // Construct affine transformation from position, Euler angles and optional scaling, with 
 // remaining elements taken from the identity matrix. May specify order to apply rotations
 // Matrix is effectively built in this order: M = Scale*Rotation*Translation
@@ -436,59 +468,6 @@ CMatrix4x4::CMatrix4x4
 }
 
 
-// Copy constructor
-CMatrix4x4::CMatrix4x4( const CMatrix4x4& m )
-{
-	e00 = m.e00;
-	e01 = m.e01;
-	e02 = m.e02;
-	e03 = m.e03;
-
-	e10 = m.e10;
-	e11 = m.e11;
-	e12 = m.e12;
-	e13 = m.e13;
-
-	e20 = m.e20;
-	e21 = m.e21;
-	e22 = m.e22;
-	e23 = m.e23;
-
-	e30 = m.e30;
-	e31 = m.e31;
-	e32 = m.e32;
-	e33 = m.e33;
-}
-
-// Assignment operator
-CMatrix4x4& CMatrix4x4::operator=( const CMatrix4x4& m )
-{
-	if ( this != &m )
-	{
-		e00 = m.e00;
-		e01 = m.e01;
-		e02 = m.e02;
-		e03 = m.e03;
-
-		e10 = m.e10;
-		e11 = m.e11;
-		e12 = m.e12;
-		e13 = m.e13;
-
-		e20 = m.e20;
-		e21 = m.e21;
-		e22 = m.e22;
-		e23 = m.e23;
-
-		e30 = m.e30;
-		e31 = m.e31;
-		e32 = m.e32;
-		e33 = m.e33;
-	}
-	return *this;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Setters
 -----------------------------------------------------------------------------------------*/
@@ -1652,67 +1631,6 @@ CMatrix4x4 Orthogonalise3x3
 	Inverse related
 -----------------------------------------------------------------------------------------*/
 
-// Set this matrix to its transpose (matrix reflected through its diagonal)
-// This is also the (most efficient) inverse for a rotation matrix
-void CMatrix4x4::Transpose()
-{
-	TFloat32 t;
-
-	t   = e01;
-	e01 = e10;
-	e10 = t;
-
-	t   = e02;
-	e02 = e20;
-	e20 = t;
-
-	t   = e12;
-	e12 = e21;
-	e21 = t;
-
-	t   = e03;
-	e03 = e30;
-	e30 = t;
-
-	t   = e13;
-	e13 = e31;
-	e31 = t;
-
-	t   = e23;
-	e23 = e32;
-	e32 = t;
-}
-    
-// Return the transpose of given matrix (matrix reflected through its diagonal)
-// This is also the (most efficient) inverse for a rotation matrix
-CMatrix4x4 Transpose( const CMatrix4x4& m )
-{
-	CMatrix4x4 transMat;
-
-	transMat.e00 = m.e00;
-	transMat.e01 = m.e10;
-	transMat.e02 = m.e20;
-	transMat.e03 = m.e30;
-
-	transMat.e10 = m.e01;
-	transMat.e11 = m.e11;
-	transMat.e12 = m.e21;
-	transMat.e13 = m.e31;
-
-	transMat.e20 = m.e02;
-	transMat.e21 = m.e12;
-	transMat.e22 = m.e22;
-	transMat.e23 = m.e32;
-
-	transMat.e30 = m.e03;
-	transMat.e31 = m.e13;
-	transMat.e32 = m.e23;
-	transMat.e33 = m.e33;
-
-	return transMat;
-}
-
-
 // Set this matrix to its inverse assuming it is affine with an orthogonal upper-left 3x3
 // matrix i.e. an affine transformation with no scaling or shear
 // Most efficient inverse for transformations containing rotation and translation only
@@ -1880,38 +1798,32 @@ CMatrix4x4 InverseAffine( const CMatrix4x4& m )
 
 	CMatrix4x4 mOut;
 
-	// Calculate determinant of upper left 3x3
-	TFloat32 det0 = m.e11*m.e22 - m.e12*m.e21;
-	TFloat32 det1 = m.e12*m.e20 - m.e10*m.e22;
-	TFloat32 det2 = m.e10*m.e21 - m.e11*m.e20;
-	TFloat32 det = m.e00*det0 + m.e01*det1 + m.e02*det2;
-	GEN_ASSERT( !IsZero(det), "Singular matrix" );
-
-	// Calculate inverse of upper left 3x3
-	TFloat32 invDet = 1.0f / det;
-	mOut.e00 = invDet * det0;
-	mOut.e10 = invDet * det1;
-	mOut.e20 = invDet * det2;
-		  
-	mOut.e01 = invDet * (m.e21*m.e02 - m.e22*m.e01);
-	mOut.e11 = invDet * (m.e22*m.e00 - m.e20*m.e02);
-	mOut.e21 = invDet * (m.e20*m.e01 - m.e21*m.e00);
-		  
-	mOut.e02 = invDet * (m.e01*m.e12 - m.e02*m.e11);
-	mOut.e12 = invDet * (m.e02*m.e10 - m.e00*m.e12);
-	mOut.e22 = invDet * (m.e00*m.e11 - m.e01*m.e10);
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
 
-	// Transform negative translation by inverted 3x3 to get inverse
-	mOut.e30 = -m.e30*mOut.e00 - m.e31*mOut.e10 - m.e32*mOut.e20;
-	mOut.e31 = -m.e30*mOut.e01 - m.e31*mOut.e11 - m.e32*mOut.e21;
-	mOut.e32 = -m.e30*mOut.e02 - m.e31*mOut.e12 - m.e32*mOut.e22;
+	// The columns of the inverse of the upper left 3x3 are the cross products of pairs of its
+	// rows, divided by its determinant. Cross products have w = 0, giving the right column
+	TFloat32x4 aInv[4];
+	aInv[0] = Cross3( aRows[1], aRows[2] );
+	aInv[1] = Cross3( aRows[2], aRows[0] );
+	aInv[2] = Cross3( aRows[0], aRows[1] );
+	aInv[3] = Zero4();
 
-	// Fill in right column for affine matrix
-	mOut.e03 = 0.0f;
-	mOut.e13 = 0.0f;
-	mOut.e23 = 0.0f;
-	mOut.e33 = 1.0f;
+	// Calculate determinant of upper left 3x3 (the w element of the cross product is 0)
+	TFloat32x4 det = HorizontalAdd4( Mul4( aRows[0], aInv[0] ) );
+	GEN_ASSERT( !IsZero(GetLane4<0>( det )), "Singular matrix" );
+
+	// Transpose columns to rows and divide by the determinant to get the inverse of upper left 3x3
+	Transpose4( aInv[0], aInv[1], aInv[2], aInv[3] );
+	TFloat32x4 invDet = Div4( Splat4( 1.0f ), det );
+	aInv[0] = Mul4( aInv[0], invDet );
+	aInv[1] = Mul4( aInv[1], invDet );
+	aInv[2] = Mul4( aInv[2], invDet );
+
+	// Transform negative translation by inverted 3x3 to get inverse, and put 1 in bottom-right
+	aInv[3] = Sub4( Set4( 0.0f, 0.0f, 0.0f, 1.0f ), MultiplyRow3( aRows[3], aInv ) );
 
+	StoreMatrixRows( mOut, aInv );
 	return mOut;
 
 	GEN_ENDGUARD;
@@ -1975,21 +1887,53 @@ CMatrix4x4 Inverse( const CMatrix4x4& m )
 
 	CMatrix4x4 mOut;
 
-	// Calculate determinant
-	TFloat32 det = m.e00 * Cofactor( m, 0, 0 ) + m.e01 * Cofactor( m, 0, 1 ) + 
-	               m.e02 * Cofactor( m, 0, 2 ) + m.e03 * Cofactor( m, 0, 3 ); 
-	GEN_ASSERT( !IsZero(det), "Singular matrix" );
-
-	// Inverse is (1/determinant)*adjoint matrix. Adjoint matrix is transposed matrix of cofactors
-	TFloat32 invDet = 1.0f / det;
-	for (TUInt32 i = 0; i < 4; ++i)
-	{
-		for (TUInt32 j = 0; j < 4; ++j)
-		{
-			mOut[i][j] = invDet * Cofactor( m, j, i );
-		}
-	}
+	// Inverse is (1/determinant)*adjoint matrix. Rather than calculating the cofactors one at a time
+	// the matrix is split into 2x2 sub-matrices:  M = | A B |  and the inverse found blockwise:
+	//                                                 | C D |
+	//     M^-1 = 1/|M| * | X# Y# |#   where X# = |D|A - B(D#C),   Y# = |B|C - D(A#B)#
+	//                    | Z# W# |          Z# = |C|B - A(D#C)#,  W# = |A|D - C(A#B)
+	//     |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	// See notes on 2x2 helper functions above for notation
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	TFloat32x4 A = Shuffle4<0, 1, 0, 1>( aRows[0], aRows[1] );
+	TFloat32x4 B = Shuffle4<2, 3, 2, 3>( aRows[0], aRows[1] );
+	TFloat32x4 C = Shuffle4<0, 1, 0, 1>( aRows[2], aRows[3] );
+	TFloat32x4 D = Shuffle4<2, 3, 2, 3>( aRows[2], aRows[3] );
+
+	// Determinants of the sub-matrices (|A|, |B|, |C|, |D|)
+	TFloat32x4 detSub = NegMulAdd4( Shuffle4<1, 3, 1, 3>( aRows[0], aRows[2] ), Shuffle4<0, 2, 0, 2>( aRows[1], aRows[3] ),
+	                                Mul4( Shuffle4<0, 2, 0, 2>( aRows[0], aRows[2] ), Shuffle4<1, 3, 1, 3>( aRows[1], aRows[3] ) ) );
+	TFloat32x4 detA = SplatLane4<0>( detSub );
+	TFloat32x4 detB = SplatLane4<1>( detSub );
+	TFloat32x4 detC = SplatLane4<2>( detSub );
+	TFloat32x4 detD = SplatLane4<3>( detSub );
+
+	TFloat32x4 adjDC = AdjugateMultiply2x2( D, C );
+	TFloat32x4 adjAB = AdjugateMultiply2x2( A, B );
+	TFloat32x4 adjX = Sub4( Mul4( detD, A ), Multiply2x2( B, adjDC ) );
+	TFloat32x4 adjW = Sub4( Mul4( detA, D ), Multiply2x2( C, adjAB ) );
+	TFloat32x4 adjY = Sub4( Mul4( detB, C ), MultiplyAdjugate2x2( D, adjAB ) );
+	TFloat32x4 adjZ = Sub4( Mul4( detC, B ), MultiplyAdjugate2x2( A, adjDC ) );
 
+	// Calculate determinant
+	TFloat32x4 det = MulAdd4( detB, detC, Mul4( detA, detD ) );
+	det = Sub4( det, HorizontalAdd4( Mul4( adjAB, Swizzle4<0, 2, 1, 3>( adjDC ) ) ) );
+	GEN_ASSERT( !IsZero(GetLane4<0>( det )), "Singular matrix" );
+
+	// Divide by determinant, including the signs of the 2x2 adjugates, which are applied along with
+	// rearranging the sub-matrices back into rows
+	TFloat32x4 invDet = Div4( Set4( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+	adjX = Mul4( adjX, invDet );
+	adjY = Mul4( adjY, invDet );
+	adjZ = Mul4( adjZ, invDet );
+	adjW = Mul4( adjW, invDet );
+	aRows[0] = Shuffle4<3, 1, 3, 1>( adjX, adjY );
+	aRows[1] = Shuffle4<2, 0, 2, 0>( adjX, adjY );
+	aRows[2] = Shuffle4<3, 1, 3, 1>( adjZ, adjW );
+	aRows[3] = Shuffle4<2, 0, 2, 0>( adjZ, adjW );
+
+	StoreMatrixRows( mOut, aRows );
 	return mOut;
 
 	GEN_ENDGUARD;
@@ -2052,7 +1996,7 @@ void CMatrix4x4::MakeTranslation( const CVector3& translate )
 void CMatrix4x4::MakeRotationX( const TFloat32 x )
 {
 	TFloat32 sX, cX;
-	SinCos( x, &sX, &cX );
+	RotationSinCos( x, &sX, &cX );
 
 	e00 = 1.0f;
 	e01 = 0.0f;
@@ -2079,7 +2023,7 @@ void CMatrix4x4::MakeRotationX( const TFloat32 x )
 void CMatrix4x4::MakeRotationY( const TFloat32 y )
 {
 	TFloat32 sY, cY;
-	SinCos( y, &sY, &cY );
+	RotationSinCos( y, &sY, &cY );
 
 	e00 = cY;
 	e01 = 0.0f;
@@ -2106,7 +2050,7 @@ void CMatrix4x4::MakeRotationY( const TFloat32 y )
 void CMatrix4x4::MakeRotationZ( const TFloat32 z )
 {
 	TFloat32 sZ, cZ;
-	SinCos( z, &sZ, &cZ );
+	RotationSinCos( z, &sZ, &cZ );
 
 	e00 = cZ;
 	e01 = sZ;
@@ -2140,9 +2084,9 @@ void CMatrix4x4::MakeRotation
 	GEN_GUARD;
 
 	TFloat32 sX, cX, sY, cY, sZ, cZ;
-	SinCos( angles.x, &sX, &cX );
-	SinCos( angles.y, &sY, &cY );
-	SinCos( angles.z, &sZ, &cZ );
+	RotationSinCos( angles.x, &sX, &cX );
+	RotationSinCos( angles.y, &sY, &cY );
+	RotationSinCos( angles.z, &sZ, &cZ );
 
 	switch (eRotOrder)
 	{
@@ -2272,7 +2216,7 @@ void CMatrix4x4::MakeRotation
 	GEN_GUARD;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 	TFloat32 t = 1.0f - c;
 
 	CVector3 axisNorm = Normalise( axis );
@@ -2367,62 +2311,6 @@ void CMatrix4x4::MakeScaling( const TFloat32 fScale )
 // as temporaries in calculations, e.g.
 //     CMatrix4x4 m = MatrixScaling( 3.0f ) * MatrixTranslation( CVector3(10.0f, -10.0f, 20.0f) );
 
-// Return an identity matrix - non-member function
-CMatrix4x4 MatrixIdentity()
-{
-	CMatrix4x4 m;
-
-	m.e00 = 1.0f;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f; 
-	m.e03 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = 1.0f;
-	m.e12 = 0.0f;
-	m.e13 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = 1.0f;
-	m.e23 = 0.0f;
-
-	m.e30 = 0.0f;
-	m.e31 = 0.0f;
-	m.e32 = 0.0f;
-	m.e33 = 1.0f;
-
-	return m;
-}
-
-// Return a translation matrix of the given vector - non-member function
-CMatrix4x4 MatrixTranslation( const CVector3& translate )
-{
-	CMatrix4x4 m;
-
-	m.e00 = 1.0f;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-	m.e03 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = 1.0f;
-	m.e12 = 0.0f;
-	m.e13 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = 1.0f;
-	m.e23 = 0.0f;
-
-	m.e30 = translate.x;
-	m.e31 = translate.y;
-	m.e32 = translate.z;
-	m.e33 = 1.0f;
-
-	return m;
-}
-
 
 // Return an X-axis rotation matrix of the given angle - non-member function
 CMatrix4x4 MatrixRotationX( const TFloat32 x )
@@ -2430,7 +2318,7 @@ CMatrix4x4 MatrixRotationX( const TFloat32 x )
 	CMatrix4x4 m;
 
 	TFloat32 sX, cX;
-	SinCos( x, &sX, &cX );
+	RotationSinCos( x, &sX, &cX );
 
 	m.e00 = 1.0f;
 	m.e01 = 0.0f;
@@ -2461,7 +2349,7 @@ CMatrix4x4 MatrixRotationY( const TFloat32 y )
 	CMatrix4x4 m;
 
 	TFloat32 sY, cY;
-	SinCos( y, &sY, &cY );
+	RotationSinCos( y, &sY, &cY );
 
 	m.e00 = cY;
 	m.e01 = 0.0f;
@@ -2492,7 +2380,7 @@ CMatrix4x4 MatrixRotationZ( const TFloat32 z )
 	CMatrix4x4 m;
 
 	TFloat32 sZ, cZ;
-	SinCos( z, &sZ, &cZ );
+	RotationSinCos( z, &sZ, &cZ );
 
 	m.e00 = cZ;
 	m.e01 = sZ;
@@ -2530,9 +2418,9 @@ CMatrix4x4 MatrixRotation
 	CMatrix4x4 m;
 
 	TFloat32 sX, cX, sY, cY, sZ, cZ;
-	SinCos( angles.x, &sX, &cX );
-	SinCos( angles.y, &sY, &cY );
-	SinCos( angles.z, &sZ, &cZ );
+	RotationSinCos( angles.x, &sX, &cX );
+	RotationSinCos( angles.y, &sY, &cY );
+	RotationSinCos( angles.z, &sZ, &cZ );
 
 	switch (eRotOrder)
 	{
@@ -2667,7 +2555,7 @@ CMatrix4x4 MatrixRotation
 	CMatrix4x4 m;
 
 	TFloat32 s, c;
-	SinCos( fAngle, &s, &c );
+	RotationSinCos( fAngle, &s, &c );
 	TFloat32 t = 1.0f - c;
 
 	CVector3 axisNorm = Normalise( axis );
@@ -2709,64 +2597,6 @@ CMatrix4x4 MatrixRotation
 }
 
 
-// Return a matrix that is a scaling in X,Y and Z of the values provided in the given vector
-// Non-member function
-CMatrix4x4 MatrixScaling( const CVector3& scale )
-{
-	CMatrix4x4 m;
-
-	m.e00 = scale.x;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-	m.e03 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = scale.y;
-	m.e12 = 0.0f;
-	m.e13 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = scale.z;
-	m.e23 = 0.0f;
-
-	m.e30 = 0.0f;
-	m.e31 = 0.0f;
-	m.e32 = 0.0f;
-	m.e33 = 1.0f;
-
-	return m;
-}
-
-// Return a matrix that is a uniform scaling of the given amount - non-member function
-CMatrix4x4 MatrixScaling( const TFloat32 fScale )
-{
-	CMatrix4x4 m;
-
-	m.e00 = fScale;
-	m.e01 = 0.0f;
-	m.e02 = 0.0f;
-	m.e03 = 0.0f;
-
-	m.e10 = 0.0f;
-	m.e11 = fScale;
-	m.e12 = 0.0f;
-	m.e13 = 0.0f;
-
-	m.e20 = 0.0f;
-	m.e21 = 0.0f;
-	m.e22 = fScale;
-	m.e23 = 0.0f;
-
-	m.e30 = 0.0f;
-	m.e31 = 0.0f;
-	m.e32 = 0.0f;
-	m.e33 = 1.0f;
-
-	return m;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Facing Matrices
 -----------------------------------------------------------------------------------------*/
@@ -3107,23 +2937,6 @@ CMatrix4x4 operator/
 ///////////////////////////////
 // Vector multiplication
 
-// Vector-matrix multiplication (order is important - this is usual order for transformation
-// for matrices stored as row vectors - see notes at top of header)
-CVector4 operator*
-(
-	const CVector4&   v,
-	const CMatrix4x4& m
-)
-{
-    CVector4 vOut;
-    vOut.x = v.x*m.e00 + v.y*m.e10 + v.z*m.e20 + v.w*m.e30;
-    vOut.y = v.x*m.e01 + v.y*m.e11 + v.z*m.e21 + v.w*m.e31;
-    vOut.z = v.x*m.e02 + v.y*m.e12 + v.z*m.e22 + v.w*m.e32;
-    vOut.w = v.x*m.e03 + v.y*m.e13 + v.z*m.e23 + v.w*m.e33;
-
-    return vOut;
-}
-
 // Matrix-vector multiplication (order is important - this is an unusual order for matrices
 // stored as row vectors - see notes at top of header)
 CVector4 operator*
@@ -3132,28 +2945,17 @@ CVector4 operator*
 	const CVector4&   v
 )
 {
-    CVector4 vOut;
-    vOut.x = m.e00*v.x + m.e01*v.y + m.e02*v.z + m.e03*v.w;
-    vOut.y = m.e10*v.x + m.e11*v.y + m.e12*v.z + m.e13*v.w;
-    vOut.z = m.e20*v.x + m.e21*v.y + m.e22*v.z + m.e23*v.w;
-    vOut.w = m.e30*v.x + m.e31*v.y + m.e32*v.z + m.e33*v.w;
-
-    return vOut;
-}
+	// Same as multiplying row vector by the transposed matrix
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	Transpose4( aRows[0], aRows[1], aRows[2], aRows[3] );
 
-
-// Return the given vector transformed by this matrix (pre-multiplication: V' = V*M)
-CVector4 CMatrix4x4::Transform(	const CVector4& v ) const
-{
 	CVector4 vOut;
-	vOut.x = v.x*e00 + v.y*e10 + v.z*e20 + v.w*e30;
-	vOut.y = v.x*e01 + v.y*e11 + v.z*e21 + v.w*e31;
-	vOut.z = v.x*e02 + v.y*e12 + v.z*e22 + v.w*e32;
-	vOut.w = v.x*e03 + v.y*e13 + v.z*e23 + v.w*e33;
-
+	Store4Unaligned( &vOut.x, MultiplyMatrixRow( Load4Unaligned( &v.x ), aRows ) );
 	return vOut;
 }
 
+
 // Return the given CVector3 transformed by this matrix (pre-multiplication: V' = V*M)
 // Assuming it is a vector rather then a point, i.e. assume the vector's 4th element is 0
 CVector3 CMatrix4x4::TransformVector( const CVector3& v ) const
@@ -3182,169 +2984,329 @@ CVector3 CMatrix4x4::TransformPoint( const CVector3& p ) const
 ///////////////////////////////
 // Matrix multiplication
 
-// Post-multiply this matrix by the given one
-CMatrix4x4& CMatrix4x4::operator*=( const CMatrix4x4& m )
+// Post-multiply this matrix by the given one assuming they are both affine
+CMatrix4x4& CMatrix4x4::MultiplyAffine( const CMatrix4x4& m )
 {
-	if ( this == &m )
-	{
-		// Special case of multiplying by self - no copy optimisations so use binary version
-		*this = m * m;
-	}
-	else
-	{
-		TFloat32 t0, t1, t2;
-
-		t0  = e00*m.e00 + e01*m.e10 + e02*m.e20 + e03*m.e30;
-		t1  = e00*m.e01 + e01*m.e11 + e02*m.e21 + e03*m.e31;
-		t2  = e00*m.e02 + e01*m.e12 + e02*m.e22 + e03*m.e32;
-		e03 = e00*m.e03 + e01*m.e13 + e02*m.e23 + e03*m.e33;
-		e00 = t0;
-		e01 = t1;
-		e02 = t2;
-
-		t0  = e10*m.e00 + e11*m.e10 + e12*m.e20 + e13*m.e30;
-		t1  = e10*m.e01 + e11*m.e11 + e12*m.e21 + e13*m.e31;
-		t2  = e10*m.e02 + e11*m.e12 + e12*m.e22 + e13*m.e32;
-		e13 = e10*m.e03 + e11*m.e13 + e12*m.e23 + e13*m.e33;
-		e10 = t0;
-		e11 = t1;
-		e12 = t2;
-
-		t0  = e20*m.e00 + e21*m.e10 + e22*m.e20 + e23*m.e30;
-		t1  = e20*m.e01 + e21*m.e11 + e22*m.e21 + e23*m.e31;
-		t2  = e20*m.e02 + e21*m.e12 + e22*m.e22 + e23*m.e32;
-		e23 = e20*m.e03 + e21*m.e13 + e22*m.e23 + e23*m.e33;
-		e20 = t0;
-		e21 = t1;
-		e22 = t2;
-
-		t0  = e30*m.e00 + e31*m.e10 + e32*m.e20 + e33*m.e30;
-		t1  = e30*m.e01 + e31*m.e11 + e32*m.e21 + e33*m.e31;
-		t2  = e30*m.e02 + e31*m.e12 + e32*m.e22 + e33*m.e32;
-		e33 = e30*m.e03 + e31*m.e13 + e32*m.e23 + e33*m.e33;
-		e30 = t0;
-		e31 = t1;
-		e32 = t2;
-	}
+	// All rows are loaded before any are stored, so multiplying by self needs no special case
+	MultiplyAffineMatrices( *this, m, *this );
 	return *this;
 }
 
-
-// Binary matrix-matrix multiplication - non-member version
-CMatrix4x4 operator*
+// Binary matrix-matrix multiplication assuming both matrices are affine - non-member version
+CMatrix4x4 MultiplyAffine
 (
 	const CMatrix4x4& m1,
 	const CMatrix4x4& m2
 )
 {
 	CMatrix4x4 mOut;
+	MultiplyAffineMatrices( m1, m2, mOut );
+	return mOut;
+}
 
-	mOut.e00 = m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20 + m1.e03*m2.e30;
-	mOut.e01 = m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21 + m1.e03*m2.e31;
-	mOut.e02 = m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22 + m1.e03*m2.e32;
-	mOut.e03 = m1.e00*m2.e03 + m1.e01*m2.e13 + m1.e02*m2.e23 + m1.e03*m2.e33;
 
-	mOut.e10 = m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20 + m1.e13*m2.e30;
-	mOut.e11 = m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21 + m1.e13*m2.e31;
-	mOut.e12 = m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22 + m1.e13*m2.e32;
-	mOut.e13 = m1.e10*m2.e03 + m1.e11*m2.e13 + m1.e12*m2.e23 + m1.e13*m2.e33;
+/*---------------------------------------------------------------------------------------------
+	Batch Transformation
+---------------------------------------------------------------------------------------------*/
+// Arrays of CVector3 are transformed four at a time in SoA form (x, y & z of four vectors in three
+// SIMD registers), each element multiplied by a matrix element splatted across a register. The
+// few vectors left over at the end are copied through a padded group of four
 
-	mOut.e20 = m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20 + m1.e23*m2.e30;
-	mOut.e21 = m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21 + m1.e23*m2.e31;
-	mOut.e22 = m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22 + m1.e23*m2.e32;
-	mOut.e23 = m1.e20*m2.e03 + m1.e21*m2.e13 + m1.e22*m2.e23 + m1.e23*m2.e33;
+// Fewest items worth giving each thread - starting a thread takes longer than transforming this
+// many vectors, and memory bandwidth limits the gains from threads on smaller batches
+const size_t kMinVectorsPerThread = 32768;
+const size_t kMinMatricesPerThread = 8192;
 
-	mOut.e30 = m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m1.e33*m2.e30;
-	mOut.e31 = m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m1.e33*m2.e31;
-	mOut.e32 = m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m1.e33*m2.e32;
-	mOut.e33 = m1.e30*m2.e03 + m1.e31*m2.e13 + m1.e32*m2.e23 + m1.e33*m2.e33;
+// Upper three rows of a matrix with each element splatted across a register (w element not used).
+// Row 3 is the translation, used only for points
+struct SSplatRows
+{
+	TFloat32x4 e[4][3];
+};
 
-	return mOut;
+// Splat the x, y & z elements of the given rows, each multiplied by a scale
+static void SplatRows
+(
+	const TFloat32x4* aRows,
+	const TFloat32    fScale,
+	SSplatRows&       splat
+)
+{
+	for (int row = 0; row < 4; ++row)
+	{
+		TFloat32x4 scaled = Mul4( aRows[row], Splat4( fScale ) );
+		splat.e[row][0] = SplatLane4<0>( scaled );
+		splat.e[row][1] = SplatLane4<1>( scaled );
+		splat.e[row][2] = SplatLane4<2>( scaled );
+	}
 }
 
-
-// Post-multiply this matrix by the given one assuming they are both affine
-CMatrix4x4& CMatrix4x4::MultiplyAffine( const CMatrix4x4& m )
+// Transform four consecutive CVector3s (12 floats) by the splatted matrix rows, as points (adding
+// row 3) or vectors, optionally normalising the results. Input and output may be the same
+template <bool IsPoint, bool Normalise>
+static inline void TransformGroup
+(
+	const SSplatRows& m,
+	const TFloat32*   pIn,
+	TFloat32*         pOut
+)
 {
-	if ( this == &m )
+	// Load as (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) and convert to SoA
+	TFloat32x4 a = Load4Unaligned( pIn );
+	TFloat32x4 b = Load4Unaligned( pIn + 4 );
+	TFloat32x4 c = Load4Unaligned( pIn + 8 );
+	TFloat32x4 ab = Shuffle4<1, 2, 0, 1>( a, b ); // y0 z0 y1 z1
+	TFloat32x4 bc = Shuffle4<2, 3, 0, 1>( b, c ); // x2 y2 z2 x3
+	TFloat32x4 x = Shuffle4<0, 3, 0, 3>( a, bc );
+	TFloat32x4 y = Shuffle4<0, 2, 1, 2>( ab, Shuffle4<3, 3, 2, 2>( b, c ) );
+	TFloat32x4 z = Shuffle4<1, 3, 0, 3>( ab, c );
+
+	TFloat32x4 xOut, yOut, zOut;
+	if (IsPoint)
 	{
-		// Special case of multiplying by self - no copy optimisations so use binary version
-		*this = gen::MultiplyAffine( m, m );
+		xOut = MulAdd4( x, m.e[0][0], m.e[3][0] );
+		yOut = MulAdd4( x, m.e[0][1], m.e[3][1] );
+		zOut = MulAdd4( x, m.e[0][2], m.e[3][2] );
 	}
 	else
 	{
-		TFloat32 t0, t1;
-
-		t0  = e00*m.e00 + e01*m.e10 + e02*m.e20;
-		t1  = e00*m.e01 + e01*m.e11 + e02*m.e21;
-		e02 = e00*m.e02 + e01*m.e12 + e02*m.e22;
-		e00 = t0;
-		e01 = t1;
-
-		t0  = e10*m.e00 + e11*m.e10 + e12*m.e20;
-		t1  = e10*m.e01 + e11*m.e11 + e12*m.e21;
-		e12 = e10*m.e02 + e11*m.e12 + e12*m.e22;
-		e10 = t0;
-		e11 = t1;
-
-		t0  = e20*m.e00 + e21*m.e10 + e22*m.e20;
-		t1  = e20*m.e01 + e21*m.e11 + e22*m.e21;
-		e22 = e20*m.e02 + e21*m.e12 + e22*m.e22;
-		e20 = t0;
-		e21 = t1;
-
-		t0  = e30*m.e00 + e31*m.e10 + e32*m.e20 + m.e30;
-		t1  = e30*m.e01 + e31*m.e11 + e32*m.e21 + m.e31;
-		e32 = e30*m.e02 + e31*m.e12 + e32*m.e22 + m.e32;
-		e30 = t0;
-		e31 = t1;
+		xOut = Mul4( x, m.e[0][0] );
+		yOut = Mul4( x, m.e[0][1] );
+		zOut = Mul4( x, m.e[0][2] );
 	}
+	xOut = MulAdd4( z, m.e[2][0], MulAdd4( y, m.e[1][0], xOut ) );
+	yOut = MulAdd4( z, m.e[2][1], MulAdd4( y, m.e[1][1], yOut ) );
+	zOut = MulAdd4( z, m.e[2][2], MulAdd4( y, m.e[1][2], zOut ) );
 
-	return *this;
+	if (Normalise)
+	{
+		// Zero-length vectors (as IsZero) become zero, as CVector3::Normalise. The reciprocal length
+		// is infinite for exactly zero, but is masked to zero before use
+		TFloat32x4 lengthSq = MulAdd4( zOut, zOut, MulAdd4( yOut, yOut, Mul4( xOut, xOut ) ) );
+		TFloat32x4 invLength = Div4( Splat4( 1.0f ), Sqrt4( lengthSq ) );
+		invLength = And4( invLength, GreaterEqual4( lengthSq, Splat4( kfEpsilon ) ) );
+		xOut = Mul4( xOut, invLength );
+		yOut = Mul4( yOut, invLength );
+		zOut = Mul4( zOut, invLength );
+	}
+
+	// Convert back to AoS, all input has been read so output can overwrite it
+	TFloat32x4 xy01 = Shuffle4<0, 1, 0, 1>( xOut, yOut ); // x0 x1 y0 y1
+	TFloat32x4 xy23 = Shuffle4<2, 3, 2, 3>( xOut, yOut ); // x2 x3 y2 y3
+	TFloat32x4 zx01 = Shuffle4<0, 0, 1, 1>( zOut, xOut ); // z0 z0 x1 x1
+	TFloat32x4 zx23 = Shuffle4<2, 2, 3, 3>( zOut, xOut ); // z2 z2 x3 x3
+	TFloat32x4 yz1  = Shuffle4<1, 1, 1, 1>( yOut, zOut ); // y1 y1 z1 z1
+	TFloat32x4 yz3  = Shuffle4<3, 3, 3, 3>( yOut, zOut ); // y3 y3 z3 z3
+	Store4Unaligned( pOut,     Shuffle4<0, 2, 0, 2>( xy01, zx01 ) );
+	Store4Unaligned( pOut + 4, Shuffle4<0, 2, 0, 2>( yz1, xy23 ) );
+	Store4Unaligned( pOut + 8, Shuffle4<0, 2, 0, 2>( zx23, yz3 ) );
+}
+
+// Transform a range of an array of CVector3s by the splatted matrix rows
+template <bool IsPoint, bool Normalise>
+static void TransformRange
+(
+	const SSplatRows& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      begin,
+	const size_t      end
+)
+{
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		TransformGroup<IsPoint, Normalise>( m, &aIn[i].x, &aOut[i].x );
+	}
+	if (i < end)
+	{
+		CVector3 aGroup[4] = { CVector3::kZero, CVector3::kZero, CVector3::kZero, CVector3::kZero };
+		for (size_t j = i; j < end; ++j)  aGroup[j - i] = aIn[j];
+		TransformGroup<IsPoint, Normalise>( m, &aGroup[0].x, &aGroup[0].x );
+		for (size_t j = i; j < end; ++j)  aOut[j] = aGroup[j - i];
+	}
 }
 
-// Binary matrix-matrix multiplication assuming both matrices are affine - non-member version
-CMatrix4x4 MultiplyAffine
+// Transform an array of CVector3s by the splatted matrix rows, split over threads
+template <bool IsPoint, bool Normalise>
+static void TransformArray
 (
-	const CMatrix4x4& m1,
-	const CMatrix4x4& m2
+	const SSplatRows& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numVectors,
+	const TUInt32     numThreads
 )
 {
-	CMatrix4x4 mOut;
+	ParallelRanges( numVectors, kMinVectorsPerThread, numThreads, [&]( size_t begin, size_t end )
+	{
+		TransformRange<IsPoint, Normalise>( m, aIn, aOut, begin, end );
+	} );
+}
 
-	mOut.e00 = m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20;
-	mOut.e01 = m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21;
-	mOut.e02 = m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22;
-	mOut.e03 = 0.0f;
 
-	mOut.e10 = m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20;
-	mOut.e11 = m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21;
-	mOut.e12 = m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22;
-	mOut.e13 = 0.0f;
+// Transform an array of points by the given matrix (pre-multiplication, 4th element 1, as
+// TransformPoint)
+void TransformPoints
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numPoints,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	SSplatRows splat;
+	SplatRows( aRows, 1.0f, splat );
+	TransformArray<true, false>( splat, aIn, aOut, numPoints, numThreads );
+}
 
-	mOut.e20 = m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20;
-	mOut.e21 = m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21;
-	mOut.e22 = m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22;
-	mOut.e23 = 0.0f;
+// Transform an array of vectors by the given matrix (pre-multiplication, 4th element 0, as
+// TransformVector)
+void TransformVectors
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numVectors,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	SSplatRows splat;
+	SplatRows( aRows, 1.0f, splat );
+	TransformArray<false, false>( splat, aIn, aOut, numVectors, numThreads );
+}
 
-	mOut.e30 = m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m2.e30;
-	mOut.e31 = m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m2.e31;
-	mOut.e32 = m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m2.e32;
-	mOut.e33 = 1.0f;
+// Transform an array of normals for geometry transformed by the given matrix, i.e. by the inverse
+// transpose of its upper-left 3x3 matrix. Results are normalised unless bNormalise is false
+void TransformNormals
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numNormals,
+	const bool        bNormalise /*= true*/,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	GEN_GUARD;
 
-	return mOut;
+	// The inverse transpose of a 3x3 matrix with rows r0, r1 & r2 has rows (r1 x r2), (r2 x r0) &
+	// (r0 x r1) divided by the determinant. Normalised results only need the sign of the determinant
+	// (negative for mirroring transforms, which would otherwise flip normals)
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	TFloat32x4 aCofactorRows[4];
+	aCofactorRows[0] = Cross3( aRows[1], aRows[2] );
+	aCofactorRows[1] = Cross3( aRows[2], aRows[0] );
+	aCofactorRows[2] = Cross3( aRows[0], aRows[1] );
+	aCofactorRows[3] = Zero4();
+	TFloat32 det = GetLane4<0>( HorizontalAdd4( Mul4( aRows[0], aCofactorRows[0] ) ) );
+
+	SSplatRows splat;
+	if (bNormalise)
+	{
+		SplatRows( aCofactorRows, (det < 0.0f) ? -1.0f : 1.0f, splat );
+		TransformArray<false, true>( splat, aIn, aOut, numNormals, numThreads );
+	}
+	else
+	{
+		GEN_ASSERT( !IsZero( det ), "Singular matrix" );
+		SplatRows( aCofactorRows, 1.0f / det, splat );
+		TransformArray<false, false>( splat, aIn, aOut, numNormals, numThreads );
+	}
+
+	GEN_ENDGUARD;
 }
 
+// Transform an array of tangents (or bitangents) by the upper-left 3x3 matrix of the given matrix,
+// results are normalised unless bNormalise is false
+void TransformTangents
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numTangents,
+	const bool        bNormalise /*= true*/,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	SSplatRows splat;
+	SplatRows( aRows, 1.0f, splat );
+	if (bNormalise)
+	{
+		TransformArray<false, true>( splat, aIn, aOut, numTangents, numThreads );
+	}
+	else
+	{
+		TransformArray<false, false>( splat, aIn, aOut, numTangents, numThreads );
+	}
+}
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
+// Transform an array of 4-element vectors by the given matrix (pre-multiplication, as Transform)
+void Transform
+(
+	const CMatrix4x4& m,
+	const CVector4*   aIn,
+	CVector4*         aOut,
+	const size_t      numVectors,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	ParallelRanges( numVectors, kMinVectorsPerThread, numThreads, [&]( size_t begin, size_t end )
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			Store4Unaligned( &aOut[i].x, MultiplyMatrixRow( Load4Unaligned( &aIn[i].x ), aRows ) );
+		}
+	} );
+}
+
+// Multiply each matrix in an array by the given matrix: aOut[i] = aIn[i] * m
+void TransformMatrices
+(
+	const CMatrix4x4& m,
+	const CMatrix4x4* aIn,
+	CMatrix4x4*       aOut,
+	const size_t      numMatrices,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	ParallelRanges( numMatrices, kMinMatricesPerThread, numThreads, [&]( size_t begin, size_t end )
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			MultiplyMatrices( aIn[i], m, aOut[i] );
+		}
+	} );
+}
 
-// Standard matrices
-const CMatrix4x4 CMatrix4x4::kIdentity(1.0f, 0.0f, 0.0f, 0.0f,
-                                       0.0f, 1.0f, 0.0f, 0.0f,
-                                       0.0f, 0.0f, 1.0f, 0.0f,
-                                       0.0f, 0.0f, 0.0f, 1.0f);
+// Multiply matrices from two arrays in pairs: aOut[i] = am1[i] * am2[i]
+void MultiplyMatrices
+(
+	const CMatrix4x4* am1,
+	const CMatrix4x4* am2,
+	CMatrix4x4*       aOut,
+	const size_t      numMatrices,
+	const TUInt32     numThreads /*= 1*/
+)
+{
+	ParallelRanges( numMatrices, kMinMatricesPerThread, numThreads, [&]( size_t begin, size_t end )
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			MultiplyMatrices( am1[i], am2[i], aOut[i] );
+		}
+	} );
+}
 
 
 } // namespace gen
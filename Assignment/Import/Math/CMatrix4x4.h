@@ -48,28 +48,35 @@
 // - As the matrix is stored in rows, the [] operator is provided to returns CVector4/CVector3
 //   references to the actual matrix data. This is highly convenient/efficient but non-portable,
 //   i.e. the [] operator is not guaranteed to work on all compilers (though it will on most)
+// - Matrices are 16-byte aligned so each row can be loaded into a SIMD register (see MathSIMD.h),
+//   which is used for multiplication, transformation, transpose and inverse. Containers of
+//   matrices (or of types containing them) should use CAlignedAllocator (see AlignedAllocator.h)
 
 #ifndef GEN_C_MATRIX_4X4_H_INCLUDED
 #define GEN_C_MATRIX_4X4_H_INCLUDED
 
 #include "GenDefines.h"
+#include "AlignedAllocator.h"
 #include "BaseMath.h"
+#include "MathSIMD.h"
+#include "FastMath.h"
 #include "CVector2.h"
 #include "CVector3.h"
+#include "CVector4.h"
 
 namespace gen
 {
 
 // Forward declaration of classes, where includes are only possible/necessary in the .cpp file
-class CVector4;
 class CMatrix2x2;
 class CMatrix3x3;
 class CQuaternion;
 
 
-class CMatrix4x4
+class GEN_ALIGN(16) CMatrix4x4
 {
 	GEN_CLASS( CMatrix4x4 );
+	GEN_ALIGNED_NEW( 16 );
 
 // Concrete class - public access
 public:
@@ -82,13 +89,17 @@ public:
 	CMatrix4x4() {}
 
 	// Construct by value
-	CMatrix4x4
+	constexpr CMatrix4x4
 	(
 		const TFloat32 elt00, const TFloat32 elt01, const TFloat32 elt02, const TFloat32 elt03,
 		const TFloat32 elt10, const TFloat32 elt11, const TFloat32 elt12, const TFloat32 elt13,
 		const TFloat32 elt20, const TFloat32 elt21, const TFloat32 elt22, const TFloat32 elt23,
 		const TFloat32 elt30, const TFloat32 elt31, const TFloat32 elt32, const TFloat32 elt33
-	);
+	) : e00( elt00 ), e01( elt01 ), e02( elt02 ), e03( elt03 ),
+	    e10( elt10 ), e11( elt11 ), e12( elt12 ), e13( elt13 ),
+	    e20( elt20 ), e21( elt21 ), e22( elt22 ), e23( elt23 ),
+	    e30( elt30 ), e31( elt31 ), e32( elt32 ), e33( elt33 )
+	{}
 
 	// Construct through pointer to 16 floats, may specify row/column order of data
 	explicit CMatrix4x4
@@ -123,7 +134,12 @@ public:
 
 
 	// Construct affine transformation from position (translation) only
-	explicit CMatrix4x4( const CVector3& position );
+	constexpr explicit CMatrix4x4( const CVector3& position )
+	  : e00( 1.0f ),       e01( 0.0f ),       e02( 0.0f ),       e03( 0.0f ),
+	    e10( 0.0f ),       e11( 1.0f ),       e12( 0.0f ),       e13( 0.0f ),
+	    e20( 0.0f ),       e21( 0.0f ),       e22( 1.0f ),       e23( 0.0f ),
+	    e30( position.x ), e31( position.y ), e32( position.z ), e33( 1.0f )
+	{}
 	// Require explicit conversion from position only (see above)
 
 	// Construct affine transformation from position, Euler angles and optional scaling, with 
@@ -179,11 +195,10 @@ public:
 	// Require explicit conversion from CMatrix3x3 (see above)
 
 
-	// Copy constructor
-    CMatrix4x4( const CMatrix4x4& m );
-
-	// Assignment operator
-    CMatrix4x4& operator=( const CMatrix4x4& m );
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CMatrix4x4( const CMatrix4x4& m ) = default;
+	CMatrix4x4& operator=( const CMatrix4x4& m ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -453,7 +468,7 @@ public:
 
 	// Get the position (translation) of an affine transformation matrix. Similar to GetRow( 3 ),
 	// but returning CVector3. Use of Position() function may be more efficient, but non-portable
-	CVector3 GetPosition() const
+	constexpr CVector3 GetPosition() const
 	{
 		return CVector3(e30, e31, e32);
 	}
@@ -461,7 +476,7 @@ public:
 	// Set the position (translation) of an affine transformation matrix. Will not change other
 	// components of the transformation (rotation, scale etc.). Same as SetRow( 3, p ). Use of
 	// Position() function may be more efficient, but non-portable
-	void SetPosition( const CVector3& p )
+	constexpr void SetPosition( const CVector3& p )
 	{
 		e30 = p.x;
 		e31 = p.y;
@@ -469,45 +484,45 @@ public:
 	}
 
 	// Return X position (translation) of an affine transformation matrix
-	TFloat32 GetX() const 
+	constexpr TFloat32 GetX() const 
 	{
 		return e30;
 	}
 
 	// Return Y position (translation) of an affine transformation matrix
-	TFloat32 GetY() const
+	constexpr TFloat32 GetY() const
 	{
 		return e31;
 	}
 
 	// Return Z position (translation) of an affine transformation matrix
-	TFloat32 GetZ() const
+	constexpr TFloat32 GetZ() const
 	{
 		return e32;
 	}
 
 
 	// Set X position (translation) of an affine transformation matrix
-	void SetX( const TFloat32 x )
+	constexpr void SetX( const TFloat32 x )
 	{
 		e30 = x;
 	}
 
 	// Set Y position (translation) of an affine transformation matrix
-	void SetY( const TFloat32 y )
+	constexpr void SetY( const TFloat32 y )
 	{
 		e31 = y;
 	}
 
 	// Set Z position (translation) of an affine transformation matrix
-	void SetZ( const TFloat32 z )
+	constexpr void SetZ( const TFloat32 z )
 	{
 		e32 = z;
 	}
 
 
 	// Move position (translation) of an affine transformation matrix by the given vector
-	void Move( const CVector3 v ) 
+	constexpr void Move( const CVector3 v ) 
 	{
 		e30 += v.x;
 		e31 += v.y;
@@ -515,19 +530,19 @@ public:
 	}
 
 	// Move X position (translation) of an affine transformation matrix
-	void MoveX( const TFloat32 x )
+	constexpr void MoveX( const TFloat32 x )
 	{
 		e30 += x;
 	}
 
 	// Move Y position (translation) of an affine transformation matrix
-	void MoveY( const TFloat32 y )
+	constexpr void MoveY( const TFloat32 y )
 	{
 		e31 += y;
 	}
 
 	// Move Z position (translation) of an affine transformation matrix
-	void MoveZ( const TFloat32 z )  
+	constexpr void MoveZ( const TFloat32 z )  
 	{
 		e32 += z;
 	}
@@ -550,7 +565,7 @@ public:
 	// local coordinate space. Will move relative to the matrix's scaling, i.e. matrix will move 
 	// v.x * x-scaling units in x, and similarly in y & z. More efficient than MoveLocal if the 
 	// matrix is unscaled
-	void MoveLocalWithScaling( const CVector3 v ) 
+	constexpr void MoveLocalWithScaling( const CVector3 v ) 
 	{
 		e30 += v.x * e00 + v.y * e10 + v.z * e20;
 		e31 += v.x * e01 + v.y * e11 + v.z * e21;
@@ -571,7 +586,7 @@ public:
 	// Move X position (translation) of an affine transformation matrix along X axis of the matrix
 	// Will move relative to the matrix's x-scaling, i.e. will move x * x-scale units
 	// More efficient than MoveLocalX if matrix is unscaled
-	void MoveLocalXWithScaling( const TFloat32 x ) 
+	constexpr void MoveLocalXWithScaling( const TFloat32 x ) 
 	{
 		e30 += x * e00;
 		e31 += x * e01;
@@ -592,7 +607,7 @@ public:
 	// Move Y position (translation) of an affine transformation matrix along Y axis of the matrix
 	// Will move relative to the matrix's y-scaling, i.e. will move y * y-scale units
 	// More efficient than MoveLocalY if matrix is unscaled
-	void MoveLocalYWithScaling( const TFloat32 y ) 
+	constexpr void MoveLocalYWithScaling( const TFloat32 y ) 
 	{
 		e30 += y * e10;
 		e31 += y * e11;
@@ -613,7 +628,7 @@ public:
 	// Move Z position (translation) of an affine transformation matrix along Z axis of the matrix
 	// Will move relative to the matrix's z-scaling, i.e. will move z * z-scale units
 	// More efficient than MoveLocalZ if matrix is unscaled
-	void MoveLocalZWithScaling( const TFloat32 z ) 
+	constexpr void MoveLocalZWithScaling( const TFloat32 z ) 
 	{
 		e30 += z * e20;
 		e31 += z * e21;
@@ -666,7 +681,7 @@ public:
 
 	// Alter the scale of an affine transformation matrix in the (local) X direction. The effect is
 	// multiplicative, e.g ScaleX( 2.0f ) indicates a doubling of the X scale
-    void ScaleX( const TFloat32 x )
+    constexpr void ScaleX( const TFloat32 x )
 	{
 		e00 *= x;
 		e01 *= x;
@@ -675,7 +690,7 @@ public:
 
 	// Alter the scale of an affine transformation matrix in the (local) Y direction. The effect is
 	// multiplicative, e.g ScaleY( 2.0f ) indicates a doubling of the Y scale
-    void ScaleY( const TFloat32 y )
+    constexpr void ScaleY( const TFloat32 y )
 	{
 		e10 *= y;
 		e11 *= y;
@@ -684,7 +699,7 @@ public:
 
 	// Alter the scale of an affine transformation matrix in the (local) Z direction. The effect is
 	// multiplicative, e.g ScaleZ( 2.0f ) indicates a doubling of the Z scale
-    void ScaleZ( const TFloat32 z )
+    constexpr void ScaleZ( const TFloat32 z )
 	{
 		e20 *= z;
 		e21 *= z;
@@ -694,7 +709,7 @@ public:
 	// Alter the scale of an affine transformation matrix in the (local) X, Y & Z directions. The
 	// effect is multiplicative, e.g Scale( CVector3(2.0f, 2.0f, 2.0f) ) indicates a doubling of
 	// the scale in all directions
-    void Scale( const CVector3 scale )
+    constexpr void Scale( const CVector3 scale )
 	{
 		e00 *= scale.x;
 		e01 *= scale.x;
@@ -712,7 +727,7 @@ public:
 	// Alter the scale of an affine transformation matrix uniformly in the (local) X, Y & Z
 	// directions. The effect is multiplicative, e.g Scale( 2.0f ) indicates a uniform doubling of
 	// the scale
-    void Scale( const TFloat32 fScale )
+    constexpr void Scale( const TFloat32 fScale )
 	{
 		e00 *= fScale;
 		e01 *= fScale;
@@ -735,7 +750,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sX, cX;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		TFloat32 t;
 		t   = e01*sX + e02*cX;
 		e01 = e01*cX - e02*sX;
@@ -758,7 +773,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sY, cY;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		TFloat32 t;
 		t   = e00*cY + e02*sY;
 		e02 = e02*cY - e00*sY;
@@ -781,7 +796,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sZ, cZ;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		TFloat32 t;
 		t   = e00*sZ + e01*cZ;
 		e00 = e00*cZ - e01*sZ;
@@ -805,7 +820,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sX, cX;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		TFloat32 t;
 		t   = e01*sX + e02*cX;
 		e01 = e01*cX - e02*sX;
@@ -825,7 +840,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sY, cY;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		TFloat32 t;
 		t   = e00*cY + e02*sY;
 		e02 = e02*cY - e00*sY;
@@ -845,7 +860,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sZ, cZ;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		TFloat32 t;
 		t   = e00*sZ + e01*cZ;
 		e00 = e00*cZ - e01*sZ;
@@ -872,7 +887,7 @@ public:
 		TFloat32 scaleYZ = Sqrt( scaleSqY ) * InvSqrt( scaleSqZ );
 
 		TFloat32 sX, cX, sXY, sXZ;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		sXY = sX * scaleYZ;
 		sXZ = sX / scaleYZ;
 
@@ -897,7 +912,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sX, cX;
-		SinCos( x, &sX, &cX );
+		RotationSinCos( x, &sX, &cX );
 		TFloat32 t;
 		t   = e10*cX + e20*sX;
 		e20 = e20*cX - e10*sX;
@@ -923,7 +938,7 @@ public:
 		TFloat32 scaleZX = Sqrt( scaleSqZ ) * InvSqrt( scaleSqX );
 
 		TFloat32 sY, cY, sYZ, sYX;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		sYZ = sY * scaleZX;
 		sYX = sY / scaleZX;
 
@@ -947,7 +962,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sY, cY;
-		SinCos( y, &sY, &cY );
+		RotationSinCos( y, &sY, &cY );
 		TFloat32 t;
 		t   = e20*cY + e00*sY;
 		e00 = e00*cY - e20*sY;
@@ -973,7 +988,7 @@ public:
 		TFloat32 scaleXY = Sqrt( scaleSqX ) * InvSqrt( scaleSqY );
 
 		TFloat32 sZ, cZ, sZX, sZY;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		sZX = sZ * scaleXY;
 		sZY = sZ / scaleXY;
 
@@ -997,7 +1012,7 @@ public:
 	{
 		// Perform minimum of calculations rather than use full matrix multiply
 		TFloat32 sZ, cZ;
-		SinCos( z, &sZ, &cZ );
+		RotationSinCos( z, &sZ, &cZ );
 		TFloat32 t;
 		t   = e00*cZ + e10*sZ;
 		e10 = e10*cZ - e00*sZ;
@@ -1212,6 +1227,174 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard matrices
+inline constexpr CMatrix4x4 CMatrix4x4::kIdentity(1.0f, 0.0f, 0.0f, 0.0f,
+                                       0.0f, 1.0f, 0.0f, 0.0f,
+                                       0.0f, 0.0f, 1.0f, 0.0f,
+                                       0.0f, 0.0f, 0.0f, 1.0f);
+
+
+/*-----------------------------------------------------------------------------------------
+	SIMD kernels
+-----------------------------------------------------------------------------------------*/
+// Multiplication, vector transformation and transpose are only a few SIMD instructions, fewer
+// than the cost of a call and of passing the result back through memory, so they are defined
+// here to be inlined wherever they are used. CMatrix4x4.cpp builds the other operations from
+// the same kernels. Matrices are 16-byte aligned, vectors are not
+
+// Load the four rows of a matrix
+inline void LoadMatrixRows
+(
+	const CMatrix4x4& m,
+	TFloat32x4*       aRows
+)
+{
+	aRows[0] = Load4( &m.e00 );
+	aRows[1] = Load4( &m.e10 );
+	aRows[2] = Load4( &m.e20 );
+	aRows[3] = Load4( &m.e30 );
+}
+
+// Store four rows to a matrix
+inline void StoreMatrixRows
+(
+	CMatrix4x4&       m,
+	const TFloat32x4* aRows
+)
+{
+	Store4( &m.e00, aRows[0] );
+	Store4( &m.e10, aRows[1] );
+	Store4( &m.e20, aRows[2] );
+	Store4( &m.e30, aRows[3] );
+}
+
+// Return a row vector multiplied by the matrix with the given rows (V' = V*M). Sums the products
+// in two independent pairs so they can execute in parallel
+inline TFloat32x4 MultiplyMatrixRow
+(
+	const TFloat32x4  v,
+	const TFloat32x4* aRows
+)
+{
+	TFloat32x4 v01 = MulAdd4( SplatLane4<1>( v ), aRows[1], Mul4( SplatLane4<0>( v ), aRows[0] ) );
+	TFloat32x4 v23 = MulAdd4( SplatLane4<3>( v ), aRows[3], Mul4( SplatLane4<2>( v ), aRows[2] ) );
+	return Add4( v01, v23 );
+}
+
+// Multiply two matrices into a third (mOut = m1 * m2), which may be the same object as either input
+inline void MultiplyMatrices
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2,
+	CMatrix4x4&       mOut
+)
+{
+#if defined(GEN_SIMD_AVX)
+	// Process two rows of m1 at once in 256-bit registers, each half of the register multiplying one
+	// row of m1 by the rows of m2 (which are copied into both halves). Rows are loaded and stored
+	// 128 bits at a time - a 256-bit access to a matrix just written or about to be read by 128-bit
+	// accesses (as the rest of the class uses) stalls on store forwarding
+	__m256 m2Row0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e00) );
+	__m256 m2Row1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e10) );
+	__m256 m2Row2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e20) );
+	__m256 m2Row3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e30) );
+	__m256 m1Rows01 = _mm256_insertf128_ps( _mm256_castps128_ps256( Load4( &m1.e00 ) ), Load4( &m1.e10 ), 1 );
+	__m256 m1Rows23 = _mm256_insertf128_ps( _mm256_castps128_ps256( Load4( &m1.e20 ) ), Load4( &m1.e30 ), 1 );
+	__m256 aOut[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		__m256 m1Rows = (i == 0) ? m1Rows01 : m1Rows23;
+		__m256 out01 = _mm256_mul_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0x00 ), m2Row0 );
+		__m256 out23 = _mm256_mul_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0xaa ), m2Row2 );
+	#if defined(GEN_SIMD_FMA)
+		out01 = _mm256_fmadd_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0x55 ), m2Row1, out01 );
+		out23 = _mm256_fmadd_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0xff ), m2Row3, out23 );
+	#else
+		out01 = _mm256_add_ps( out01, _mm256_mul_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0x55 ), m2Row1 ) );
+		out23 = _mm256_add_ps( out23, _mm256_mul_ps( _mm256_shuffle_ps( m1Rows, m1Rows, 0xff ), m2Row3 ) );
+	#endif
+		aOut[i] = _mm256_add_ps( out01, out23 );
+	}
+	Store4( &mOut.e00, _mm256_castps256_ps128( aOut[0] ) );
+	Store4( &mOut.e10, _mm256_extractf128_ps( aOut[0], 1 ) );
+	Store4( &mOut.e20, _mm256_castps256_ps128( aOut[1] ) );
+	Store4( &mOut.e30, _mm256_extractf128_ps( aOut[1], 1 ) );
+#else
+	// Each output row is stored as soon as it is calculated, so only one row of m1 is in registers
+	// at a time. The output row only depends on the same row of m1, and all rows of m2 are loaded
+	// first, so the output can still be either input
+	TFloat32x4 aM2Rows[4];
+	LoadMatrixRows( m2, aM2Rows );
+	Store4( &mOut.e00, MultiplyMatrixRow( Load4( &m1.e00 ), aM2Rows ) );
+	Store4( &mOut.e10, MultiplyMatrixRow( Load4( &m1.e10 ), aM2Rows ) );
+	Store4( &mOut.e20, MultiplyMatrixRow( Load4( &m1.e20 ), aM2Rows ) );
+	Store4( &mOut.e30, MultiplyMatrixRow( Load4( &m1.e30 ), aM2Rows ) );
+#endif
+}
+
+// Transpose a matrix into another (mOut = transpose of m), which may be the same object
+inline void TransposeMatrix
+(
+	const CMatrix4x4& m,
+	CMatrix4x4&       mOut
+)
+{
+#if defined(GEN_SIMD_AVX2)
+	// Rows 0 & 2 and rows 1 & 3 are paired in 256-bit registers, so one interleave of the pairs gives
+	// (x0 x1 y0 y1 | x2 x3 y2 y3) and another the z and w elements, and a lane-crossing permute
+	// puts each in row order. Four shuffles rather than eight for the 128-bit transpose. The rows are
+	// loaded 128 bits at a time to read a matrix just written that way without a store forwarding
+	// stall, but stored as 256 bits - a later 128-bit read of half of a 256-bit store is forwarded
+	__m256 rows02 = _mm256_insertf128_ps( _mm256_castps128_ps256( Load4( &m.e00 ) ), Load4( &m.e20 ), 1 );
+	__m256 rows13 = _mm256_insertf128_ps( _mm256_castps128_ps256( Load4( &m.e10 ) ), Load4( &m.e30 ), 1 );
+	const __m256i order = _mm256_setr_epi32( 0, 1, 4, 5, 2, 3, 6, 7 );
+	__m256 cols01 = _mm256_permutevar8x32_ps( _mm256_unpacklo_ps( rows02, rows13 ), order );
+	__m256 cols23 = _mm256_permutevar8x32_ps( _mm256_unpackhi_ps( rows02, rows13 ), order );
+	_mm256_storeu_ps( &mOut.e00, cols01 );
+	_mm256_storeu_ps( &mOut.e20, cols23 );
+#else
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( m, aRows );
+	Transpose4( aRows[0], aRows[1], aRows[2], aRows[3] );
+	StoreMatrixRows( mOut, aRows );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Inline Member Functions
+-----------------------------------------------------------------------------------------*/
+
+// Return the given vector transformed by this matrix (pre-multiplication: V' = V*M)
+inline CVector4 CMatrix4x4::Transform( const CVector4& v ) const
+{
+	TFloat32x4 aRows[4];
+	LoadMatrixRows( *this, aRows );
+
+	CVector4 vOut;
+	Store4Unaligned( &vOut.x, MultiplyMatrixRow( Load4Unaligned( &v.x ), aRows ) );
+	return vOut;
+}
+
+// Post-multiply this matrix by the given one
+inline CMatrix4x4& CMatrix4x4::operator*=( const CMatrix4x4& m )
+{
+	MultiplyMatrices( *this, m, *this );
+	return *this;
+}
+
+// Set this matrix to its transpose (matrix reflected through its diagonal)
+inline void CMatrix4x4::Transpose()
+{
+	TransposeMatrix( *this, *this );
+}
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -1266,11 +1449,14 @@ CMatrix4x4 operator/
 
 // Vector-matrix multiplication (order is important - this is usual order for transformation
 // for matrices stored as row vectors - see notes at top)
-CVector4 operator*
+inline CVector4 operator*
 (
 	const CVector4&   v,
 	const CMatrix4x4& m
-);
+)
+{
+	return m.Transform( v );
+}
 
 // Matrix-vector multiplication (order is important - this is an unusual order for matrices
 // stored as row vectors - see notes at top)
@@ -1285,11 +1471,16 @@ CVector4 operator*
 // Matrix multiplication
 
 // General matrix-matrix multiplication
-CMatrix4x4 operator*
+inline CMatrix4x4 operator*
 (
 	const CMatrix4x4& m1,
 	const CMatrix4x4& m2
-);
+)
+{
+	CMatrix4x4 mOut;
+	MultiplyMatrices( m1, m2, mOut );
+	return mOut;
+}
 
 
 // Matrix-matrix multiplication assuming both matrices are affine
@@ -1300,6 +1491,96 @@ CMatrix4x4 MultiplyAffine
 );
 
 
+/*-----------------------------------------------------------------------------------------
+	Batch Transformation
+-----------------------------------------------------------------------------------------*/
+// Transform arrays of vectors or matrices, much faster than a loop of single transforms as the
+// matrix is held in registers and four CVector3s are processed at once. Output arrays may be the
+// same as the input arrays, but must not otherwise overlap. Large batches can be split over a
+// number of threads (0 to use the hardware concurrency), but smaller batches always use the
+// current thread only as starting threads costs more than the transforms themselves
+
+// Transform an array of points by the given matrix (pre-multiplication, 4th element 1, as
+// TransformPoint)
+void TransformPoints
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numPoints,
+	const TUInt32     numThreads = 1
+);
+
+// Transform an array of vectors by the given matrix (pre-multiplication, 4th element 0, as
+// TransformVector)
+void TransformVectors
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numVectors,
+	const TUInt32     numThreads = 1
+);
+
+// Transform an array of normals for geometry transformed by the given matrix, i.e. by the inverse
+// transpose of its upper-left 3x3 matrix so normals stay perpendicular to surfaces after scaling
+// or shear. Results are normalised unless bNormalise is false, zero-length results become zero.
+// The matrix must be invertible if results are not normalised (or normals would be undefined)
+void TransformNormals
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numNormals,
+	const bool        bNormalise = true,
+	const TUInt32     numThreads = 1
+);
+
+// Transform an array of tangents (or bitangents) by the upper-left 3x3 matrix of the given matrix,
+// as TransformVectors but results are normalised unless bNormalise is false
+void TransformTangents
+(
+	const CMatrix4x4& m,
+	const CVector3*   aIn,
+	CVector3*         aOut,
+	const size_t      numTangents,
+	const bool        bNormalise = true,
+	const TUInt32     numThreads = 1
+);
+
+// Transform an array of 4-element vectors by the given matrix (pre-multiplication, as Transform)
+void Transform
+(
+	const CMatrix4x4& m,
+	const CVector4*   aIn,
+	CVector4*         aOut,
+	const size_t      numVectors,
+	const TUInt32     numThreads = 1
+);
+
+// Multiply each matrix in an array by the given matrix: aOut[i] = aIn[i] * m. E.g. to transform
+// an array of local/bone matrices into world space
+void TransformMatrices
+(
+	const CMatrix4x4& m,
+	const CMatrix4x4* aIn,
+	CMatrix4x4*       aOut,
+	const size_t      numMatrices,
+	const TUInt32     numThreads = 1
+);
+
+// Multiply matrices from two arrays in pairs: aOut[i] = am1[i] * am2[i]. The output may be the
+// same array as either input
+void MultiplyMatrices
+(
+	const CMatrix4x4* am1,
+	const CMatrix4x4* am2,
+	CMatrix4x4*       aOut,
+	const size_t      numMatrices,
+	const TUInt32     numThreads = 1
+);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-Member Othogonality
 -----------------------------------------------------------------------------------------*/
@@ -1321,7 +1602,12 @@ CMatrix4x4 Orthogonalise3x3
 
 // Return the transpose of given matrix (matrix reflected through its diagonal)
 // This is also the (most efficient) inverse for a rotation matrix
-CMatrix4x4 Transpose( const CMatrix4x4& m );
+inline CMatrix4x4 Transpose( const CMatrix4x4& m )
+{
+	CMatrix4x4 transMat;
+	TransposeMatrix( m, transMat );
+	return transMat;
+}
 
 // Return the inverse of given matrix assuming it is affine with an orthogonal upper-left 3x3
 // matrix i.e. an affine transformation with no scaling or shear
@@ -1358,10 +1644,16 @@ CMatrix4x4 Inverse( const CMatrix4x4& m );
 //     CMatrix4x4 m = MatrixScaling( 3.0f ) * MatrixTranslation( CVector3(10.0f, -10.0f, 20.0f) );
 
 // Return an identity matrix
-CMatrix4x4 MatrixIdentity();
+constexpr CMatrix4x4 MatrixIdentity()
+{
+	return CMatrix4x4::kIdentity;
+}
 
 // Return an affine translation matrix of the given vector
-CMatrix4x4 MatrixTranslation( const CVector3& translate );
+constexpr CMatrix4x4 MatrixTranslation( const CVector3& translate )
+{
+	return CMatrix4x4( translate );
+}
 
 // Return an X-axis rotation matrix of the given angle
 CMatrix4x4 MatrixRotationX( const TFloat32 x );
@@ -1389,10 +1681,22 @@ CMatrix4x4 MatrixRotation
 
 
 // Return a matrix that is a scaling in X,Y and Z of the values provided in the given vector
-CMatrix4x4 MatrixScaling( const CVector3& scale );
+constexpr CMatrix4x4 MatrixScaling( const CVector3& scale )
+{
+	return CMatrix4x4( scale.x, 0.0f, 0.0f, 0.0f,
+	                   0.0f, scale.y, 0.0f, 0.0f,
+	                   0.0f, 0.0f, scale.z, 0.0f,
+	                   0.0f, 0.0f, 0.0f, 1.0f );
+}
 
 // Return a matrix that is a uniform scaling of the given amount
-CMatrix4x4 MatrixScaling( const TFloat32 fScale );
+constexpr CMatrix4x4 MatrixScaling( const TFloat32 fScale )
+{
+	return CMatrix4x4( fScale, 0.0f, 0.0f, 0.0f,
+	                   0.0f, fScale, 0.0f, 0.0f,
+	                   0.0f, 0.0f, fScale, 0.0f,
+	                   0.0f, 0.0f, 0.0f, 1.0f );
+}
 
 
 /*-----------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 ********************************************/
 
 #include "CQuatTransform.h"
+#include "MathSIMD.h"
 
 namespace gen
 {
@@ -117,5 +118,222 @@ void Slerp
 }
 
 
+/*---------------------------------------------------------------------------------------------
+	Batch Operations
+---------------------------------------------------------------------------------------------*/
+// Position and scale are worked on directly as the first and last four floats of each transform
+// (each overlapping one float of the quaternion), so the transform must be ten packed floats
+static_assert( sizeof(CQuatTransform) == 10 * sizeof(TFloat32), "CQuatTransform must be ten packed floats" );
+
+// Transforms are blended in chunks - the quaternions of a chunk are gathered into arrays for the
+// quaternion batch functions, small enough to stay on the stack and in the cache
+const size_t kBlendChunkSize = 64;
+
+// Blend arrays of quaternion-transforms using slerp or nlerp for the quaternions, with parameters
+// from an array (aT) or a single parameter for all pairs (aT null)
+template <bool Spherical>
+static void BlendArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32*       aT,
+	const TFloat32        t,
+	CQuatTransform*       aOut,
+	const size_t          count
+)
+{
+	CQuaternion aQuat0[kBlendChunkSize], aQuat1[kBlendChunkSize];
+	for (size_t chunk = 0; chunk < count; chunk += kBlendChunkSize)
+	{
+		const size_t chunkCount = Min( count - chunk, kBlendChunkSize );
+		for (size_t i = 0; i < chunkCount; ++i)
+		{
+			aQuat0[i] = aQ0[chunk + i].quat;
+			aQuat1[i] = aQ1[chunk + i].quat;
+		}
+
+		// Lerp position and scale four floats at a time. The quaternion floats this also writes
+		// are replaced below, and have already been gathered so output can overwrite the input
+		for (size_t i = chunk; i < chunk + chunkCount; ++i)
+		{
+			const TFloat32* p0 = &aQ0[i].pos.x;
+			const TFloat32* p1 = &aQ1[i].pos.x;
+			TFloat32x4 start0 = Load4Unaligned( p0 );
+			TFloat32x4 end0   = Load4Unaligned( p0 + 6 );
+			TFloat32x4 start1 = Load4Unaligned( p1 );
+			TFloat32x4 end1   = Load4Unaligned( p1 + 6 );
+			TFloat32x4 lerpT = Splat4( aT ? aT[i] : t );
+			TFloat32* pOut = &aOut[i].pos.x;
+			Store4Unaligned( pOut,     MulAdd4( Sub4( start1, start0 ), lerpT, start0 ) );
+			Store4Unaligned( pOut + 6, MulAdd4( Sub4( end1, end0 ), lerpT, end0 ) );
+		}
+
+		if (Spherical)
+		{
+			if (aT)  SlerpArray( aQuat0, aQuat1, aT + chunk, aQuat0, chunkCount );
+			else     SlerpArray( aQuat0, aQuat1, t, aQuat0, chunkCount );
+		}
+		else
+		{
+			if (aT)  NLerpArray( aQuat0, aQuat1, aT + chunk, aQuat0, chunkCount );
+			else     NLerpArray( aQuat0, aQuat1, t, aQuat0, chunkCount );
+		}
+		for (size_t i = 0; i < chunkCount; ++i)  aOut[chunk + i].quat = aQuat0[i];
+	}
+}
+
+
+// Normalised linear interpolation of arrays of quaternion-transform pairs
+void NLerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32*       aT,
+	CQuatTransform*       aOut,
+	const size_t          count
+)
+{
+	BlendArray<false>( aQ0, aQ1, aT, 0.0f, aOut, count );
+}
+void NLerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32        t,
+	CQuatTransform*       aOut,
+	const size_t          count
+)
+{
+	BlendArray<false>( aQ0, aQ1, 0, t, aOut, count );
+}
+
+// Spherical linear interpolation of arrays of quaternion-transform pairs
+void SlerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32*       aT,
+	CQuatTransform*       aOut,
+	const size_t          count
+)
+{
+	BlendArray<true>( aQ0, aQ1, aT, 0.0f, aOut, count );
+}
+void SlerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32        t,
+	CQuatTransform*       aOut,
+	const size_t          count
+)
+{
+	BlendArray<true>( aQ0, aQ1, 0, t, aOut, count );
+}
+
+
+// Convert four consecutive quaternion-transforms to matrices, using the same formula as the
+// CMatrix4x4 quaternion constructor in SoA form (each element for four matrices in one register).
+// The quaternions are divided by their squared length, so they need not be normalised
+static inline void GetMatrixGroup
+(
+	const CQuatTransform* aIn,
+	CMatrix4x4*           aOut
+)
+{
+	// Quaternions and scales in SoA form, the scales from the last four floats of each transform
+	TFloat32x4 w = Load4Unaligned( &aIn[0].quat.w );
+	TFloat32x4 x = Load4Unaligned( &aIn[1].quat.w );
+	TFloat32x4 y = Load4Unaligned( &aIn[2].quat.w );
+	TFloat32x4 z = Load4Unaligned( &aIn[3].quat.w );
+	Transpose4( w, x, y, z );
+	TFloat32x4 unused = Load4Unaligned( &aIn[0].quat.z );
+	TFloat32x4 scaleX = Load4Unaligned( &aIn[1].quat.z );
+	TFloat32x4 scaleY = Load4Unaligned( &aIn[2].quat.z );
+	TFloat32x4 scaleZ = Load4Unaligned( &aIn[3].quat.z );
+	Transpose4( unused, scaleX, scaleY, scaleZ );
+
+	// Precalculate values as the constructor, with 2 / length^2 in place of 2
+	TFloat32x4 lengthSq = MulAdd4( z, z, MulAdd4( y, y, MulAdd4( x, x, Mul4( w, w ) ) ) );
+	TFloat32x4 s = Div4( Splat4( 2.0f ), lengthSq );
+	TFloat32x4 xs = Mul4( x, s );
+	TFloat32x4 ys = Mul4( y, s );
+	TFloat32x4 zs = Mul4( z, s );
+	TFloat32x4 xx = Mul4( x, xs );
+	TFloat32x4 yy = Mul4( y, ys );
+	TFloat32x4 zz = Mul4( z, zs );
+	TFloat32x4 xy = Mul4( x, ys );
+	TFloat32x4 yz = Mul4( y, zs );
+	TFloat32x4 zx = Mul4( z, xs );
+	TFloat32x4 wx = Mul4( w, xs );
+	TFloat32x4 wy = Mul4( w, ys );
+	TFloat32x4 wz = Mul4( w, zs );
+	const TFloat32x4 one = Splat4( 1.0f );
+
+	// Upper three rows, each transposed back to one row of each matrix with 0 in the fourth column
+	TFloat32x4 r0 = Mul4( scaleX, Sub4( Sub4( one, yy ), zz ) );
+	TFloat32x4 r1 = Mul4( scaleX, Add4( xy, wz ) );
+	TFloat32x4 r2 = Mul4( scaleX, Sub4( zx, wy ) );
+	TFloat32x4 r3 = Zero4();
+	Transpose4( r0, r1, r2, r3 );
+	Store4( &aOut[0].e00, r0 );
+	Store4( &aOut[1].e00, r1 );
+	Store4( &aOut[2].e00, r2 );
+	Store4( &aOut[3].e00, r3 );
+
+	r0 = Mul4( scaleY, Sub4( xy, wz ) );
+	r1 = Mul4( scaleY, Sub4( Sub4( one, xx ), zz ) );
+	r2 = Mul4( scaleY, Add4( yz, wx ) );
+	r3 = Zero4();
+	Transpose4( r0, r1, r2, r3 );
+	Store4( &aOut[0].e10, r0 );
+	Store4( &aOut[1].e10, r1 );
+	Store4( &aOut[2].e10, r2 );
+	Store4( &aOut[3].e10, r3 );
+
+	r0 = Mul4( scaleZ, Add4( zx, wy ) );
+	r1 = Mul4( scaleZ, Sub4( yz, wx ) );
+	r2 = Mul4( scaleZ, Sub4( Sub4( one, xx ), yy ) );
+	r3 = Zero4();
+	Transpose4( r0, r1, r2, r3 );
+	Store4( &aOut[0].e20, r0 );
+	Store4( &aOut[1].e20, r1 );
+	Store4( &aOut[2].e20, r2 );
+	Store4( &aOut[3].e20, r3 );
+
+	// Position in the bottom row, from the first four floats of each transform with the fourth
+	// element replaced by 1
+	for (int i = 0; i < 4; ++i)
+	{
+		TFloat32x4 pos = Load4Unaligned( &aIn[i].pos.x );
+		Store4( &aOut[i].e30, Shuffle4<0, 1, 0, 2>( pos, Shuffle4<2, 2, 0, 0>( pos, one ) ) );
+	}
+}
+
+// Get the 4x4 matrices equivalent to an array of quaternion-transforms
+void GetMatrices
+(
+	const CQuatTransform* aIn,
+	CMatrix4x4*           aOut,
+	const size_t          count
+)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		GetMatrixGroup( aIn + i, aOut + i );
+	}
+	if (i < count)
+	{
+		const CQuatTransform identity( CQuaternion::kIdentity, CVector3::kOrigin, CVector3::kOne );
+		CQuatTransform aGroup[4] = { identity, identity, identity, identity };
+		CMatrix4x4 aGroupOut[4];
+		for (size_t j = i; j < count; ++j)  aGroup[j - i] = aIn[j];
+		GetMatrixGroup( aGroup, aGroupOut );
+		for (size_t j = i; j < count; ++j)  aOut[j] = aGroupOut[j - i];
+	}
+}
+
+
 } // namespace gen
 
@@ -31,7 +31,7 @@ public:
 	CQuatTransform() {}
 
 	// Constructor by value
-    CQuatTransform
+    constexpr CQuatTransform
 	(
 		const CQuaternion& initQuat,
 		const CVector3&    initPos,
@@ -56,29 +56,10 @@ public:
 	}
 
 
-	// Copy constructor
-    CQuatTransform
-	(
-		const CQuatTransform& src
-	) : quat( src.quat ), pos( src.pos ), scale( src.scale ) {}
-
-	// Assignment operator
-    CQuatTransform& operator=
-	(
-		const CQuatTransform& src
-	)
-	{
-		if ( this != &src )
-		{
-			quat = src.quat;
-			pos = src.pos;
-			scale = src.scale;
-		}
-		return *this;
-	}
-
-	// Destructor
-	~CQuatTransform() {}
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CQuatTransform( const CQuatTransform& src ) = default;
+	CQuatTransform& operator=( const CQuatTransform& src ) = default;
 
 
 /*-----------------------------------------------------------------------------------------
@@ -114,7 +95,7 @@ public:
 	// Addition / subtraction
 
 	// Add another quaternion transform to this one
-    CQuatTransform& operator+=
+    constexpr CQuatTransform& operator+=
 	(
 		const CQuatTransform& qt
 	)
@@ -126,7 +107,7 @@ public:
 	}
 
 	// Subtract another quaternion transform to this one
-    CQuatTransform& operator-=
+    constexpr CQuatTransform& operator-=
 	(
 		const CQuatTransform& qt
 	)
@@ -142,7 +123,7 @@ public:
 	// Scalar operations
 
 	// Scalar multiplication
-    CQuatTransform& operator*=
+    constexpr CQuatTransform& operator*=
 	(
 		const TFloat32& scalar
 	)
@@ -269,7 +250,7 @@ public:
 // Addition / subtraction
 
 // Addition
-inline CQuatTransform operator+
+constexpr CQuatTransform operator+
 (
 	const CQuatTransform& qt1,
 	const CQuatTransform& qt2
@@ -279,7 +260,7 @@ inline CQuatTransform operator+
 }
 
 // Subtraction
-inline CQuatTransform operator-
+constexpr CQuatTransform operator-
 (
 	const CQuatTransform& qt1,
 	const CQuatTransform& qt2
@@ -289,7 +270,7 @@ inline CQuatTransform operator-
 }
 
 // Unary positive (for completeness)
-inline CQuatTransform operator+
+constexpr CQuatTransform operator+
 (
 	const CQuatTransform& qt
 )
@@ -298,7 +279,7 @@ inline CQuatTransform operator+
 }
 
 // Unary negation
-inline CQuatTransform operator-
+constexpr CQuatTransform operator-
 (
 	const CQuatTransform& qt
 )
@@ -311,7 +292,7 @@ inline CQuatTransform operator-
 // Scalar operations
 
 // Scalar multiplication
-inline CQuatTransform operator*
+constexpr CQuatTransform operator*
 (
 	const CQuatTransform& qt1,
 	const TFloat32        scalar
@@ -331,6 +312,63 @@ inline CQuatTransform operator/
 }
 
 
+/*-----------------------------------------------------------------------------------------
+	Batch Operations
+-----------------------------------------------------------------------------------------*/
+// Blend and convert arrays of quaternion-transforms, much faster than a loop of single operations
+// as four transforms are processed at once. Used to blend animation poses and to get the matrices
+// of the bones in a hierarchy. Blended output may be the same as either input array, but must not
+// otherwise overlap
+
+// Normalised linear interpolation of arrays of quaternion-transform pairs, with parameters aT[i]
+// or the single parameter t for all pairs. Position and scale use lerp, the quaternions use
+// NLerpArray, which takes the shorter route between each pair
+void NLerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32*       aT,
+	CQuatTransform*       aOut,
+	const size_t          count
+);
+void NLerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32        t,
+	CQuatTransform*       aOut,
+	const size_t          count
+);
+
+// Spherical linear interpolation of arrays of quaternion-transform pairs, with parameters aT[i]
+// or the single parameter t for all pairs. Only the quaternions use slerp (SlerpArray), position
+// and scale use lerp
+void SlerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32*       aT,
+	CQuatTransform*       aOut,
+	const size_t          count
+);
+void SlerpArray
+(
+	const CQuatTransform* aQ0,
+	const CQuatTransform* aQ1,
+	const TFloat32        t,
+	CQuatTransform*       aOut,
+	const size_t          count
+);
+
+// Get the 4x4 matrices equivalent to an array of quaternion-transforms, as GetMatrix
+void GetMatrices
+(
+	const CQuatTransform* aIn,
+	CMatrix4x4*           aOut,
+	const size_t          count
+);
+
+
 } // namespace gen
 
 #endif // GEN_C_QUATERNION_H_INCLUDED
@@ -12,6 +12,7 @@
 **************************************************************************************************/
 
 #include "CQuaternion.h"
+#include "FastMath.h"
 
 namespace gen
 {
@@ -102,24 +103,6 @@ CQuaternion::CQuaternion
 }
 
 
-/*-----------------------------------------------------------------------------------------
-	Quaternion multiplication
------------------------------------------------------------------------------------------*/
-
-// Return the quaternion result of multiplying two quaternions - non-member function
-CQuaternion operator*
-(
-	const CQuaternion& q1,
-	const CQuaternion& q2
-)
-{
-	const CVector3& v1 = q1.Vector();
-	const CVector3& v2 = q2.Vector();
-
-	return CQuaternion( q1.w*q2.w - Dot( v1, v2 ), q1.w*v2 + q2.w*v1 + Cross( v2, v1 ) );
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	Length operations
 -----------------------------------------------------------------------------------------*/
@@ -277,12 +260,200 @@ void Slerp
 
 
 /*---------------------------------------------------------------------------------------------
-	Static constants
+	Batch Interpolation
 ---------------------------------------------------------------------------------------------*/
+// Quaternions are interpolated four pairs at a time in SoA form (w, x, y & z of four quaternions
+// in four SIMD registers). The few pairs left over at the end are copied through a padded group
+
+// Load four consecutive quaternions and convert to SoA form
+static inline void LoadGroup
+(
+	const CQuaternion* aQ,
+	TFloat32x4&        w,
+	TFloat32x4&        x,
+	TFloat32x4&        y,
+	TFloat32x4&        z
+)
+{
+	w = Load4Unaligned( &aQ[0].w );
+	x = Load4Unaligned( &aQ[1].w );
+	y = Load4Unaligned( &aQ[2].w );
+	z = Load4Unaligned( &aQ[3].w );
+	Transpose4( w, x, y, z );
+}
+
+// Convert four quaternions in SoA form back to AoS and store them consecutively
+static inline void StoreGroup
+(
+	CQuaternion* aQ,
+	TFloat32x4   w,
+	TFloat32x4   x,
+	TFloat32x4   y,
+	TFloat32x4   z
+)
+{
+	Transpose4( w, x, y, z );
+	Store4Unaligned( &aQ[0].w, w );
+	Store4Unaligned( &aQ[1].w, x );
+	Store4Unaligned( &aQ[2].w, y );
+	Store4Unaligned( &aQ[3].w, z );
+}
+
+// Interpolate four consecutive pairs of quaternions with the parameters in t, using slerp or
+// nlerp. Output may be the same as either input
+template <bool Spherical>
+static inline void InterpolateGroup
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32x4   t,
+	CQuaternion*       aOut
+)
+{
+	TFloat32x4 w0, x0, y0, z0, w1, x1, y1, z1;
+	LoadGroup( aQ0, w0, x0, y0, z0 );
+	LoadGroup( aQ1, w1, x1, y1, z1 );
+	TFloat32x4 cosTheta = MulAdd4( z0, z1, MulAdd4( y0, y1, MulAdd4( x0, x1, Mul4( w0, w1 ) ) ) );
+
+	const TFloat32x4 one = Splat4( 1.0f );
+	TFloat32x4 weight0 = Sub4( one, t );
+	TFloat32x4 weight1 = t;
+	if (Spherical)
+	{
+		// Slerp weights as Slerp, with theta from atan2 rather than acos. 1 - cos^2 is calculated
+		// as (1 - cos)(1 + cos), which keeps sin theta accurate for small angles
+		TFloat32x4 absCos = Abs4( cosTheta );
+		TFloat32x4 oneMinusCos = Sub4( one, absCos );
+		TFloat32x4 sinTheta = Sqrt4( Mul4( oneMinusCos, Add4( one, absCos ) ) );
+		TFloat32x4 theta = ATan24<kPrecisionFull>( sinTheta, absCos );
+		TFloat32x4 invSinTheta = Div4( one, sinTheta );
+		TFloat32x4 slerp0 = Mul4( Sin4<kPrecisionFull>( Mul4( weight0, theta ) ), invSinTheta );
+		TFloat32x4 slerp1 = Mul4( Sin4<kPrecisionFull>( Mul4( t, theta ) ), invSinTheta );
+
+		// Keep lerp weights where the angle is too small for the slerp formula (sin theta is zero
+		// for equal quaternions)
+		TFloat32x4 useSlerp = Greater4( oneMinusCos, Splat4( kfEpsilon ) );
+		weight0 = Select4( useSlerp, slerp0, weight0 );
+		weight1 = Select4( useSlerp, slerp1, weight1 );
+	}
+
+	// Take the shorter route round the circle by negating the first quaternion where the cos is
+	// negative, as Slerp
+	weight0 = Xor4( weight0, SignBit4( cosTheta ) );
+
+	TFloat32x4 w = MulAdd4( w1, weight1, Mul4( w0, weight0 ) );
+	TFloat32x4 x = MulAdd4( x1, weight1, Mul4( x0, weight0 ) );
+	TFloat32x4 y = MulAdd4( y1, weight1, Mul4( y0, weight0 ) );
+	TFloat32x4 z = MulAdd4( z1, weight1, Mul4( z0, weight0 ) );
+
+	if (!Spherical)
+	{
+		// Taking the shorter route keeps the length away from zero for parameters from 0 to 1
+		TFloat32x4 lengthSq = MulAdd4( z, z, MulAdd4( y, y, MulAdd4( x, x, Mul4( w, w ) ) ) );
+		TFloat32x4 invLength = InvSqrt4<kPrecisionFull>( lengthSq );
+		w = Mul4( w, invLength );
+		x = Mul4( x, invLength );
+		y = Mul4( y, invLength );
+		z = Mul4( z, invLength );
+	}
+
+	StoreGroup( aOut, w, x, y, z );
+}
 
-// Standard vectors
-const CQuaternion CQuaternion::kZero( 0.0f, 0.0f, 0.0f, 0.0f );
-const CQuaternion CQuaternion::kIdentity( 1.0f, 0.0f, 0.0f, 0.0f );
+// Interpolate arrays of quaternion pairs, with parameters from an array (aT) or a single
+// parameter for all pairs (aT null)
+template <bool Spherical>
+static void InterpolateArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32*    aT,
+	const TFloat32     t,
+	CQuaternion*       aOut,
+	const size_t       count
+)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		TFloat32x4 groupT = aT ? Load4Unaligned( aT + i ) : Splat4( t );
+		InterpolateGroup<Spherical>( aQ0 + i, aQ1 + i, groupT, aOut + i );
+	}
+	if (i < count)
+	{
+		CQuaternion aGroup0[4] = { CQuaternion::kIdentity, CQuaternion::kIdentity,
+		                           CQuaternion::kIdentity, CQuaternion::kIdentity };
+		CQuaternion aGroup1[4] = { CQuaternion::kIdentity, CQuaternion::kIdentity,
+		                           CQuaternion::kIdentity, CQuaternion::kIdentity };
+		TFloat32 aGroupT[4] = { t, t, t, t };
+		for (size_t j = i; j < count; ++j)
+		{
+			aGroup0[j - i] = aQ0[j];
+			aGroup1[j - i] = aQ1[j];
+			if (aT)  aGroupT[j - i] = aT[j];
+		}
+		InterpolateGroup<Spherical>( aGroup0, aGroup1, Load4Unaligned( aGroupT ), aGroup0 );
+		for (size_t j = i; j < count; ++j)  aOut[j] = aGroup0[j - i];
+	}
+}
+
+
+// Normalised linear interpolation of arrays of quaternion pairs, an approximation to slerp
+void NLerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32*    aT,
+	CQuaternion*       aOut,
+	const size_t       count
+)
+{
+	InterpolateArray<false>( aQ0, aQ1, aT, 0.0f, aOut, count );
+}
+void NLerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32     t,
+	CQuaternion*       aOut,
+	const size_t       count
+)
+{
+	InterpolateArray<false>( aQ0, aQ1, 0, t, aOut, count );
+}
+
+// Spherical linear interpolation of arrays of quaternion pairs
+void SlerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32*    aT,
+	CQuaternion*       aOut,
+	const size_t       count
+)
+{
+#if defined(GEN_SIMD_NONE)
+	// The polynomials are slower than the library functions without SIMD
+	for (size_t i = 0; i < count; ++i)  Slerp( aQ0[i], aQ1[i], aT[i], aOut[i] );
+#else
+	InterpolateArray<true>( aQ0, aQ1, aT, 0.0f, aOut, count );
+#endif
+}
+void SlerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32     t,
+	CQuaternion*       aOut,
+	const size_t       count
+)
+{
+#if defined(GEN_SIMD_NONE)
+	for (size_t i = 0; i < count; ++i)  Slerp( aQ0[i], aQ1[i], t, aOut[i] );
+#else
+	InterpolateArray<true>( aQ0, aQ1, 0, t, aOut, count );
+#endif
+}
 
 
 } // namespace gen
@@ -36,7 +36,7 @@ public:
 	CQuaternion() {}
 
 	// Construct by value - four floats
-	CQuaternion
+	constexpr CQuaternion
 	(
 		const TFloat32 initW,
 		const TFloat32 initX,
@@ -45,7 +45,7 @@ public:
 	) : w( initW ), x( initX ), y( initY ), z( initZ ) {}
 
 	// Construct by value - float and CVector3
-	CQuaternion
+	constexpr CQuaternion
 	(
 		const TFloat32 initW,
 		const CVector3 initV
@@ -53,13 +53,13 @@ public:
 
 	// Construct through pointer to four floats
 	// Specifying explicit avoids defining an implicit conversion
-	explicit CQuaternion
+	constexpr explicit CQuaternion
 	(
 		const TFloat32* pWXYZ
 	) : w( pWXYZ[0] ), x( pWXYZ[1] ), y( pWXYZ[2] ), z( pWXYZ[3] ) {}
 
  	// Construct from a CVector3 - w value becomes 0
-	explicit CQuaternion
+	constexpr explicit CQuaternion
 	(
 		const CVector3& src
 	) : w( 0.0f ), x( src.x ), y( src.y ), z( src.z ) {};
@@ -71,30 +71,10 @@ public:
 	);
 
 
-	// Copy constructor
-    CQuaternion
-	(
-		const CQuaternion& src
-	) : w( src.w ), x( src.x ), y( src.y ), z( src.z ) {}
-
-	// Assignment operator
-    CQuaternion& operator=
-	(
-		const CQuaternion& src
-	)
-	{
-		if ( this != &src )
-		{
-			w = src.w;
-			x = src.x;
-			y = src.y;
-			z = src.z;
-		}
-		return *this;
-	}
-
-	// Destructor
-	~CQuaternion() {}
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CQuaternion( const CQuaternion& src ) = default;
+	CQuaternion& operator=( const CQuaternion& src ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -102,7 +82,7 @@ public:
 	-----------------------------------------------------------------------------------------*/
 
 	// Set all four quaternion components
-    void Set
+    constexpr void Set
 	(
 		const TFloat32 setW,
 		const TFloat32 setX,
@@ -117,7 +97,7 @@ public:
 	}
 
 	// Set all four quaternion components from float and CVector3
-    void Set
+    constexpr void Set
 	(
 		const TFloat32 setW,
 		const CVector3 setV
@@ -130,7 +110,7 @@ public:
 	}
 
 	// Set the quaternion through a pointer to four floats
-    void Set
+    constexpr void Set
 	(
 		const TFloat32* pXYZ
 	)
@@ -142,13 +122,13 @@ public:
 	}
 
 	// Set the quaternion to (0,0,0,0)
-    void SetZero()
+    constexpr void SetZero()
 	{
 		w = x = y = z = 0.0f;
 	}
 
 	// Set the quaternion to the idendity (1,0,0,0)
-    void SetIdentity()
+    constexpr void SetIdentity()
 	{
 		w = 1.0f;
 		x = y = z = 0.0f;
@@ -247,7 +227,7 @@ public:
 	// Addition / subtraction
 
 	// Add another quaternion to this quaternion
-    CQuaternion& operator+=
+    constexpr CQuaternion& operator+=
 	(
 		const CQuaternion& quat
 	)
@@ -260,7 +240,7 @@ public:
 	}
 
 	// Subtract another quaternion from this quaternion
-    CQuaternion& operator-=
+    constexpr CQuaternion& operator-=
 	(
 		const CQuaternion& quat
 	)
@@ -277,7 +257,7 @@ public:
 	// Scalar multiplication & division
 
 	// Multiply this quaternion by a scalar
-	CQuaternion& operator*=
+	constexpr CQuaternion& operator*=
 	(
 		const TFloat32 scalar
 	)
@@ -290,7 +270,7 @@ public:
 	}
 
 	// Divide this quaternion by a scalar
-    CQuaternion& operator/=
+    constexpr CQuaternion& operator/=
 	(
 		const TFloat32 scalar
 	)
@@ -307,14 +287,14 @@ public:
 	// Quaternion multiplication
 
 	// Binary form as friend to define function below
-	friend CQuaternion operator*
+	friend constexpr CQuaternion operator*
 	(
 		const CQuaternion& quat1,
 		const CQuaternion& quat2
 	);
 
 	// Multiply this quaternion by another
-    CQuaternion& operator*=
+    constexpr CQuaternion& operator*=
 	(
 		const CQuaternion& quat
 	)
@@ -328,7 +308,7 @@ public:
 	// Other operations
 
 	// Dot product of this with another quaternion
-    TFloat32 Dot
+    constexpr TFloat32 Dot
 	(
 		const CQuaternion& quat
 	) const
@@ -349,7 +329,7 @@ public:
 	}
 
 	// Return squared norm of this quaternion
-	TFloat32 NormSquared() const
+	constexpr TFloat32 NormSquared() const
 	{
 		return w*w + x*x + y*y + z*z;
 	}
@@ -363,7 +343,7 @@ public:
 	-----------------------------------------------------------------------------------------*/
 
 	// Set this quaternion to its inverse
-	void SetInverse()
+	constexpr void SetInverse()
 	{
 		x = -x;
 		y = -y;
@@ -371,7 +351,7 @@ public:
 	}
 
 	// Return the inverse of this quaternion
-	CQuaternion Inverse() const
+	constexpr CQuaternion Inverse() const
 	{
 		return CQuaternion( w, -x, -y, -z );
 	}
@@ -404,6 +384,16 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard vectors
+inline constexpr CQuaternion CQuaternion::kZero( 0.0f, 0.0f, 0.0f, 0.0f );
+inline constexpr CQuaternion CQuaternion::kIdentity( 1.0f, 0.0f, 0.0f, 0.0f );
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -438,7 +428,7 @@ inline bool operator!=
 // Addition / subtraction
 
 // Quaternion addition
-inline CQuaternion operator+
+constexpr CQuaternion operator+
 (
 	const CQuaternion& quat1,
 	const CQuaternion& quat2
@@ -448,7 +438,7 @@ inline CQuaternion operator+
 }
 
 // Quaternion subtraction
-inline CQuaternion operator-
+constexpr CQuaternion operator-
 (
 	const CQuaternion& quat1,
 	const CQuaternion& quat2
@@ -458,7 +448,7 @@ inline CQuaternion operator-
 }
 
 // Unary positive (for completeness)
-inline CQuaternion operator+
+constexpr CQuaternion operator+
 (
 	const CQuaternion& quat
 )
@@ -467,7 +457,7 @@ inline CQuaternion operator+
 }
 
 // Unary negation
-inline CQuaternion operator-
+constexpr CQuaternion operator-
 (
 	const CQuaternion& quat
 )
@@ -480,7 +470,7 @@ inline CQuaternion operator-
 // Scalar multiplication & division
 
 // Quaternion multiplied by scalar
-inline CQuaternion operator*
+constexpr CQuaternion operator*
 (
 	const CQuaternion& quat,
 	const TFloat32     scalar
@@ -490,7 +480,7 @@ inline CQuaternion operator*
 }
 
 // Scalar multiplied by quaternion
-inline CQuaternion operator*
+constexpr CQuaternion operator*
 (
 	const TFloat32     scalar,
 	const CQuaternion& quat
@@ -500,7 +490,7 @@ inline CQuaternion operator*
 }
 
 // Quaternion divided by scalar
-inline CQuaternion operator/
+constexpr CQuaternion operator/
 (
 	const CQuaternion& quat,
 	const TFloat32     scalar
@@ -513,19 +503,26 @@ inline CQuaternion operator/
 ////////////////////////////////////
 // Quaternion multiplication
 
-// Return the quaternion result of multiplying two quaternions
-CQuaternion operator*
+// Return the quaternion result of multiplying two quaternions. The vector part is
+// q1.w*v2 + q2.w*v1 + v2 x v1, written out by element
+constexpr CQuaternion operator*
 (
 	const CQuaternion& quat1,
 	const CQuaternion& quat2
-);
+)
+{
+	return CQuaternion( quat1.w*quat2.w - (quat1.x*quat2.x + quat1.y*quat2.y + quat1.z*quat2.z),
+	                    quat1.w*quat2.x + quat2.w*quat1.x + quat2.y*quat1.z - quat2.z*quat1.y,
+	                    quat1.w*quat2.y + quat2.w*quat1.y + quat2.z*quat1.x - quat2.x*quat1.z,
+	                    quat1.w*quat2.z + quat2.w*quat1.z + quat2.x*quat1.y - quat2.y*quat1.x );
+}
 
 
 ////////////////////////////////////
 // Other operations
 
 // Dot product of two given quaternions (order not important) - non-member version
-inline TFloat32 Dot
+constexpr TFloat32 Dot
 (
 	const CQuaternion& quat1,
 	const CQuaternion& quat2
@@ -549,7 +546,7 @@ inline TFloat32 Norm
 }
 
 // Return squared norm of a quaternion - non-member version
-inline TFloat32 NormSquared
+constexpr TFloat32 NormSquared
 (
 	const CQuaternion& quat
 )
@@ -598,6 +595,53 @@ void Slerp
 );
 
 
+/*---------------------------------------------------------------------------------------------
+	Batch Interpolation
+---------------------------------------------------------------------------------------------*/
+// Interpolate arrays of quaternion pairs, much faster than a loop of single interpolations as
+// four pairs are processed at once. Result i interpolates aQ0[i] and aQ1[i] with parameter aT[i],
+// or with the single parameter t for all pairs. Both functions take the shorter route between
+// each pair (as Slerp, but unlike NLerp), which is needed when blending animations. The output
+// array may be the same as either input array, but must not otherwise overlap
+
+// Normalised linear interpolation of arrays of quaternion pairs, an approximation to slerp
+void NLerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32*    aT,
+	CQuaternion*       aOut,
+	const size_t       count
+);
+void NLerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32     t,
+	CQuaternion*       aOut,
+	const size_t       count
+);
+
+// Spherical linear interpolation of arrays of quaternion pairs. Results match Slerp to within a
+// few units in the last place (using the FastMath.h sin and atan2)
+void SlerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32*    aT,
+	CQuaternion*       aOut,
+	const size_t       count
+);
+void SlerpArray
+(
+	const CQuaternion* aQ0,
+	const CQuaternion* aQ1,
+	const TFloat32     t,
+	CQuaternion*       aOut,
+	const size_t       count
+);
+
+
 } // namespace gen
 
 #endif // GEN_C_QUATERNION_H_INCLUDED
@@ -0,0 +1,280 @@
+/**************************************************************************************************
+	Module:       CRandom.cpp
+
+	Implementation of the concrete class CRandom, a fast random number generator with batch functions
+	that generate four values at once using SIMD
+
+	Change history:
+		V1.0    Created with xoshiro128 generators and batch floats, unit vectors and sphere points
+**************************************************************************************************/
+
+#include <atomic>
+
+#include "CRandom.h"
+#include "MathSIMD.h"
+#include "FastMath.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Seeding
+-----------------------------------------------------------------------------------------*/
+
+// Return the next value from a SplitMix64 generator (Steele, Lea & Flood) with the given state.
+// Used to spread a seed over the generator state - xoshiro needs well mixed, non-zero state
+static TUInt64 SplitMix64( TUInt64& state )
+{
+	TUInt64 z = (state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+// Restart the generator with the given seed
+void CRandom::Seed( const TUInt64 seed )
+{
+	// Generator 0 is the single value generator, 1 to 4 are the lanes of the batch generator. An
+	// all-zero state would only ever return zero, it is a 1 in 2^128 chance but is checked
+	TUInt64 mix = seed;
+	for (int generator = 0; generator < 5; ++generator)
+	{
+		TUInt32 aWords[4];
+		do
+		{
+			TUInt64 low = SplitMix64( mix );
+			TUInt64 high = SplitMix64( mix );
+			aWords[0] = static_cast<TUInt32>(low);
+			aWords[1] = static_cast<TUInt32>(low >> 32);
+			aWords[2] = static_cast<TUInt32>(high);
+			aWords[3] = static_cast<TUInt32>(high >> 32);
+		} while ((aWords[0] | aWords[1] | aWords[2] | aWords[3]) == 0);
+
+		for (int word = 0; word < 4; ++word)
+		{
+			if (generator == 0)
+			{
+				maState[word] = aWords[word];
+			}
+			else
+			{
+				maLaneState[word][generator - 1] = aWords[word];
+			}
+		}
+	}
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Single values
+-----------------------------------------------------------------------------------------*/
+
+// Return random unit vector, evenly distributed over all directions
+CVector3 CRandom::UnitVector()
+{
+	// Archimedes' hat-box theorem: z evenly distributed in [-1, 1] and an even angle around the z
+	// axis give an even distribution on the sphere
+	TFloat32 z = Float( -1.0f, 1.0f );
+	TFloat32 angle = Float( -kfPi, kfPi );
+	TFloat32 r = Sqrt( Max( 0.0f, 1.0f - z * z ) );
+	TFloat32 s, c;
+	SinCos( angle, &s, &c );
+	return CVector3( r * c, r * s, z );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch generation
+-----------------------------------------------------------------------------------------*/
+// Each lane runs its own xoshiro128+ generator, using the integer operations in MathSIMD.h. The
+// state is kept in registers during each batch and written back at the end. xoshiro128+ rather
+// than the xoshiro128** used for single values because it needs no integer multiply (which SSE2
+// lacks). Its lowest bits are weaker, but only the top 23 bits are used to make floats. The scalar
+// build uses the single value generator since emulating the lanes would be slower
+
+#if !defined(GEN_SIMD_NONE)
+
+// Step the four lane generators, returning a random float in [1, 2) in each lane
+static inline TFloat32x4 NextFloats1To2( TFloat32x4* aState )
+{
+	TFloat32x4 result = AddBits4( aState[0], aState[3] );
+	TFloat32x4 t = ShiftLeftBits4<9>( aState[1] );
+	aState[2] = Xor4( aState[2], aState[0] );
+	aState[3] = Xor4( aState[3], aState[1] );
+	aState[1] = Xor4( aState[1], aState[2] );
+	aState[0] = Xor4( aState[0], aState[3] );
+	aState[2] = Xor4( aState[2], t );
+	aState[3] = RotateLeftBits4<11>( aState[3] );
+
+	// Top 23 bits as the mantissa with the exponent of 1.0
+	return Or4( ShiftRightBits4<9>( result ), SplatBits4( 0x3f800000 ) );
+}
+
+// Fill an array with random floats in the range [base, base + scale) using the lane generators
+static void FillFloats
+(
+	TUInt32        aLaneState[4][4],
+	const TFloat32 base,
+	const TFloat32 scale,
+	TFloat32*      aOut,
+	const size_t   count
+)
+{
+	TFloat32x4 aState[4];
+	for (int word = 0; word < 4; ++word)
+	{
+		aState[word] = Load4Unaligned( reinterpret_cast<const TFloat32*>(aLaneState[word]) );
+	}
+	const TFloat32x4 scale4 = Splat4( scale );
+	const TFloat32x4 base4 = Splat4( base );
+	const TFloat32x4 one = Splat4( 1.0f );
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		Store4Unaligned( aOut + i, MulAdd4( Sub4( NextFloats1To2( aState ), one ), scale4, base4 ) );
+	}
+	if (i < count)
+	{
+		TFloat32 aGroup[4];
+		Store4Unaligned( aGroup, MulAdd4( Sub4( NextFloats1To2( aState ), one ), scale4, base4 ) );
+		for (size_t j = i; j < count; ++j)  aOut[j] = aGroup[j - i];
+	}
+
+	for (int word = 0; word < 4; ++word)
+	{
+		Store4Unaligned( reinterpret_cast<TFloat32*>(aLaneState[word]), aState[word] );
+	}
+}
+
+// Fill an array with random points on a sphere using the lane generators, as UnitVector
+static void FillSpherePoints
+(
+	TUInt32         aLaneState[4][4],
+	const CVector3& centre,
+	const TFloat32  radius,
+	CVector3*       aOut,
+	const size_t    count
+)
+{
+	TFloat32x4 aState[4];
+	for (int word = 0; word < 4; ++word)
+	{
+		aState[word] = Load4Unaligned( reinterpret_cast<const TFloat32*>(aLaneState[word]) );
+	}
+	const TFloat32x4 centreX = Splat4( centre.x );
+	const TFloat32x4 centreY = Splat4( centre.y );
+	const TFloat32x4 centreZ = Splat4( centre.z );
+	const TFloat32x4 radius4 = Splat4( radius );
+	const TFloat32x4 one = Splat4( 1.0f );
+
+	size_t i = 0;
+	CVector3 aGroup[4];
+	while (i < count)
+	{
+		// z in [-1, 1) and angle in [-pi, pi) from [1, 2)
+		TFloat32x4 z = MulAdd4( NextFloats1To2( aState ), Splat4( 2.0f ), Splat4( -3.0f ) );
+		TFloat32x4 angle = MulAdd4( NextFloats1To2( aState ), Splat4( 2.0f * kfPi ), Splat4( -3.0f * kfPi ) );
+		TFloat32x4 r = Sqrt4( Max4( NegMulAdd4( z, z, one ), Zero4() ) );
+		TFloat32x4 s, c;
+		SinCos4<kPrecisionFull>( angle, &s, &c );
+		TFloat32x4 x = MulAdd4( Mul4( r, c ), radius4, centreX );
+		TFloat32x4 y = MulAdd4( Mul4( r, s ), radius4, centreY );
+		z = MulAdd4( z, radius4, centreZ );
+
+		// Convert to AoS, as (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3). The last group goes through
+		// a local array if it is incomplete
+		TFloat32* pOut = (i + 4 <= count) ? &aOut[i].x : &aGroup[0].x;
+		TFloat32x4 xy01 = Shuffle4<0, 1, 0, 1>( x, y ); // x0 x1 y0 y1
+		TFloat32x4 xy23 = Shuffle4<2, 3, 2, 3>( x, y ); // x2 x3 y2 y3
+		TFloat32x4 zx01 = Shuffle4<0, 0, 1, 1>( z, x ); // z0 z0 x1 x1
+		TFloat32x4 zx23 = Shuffle4<2, 2, 3, 3>( z, x ); // z2 z2 x3 x3
+		TFloat32x4 yz1  = Shuffle4<1, 1, 1, 1>( y, z ); // y1 y1 z1 z1
+		TFloat32x4 yz3  = Shuffle4<3, 3, 3, 3>( y, z ); // y3 y3 z3 z3
+		Store4Unaligned( pOut,     Shuffle4<0, 2, 0, 2>( xy01, zx01 ) );
+		Store4Unaligned( pOut + 4, Shuffle4<0, 2, 0, 2>( yz1, xy23 ) );
+		Store4Unaligned( pOut + 8, Shuffle4<0, 2, 0, 2>( zx23, yz3 ) );
+		if (i + 4 > count)
+		{
+			for (size_t j = i; j < count; ++j)  aOut[j] = aGroup[j - i];
+		}
+		i += 4;
+	}
+
+	for (int word = 0; word < 4; ++word)
+	{
+		Store4Unaligned( reinterpret_cast<TFloat32*>(aLaneState[word]), aState[word] );
+	}
+}
+
+#endif // !GEN_SIMD_NONE
+
+
+// Fill an array with random floats in the range [0, 1)
+void CRandom::Floats
+(
+	TFloat32*    aOut,
+	const size_t count
+)
+{
+	Floats( 0.0f, 1.0f, aOut, count );
+}
+
+// Fill an array with random floats in the range [a, b)
+void CRandom::Floats
+(
+	const TFloat32 a,
+	const TFloat32 b,
+	TFloat32*      aOut,
+	const size_t   count
+)
+{
+#if defined(GEN_SIMD_NONE)
+	for (size_t i = 0; i < count; ++i)  aOut[i] = Float( a, b );
+#else
+	FillFloats( maLaneState, a, b - a, aOut, count );
+#endif
+}
+
+// Fill an array with random unit vectors, evenly distributed over all directions
+void CRandom::UnitVectors
+(
+	CVector3*    aOut,
+	const size_t count
+)
+{
+	PointsOnSphere( CVector3::kZero, 1.0f, aOut, count );
+}
+
+// Fill an array with random points on the surface of a sphere, evenly distributed
+void CRandom::PointsOnSphere
+(
+	const CVector3& centre,
+	const TFloat32  radius,
+	CVector3*       aOut,
+	const size_t    count
+)
+{
+#if defined(GEN_SIMD_NONE)
+	for (size_t i = 0; i < count; ++i)  aOut[i] = PointOnSphere( centre, radius );
+#else
+	FillSpherePoints( maLaneState, centre, radius, aOut, count );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Per-thread generator
+-----------------------------------------------------------------------------------------*/
+
+// Return a generator for the calling thread
+CRandom& ThreadRandom()
+{
+	// Seed each thread's generator from a shared counter, the seeding mixes the seeds thoroughly
+	static atomic<TUInt64> nextSeed( 0 );
+	thread_local CRandom random( nextSeed++ );
+	return random;
+}
+
+
+} // namespace gen
@@ -0,0 +1,177 @@
+/**************************************************************************************************
+	Module:       CRandom.h
+
+	Definition of the concrete class CRandom, a fast random number generator with batch functions
+	that generate four values at once using SIMD. Unlike Random in BaseMath.h it keeps its own
+	state, so each thread can use its own generator without contention
+
+	Change history:
+		V1.0    Created with xoshiro128 generators and batch floats, unit vectors and sphere points
+**************************************************************************************************/
+
+#ifndef GEN_C_RANDOM_H_INCLUDED
+#define GEN_C_RANDOM_H_INCLUDED
+
+#include "GenDefines.h"
+#include "CVector3.h"
+
+namespace gen
+{
+
+// Random number generator using the xoshiro128 family (Blackman & Vigna) - small, very fast and
+// of good statistical quality, but not suitable for cryptography. Single values use xoshiro128**.
+// The batch functions use four xoshiro128+ generators in SIMD lanes, which have separate state so
+// batches do not change the single value sequence. A generator must not be shared between threads
+// without locking - use one per thread, such as ThreadRandom below
+class CRandom
+{
+// Concrete class - public access
+public:
+	/*-----------------------------------------------------------------------------------------
+		Constructors
+	-----------------------------------------------------------------------------------------*/
+
+	// Construct with the given seed. The same seed always gives the same sequence
+	explicit CRandom( const TUInt64 seed = 0 )
+	{
+		Seed( seed );
+	}
+
+
+	/*-----------------------------------------------------------------------------------------
+		Seeding
+	-----------------------------------------------------------------------------------------*/
+
+	// Restart the generator with the given seed. Any seed is valid, similar seeds give unrelated
+	// sequences
+	void Seed( const TUInt64 seed );
+
+
+	/*-----------------------------------------------------------------------------------------
+		Single values
+	-----------------------------------------------------------------------------------------*/
+
+	// Return 32 random bits
+	TUInt32 Next()
+	{
+		TUInt32 result = RotateLeft( maState[1] * 5, 7 ) * 9;
+		TUInt32 t = maState[1] << 9;
+		maState[2] ^= maState[0];
+		maState[3] ^= maState[1];
+		maState[1] ^= maState[2];
+		maState[0] ^= maState[3];
+		maState[2] ^= t;
+		maState[3] = RotateLeft( maState[3], 11 );
+		return result;
+	}
+
+	// Return random integer from a to b (inclusive). Any range is supported, the bias towards some
+	// values is negligible (below 1 in 2^32 / range)
+	TInt32 Int( const TInt32 a, const TInt32 b )
+	{
+		TUInt32 range = static_cast<TUInt32>(b) - static_cast<TUInt32>(a) + 1;
+		if (range == 0)  return static_cast<TInt32>(Next()); // Full 32-bit range
+		return static_cast<TInt32>(static_cast<TUInt32>(a) +
+		                           static_cast<TUInt32>((static_cast<TUInt64>(Next()) * range) >> 32));
+	}
+
+	// Return random float in the range [0, 1), with 24 bits of precision
+	TFloat32 Float()
+	{
+		return static_cast<TFloat32>(Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Return random float in the range [a, b)
+	TFloat32 Float( const TFloat32 a, const TFloat32 b )
+	{
+		return a + (b - a) * Float();
+	}
+
+	// Return random unit vector, evenly distributed over all directions
+	CVector3 UnitVector();
+
+	// Return random point on the surface of a sphere, evenly distributed
+	CVector3 PointOnSphere
+	(
+		const CVector3& centre,
+		const TFloat32  radius
+	)
+	{
+		return centre + UnitVector() * radius;
+	}
+
+
+	/*-----------------------------------------------------------------------------------------
+		Batch generation
+	-----------------------------------------------------------------------------------------*/
+	// Fill arrays with random values, four at a time, much faster than a loop of single values.
+	// Floats have 23 bits of precision, otherwise the results are as the single value versions
+
+	// Fill an array with random floats in the range [0, 1)
+	void Floats
+	(
+		TFloat32*    aOut,
+		const size_t count
+	);
+
+	// Fill an array with random floats in the range [a, b)
+	void Floats
+	(
+		const TFloat32 a,
+		const TFloat32 b,
+		TFloat32*      aOut,
+		const size_t   count
+	);
+
+	// Fill an array with random unit vectors, evenly distributed over all directions
+	void UnitVectors
+	(
+		CVector3*    aOut,
+		const size_t count
+	);
+
+	// Fill an array with random points on the surface of a sphere, evenly distributed
+	void PointsOnSphere
+	(
+		const CVector3& centre,
+		const TFloat32  radius,
+		CVector3*       aOut,
+		const size_t    count
+	);
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Rotate the bits of x left by the given amount (1 to 31)
+	static TUInt32 RotateLeft( const TUInt32 x, const int bits )
+	{
+		return (x << bits) | (x >> (32 - bits));
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Data
+---------------------------------------------------------------------------------------------*/
+private:
+	TUInt32 maState[4];        // xoshiro128** state for single values
+	TUInt32 maLaneState[4][4]; // xoshiro128+ state for batches, element i of the state of each
+	                           // lane is in maLaneState[i] so it loads as one SIMD register
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Per-thread generator
+-----------------------------------------------------------------------------------------*/
+
+// Return a generator for the calling thread. Each thread's generator is created on first use with
+// a different seed, so threads get independent sequences with no locking. The sequences differ
+// from run to run if threads start in a different order - use a CRandom with a fixed seed where
+// repeatable results are needed
+CRandom& ThreadRandom();
+
+
+} // namespace gen
+
+#endif // GEN_C_RANDOM_H_INCLUDED
@@ -0,0 +1,503 @@
+/**************************************************************************************************
+	Module:       CSplinePath.cpp
+
+	Implementation of the concrete class CSplinePath, a smooth path through 3D space made of cubic
+	Catmull-Rom or Bezier segments, evaluated by distance along the path for constant speed
+	movement
+
+	Change history:
+		V1.0    Created with Catmull-Rom and Bezier paths and arc-length tables
+		V1.1    Batch functions look up four distances at once
+**************************************************************************************************/
+
+#include <algorithm>
+
+#include "CSplinePath.h"
+#include "MathSIMD.h"
+
+namespace gen
+{
+
+// The batch functions load segments directly as packed floats
+static_assert( sizeof(CVector3) == 3 * sizeof(TFloat32), "CVector3 must be three packed floats" );
+
+
+/*-----------------------------------------------------------------------------------------
+	Constructors
+-----------------------------------------------------------------------------------------*/
+
+// Construct from an array of points
+CSplinePath::CSplinePath
+(
+	const CVector3*   aPoints,
+	const size_t      numPoints,
+	const ESplineType type /*= kCatmullRom*/,
+	const bool        bClosed /*= false*/,
+	const TUInt32     samplesPerSegment /*= 16*/
+) : mbClosed( false ), mSamplesPerSegment( Max( samplesPerSegment, 1u ) )
+{
+	if (type == kCatmullRom)
+	{
+		if (numPoints < (bClosed ? 3u : 2u))  return;
+		mbClosed = bClosed;
+
+		// Tangent at each point is half the vector between its neighbours. The ends of an open path
+		// have only one neighbour, so use a neighbour reflected through the end point instead
+		size_t numSegments = bClosed ? numPoints : numPoints - 1;
+		for (size_t i = 0; i < numSegments; ++i)
+		{
+			const CVector3& p1 = aPoints[i];
+			const CVector3& p2 = aPoints[(i + 1) % numPoints];
+			CVector3 p0, p3;
+			if (bClosed)
+			{
+				p0 = aPoints[(i + numPoints - 1) % numPoints];
+				p3 = aPoints[(i + 2) % numPoints];
+			}
+			else
+			{
+				p0 = (i > 0) ? aPoints[i - 1] : p1 * 2.0f - p2;
+				p3 = (i + 2 < numPoints) ? aPoints[i + 2] : p2 * 2.0f - p1;
+			}
+			AddHermiteSegment( p1, (p2 - p0) * 0.5f, p2, (p3 - p1) * 0.5f );
+		}
+	}
+	else // kBezier
+	{
+		if (bClosed || numPoints < 4 || (numPoints - 1) % 3 != 0)  return;
+
+		// The tangents at the ends of a Bezier segment are three times the vectors to the control
+		// points
+		for (size_t i = 0; i + 3 < numPoints; i += 3)
+		{
+			AddHermiteSegment( aPoints[i], (aPoints[i + 1] - aPoints[i]) * 3.0f,
+			                   aPoints[i + 3], (aPoints[i + 3] - aPoints[i + 2]) * 3.0f );
+		}
+	}
+
+	// Build the distance table. The length of each step between samples is the integral of the
+	// speed |dp/du|, found with 3-point Gauss-Legendre quadrature - exact for the polynomial part
+	// and far more accurate than the chord length. The speed at each sample is also stored for
+	// FindSegment, at both ends of each step as the speed can jump between Bezier segments
+	const TFloat32 kaGaussPoints[3] = { 0.1127016654f, 0.5f, 0.8872983346f };
+	const TFloat32 kaGaussWeights[3] = { 5.0f / 18.0f, 8.0f / 18.0f, 5.0f / 18.0f };
+	const TFloat32 step = 1.0f / mSamplesPerSegment;
+	maDistances.reserve( maSegments.size() * mSamplesPerSegment + 1 );
+	maSpeeds.reserve( maSegments.size() * mSamplesPerSegment * 2 );
+	maDistances.push_back( 0.0f );
+	TFloat32 distance = 0.0f;
+	for (const SSegment& segment : maSegments)
+	{
+		for (TUInt32 sample = 0; sample < mSamplesPerSegment; ++sample)
+		{
+			for (TUInt32 end = 0; end < 2; ++end)
+			{
+				TFloat32 u = (sample + end) * step;
+				maSpeeds.push_back( ((segment.a * (3.0f * u) + segment.b * 2.0f) * u + segment.c).Length() );
+			}
+
+			TFloat32 stepLength = 0.0f;
+			for (int point = 0; point < 3; ++point)
+			{
+				TFloat32 u = (sample + kaGaussPoints[point]) * step;
+				CVector3 velocity = (segment.a * (3.0f * u) + segment.b * 2.0f) * u + segment.c;
+				stepLength += velocity.Length() * kaGaussWeights[point];
+			}
+			distance += stepLength * step;
+			maDistances.push_back( distance );
+		}
+	}
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Evaluation
+-----------------------------------------------------------------------------------------*/
+
+// Return the position at the given distance along the path
+CVector3 CSplinePath::GetPosition( const TFloat32 distance ) const
+{
+	if (maSegments.empty())  return CVector3::kZero;
+	size_t index;
+	TFloat32 u;
+	FindSegment( distance, index, u );
+	const SSegment& segment = maSegments[index];
+	return ((segment.a * u + segment.b) * u + segment.c) * u + segment.d;
+}
+
+// Return the unit direction of travel at the given distance along the path
+CVector3 CSplinePath::GetDirection( const TFloat32 distance ) const
+{
+	if (maSegments.empty())  return CVector3::kZero;
+	size_t index;
+	TFloat32 u;
+	FindSegment( distance, index, u );
+	const SSegment& segment = maSegments[index];
+	return Normalise( (segment.a * (3.0f * u) + segment.b * 2.0f) * u + segment.c );
+}
+
+// Return a world matrix for an object at the given distance along the path
+CMatrix4x4 CSplinePath::GetMatrix
+(
+	const TFloat32  distance,
+	const CVector3& up /*= CVector3::kYAxis*/
+) const
+{
+	return MatrixFaceDirection( GetPosition( distance ), GetDirection( distance ), up );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch evaluation
+-----------------------------------------------------------------------------------------*/
+// Each group of four distances is looked up in the distance table together (FindSegments), then
+// the four segments are loaded and transposed to SoA form to evaluate the polynomials together.
+// The scalar build uses the single versions since emulating the lanes would be slower
+
+#if !defined(GEN_SIMD_NONE)
+
+// Segment polynomials for four distances in SoA form, and the curve parameter for each
+struct SSegmentGroup
+{
+	TFloat32x4 a[3], b[3], c[3], d[3];
+	TFloat32x4 u;
+};
+
+// Load four segments (each 12 floats) and their curve parameters into SoA form
+static inline void LoadGroup
+(
+	const TFloat32* const apSegments[4],
+	const TFloat32*       au,
+	SSegmentGroup&        group
+)
+{
+	// Load as (a.x a.y a.z b.x) (b.y b.z c.x c.y) (c.z d.x d.y d.z) and transpose. Each row is
+	// named rather than in an array so they stay in registers
+	TFloat32x4 row00 = Load4Unaligned( apSegments[0] ),     row01 = Load4Unaligned( apSegments[1] );
+	TFloat32x4 row02 = Load4Unaligned( apSegments[2] ),     row03 = Load4Unaligned( apSegments[3] );
+	TFloat32x4 row10 = Load4Unaligned( apSegments[0] + 4 ), row11 = Load4Unaligned( apSegments[1] + 4 );
+	TFloat32x4 row12 = Load4Unaligned( apSegments[2] + 4 ), row13 = Load4Unaligned( apSegments[3] + 4 );
+	TFloat32x4 row20 = Load4Unaligned( apSegments[0] + 8 ), row21 = Load4Unaligned( apSegments[1] + 8 );
+	TFloat32x4 row22 = Load4Unaligned( apSegments[2] + 8 ), row23 = Load4Unaligned( apSegments[3] + 8 );
+	Transpose4( row00, row01, row02, row03 );
+	Transpose4( row10, row11, row12, row13 );
+	Transpose4( row20, row21, row22, row23 );
+	group.a[0] = row00;  group.a[1] = row01;  group.a[2] = row02;
+	group.b[0] = row03;  group.b[1] = row10;  group.b[2] = row11;
+	group.c[0] = row12;  group.c[1] = row13;  group.c[2] = row20;
+	group.d[0] = row21;  group.d[1] = row22;  group.d[2] = row23;
+	group.u = Load4Unaligned( au );
+}
+
+// Get the positions and optionally the (non-normalised) velocities of a group of segments
+static inline void EvaluateGroup
+(
+	const SSegmentGroup& group,
+	TFloat32x4*          aPosition,
+	TFloat32x4*          aVelocity
+)
+{
+	const TFloat32x4 u = group.u;
+	const TFloat32x4 u3 = Mul4( u, Splat4( 3.0f ) );
+	const TFloat32x4 two = Splat4( 2.0f );
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		aPosition[axis] = MulAdd4( MulAdd4( MulAdd4( group.a[axis], u, group.b[axis] ), u, group.c[axis] ), u, group.d[axis] );
+		if (aVelocity)
+		{
+			aVelocity[axis] = MulAdd4( MulAdd4( group.a[axis], u3, Mul4( group.b[axis], two ) ), u, group.c[axis] );
+		}
+	}
+}
+
+#endif // !GEN_SIMD_NONE
+
+
+// Get the positions at an array of distances along the path
+void CSplinePath::GetPositions
+(
+	const TFloat32* aDistances,
+	CVector3*       aOut,
+	const size_t    count
+) const
+{
+#if defined(GEN_SIMD_NONE)
+	for (size_t i = 0; i < count; ++i)  aOut[i] = GetPosition( aDistances[i] );
+#else
+	if (maSegments.empty())
+	{
+		for (size_t i = 0; i < count; ++i)  aOut[i] = CVector3::kZero;
+		return;
+	}
+
+	SSegmentGroup group;
+	TFloat32x4 aPosition[3];
+	CVector3 aGroup[4];
+	for (size_t i = 0; i < count; i += 4)
+	{
+		// A final group of fewer than four is padded with copies of the last distance
+		const TFloat32* pDistances = &aDistances[i];
+		TFloat32 aFinalDistances[4];
+		if (i + 4 > count)
+		{
+			for (size_t lane = 0; lane < 4; ++lane)  aFinalDistances[lane] = aDistances[Min( i + lane, count - 1 )];
+			pDistances = aFinalDistances;
+		}
+		size_t aIndices[4];
+		TFloat32 au[4];
+		FindSegments( pDistances, aIndices, au );
+		const TFloat32* apSegments[4];
+		for (size_t lane = 0; lane < 4; ++lane)  apSegments[lane] = &maSegments[aIndices[lane]].a.x;
+		LoadGroup( apSegments, au, group );
+		EvaluateGroup( group, aPosition, 0 );
+
+		// Convert to AoS, as (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+		const TFloat32x4& x = aPosition[0];
+		const TFloat32x4& y = aPosition[1];
+		const TFloat32x4& z = aPosition[2];
+		TFloat32* pOut = (i + 4 <= count) ? &aOut[i].x : &aGroup[0].x;
+		TFloat32x4 xy01 = Shuffle4<0, 1, 0, 1>( x, y ); // x0 x1 y0 y1
+		TFloat32x4 xy23 = Shuffle4<2, 3, 2, 3>( x, y ); // x2 x3 y2 y3
+		TFloat32x4 zx01 = Shuffle4<0, 0, 1, 1>( z, x ); // z0 z0 x1 x1
+		TFloat32x4 zx23 = Shuffle4<2, 2, 3, 3>( z, x ); // z2 z2 x3 x3
+		TFloat32x4 yz1  = Shuffle4<1, 1, 1, 1>( y, z ); // y1 y1 z1 z1
+		TFloat32x4 yz3  = Shuffle4<3, 3, 3, 3>( y, z ); // y3 y3 z3 z3
+		Store4Unaligned( pOut,     Shuffle4<0, 2, 0, 2>( xy01, zx01 ) );
+		Store4Unaligned( pOut + 4, Shuffle4<0, 2, 0, 2>( yz1, xy23 ) );
+		Store4Unaligned( pOut + 8, Shuffle4<0, 2, 0, 2>( zx23, yz3 ) );
+		if (i + 4 > count)
+		{
+			for (size_t j = i; j < count; ++j)  aOut[j] = aGroup[j - i];
+		}
+	}
+#endif
+}
+
+// Get world matrices at an array of distances along the path
+void CSplinePath::GetMatrices
+(
+	const TFloat32* aDistances,
+	CMatrix4x4*     aOut,
+	const size_t    count,
+	const CVector3& up /*= CVector3::kYAxis*/
+) const
+{
+#if defined(GEN_SIMD_NONE)
+	for (size_t i = 0; i < count; ++i)  aOut[i] = GetMatrix( aDistances[i], up );
+#else
+	if (maSegments.empty())
+	{
+		for (size_t i = 0; i < count; ++i)  aOut[i].MakeIdentity();
+		return;
+	}
+
+	const TFloat32x4 aUp[3] = { Splat4( up.x ), Splat4( up.y ), Splat4( up.z ) };
+	const TFloat32x4 zero = Zero4();
+	const TFloat32x4 one = Splat4( 1.0f );
+	const TFloat32x4 epsilon = Splat4( kfEpsilon );
+
+	SSegmentGroup group;
+	TFloat32x4 aPosition[3], aAxisZ[3];
+	for (size_t i = 0; i < count; i += 4)
+	{
+		// A final group of fewer than four is padded with copies of the last distance
+		const TFloat32* pDistances = &aDistances[i];
+		TFloat32 aFinalDistances[4];
+		if (i + 4 > count)
+		{
+			for (size_t lane = 0; lane < 4; ++lane)  aFinalDistances[lane] = aDistances[Min( i + lane, count - 1 )];
+			pDistances = aFinalDistances;
+		}
+		size_t aIndices[4];
+		TFloat32 au[4];
+		FindSegments( pDistances, aIndices, au );
+		const TFloat32* apSegments[4];
+		for (size_t lane = 0; lane < 4; ++lane)  apSegments[lane] = &maSegments[aIndices[lane]].a.x;
+		LoadGroup( apSegments, au, group );
+		EvaluateGroup( group, aPosition, aAxisZ );
+
+		// Axes as MatrixFaceDirection: Z along the velocity, X = up x Z, Y = Z x X. Lanes where
+		// either cross product is zero length get no rotation as that function does
+		TFloat32x4 lengthSqZ = MulAdd4( aAxisZ[2], aAxisZ[2], MulAdd4( aAxisZ[1], aAxisZ[1], Mul4( aAxisZ[0], aAxisZ[0] ) ) );
+		TFloat32x4 invLengthZ = Div4( one, Sqrt4( lengthSqZ ) );
+		for (int axis = 0; axis < 3; ++axis)  aAxisZ[axis] = Mul4( aAxisZ[axis], invLengthZ );
+		TFloat32x4 aAxisX[3] =
+		{
+			NegMulAdd4( aUp[2], aAxisZ[1], Mul4( aUp[1], aAxisZ[2] ) ),
+			NegMulAdd4( aUp[0], aAxisZ[2], Mul4( aUp[2], aAxisZ[0] ) ),
+			NegMulAdd4( aUp[1], aAxisZ[0], Mul4( aUp[0], aAxisZ[1] ) ),
+		};
+		TFloat32x4 lengthSqX = MulAdd4( aAxisX[2], aAxisX[2], MulAdd4( aAxisX[1], aAxisX[1], Mul4( aAxisX[0], aAxisX[0] ) ) );
+		TFloat32x4 invLengthX = Div4( one, Sqrt4( lengthSqX ) );
+		for (int axis = 0; axis < 3; ++axis)  aAxisX[axis] = Mul4( aAxisX[axis], invLengthX );
+		TFloat32x4 aAxisY[3] =
+		{
+			NegMulAdd4( aAxisZ[2], aAxisX[1], Mul4( aAxisZ[1], aAxisX[2] ) ),
+			NegMulAdd4( aAxisZ[0], aAxisX[2], Mul4( aAxisZ[2], aAxisX[0] ) ),
+			NegMulAdd4( aAxisZ[1], aAxisX[0], Mul4( aAxisZ[0], aAxisX[1] ) ),
+		};
+		TFloat32x4 valid = And4( GreaterEqual4( lengthSqZ, epsilon ), GreaterEqual4( lengthSqX, epsilon ) );
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			aAxisX[axis] = Select4( valid, aAxisX[axis], axis == 0 ? one : zero );
+			aAxisY[axis] = Select4( valid, aAxisY[axis], axis == 1 ? one : zero );
+			aAxisZ[axis] = Select4( valid, aAxisZ[axis], axis == 2 ? one : zero );
+		}
+
+		// Each axis transposes to the same row of four matrices
+		TFloat32x4 aMatrixRows[4][4] =
+		{
+			{ aAxisX[0], aAxisX[1], aAxisX[2], zero },
+			{ aAxisY[0], aAxisY[1], aAxisY[2], zero },
+			{ aAxisZ[0], aAxisZ[1], aAxisZ[2], zero },
+			{ aPosition[0], aPosition[1], aPosition[2], one },
+		};
+		for (int row = 0; row < 4; ++row)
+		{
+			TFloat32x4* r = aMatrixRows[row];
+			Transpose4( r[0], r[1], r[2], r[3] );
+		}
+		for (size_t lane = 0; lane < 4 && i + lane < count; ++lane)
+		{
+			TFloat32* pOut = &aOut[i + lane].e00;
+			for (int row = 0; row < 4; ++row)  Store4( pOut + 4 * row, aMatrixRows[row][lane] );
+		}
+	}
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Private interface
+-----------------------------------------------------------------------------------------*/
+
+// Add a segment from its Hermite form
+void CSplinePath::AddHermiteSegment
+(
+	const CVector3& p0,
+	const CVector3& t0,
+	const CVector3& p1,
+	const CVector3& t1
+)
+{
+	// Collect the terms of the Hermite basis functions by power of u
+	SSegment segment;
+	segment.a = p0 * 2.0f + t0 - p1 * 2.0f + t1;
+	segment.b = p1 * 3.0f - p0 * 3.0f - t0 * 2.0f - t1;
+	segment.c = t0;
+	segment.d = p0;
+	maSegments.push_back( segment );
+}
+
+// Convert a distance along the path to a segment index and the curve parameter u within it
+void CSplinePath::FindSegment
+(
+	TFloat32  distance,
+	size_t&   segment,
+	TFloat32& u
+) const
+{
+	TFloat32 length = GetLength();
+	if (mbClosed && length > 0.0f)
+	{
+		distance -= Floor( distance / length ) * length;
+	}
+	distance = Max( 0.0f, Min( distance, length ) );
+
+	// Find the step between samples containing the distance, then the position within that step
+	size_t numSteps = maDistances.size() - 1;
+	size_t step = upper_bound( maDistances.begin(), maDistances.end(), distance ) - maDistances.begin();
+	step = (step == 0) ? 0 : Min( step - 1, numSteps - 1 );
+	TFloat32 stepLength = maDistances[step + 1] - maDistances[step];
+	TFloat32 fraction = (stepLength > 0.0f) ? Min( (distance - maDistances[step]) / stepLength, 1.0f ) : 0.0f;
+
+	// Taking u as proportional to distance within the step is poor where the speed changes quickly.
+	// Instead use a cubic Hermite curve for u against distance, with slopes 1 / speed at the samples.
+	// The slopes are scaled to the step and limited to 3 so u keeps increasing (Fritsch-Carlson),
+	// which also handles speeds near zero at cusps
+	TFloat32 stepU = 1.0f / mSamplesPerSegment;
+	TFloat32 move0 = stepU * maSpeeds[2 * step]; // Distance the step would cover at the speeds at its ends
+	TFloat32 move1 = stepU * maSpeeds[2 * step + 1];
+	TFloat32 slope0 = (3.0f * move0 > stepLength) ? stepLength / move0 : 3.0f;
+	TFloat32 slope1 = (3.0f * move1 > stepLength) ? stepLength / move1 : 3.0f;
+	TFloat32 f2 = fraction * fraction;
+	TFloat32 f3 = f2 * fraction;
+	fraction = (3.0f * f2 - 2.0f * f3) + slope0 * (f3 - 2.0f * f2 + fraction) + slope1 * (f3 - f2);
+
+	segment = step / mSamplesPerSegment;
+	u = (static_cast<TFloat32>(step % mSamplesPerSegment) + fraction) * stepU;
+}
+
+// Convert four distances along the path to segment indices and curve parameters, as FindSegment.
+// The four table searches are branchless and interleaved so their loads overlap, then the curve
+// parameters are found together
+void CSplinePath::FindSegments
+(
+	const TFloat32* aDistances,
+	size_t*         aSegments,
+	TFloat32*       au
+) const
+{
+	// Wrap and clamp the distances as FindSegment. Floor is the rounded value less one where that
+	// rounded up, and the value itself where it is too large to have a fraction
+	const TFloat32x4 zero = Zero4();
+	const TFloat32x4 one = Splat4( 1.0f );
+	TFloat32 length = GetLength();
+	TFloat32x4 distance = Load4Unaligned( aDistances );
+	if (mbClosed && length > 0.0f)
+	{
+		TFloat32x4 laps = Div4( distance, Splat4( length ) );
+		TFloat32x4 rounded = Round4( laps );
+		TFloat32x4 wholeLaps = Sub4( rounded, And4( Greater4( rounded, laps ), one ) );
+		wholeLaps = Select4( GreaterEqual4( Abs4( laps ), Splat4( 8388608.0f ) ), laps, wholeLaps );
+		distance = Sub4( distance, Mul4( wholeLaps, Splat4( length ) ) );
+	}
+	distance = Max4( zero, Min4( distance, Splat4( length ) ) );
+	TFloat32 aDistance[4];
+	Store4Unaligned( aDistance, distance );
+
+	// Last step whose start is not beyond the distance - the same step as the upper_bound in
+	// FindSegment. Each pass halves the range of steps still possible for every lane. The lanes are
+	// written out so the steps stay in registers
+	const TFloat32* pTable = &maDistances[0];
+	size_t step0 = 0, step1 = 0, step2 = 0, step3 = 0;
+	for (size_t range = maDistances.size() - 1; range > 1; )
+	{
+		size_t half = range / 2;
+		step0 = (pTable[step0 + half] <= aDistance[0]) ? step0 + half : step0;
+		step1 = (pTable[step1 + half] <= aDistance[1]) ? step1 + half : step1;
+		step2 = (pTable[step2 + half] <= aDistance[2]) ? step2 + half : step2;
+		step3 = (pTable[step3 + half] <= aDistance[3]) ? step3 + half : step3;
+		range -= half;
+	}
+	const size_t aStep[4] = { step0, step1, step2, step3 };
+
+	// Position within each step as FindSegment, with the same operations so the results match
+	const TFloat32* pSpeeds = &maSpeeds[0];
+	TFloat32x4 start = Set4( pTable[aStep[0]], pTable[aStep[1]], pTable[aStep[2]], pTable[aStep[3]] );
+	TFloat32x4 end = Set4( pTable[aStep[0] + 1], pTable[aStep[1] + 1], pTable[aStep[2] + 1], pTable[aStep[3] + 1] );
+	TFloat32x4 speed0 = Set4( pSpeeds[2 * aStep[0]], pSpeeds[2 * aStep[1]], pSpeeds[2 * aStep[2]], pSpeeds[2 * aStep[3]] );
+	TFloat32x4 speed1 = Set4( pSpeeds[2 * aStep[0] + 1], pSpeeds[2 * aStep[1] + 1], pSpeeds[2 * aStep[2] + 1], pSpeeds[2 * aStep[3] + 1] );
+
+	const TFloat32x4 two = Splat4( 2.0f );
+	const TFloat32x4 three = Splat4( 3.0f );
+	TFloat32 stepU = 1.0f / mSamplesPerSegment;
+	TFloat32x4 stepLength = Sub4( end, start );
+	TFloat32x4 fraction = Select4( Greater4( stepLength, zero ), Min4( Div4( Sub4( distance, start ), stepLength ), one ), zero );
+	TFloat32x4 move0 = Mul4( Splat4( stepU ), speed0 );
+	TFloat32x4 move1 = Mul4( Splat4( stepU ), speed1 );
+	TFloat32x4 slope0 = Select4( Greater4( Mul4( three, move0 ), stepLength ), Div4( stepLength, move0 ), three );
+	TFloat32x4 slope1 = Select4( Greater4( Mul4( three, move1 ), stepLength ), Div4( stepLength, move1 ), three );
+	TFloat32x4 f2 = Mul4( fraction, fraction );
+	TFloat32x4 f3 = Mul4( f2, fraction );
+	fraction = Add4( Add4( Sub4( Mul4( three, f2 ), Mul4( two, f3 ) ), Mul4( slope0, Add4( Sub4( f3, Mul4( two, f2 ) ), fraction ) ) ),
+	                 Mul4( slope1, Sub4( f3, f2 ) ) );
+
+	for (int lane = 0; lane < 4; ++lane)  aSegments[lane] = aStep[lane] / mSamplesPerSegment;
+	TFloat32x4 stepInSegment = Set4( static_cast<TFloat32>(aStep[0] % mSamplesPerSegment), static_cast<TFloat32>(aStep[1] % mSamplesPerSegment),
+	                                 static_cast<TFloat32>(aStep[2] % mSamplesPerSegment), static_cast<TFloat32>(aStep[3] % mSamplesPerSegment) );
+	Store4Unaligned( au, Mul4( Add4( stepInSegment, fraction ), Splat4( stepU ) ) );
+}
+
+
+} // namespace gen
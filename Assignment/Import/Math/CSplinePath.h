@@ -0,0 +1,240 @@
+/**************************************************************************************************
+	Module:       CSplinePath.h
+
+	Definition of the concrete class CSplinePath, a smooth path through 3D space made of cubic
+	Catmull-Rom or Bezier segments, evaluated by distance along the path for constant speed
+	movement. Batch functions evaluate many positions or world matrices at once using SIMD. Also
+	Hermite, Catmull-Rom and Bezier curve functions for single values
+
+	Change history:
+		V1.0    Created with Catmull-Rom and Bezier paths and arc-length tables
+		V1.1    Batch functions look up four distances at once
+**************************************************************************************************/
+
+#ifndef GEN_C_SPLINE_PATH_H_INCLUDED
+#define GEN_C_SPLINE_PATH_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "GenDefines.h"
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Curve functions
+-----------------------------------------------------------------------------------------*/
+// Points on a single cubic curve segment at parameter u from 0 (start of segment) to 1 (end).
+// The parameter does not move at constant speed along the curve, see CSplinePath for that
+
+// Hermite curve from p0 to p1 with tangents t0 and t1 at those points
+inline CVector3 Hermite
+(
+	const CVector3& p0,
+	const CVector3& t0,
+	const CVector3& p1,
+	const CVector3& t1,
+	const TFloat32  u
+)
+{
+	TFloat32 u2 = u * u;
+	TFloat32 u3 = u2 * u;
+	return p0 * (2.0f * u3 - 3.0f * u2 + 1.0f) + t0 * (u3 - 2.0f * u2 + u) +
+	       p1 * (3.0f * u2 - 2.0f * u3)        + t1 * (u3 - u2);
+}
+
+// Catmull-Rom curve from p1 to p2, a Hermite curve with tangents taken from the neighbouring
+// points p0 and p3. Consecutive segments through a list of points join smoothly
+inline CVector3 CatmullRom
+(
+	const CVector3& p0,
+	const CVector3& p1,
+	const CVector3& p2,
+	const CVector3& p3,
+	const TFloat32  u
+)
+{
+	return Hermite( p1, (p2 - p0) * 0.5f, p2, (p3 - p1) * 0.5f, u );
+}
+
+// Cubic Bezier curve from p0 to p1 with control points c0 and c1, which the curve heads towards
+// but does not pass through
+inline CVector3 Bezier
+(
+	const CVector3& p0,
+	const CVector3& c0,
+	const CVector3& c1,
+	const CVector3& p1,
+	const TFloat32  u
+)
+{
+	TFloat32 v = 1.0f - u;
+	return p0 * (v * v * v) + c0 * (3.0f * v * v * u) + c1 * (3.0f * v * u * u) + p1 * (u * u * u);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Spline paths
+-----------------------------------------------------------------------------------------*/
+
+// Types of curve used for a path
+enum ESplineType
+{
+	kCatmullRom, // Passes through every point
+	kBezier,     // Points are p0, c0, c1, p1, c2, c3, p2... passing through p0, p1, p2... only
+};
+
+// Path made of cubic segments, evaluated by distance from the start. A table of distances along
+// the path is built on construction so evaluation moves at constant speed, which the curve
+// parameter does not. With the default samples per segment the speed is typically within 0.1% of
+// constant, but less accurate near sharp corners where the curve almost stops (e.g. when points
+// nearly double back) - increase the samples for paths with tight bends
+class CSplinePath
+{
+// Concrete class - public access
+public:
+	/*-----------------------------------------------------------------------------------------
+		Constructors
+	-----------------------------------------------------------------------------------------*/
+
+	// Construct from an array of points. A Catmull-Rom path passes through all the points, needing
+	// at least two. A closed Catmull-Rom path returns from the last point to the first. A Bezier
+	// path needs 3n + 1 points for n segments, see ESplineType, and cannot be closed (repeat the
+	// first point at the end instead). Invalid arguments leave the path empty (length zero)
+	CSplinePath
+	(
+		const CVector3*   aPoints,
+		const size_t      numPoints,
+		const ESplineType type = kCatmullRom,
+		const bool        bClosed = false,
+		const TUInt32     samplesPerSegment = 16
+	);
+
+
+	/*-----------------------------------------------------------------------------------------
+		Getters
+	-----------------------------------------------------------------------------------------*/
+
+	size_t GetNumSegments() const
+	{
+		return maSegments.size();
+	}
+
+	bool IsClosed() const
+	{
+		return mbClosed;
+	}
+
+	// Length of the path, as measured by the distance table
+	TFloat32 GetLength() const
+	{
+		return maDistances.empty() ? 0.0f : maDistances.back();
+	}
+
+
+	/*-----------------------------------------------------------------------------------------
+		Evaluation
+	-----------------------------------------------------------------------------------------*/
+	// Distances are from the start of the path. Distances outside the path wrap around a closed
+	// path, and are clamped to the ends of an open one
+
+	// Return the position at the given distance along the path
+	CVector3 GetPosition( const TFloat32 distance ) const;
+
+	// Return the unit direction of travel at the given distance along the path
+	CVector3 GetDirection( const TFloat32 distance ) const;
+
+	// Return a world matrix for an object at the given distance along the path, with its Z axis
+	// facing the direction of travel and its Y axis towards the given up vector, as
+	// MatrixFaceDirection (left-handed)
+	CMatrix4x4 GetMatrix
+	(
+		const TFloat32  distance,
+		const CVector3& up = CVector3::kYAxis
+	) const;
+
+
+	/*-----------------------------------------------------------------------------------------
+		Batch evaluation
+	-----------------------------------------------------------------------------------------*/
+	// Evaluate the path at an array of distances, e.g. for many objects following the same path.
+	// Four distances are looked up and evaluated at once. Faster than single calls, by over 2x for
+	// matrices but less for positions, where the distance table search is most of the work
+
+	// Get the positions at an array of distances along the path
+	void GetPositions
+	(
+		const TFloat32* aDistances,
+		CVector3*       aOut,
+		const size_t    count
+	) const;
+
+	// Get world matrices at an array of distances along the path, as GetMatrix
+	void GetMatrices
+	(
+		const TFloat32* aDistances,
+		CMatrix4x4*     aOut,
+		const size_t    count,
+		const CVector3& up = CVector3::kYAxis
+	) const;
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// A segment as a cubic polynomial in u (0 to 1): position = ((a*u + b)*u + c)*u + d
+	struct SSegment
+	{
+		CVector3 a, b, c, d;
+	};
+
+	// Add a segment from its Hermite form
+	void AddHermiteSegment
+	(
+		const CVector3& p0,
+		const CVector3& t0,
+		const CVector3& p1,
+		const CVector3& t1
+	);
+
+	// Convert a distance along the path to a segment index and the curve parameter u within it
+	void FindSegment
+	(
+		TFloat32  distance,
+		size_t&   segment,
+		TFloat32& u
+	) const;
+
+	// Convert four distances along the path to segment indices and curve parameters, as
+	// FindSegment, for the batch functions
+	void FindSegments
+	(
+		const TFloat32* aDistances,
+		size_t*         aSegments,
+		TFloat32*       au
+	) const;
+
+
+/*---------------------------------------------------------------------------------------------
+	Data
+---------------------------------------------------------------------------------------------*/
+private:
+	vector<SSegment> maSegments;
+	bool             mbClosed;
+
+	// Distance table: maDistances[i] is the distance along the path at sample i, with samples at
+	// mSamplesPerSegment even steps of u in each segment, holding (segments * samples) + 1 entries.
+	// maSpeeds holds |dp/du| at the start and end of each step, two entries per step
+	vector<TFloat32> maDistances;
+	vector<TFloat32> maSpeeds;
+	TUInt32          mSamplesPerSegment;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_SPLINE_PATH_H_INCLUDED
@@ -129,16 +129,4 @@ TFloat32 DistanceSquared
 }
 
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
-
-// Standard vectors
-const CVector2 CVector2::kZero(0.0f, 0.0f);
-const CVector2 CVector2::kOne(1.0f, 1.0f);
-const CVector2 CVector2::kOrigin(0.0f, 0.0f);
-const CVector2 CVector2::kXAxis(1.0f, 0.0f);
-const CVector2 CVector2::kYAxis(0.0f, 1.0f);
-
-
 } // namespace gen
@@ -42,7 +42,7 @@ public:
 	CVector2() {}
 
 	// Construct by value
-	CVector2
+	constexpr CVector2
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn
@@ -66,7 +66,7 @@ public:
 
 
 	// Construct as vector between two points (p1 to p2)
-	CVector2
+	constexpr CVector2
 	(
 		const CVector2& p1,
 		const CVector2& p2
@@ -83,20 +83,10 @@ public:
 	// Require explicit conversion from CVector4 (see above)
 
 
-	// Copy constructor
-    CVector2( const CVector2& v ) : x( v.x ), y( v.y )
-	{}
-
-	// Assignment operator
-    CVector2& operator=( const CVector2& v )
-	{
-		if ( this != &v )
-		{
-			x = v.x;
-			y = v.y;
-		}
-		return *this;
-	}
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CVector2( const CVector2& v ) = default;
+	CVector2& operator=( const CVector2& v ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -104,7 +94,7 @@ public:
 	-----------------------------------------------------------------------------------------*/
 
 	// Set both vector components
-    void Set
+    constexpr void Set
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn
@@ -115,14 +105,14 @@ public:
 	}
 
 	// Set the vector through a pointer to two floats
-    void Set( const TFloat32* pfElts )
+    constexpr void Set( const TFloat32* pfElts )
 	{
 		x = pfElts[0];
 		y = pfElts[1];
 	}
 
 	// Set as vector between two points (p1 to p2)
-    void Set
+    constexpr void Set
 	(
 		const CVector2& p1,
 		const CVector2& p2
@@ -133,7 +123,7 @@ public:
 	}
 
 	// Set the vector to (0,0)
-    void SetZero()
+    constexpr void SetZero()
 	{
 		x = y = 0.0f;
 	}
@@ -185,7 +175,7 @@ public:
 	// Addition / subtraction
 
 	// Add another vector to this vector
-    CVector2& operator+=( const CVector2& v )
+    constexpr CVector2& operator+=( const CVector2& v )
 	{
 		x += v.x;
 		y += v.y;
@@ -193,7 +183,7 @@ public:
 	}
 
 	// Subtract another vector from this vector
-    CVector2& operator-=( const CVector2& v )
+    constexpr CVector2& operator-=( const CVector2& v )
 	{
 		x -= v.x;
 		y -= v.y;
@@ -205,7 +195,7 @@ public:
 	// Scalar multiplication & division
 
 	// Multiply this vector by a scalar
-	CVector2& operator*=( const TFloat32 s )
+	constexpr CVector2& operator*=( const TFloat32 s )
 	{
 		x *= s;
 		y *= s;
@@ -230,7 +220,7 @@ public:
 	// Other operations
 
 	// Set this vector to its perpendicular, in a counter-clockwise direction
-	void SetPerpendicular()
+	constexpr void SetPerpendicular()
 	{
 		TFloat32 t = x;
 		x = -y;
@@ -238,14 +228,14 @@ public:
 	}
 
 	// Return a vector perpendicular to this one, in a counter-clockwise direction
-	CVector2 Perpendicular()
+	constexpr CVector2 Perpendicular()
 	{
 		return CVector2(-y, x);
 	}
 
 
 	// Dot product of this with another vector
-    TFloat32 Dot( const CVector2& v ) const
+    constexpr TFloat32 Dot( const CVector2& v ) const
 	{
 	    return x*v.x + y*v.y;
 	}
@@ -253,7 +243,7 @@ public:
 	
 	// Cross product of this with another vector, both promoted to 3D with a z component of 0
 	// Result is positive if the other vector is counter-clockwise from this vector
-    CVector2 Cross3D( const CVector2& v ) const
+    constexpr CVector2 Cross3D( const CVector2& v ) const
 	{
 		return CVector2(y*v.x - x*v.y, x*v.y - y*v.x);
 	}
@@ -273,7 +263,7 @@ public:
 	// Return squared length of this vector
 	// More efficient than Length when exact value is not required (e.g. for comparisons)
 	// Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-	TFloat32 LengthSquared() const
+	constexpr TFloat32 LengthSquared() const
 	{
 		return x*x + y*y;
 	}
@@ -313,6 +303,19 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard vectors
+inline constexpr CVector2 CVector2::kZero(0.0f, 0.0f);
+inline constexpr CVector2 CVector2::kOne(1.0f, 1.0f);
+inline constexpr CVector2 CVector2::kOrigin(0.0f, 0.0f);
+inline constexpr CVector2 CVector2::kXAxis(1.0f, 0.0f);
+inline constexpr CVector2 CVector2::kYAxis(0.0f, 1.0f);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -347,7 +350,7 @@ inline bool operator!=
 // Addition / subtraction
 
 // Vector addition
-inline CVector2 operator+
+constexpr CVector2 operator+
 (
 	const CVector2& v1,
 	const CVector2& v2
@@ -357,7 +360,7 @@ inline CVector2 operator+
 }
 
 // Vector subtraction
-inline CVector2 operator-
+constexpr CVector2 operator-
 (
 	const CVector2& v1,
 	const CVector2& v2
@@ -367,13 +370,13 @@ inline CVector2 operator-
 }
 
 // Unary positive (i.e. a = +v, included for completeness)
-inline CVector2 operator+( const CVector2& v )
+constexpr CVector2 operator+( const CVector2& v )
 {
 	return v;
 }
 
 // Unary negation (i.e. a = -v)
-inline CVector2 operator-( const CVector2& v )
+constexpr CVector2 operator-( const CVector2& v )
 {
 	return CVector2(-v.x, -v.y);
 }
@@ -383,7 +386,7 @@ inline CVector2 operator-( const CVector2& v )
 // Scalar multiplication & division
 
 // Vector multiplied by scalar
-inline CVector2 operator*
+constexpr CVector2 operator*
 (
 	const CVector2& v,
 	const TFloat32  s
@@ -393,7 +396,7 @@ inline CVector2 operator*
 }
 
 // Scalar multiplied by vector
-inline CVector2 operator*
+constexpr CVector2 operator*
 (
 	const TFloat32  s,
 	const CVector2& v
@@ -422,14 +425,14 @@ inline CVector2 operator/
 // Other operations
 
 // Return a vector perpendicular to the given one, in a counter-clockwise direction
-inline CVector2 Perpendicular( const CVector2& v )
+constexpr CVector2 Perpendicular( const CVector2& v )
 {
 	return CVector2(-v.y, v.x);
 }
 
 
 // Dot product of two given vectors (order not important) - non-member version
-inline TFloat32 Dot
+constexpr TFloat32 Dot
 (
 	const CVector2& v1,
 	const CVector2& v2
@@ -441,7 +444,7 @@ inline TFloat32 Dot
 // Cross product of two given vectors (order is important), both promoted to 3D with a
 // z component of 0 - non-member version
 // Result is positive if the second vector is counter-clockwise from the first
-inline CVector2 Cross3D
+constexpr CVector2 Cross3D
 (
 	const CVector2& v1,
 	const CVector2& v2
@@ -463,7 +466,7 @@ inline TFloat32 Length( const CVector2& v )
 // Return squared length of given vector
 // More efficient than Length when exact value is not required (e.g. for comparisons)
 // Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-inline TFloat32 LengthSquared( const CVector2& v )
+constexpr TFloat32 LengthSquared( const CVector2& v )
 {
 	return v.x*v.x + v.y*v.y;
 }
@@ -128,17 +128,4 @@ TFloat32 DistanceSquared
 }
 
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
-
-// Standard vectors
-const CVector3 CVector3::kZero(0.0f, 0.0f, 0.0f);
-const CVector3 CVector3::kOne(1.0f, 1.0f, 1.0f);
-const CVector3 CVector3::kOrigin(0.0f, 0.0f, 0.0f);
-const CVector3 CVector3::kXAxis(1.0f, 0.0f, 0.0f);
-const CVector3 CVector3::kYAxis(0.0f, 1.0f, 0.0f);
-const CVector3 CVector3::kZAxis(0.0f, 0.0f, 1.0f);
-
-
 } // namespace gen
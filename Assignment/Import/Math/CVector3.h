@@ -42,7 +42,7 @@ public:
 	CVector3() {}
 
 	// Construct by value
-	CVector3
+	constexpr CVector3
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn,
@@ -68,7 +68,7 @@ public:
 
 
 	// Construct as vector between two points (p1 to p2)
-	CVector3
+	constexpr CVector3
 	(
 		const CVector3& p1,
 		const CVector3& p2
@@ -77,7 +77,7 @@ public:
 
 
 	// Construct from a CVector2 and a z value (defaults to 0)
-	explicit CVector3
+	constexpr explicit CVector3
 	(
 		const CVector2& v,
 		const TFloat32 zIn = 0.0f
@@ -90,21 +90,10 @@ public:
 	// Require explicit conversion from CVector4 (see above)
 
 
-	// Copy constructor, construct from CVector3
-    CVector3( const CVector3& v ) : x( v.x ), y( v.y ), z( v.z )
-	{}
-
-	// Assignment operator
-    CVector3& operator=( const CVector3& v )
-	{
-		if ( this != &v )
-		{
-			x = v.x;
-			y = v.y;
-			z = v.z;
-		}
-		return *this;
-	}
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CVector3( const CVector3& v ) = default;
+	CVector3& operator=( const CVector3& v ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -112,7 +101,7 @@ public:
 	-----------------------------------------------------------------------------------------*/
 
 	// Set all three vector components
-    void Set
+    constexpr void Set
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn,
@@ -125,7 +114,7 @@ public:
 	}
 
 	// Set the vector through a pointer to three floats
-    void Set( const TFloat32* pfElts )
+    constexpr void Set( const TFloat32* pfElts )
 	{
 		x = pfElts[0];
 		y = pfElts[1];
@@ -133,7 +122,7 @@ public:
 	}
 
 	// Set as vector between two points (p1 to p2)
-    void Set
+    constexpr void Set
 	(
 		const CVector3& p1,
 		const CVector3& p2
@@ -145,7 +134,7 @@ public:
 	}
 
 	// Set the vector to (0,0,0)
-    void SetZero()
+    constexpr void SetZero()
 	{
 		x = y = z = 0.0f;
 	}
@@ -218,7 +207,7 @@ public:
 	// Addition / subtraction
 
 	// Add another vector to this vector
-    CVector3& operator+=( const CVector3& v )
+    constexpr CVector3& operator+=( const CVector3& v )
 	{
 		x += v.x;
 		y += v.y;
@@ -227,7 +216,7 @@ public:
 	}
 
 	// Subtract another vector from this vector
-    CVector3& operator-=( const CVector3& v )
+    constexpr CVector3& operator-=( const CVector3& v )
 	{
 		x -= v.x;
 		y -= v.y;
@@ -240,7 +229,7 @@ public:
 	// Scalar multiplication & division
 
 	// Multiply this vector by a scalar
-	CVector3& operator*=( const TFloat32 s )
+	constexpr CVector3& operator*=( const TFloat32 s )
 	{
 		x *= s;
 		y *= s;
@@ -267,14 +256,14 @@ public:
 	// Other operations
 
 	// Dot product of this with another vector
-    TFloat32 Dot( const CVector3& v ) const
+    constexpr TFloat32 Dot( const CVector3& v ) const
 	{
 	    return x*v.x + y*v.y + z*v.z;
 	}
 	
 	
 	// Cross product of this with another vector
-    CVector3 Cross( const CVector3& v ) const
+    constexpr CVector3 Cross( const CVector3& v ) const
 	{
 		return CVector3(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x);
 	}
@@ -294,7 +283,7 @@ public:
 	// Return squared length of this vector
 	// More efficient than Length when exact value is not required (e.g. for comparisons)
 	// Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-	TFloat32 LengthSquared() const
+	constexpr TFloat32 LengthSquared() const
 	{
 		return x*x + y*y + z*z;
 	}
@@ -336,6 +325,20 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard vectors
+inline constexpr CVector3 CVector3::kZero(0.0f, 0.0f, 0.0f);
+inline constexpr CVector3 CVector3::kOne(1.0f, 1.0f, 1.0f);
+inline constexpr CVector3 CVector3::kOrigin(0.0f, 0.0f, 0.0f);
+inline constexpr CVector3 CVector3::kXAxis(1.0f, 0.0f, 0.0f);
+inline constexpr CVector3 CVector3::kYAxis(0.0f, 1.0f, 0.0f);
+inline constexpr CVector3 CVector3::kZAxis(0.0f, 0.0f, 1.0f);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -370,7 +373,7 @@ inline bool operator!=
 // Addition / subtraction
 
 // Vector addition
-inline CVector3 operator+
+constexpr CVector3 operator+
 (
 	const CVector3& v1,
 	const CVector3& v2
@@ -380,7 +383,7 @@ inline CVector3 operator+
 }
 
 // Vector subtraction
-inline CVector3 operator-
+constexpr CVector3 operator-
 (
 	const CVector3& v1,
 	const CVector3& v2
@@ -390,13 +393,13 @@ inline CVector3 operator-
 }
 
 // Unary positive (i.e. a = +v, included for completeness)
-inline CVector3 operator+( const CVector3& v )
+constexpr CVector3 operator+( const CVector3& v )
 {
 	return v;
 }
 
 // Unary negation (i.e. a = -v)
-inline CVector3 operator-( const CVector3& v )
+constexpr CVector3 operator-( const CVector3& v )
 {
 	return CVector3(-v.x, -v.y, -v.z);
 }
@@ -406,7 +409,7 @@ inline CVector3 operator-( const CVector3& v )
 // Scalar multiplication & division
 
 // Vector multiplied by scalar
-inline CVector3 operator*
+constexpr CVector3 operator*
 (
 	const CVector3& v,
 	const TFloat32  s
@@ -416,7 +419,7 @@ inline CVector3 operator*
 }
 
 // Scalar multiplied by vector
-inline CVector3 operator*
+constexpr CVector3 operator*
 (
 	const TFloat32  s,
 	const CVector3& v
@@ -445,7 +448,7 @@ inline CVector3 operator/
 // Other operations
 
 // Dot product of two given vectors (order not important) - non-member version
-inline TFloat32 Dot
+constexpr TFloat32 Dot
 (
 	const CVector3& v1,
 	const CVector3& v2
@@ -455,7 +458,7 @@ inline TFloat32 Dot
 }
 
 // Cross product of two given vectors (order is important) - non-member version
-inline CVector3 Cross
+constexpr CVector3 Cross
 (
 	const CVector3& v1,
 	const CVector3& v2
@@ -478,7 +481,7 @@ inline TFloat32 Length( const CVector3& v )
 // Return squared length of given vector
 // More efficient than Length when exact value is not required (e.g. for comparisons)
 // Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-inline TFloat32 LengthSquared( const CVector3& v )
+constexpr TFloat32 LengthSquared( const CVector3& v )
 {
 	return v.x*v.x + v.y*v.y + v.z*v.z;
 }
@@ -60,18 +60,4 @@ CVector4 Normalise( const CVector4& v )
 }
 
 
-/*---------------------------------------------------------------------------------------------
-	Static constants
----------------------------------------------------------------------------------------------*/
-
-// Standard vectors
-const CVector4 CVector4::kZero(0.0f, 0.0f, 0.0f, 0.0f);
-const CVector4 CVector4::kOne(1.0f, 1.0f, 1.0f, 1.0f);
-const CVector4 CVector4::kOrigin(0.0f, 0.0f, 0.0f, 0.0f);
-const CVector4 CVector4::kXAxis(1.0f, 0.0f, 0.0f, 0.0f);
-const CVector4 CVector4::kYAxis(0.0f, 1.0f, 0.0f, 0.0f);
-const CVector4 CVector4::kZAxis(0.0f, 0.0f, 1.0f, 0.0f);
-const CVector4 CVector4::kWAxis(0.0f, 0.0f, 0.0f ,1.0f);
-
-
 } // namespace gen
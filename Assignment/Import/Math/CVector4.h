@@ -39,7 +39,7 @@ public:
 	CVector4() {}
 
 	// Construct by value
-	CVector4
+	constexpr CVector4
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn,
@@ -67,7 +67,7 @@ public:
 
 
 	// Construct as vector between two 3D points (p1 to p2) and a w value (defaults to 0)
-	CVector4
+	constexpr CVector4
 	(
 		const CVector3& p1,
 		const CVector3& p2,
@@ -77,7 +77,7 @@ public:
 
 
 	// Construct from a CVector2 and z & w values (default to 0)
-	explicit CVector4
+	constexpr explicit CVector4
 	(
 		const CVector2& v,
 		const TFloat32 zIn = 0.0f,
@@ -87,7 +87,7 @@ public:
 	// Require explicit conversion from CVector2 (see above)
 
 	// Construct from a CVector3 and a w value (defaults to 0)
-	explicit CVector4
+	constexpr explicit CVector4
 	(
 		const CVector3& v,
 		const TFloat32 wIn = 0.0f
@@ -96,22 +96,10 @@ public:
 	// Require explicit conversion from CVector3 (see above)
 
 
-	// Copy constructor
-    CVector4( const CVector4& v ) : x( v.x ), y( v.y ), z( v.z ), w( v.w )
-	{}
-
-	// Assignment operator
-    CVector4& operator=( const CVector4& v )
-	{
-		if ( this != &v )
-		{
-			x = v.x;
-			y = v.y;
-			z = v.z;
-			w = v.w;
-		}
-		return *this;
-	}
+	// Copy constructor and assignment operator are the compiler generated versions so they can be
+	// used in constant expressions, and the class is trivially copyable
+	CVector4( const CVector4& v ) = default;
+	CVector4& operator=( const CVector4& v ) = default;
 
 
 	/*-----------------------------------------------------------------------------------------
@@ -119,7 +107,7 @@ public:
 	-----------------------------------------------------------------------------------------*/
 
 	// Set all four vector components
-    void Set
+    constexpr void Set
 	(
 		const TFloat32 xIn,
 		const TFloat32 yIn,
@@ -134,7 +122,7 @@ public:
 	}
 
 	// Set the vector through a pointer to four floats
-    void Set( const TFloat32* pfElts )
+    constexpr void Set( const TFloat32* pfElts )
 	{
 		x = pfElts[0];
 		y = pfElts[1];
@@ -143,7 +131,7 @@ public:
 	}
 
 	// Set as vector between two 3D points (p1 to p2) and a w value (defaults to 0)
-    void Set
+    constexpr void Set
 	(
 		const CVector3& p1,
 		const CVector3& p2,
@@ -157,7 +145,7 @@ public:
 	}
 
 	// Set the vector to (0,0,0,0)
-    void SetZero()
+    constexpr void SetZero()
 	{
 		x = y = z = w = 0.0f;
 	}
@@ -241,7 +229,7 @@ public:
 	// Addition / subtraction
 
 	// Add another vector to this vector
-    CVector4& operator+=( const CVector4& v )
+    constexpr CVector4& operator+=( const CVector4& v )
 	{
 		x += v.x;
 		y += v.y;
@@ -251,7 +239,7 @@ public:
 	}
 
 	// Subtract another vector from this vector
-    CVector4& operator-=( const CVector4& v )
+    constexpr CVector4& operator-=( const CVector4& v )
 	{
 		x -= v.x;
 		y -= v.y;
@@ -265,7 +253,7 @@ public:
 	// Scalar multiplication & division
 
 	// Multiply this vector by a scalar
-	CVector4& operator*=( const TFloat32 s )
+	constexpr CVector4& operator*=( const TFloat32 s )
 	{
 		x *= s;
 		y *= s;
@@ -294,14 +282,14 @@ public:
 	// Other operations
 
 	// Dot product of this with another vector
-    TFloat32 Dot( const CVector4& v ) const
+    constexpr TFloat32 Dot( const CVector4& v ) const
 	{
 	    return x*v.x + y*v.y + z*v.z + w*v.w;
 	}
 	
 	
 	// Cross product of this with another vector
-    CVector4 Cross(	const CVector4& v ) const
+    constexpr CVector4 Cross(	const CVector4& v ) const
 	{
 		return CVector4(y*v.z - z*v.y, z*v.w - w*v.z,
 		                w*v.x - x*v.w, x*v.y - y*v.x);
@@ -322,7 +310,7 @@ public:
 	// Return squared length of this vector
 	// More efficient than Length when exact value is not required (e.g. for comparisons)
 	// Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-	TFloat32 LengthSquared() const
+	constexpr TFloat32 LengthSquared() const
 	{
 		return x*x + y*y + z*z + w*w;
 	}
@@ -352,6 +340,21 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Static constants
+-----------------------------------------------------------------------------------------*/
+// Defined in the header so they can be used in constant expressions
+
+// Standard vectors
+inline constexpr CVector4 CVector4::kZero(0.0f, 0.0f, 0.0f, 0.0f);
+inline constexpr CVector4 CVector4::kOne(1.0f, 1.0f, 1.0f, 1.0f);
+inline constexpr CVector4 CVector4::kOrigin(0.0f, 0.0f, 0.0f, 0.0f);
+inline constexpr CVector4 CVector4::kXAxis(1.0f, 0.0f, 0.0f, 0.0f);
+inline constexpr CVector4 CVector4::kYAxis(0.0f, 1.0f, 0.0f, 0.0f);
+inline constexpr CVector4 CVector4::kZAxis(0.0f, 0.0f, 1.0f, 0.0f);
+inline constexpr CVector4 CVector4::kWAxis(0.0f, 0.0f, 0.0f ,1.0f);
+
+
 /*-----------------------------------------------------------------------------------------
 	Non-member Operators
 -----------------------------------------------------------------------------------------*/
@@ -388,7 +391,7 @@ inline bool operator!=
 // Addition / subtraction
 
 // Vector addition
-inline CVector4 operator+
+constexpr CVector4 operator+
 (
 	const CVector4& v1,
 	const CVector4& v2
@@ -398,7 +401,7 @@ inline CVector4 operator+
 }
 
 // Vector subtraction
-inline CVector4 operator-
+constexpr CVector4 operator-
 (
 	const CVector4& v1,
 	const CVector4& v2
@@ -408,13 +411,13 @@ inline CVector4 operator-
 }
 
 // Unary positive (i.e. a = +v, included for completeness)
-inline CVector4 operator+( const CVector4& v )
+constexpr CVector4 operator+( const CVector4& v )
 {
 	return v;
 }
 
 // Unary negation (i.e. a = -v)
-inline CVector4 operator-( const CVector4& v )
+constexpr CVector4 operator-( const CVector4& v )
 {
 	return CVector4(-v.x, -v.y, -v.z, -v.w);
 }
@@ -424,7 +427,7 @@ inline CVector4 operator-( const CVector4& v )
 // Scalar multiplication & division
 
 // Vector multiplied by scalar
-inline CVector4 operator*
+constexpr CVector4 operator*
 (
 	const CVector4& v,
 	const TFloat32  s
@@ -434,7 +437,7 @@ inline CVector4 operator*
 }
 
 // Scalar multiplied by vtor
-inline CVector4 operator*
+constexpr CVector4 operator*
 (
 	const TFloat32  s,
 	const CVector4& v
@@ -463,7 +466,7 @@ inline CVector4 operator/
 // Other operations
 
 // Dot product of two given vectors (order not important) - non-member version
-inline TFloat32 Dot
+constexpr TFloat32 Dot
 (
 	const CVector4& v1,
 	const CVector4& v2
@@ -473,7 +476,7 @@ inline TFloat32 Dot
 }
 
 // Cross product of two given vectors (order is important) - non-member version
-inline CVector4 Cross
+constexpr CVector4 Cross
 (
 	const CVector4& v1,
 	const CVector4& v2
@@ -497,7 +500,7 @@ inline TFloat32 Length( const CVector4& v )
 // Return squared length of given vector
 // More efficient than Length when exact value is not required (e.g. for comparisons)
 // Use InvSqrt( LengthSquared(...) ) to calculate 1 / length more efficiently
-inline TFloat32 LengthSquared( const CVector4& v )
+constexpr TFloat32 LengthSquared( const CVector4& v )
 {
 	return v.x*v.x + v.y*v.y + v.z*v.z + v.w*v.w;
 }
@@ -0,0 +1,248 @@
+/**************************************************************************************************
+	Module:       FastMath.cpp
+
+	Array versions of the fast polynomial approximations in FastMath.h
+
+	Change history:
+		V1.0    Created with SSE, NEON and scalar implementations
+**************************************************************************************************/
+
+#include "FastMath.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Array support
+-----------------------------------------------------------------------------------------*/
+// Each array is processed four elements at a time. A final group of fewer than four is copied to
+// a local group padded with 1s (valid input for every function) so the 4-wide functions never read
+// or write past the ends of the arrays
+
+// Apply a 4-wide function of one value to each element of an array
+template <class Func>
+static void MapArray
+(
+	const TFloat32* aIn,
+	TFloat32*       aOut,
+	const size_t    count,
+	const Func&     func
+)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		Store4Unaligned( aOut + i, func( Load4Unaligned( aIn + i ) ) );
+	}
+	if (i < count)
+	{
+		TFloat32 group[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (size_t j = i; j < count; ++j)  group[j - i] = aIn[j];
+		Store4Unaligned( group, func( Load4Unaligned( group ) ) );
+		for (size_t j = i; j < count; ++j)  aOut[j] = group[j - i];
+	}
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Array functions
+-----------------------------------------------------------------------------------------*/
+
+// Sin of each element of an array
+void SinArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Sin4<kPrecisionFull>( x ); } );
+	}
+	else
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Sin4<kPrecisionFast>( x ); } );
+	}
+}
+
+// Cos of each element of an array
+void CosArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Cos4<kPrecisionFull>( x ); } );
+	}
+	else
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Cos4<kPrecisionFast>( x ); } );
+	}
+}
+
+// Sin and cos of each element of an array
+template <EMathPrecision Precision>
+static void SinCosArrayPrecision
+(
+	const TFloat32* aIn,
+	TFloat32*       aSin,
+	TFloat32*       aCos,
+	const size_t    count
+)
+{
+	TFloat32x4 s, c;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		SinCos4<Precision>( Load4Unaligned( aIn + i ), &s, &c );
+		Store4Unaligned( aSin + i, s );
+		Store4Unaligned( aCos + i, c );
+	}
+	if (i < count)
+	{
+		TFloat32 group[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		TFloat32 groupSin[4], groupCos[4];
+		for (size_t j = i; j < count; ++j)  group[j - i] = aIn[j];
+		SinCos4<Precision>( Load4Unaligned( group ), &s, &c );
+		Store4Unaligned( groupSin, s );
+		Store4Unaligned( groupCos, c );
+		for (size_t j = i; j < count; ++j)
+		{
+			aSin[j] = groupSin[j - i];
+			aCos[j] = groupCos[j - i];
+		}
+	}
+}
+
+void SinCosArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aSin,
+	TFloat32*            aCos,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		SinCosArrayPrecision<kPrecisionFull>( aIn, aSin, aCos, count );
+	}
+	else
+	{
+		SinCosArrayPrecision<kPrecisionFast>( aIn, aSin, aCos, count );
+	}
+}
+
+// atan2( y, x ) for each pair of elements of two arrays
+template <EMathPrecision Precision>
+static void ATan2ArrayPrecision
+(
+	const TFloat32* aY,
+	const TFloat32* aX,
+	TFloat32*       aOut,
+	const size_t    count
+)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		Store4Unaligned( aOut + i, ATan24<Precision>( Load4Unaligned( aY + i ), Load4Unaligned( aX + i ) ) );
+	}
+	if (i < count)
+	{
+		TFloat32 groupY[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		TFloat32 groupX[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (size_t j = i; j < count; ++j)
+		{
+			groupY[j - i] = aY[j];
+			groupX[j - i] = aX[j];
+		}
+		Store4Unaligned( groupY, ATan24<Precision>( Load4Unaligned( groupY ), Load4Unaligned( groupX ) ) );
+		for (size_t j = i; j < count; ++j)  aOut[j] = groupY[j - i];
+	}
+}
+
+void ATan2Array
+(
+	const TFloat32*      aY,
+	const TFloat32*      aX,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		ATan2ArrayPrecision<kPrecisionFull>( aY, aX, aOut, count );
+	}
+	else
+	{
+		ATan2ArrayPrecision<kPrecisionFast>( aY, aX, aOut, count );
+	}
+}
+
+// e^x for each element of an array
+void ExpArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Exp4<kPrecisionFull>( x ); } );
+	}
+	else
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Exp4<kPrecisionFast>( x ); } );
+	}
+}
+
+// Natural log of each element of an array
+void LogArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Log4<kPrecisionFull>( x ); } );
+	}
+	else
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return Log4<kPrecisionFast>( x ); } );
+	}
+}
+
+// 1 / sqrt of each element of an array
+void InvSqrtArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision /*= kPrecisionFull*/
+)
+{
+	if (precision == kPrecisionFull)
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return InvSqrt4<kPrecisionFull>( x ); } );
+	}
+	else
+	{
+		MapArray( aIn, aOut, count, []( const TFloat32x4 x ) { return InvSqrt4<kPrecisionFast>( x ); } );
+	}
+}
+
+
+} // namespace gen
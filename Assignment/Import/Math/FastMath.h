@@ -0,0 +1,427 @@
+/**************************************************************************************************
+	Module:       FastMath.h
+
+	Fast polynomial approximations of sin, cos, atan2, exp, log and 1/sqrt, four floats at a time
+	(using MathSIMD.h), over arrays, or as scalar replacements for the <math.h> based functions in
+	BaseMath.h where speed matters more than the last bit of precision
+
+	Change history:
+		V1.0    Created with SSE, NEON and scalar implementations
+**************************************************************************************************/
+
+// Each function is provided in two precision tiers (see EMathPrecision). The maximum errors listed
+// with each function were measured against double precision results rounded to float, over the
+// input ranges given, for the SSE implementation (with and without FMA). Errors are in ULP - units
+// in the last place of the float result, so 1 ULP is a relative error of 2^-23 (1.2e-7) at most.
+// Inputs outside the stated ranges give inaccurate or unspecified results - these functions do not
+// handle infinities, NaNs or denormals, and do not set errno
+//
+// The 4-wide functions take the precision tier as a template parameter so the unused tier is
+// compiled out, e.g. Sin4<kPrecisionFast>( v ). The array functions select the tier at runtime
+
+#ifndef GEN_FAST_MATH_H_INCLUDED
+#define GEN_FAST_MATH_H_INCLUDED
+
+#include <stddef.h>
+
+#include "GenDefines.h"
+#include "BaseMath.h"
+#include "MathSIMD.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Precision tiers
+-----------------------------------------------------------------------------------------*/
+
+enum EMathPrecision
+{
+	kPrecisionFast, // Relative error below 4e-4 (about 12 bits) - enough for most graphics work
+	kPrecisionFull, // Within a few ULP of the correctly rounded result, see each function
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Sin & cos
+-----------------------------------------------------------------------------------------*/
+// Arguments are reduced to the range [-pi/2, pi/2] by subtracting the nearest multiple of pi,
+// using a three part split of pi (Cody & Waite) so the reduction is exact for |x| up to 8192.
+// Beyond that precision is lost as the argument grows, as it is with any float argument
+//
+// Maximum error for |x| <= 8192, relative where |result| >= 0.001, absolute closer to the zeros:
+//     kPrecisionFast - 1.4e-4 relative, 1.4e-4 absolute
+//     kPrecisionFull - 2.1 ULP, 1.3e-7 absolute
+
+// Return x - n * pi for n holding integers or half integers
+inline TFloat32x4 ReduceByPi4( const TFloat32x4 x, const TFloat32x4 n )
+{
+	// pi as the sum of three floats, the first two with enough trailing zero bits that their
+	// products with n are exact
+	TFloat32x4 r = NegMulAdd4( n, Splat4( 3.140625f ), x );
+	r = NegMulAdd4( n, Splat4( 9.67502593994140625e-4f ), r );
+	return NegMulAdd4( n, Splat4( 1.509957990978376432e-7f ), r );
+}
+
+// Return 1 in lanes where n holds an even integer, -1 where n is odd
+inline TFloat32x4 ParitySign4( const TFloat32x4 n )
+{
+	// h is 0 for even n and +/-0.5 for odd n, so 1 - 8h^2 is 1 or -1
+	TFloat32x4 half = Mul4( n, Splat4( 0.5f ) );
+	TFloat32x4 h = Sub4( half, Round4( half ) );
+	return NegMulAdd4( Mul4( h, h ), Splat4( 8.0f ), Splat4( 1.0f ) );
+}
+
+// Return sin of each lane of r in the range [-pi/2, pi/2], as an odd polynomial minimising the
+// maximum relative error
+template <EMathPrecision Precision>
+inline TFloat32x4 SinPolynomial4( const TFloat32x4 r )
+{
+	TFloat32x4 r2 = Mul4( r, r );
+	TFloat32x4 p;
+	if (Precision == kPrecisionFull)
+	{
+		p = MulAdd4( r2, Splat4( 2.6057794e-6f ), Splat4( -1.98096022e-4f ) );
+		p = MulAdd4( r2, p, Splat4( 8.33306648e-3f ) );
+		p = MulAdd4( r2, p, Splat4( -1.66666597e-1f ) );
+	}
+	else
+	{
+		p = MulAdd4( r2, Splat4( 7.65656028e-3f ), Splat4( -1.66129217e-1f ) );
+	}
+	return MulAdd4( Mul4( r2, r ), p, r );
+}
+
+// Return sin of each lane
+template <EMathPrecision Precision>
+inline TFloat32x4 Sin4( const TFloat32x4 x )
+{
+	// sin(x) = sin(r + n*pi) = (-1)^n * sin(r)
+	TFloat32x4 n = Round4( Mul4( x, Splat4( 1.0f / kfPi ) ) );
+	TFloat32x4 r = ReduceByPi4( x, n );
+	return Mul4( SinPolynomial4<Precision>( r ), ParitySign4( n ) );
+}
+
+// Return cos of each lane
+template <EMathPrecision Precision>
+inline TFloat32x4 Cos4( const TFloat32x4 x )
+{
+	// cos(x) = cos(r + (k + 1/2)*pi) = -(-1)^k * sin(r)
+	TFloat32x4 k = Round4( MulAdd4( x, Splat4( 1.0f / kfPi ), Splat4( -0.5f ) ) );
+	TFloat32x4 r = ReduceByPi4( x, Add4( k, Splat4( 0.5f ) ) );
+	return Mul4( SinPolynomial4<Precision>( r ), Sub4( Zero4(), ParitySign4( k ) ) );
+}
+
+// Get both sin and cos of each lane, more efficient than calling the functions separately
+template <EMathPrecision Precision>
+inline void SinCos4
+(
+	const TFloat32x4 x,
+	TFloat32x4*      pSin,
+	TFloat32x4*      pCos
+)
+{
+	TFloat32x4 y = Mul4( x, Splat4( 1.0f / kfPi ) );
+	TFloat32x4 n = Round4( y );
+	TFloat32x4 k = Round4( Sub4( y, Splat4( 0.5f ) ) );
+	*pSin = Mul4( SinPolynomial4<Precision>( ReduceByPi4( x, n ) ), ParitySign4( n ) );
+	*pCos = Mul4( SinPolynomial4<Precision>( ReduceByPi4( x, Add4( k, Splat4( 0.5f ) ) ) ),
+	              Sub4( Zero4(), ParitySign4( k ) ) );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	ATan2
+-----------------------------------------------------------------------------------------*/
+// atan2 for any finite x and y (both zero returns zero). The sign of a zero x is ignored, so
+// atan2( 0, -0 ) is 0 rather than pi
+//
+// Maximum error:
+//     kPrecisionFast - 2.6e-4 relative (one divide)
+//     kPrecisionFull - 3.2 ULP (two divides)
+
+// Return atan of each lane of t in the range [0, 1]
+template <EMathPrecision Precision>
+inline TFloat32x4 ATanUnit4( TFloat32x4 t )
+{
+	if (Precision == kPrecisionFull)
+	{
+		// Values above tan(pi/8) use atan(t) = pi/4 + atan((t - 1) / (t + 1)), so the polynomial only
+		// covers [-tan(pi/8), tan(pi/8)]
+		TFloat32x4 one = Splat4( 1.0f );
+		TFloat32x4 fold = Greater4( t, Splat4( 0.414213562f ) );
+		t = Select4( fold, Div4( Sub4( t, one ), Add4( t, one ) ), t );
+		TFloat32x4 t2 = Mul4( t, t );
+		TFloat32x4 p = MulAdd4( t2, Splat4( 8.05370361e-2f ), Splat4( -1.38776734e-1f ) );
+		p = MulAdd4( t2, p, Splat4( 1.99777097e-1f ) );
+		p = MulAdd4( t2, p, Splat4( -3.33329499e-1f ) );
+		return Add4( MulAdd4( Mul4( t2, t ), p, t ), And4( fold, Splat4( kfPi / 4.0f ) ) );
+	}
+	else
+	{
+		TFloat32x4 t2 = Mul4( t, t );
+		TFloat32x4 p = MulAdd4( t2, Splat4( -4.64966521e-2f ), Splat4( 1.59314439e-1f ) );
+		p = MulAdd4( t2, p, Splat4( -3.27622831e-1f ) );
+		return MulAdd4( Mul4( t2, t ), p, t );
+	}
+}
+
+// Return atan2( y, x ) of each lane, i.e. the angle of (x, y) from the x axis in the range -pi to pi
+template <EMathPrecision Precision>
+inline TFloat32x4 ATan24
+(
+	const TFloat32x4 y,
+	const TFloat32x4 x
+)
+{
+	// Work in the first octant then reflect the result into the correct one
+	TFloat32x4 absX = Abs4( x );
+	TFloat32x4 absY = Abs4( y );
+	TFloat32x4 smaller = Min4( absX, absY );
+	TFloat32x4 larger = Max4( Max4( absX, absY ), Splat4( 1.175494351e-38f ) ); // Avoid 0 / 0
+	TFloat32x4 a = ATanUnit4<Precision>( Div4( smaller, larger ) );
+	a = Select4( Greater4( absY, absX ), Sub4( Splat4( kfPi / 2.0f ), a ), a );
+	a = Select4( Greater4( Zero4(), x ), Sub4( Splat4( kfPi ), a ), a );
+	return Xor4( a, SignBit4( y ) );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Exp & log
+-----------------------------------------------------------------------------------------*/
+// exp reduces x to r in [-ln(2)/2, ln(2)/2] with x = r + n*ln(2), so exp(x) = exp(r) * 2^n. Results
+// are clamped to the range of normal floats, e^-87.3 to e^88.7 (about 1.2e-38 to 3.3e38), rather
+// than becoming denormals, zero or infinity. log takes positive normal floats only (zero, negative
+// values, denormals, infinities and NaNs give unspecified results)
+//
+// Maximum error for exp with |x| <= 87, log with 1.2e-38 <= x <= 3.4e38:
+//     kPrecisionFast - 1.3e-4 relative (exp), 9.3e-5 relative (log)
+//     kPrecisionFull - 1.1 ULP (exp), 1.2 ULP (log)
+
+// Return e^x for each lane
+template <EMathPrecision Precision>
+inline TFloat32x4 Exp4( TFloat32x4 x )
+{
+	x = Min4( Max4( x, Splat4( -87.3365479f ) ), Splat4( 88.7f ) );
+	TFloat32x4 n = Round4( Mul4( x, Splat4( 1.44269504f ) ) );
+
+	// ln(2) in two parts, the first with enough trailing zero bits that its product with n is exact
+	TFloat32x4 r = NegMulAdd4( n, Splat4( 0.693359375f ), x );
+	r = NegMulAdd4( n, Splat4( -2.12194440e-4f ), r );
+
+	// exp(r) = 1 + r + r^2 * p(r)
+	TFloat32x4 p;
+	if (Precision == kPrecisionFull)
+	{
+		p = MulAdd4( r, Splat4( 1.38146046e-3f ), Splat4( 8.36871006e-3f ) );
+		p = MulAdd4( r, p, Splat4( 4.16683890e-2f ) );
+		p = MulAdd4( r, p, Splat4( 1.66665211e-1f ) );
+		p = MulAdd4( r, p, Splat4( 4.99999940e-1f ) );
+	}
+	else
+	{
+		p = MulAdd4( r, Splat4( 1.66627243e-1f ), Splat4( 5.03940463e-1f ) );
+	}
+	TFloat32x4 e = Add4( MulAdd4( Mul4( r, r ), p, r ), Splat4( 1.0f ) );
+
+	// 2^n in two factors as n may be 128 for the largest results, beyond the range of Pow2Int4
+	TFloat32x4 n1 = Round4( Mul4( n, Splat4( 0.5f ) ) );
+	return Mul4( Mul4( e, Pow2Int4( n1 ) ), Pow2Int4( Sub4( n, n1 ) ) );
+}
+
+// Return the natural log of each lane
+template <EMathPrecision Precision>
+inline TFloat32x4 Log4( const TFloat32x4 x )
+{
+	// x = m * 2^e, with m adjusted into [sqrt(1/2), sqrt(2)] so log(m) is small
+	TFloat32x4 m;
+	TFloat32x4 e = SplitExponent4( x, &m );
+	TFloat32x4 high = Greater4( m, Splat4( 1.41421356f ) );
+	m = Select4( high, Mul4( m, Splat4( 0.5f ) ), m );
+	e = Add4( e, And4( high, Splat4( 1.0f ) ) );
+
+	// log(1 + f) = f - f^2/2 + f^3 * p(f)
+	TFloat32x4 f = Sub4( m, Splat4( 1.0f ) );
+	TFloat32x4 p;
+	if (Precision == kPrecisionFull)
+	{
+		p = MulAdd4( f, Splat4( 8.70047510e-2f ), Splat4( -1.42675489e-1f ) );
+		p = MulAdd4( f, p, Splat4( 1.49147823e-1f ) );
+		p = MulAdd4( f, p, Splat4( -1.65775776e-1f ) );
+		p = MulAdd4( f, p, Splat4( 1.99630618e-1f ) );
+		p = MulAdd4( f, p, Splat4( -2.50013381e-1f ) );
+		p = MulAdd4( f, p, Splat4( 3.33339095e-1f ) );
+	}
+	else
+	{
+		p = MulAdd4( f, Splat4( 1.73249885e-1f ), Splat4( -2.64611721e-1f ) );
+		p = MulAdd4( f, p, Splat4( 3.35673183e-1f ) );
+	}
+
+	// Sum smallest terms first, with ln(2) in two parts as for Exp4
+	TFloat32x4 f2 = Mul4( f, f );
+	TFloat32x4 y = Mul4( Mul4( f2, f ), p );
+	y = MulAdd4( e, Splat4( -2.12194440e-4f ), y );
+	y = NegMulAdd4( f2, Splat4( 0.5f ), y );
+	return MulAdd4( e, Splat4( 0.693359375f ), Add4( f, y ) );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	1 / Sqrt
+-----------------------------------------------------------------------------------------*/
+// The hardware estimate (InvSqrtEstimate4) refined by Newton-Raphson steps. x must be positive
+//
+// Maximum error for 1.2e-38 <= x <= 3.4e38:
+//     kPrecisionFast - 3.3e-4 relative (SSE estimate only, one step on NEON)
+//     kPrecisionFull - 4 ULP (one step on SSE, two on NEON)
+
+// Return 1 / sqrt of each lane
+template <EMathPrecision Precision>
+inline TFloat32x4 InvSqrt4( const TFloat32x4 x )
+{
+	TFloat32x4 r = InvSqrtEstimate4( x );
+#if !defined(GEN_SIMD_NONE) // Estimate is exact on the scalar implementation
+	// Each step r' = r * (3 - x*r*r) / 2 doubles the number of correct bits
+	TFloat32x4 halfX = Mul4( x, Splat4( 0.5f ) );
+	#if defined(GEN_SIMD_NEON)
+		r = Mul4( r, NegMulAdd4( Mul4( halfX, r ), r, Splat4( 1.5f ) ) );
+	#endif
+	if (Precision == kPrecisionFull)
+	{
+		r = Mul4( r, NegMulAdd4( Mul4( halfX, r ), r, Splat4( 1.5f ) ) );
+	}
+#endif
+	return r;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Array functions
+-----------------------------------------------------------------------------------------*/
+// Apply the functions above to arrays of any length and alignment, four values at a time. Output
+// arrays may be the same as the input arrays, but must not otherwise overlap
+
+// Sin of each element of an array
+void SinArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// Cos of each element of an array
+void CosArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// Sin and cos of each element of an array
+void SinCosArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aSin,
+	TFloat32*            aCos,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// atan2( y, x ) for each pair of elements of two arrays
+void ATan2Array
+(
+	const TFloat32*      aY,
+	const TFloat32*      aX,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// e^x for each element of an array
+void ExpArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// Natural log of each element of an array
+void LogArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+// 1 / sqrt of each element of an array
+void InvSqrtArray
+(
+	const TFloat32*      aIn,
+	TFloat32*            aOut,
+	const size_t         count,
+	const EMathPrecision precision = kPrecisionFull
+);
+
+
+/*-----------------------------------------------------------------------------------------
+	Scalar fast paths
+-----------------------------------------------------------------------------------------*/
+// Single value versions of the full precision functions, for use in place of those in BaseMath.h
+
+// 1 / Sqrt using the hardware estimate and one Newton-Raphson step - 4 ULP maximum error rather
+// than the 0.5 ULP of InvSqrt, but without its divide and square root. x must be positive
+inline TFloat32 InvSqrtFast( const TFloat32 x )
+{
+	return GetLane4<0>( InvSqrt4<kPrecisionFull>( Splat4( x ) ) );
+}
+
+// Get both sin and cos of x using the polynomials above - 2.1 ULP maximum error for |x| <= 8192.
+// The scalar implementation has no advantage over <math.h> so uses SinCos from BaseMath.h
+inline void SinCosFast
+(
+	const TFloat32 x,
+	TFloat32*      pSin,
+	TFloat32*      pCos
+)
+{
+#if defined(GEN_SIMD_NONE)
+	SinCos( x, pSin, pCos );
+#else
+	// Sin in lane 0 and cos in lane 1 (as in Sin4 and Cos4), sharing one polynomial evaluation
+	TFloat32x4 offset = Set4( 0.0f, 0.5f, 0.0f, 0.5f );
+	TFloat32x4 xs = Splat4( x );
+	TFloat32x4 k = Round4( Sub4( Mul4( xs, Splat4( 1.0f / kfPi ) ), offset ) );
+	TFloat32x4 r = ReduceByPi4( xs, Add4( k, offset ) );
+	TFloat32x4 sign = Mul4( ParitySign4( k ), Set4( 1.0f, -1.0f, 1.0f, -1.0f ) );
+	TFloat32x4 sinCos = Mul4( SinPolynomial4<kPrecisionFull>( r ), sign );
+	*pSin = GetLane4<0>( sinCos );
+	*pCos = GetLane4<1>( sinCos );
+#endif
+}
+
+// Sin and cos used by the rotation functions of the matrix classes (Rotate*, MakeRotation*,
+// Matrix*Rotation*). Define GEN_FAST_ROTATIONS in the project settings to use SinCosFast rather
+// than the <math.h> functions - faster, but rotation matrices are then only accurate to 2.1 ULP
+inline void RotationSinCos
+(
+	const TFloat32 x,
+	TFloat32*      pSin,
+	TFloat32*      pCos
+)
+{
+#if defined(GEN_FAST_ROTATIONS)
+	SinCosFast( x, pSin, pCos );
+#else
+	SinCos( x, pSin, pCos );
+#endif
+}
+
+
+} // namespace gen
+
+#endif // GEN_FAST_MATH_H_INCLUDED
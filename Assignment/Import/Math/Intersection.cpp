@@ -0,0 +1,590 @@
+/**************************************************************************************************
+	Module:       Intersection.cpp
+
+	Bounding volumes (spheres and axis-aligned boxes), view frustums and ray intersection tests,
+	with batch versions that test four volumes or triangles at once using SIMD
+
+	Change history:
+		V1.0    Created with frustum, sphere, AABB, ray/AABB and ray/triangle tests
+**************************************************************************************************/
+
+#include <float.h> // For FLT_MAX
+#include <atomic>
+
+#include "Intersection.h"
+#include "MathSIMD.h"
+#include "Parallel.h"
+
+namespace gen
+{
+
+// The batch functions load volumes directly from arrays as packed floats
+static_assert( sizeof(SSphere) == 4 * sizeof(TFloat32), "SSphere must be four packed floats" );
+static_assert( sizeof(SAABB) == 6 * sizeof(TFloat32), "SAABB must be six packed floats" );
+
+// Fewest volumes worth giving each thread - starting a thread takes longer than testing this many
+const size_t kMinVolumesPerThread = 16384;
+
+// Number of lanes set in each 4-bit mask from MoveMask4
+static const int kaBitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+
+/*-----------------------------------------------------------------------------------------
+	Frustum
+-----------------------------------------------------------------------------------------*/
+
+// Construct from a view-projection matrix (or a projection matrix for a frustum in camera space).
+// Uses Direct3D conventions: row vectors (pre-multiplication, V' = V*M) and clip space z from 0
+// to w
+CFrustum::CFrustum( const CMatrix4x4& viewProj )
+{
+	// A point is inside when its clip space coordinates satisfy -w <= x <= w, -w <= y <= w and
+	// 0 <= z <= w. Clip coordinate j is the dot product of the point with column j of the matrix,
+	// so each condition gives a plane from a sum or difference of columns (Gribb & Hartmann)
+	CVector4 column0( viewProj.e00, viewProj.e10, viewProj.e20, viewProj.e30 );
+	CVector4 column1( viewProj.e01, viewProj.e11, viewProj.e21, viewProj.e31 );
+	CVector4 column2( viewProj.e02, viewProj.e12, viewProj.e22, viewProj.e32 );
+	CVector4 column3( viewProj.e03, viewProj.e13, viewProj.e23, viewProj.e33 );
+	maPlanes[kLeftPlane]   = column3 + column0;
+	maPlanes[kRightPlane]  = column3 - column0;
+	maPlanes[kBottomPlane] = column3 + column1;
+	maPlanes[kTopPlane]    = column3 - column1;
+	maPlanes[kNearPlane]   = column2;
+	maPlanes[kFarPlane]    = column3 - column2;
+
+	// Normalise so plane equations give distances, needed for sphere and box tests
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		CVector4& p = maPlanes[plane];
+		p /= Sqrt( p.x*p.x + p.y*p.y + p.z*p.z );
+	}
+}
+
+
+// Test if a point is inside the frustum
+bool CFrustum::IsPointInside( const CVector3& point ) const
+{
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const CVector4& p = maPlanes[plane];
+		if (p.x*point.x + p.y*point.y + p.z*point.z + p.w < 0.0f)  return false;
+	}
+	return true;
+}
+
+// Test if a sphere is visible (not entirely outside any plane)
+bool CFrustum::IsSphereVisible( const SSphere& sphere ) const
+{
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const CVector4& p = maPlanes[plane];
+		TFloat32 distance = p.x*sphere.centre.x + p.y*sphere.centre.y + p.z*sphere.centre.z + p.w;
+		if (distance < -sphere.radius)  return false;
+	}
+	return true;
+}
+
+// Test if an axis-aligned box is visible (not entirely outside any plane)
+bool CFrustum::IsAABBVisible( const SAABB& box ) const
+{
+	// Compare the distance of the box centre from each plane with the furthest the box extends
+	// towards the plane
+	CVector3 centre = (box.minPoint + box.maxPoint) * 0.5f;
+	CVector3 extent = (box.maxPoint - box.minPoint) * 0.5f;
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const CVector4& p = maPlanes[plane];
+		TFloat32 distance = p.x*centre.x + p.y*centre.y + p.z*centre.z + p.w;
+		TFloat32 radius = Abs( p.x )*extent.x + Abs( p.y )*extent.y + Abs( p.z )*extent.z;
+		if (distance < -radius)  return false;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch visibility tests
+-----------------------------------------------------------------------------------------*/
+// Volumes are tested four at a time in SoA form (each element of four volumes in one SIMD
+// register) against planes with each element splatted across a register. The few volumes left
+// over at the end are copied through a padded group of four
+
+// Frustum planes with each element splatted across a register, and the absolute values of the
+// normals for box tests
+struct SSplatPlanes
+{
+	TFloat32x4 e[kNumFrustumPlanes][4];
+	TFloat32x4 absNormal[kNumFrustumPlanes][3];
+};
+
+static void SplatPlanes
+(
+	const CFrustum& frustum,
+	SSplatPlanes&   splat
+)
+{
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const CVector4& p = frustum.GetPlane( static_cast<EFrustumPlane>(plane) );
+		splat.e[plane][0] = Splat4( p.x );
+		splat.e[plane][1] = Splat4( p.y );
+		splat.e[plane][2] = Splat4( p.z );
+		splat.e[plane][3] = Splat4( p.w );
+		splat.absNormal[plane][0] = Splat4( Abs( p.x ) );
+		splat.absNormal[plane][1] = Splat4( Abs( p.y ) );
+		splat.absNormal[plane][2] = Splat4( Abs( p.z ) );
+	}
+}
+
+// Test four consecutive spheres, returning a 4-bit mask of the visible ones
+static inline int CullSphereGroup
+(
+	const SSplatPlanes& planes,
+	const SSphere*      aSpheres
+)
+{
+	TFloat32x4 x = Load4Unaligned( &aSpheres[0].centre.x );
+	TFloat32x4 y = Load4Unaligned( &aSpheres[1].centre.x );
+	TFloat32x4 z = Load4Unaligned( &aSpheres[2].centre.x );
+	TFloat32x4 negRadius = Load4Unaligned( &aSpheres[3].centre.x );
+	Transpose4( x, y, z, negRadius );
+	negRadius = Xor4( negRadius, Splat4( -0.0f ) );
+
+	TFloat32x4 visible = GreaterEqual4( Zero4(), Zero4() ); // All set
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const TFloat32x4* p = planes.e[plane];
+		TFloat32x4 distance = MulAdd4( z, p[2], MulAdd4( y, p[1], MulAdd4( x, p[0], p[3] ) ) );
+		visible = And4( visible, GreaterEqual4( distance, negRadius ) );
+	}
+	return MoveMask4( visible );
+}
+
+// Test four consecutive axis-aligned boxes, returning a 4-bit mask of the visible ones
+static inline int CullAABBGroup
+(
+	const SSplatPlanes& planes,
+	const SAABB*        aBoxes
+)
+{
+	// Each box loaded as (min.x min.y min.z max.x) and (min.z max.x max.y max.z)
+	TFloat32x4 minX = Load4Unaligned( &aBoxes[0].minPoint.x );
+	TFloat32x4 minY = Load4Unaligned( &aBoxes[1].minPoint.x );
+	TFloat32x4 minZ = Load4Unaligned( &aBoxes[2].minPoint.x );
+	TFloat32x4 maxX = Load4Unaligned( &aBoxes[3].minPoint.x );
+	Transpose4( minX, minY, minZ, maxX );
+	TFloat32x4 unused = Load4Unaligned( &aBoxes[0].minPoint.z );
+	TFloat32x4 unused2 = Load4Unaligned( &aBoxes[1].minPoint.z );
+	TFloat32x4 maxY = Load4Unaligned( &aBoxes[2].minPoint.z );
+	TFloat32x4 maxZ = Load4Unaligned( &aBoxes[3].minPoint.z );
+	Transpose4( unused, unused2, maxY, maxZ );
+
+	const TFloat32x4 half = Splat4( 0.5f );
+	TFloat32x4 centreX = Mul4( Add4( minX, maxX ), half );
+	TFloat32x4 centreY = Mul4( Add4( minY, maxY ), half );
+	TFloat32x4 centreZ = Mul4( Add4( minZ, maxZ ), half );
+	TFloat32x4 extentX = Mul4( Sub4( maxX, minX ), half );
+	TFloat32x4 extentY = Mul4( Sub4( maxY, minY ), half );
+	TFloat32x4 extentZ = Mul4( Sub4( maxZ, minZ ), half );
+
+	TFloat32x4 visible = GreaterEqual4( Zero4(), Zero4() ); // All set
+	for (int plane = 0; plane < kNumFrustumPlanes; ++plane)
+	{
+		const TFloat32x4* p = planes.e[plane];
+		const TFloat32x4* absNormal = planes.absNormal[plane];
+		TFloat32x4 distance = MulAdd4( centreZ, p[2], MulAdd4( centreY, p[1], MulAdd4( centreX, p[0], p[3] ) ) );
+		TFloat32x4 radius = MulAdd4( extentZ, absNormal[2], MulAdd4( extentY, absNormal[1], Mul4( extentX, absNormal[0] ) ) );
+		visible = And4( visible, GreaterEqual4( Add4( distance, radius ), Zero4() ) );
+	}
+	return MoveMask4( visible );
+}
+
+// Test a range of an array of volumes with the given group function, returning the number visible.
+// The group function is a template parameter so it is inlined into the loop
+template <class Volume, int (*CullGroup)( const SSplatPlanes&, const Volume* )>
+static size_t CullRange
+(
+	const SSplatPlanes& planes,
+	const Volume*       aVolumes,
+	bool*               aVisible,
+	const size_t        begin,
+	const size_t        end
+)
+{
+	size_t numVisible = 0;
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		int mask = CullGroup( planes, aVolumes + i );
+		aVisible[i]     = (mask & 1) != 0;
+		aVisible[i + 1] = (mask & 2) != 0;
+		aVisible[i + 2] = (mask & 4) != 0;
+		aVisible[i + 3] = (mask & 8) != 0;
+		numVisible += kaBitCount[mask];
+	}
+	if (i < end)
+	{
+		Volume aGroup[4] = {};
+		for (size_t j = i; j < end; ++j)  aGroup[j - i] = aVolumes[j];
+		int mask = CullGroup( planes, aGroup );
+		for (size_t j = i; j < end; ++j)
+		{
+			aVisible[j] = (mask & (1 << (j - i))) != 0;
+			numVisible += aVisible[j] ? 1 : 0;
+		}
+	}
+	return numVisible;
+}
+
+// Test an array of volumes with the given group function, split over threads
+template <class Volume, int (*CullGroup)( const SSplatPlanes&, const Volume* )>
+static size_t CullArray
+(
+	const CFrustum& frustum,
+	const Volume*   aVolumes,
+	bool*           aVisible,
+	const size_t    numVolumes,
+	const TUInt32   numThreads
+)
+{
+	SSplatPlanes planes;
+	SplatPlanes( frustum, planes );
+	atomic<size_t> numVisible( 0 );
+	ParallelRanges( numVolumes, kMinVolumesPerThread, numThreads, [&]( size_t begin, size_t end )
+	{
+		numVisible += CullRange<Volume, CullGroup>( planes, aVolumes, aVisible, begin, end );
+	} );
+	return numVisible;
+}
+
+
+// Test the visibility of an array of spheres
+size_t CFrustum::CullSpheres
+(
+	const SSphere* aSpheres,
+	bool*          aVisible,
+	const size_t   numSpheres,
+	const TUInt32  numThreads /*= 1*/
+) const
+{
+	return CullArray<SSphere, CullSphereGroup>( *this, aSpheres, aVisible, numSpheres, numThreads );
+}
+
+// Test the visibility of an array of axis-aligned boxes
+size_t CFrustum::CullAABBs
+(
+	const SAABB*  aBoxes,
+	bool*         aVisible,
+	const size_t  numBoxes,
+	const TUInt32 numThreads /*= 1*/
+) const
+{
+	return CullArray<SAABB, CullAABBGroup>( *this, aBoxes, aVisible, numBoxes, numThreads );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Ray intersection
+-----------------------------------------------------------------------------------------*/
+
+// Test if a ray intersects an axis-aligned box. If so, optionally return the distance to where it
+// enters the box in pDistance (0 if the origin is inside the box)
+bool IntersectRayAABB
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const SAABB&    box,
+	TFloat32*       pDistance /*= 0*/
+)
+{
+	// Slab method - find the range of distances where the ray is between each pair of parallel
+	// box faces, the ray hits the box if the three ranges overlap. Reciprocals of zero direction
+	// elements are infinite, giving an unlimited range if the origin is between those faces
+	TFloat32 nearDistance = 0.0f;
+	TFloat32 farDistance = FLT_MAX;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		TFloat32 invDirection = 1.0f / rayDirection[axis];
+		TFloat32 t0 = (box.minPoint[axis] - rayOrigin[axis]) * invDirection;
+		TFloat32 t1 = (box.maxPoint[axis] - rayOrigin[axis]) * invDirection;
+		nearDistance = Max( nearDistance, Min( t0, t1 ) );
+		farDistance = Min( farDistance, Max( t0, t1 ) );
+	}
+	if (nearDistance > farDistance)  return false;
+
+	if (pDistance)  *pDistance = nearDistance;
+	return true;
+}
+
+// Test if a ray intersects a triangle (either side). If so, optionally return the distance to the
+// intersection in pDistance
+bool IntersectRayTriangle
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const CVector3& v0,
+	const CVector3& v1,
+	const CVector3& v2,
+	TFloat32*       pDistance /*= 0*/
+)
+{
+	// Moller-Trumbore - solve for the distance along the ray and the barycentric coordinates
+	// (u, v) of the intersection with the triangle's plane using Cramer's rule
+	CVector3 edge1 = v1 - v0;
+	CVector3 edge2 = v2 - v0;
+	CVector3 p = Cross( rayDirection, edge2 );
+	TFloat32 det = Dot( edge1, p );
+	if (det == 0.0f)  return false; // Ray parallel to triangle
+	TFloat32 invDet = 1.0f / det;
+
+	CVector3 s = rayOrigin - v0;
+	TFloat32 u = Dot( s, p ) * invDet;
+	if (u < 0.0f || u > 1.0f)  return false;
+
+	CVector3 q = Cross( s, edge1 );
+	TFloat32 v = Dot( rayDirection, q ) * invDet;
+	if (v < 0.0f || u + v > 1.0f)  return false;
+
+	TFloat32 distance = Dot( edge2, q ) * invDet;
+	if (distance < 0.0f)  return false;
+
+	if (pDistance)  *pDistance = distance;
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch ray intersection
+-----------------------------------------------------------------------------------------*/
+// Boxes and triangles are tested four at a time in SoA form, using the same methods as the single
+// versions above with the ray splatted across registers
+
+// Ray with each element splatted across a register, and the reciprocal of the direction for box
+// tests
+struct SSplatRay
+{
+	TFloat32x4 origin[3];
+	TFloat32x4 direction[3];
+	TFloat32x4 invDirection[3];
+};
+
+static void SplatRay
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	SSplatRay&      splat
+)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		splat.origin[axis] = Splat4( rayOrigin[axis] );
+		splat.direction[axis] = Splat4( rayDirection[axis] );
+		splat.invDirection[axis] = Splat4( 1.0f / rayDirection[axis] );
+	}
+}
+
+// Intersect a ray with four consecutive boxes. Returns a mask of the boxes hit and the distances in
+// nearDistance
+static inline TFloat32x4 IntersectAABBGroup
+(
+	const SSplatRay& ray,
+	const SAABB*     aBoxes,
+	TFloat32x4&      nearDistance
+)
+{
+	TFloat32x4 minX = Load4Unaligned( &aBoxes[0].minPoint.x );
+	TFloat32x4 minY = Load4Unaligned( &aBoxes[1].minPoint.x );
+	TFloat32x4 minZ = Load4Unaligned( &aBoxes[2].minPoint.x );
+	TFloat32x4 maxX = Load4Unaligned( &aBoxes[3].minPoint.x );
+	Transpose4( minX, minY, minZ, maxX );
+	TFloat32x4 unused = Load4Unaligned( &aBoxes[0].minPoint.z );
+	TFloat32x4 unused2 = Load4Unaligned( &aBoxes[1].minPoint.z );
+	TFloat32x4 maxY = Load4Unaligned( &aBoxes[2].minPoint.z );
+	TFloat32x4 maxZ = Load4Unaligned( &aBoxes[3].minPoint.z );
+	Transpose4( unused, unused2, maxY, maxZ );
+	const TFloat32x4 aMin[3] = { minX, minY, minZ };
+	const TFloat32x4 aMax[3] = { maxX, maxY, maxZ };
+
+	nearDistance = Zero4();
+	TFloat32x4 farDistance = Splat4( FLT_MAX );
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		TFloat32x4 t0 = Mul4( Sub4( aMin[axis], ray.origin[axis] ), ray.invDirection[axis] );
+		TFloat32x4 t1 = Mul4( Sub4( aMax[axis], ray.origin[axis] ), ray.invDirection[axis] );
+		nearDistance = Max4( nearDistance, Min4( t0, t1 ) );
+		farDistance = Min4( farDistance, Max4( t0, t1 ) );
+	}
+	return GreaterEqual4( farDistance, nearDistance );
+}
+
+// Intersect a ray with an array of axis-aligned boxes
+size_t IntersectRayAABBs
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const SAABB*    aBoxes,
+	TFloat32*       aDistances,
+	const size_t    numBoxes
+)
+{
+#if defined(GEN_SIMD_NONE)
+	// The emulated vector operations are slower than the single test without SIMD
+	size_t numHits = 0;
+	for (size_t i = 0; i < numBoxes; ++i)
+	{
+		aDistances[i] = -1.0f;
+		if (IntersectRayAABB( rayOrigin, rayDirection, aBoxes[i], &aDistances[i] ))  ++numHits;
+	}
+	return numHits;
+#else
+	SSplatRay ray;
+	SplatRay( rayOrigin, rayDirection, ray );
+	const TFloat32x4 miss = Splat4( -1.0f );
+
+	size_t numHits = 0;
+	TFloat32x4 distance;
+	size_t i = 0;
+	for (; i + 4 <= numBoxes; i += 4)
+	{
+		TFloat32x4 hit = IntersectAABBGroup( ray, aBoxes + i, distance );
+		Store4Unaligned( aDistances + i, Select4( hit, distance, miss ) );
+		numHits += kaBitCount[MoveMask4( hit )];
+	}
+	if (i < numBoxes)
+	{
+		SAABB aGroup[4] = {};
+		for (size_t j = i; j < numBoxes; ++j)  aGroup[j - i] = aBoxes[j];
+		TFloat32x4 hit = IntersectAABBGroup( ray, aGroup, distance );
+		TFloat32 aGroupDistances[4];
+		Store4Unaligned( aGroupDistances, Select4( hit, distance, miss ) );
+		for (size_t j = i; j < numBoxes; ++j)
+		{
+			aDistances[j] = aGroupDistances[j - i];
+			numHits += aDistances[j] >= 0.0f ? 1 : 0;
+		}
+	}
+	return numHits;
+#endif
+}
+
+
+// Intersect a ray with four consecutive triangles (twelve vertices), counting only hits nearer than
+// maxDistance. Returns a 4-bit mask of the triangles hit and the distances in distance
+static inline int IntersectTriangleGroup
+(
+	const SSplatRay&  ray,
+	const CVector3*   aVertices,
+	const TFloat32x4& maxDistance,
+	TFloat32x4&       distance
+)
+{
+	// Each triangle is nine floats, loaded as (v0.x v0.y v0.z v1.x), (v0.z v1.x v1.y v1.z) and
+	// (v1.z v2.x v2.y v2.z) then transposed to give each element of the four triangles
+	const TFloat32* pf = &aVertices[0].x;
+	TFloat32x4 v0[3], v1[3], v2[3], unused;
+	v0[0] = Load4Unaligned( pf );
+	v0[1] = Load4Unaligned( pf + 9 );
+	v0[2] = Load4Unaligned( pf + 18 );
+	v1[0] = Load4Unaligned( pf + 27 );
+	Transpose4( v0[0], v0[1], v0[2], v1[0] );
+	unused = Load4Unaligned( pf + 2 );
+	TFloat32x4 unused2 = Load4Unaligned( pf + 11 );
+	v1[1] = Load4Unaligned( pf + 20 );
+	TFloat32x4 unused3 = Load4Unaligned( pf + 29 );
+	Transpose4( unused, unused2, v1[1], unused3 );
+	v1[2] = Load4Unaligned( pf + 5 );
+	v2[0] = Load4Unaligned( pf + 14 );
+	v2[1] = Load4Unaligned( pf + 23 );
+	v2[2] = Load4Unaligned( pf + 32 );
+	Transpose4( v1[2], v2[0], v2[1], v2[2] );
+
+	TFloat32x4 edge1[3], edge2[3], s[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		edge1[axis] = Sub4( v1[axis], v0[axis] );
+		edge2[axis] = Sub4( v2[axis], v0[axis] );
+		s[axis] = Sub4( ray.origin[axis], v0[axis] );
+	}
+
+	// p = direction x edge2, q = s x edge1
+	const TFloat32x4* d = ray.direction;
+	TFloat32x4 px = NegMulAdd4( d[2], edge2[1], Mul4( d[1], edge2[2] ) );
+	TFloat32x4 py = NegMulAdd4( d[0], edge2[2], Mul4( d[2], edge2[0] ) );
+	TFloat32x4 pz = NegMulAdd4( d[1], edge2[0], Mul4( d[0], edge2[1] ) );
+	TFloat32x4 qx = NegMulAdd4( s[2], edge1[1], Mul4( s[1], edge1[2] ) );
+	TFloat32x4 qy = NegMulAdd4( s[0], edge1[2], Mul4( s[2], edge1[0] ) );
+	TFloat32x4 qz = NegMulAdd4( s[1], edge1[0], Mul4( s[0], edge1[1] ) );
+
+	// Reciprocal of a zero determinant (ray parallel to triangle) is infinite and gives NaN or
+	// infinite coordinates, which are masked out by the test on the determinant
+	TFloat32x4 det = MulAdd4( edge1[2], pz, MulAdd4( edge1[1], py, Mul4( edge1[0], px ) ) );
+	TFloat32x4 invDet = Div4( Splat4( 1.0f ), det );
+	TFloat32x4 u = Mul4( MulAdd4( s[2], pz, MulAdd4( s[1], py, Mul4( s[0], px ) ) ), invDet );
+	TFloat32x4 v = Mul4( MulAdd4( d[2], qz, MulAdd4( d[1], qy, Mul4( d[0], qx ) ) ), invDet );
+	distance = Mul4( MulAdd4( edge2[2], qz, MulAdd4( edge2[1], qy, Mul4( edge2[0], qx ) ) ), invDet );
+
+	const TFloat32x4 zero = Zero4();
+	TFloat32x4 hit = Greater4( Abs4( det ), zero );
+	hit = And4( hit, GreaterEqual4( u, zero ) );
+	hit = And4( hit, GreaterEqual4( v, zero ) );
+	hit = And4( hit, GreaterEqual4( Splat4( 1.0f ), Add4( u, v ) ) );
+	hit = And4( hit, GreaterEqual4( distance, zero ) );
+	hit = And4( hit, Greater4( maxDistance, distance ) );
+	return MoveMask4( hit );
+}
+
+// Find the nearest intersection of a ray with a list of triangles, given as three vertices each
+TInt32 IntersectRayTriangles
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const CVector3* aVertices,
+	const size_t    numTriangles,
+	TFloat32*       pDistance /*= 0*/
+)
+{
+	SSplatRay ray;
+	SplatRay( rayOrigin, rayDirection, ray );
+
+	// Only hits nearer than the nearest so far are returned from each group, so most groups need
+	// no further work
+	TInt32 nearest = -1;
+	TFloat32 nearestDistance = FLT_MAX;
+	TFloat32x4 maxDistance = Splat4( FLT_MAX );
+	TFloat32x4 distance;
+	TFloat32 aDistances[4];
+	CVector3 aGroup[12];
+	for (size_t i = 0; i < numTriangles; i += 4)
+	{
+		// Triangles left over at the end are padded with degenerate ones, which are never hit
+		const CVector3* pGroup = aVertices + 3 * i;
+		if (i + 4 > numTriangles)
+		{
+			for (size_t j = 0; j < 12; ++j)
+			{
+				aGroup[j] = (3 * i + j < 3 * numTriangles) ? pGroup[j] : CVector3( 0.0f, 0.0f, 0.0f );
+			}
+			pGroup = aGroup;
+		}
+
+		int mask = IntersectTriangleGroup( ray, pGroup, maxDistance, distance );
+		if (mask)
+		{
+			Store4Unaligned( aDistances, distance );
+			for (size_t j = 0; j < 4; ++j)
+			{
+				if ((mask & (1 << j)) && aDistances[j] < nearestDistance)
+				{
+					nearestDistance = aDistances[j];
+					nearest = static_cast<TInt32>(i + j);
+				}
+			}
+			maxDistance = Splat4( nearestDistance );
+		}
+	}
+
+	if (nearest >= 0 && pDistance)  *pDistance = nearestDistance;
+	return nearest;
+}
+
+} // namespace gen
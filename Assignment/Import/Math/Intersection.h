@@ -0,0 +1,204 @@
+/**************************************************************************************************
+	Module:       Intersection.h
+
+	Bounding volumes (spheres and axis-aligned boxes), view frustums and ray intersection tests,
+	with batch versions that test four volumes or triangles at once using SIMD. The basis for
+	culling and picking
+
+	Change history:
+		V1.0    Created with frustum, sphere, AABB, ray/AABB and ray/triangle tests
+**************************************************************************************************/
+
+#ifndef GEN_INTERSECTION_H_INCLUDED
+#define GEN_INTERSECTION_H_INCLUDED
+
+#include "GenDefines.h"
+#include "CVector3.h"
+#include "CVector4.h"
+#include "CMatrix4x4.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Bounding volumes
+-----------------------------------------------------------------------------------------*/
+// Plain structures so arrays of them can be loaded directly into SIMD registers - the batch
+// functions rely on their layout (four and six packed floats)
+
+// Bounding sphere
+struct SSphere
+{
+	CVector3 centre;
+	TFloat32 radius;
+};
+
+// Axis-aligned bounding box, given by its minimum and maximum corners
+struct SAABB
+{
+	CVector3 minPoint;
+	CVector3 maxPoint;
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Frustum
+-----------------------------------------------------------------------------------------*/
+
+// Planes of a frustum, in the order held by CFrustum
+enum EFrustumPlane
+{
+	kLeftPlane,
+	kRightPlane,
+	kBottomPlane,
+	kTopPlane,
+	kNearPlane,
+	kFarPlane,
+	kNumFrustumPlanes
+};
+
+// View frustum as six planes, each facing inwards. Volumes are visible unless they are entirely
+// outside one of the planes. This is conservative - a few volumes near the frustum corners are
+// visible without being inside the frustum - but is exact for volumes fully inside or outside
+class CFrustum
+{
+// Concrete class - public access
+public:
+	/*-----------------------------------------------------------------------------------------
+		Constructors
+	-----------------------------------------------------------------------------------------*/
+
+	// Default constructor - leaves planes uninitialised
+	CFrustum() {}
+
+	// Construct from a view-projection matrix (or a projection matrix for a frustum in camera
+	// space). Uses Direct3D conventions: row vectors (pre-multiplication, V' = V*M) and clip space
+	// z from 0 to w
+	explicit CFrustum( const CMatrix4x4& viewProj );
+
+
+	/*-----------------------------------------------------------------------------------------
+		Planes
+	-----------------------------------------------------------------------------------------*/
+
+	// Return the given plane as (normal.x, normal.y, normal.z, d), with a unit length normal
+	// facing into the frustum. Points p with Dot( normal, p ) + d >= 0 are in front of the plane
+	const CVector4& GetPlane( const EFrustumPlane plane ) const
+	{
+		return maPlanes[plane];
+	}
+
+
+	/*-----------------------------------------------------------------------------------------
+		Visibility tests
+	-----------------------------------------------------------------------------------------*/
+
+	// Test if a point is inside the frustum
+	bool IsPointInside( const CVector3& point ) const;
+
+	// Test if a sphere is visible (not entirely outside any plane)
+	bool IsSphereVisible( const SSphere& sphere ) const;
+
+	// Test if an axis-aligned box is visible (not entirely outside any plane)
+	bool IsAABBVisible( const SAABB& box ) const;
+
+
+	/*-----------------------------------------------------------------------------------------
+		Batch visibility tests
+	-----------------------------------------------------------------------------------------*/
+	// Test arrays of volumes, much faster than a loop of single tests as four volumes are tested
+	// against each plane at once. aVisible[i] is set to the visibility of volume i, and the number
+	// of visible volumes is returned. Large batches can be split over a number of threads (0 to
+	// use the hardware concurrency), smaller batches always use the current thread only
+
+	// Test the visibility of an array of spheres
+	size_t CullSpheres
+	(
+		const SSphere* aSpheres,
+		bool*          aVisible,
+		const size_t   numSpheres,
+		const TUInt32  numThreads = 1
+	) const;
+
+	// Test the visibility of an array of axis-aligned boxes
+	size_t CullAABBs
+	(
+		const SAABB*  aBoxes,
+		bool*         aVisible,
+		const size_t  numBoxes,
+		const TUInt32 numThreads = 1
+	) const;
+
+
+/*---------------------------------------------------------------------------------------------
+	Data
+---------------------------------------------------------------------------------------------*/
+private:
+	CVector4 maPlanes[kNumFrustumPlanes]; // Normalised planes, see GetPlane
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Ray intersection
+-----------------------------------------------------------------------------------------*/
+// Rays are given by an origin and a direction, which need not be normalised - distances are
+// returned as multiples of the direction length. Only intersections in front of the origin (at
+// distance >= 0) count
+
+// Test if a ray intersects an axis-aligned box. If so, optionally return the distance to where it
+// enters the box in pDistance (0 if the origin is inside the box)
+bool IntersectRayAABB
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const SAABB&    box,
+	TFloat32*       pDistance = 0
+);
+
+// Test if a ray intersects a triangle (either side). If so, optionally return the distance to the
+// intersection in pDistance
+bool IntersectRayTriangle
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const CVector3& v0,
+	const CVector3& v1,
+	const CVector3& v2,
+	TFloat32*       pDistance = 0
+);
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch ray intersection
+-----------------------------------------------------------------------------------------*/
+// Test a ray against arrays of boxes or triangles, much faster than a loop of single tests as
+// four are tested at once
+
+// Intersect a ray with an array of axis-aligned boxes. aDistances[i] is set to the distance to
+// where the ray enters box i (as IntersectRayAABB), or -1 if it misses. Returns the number of
+// boxes hit
+size_t IntersectRayAABBs
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const SAABB*    aBoxes,
+	TFloat32*       aDistances,
+	const size_t    numBoxes
+);
+
+// Find the nearest intersection of a ray with a list of triangles, given as three vertices each.
+// Returns the index of the nearest triangle hit, or -1 if none are, with the distance to the hit
+// optionally returned in pDistance
+TInt32 IntersectRayTriangles
+(
+	const CVector3& rayOrigin,
+	const CVector3& rayDirection,
+	const CVector3* aVertices,
+	const size_t    numTriangles,
+	TFloat32*       pDistance = 0
+);
+
+
+} // namespace gen
+
+#endif // GEN_INTERSECTION_H_INCLUDED
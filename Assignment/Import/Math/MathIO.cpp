@@ -3,7 +3,8 @@
 	Author:       Laurent Noel
 	Date created: 11/07/07
 
-	Support for stream input and output for math classes
+	Support for stream input and output for math classes, binary input and output of arrays, and
+	fast exact text formatting and parsing
 
 	Copyright 2007, University of Central Lancashire and Laurent Noel
 
@@ -12,8 +13,20 @@
 **************************************************************************************************/
 
 #include <iostream>
+#include <charconv>
+#include <errno.h>
+#include <math.h>   // For HUGE_VALF
+#include <stdio.h>  // For snprintf
+#include <stdlib.h> // For strtof
+#include <string.h> // For memcpy
 using namespace std;
 
+// Float to_chars and from_chars are missing from some standard libraries that have the integer
+// versions, e.g. Visual Studio 2017 (v141 toolset). Those use snprintf and strtof instead
+#if defined(__cpp_lib_to_chars)
+	#define GEN_FLOAT_CHARCONV
+#endif
+
 #include "GenDefines.h"
 #include "CVector2.h"
 #include "CVector3.h"
@@ -22,6 +35,7 @@ using namespace std;
 #include "CMatrix3x3.h"
 #include "CMatrix4x4.h"
 #include "CQuaternion.h"
+#include "CQuatTransform.h"
 
 namespace gen
 {
@@ -279,4 +293,344 @@ istream& operator>>( istream& s, CQuaternion& v )
 }
 
 
+/*---------------------------------------------------------------------------------------------
+	Binary IO
+---------------------------------------------------------------------------------------------*/
+
+// The binary and text functions treat each type as an array of packed floats
+static_assert( sizeof(CVector2) == 2 * sizeof(TFloat32), "CVector2 must be packed floats" );
+static_assert( sizeof(CVector3) == 3 * sizeof(TFloat32), "CVector3 must be packed floats" );
+static_assert( sizeof(CVector4) == 4 * sizeof(TFloat32), "CVector4 must be packed floats" );
+static_assert( sizeof(CMatrix2x2) == 4 * sizeof(TFloat32), "CMatrix2x2 must be packed floats" );
+static_assert( sizeof(CMatrix3x3) == 9 * sizeof(TFloat32), "CMatrix3x3 must be packed floats" );
+static_assert( sizeof(CMatrix4x4) == 16 * sizeof(TFloat32), "CMatrix4x4 must be packed floats" );
+static_assert( sizeof(CQuaternion) == 4 * sizeof(TFloat32), "CQuaternion must be packed floats" );
+static_assert( sizeof(CQuatTransform) == 10 * sizeof(TFloat32), "CQuatTransform must be packed floats" );
+
+// Whether this platform stores values little-endian, the order used in binary files
+static bool IsLittleEndian()
+{
+	const TUInt32 one = 1;
+	TUInt8 firstByte;
+	memcpy( &firstByte, &one, 1 );
+	return firstByte == 1;
+}
+
+// Reverse the bytes of each of an array of floats, converting between big and little-endian
+static void SwapBytes( TUInt8* pBytes, const size_t numFloats )
+{
+	for (size_t i = 0; i < numFloats; ++i, pBytes += 4)
+	{
+		TUInt8 b0 = pBytes[0];
+		TUInt8 b1 = pBytes[1];
+		pBytes[0] = pBytes[3];
+		pBytes[1] = pBytes[2];
+		pBytes[2] = b1;
+		pBytes[3] = b0;
+	}
+}
+
+// Write an array of floats as 32-bit little-endian floats
+static ostream& WriteFloats( ostream& s, const TFloat32* af, const size_t numFloats )
+{
+	if (IsLittleEndian())
+	{
+		return s.write( reinterpret_cast<const char*>(af), numFloats * sizeof(TFloat32) );
+	}
+
+	// Convert in blocks to avoid allocation
+	const size_t kBlockFloats = 256;
+	TUInt8 aBlock[kBlockFloats * sizeof(TFloat32)];
+	for (size_t i = 0; i < numFloats && s; i += kBlockFloats)
+	{
+		size_t blockFloats = Min( kBlockFloats, numFloats - i );
+		memcpy( aBlock, af + i, blockFloats * sizeof(TFloat32) );
+		SwapBytes( aBlock, blockFloats );
+		s.write( reinterpret_cast<const char*>(aBlock), blockFloats * sizeof(TFloat32) );
+	}
+	return s;
+}
+
+// Read an array of 32-bit little-endian floats
+static istream& ReadFloats( istream& s, TFloat32* af, const size_t numFloats )
+{
+	s.read( reinterpret_cast<char*>(af), numFloats * sizeof(TFloat32) );
+	if (s && !IsLittleEndian())
+	{
+		SwapBytes( reinterpret_cast<TUInt8*>(af), numFloats );
+	}
+	return s;
+}
+
+
+ostream& WriteBinary( ostream& s, const CVector2* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->x, 2 * count );
+}
+ostream& WriteBinary( ostream& s, const CVector3* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->x, 3 * count );
+}
+ostream& WriteBinary( ostream& s, const CVector4* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->x, 4 * count );
+}
+ostream& WriteBinary( ostream& s, const CMatrix2x2* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->e00, 4 * count );
+}
+ostream& WriteBinary( ostream& s, const CMatrix3x3* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->e00, 9 * count );
+}
+ostream& WriteBinary( ostream& s, const CMatrix4x4* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->e00, 16 * count );
+}
+ostream& WriteBinary( ostream& s, const CQuaternion* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->w, 4 * count );
+}
+ostream& WriteBinary( ostream& s, const CQuatTransform* aIn, const size_t count )
+{
+	return WriteFloats( s, &aIn->pos.x, 10 * count );
+}
+
+
+istream& ReadBinary( istream& s, CVector2* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->x, 2 * count );
+}
+istream& ReadBinary( istream& s, CVector3* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->x, 3 * count );
+}
+istream& ReadBinary( istream& s, CVector4* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->x, 4 * count );
+}
+istream& ReadBinary( istream& s, CMatrix2x2* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->e00, 4 * count );
+}
+istream& ReadBinary( istream& s, CMatrix3x3* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->e00, 9 * count );
+}
+istream& ReadBinary( istream& s, CMatrix4x4* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->e00, 16 * count );
+}
+istream& ReadBinary( istream& s, CQuaternion* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->w, 4 * count );
+}
+istream& ReadBinary( istream& s, CQuatTransform* aOut, const size_t count )
+{
+	return ReadFloats( s, &aOut->pos.x, 10 * count );
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Text formatting and parsing
+---------------------------------------------------------------------------------------------*/
+
+// Write a float as text, returning a pointer just past the text or 0 if the buffer is too small
+static char* FormatFloat( char* pFirst, char* pLast, const TFloat32 f )
+{
+#if defined(GEN_FLOAT_CHARCONV)
+	to_chars_result result = to_chars( pFirst, pLast, f );
+	return (result.ec == errc()) ? result.ptr : 0;
+#else
+	// Nine significant digits always read back to the same float, though may not be the shortest
+	char text[32];
+	int length = snprintf( text, sizeof(text), "%.9g", f );
+	if (length < 0 || length > pLast - pFirst)  return 0;
+	memcpy( pFirst, text, length );
+	return pFirst + length;
+#endif
+}
+
+// Read a float from text as from_chars does - no leading whitespace or +. Returns a pointer just
+// past the text read, or 0 on error in which case the value is not changed
+static const char* ParseFloat( const char* pFirst, const char* pLast, TFloat32& f )
+{
+#if defined(GEN_FLOAT_CHARCONV)
+	from_chars_result result = from_chars( pFirst, pLast, f );
+	return (result.ec == errc()) ? result.ptr : 0;
+#else
+	// strtof needs a terminated string, so copy the characters a number can hold. Stopping at 'x'
+	// leaves out hex, which from_chars does not read either
+	char text[64];
+	size_t length = 0;
+	while (pFirst + length != pLast && length < sizeof(text) - 1)
+	{
+		char c = pFirst[length];
+		if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '.' || c == '+') ||
+		    c == 'x' || c == 'X')  break;
+		text[length++] = c;
+	}
+	if (length == 0 || text[0] == '+')  return 0;
+	text[length] = '\0';
+
+	char* end;
+	errno = 0;
+	float value = strtof( text, &end );
+	if (end == text || (errno == ERANGE && (value == HUGE_VALF || value == -HUGE_VALF)))  return 0;
+	f = value;
+	return pFirst + (end - text);
+#endif
+}
+
+// Write an array of floats as text in brackets, e.g. "(1, 2, 3)". Rows of a matrix are separated
+// by ",  " and the floats within a row by the given separator. Returns a pointer just past the
+// text, or 0 if the buffer is too small
+static char* FormatFloats
+(
+	char*           pFirst,
+	char*           pLast,
+	const TFloat32* af,
+	const size_t    numFloats,
+	const size_t    rowLength,
+	const char*     separator
+)
+{
+	if (pFirst == pLast)  return 0;
+	*pFirst++ = '(';
+	for (size_t i = 0; i < numFloats; ++i)
+	{
+		pFirst = FormatFloat( pFirst, pLast, af[i] );
+		if (!pFirst)  return 0;
+
+		const char* text = (i == numFloats - 1) ? ")" : ((i + 1) % rowLength == 0) ? ",  " : separator;
+		size_t length = strlen( text );
+		if (static_cast<size_t>(pLast - pFirst) < length)  return 0;
+		memcpy( pFirst, text, length );
+		pFirst += length;
+	}
+	return pFirst;
+}
+
+// Skip spaces, tabs and newlines
+static const char* SkipWhitespace( const char* pFirst, const char* pLast )
+{
+	while (pFirst != pLast && (*pFirst == ' ' || *pFirst == '\t' || *pFirst == '\n' || *pFirst == '\r'))
+	{
+		++pFirst;
+	}
+	return pFirst;
+}
+
+// Read an array of floats from text in brackets separated by commas, with any whitespace between
+// elements. Returns a pointer just past the text, or 0 on error
+static const char* ParseFloats
+(
+	const char*  pFirst,
+	const char*  pLast,
+	TFloat32*    af,
+	const size_t numFloats
+)
+{
+	pFirst = SkipWhitespace( pFirst, pLast );
+	if (pFirst == pLast || *pFirst != '(')  return 0;
+	++pFirst;
+	for (size_t i = 0; i < numFloats; ++i)
+	{
+		pFirst = SkipWhitespace( pFirst, pLast );
+		if (pFirst != pLast && *pFirst == '+')  ++pFirst; // ParseFloat does not accept a leading +
+		pFirst = ParseFloat( pFirst, pLast, af[i] );
+		if (!pFirst)  return 0;
+		pFirst = SkipWhitespace( pFirst, pLast );
+
+		char expected = (i == numFloats - 1) ? ')' : ',';
+		if (pFirst == pLast || *pFirst != expected)  return 0;
+		++pFirst;
+	}
+	return pFirst;
+}
+
+// Parse a value held as the given number of packed floats, only setting it if all input is valid
+template <class T>
+static const char* ParseValue( const char* pFirst, const char* pLast, T& value, const size_t numFloats )
+{
+	TFloat32 af[16];
+	pFirst = ParseFloats( pFirst, pLast, af, numFloats );
+	if (pFirst)
+	{
+		memcpy( &value, af, numFloats * sizeof(TFloat32) );
+	}
+	return pFirst;
+}
+
+
+char* FormatText( char* pFirst, char* pLast, const TFloat32 f )
+{
+	return FormatFloat( pFirst, pLast, f );
+}
+char* FormatText( char* pFirst, char* pLast, const CVector2& v )
+{
+	return FormatFloats( pFirst, pLast, &v.x, 2, 2, ", " );
+}
+char* FormatText( char* pFirst, char* pLast, const CVector3& v )
+{
+	return FormatFloats( pFirst, pLast, &v.x, 3, 3, ", " );
+}
+char* FormatText( char* pFirst, char* pLast, const CVector4& v )
+{
+	return FormatFloats( pFirst, pLast, &v.x, 4, 4, ", " );
+}
+char* FormatText( char* pFirst, char* pLast, const CMatrix2x2& m )
+{
+	return FormatFloats( pFirst, pLast, &m.e00, 4, 2, "," );
+}
+char* FormatText( char* pFirst, char* pLast, const CMatrix3x3& m )
+{
+	return FormatFloats( pFirst, pLast, &m.e00, 9, 3, "," );
+}
+char* FormatText( char* pFirst, char* pLast, const CMatrix4x4& m )
+{
+	return FormatFloats( pFirst, pLast, &m.e00, 16, 4, "," );
+}
+char* FormatText( char* pFirst, char* pLast, const CQuaternion& q )
+{
+	return FormatFloats( pFirst, pLast, &q.w, 4, 4, "," );
+}
+
+
+const char* ParseText( const char* pFirst, const char* pLast, TFloat32& f )
+{
+	pFirst = SkipWhitespace( pFirst, pLast );
+	if (pFirst != pLast && *pFirst == '+')  ++pFirst;
+	return ParseFloat( pFirst, pLast, f );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CVector2& v )
+{
+	return ParseValue( pFirst, pLast, v, 2 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CVector3& v )
+{
+	return ParseValue( pFirst, pLast, v, 3 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CVector4& v )
+{
+	return ParseValue( pFirst, pLast, v, 4 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix2x2& m )
+{
+	return ParseValue( pFirst, pLast, m, 4 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix3x3& m )
+{
+	return ParseValue( pFirst, pLast, m, 9 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix4x4& m )
+{
+	return ParseValue( pFirst, pLast, m, 16 );
+}
+const char* ParseText( const char* pFirst, const char* pLast, CQuaternion& q )
+{
+	return ParseValue( pFirst, pLast, q, 4 );
+}
+
+
 } // namespace gen
@@ -3,7 +3,8 @@
 	Author:       Laurent Noel
 	Date created: 11/07/07
 
-	Support for stream input and output for math classes
+	Support for stream input and output for math classes, binary input and output of arrays, and
+	fast exact text formatting and parsing
 
 	Copyright 2007, University of Central Lancashire and Laurent Noel
 
@@ -30,6 +31,7 @@ class CMatrix2x2;
 class CMatrix3x3;
 class CMatrix4x4;
 class CQuaternion;
+class CQuatTransform;
 
 
 /*---------------------------------------------------------------------------------------------
@@ -67,6 +69,71 @@ ostream& operator<<( ostream& s, const CQuaternion& v );
 istream& operator>>( istream& s, CQuaternion& v );
 
 
+/*---------------------------------------------------------------------------------------------
+	Binary IO
+---------------------------------------------------------------------------------------------*/
+// Read and write arrays of math types as their floats in memory order (e.g. CMatrix4x4 as e00,
+// e01.. e33, CQuaternion as w, x, y, z, CQuatTransform as pos, quat, scale), stored as 32-bit
+// little-endian IEEE floats so files are the same on any platform. On little-endian platforms (all
+// current targets) the array is written or read in a single block with no conversion. Errors are
+// reported in the stream state as usual, the contents of the output array are undefined after a
+// failed read
+
+ostream& WriteBinary( ostream& s, const CVector2* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CVector3* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CVector4* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CMatrix2x2* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CMatrix3x3* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CMatrix4x4* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CQuaternion* aIn, const size_t count );
+ostream& WriteBinary( ostream& s, const CQuatTransform* aIn, const size_t count );
+
+istream& ReadBinary( istream& s, CVector2* aOut, const size_t count );
+istream& ReadBinary( istream& s, CVector3* aOut, const size_t count );
+istream& ReadBinary( istream& s, CVector4* aOut, const size_t count );
+istream& ReadBinary( istream& s, CMatrix2x2* aOut, const size_t count );
+istream& ReadBinary( istream& s, CMatrix3x3* aOut, const size_t count );
+istream& ReadBinary( istream& s, CMatrix4x4* aOut, const size_t count );
+istream& ReadBinary( istream& s, CQuaternion* aOut, const size_t count );
+istream& ReadBinary( istream& s, CQuatTransform* aOut, const size_t count );
+
+
+/*---------------------------------------------------------------------------------------------
+	Text formatting and parsing
+---------------------------------------------------------------------------------------------*/
+// Text in the same format as the stream operators above, but many times faster (no streams,
+// locales or allocation) and exact - floats are written with the fewest digits that read back to
+// the same value, so text written by FormatText and read by ParseText round-trips losslessly.
+// ParseText also reads the output of the stream operators. Standard libraries without float
+// to_chars (e.g. Visual Studio 2017) write nine significant digits instead, still exact
+
+// Longest text FormatText writes per float, including its separator (and the opening bracket).
+// So a buffer of kMaxTextPerFloat * number of floats always fits (no null terminator is written)
+const size_t kMaxTextPerFloat = 18;
+
+// Write a value as text to the buffer [pFirst, pLast). Returns a pointer just past the text
+// written, or 0 if the buffer is too small
+char* FormatText( char* pFirst, char* pLast, const TFloat32 f );
+char* FormatText( char* pFirst, char* pLast, const CVector2& v );
+char* FormatText( char* pFirst, char* pLast, const CVector3& v );
+char* FormatText( char* pFirst, char* pLast, const CVector4& v );
+char* FormatText( char* pFirst, char* pLast, const CMatrix2x2& m );
+char* FormatText( char* pFirst, char* pLast, const CMatrix3x3& m );
+char* FormatText( char* pFirst, char* pLast, const CMatrix4x4& m );
+char* FormatText( char* pFirst, char* pLast, const CQuaternion& q );
+
+// Read a value from text in the buffer [pFirst, pLast), skipping leading whitespace. Returns a
+// pointer just past the text read, or 0 on error in which case the value is not changed
+const char* ParseText( const char* pFirst, const char* pLast, TFloat32& f );
+const char* ParseText( const char* pFirst, const char* pLast, CVector2& v );
+const char* ParseText( const char* pFirst, const char* pLast, CVector3& v );
+const char* ParseText( const char* pFirst, const char* pLast, CVector4& v );
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix2x2& m );
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix3x3& m );
+const char* ParseText( const char* pFirst, const char* pLast, CMatrix4x4& m );
+const char* ParseText( const char* pFirst, const char* pLast, CQuaternion& q );
+
+
 } // namespace gen
 
 #endif // GEN_C_MATHIO_H_INCLUDED
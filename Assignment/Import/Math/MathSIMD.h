@@ -0,0 +1,762 @@
+/**************************************************************************************************
+	Module:       MathSIMD.h
+
+	Platform-independent 4-wide float SIMD operations, used to optimise the math classes. Maps to
+	SSE on x86/x64 (with FMA and AVX where the compiler targets them), NEON on ARM, or plain
+	scalar code elsewhere
+
+	Change history:
+		V1.0    Created with SSE, NEON and scalar implementations
+		V1.1    Added min/max, rounding, selection and exponent operations for FastMath.h
+		V1.2    Added MoveMask4 for branching on comparison results
+		V1.3    Added integer bit operations for random number generation
+**************************************************************************************************/
+
+// The math classes use these functions rather than intrinsics directly, so each new platform only
+// needs an implementation of this file. Only operations with a cheap equivalent on every platform
+// are provided. Define GEN_NO_SIMD before including this file (e.g. in the project settings) to
+// use the scalar implementation on any platform, e.g. for testing or comparison
+//
+// Platform selected is indicated by one of these constants being defined:
+//     GEN_SIMD_SSE  - SSE2 (always available on x64). GEN_SIMD_FMA, GEN_SIMD_AVX and GEN_SIMD_AVX2
+//                     are also defined if the compiler targets those instruction sets (e.g. /arch:AVX2)
+//     GEN_SIMD_NEON - ARM NEON
+//     GEN_SIMD_NONE - Scalar implementation
+//
+// Aligned loads and stores require 16-byte aligned addresses, see GEN_ALIGN and CAlignedAllocator
+
+#ifndef GEN_MATH_SIMD_H_INCLUDED
+#define GEN_MATH_SIMD_H_INCLUDED
+
+#include <math.h>
+
+#include "GenDefines.h"
+
+// Select platform
+#if defined(GEN_NO_SIMD)
+	#define GEN_SIMD_NONE
+#elif defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	#define GEN_SIMD_SSE
+	#include <emmintrin.h>
+	#if defined(__AVX__)
+		#define GEN_SIMD_AVX
+		#include <immintrin.h>
+	#endif
+	#if defined(__AVX2__)
+		#define GEN_SIMD_AVX2
+	#endif
+	#if defined(__FMA__) || defined(__AVX2__) // Visual C++ only indicates FMA support with AVX2
+		#define GEN_SIMD_FMA
+		#include <immintrin.h>
+	#endif
+#elif defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define GEN_SIMD_NEON
+	#include <arm_neon.h>
+#else
+	#define GEN_SIMD_NONE
+#endif
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Types
+-----------------------------------------------------------------------------------------*/
+
+// Four 32-bit floats in a SIMD register. Lanes are numbered 0 to 3 and referred to as x, y, z & w
+// in comments, matching the order they are stored in memory
+#if defined(GEN_SIMD_SSE)
+	typedef __m128 TFloat32x4;
+#elif defined(GEN_SIMD_NEON)
+	typedef float32x4_t TFloat32x4;
+#else
+	struct TFloat32x4
+	{
+		TFloat32 f[4];
+	};
+#endif
+
+
+/*-----------------------------------------------------------------------------------------
+	Load / store
+-----------------------------------------------------------------------------------------*/
+
+// Load four floats from a 16-byte aligned address
+inline TFloat32x4 Load4( const TFloat32* pf )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_load_ps( pf );
+#elif defined(GEN_SIMD_NEON)
+	return vld1q_f32( pf );
+#else
+	TFloat32x4 v = { pf[0], pf[1], pf[2], pf[3] };
+	return v;
+#endif
+}
+
+// Load four floats from any address
+inline TFloat32x4 Load4Unaligned( const TFloat32* pf )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_loadu_ps( pf );
+#else
+	return Load4( pf ); // NEON and scalar loads have no alignment requirement
+#endif
+}
+
+// Store four floats to a 16-byte aligned address
+inline void Store4( TFloat32* pf, const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	_mm_store_ps( pf, v );
+#elif defined(GEN_SIMD_NEON)
+	vst1q_f32( pf, v );
+#else
+	pf[0] = v.f[0];  pf[1] = v.f[1];  pf[2] = v.f[2];  pf[3] = v.f[3];
+#endif
+}
+
+// Store four floats to any address
+inline void Store4Unaligned( TFloat32* pf, const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	_mm_storeu_ps( pf, v );
+#else
+	Store4( pf, v );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Construction
+-----------------------------------------------------------------------------------------*/
+
+// Return (x, y, z, w)
+inline TFloat32x4 Set4( const TFloat32 x, const TFloat32 y, const TFloat32 z, const TFloat32 w )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_setr_ps( x, y, z, w );
+#elif defined(GEN_SIMD_NEON)
+	const TFloat32 af[4] = { x, y, z, w };
+	return vld1q_f32( af );
+#else
+	TFloat32x4 v = { x, y, z, w };
+	return v;
+#endif
+}
+
+// Return the given value in all four lanes
+inline TFloat32x4 Splat4( const TFloat32 s )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_set1_ps( s );
+#elif defined(GEN_SIMD_NEON)
+	return vdupq_n_f32( s );
+#else
+	TFloat32x4 v = { s, s, s, s };
+	return v;
+#endif
+}
+
+// Return zero in all four lanes
+inline TFloat32x4 Zero4()
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_setzero_ps();
+#else
+	return Splat4( 0.0f );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Lane access / rearrangement
+-----------------------------------------------------------------------------------------*/
+// Lane numbers are template parameters as all platforms need them at compile time
+
+// Return the value in one lane
+template <int Lane>
+inline TFloat32 GetLane4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_cvtss_f32( _mm_shuffle_ps( v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane) ) );
+#elif defined(GEN_SIMD_NEON)
+	return vgetq_lane_f32( v, Lane );
+#else
+	return v.f[Lane];
+#endif
+}
+
+// Return (a[X], a[Y], b[Z], b[W]), i.e. the first two lanes selected from a, the last two from b
+template <int X, int Y, int Z, int W>
+inline TFloat32x4 Shuffle4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_shuffle_ps( a, b, _MM_SHUFFLE(W, Z, Y, X) );
+#elif defined(GEN_SIMD_NEON)
+	// No general NEON shuffle - lane moves with constant indices compile to single instructions
+	float32x4_t v = vmovq_n_f32( vgetq_lane_f32( a, X ) );
+	v = vsetq_lane_f32( vgetq_lane_f32( a, Y ), v, 1 );
+	v = vsetq_lane_f32( vgetq_lane_f32( b, Z ), v, 2 );
+	return vsetq_lane_f32( vgetq_lane_f32( b, W ), v, 3 );
+#else
+	TFloat32x4 v = { a.f[X], a.f[Y], b.f[Z], b.f[W] };
+	return v;
+#endif
+}
+
+// Return (v[X], v[Y], v[Z], v[W])
+template <int X, int Y, int Z, int W>
+inline TFloat32x4 Swizzle4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_castsi128_ps( _mm_shuffle_epi32( _mm_castps_si128( v ), _MM_SHUFFLE(W, Z, Y, X) ) );
+#else
+	return Shuffle4<X, Y, Z, W>( v, v );
+#endif
+}
+
+// Return the value in one lane copied to all four lanes
+template <int Lane>
+inline TFloat32x4 SplatLane4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_NEON)
+	return vdupq_n_f32( vgetq_lane_f32( v, Lane ) );
+#else
+	return Swizzle4<Lane, Lane, Lane, Lane>( v );
+#endif
+}
+
+// Transpose four vectors as if they were the rows of a 4x4 matrix
+inline void Transpose4( TFloat32x4& v0, TFloat32x4& v1, TFloat32x4& v2, TFloat32x4& v3 )
+{
+#if defined(GEN_SIMD_SSE)
+	_MM_TRANSPOSE4_PS( v0, v1, v2, v3 );
+#elif defined(GEN_SIMD_NEON)
+	float32x4x2_t t01 = vtrnq_f32( v0, v1 ); // (x0 x1 z0 z1), (y0 y1 w0 w1)
+	float32x4x2_t t23 = vtrnq_f32( v2, v3 ); // (x2 x3 z2 z3), (y2 y3 w2 w3)
+	v0 = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	v1 = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	v2 = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	v3 = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) );
+#else
+	TFloat32 t;
+	t = v0.f[1];  v0.f[1] = v1.f[0];  v1.f[0] = t;
+	t = v0.f[2];  v0.f[2] = v2.f[0];  v2.f[0] = t;
+	t = v0.f[3];  v0.f[3] = v3.f[0];  v3.f[0] = t;
+	t = v1.f[2];  v1.f[2] = v2.f[1];  v2.f[1] = t;
+	t = v1.f[3];  v1.f[3] = v3.f[1];  v3.f[1] = t;
+	t = v2.f[3];  v2.f[3] = v3.f[2];  v3.f[2] = t;
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Arithmetic
+-----------------------------------------------------------------------------------------*/
+
+// Return a + b
+inline TFloat32x4 Add4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_add_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vaddq_f32( a, b );
+#else
+	TFloat32x4 v = { a.f[0] + b.f[0], a.f[1] + b.f[1], a.f[2] + b.f[2], a.f[3] + b.f[3] };
+	return v;
+#endif
+}
+
+// Return a - b
+inline TFloat32x4 Sub4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_sub_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vsubq_f32( a, b );
+#else
+	TFloat32x4 v = { a.f[0] - b.f[0], a.f[1] - b.f[1], a.f[2] - b.f[2], a.f[3] - b.f[3] };
+	return v;
+#endif
+}
+
+// Return a * b
+inline TFloat32x4 Mul4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_mul_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vmulq_f32( a, b );
+#else
+	TFloat32x4 v = { a.f[0] * b.f[0], a.f[1] * b.f[1], a.f[2] * b.f[2], a.f[3] * b.f[3] };
+	return v;
+#endif
+}
+
+// Return a / b. Full precision division, which is slow on all platforms (and emulated on 32-bit ARM)
+inline TFloat32x4 Div4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_div_ps( a, b );
+#elif defined(GEN_SIMD_NEON) && (defined(_M_ARM64) || defined(__aarch64__))
+	return vdivq_f32( a, b );
+#elif defined(GEN_SIMD_NEON)
+	// Reciprocal estimate refined by two Newton-Raphson steps
+	float32x4_t r = vrecpeq_f32( b );
+	r = vmulq_f32( vrecpsq_f32( b, r ), r );
+	r = vmulq_f32( vrecpsq_f32( b, r ), r );
+	return vmulq_f32( a, r );
+#else
+	TFloat32x4 v = { a.f[0] / b.f[0], a.f[1] / b.f[1], a.f[2] / b.f[2], a.f[3] / b.f[3] };
+	return v;
+#endif
+}
+
+// Return a * b + c. Uses a fused multiply-add where available, so results may differ from Mul4
+// followed by Add4 in the last bit
+inline TFloat32x4 MulAdd4( const TFloat32x4 a, const TFloat32x4 b, const TFloat32x4 c )
+{
+#if defined(GEN_SIMD_FMA)
+	return _mm_fmadd_ps( a, b, c );
+#elif defined(GEN_SIMD_SSE)
+	return _mm_add_ps( _mm_mul_ps( a, b ), c );
+#elif defined(GEN_SIMD_NEON)
+	return vmlaq_f32( c, a, b );
+#else
+	return Add4( Mul4( a, b ), c );
+#endif
+}
+
+// Return c - a * b. Fused where available as MulAdd4
+inline TFloat32x4 NegMulAdd4( const TFloat32x4 a, const TFloat32x4 b, const TFloat32x4 c )
+{
+#if defined(GEN_SIMD_FMA)
+	return _mm_fnmadd_ps( a, b, c );
+#elif defined(GEN_SIMD_SSE)
+	return _mm_sub_ps( c, _mm_mul_ps( a, b ) );
+#elif defined(GEN_SIMD_NEON)
+	return vmlsq_f32( c, a, b );
+#else
+	return Sub4( c, Mul4( a, b ) );
+#endif
+}
+
+// Return the sum of the four lanes in all four lanes
+inline TFloat32x4 HorizontalAdd4( const TFloat32x4 v )
+{
+	TFloat32x4 t = Add4( v, Swizzle4<1, 0, 3, 2>( v ) );
+	return Add4( t, Swizzle4<2, 3, 0, 1>( t ) );
+}
+
+// Return the square root of each lane. Full precision, slow as Div4
+inline TFloat32x4 Sqrt4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_sqrt_ps( v );
+#elif defined(GEN_SIMD_NEON) && (defined(_M_ARM64) || defined(__aarch64__))
+	return vsqrtq_f32( v );
+#elif defined(GEN_SIMD_NEON)
+	// v * 1/sqrt(v), reciprocal square root estimate refined by two Newton-Raphson steps. The estimate
+	// is of a value at least the smallest normal float so the result for 0 is 0 rather than 0 * inf
+	float32x4_t e = vmaxq_f32( v, vdupq_n_f32( 1.175494351e-38f ) );
+	float32x4_t r = vrsqrteq_f32( e );
+	r = vmulq_f32( vrsqrtsq_f32( vmulq_f32( e, r ), r ), r );
+	r = vmulq_f32( vrsqrtsq_f32( vmulq_f32( e, r ), r ), r );
+	return vmulq_f32( v, r );
+#else
+	TFloat32x4 r = { sqrtf( v.f[0] ), sqrtf( v.f[1] ), sqrtf( v.f[2] ), sqrtf( v.f[3] ) };
+	return r;
+#endif
+}
+
+// Return an estimate of 1 / sqrt of each lane, with relative error up to 1/4096 on SSE and 1/256
+// on NEON (exact on the scalar implementation). Refine with a Newton-Raphson step for more
+// precision, see InvSqrt4 in FastMath.h
+inline TFloat32x4 InvSqrtEstimate4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_rsqrt_ps( v );
+#elif defined(GEN_SIMD_NEON)
+	return vrsqrteq_f32( v );
+#else
+	TFloat32x4 r = { 1.0f / sqrtf( v.f[0] ), 1.0f / sqrtf( v.f[1] ),
+	                 1.0f / sqrtf( v.f[2] ), 1.0f / sqrtf( v.f[3] ) };
+	return r;
+#endif
+}
+
+// Return the minimum of a and b in each lane
+inline TFloat32x4 Min4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_min_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vminq_f32( a, b );
+#else
+	TFloat32x4 v = { (b.f[0] < a.f[0]) ? b.f[0] : a.f[0], (b.f[1] < a.f[1]) ? b.f[1] : a.f[1],
+	                 (b.f[2] < a.f[2]) ? b.f[2] : a.f[2], (b.f[3] < a.f[3]) ? b.f[3] : a.f[3] };
+	return v;
+#endif
+}
+
+// Return the maximum of a and b in each lane
+inline TFloat32x4 Max4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_max_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vmaxq_f32( a, b );
+#else
+	TFloat32x4 v = { (a.f[0] < b.f[0]) ? b.f[0] : a.f[0], (a.f[1] < b.f[1]) ? b.f[1] : a.f[1],
+	                 (a.f[2] < b.f[2]) ? b.f[2] : a.f[2], (a.f[3] < b.f[3]) ? b.f[3] : a.f[3] };
+	return v;
+#endif
+}
+
+// Return each lane rounded to the nearest integer (still as a float). Only valid for values of
+// magnitude less than 2^22. Halfway cases may round either way depending on platform
+inline TFloat32x4 Round4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_cvtepi32_ps( _mm_cvtps_epi32( v ) );
+#elif defined(GEN_SIMD_NEON) && (defined(_M_ARM64) || defined(__aarch64__))
+	return vrndnq_f32( v );
+#elif defined(GEN_SIMD_NEON)
+	// Adding and subtracting 1.5 * 2^23 leaves no bits for the fraction, so the addition rounds
+	const float32x4_t magic = vdupq_n_f32( 12582912.0f );
+	return vsubq_f32( vaddq_f32( v, magic ), magic );
+#else
+	TFloat32x4 r = { floorf( v.f[0] + 0.5f ), floorf( v.f[1] + 0.5f ),
+	                 floorf( v.f[2] + 0.5f ), floorf( v.f[3] + 0.5f ) };
+	return r;
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Comparison / masks
+-----------------------------------------------------------------------------------------*/
+// Comparisons return a mask in each lane: all bits set if the comparison is true, clear if false.
+// Masks can be combined with values using the bitwise functions, e.g. And4( v, mask ) zeroes the
+// lanes where the comparison failed
+
+#if defined(GEN_SIMD_NONE)
+// Bitwise access to a float for the scalar implementation
+union UFloat32Bits
+{
+	TFloat32 f;
+	TUInt32  i;
+};
+#endif
+
+// Return a mask of lanes where a >= b
+inline TFloat32x4 GreaterEqual4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_cmpge_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vcgeq_f32( a, b ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.i = (a.f[i] >= b.f[i]) ? 0xffffffff : 0;
+		r.f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+// Return a & b, bitwise
+inline TFloat32x4 And4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_and_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bitsA, bitsB;
+		bitsA.f = a.f[i];
+		bitsB.f = b.f[i];
+		bitsA.i &= bitsB.i;
+		r.f[i] = bitsA.f;
+	}
+	return r;
+#endif
+}
+
+// Return a mask of lanes where a > b
+inline TFloat32x4 Greater4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_cmpgt_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vcgtq_f32( a, b ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.i = (a.f[i] > b.f[i]) ? 0xffffffff : 0;
+		r.f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+// Return a | b, bitwise
+inline TFloat32x4 Or4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_or_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bitsA, bitsB;
+		bitsA.f = a.f[i];
+		bitsB.f = b.f[i];
+		bitsA.i |= bitsB.i;
+		r.f[i] = bitsA.f;
+	}
+	return r;
+#endif
+}
+
+// Return a ^ b, bitwise
+inline TFloat32x4 Xor4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_xor_ps( a, b );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( veorq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bitsA, bitsB;
+		bitsA.f = a.f[i];
+		bitsB.f = b.f[i];
+		bitsA.i ^= bitsB.i;
+		r.f[i] = bitsA.f;
+	}
+	return r;
+#endif
+}
+
+// Return a in the lanes where mask is set, b elsewhere
+inline TFloat32x4 Select4( const TFloat32x4 mask, const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+#elif defined(GEN_SIMD_NEON)
+	return vbslq_f32( vreinterpretq_u32_f32( mask ), a, b );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bitsMask;
+		bitsMask.f = mask.f[i];
+		r.f[i] = bitsMask.i ? a.f[i] : b.f[i];
+	}
+	return r;
+#endif
+}
+
+// Return the sign bit of each lane (a mask of the sign bit for negative lanes, zero otherwise).
+// Xor4 with the result of this function copies a sign onto a positive value
+inline TFloat32x4 SignBit4( const TFloat32x4 v )
+{
+	return And4( v, Splat4( -0.0f ) );
+}
+
+// Return the absolute value of each lane
+inline TFloat32x4 Abs4( const TFloat32x4 v )
+{
+	return Xor4( v, SignBit4( v ) );
+}
+
+// Return the top (sign) bit of each lane as bits 0 to 3 of an integer - for a comparison mask, the
+// bits are set for the lanes where the comparison was true. Used to branch on comparisons or count
+// the lanes that pass
+inline int MoveMask4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_movemask_ps( v );
+#elif defined(GEN_SIMD_NEON)
+	uint32x4_t bits = vshrq_n_u32( vreinterpretq_u32_f32( v ), 31 );
+	return static_cast<int>(vgetq_lane_u32( bits, 0 )        | (vgetq_lane_u32( bits, 1 ) << 1) |
+	                        (vgetq_lane_u32( bits, 2 ) << 2) | (vgetq_lane_u32( bits, 3 ) << 3));
+#else
+	int mask = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.f = v.f[i];
+		mask |= static_cast<int>(bits.i >> 31) << i;
+	}
+	return mask;
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Integer bit operations
+-----------------------------------------------------------------------------------------*/
+// Treat the bits of each lane as a 32-bit unsigned integer, for integer algorithms such as random
+// number generation that produce float results. Combine with the bitwise functions above
+
+// Return the given bit pattern in all four lanes
+inline TFloat32x4 SplatBits4( const TUInt32 i )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_castsi128_ps( _mm_set1_epi32( static_cast<int>(i) ) );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vdupq_n_u32( i ) );
+#else
+	UFloat32Bits bits;
+	bits.i = i;
+	TFloat32x4 v = { bits.f, bits.f, bits.f, bits.f };
+	return v;
+#endif
+}
+
+// Return the integer sum of each lane, wrapping on overflow
+inline TFloat32x4 AddBits4( const TFloat32x4 a, const TFloat32x4 b )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_castsi128_ps( _mm_add_epi32( _mm_castps_si128( a ), _mm_castps_si128( b ) ) );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vaddq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bitsA, bitsB;
+		bitsA.f = a.f[i];
+		bitsB.f = b.f[i];
+		bitsA.i += bitsB.i;
+		r.f[i] = bitsA.f;
+	}
+	return r;
+#endif
+}
+
+// Shift the bits of each lane left by N (1 to 31)
+template <int N>
+inline TFloat32x4 ShiftLeftBits4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_castsi128_ps( _mm_slli_epi32( _mm_castps_si128( v ), N ) );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vshlq_n_u32( vreinterpretq_u32_f32( v ), N ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.f = v.f[i];
+		bits.i <<= N;
+		r.f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+// Shift the bits of each lane right by N (1 to 31), shifting in zeros
+template <int N>
+inline TFloat32x4 ShiftRightBits4( const TFloat32x4 v )
+{
+#if defined(GEN_SIMD_SSE)
+	return _mm_castsi128_ps( _mm_srli_epi32( _mm_castps_si128( v ), N ) );
+#elif defined(GEN_SIMD_NEON)
+	return vreinterpretq_f32_u32( vshrq_n_u32( vreinterpretq_u32_f32( v ), N ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.f = v.f[i];
+		bits.i >>= N;
+		r.f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+// Rotate the bits of each lane left by N (1 to 31)
+template <int N>
+inline TFloat32x4 RotateLeftBits4( const TFloat32x4 v )
+{
+	return Or4( ShiftLeftBits4<N>( v ), ShiftRightBits4<32 - N>( v ) );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Exponent manipulation
+-----------------------------------------------------------------------------------------*/
+// Direct access to the exponent bits of floats, used for range reduction in exp and log functions
+
+// Return 2^n in each lane, where n holds integers (as floats) from -126 to 127
+inline TFloat32x4 Pow2Int4( const TFloat32x4 n )
+{
+#if defined(GEN_SIMD_SSE)
+	__m128i e = _mm_add_epi32( _mm_cvtps_epi32( n ), _mm_set1_epi32( 127 ) );
+	return _mm_castsi128_ps( _mm_slli_epi32( e, 23 ) );
+#elif defined(GEN_SIMD_NEON)
+	int32x4_t e = vaddq_s32( vcvtq_s32_f32( n ), vdupq_n_s32( 127 ) );
+	return vreinterpretq_f32_s32( vshlq_n_s32( e, 23 ) );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.i = static_cast<TUInt32>(static_cast<int>(n.f[i]) + 127) << 23;
+		r.f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+// Split each lane of positive normal floats into an exponent (returned, as a float) and a
+// mantissa in the range [1, 2), such that v = mantissa * 2^exponent
+inline TFloat32x4 SplitExponent4( const TFloat32x4 v, TFloat32x4* pMantissa )
+{
+#if defined(GEN_SIMD_SSE)
+	__m128i bits = _mm_castps_si128( v );
+	__m128i mantissaBits = _mm_or_si128( _mm_and_si128( bits, _mm_set1_epi32( 0x007fffff ) ),
+	                                     _mm_set1_epi32( 0x3f800000 ) );
+	*pMantissa = _mm_castsi128_ps( mantissaBits );
+	return _mm_cvtepi32_ps( _mm_sub_epi32( _mm_srli_epi32( bits, 23 ), _mm_set1_epi32( 127 ) ) );
+#elif defined(GEN_SIMD_NEON)
+	uint32x4_t bits = vreinterpretq_u32_f32( v );
+	uint32x4_t mantissaBits = vorrq_u32( vandq_u32( bits, vdupq_n_u32( 0x007fffff ) ),
+	                                     vdupq_n_u32( 0x3f800000 ) );
+	*pMantissa = vreinterpretq_f32_u32( mantissaBits );
+	int32x4_t e = vsubq_s32( vreinterpretq_s32_u32( vshrq_n_u32( bits, 23 ) ), vdupq_n_s32( 127 ) );
+	return vcvtq_f32_s32( e );
+#else
+	TFloat32x4 r;
+	for (int i = 0; i < 4; ++i)
+	{
+		UFloat32Bits bits;
+		bits.f = v.f[i];
+		r.f[i] = static_cast<TFloat32>(static_cast<int>(bits.i >> 23) - 127);
+		bits.i = (bits.i & 0x007fffff) | 0x3f800000;
+		pMantissa->f[i] = bits.f;
+	}
+	return r;
+#endif
+}
+
+
+} // namespace gen
+
+#endif // GEN_MATH_SIMD_H_INCLUDED
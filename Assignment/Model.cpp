@@ -6,14 +6,17 @@
 #include "Model.h"
 #include "Device.h"
 #include "Scene.h"
-#include "CImportXFile.h" // Class to load meshes (taken from another graphics engine)
+
+// Number of world matrix recalculations since the count was last reset
+unsigned int Model::smMatrixUpdates = 0;
+
 
 ///////////////////////////////
 // Constructors / Destructors
 
 // Constructor - initialise all model settings - look at the constructor declaration in the header
 // file to see that there are defaults provided for everything
-Model::Model( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float scale )
+Model::Model( const gen::CVector3& position, const gen::CVector3& rotation, float scale )
 {
 	mPosition = position;
 	mRotation = rotation;
@@ -21,15 +24,8 @@ Model::Model( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float scale )
 	UpdateMatrix();
 
 	// Good practice to ensure all private data is sensibly initialised
-	mVertexBuffer = NULL;
-	mNumVertices = 0;
-	mVertexSize = 0;
-	mVertexLayout = NULL;
-
-	mIndexBuffer = NULL;
-	mNumIndices = 0;
-
-	mHasGeometry = false;
+	mGeometry = NULL;
+	mExampleTechnique = NULL;
 }
 
 // Model destructor
@@ -41,20 +37,17 @@ Model::~Model()
 // Release resources used by model
 void Model::ReleaseResources()
 {
-	// Release resources
-	if (mIndexBuffer )  mIndexBuffer ->Release();
-	if (mVertexBuffer)  mVertexBuffer->Release();
-	if (mVertexLayout)  mVertexLayout->Release();
-	mHasGeometry = false;
+	// Stop using the geometry, it is released when no other models are using it
+	if (mGeometry)  mGeometry->Release();
+	mGeometry = NULL;
 }
 
 
 /////////////////////////////
 // Model Loading
 
-// The loading and parsing of ".X" files is supported using a class taken from another application.
-// We will not look at the process (more to do with parsing than graphics). Ultimately we end up
-// with arrays of data just like the previous labs where the geometry was typed in to the code
+// The loading of geometry from files is done by the Geometry class, which shares geometry between
+// models loaded from the same file with the same options
 
 // Load the model geometry from a file. This function only reads the geometry using the first
 // material in the file, so multi-material models will load but will have parts missing. May 
@@ -66,126 +59,34 @@ bool Model::Load( const string& fileName, ID3D10EffectTechnique* exampleTechniqu
 	// Release any existing geometry in this object
 	ReleaseResources();
 
-	// Use CImportXFile class (from another application) to load the given file. The import code is wrapped in the namespace 'gen'
-	gen::CImportXFile mesh;
-	if (mesh.ImportFile( fileName.c_str() ) != gen::kSuccess)
-	{
-		return false;
-	}
-
-	// Get first sub-mesh from loaded file
-	gen::SSubMesh subMesh;
-	if (mesh.GetSubMesh( 0, &subMesh, tangents ) != gen::kSuccess)
-	{
-		return false;
-	}
-
-
-	// Create vertex element list & layout. We need a vertex layout to say what data we have per vertex in this model (e.g. position, normal, uv, etc.)
-	// In previous projects the element list was a manually typed in array as we knew what data we would provide. However, as we can load models with
-	// different vertex data this time we need flexible code. The array is built up one element at a time: ask the import class if it loaded normals, 
-	// if so then add a normal line to the array, then ask if it loaded UVS...etc
-	unsigned int numElts = 0;
-	unsigned int offset = 0;
-	// Position is always required
-	mVertexElts[numElts].SemanticName = "POSITION";   // Semantic in HLSL (what is this data for)
-	mVertexElts[numElts].SemanticIndex = 0;           // Index to add to semantic (a count for this kind of data, when using multiple of the same type, e.g. TEXCOORD0, TEXCOORD1)
-	mVertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT; // Type of data - this one will be a float3 in the shader. Most data communicated as though it were colours
-	mVertexElts[numElts].AlignedByteOffset = offset;  // Offset of element from start of vertex data (e.g. if we have position (float3), uv (float2) then normal, the normal's offset is 5 floats = 5*4 = 20)
-	mVertexElts[numElts].InputSlot = 0;               // For when using multiple vertex buffers (e.g. instancing - an advanced topic)
-	mVertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA; // Use this value for most cases (only changed for instancing)
-	mVertexElts[numElts].InstanceDataStepRate = 0;                     // --"--
-	offset += 12;
-	++numElts;
-	// Repeat for each kind of vertex data
-	if (subMesh.hasNormals)
-	{
-		mVertexElts[numElts].SemanticName = "NORMAL";
-		mVertexElts[numElts].SemanticIndex = 0;
-		mVertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		mVertexElts[numElts].AlignedByteOffset = offset;
-		mVertexElts[numElts].InputSlot = 0;
-		mVertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		mVertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 12;
-		++numElts;
-	}
-	if (subMesh.hasTangents)
-	{
-		mVertexElts[numElts].SemanticName = "TANGENT";
-		mVertexElts[numElts].SemanticIndex = 0;
-		mVertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		mVertexElts[numElts].AlignedByteOffset = offset;
-		mVertexElts[numElts].InputSlot = 0;
-		mVertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		mVertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 12;
-		++numElts;
-	}
-	if (subMesh.hasTextureCoords)
-	{
-		mVertexElts[numElts].SemanticName = "TEXCOORD";
-		mVertexElts[numElts].SemanticIndex = 0;
-		mVertexElts[numElts].Format = DXGI_FORMAT_R32G32_FLOAT;
-		mVertexElts[numElts].AlignedByteOffset = offset;
-		mVertexElts[numElts].InputSlot = 0;
-		mVertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		mVertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 8;
-		++numElts;
-	}
-	if (subMesh.hasVertexColours)
-	{
-		mVertexElts[numElts].SemanticName = "COLOR";
-		mVertexElts[numElts].SemanticIndex = 0;
-		mVertexElts[numElts].Format = DXGI_FORMAT_R8G8B8A8_UNORM; // A RGBA colour with 1 byte (0-255) per component
-		mVertexElts[numElts].AlignedByteOffset = offset;
-		mVertexElts[numElts].InputSlot = 0;
-		mVertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		mVertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 4;
-		++numElts;
-	}
-	mVertexSize = offset;
-
-	// Given the vertex element list, pass it to DirectX to create a vertex layout. We also need to pass an example of a technique that will
-	// render this model. We will only be able to render this model with techniques that have the same vertex input as the example we use here
-	D3D10_PASS_DESC PassDesc;
-	exampleTechnique->GetPassByIndex( 0 )->GetDesc( &PassDesc );
-	Device->CreateInputLayout( mVertexElts, numElts, PassDesc.pIAInputSignature, PassDesc.IAInputSignatureSize, &mVertexLayout );
+	mGeometry = Geometry::Acquire( fileName, tangents );
+	mExampleTechnique = exampleTechnique;
+	return mGeometry != NULL;
+}
 
 
-	// Create the vertex buffer and fill it with the loaded vertex data
-	mNumVertices = subMesh.numVertices;
-	D3D10_BUFFER_DESC bufferDesc;
-	bufferDesc.BindFlags = D3D10_BIND_VERTEX_BUFFER;
-	bufferDesc.Usage = D3D10_USAGE_DEFAULT; // Not a dynamic buffer
-	bufferDesc.ByteWidth = mNumVertices * mVertexSize; // Buffer size
-	bufferDesc.CPUAccessFlags = 0;   // Indicates that CPU won't access this buffer at all after creation
-	bufferDesc.MiscFlags = 0;
-	D3D10_SUBRESOURCE_DATA initData; // Initial data
-	initData.pSysMem = subMesh.vertices;   
-	if (FAILED( Device->CreateBuffer( &bufferDesc, &initData, &mVertexBuffer )))
-	{
-		return false;
-	}
+// Start loading the model geometry from a file without waiting for it. The file is imported on
+// a background thread, then UpdateLoading must be called each frame to upload the geometry to
+// the GPU a chunk at a time. Returns false if the load could not be started
+bool Model::LoadProgressive( const string& fileName, ID3D10EffectTechnique* exampleTechnique, bool tangents )
+{
+	// Release any existing geometry in this object
+	ReleaseResources();
 
+	mGeometry = Geometry::Acquire( fileName, tangents, true );
+	mExampleTechnique = exampleTechnique;
+	return mGeometry != NULL;
+}
 
-	// Create the index buffer - assuming 2-byte (WORD) index data
-	mNumIndices = static_cast<unsigned int>(subMesh.numFaces) * 3;
-	bufferDesc.BindFlags = D3D10_BIND_INDEX_BUFFER;
-	bufferDesc.Usage = D3D10_USAGE_DEFAULT;
-	bufferDesc.ByteWidth = mNumIndices * sizeof(WORD);
-	bufferDesc.CPUAccessFlags = 0;
-	bufferDesc.MiscFlags = 0;
-	initData.pSysMem = subMesh.faces;   
-	if (FAILED( Device->CreateBuffer( &bufferDesc, &initData, &mIndexBuffer )))
+// Continue a progressive load - upload up to the given number of faces (and the vertices they
+// use) if the import has finished. Returns false if the load failed
+bool Model::UpdateLoading( unsigned int maxFaces )
+{
+	if (!mGeometry)
 	{
-		return false;
+		return true;
 	}
-
-	mHasGeometry = true;
-	return true;
+	return mGeometry->UpdateLoading( maxFaces );
 }
 
 
@@ -195,27 +96,61 @@ bool Model::Load( const string& fileName, ID3D10EffectTechnique* exampleTechniqu
 // Update the world matrix of the model from its position, rotation and scaling
 void Model::UpdateMatrix()
 {
-	// Make a matrix for position and scaling, and one each for X, Y & Z rotations
-	D3DXMATRIX matrixXRot, matrixYRot, matrixZRot, matrixTranslation, matrixScaling;
-	D3DXMatrixRotationX( &matrixXRot, mRotation.x );
-	D3DXMatrixRotationY( &matrixYRot, mRotation.y );
-	D3DXMatrixRotationZ( &matrixZRot, mRotation.z );
-	D3DXMatrixTranslation( &matrixTranslation, mPosition.x, mPosition.y, mPosition.z );
-	D3DXMatrixScaling( &matrixScaling, mScale.x, mScale.y, mScale.z );
-
-	// Multiply above matrices together to get the effect of them all combined - this makes the world
-	// matrix for the rendering pipeline. Order of multiplication affects how the controls will operate
-	mWorldMatrix = matrixScaling * matrixZRot * matrixXRot * matrixYRot * matrixTranslation;
+	// The world matrix is the combination Scaling * ZRotation * XRotation * YRotation * Translation.
+	// The order affects how the controls operate. Rather than building and multiplying five matrices,
+	// the combined matrix is built directly, with one sine/cosine per rotation axis
+	mWorldMatrix.MakeAffineEuler( mPosition, mRotation, gen::kZXY, mScale );
+	mMatrixDirty = false;
+	++smMatrixUpdates;
 }
 
-// Read only access to model world matrix, created every frame from position, rotation and scale
-D3DXMATRIX Model::WorldMatrix()
+// Read only access to model world matrix, kept up to date with the position, rotation and scale
+const gen::CMatrix4x4& Model::WorldMatrix()
 {
-	// Everytime there is a request for the world matrix, it is recalculated from the current position, scale etc.
-	UpdateMatrix();
+	// The matrix is only recalculated if the position, rotation or scale has changed since it was
+	// last built, so models that do not move cost nothing however often they are rendered
+	if (mMatrixDirty)
+	{
+		UpdateMatrix();
+	}
 	return mWorldMatrix;
 }
 
+// Centre of a sphere enclosing the model in world space
+gen::CVector3 Model::BoundingCentre()
+{
+	if (!mGeometry)
+	{
+		return mPosition;
+	}
+	D3DXVECTOR3 centre = mGeometry->BoundingCentre();
+	return WorldMatrix().TransformPoint( gen::CVector3( centre.x, centre.y, centre.z ) );
+}
+
+// Radius of a sphere enclosing the model in world space. Scaling may differ on each axis, so the
+// largest is used
+float Model::BoundingRadius()
+{
+	if (!mGeometry)
+	{
+		return 0.0f;
+	}
+	float maxScale = gen::Max( gen::Abs( mScale.x ), gen::Max( gen::Abs( mScale.y ), gen::Abs( mScale.z ) ) );
+	return mGeometry->BoundingRadius() * maxScale;
+}
+
+// Average distance in texture coordinates covered by one unit of world distance across the model's
+// surface. Scaling up a model spreads its texture over a larger distance
+float Model::UVDensity()
+{
+	if (!mGeometry)
+	{
+		return 0.0f;
+	}
+	float maxScale = gen::Max( gen::Abs( mScale.x ), gen::Max( gen::Abs( mScale.y ), gen::Abs( mScale.z ) ) );
+	return maxScale > 0.0f ? mGeometry->UVDensity() / maxScale : 0.0f;
+}
+
 // Control the model's position and rotation using keys provided. Amount of motion performed depends on frame time
 void Model::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyCode turnLeft, EKeyCode turnRight,  
                       EKeyCode turnCW, EKeyCode turnCCW, EKeyCode moveForward, EKeyCode moveBackward )
@@ -223,40 +158,46 @@ void Model::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyCo
 	if (KeyHeld( turnDown ))
 	{
 		mRotation.x += kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( turnUp ))
 	{
 		mRotation.x -= kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( turnRight ))
 	{
 		mRotation.y += kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( turnLeft ))
 	{
 		mRotation.y -= kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( turnCW ))
 	{
 		mRotation.z += kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( turnCCW ))
 	{
 		mRotation.z -= kRotationSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 
-	// Local Z movement - move in the direction of the Z axis, get axis from world matrix
+	// Local Z movement - move in the direction of the Z axis, get axis from world matrix. The matrix
+	// may be a frame out of date if the model has turned, but rebuilding it here would cost a second
+	// recalculation this frame
 	if (KeyHeld( moveForward ))
 	{
-		mPosition.x += mWorldMatrix._31 * kMovementSpeed * frameTime;
-		mPosition.y += mWorldMatrix._32 * kMovementSpeed * frameTime;
-		mPosition.z += mWorldMatrix._33 * kMovementSpeed * frameTime;
+		mPosition += mWorldMatrix.ZAxis() * kMovementSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 	if (KeyHeld( moveBackward ))
 	{
-		mPosition.x -= mWorldMatrix._31 * kMovementSpeed * frameTime;
-		mPosition.y -= mWorldMatrix._32 * kMovementSpeed * frameTime;
-		mPosition.z -= mWorldMatrix._33 * kMovementSpeed * frameTime;
+		mPosition -= mWorldMatrix.ZAxis() * kMovementSpeed * frameTime;
+		mMatrixDirty = true;
 	}
 }
 
@@ -266,25 +207,9 @@ void Model::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyCo
 void Model::Render( ID3D10EffectTechnique* technique )
 {
 	// Don't render if no geometry
-	if (!mHasGeometry)
+	if (!mGeometry)
 	{
 		return;
 	}
-
-	// Select vertex and index buffer - assuming all data will be as triangle lists
-	UINT offset = 0;
-	Device->IASetVertexBuffers( 0, 1, &mVertexBuffer, &mVertexSize, &offset );
-	Device->IASetInputLayout( mVertexLayout );
-	Device->IASetIndexBuffer( mIndexBuffer, DXGI_FORMAT_R16_UINT, 0 );
-	Device->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-
-	// Render the model. Vertex buffers are prepared abovce, calling code must have prepared textures,
-	// states, shaders and shader variables.
-	D3D10_TECHNIQUE_DESC techDesc;
-	technique->GetDesc( &techDesc );
-	for( UINT p = 0; p < techDesc.Passes; ++p )
-	{
-		technique->GetPassByIndex( p )->Apply( 0 );
-		Device->DrawIndexed( mNumIndices, 0, 0 );
-	}
+	mGeometry->Render( technique, mExampleTechnique );
 }
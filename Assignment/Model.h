@@ -10,11 +10,19 @@
 #include "Input.h"
 #include <d3d10.h>
 #include <d3dx10.h>
+#include "Geometry.h"
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "AlignedAllocator.h"
 #include <string>
 using namespace std;
 
 class Model
 {
+	// The world matrix is a 16-byte aligned gen::CMatrix4x4, so models created with new must be
+	// aligned too
+	GEN_ALIGNED_NEW( 16 );
+
 //-------------------------------------
 // Private member variables
 //-------------------------------------
@@ -23,33 +31,26 @@ private:
 	// Postioning
 
 	// Positions, rotations and scaling for the model
-	D3DXVECTOR3 mPosition;
-	D3DXVECTOR3 mRotation;
-	D3DXVECTOR3 mScale;
+	gen::CVector3 mPosition;
+	gen::CVector3 mRotation;
+	gen::CVector3 mScale;
+
+	// World matrix for the model - built from the above, only when they have changed
+	gen::CMatrix4x4 mWorldMatrix;
+	bool            mMatrixDirty; // Position, rotation or scale changed since the matrix was built
 
-	// World matrix for the model - built from the above
-	D3DXMATRIX mWorldMatrix;
+	// Number of world matrix recalculations by all models, see MatrixUpdates
+	static unsigned int smMatrixUpdates;
 
 	
 	//-------------------------------------
 	// Geometry data
 
-	// Does this model have any geometry to render
-	bool                     mHasGeometry;
-
-	// Model vertices a stored in a vertex buffer and the number of the vertices in the buffer
-	ID3D10Buffer*            mVertexBuffer;
-	unsigned int             mNumVertices;
+	// The model's geometry, shared with any other models loaded from the same file with the same options
+	Geometry*                mGeometry;
 
-	// Description of the elements in a single vertex (position, normal, UVs etc.)
-	static const int         MAX_VERTEX_ELTS = 64;
-	D3D10_INPUT_ELEMENT_DESC mVertexElts[MAX_VERTEX_ELTS];
-	ID3D10InputLayout*       mVertexLayout; // Layout of a vertex (derived from above)
-	unsigned int             mVertexSize;   // Size of vertex calculated from contained elements
-
-	// Index data for the model stored in a index buffer and the number of indices in the buffer
-	ID3D10Buffer*            mIndexBuffer;
-	unsigned int             mNumIndices;
+	// Example technique given when loading, used to select the geometry's vertex layout
+	ID3D10EffectTechnique*   mExampleTechnique;
 
 
 //-------------------------------------
@@ -61,7 +62,8 @@ public:
 	// Constructors / Destructors
 
 	// Constructor - initialise all settings, sensible defaults provided for everything.
-	Model( D3DXVECTOR3 position = D3DXVECTOR3(0,0,0), D3DXVECTOR3 rotation = D3DXVECTOR3(0,0,0), float scale = 1 );
+	Model( const gen::CVector3& position = gen::CVector3::kOrigin, const gen::CVector3& rotation = gen::CVector3::kZero,
+	       float scale = 1 );
 
 	// Destructor
 	~Model();
@@ -74,17 +76,32 @@ public:
 	// Data access
 
 	// Getters / setters for data we want to expose
-	D3DXVECTOR3 Position()  { return mPosition; }
-	D3DXVECTOR3 Rotation()  { return mRotation; }
-	D3DXVECTOR3 Scale()     { return mScale;    }
-	void SetPosition( D3DXVECTOR3 position )  { mPosition = position; }
-	void SetRotation( D3DXVECTOR3 rotation )  { mRotation = rotation; }
+	gen::CVector3 Position()  { return mPosition; }
+	gen::CVector3 Rotation()  { return mRotation; }
+	gen::CVector3 Scale()     { return mScale;    }
+	void SetPosition( const gen::CVector3& position )  { mPosition = position;  mMatrixDirty = true; }
+	void SetRotation( const gen::CVector3& rotation )  { mRotation = rotation;  mMatrixDirty = true; }
 	// Two ways to set scale: x,y,z separately, or all to the same value
-	void SetScale   ( D3DXVECTOR3 scale    )  { mScale = scale;       } 
-	void SetScale   ( float scale          )  { mScale = D3DXVECTOR3( scale, scale, scale );}
+	void SetScale   ( const gen::CVector3& scale    )  { mScale = scale;  mMatrixDirty = true; }
+	void SetScale   ( float scale                   )  { mScale = gen::CVector3( scale, scale, scale );  mMatrixDirty = true; }
+
+	// Read only access to model world matrix. It is rebuilt from position, rotation and scale only
+	// when one of them has changed, so at most once per frame for a model moved during the update
+	const gen::CMatrix4x4& WorldMatrix();
 
-	// Read only access to model world matrix, created every frame from position, rotation and scale
-	D3DXMATRIX WorldMatrix();
+	// Number of world matrix recalculations by all models since the last ResetMatrixUpdates. Reset
+	// at the start of each frame to get the number of recalculations per frame
+	static unsigned int MatrixUpdates()  { return smMatrixUpdates; }
+	static void ResetMatrixUpdates()     { smMatrixUpdates = 0; }
+
+	// Centre and radius of a sphere enclosing the model in world space, from its geometry's bounds
+	// and the world matrix. The radius is 0 if the geometry has not loaded yet
+	gen::CVector3 BoundingCentre();
+	float BoundingRadius();
+
+	// Average distance in texture coordinates covered by one unit of world distance across the
+	// model's surface, i.e. the geometry's UV density allowing for the model's scale. 0 if unknown
+	float UVDensity();
 
 	//-------------------------------------
 	// Model Loading
@@ -93,14 +110,31 @@ public:
 	// material in the file, so multi-material models will load but will have parts missing. May 
 	// optionally request for tangents to be created for the model (for normal or parallax mapping)
 	// We need to pass an example technique that the model will use to help DirectX understand how 
-	// to connect this data with the vertex shaders. Returns true if the load was successful
+	// to connect this data with the vertex shaders. If another model has already loaded the same
+	// file with the same options its geometry is shared. Returns true if the load was successful
 	bool Load( const string& fileName, ID3D10EffectTechnique* shaderCode, bool tangents = false );
 
+	// Start loading the model geometry from a file without waiting for it. The file is imported on
+	// a background thread, then UpdateLoading must be called each frame to upload the geometry to
+	// the GPU a chunk at a time. The model renders whatever part of its geometry has been uploaded
+	// so far, so a large model appears progressively rather than stalling startup. Parameters as
+	// for Load. Returns false if the load could not be started
+	bool LoadProgressive( const string& fileName, ID3D10EffectTechnique* exampleTechnique, bool tangents = false );
+
+	// Continue a progressive load - upload up to the given number of faces (and the vertices they
+	// use) if the import has finished. Returns false if the load failed, does nothing if the model
+	// is not loading progressively
+	bool UpdateLoading( unsigned int maxFaces = 8192 );
+
+	// Is a progressive load still in progress (i.e. not all geometry is being rendered yet)
+	bool IsLoading()  { return mGeometry && mGeometry->IsLoading(); }
+
 
 	//-------------------------------------
 	// Model Usage
 
-	// Update the world matrix of the model from its position, rotation and scaling
+	// Update the world matrix of the model from its position, rotation and scaling now, whether or
+	// not they have changed. WorldMatrix does this automatically when needed
 	void UpdateMatrix();
 	
 	// Control the model's position and rotation using keys provided. Amount of motion performed depends on frame time
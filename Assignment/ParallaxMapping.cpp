@@ -5,34 +5,60 @@
 #include "Scene.h"
 #include "Device.h"
 #include "Model.h"
+#include "EntityStore.h"
+#include "SceneFile.h"
 #include "Camera.h"
+#include "Intersection.h"
 #include "Shader.h"
+#include "Texture.h"
+#include "TextureManager.h"
+#include "ImageMips.h"
 #include "Input.h"  // Input functions - not DirectX
 #include "Colour\ColourConversions.h"  // my hsl and rbs conversions
+#include <algorithm>
+#include <memory>
 
-enum ELightType { point, directional, spot };
-enum EID3D10EffectTechnique { Parallax, VertexLit, AdditiveTintTex, VertexAdditive };
-
+// Light component
 struct Light {
 	ELightType type;
 	D3DXVECTOR3 colour;
 	float power;
-	D3DXVECTOR3 vector;
-	Model* model;
+	D3DXVECTOR3 vector; // Direction of directional and spot lights
+	float angle;        // Spot light cone angle, radians
+};
+
+// Light animation component - changes the colour of a light over time
+struct SLightAnimation {
+	ESceneLightAnimation type;
+	D3DXVECTOR3 baseColour; // Colour at the peak of a pulse
+	float rate;             // Speed of a pulse, or hue change per second of a hue cycle
+	float time;
+	float HSL[3];           // Current colour of a hue cycle
+};
+
+// Orbit component - moves an entity in a circle around another, in the XZ plane
+struct SOrbit {
+	EntityHandle centre;
+	float radius;
+	float speed; // Radians per second
+	float angle;
 };
 
-struct SModel {
-	string fileName;
+// Renderable component - the geometry of an entity and how to render it
+struct SRenderable {
+	Geometry* geometry;                      // Shared with any other entities loaded from the same file with the same options
+	ID3D10EffectTechnique* technique;        // Technique to render with
+	ID3D10EffectTechnique* exampleTechnique; // Technique given when loading, selects the geometry's vertex layout
 	EID3D10EffectTechnique Etechnique;
-	bool tangents;
-	LPCWSTR DiffuseMapName;
-	LPCWSTR NormalMapName;
+	int DiffuseTexture; // Textures in the texture manager, -1 if none
+	int NormalTexture;  // Normal/depth texture, normal x and y with z rebuilt in the shader and depth for parallax mapping
 	D3DXVECTOR3 tintColour;
 	bool effectsAlways;
-	ID3D10ShaderResourceView* DiffuseMap;
-	ID3D10ShaderResourceView* NormalMap;
-	ID3D10EffectTechnique* technique;
-	Model* model;
+};
+
+// Controller component - keys to turn and move an entity with
+struct SController {
+	EKeyCode turnUp, turnDown, turnLeft, turnRight, turnCW, turnCCW, moveForward, moveBackward;
 };
 
 //--------------------------------------------------------------------------------------
@@ -43,7 +69,6 @@ struct SModel {
 const float kRotationSpeed = 2.0f;  // 4 radians per second for rotation
 const float kMovementSpeed = 50.0f; // 10 units per second for movement (what a unit of length is depends on 3D model - i.e. an artist decision usually)
 const float kScaleSpeed    = 2.0f;  // 2x or 1/2x scaling each second - this is used as a multiplier/divider
-float Pulse;                        // pulsating light value
 float Mover;                        // mover value
 float Wiggle;                       // wiggle value
 bool UseMover = false; // invert mover on object
@@ -54,20 +79,24 @@ float WigglePower = 0.1f;    // power of the wiggle effect
 
 //-------------------------------------
 
-// Models and cameras. Now encapsulated in classes for flexibity and convenience
-// The CModel class collects together geometry and world matrix, and provides functions to control the model and render it
+// The scene's models, materials, lights, cameras and portal are read from a scene file (see InitScene), and kept for
+// the sets of control keys they refer to
+SceneDescription Scene;
+
+// Entities and cameras. The models and lights are entities: handles to components held in dense arrays, so the
+// update and render loops below run through contiguous memory however many objects the scene has
+// The EntityStore holds each entity's transform (position, rotation, scale and world matrix), the pools hold the others
 // The CCamera class handles the view and projections matrice, and provides functions to control the camera
-const int MODEL_COUNT = 6;
-SModel ModelArr[MODEL_COUNT] = {
-	{ "Cube.x",   Parallax,       true,  L"TechDiffuseSpecular.dds",    L"TechNormalDepth.dds",    D3DXVECTOR3(),                         false, NULL, NULL },
-	{ "Cube.x",   VertexLit,      true,  L"StoneDiffuseSpecular.dds",    L"",                      D3DXVECTOR3(),                         false, NULL, NULL },
-	{ "Decal.x",  VertexAdditive, false, L"Moogle.png",                 L"",                       D3DXVECTOR3(1,1,1) * 10,               false, NULL, NULL },
-	{ "Teapot.x", Parallax,       true,  L"PatternDiffuseSpecular.dds", L"PatternNormalDepth.dds", D3DXVECTOR3(),                         false, NULL, NULL },
-	{ "Sphere.x", Parallax,       true,  L"BrainDiffuseSpecular.dds",   L"BrainNormalDepth.dds",   D3DXVECTOR3(1.0f, 0.41f, 0.7f) * 0.3f, true,  NULL, NULL },
-	{ "Hills.x",  Parallax,       true,  L"CobbleDiffuseSpecular.dds",  L"CobbleNormalDepth.dds",  D3DXVECTOR3(),                         false, NULL, NULL },
-};
+EntityStore                    Entities;
+ComponentPool<SRenderable>     Renderables; // Kept in draw order, see InitScene
+ComponentPool<Light>           Lights;
+ComponentPool<SLightAnimation> LightAnimations;
+ComponentPool<SOrbit>          Orbits;      // In scene order, so a model orbiting a moving model follows its new position
+ComponentPool<SController>     Controllers;
+vector<Geometry*>              SceneGeometries; // Each different geometry of the renderables once (they hold the references)
 
 Camera* MainCamera;
+int     MainCameraControls = kNoSceneObject; // Controls in the scene description
 
 //**** Portal Data ****//
 
@@ -78,8 +107,10 @@ Camera* MainCamera;
 int PortalWidth = 1024;
 int PortalHeight = 1024;
 
-Model*  Portal;       // The model on which the portal appears
-Camera* PortalCamera; // The camera view shown in the portal
+Model*  Portal = NULL;       // The model on which the portal appears, NULL if the scene has no portal
+Camera* PortalCamera = NULL; // The camera view shown in the portal
+int     PortalControls = kNoSceneObject;
+int     PortalCameraControls = kNoSceneObject;
 
 					  // The portal texture and the view of it as a render target (see code comments)
 ID3D10Texture2D*          PortalTexture = NULL;
@@ -93,7 +124,10 @@ ID3D10DepthStencilView* PortalDepthStencilView = NULL;
 
 //*********************//
 
-// Textures - including normal maps
+// Textures - including normal maps. Model textures are kept within a memory budget by the texture manager, which
+// streams in the detail needed for the size they appear on screen
+const size_t TEXTURE_BUDGET = 8 * 1024 * 1024;
+TextureManager* Textures = NULL;
 
 ID3D10ShaderResourceView* LightDiffuseMap  = NULL;
 float ParallaxDepth = 0.08f; // Overall depth of bumpiness for parallax mapping
@@ -101,31 +135,32 @@ bool UseParallax    = true;  // Toggle for parallax
 
 //-------------------------------------
 
-// Light data still stored manually, a light class would be helpful - but it's an assignment task!
+// Background and ambient colours, from the scene description
 D3DXVECTOR4 BackgroundColour = D3DXVECTOR4(0.2f, 0.2f, 0.3f, 1.0f);
 D3DXVECTOR3 AmbientColour = D3DXVECTOR3( 0.2f, 0.2f, 0.3f );
 
-const int LIGHT_COUNT = 4;
-Light LightArr[LIGHT_COUNT] = {
-	{ point, D3DXVECTOR3(0.8f, 0.8f, 1.0f), 20 },
-	{ point, D3DXVECTOR3(1.0f, 0.8f, 0.2f), 30 },
-	{ directional, D3DXVECTOR3(0, 0, 1.0f), 0.1f, D3DXVECTOR3(0, 1, 0) },
-	{ spot, D3DXVECTOR3(1, 1, 1), 50, D3DXVECTOR3(0, 0.707107f, -0.707107f) }
-};
-
-D3DXVECTOR3 PulseDefault = LightArr[1].colour;
+// Lights in the scene are entities with a transform and light component. The shaders have a fixed set of lights: two
+// point lights, a directional light and a spot light. These are the first lights of each type in the scene, kNoEntity
+// for any the scene does not have
+EntityHandle Light1Entity           = kNoEntity;
+EntityHandle Light2Entity           = kNoEntity;
+EntityHandle DirectionalLightEntity = kNoEntity;
+EntityHandle SpotLightEntity        = kNoEntity;
+Geometry*    LightGeometry = NULL; // All lights are displayed with the same model
 
-float SpotLightAngle = 0.52f; // aprox 30 degrees - 29.79381
 float SpecularPower = 256.0f;
 
-// Light 1 colour to HSL
-// used to rotate colours
-float HSL[3];
-float ColourRotateRate = 1000.0f;
+//-------------------------------------
+
+// World space bounding spheres of everything rendered: the renderables in draw order, then the light models, then the
+// portal. Rebuilt once a frame after the entities move, then culled against the frustum of each camera in turn
+vector<gen::SSphere> BoundingSpheres;
+unique_ptr<bool[]>   SphereVisible; // Visibility of each sphere to the camera being rendered (see RenderModels)
+size_t               SphereVisibleSize = 0;
 
-// Display models where the lights are. One of the lights will follow an orbit
-const float LightOrbitRadius = 20.0f;
-const float LightOrbitSpeed  = 0.7f;
+// Number of objects culled by each rendering pass in the last frame
+unsigned int PortalPassCulled = 0;
+unsigned int MainPassCulled = 0;
 
 //-------------------------------------
 
@@ -133,67 +168,197 @@ const float LightOrbitSpeed  = 0.7f;
 inline float ToRadians( float deg ) { return deg * (float)D3DX_PI / 180.0f; }
 inline float ToDegrees( float rad ) { return rad * 180.0f / (float)D3DX_PI; }
 
+// Scene descriptions use gen maths vectors, the shaders take D3DX vectors
+inline D3DXVECTOR3 ToD3DX( const gen::CVector3& v ) { return D3DXVECTOR3(v.x, v.y, v.z); }
+
 
 //--------------------------------------------------------------------------------------
 // Scene Setup / Update / Rendering
 //--------------------------------------------------------------------------------------
 
+// Create a camera from its scene description
+Camera* CreateCamera(const SSceneCamera& sceneCamera)
+{
+	Camera* camera = new Camera();
+	camera->SetPosition(sceneCamera.position);
+	camera->SetRotation(sceneCamera.rotation);
+	camera->SetFOV(sceneCamera.fov);
+	camera->SetNearClip(sceneCamera.nearClip);
+	camera->SetFarClip(sceneCamera.farClip);
+	return camera;
+}
+
+// Keys of one of the scene's sets of controls
+SController SceneController(int controls)
+{
+	const unsigned int* keys = Scene.controls[controls].keys;
+	SController controller = { static_cast<EKeyCode>(keys[0]), static_cast<EKeyCode>(keys[1]), static_cast<EKeyCode>(keys[2]),
+	                           static_cast<EKeyCode>(keys[3]), static_cast<EKeyCode>(keys[4]), static_cast<EKeyCode>(keys[5]),
+	                           static_cast<EKeyCode>(keys[6]), static_cast<EKeyCode>(keys[7]) };
+	return controller;
+}
+
+// Orbit component for an entity at the given position following one of the scene's orbits, starting from that position
+SOrbit SceneOrbit(int index, const gen::CVector3& position, const vector<EntityHandle>& modelEntities)
+{
+	const SSceneOrbit& sceneOrbit = Scene.orbits[index];
+	gen::CVector3 offset = position - Scene.models[sceneOrbit.centre].position;
+	SOrbit orbit = { modelEntities[sceneOrbit.centre], sceneOrbit.radius, sceneOrbit.speed, atan2(offset.z, offset.x) };
+	return orbit;
+}
+
 // Create / load the camera, models and textures for the scene
 bool InitScene()
 {
 	//---------------------------
-	// Create camera
+	// Load the scene description
 
-	MainCamera = new Camera();
-	MainCamera->SetPosition( D3DXVECTOR3(40, 30, -90) );
-	MainCamera->SetRotation( D3DXVECTOR3(ToRadians(8.0f), ToRadians(-18.0f), 0.0f) ); // ToRadians is a new helper function to convert degrees to radians
+	// The scene is described in a text file, which is compiled to a binary form the first time it is loaded so later runs
+	// read the whole scene in one go (see SceneFile.h). Edit the text file to change the scene without recompiling
+	string error;
+	if (!LoadScene("ParallaxMapping.scene", "ParallaxMapping.sceneb", &Scene, &error))
+	{
+		wstring message(error.begin(), error.end());
+		MessageBox(NULL, message.c_str(), L"Error loading scene", MB_OK);
+		return false;
+	}
+	BackgroundColour = D3DXVECTOR4(Scene.backgroundColour.x, Scene.backgroundColour.y, Scene.backgroundColour.z, 1.0f);
+	AmbientColour = ToD3DX(Scene.ambientColour);
+
+
+	//---------------------------
+	// Create cameras
+
+	// The first camera in the scene is the main view
+	MainCamera = CreateCamera(Scene.cameras[0]);
+	MainCameraControls = Scene.cameras[0].controls;
 
 	//**** Portal camera is the view shown in the portal object's texture ****//
-	PortalCamera = new Camera();
-	PortalCamera->SetPosition(D3DXVECTOR3(45, 45, 85));
-	PortalCamera->SetRotation(D3DXVECTOR3(ToRadians(20.0f), ToRadians(215.0f), 0.));
+	// Only one portal is supported, any others in the scene are ignored
+	if (!Scene.portals.empty())
+	{
+		const SSceneCamera& portalCamera = Scene.cameras[Scene.portals[0].camera];
+		PortalCamera = CreateCamera(portalCamera);
+		PortalCameraControls = portalCamera.controls;
+	}
+
 
 	//---------------------------
 	// Load/Create models
 
-	Portal    = new Model;
-
 	// Load the model's geometry from ".X" files
-	// The third parameter is set to true on the first 2 lines below. This asks the import code to generate
-	// tangents for those models being loaded. Tangents are required for normal mapping and parallax mapping
+	// Models marked with "tangents" in the scene ask the import code to generate tangents for those models being loaded.
+	// Tangents are required for normal mapping and parallax mapping
 	// A tangent is rather like a "second normal" for a vertex, but one that is parallel to the model surface
 	// (in the direction of the texture U axis). However, whilst artists will provide normals with their
 	// models, they won't provide tangents. They must be calculated by looking at the geometry and UVs. The
 	// process is done in the import code, but the detail is beyond the scope of this lab exercise
 	//
+	// Geometry is shared between entities loaded from the same file with the same options. Each different geometry is
+	// acquired once - file names are stored once in the scene so the name's offset identifies the file. All geometry is
+	// imported in parallel on background threads while the textures load below, and models that are not shown
+	// progressively are completed before the first frame
 	bool success = true;
-	for (int i = 0; i < MODEL_COUNT; i++)
+	vector<Geometry*> sceneGeometry(Scene.strings.size() * 2, NULL); // Indexed by file name offset * 2 + tangents
+	vector<EntityHandle> modelEntities(Scene.models.size());
+	Entities.Reserve(static_cast<unsigned int>(Scene.models.size() + Scene.lights.size()));
+
+	// Each material's textures are added to the texture manager once, and shared by all the models using the material
+	Textures = new TextureManager(TEXTURE_BUDGET);
+	vector<int> diffuseTextures(Scene.materials.size(), -1);
+	vector<int> normalTextures(Scene.materials.size(), -1);
+	for (unsigned int i = 0; i < Scene.materials.size(); i++)
 	{
-		if (ModelArr[i].Etechnique == Parallax)
-			ModelArr[i].technique = ParallaxMappingTechnique;
-		else if (ModelArr[i].Etechnique == VertexLit || ModelArr[i].Etechnique == VertexAdditive)
-			ModelArr[i].technique = VertexLitTexTechnique;
-		else if (ModelArr[i].Etechnique == AdditiveTintTex)
-			ModelArr[i].technique = AdditiveTintTexTechnique;
-
-		ModelArr[i].model = new Model;
-		if (!ModelArr[i].model->Load(ModelArr[i].fileName, ModelArr[i].technique, ModelArr[i].tangents))  success = false;
-
-		if (ModelArr[i].Etechnique == VertexAdditive)
-			ModelArr[i].technique = AdditiveTintTexTechnique;
+		const SSceneMaterial& material = Scene.materials[i];
+		if (material.diffuseMap != kNoSceneString)
+			diffuseTextures[i] = Textures->Add(Scene.String(material.diffuseMap), TextureManager::DiffuseSpecular);
+		if (material.normalMap != kNoSceneString)
+			normalTextures[i] = Textures->Add(Scene.String(material.normalMap), TextureManager::NormalDepth);
 	}
-	if (!Portal->   Load( "Portal.x", VertexLitTexTechnique                 ))  success = false;
-	if (!success)
+
+	for (unsigned int i = 0; i < Scene.models.size(); i++)
 	{
-		MessageBox(NULL, L"Error loading model files. Ensure your files are correctly named and in the same folder as this executable.", L"Error", MB_OK);
-		return false;
+		const SSceneModel& model = Scene.models[i];
+		const SSceneMaterial* material = model.material != kNoSceneObject ? &Scene.materials[model.material] : NULL;
+		EID3D10EffectTechnique technique = material ? static_cast<EID3D10EffectTechnique>(material->technique) : VertexLit;
+
+		SRenderable renderable = {};
+		if (technique == Parallax)
+			renderable.exampleTechnique = ParallaxMappingTechnique;
+		else if (technique == VertexLit || technique == VertexAdditive)
+			renderable.exampleTechnique = VertexLitTexTechnique;
+		else if (technique == AdditiveTintTex)
+			renderable.exampleTechnique = AdditiveTintTexTechnique;
+
+		bool tangents = (model.flags & kSceneModelTangents) != 0;
+		Geometry*& geometry = sceneGeometry[model.geometry * 2 + (tangents ? 1 : 0)];
+		if (geometry)
+			geometry->AddRef();
+		else
+		{
+			geometry = Geometry::Acquire(Scene.String(model.geometry), tangents, true);
+			SceneGeometries.push_back(geometry);
+		}
+		renderable.geometry = geometry;
+
+		if (technique == VertexAdditive)
+			renderable.technique = AdditiveTintTexTechnique;
+		else
+			renderable.technique = renderable.exampleTechnique;
+		renderable.Etechnique = technique;
+		renderable.DiffuseTexture = material ? diffuseTextures[model.material] : -1;
+		renderable.NormalTexture = material ? normalTextures[model.material] : -1;
+		renderable.tintColour = material ? ToD3DX(material->tintColour) : D3DXVECTOR3(1, 1, 1);
+		renderable.effectsAlways = material && material->effectsAlways;
+
+		EntityHandle entity = Entities.Create(model.position, model.rotation);
+		Entities.SetScale(entity, model.scale);
+		Renderables.Add(entity, renderable);
+		if (model.controls != kNoSceneObject)  Controllers.Add(entity, SceneController(model.controls));
+		if (model.orbit != kNoSceneObject)  Orbits.Add(entity, SceneOrbit(model.orbit, model.position, modelEntities));
+		modelEntities[i] = entity;
 	}
 
 	// lights
-	for (int i = 0; i < LIGHT_COUNT; i++)
+	if (Scene.lightGeometry != kNoSceneString)
+		LightGeometry = Geometry::Acquire(Scene.String(Scene.lightGeometry), false, true);
+	for (unsigned int i = 0; i < Scene.lights.size(); i++)
 	{
-		LightArr[i].model = new Model;
-		if (!LightArr[i].model->Load("Light.x", AdditiveTintTexTechnique))  success = false;
+		const SSceneLight& sceneLight = Scene.lights[i];
+		Light light = { static_cast<ELightType>(sceneLight.type), ToD3DX(sceneLight.colour), sceneLight.power,
+		                ToD3DX(sceneLight.direction), sceneLight.angle };
+		EntityHandle entity = Entities.Create(sceneLight.position, gen::CVector3::kZero, sceneLight.scale);
+		Lights.Add(entity, light);
+
+		// Pulsing lights fade from their colour to black and back, hue cycling lights rotate the hue of their colour
+		if (sceneLight.animation != kSceneLightStill)
+		{
+			SLightAnimation animation = { static_cast<ESceneLightAnimation>(sceneLight.animation), light.colour, sceneLight.animationRate, 0.0f };
+			RGBToHSL(light.colour.x, light.colour.y, light.colour.z, animation.HSL[0], animation.HSL[1], animation.HSL[2]);
+			LightAnimations.Add(entity, animation);
+		}
+		if (sceneLight.orbit != kNoSceneObject)  Orbits.Add(entity, SceneOrbit(sceneLight.orbit, sceneLight.position, modelEntities));
+
+		// The first lights of each type are sent to the shaders
+		if (light.type == point && Light1Entity == kNoEntity)                  Light1Entity = entity;
+		else if (light.type == point && Light2Entity == kNoEntity)             Light2Entity = entity;
+		else if (light.type == directional && DirectionalLightEntity == kNoEntity)  DirectionalLightEntity = entity;
+		else if (light.type == spot && SpotLightEntity == kNoEntity)           SpotLightEntity = entity;
+	}
+
+	// Build the initial world matrices, after this they are only rebuilt when entities move (see UpdateScene)
+	Entities.UpdateWorldMatrices();
+
+	if (PortalCamera)
+	{
+		const SScenePortal& scenePortal = Scene.portals[0];
+		Portal = new Model;
+		if (!Portal->Load(Scene.String(scenePortal.geometry), VertexLitTexTechnique))  success = false;
+		Portal->SetPosition(scenePortal.position);
+		Portal->SetRotation(scenePortal.rotation);
+		PortalWidth = scenePortal.width;
+		PortalHeight = scenePortal.height;
+		PortalControls = scenePortal.controls;
 	}
 	if (!success)
 	{
@@ -201,28 +366,6 @@ bool InitScene()
 		return false;
 	}
 
-	// Initial model positions
-	ModelArr[0].model->SetPosition( D3DXVECTOR3( 10, 15, -40) );
-	ModelArr[1].model->SetPosition( D3DXVECTOR3( 10, 15, -80) );
-	ModelArr[2].model->SetPosition(ModelArr[1].model->Position() + D3DXVECTOR3(0, 0, -0.1f));
-	ModelArr[3].model->SetPosition( D3DXVECTOR3( 40, 10,  10) );
-	ModelArr[4].model->SetPosition( D3DXVECTOR3(  0, 20,  10) );
-
-	LightArr[0].model->SetPosition( D3DXVECTOR3( 30, 15, -40) );
-	LightArr[0].model->SetScale( 5.0f );
-	LightArr[1].model->SetPosition( D3DXVECTOR3( 20, 40, -20) );
-	LightArr[1].model->SetScale( 12.0f );
-	LightArr[3].model->SetPosition( D3DXVECTOR3(60, 20, -60));
-	LightArr[3].model->SetScale( 12.0f );
-
-	Portal->SetPosition(D3DXVECTOR3(40, 20, 40));
-	Portal->SetRotation(D3DXVECTOR3(0.0f, ToRadians(-130.0f), 0.0f));
-
-	// Setup Light1's colour
-	// Light 1 colour to HSL
-	// used to rotate colours
-	RGBToHSL(LightArr[0].colour.x, LightArr[0].colour.y, LightArr[0].colour.z, HSL[0], HSL[1], HSL[2]);
-
 
 	//---------------------------
 	// Load textures
@@ -235,22 +378,55 @@ bool InitScene()
 	// the flat plane of the surface geometry. This depth is held in the alpha channel of the normal map (in
 	// a similar way that the specular map is held in the alpha channel of the diffuse map)
 	//*******************************************************************************************************//
-	for (int i = 0; i < MODEL_COUNT; i++)
+	// Model textures are loaded by the texture manager, which decodes the files in parallel. Diffuse/specular maps
+	// are block compressed to BC3 (or BC1 if they have no specular), and normal/depth maps are split into a BC5
+	// normal map and BC4 depth map, together less than half the size of the original. Textures start with as much
+	// detail as fits in the budget, after that the detail follows the size they are seen on screen
+	if (!Textures->LoadAll())  success = false;
+
+	// The shaders sample texture arrays, so the light texture is an array of one
+	if (Scene.lightMap != kNoSceneString)
 	{
-		if (ModelArr[i].DiffuseMapName != L"")
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(Device, ModelArr[i].DiffuseMapName, NULL, NULL, &ModelArr[i].DiffuseMap, NULL)))  success = false;
-		if (ModelArr[i].NormalMapName != L"")
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(Device, ModelArr[i].NormalMapName, NULL, NULL, &ModelArr[i].NormalMap, NULL)))  success = false;
+		Image flareImage;
+		if (!LoadImageFile(Scene.String(Scene.lightMap), &flareImage) || !GenerateMips(&flareImage, MipFilterKaiser, MipContentColour) ||
+		    !CreateTextureArray(vector<const Image*>(1, &flareImage), &LightDiffuseMap))  success = false;
 	}
-	if (FAILED( D3DX10CreateShaderResourceViewFromFile( Device, L"flare.jpg",                  NULL, NULL, &LightDiffuseMap,  NULL ) ))  success = false;
 	if (!success)
 	{
 		MessageBox(NULL, L"Error loading texture files. Ensure your files are correctly named and in the same folder as this executable.", L"Error", MB_OK);
 		return false;
 	}
 
+	// The geometry has been importing while the textures loaded, wait for any models not shown progressively
+	for (unsigned int i = 0; i < Scene.models.size(); i++)
+	{
+		Geometry* geometry = Renderables.Get(modelEntities[i])->geometry;
+		if (!(Scene.models[i].flags & kSceneModelProgressive) && !geometry->FinishLoading())  success = false;
+	}
+	if (LightGeometry && !LightGeometry->FinishLoading())  success = false;
+	if (!success)
+	{
+		MessageBox(NULL, L"Error loading model files. Ensure your files are correctly named and in the same folder as this executable.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Put the renderables in draw order: opaque models grouped by technique then texture arrays, so consecutive models
+	// share their textures and could be batched. Additive models come last, they don't write depth so must be drawn over
+	// the opaque models. The pool is sorted in place so rendering runs straight through it
+	Renderables.Sort([](const SRenderable& a, const SRenderable& b)
+	{
+		bool additiveA = a.Etechnique == VertexAdditive, additiveB = b.Etechnique == VertexAdditive;
+		if (additiveA || additiveB)  return !additiveA && additiveB;
+		if (a.Etechnique != b.Etechnique)  return a.Etechnique < b.Etechnique;
+		if (Textures->Array(a.DiffuseTexture) != Textures->Array(b.DiffuseTexture))
+			return Textures->Array(a.DiffuseTexture) < Textures->Array(b.DiffuseTexture);
+		return Textures->Array(a.NormalTexture) < Textures->Array(b.NormalTexture);
+	});
+
 	//**** Portal Texture ****//
 
+	if (!Portal)  return true; // The scene has no portal
+
 	//*** As noted with the portal variables, some/all of this code might better be in device.cpp, but showing all new code in this file
 
 	// Create the portal texture itself, above we used a D3DX... helper function to create a texture in one line. Here, we need to do things manually
@@ -276,9 +452,11 @@ bool InitScene()
 	// We also need to send this texture (resource) to the shaders. To do that we must create a shader-resource "view"
 	D3D10_SHADER_RESOURCE_VIEW_DESC srDesc;
 	srDesc.Format = portalDesc.Format;
-	srDesc.ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2D;
-	srDesc.Texture2D.MostDetailedMip = 0;
-	srDesc.Texture2D.MipLevels = 1;
+	srDesc.ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2DARRAY; // The shaders sample texture arrays, this is an array of one
+	srDesc.Texture2DArray.MostDetailedMip = 0;
+	srDesc.Texture2DArray.MipLevels = 1;
+	srDesc.Texture2DArray.FirstArraySlice = 0;
+	srDesc.Texture2DArray.ArraySize = 1;
 	if (FAILED(Device->CreateShaderResourceView(PortalTexture, &srDesc, &PortalMap))) return false;
 
 
@@ -317,15 +495,23 @@ bool InitScene()
 //--------------------------------------------------------------------------------------
 void ReleaseScene()
 {
-	for (int i = 0; i < LIGHT_COUNT; i++)
-	{
-		delete LightArr[i].model;  LightArr[i].model = NULL;
-	}
-
-	for (int i = 0; i < MODEL_COUNT; i++)
+	// Stop using the entities' geometry, each is released when no entities are using it
+	for (unsigned int i = 0; i < Renderables.Size(); i++)
 	{
-		delete ModelArr[i].model;  ModelArr[i].model = NULL;
+		if (Renderables[i].geometry)  Renderables[i].geometry->Release();
 	}
+	SceneGeometries.clear();
+	if (LightGeometry)  LightGeometry->Release();
+	LightGeometry = NULL;
+
+	Controllers.Clear();
+	Orbits.Clear();
+	LightAnimations.Clear();
+	Lights.Clear();
+	Renderables.Clear();
+	Entities.Clear();
+	Light1Entity = Light2Entity = DirectionalLightEntity = SpotLightEntity = kNoEntity;
+	Scene = SceneDescription();
 
 	delete Portal;        Portal = NULL;
 	delete PortalCamera;  PortalCamera = NULL;
@@ -338,41 +524,171 @@ void ReleaseScene()
 	if (PortalTexture)           PortalTexture->Release();
 
     if (LightDiffuseMap)  LightDiffuseMap->Release();
-	for (int i = 0; i < MODEL_COUNT; i++)
-	{
-		if (ModelArr[i].NormalMap)  ModelArr[i].NormalMap->Release();
-		if (ModelArr[i].DiffuseMap) ModelArr[i].DiffuseMap->Release();
-	}
+	delete Textures;  Textures = NULL;
 }
 
 //--------------------------------------------------------------------------------------
 // Update scene every frame
 //--------------------------------------------------------------------------------------
 
+// Controller system - turn and move each entity that has a controller using its keys. Amount of motion performed
+// depends on frame time. Only entities that actually move have their world matrix rebuilt
+void UpdateControllers( float frameTime )
+{
+	for (unsigned int i = 0; i < Controllers.Size(); i++)
+	{
+		const SController& keys = Controllers[i];
+		EntityHandle entity = Controllers.Owner(i);
+
+		gen::CVector3 rotation = Entities.Rotation(entity);
+		bool turned = false;
+		if (KeyHeld( keys.turnDown ))   { rotation.x += kRotationSpeed * frameTime;  turned = true; }
+		if (KeyHeld( keys.turnUp ))     { rotation.x -= kRotationSpeed * frameTime;  turned = true; }
+		if (KeyHeld( keys.turnRight ))  { rotation.y += kRotationSpeed * frameTime;  turned = true; }
+		if (KeyHeld( keys.turnLeft ))   { rotation.y -= kRotationSpeed * frameTime;  turned = true; }
+		if (KeyHeld( keys.turnCW ))     { rotation.z += kRotationSpeed * frameTime;  turned = true; }
+		if (KeyHeld( keys.turnCCW ))    { rotation.z -= kRotationSpeed * frameTime;  turned = true; }
+		if (turned)  Entities.SetRotation(entity, rotation);
+
+		// Local Z movement - move in the direction of the Z axis of the world matrix, which is a frame out of date if the
+		// entity has turned (as for the Model class)
+		gen::CVector3 zAxis = Entities.WorldMatrix(entity).ZAxis();
+		if (KeyHeld( keys.moveForward ))   Entities.SetPosition(entity, Entities.Position(entity) + zAxis * kMovementSpeed * frameTime);
+		if (KeyHeld( keys.moveBackward ))  Entities.SetPosition(entity, Entities.Position(entity) - zAxis * kMovementSpeed * frameTime);
+	}
+}
+
+// Orbit system - move each entity with an orbit around its centre entity. Orbits are in scene order, and models only
+// orbit models before them in the scene, so each centre has already moved this frame
+void UpdateOrbits( float frameTime )
+{
+	for (unsigned int i = 0; i < Orbits.Size(); i++)
+	{
+		SOrbit& orbit = Orbits[i];
+		if (!Entities.IsValid(orbit.centre))  continue;
+		Entities.SetPosition(Orbits.Owner(i), Entities.Position(orbit.centre) +
+		                     gen::CVector3(cos(orbit.angle) * orbit.radius, 0, sin(orbit.angle) * orbit.radius));
+		orbit.angle -= orbit.speed * frameTime;
+	}
+}
+
+// Light animation system - pulse or cycle the hue of light colours
+void UpdateLightAnimations( float frameTime )
+{
+	for (unsigned int i = 0; i < LightAnimations.Size(); i++)
+	{
+		SLightAnimation& animation = LightAnimations[i];
+		Light* light = Lights.Get(LightAnimations.Owner(i));
+		if (!light)  continue;
+		if (animation.type == kSceneLightPulse)
+		{
+			animation.time += frameTime * animation.rate;
+			light->colour = animation.baseColour * abs(sin(animation.time));
+		}
+		else if (animation.type == kSceneLightHueCycle)
+		{
+			animation.HSL[0] += frameTime * animation.rate;
+			HSLToRGB(animation.HSL[0], animation.HSL[1], animation.HSL[2], light->colour.x, light->colour.y, light->colour.z);
+		}
+	}
+}
+
+// Control a camera with one of the scene's sets of controls
+void ControlCamera( Camera* camera, int controls, float frameTime )
+{
+	if (!camera || controls == kNoSceneObject)  return;
+	SController keys = SceneController(controls);
+	camera->Control(frameTime, keys.turnUp, keys.turnDown, keys.turnLeft, keys.turnRight, keys.turnCW, keys.turnCCW,
+	                keys.moveForward, keys.moveBackward);
+}
+
+// World space bounding sphere of an entity from its geometry's bounds and its transform. Scaling may differ on each axis,
+// so the radius uses the largest
+gen::SSphere EntityBoundingSphere( EntityHandle entity, Geometry* geometry )
+{
+	gen::SSphere sphere;
+	if (!geometry)
+	{
+		sphere.centre = Entities.Position(entity);
+		sphere.radius = 0.0f;
+		return sphere;
+	}
+	D3DXVECTOR3 centre = geometry->BoundingCentre();
+	sphere.centre = Entities.WorldMatrix(entity).TransformPoint(gen::CVector3(centre.x, centre.y, centre.z));
+	sphere.radius = geometry->BoundingRadius() * Entities.MaxScale(entity);
+	return sphere;
+}
+
+// Bounding sphere system - rebuild the world space bounding sphere of every rendered object, in the order they are
+// rendered. The spheres of geometry still importing have zero radius, nothing is drawn for them yet anyway
+void UpdateBoundingSpheres()
+{
+	BoundingSpheres.resize(Renderables.Size() + Lights.Size() + (Portal ? 1 : 0));
+	gen::SSphere* sphere = BoundingSpheres.empty() ? NULL : &BoundingSpheres[0];
+	for (unsigned int i = 0; i < Renderables.Size(); i++)
+	{
+		*sphere++ = EntityBoundingSphere(Renderables.Owner(i), Renderables[i].geometry);
+	}
+	for (unsigned int i = 0; i < Lights.Size(); i++)
+	{
+		*sphere++ = EntityBoundingSphere(Lights.Owner(i), LightGeometry);
+	}
+	if (Portal)
+	{
+		sphere->centre = Portal->BoundingCentre();
+		sphere->radius = Portal->BoundingRadius();
+	}
+}
+
 // Update the scene - move/rotate each model and the camera, then update their matrices
 void UpdateScene( float frameTime )
 {
+	// Count the model world matrices recalculated this frame (Model::MatrixUpdates) from here
+	Model::ResetMatrixUpdates();
+
+	// Upload the next part of any models still loading in the background. Once per geometry not per renderable, so
+	// geometry shared by several entities does not upload several parts a frame
+	for (unsigned int i = 0; i < SceneGeometries.size(); i++)
+	{
+		if (SceneGeometries[i] && !SceneGeometries[i]->UpdateLoading(8192))
+		{
+			MessageBox(NULL, L"Error loading model files. Ensure your files are correctly named and in the same folder as this executable.", L"Error", MB_OK);
+		}
+	}
+
+	// Use any texture detail streamed in since the last frame and start loading the detail the last frame needed
+	if (!Textures->Update())
+	{
+		MessageBox(NULL, L"Error loading texture files. Ensure your files are correctly named and in the same folder as this executable.", L"Error", MB_OK);
+	}
+
 	// Control camera position and update its matrices (view matrix, projection matrix) each frame
 	// Don't be deceived into thinking that this is a new method to control models - the same code we used previously is in the camera class
-	MainCamera->Control(frameTime, Key_W, Key_S, Key_A, Key_D, Key_E, Key_Q, Key_Z, Key_X);
-	PortalCamera->Control(frameTime, Key_T, Key_G, Key_F, Key_H, Key_N, Key_B, Key_V, Key_M);
+	// The keys for each camera come from the scene
+	ControlCamera(MainCamera, MainCameraControls, frameTime);
+	ControlCamera(PortalCamera, PortalCameraControls, frameTime);
+
+	// Bring the camera matrices up to date once for the frame, all the rendering passes then share them
+	MainCamera->UpdateMatrices();
+	if (PortalCamera)  PortalCamera->UpdateMatrices();
 	
-	// Control cube position and update its world matrix each frame
-	ModelArr[1].model->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Comma, Key_Period);
-	ModelArr[2].model->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Comma, Key_Period);
-	Portal->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma);
+	// Control the entities with controllers and the portal, then move the orbiting entities
+	UpdateControllers(frameTime);
+	if (Portal && PortalControls != kNoSceneObject)
+	{
+		SController keys = SceneController(PortalControls);
+		Portal->Control(frameTime, keys.turnUp, keys.turnDown, keys.turnLeft, keys.turnRight, keys.turnCW, keys.turnCCW,
+		                keys.moveForward, keys.moveBackward);
+	}
+	UpdateOrbits(frameTime);
 
-	// Update the orbiting light - a bit of a cheat with the static variable [ask the tutor if you want to know what this is]
-	static float Rotate = 0.0f;
-	LightArr[0].model->SetPosition(ModelArr[0].model->Position() + D3DXVECTOR3(cos(Rotate)*LightOrbitRadius, 0, sin(Rotate)*LightOrbitRadius) );
-	Rotate -= LightOrbitSpeed * frameTime;
+	// Rebuild the world matrices of the entities that moved, in one pass through the transforms, then the bounding spheres
+	// used to cull objects in every rendering pass
+	Entities.UpdateWorldMatrices();
+	UpdateBoundingSpheres();
 
 	// lighting
-	Pulse += frameTime;
-	LightArr[1].colour = PulseDefault * abs(sin(Pulse));
-	
-	HSL[0] += frameTime * ColourRotateRate;
-	HSLToRGB(HSL[0], HSL[1], HSL[2], LightArr[0].colour.x, LightArr[0].colour.y, LightArr[0].colour.z);
+	UpdateLightAnimations(frameTime);
 
 	// Update mover
 	Mover += 0.1f * frameTime;
@@ -422,9 +738,44 @@ void UpdateScene( float frameTime )
 //**** Scene rendering has been split up. Since the models are rendered twice, once into the portal ****//
 //**** texture, and once for the viewport, that part of the code has been seperated into a function ****//
 
-// Render all the models from the point of view of the given camera
-void RenderModels(Camera* camera)
+// Request the texture detail needed for an entity seen by the given camera in a viewport of the given height. The
+// nearest point of the entity needs the most detail, where one pixel covers the distance found from the field of view
+void RequestModelTextures(const SRenderable& renderable, EntityHandle entity, const gen::SSphere& bounds, const Camera* camera,
+                          unsigned int viewportHeight)
+{
+	if (!renderable.geometry)  return;
+
+	// Distance to the entity's world space bounding sphere. Scaling up a model spreads its texture over a larger distance
+	float maxScale = Entities.MaxScale(entity);
+	float distance = (bounds.centre - camera->Position()).Length() - bounds.radius;
+	if (distance < camera->NearClip())  distance = camera->NearClip();
+	float pixelSize = 2.0f * distance * tan(camera->FOV() * 0.5f) / viewportHeight;
+	float uvPerPixel = maxScale > 0.0f ? pixelSize * renderable.geometry->UVDensity() / maxScale : 0.0f;
+
+	Textures->Request(renderable.DiffuseTexture, uvPerPixel);
+	Textures->Request(renderable.NormalTexture, uvPerPixel);
+}
+
+// Render all the models from the point of view of the given camera, rendering to a viewport of the given height. Returns
+// the number of objects culled
+unsigned int RenderModels(const Camera* camera, unsigned int viewportHeight)
 {
+	//---------------------------
+	// Frustum culling
+
+	// Test the bounding sphere of every object against the camera's frustum in one batch, four spheres at a time with
+	// SIMD, before any shader variables are set. Objects the camera cannot see are skipped entirely, so the cost of the
+	// rendering pass follows what the camera can see rather than the size of the scene
+	size_t numSpheres = BoundingSpheres.size();
+	if (numSpheres > SphereVisibleSize)
+	{
+		SphereVisible.reset(new bool[numSpheres]);
+		SphereVisibleSize = numSpheres;
+	}
+	const bool* visible = SphereVisible.get();
+	size_t numVisible = 0;
+	if (numSpheres > 0)  numVisible = camera->Frustum().CullSpheres(&BoundingSpheres[0], SphereVisible.get(), numSpheres, 0);
+
 	//---------------------------
 	// Render each model
 
@@ -435,39 +786,70 @@ void RenderModels(Camera* camera)
 	ViewMatrixVar->SetMatrix((float*)&camera->ViewMatrix());
 	ProjMatrixVar->SetMatrix((float*)&camera->ProjectionMatrix());
 
-	// Render cube
-	for (int i = 0; i < MODEL_COUNT; i++)
+	// Render each visible renderable entity, straight through the pool which is kept in draw order. Entities sharing
+	// texture arrays are drawn one after another (see InitScene) so the arrays are only sent to the shader when they
+	// change, each entity just selects its own slice of them. Only visible entities request texture detail
+	ID3D10ShaderResourceView* diffuseMap = NULL;
+	ID3D10ShaderResourceView* normalMap = NULL;
+	bool firstDrawn = true;
+	for (unsigned int i = 0; i < Renderables.Size(); i++)
 	{
-		WorldMatrixVar->SetMatrix((float*)ModelArr[i].model->WorldMatrix()); // Send the cube's world matrix to the shader
-		DiffuseMapVar->SetResource(ModelArr[i].DiffuseMap);             // Send the cube's diffuse/specular map to the shader
-		NormalMapVar->SetResource(ModelArr[i].NormalMap);               // Send the cube's normal/depth map to the shader
-		TintColourVar->SetRawValue(ModelArr[i].tintColour, 0, 12);
-
-		if (ModelArr[i].effectsAlways || UseMover)
+		if (!visible[i])  continue;
+
+		SRenderable& renderable = Renderables[i];
+		EntityHandle entity = Renderables.Owner(i);
+		WorldMatrixVar->SetMatrix((float*)&Entities.WorldMatrix(entity)); // Send the entity's world matrix to the shader
+		RequestModelTextures(renderable, entity, BoundingSpheres[i], camera, viewportHeight);
+		if (firstDrawn || Textures->Map(renderable.DiffuseTexture) != diffuseMap)
+		{
+			diffuseMap = Textures->Map(renderable.DiffuseTexture);
+			DiffuseMapVar->SetResource(diffuseMap);                      // Send the diffuse/specular map to the shader
+		}
+		if (firstDrawn || Textures->Map(renderable.NormalTexture) != normalMap)
+		{
+			normalMap = Textures->Map(renderable.NormalTexture, 0);
+			NormalMapVar->SetResource(normalMap);                        // Send the normal map to the shader
+			DepthMapVar->SetResource(Textures->Map(renderable.NormalTexture, 1)); // Send the depth map to the shader
+		}
+		DiffuseSliceVar->SetFloat((float)Textures->Slice(renderable.DiffuseTexture));
+		NormalSliceVar->SetFloat((float)Textures->Slice(renderable.NormalTexture));
+		TintColourVar->SetRawValue(renderable.tintColour, 0, 12);
+
+		if (renderable.effectsAlways || UseMover)
 			MoverVar->SetFloat(Mover);
 		else
 			MoverVar->SetFloat(0);
-		if (ModelArr[i].effectsAlways || UseWiggle)
+		if (renderable.effectsAlways || UseWiggle)
 			WiggleVar->SetFloat(Wiggle);
 		else
 			WiggleVar->SetFloat(0);
 
-		ModelArr[i].model->Render(ModelArr[i].technique);                 // Pass rendering technique to the model class
+		if (renderable.geometry)  renderable.geometry->Render(renderable.technique, renderable.exampleTechnique);
+		firstDrawn = false;
 	}
 
-	for (int i = 0; i < LIGHT_COUNT; i++)
+	// Display a model at each visible light, all sharing the same geometry
+	const bool* lightVisible = visible + Renderables.Size();
+	for (unsigned int i = 0; i < Lights.Size() && LightGeometry; i++)
 	{
-		WorldMatrixVar->SetMatrix((float*)LightArr[i].model->WorldMatrix());
+		if (!lightVisible[i])  continue;
+		WorldMatrixVar->SetMatrix((float*)&Entities.WorldMatrix(Lights.Owner(i)));
 		DiffuseMapVar->SetResource(LightDiffuseMap);
-		TintColourVar->SetRawValue(LightArr[i].colour * LightArr[i].power, 0, 12); // Using special shader that tints the light model to match the light colour
+		DiffuseSliceVar->SetFloat(0);
+		TintColourVar->SetRawValue(Lights[i].colour * Lights[i].power, 0, 12); // Using special shader that tints the light model to match the light colour
 		WiggleVar->SetFloat(0);
 		MoverVar->SetFloat(0);
-		LightArr[i].model->Render(AdditiveTintTexTechnique);
+		LightGeometry->Render(AdditiveTintTexTechnique, AdditiveTintTexTechnique);
+	}
+
+	if (Portal && visible[numSpheres - 1])
+	{
+		WorldMatrixVar->SetMatrix((float*)&Portal->WorldMatrix());
+		DiffuseMapVar->SetResource(PortalMap);
+		Portal->Render(VertexLitTexTechnique);
 	}
 
-	WorldMatrixVar->SetMatrix((float*)Portal->WorldMatrix());
-	DiffuseMapVar->SetResource(PortalMap);
-	Portal->Render(VertexLitTexTechnique);
+	return static_cast<unsigned int>(numSpheres - numVisible);
 }
 
 // Render everything in the scene
@@ -479,19 +861,33 @@ void RenderScene()
 	// There are some common features all models that we will be rendering, set these once only
 
 
-	// Pass light information to the vertex shader - lights are the same for each model
-	Light1PosVar->SetRawValue(LightArr[0].model->Position(), 0, 12);  // Send 3 floats (12 bytes) from C++ LightPos variable (x,y,z) to shader counterpart (middle parameter is unused) 
-	Light1ColourVar->SetRawValue(LightArr[0].colour * LightArr[0].power, 0, 12);
-	Light2PosVar->SetRawValue(LightArr[1].model->Position(), 0, 12);
-	Light2ColourVar->SetRawValue(LightArr[1].colour * LightArr[1].power, 0, 12);
-	DirrectionalVecVar->SetRawValue(LightArr[2].vector, 0, 12);
-	DirrectionalColourVar->SetRawValue(LightArr[2].colour * LightArr[2].power, 0, 12);
-	SpotLightPosVar->SetRawValue(LightArr[3].model->Position(), 0, 12);
-	SpotLightVecVar->SetRawValue(LightArr[3].vector, 0, 12);
-	SpotLightColourVar->SetRawValue(LightArr[3].colour * LightArr[3].power, 0, 12);
-	SpotLightAngleVar->SetFloat(SpotLightAngle);
+	// Pass light information to the vertex shader - lights are the same for each model. Any of the shader's lights
+	// that the scene doesn't have are sent as black
+	Light noLight = { point, D3DXVECTOR3(0, 0, 0), 0.0f, D3DXVECTOR3(0, 1, 0), 0.0f };
+	Light* light1 = Lights.Get(Light1Entity);
+	Light* light2 = Lights.Get(Light2Entity);
+	Light* directionalLight = Lights.Get(DirectionalLightEntity);
+	Light* spotLight = Lights.Get(SpotLightEntity);
+	gen::CVector3 light1Pos = light1 ? Entities.Position(Light1Entity) : gen::CVector3::kOrigin;
+	gen::CVector3 light2Pos = light2 ? Entities.Position(Light2Entity) : gen::CVector3::kOrigin;
+	gen::CVector3 spotLightPos = spotLight ? Entities.Position(SpotLightEntity) : gen::CVector3::kOrigin;
+	if (!light1)            light1 = &noLight;
+	if (!light2)            light2 = &noLight;
+	if (!directionalLight)  directionalLight = &noLight;
+	if (!spotLight)         spotLight = &noLight;
+	gen::CVector3 cameraPos = MainCamera->Position();
+	Light1PosVar->SetRawValue(&light1Pos, 0, 12);  // Send 3 floats (12 bytes) from C++ LightPos variable (x,y,z) to shader counterpart (middle parameter is unused) 
+	Light1ColourVar->SetRawValue(light1->colour * light1->power, 0, 12);
+	Light2PosVar->SetRawValue(&light2Pos, 0, 12);
+	Light2ColourVar->SetRawValue(light2->colour * light2->power, 0, 12);
+	DirrectionalVecVar->SetRawValue(directionalLight->vector, 0, 12);
+	DirrectionalColourVar->SetRawValue(directionalLight->colour * directionalLight->power, 0, 12);
+	SpotLightPosVar->SetRawValue(&spotLightPos, 0, 12);
+	SpotLightVecVar->SetRawValue(spotLight->vector, 0, 12);
+	SpotLightColourVar->SetRawValue(spotLight->colour * spotLight->power, 0, 12);
+	SpotLightAngleVar->SetFloat(spotLight->angle);
 	AmbientColourVar->SetRawValue(AmbientColour, 0, 12);
-	CameraPosVar->SetRawValue(MainCamera->Position(), 0, 12);
+	CameraPosVar->SetRawValue(&cameraPos, 0, 12);
 	SpecularPowerVar->SetFloat(SpecularPower);
 
 	// Parallax mapping depth
@@ -504,25 +900,28 @@ void RenderScene()
 	// Render portal scene
 	//---------------------------
 
-	// Setup the viewport - defines which part of the texture we will render to (usually all of it)
 	D3D10_VIEWPORT vp;
-	vp.Width = PortalWidth;
-	vp.Height = PortalHeight;
-	vp.MinDepth = 0.0f;
-	vp.MaxDepth = 1.0f;
-	vp.TopLeftX = 0;
-	vp.TopLeftY = 0;
-	Device->RSSetViewports(1, &vp);
-
-	// Select the portal texture to use for rendering, will share the depth/stencil buffer with the backbuffer though
-	Device->OMSetRenderTargets(1, &PortalRenderTarget, PortalDepthStencilView);
-
-	// Clear the portal texture and its depth buffer
-	Device->ClearRenderTargetView(PortalRenderTarget, &BackgroundColour[0]);
-	Device->ClearDepthStencilView(PortalDepthStencilView, D3D10_CLEAR_DEPTH, 1.0f, 0);
-
-	// Render everything from the portal camera's point of view (into the portal render target [texture] set above)
-	RenderModels(PortalCamera);
+	if (Portal)
+	{
+		// Setup the viewport - defines which part of the texture we will render to (usually all of it)
+		vp.Width = PortalWidth;
+		vp.Height = PortalHeight;
+		vp.MinDepth = 0.0f;
+		vp.MaxDepth = 1.0f;
+		vp.TopLeftX = 0;
+		vp.TopLeftY = 0;
+		Device->RSSetViewports(1, &vp);
+
+		// Select the portal texture to use for rendering, will share the depth/stencil buffer with the backbuffer though
+		Device->OMSetRenderTargets(1, &PortalRenderTarget, PortalDepthStencilView);
+
+		// Clear the portal texture and its depth buffer
+		Device->ClearRenderTargetView(PortalRenderTarget, &BackgroundColour[0]);
+		Device->ClearDepthStencilView(PortalDepthStencilView, D3D10_CLEAR_DEPTH, 1.0f, 0);
+
+		// Render everything from the portal camera's point of view (into the portal render target [texture] set above)
+		PortalPassCulled = RenderModels(PortalCamera, PortalHeight);
+	}
 
 	//---------------------------
 	// Render main scene
@@ -545,7 +944,7 @@ void RenderScene()
 	Device->ClearDepthStencilView(DepthStencilView, D3D10_CLEAR_DEPTH, 1.0f, 0);
 
 	// Render everything from the main camera's point of view (into the portal render target [texture] set above)
-	RenderModels(MainCamera);
+	MainPassCulled = RenderModels(MainCamera, ViewportHeight);
 
 	//---------------------------
 	// Display the Scene
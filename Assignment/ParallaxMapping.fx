@@ -90,10 +90,17 @@ float  WigglePower;
 float3 TintColour;
 
 // Diffuse map (sometimes also containing specular map in alpha channel). Loaded from a bitmap in the C++ then sent over to the shader variable in the usual way
-Texture2D DiffuseMap;
-
-//****| INFO | Normal map, now contains depth per pixel in the alpha channel ****//
-Texture2D NormalMap;
+// Textures of the same size and format are packed into texture arrays, so models with different textures can share the
+// same bound array. The slice holding the model's texture is selected with DiffuseSlice
+Texture2DArray DiffuseMap;
+float DiffuseSlice;
+
+//****| INFO | Normal map and depth map. The normal map only holds the x and y of each (unit length) normal, z is
+//              rebuilt from them. The depth per pixel is in its own single channel map. Both are arrays like the
+//              diffuse map, with the same slice of each used ****//
+Texture2DArray NormalMap;
+Texture2DArray DepthMap;
+float NormalSlice;
 
 //****| INFO | Also store a factor to strengthen/weaken the parallax effect. Cannot exaggerate it too much or will get distortion ****//
 float ParallaxDepth;
@@ -233,9 +240,9 @@ float4 NormalMapLighting( VS_NORMALMAP_OUTPUT vOut ) : SV_Target
 	float3x3 tangentMatrix = transpose( invTangentMatrix ); 
 	float2 textureOffsetDir = mul( cameraModelDir, tangentMatrix );
 	
-	// Get the depth info from the normal map's alpha channel at the given texture coordinate
+	// Get the depth info from the depth map at the given texture coordinate
 	// Rescale from 0->1 range to -x->+x range, x determined by ParallaxDepth setting
-	float texDepth = ParallaxDepth * (NormalMap.Sample( TrilinearWrap, vOut.UV ).a - 0.5f);
+	float texDepth = ParallaxDepth * (DepthMap.Sample( TrilinearWrap, float3(vOut.UV, NormalSlice) ).r - 0.5f);
 	
 	// Use the depth of the texture to offset the given texture coordinate - this corrected texture coordinate will be used from here on
 	float2 offsetTexCoord = vOut.UV + texDepth * textureOffsetDir * 0.75f;
@@ -249,9 +256,12 @@ float4 NormalMapLighting( VS_NORMALMAP_OUTPUT vOut ) : SV_Target
 	//**********************************************************************************************//
 
 
-	// Get the texture normal from the normal map. The r,g,b pixel values actually store x,y,z components of a normal. However, r,g,b
-	// values are stored in the range 0->1, whereas the x, y & z components should be in the range -1->1. So some scaling is needed
-	float3 textureNormal = 2.0f * NormalMap.Sample( TrilinearWrap, offsetTexCoord ) - 1.0f; // Scale from 0->1 to -1->1
+	// Get the texture normal from the normal map. The r,g pixel values actually store x,y components of a normal. However, r,g
+	// values are stored in the range 0->1, whereas the x & y components should be in the range -1->1. So some scaling is needed.
+	// The normal is unit length and points out of the surface, so z is the positive root of 1 - x^2 - y^2
+	float3 textureNormal;
+	textureNormal.xy = 2.0f * NormalMap.Sample( TrilinearWrap, float3(offsetTexCoord, NormalSlice) ).rg - 1.0f; // Scale from 0->1 to -1->1
+	textureNormal.z = sqrt( saturate( 1.0f - dot( textureNormal.xy, textureNormal.xy ) ) );
 
 	// Now convert the texture normal into model space using the inverse tangent matrix, and then convert into world space using the world
 	// matrix. Normalise, because of the effects of texture filtering and in case the world matrix contains scaling
@@ -315,7 +325,7 @@ float4 NormalMapLighting( VS_NORMALMAP_OUTPUT vOut ) : SV_Target
 	// Sample texture
 
 	// Extract diffuse and specular material colour for this pixel from a texture (use offset texture coordinate from parallax mapping)
-	float4 DiffuseMaterial = DiffuseMap.Sample( TrilinearWrap, offsetTexCoord );
+	float4 DiffuseMaterial = DiffuseMap.Sample( TrilinearWrap, float3(offsetTexCoord, DiffuseSlice) );
 	float3 SpecularMaterial = DiffuseMaterial.a;
 
 	
@@ -335,7 +345,7 @@ float4 NormalMapLighting( VS_NORMALMAP_OUTPUT vOut ) : SV_Target
 float4 TintDiffuseMap( VS_BASIC_OUTPUT vOut ) : SV_Target
 {
 	// Extract diffuse material colour for this pixel from a texture
-	float4 diffuseMapColour = DiffuseMap.Sample( TrilinearWrap, vOut.UV );
+	float4 diffuseMapColour = DiffuseMap.Sample( TrilinearWrap, float3(vOut.UV, DiffuseSlice) );
 
 	// Tint by global colour (set from C++)
 	diffuseMapColour.rgb *= TintColour / 10;
@@ -405,7 +415,7 @@ float4 VertexLitDiffuseMap(VS_LIGHTING_OUTPUT vOut) : SV_Target  // The ": SV_Ta
 	// Sample texture
 
 	// Extract diffuse material colour for this pixel from a texture (using float3, so we get RGB - i.e. ignore any alpha in the texture)
-	float4 DiffuseMaterial = DiffuseMap.Sample(TrilinearWrap, vOut.UV);
+	float4 DiffuseMaterial = DiffuseMap.Sample(TrilinearWrap, float3(vOut.UV, DiffuseSlice));
 
 	// Assume specular material colour is white (i.e. highlights are a full, untinted reflection of light)
 	float3 SpecularMaterial = DiffuseMaterial.a;
@@ -18,6 +18,11 @@ extern const float kRotationSpeed;
 extern const float kMovementSpeed;
 extern const float kScaleSpeed;
 
+// Number of objects culled by the portal and main rendering passes in the last frame - objects
+// outside a camera's view frustum are not drawn by that pass
+extern unsigned int PortalPassCulled;
+extern unsigned int MainPassCulled;
+
 
 //--------------------------------------------------------------------------------------
 // Function prototypes
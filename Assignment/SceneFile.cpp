@@ -0,0 +1,1121 @@
+//--------------------------------------------------------------------------------------
+//	Scene description files - the models, materials, lights, cameras and portal of a
+//	scene, kept out of the code so the scene can be changed without recompiling.
+//	Scenes are written in a text form (.scene) and compiled to a binary form (.sceneb)
+//	that loads with a single read
+//--------------------------------------------------------------------------------------
+// Text form, one setting per line, # starts a comment:
+//
+//   background (0.2, 0.2, 0.3)         Global settings, anywhere in the file
+//   ambient    (0.2, 0.2, 0.3)
+//   lightmodel Light.x                 Model and texture shown at each light
+//   lightmap   Flare.jpg
+//
+//   material Stone                     An object starts with its type and name, the indented
+//     technique VertexLit              lines after it set its properties
+//     diffuse StoneDiffuseSpecular.dds
+//
+//   model Floor
+//     geometry Floor.x
+//     material Stone                   Refers to an object of that type declared above
+//
+// Vectors are written "(x, y, z)" and angles in degrees. Names and file names containing
+// spaces are written in double quotes. See the parser functions below for each object's
+// properties and their defaults
+
+#include "SceneFile.h"
+#include "MathIO.h"
+#include "BaseMath.h"
+#include <charconv>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <stdio.h>
+#include <string.h>
+
+// Technique, light type and light animation names in the text form, in enum order
+static const char* TechniqueNames[] = { "Parallax", "VertexLit", "AdditiveTintTex", "VertexAdditive" };
+static const char* LightTypeNames[] = { "point", "directional", "spot" };
+static const char* AnimationNames[] = { "still", "pulse", "hue" };
+static const unsigned int kNumTechniques  = sizeof(TechniqueNames) / sizeof(TechniqueNames[0]);
+static const unsigned int kNumLightTypes  = sizeof(LightTypeNames) / sizeof(LightTypeNames[0]);
+static const unsigned int kNumAnimations  = sizeof(AnimationNames) / sizeof(AnimationNames[0]);
+
+// Largest portal texture
+static const unsigned int kMaxPortalSize = 8192;
+
+
+//--------------------------------------------------------------------------------------
+// Helper functions
+//--------------------------------------------------------------------------------------
+
+static bool SceneError( string* error, const string& message )
+{
+	if (error)  *error = message;
+	return false;
+}
+
+// Key code for a character in a list of controls (see Input.h), 0 if the character is not a key
+static unsigned int KeyFromChar( char c )
+{
+	if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))  return c; // Letter and number key codes are their characters
+	if (c >= 'a' && c <= 'z')  return c - 'a' + 'A';
+	if (c == ',')  return 0xBC; // Key_Comma
+	if (c == '.')  return 0xBE; // Key_Period
+	if (c == '-')  return 0xBD; // Key_Minus
+	if (c == '+')  return 0xBB; // Key_Plus
+	return 0;
+}
+
+// Character for a key code in a list of controls, 0 if the key has no character
+static char CharFromKey( unsigned int key )
+{
+	if ((key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9'))  return static_cast<char>(key);
+	if (key == 0xBC)  return ',';
+	if (key == 0xBE)  return '.';
+	if (key == 0xBD)  return '-';
+	if (key == 0xBB)  return '+';
+	return 0;
+}
+
+// Read a whole file into memory
+static bool ReadWholeFile( const string& fileName, vector<char>* data, string* error )
+{
+	FILE* file = fopen( fileName.c_str(), "rb" );
+	if (!file)
+	{
+		return SceneError( error, fileName + ": Cannot open file" );
+	}
+
+	fseek( file, 0, SEEK_END );
+	long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	bool ok = fileSize >= 0;
+	if (ok)
+	{
+		data->resize( fileSize );
+		ok = fileSize == 0 || fread( &(*data)[0], 1, fileSize, file ) == static_cast<size_t>(fileSize);
+	}
+	fclose( file );
+	if (!ok)
+	{
+		data->clear();
+		return SceneError( error, fileName + ": Cannot read file" );
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Validation
+//--------------------------------------------------------------------------------------
+// Checks shared by the text and binary forms, so the rest of the program can use any scene that
+// loads without further checks
+
+static bool ValidString( const SceneDescription& scene, unsigned int offset, bool required )
+{
+	if (offset == kNoSceneString)  return !required;
+	return offset < scene.strings.size();
+}
+
+static bool ValidIndex( int index, size_t count, bool required )
+{
+	if (index == kNoSceneObject)  return !required;
+	return index >= 0 && static_cast<size_t>(index) < count;
+}
+
+static bool ValidateScene( const SceneDescription& scene, string* error )
+{
+	// Every offset into the string table must be followed by a null somewhere, so it is enough that
+	// the table ends with one
+	if (!scene.strings.empty() && scene.strings.back() != '\0')
+	{
+		return SceneError( error, "String table is not terminated" );
+	}
+	if (!ValidString( scene, scene.lightGeometry, !scene.lights.empty() ) || !ValidString( scene, scene.lightMap, false ))
+	{
+		return SceneError( error, "Scene has lights but no light model" );
+	}
+
+	for (size_t i = 0; i < scene.controls.size(); ++i)
+	{
+		for (int key = 0; key < 8; ++key)
+		{
+			if (scene.controls[i].keys[key] == 0 || scene.controls[i].keys[key] > 0xff)
+			{
+				return SceneError( error, "Invalid key code in controls" );
+			}
+		}
+	}
+	for (size_t i = 0; i < scene.orbits.size(); ++i)
+	{
+		if (!ValidIndex( scene.orbits[i].centre, scene.models.size(), true ))
+		{
+			return SceneError( error, "Orbit centre is not a model" );
+		}
+	}
+
+	for (size_t i = 0; i < scene.materials.size(); ++i)
+	{
+		const SSceneMaterial& material = scene.materials[i];
+		if (!ValidString( scene, material.name, false ) || !ValidString( scene, material.diffuseMap, false ) ||
+		    !ValidString( scene, material.normalMap, false ) || material.technique >= kNumTechniques)
+		{
+			return SceneError( error, "Invalid material" );
+		}
+	}
+
+	for (size_t i = 0; i < scene.models.size(); ++i)
+	{
+		const SSceneModel& model = scene.models[i];
+		if (!ValidString( scene, model.name, false ) || !ValidString( scene, model.geometry, true ) ||
+		    !ValidIndex( model.material, scene.materials.size(), false ) ||
+		    !ValidIndex( model.controls, scene.controls.size(), false ) ||
+		    !ValidIndex( model.orbit, scene.orbits.size(), false ))
+		{
+			return SceneError( error, "Invalid model" );
+		}
+
+		// Models orbit models before them, so moving the models in order moves each centre first
+		if (model.orbit != kNoSceneObject && scene.orbits[model.orbit].centre >= static_cast<int>(i))
+		{
+			return SceneError( error, "Model orbits itself or a later model" );
+		}
+	}
+
+	for (size_t i = 0; i < scene.lights.size(); ++i)
+	{
+		const SSceneLight& light = scene.lights[i];
+		if (!ValidString( scene, light.name, false ) || light.type >= kNumLightTypes ||
+		    light.animation >= kNumAnimations || !ValidIndex( light.orbit, scene.orbits.size(), false ))
+		{
+			return SceneError( error, "Invalid light" );
+		}
+	}
+
+	if (scene.cameras.empty())
+	{
+		return SceneError( error, "Scene has no camera" );
+	}
+	for (size_t i = 0; i < scene.cameras.size(); ++i)
+	{
+		const SSceneCamera& camera = scene.cameras[i];
+		if (!ValidString( scene, camera.name, false ) || !ValidIndex( camera.controls, scene.controls.size(), false ) ||
+		    !(camera.fov > 0.0f && camera.fov < gen::kfPi) || !(camera.nearClip > 0.0f && camera.farClip > camera.nearClip))
+		{
+			return SceneError( error, "Invalid camera" );
+		}
+	}
+
+	for (size_t i = 0; i < scene.portals.size(); ++i)
+	{
+		const SScenePortal& portal = scene.portals[i];
+		if (!ValidString( scene, portal.name, false ) || !ValidString( scene, portal.geometry, true ) ||
+		    !ValidIndex( portal.camera, scene.cameras.size(), true ) ||
+		    !ValidIndex( portal.controls, scene.controls.size(), false ) ||
+		    portal.width == 0 || portal.width > kMaxPortalSize || portal.height == 0 || portal.height > kMaxPortalSize)
+		{
+			return SceneError( error, "Invalid portal" );
+		}
+	}
+
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Text form - reading
+//--------------------------------------------------------------------------------------
+
+// Reads a text scene in one pass. Tokens are views into the text, and each different string is
+// added to the scene's string table once (looked up by a view of its first use). So nothing is
+// allocated per token, only the scene's arrays and a hash table entry per different string and name
+class SceneParser
+{
+public:
+	SceneParser( const char* text, size_t length, const string& fileName, SceneDescription* scene, string* error )
+		: mPos( text ), mLineEnd( text ), mNextLine( text ), mEnd( text + length ), mFileName( fileName ), mLine( 0 ),
+		  mScene( scene ), mError( error ), mObject( kNone )
+	{
+	}
+
+	bool Parse();
+
+private:
+	// Type of the object whose properties are being read
+	enum EObject { kNone, kMaterial, kModel, kLight, kCamera, kPortal };
+
+	//-------------------------------------
+	// Tokens
+
+	// Move to the next line, returning false at the end of the text
+	bool NextLine();
+
+	// Read the next word or quoted string on the line, returning false if there is none
+	bool Word( string_view* word );
+
+	// Read values from the line, reporting an error if they are missing or invalid
+	bool String( unsigned int* offset, string_view* text = NULL );
+	bool Float( float* value );
+	bool Angle( float* radians );
+	bool Unsigned( unsigned int* value );
+	bool Vector( gen::CVector3* value );
+	bool Angles( gen::CVector3* radians );
+	bool Name( const char* const* names, unsigned int count, unsigned int* value, const char* what );
+	bool Controls( int* index );
+	bool Orbit( int* index );
+
+	// Look up an object declared earlier by name
+	bool Reference( unordered_map<string_view, int>& names, const char* what, int* index );
+
+	// Check nothing follows the values on a line
+	bool EndOfLine();
+
+	bool Error( const string& message );
+
+	//-------------------------------------
+	// Objects
+
+	bool Global( string_view keyword, bool* handled );
+	bool BeginObject( string_view keyword, bool* handled );
+	bool MaterialProperty( string_view keyword );
+	bool ModelProperty( string_view keyword );
+	bool LightProperty( string_view keyword );
+	bool CameraProperty( string_view keyword );
+	bool PortalProperty( string_view keyword );
+
+	//-------------------------------------
+	// Data
+
+	const char* mPos;     // Next character to read...
+	const char* mLineEnd; // ...on the current line, which ends here (before any comment)
+	const char* mNextLine;
+	const char* mEnd;
+	const string& mFileName;
+	int mLine;
+
+	SceneDescription* mScene;
+	string* mError;
+
+	// Offset in the string table of each different string, and index of each named object that can
+	// be referred to. The views point into the text
+	unordered_map<string_view, unsigned int> mStrings;
+	unordered_map<string_view, int> mMaterials;
+	unordered_map<string_view, int> mModels;
+	unordered_map<string_view, int> mCameras;
+
+	EObject mObject; // Object whose properties are being read, the last one of its type in the scene
+};
+
+
+///////////////////////////////
+// Tokens
+
+bool SceneParser::NextLine()
+{
+	if (mNextLine == mEnd)  return false;
+	mPos = mNextLine;
+	const char* newline = static_cast<const char*>(memchr( mPos, '\n', mEnd - mPos ));
+	mLineEnd = newline ? newline : mEnd;
+	mNextLine = newline ? newline + 1 : mEnd;
+	++mLine;
+
+	// Comments run to the end of the line, unless in quotes
+	bool quoted = false;
+	for (const char* c = mPos; c != mLineEnd; ++c)
+	{
+		if (*c == '"')  quoted = !quoted;
+		else if (*c == '#' && !quoted)
+		{
+			mLineEnd = c;
+			break;
+		}
+	}
+	return true;
+}
+
+bool SceneParser::Word( string_view* word )
+{
+	while (mPos != mLineEnd && (*mPos == ' ' || *mPos == '\t' || *mPos == '\r'))  ++mPos;
+	if (mPos == mLineEnd)  return false;
+
+	const char* start = mPos;
+	if (*mPos == '"')
+	{
+		++start;
+		const char* close = static_cast<const char*>(memchr( start, '"', mLineEnd - start ));
+		if (!close)  return false;
+		*word = string_view( start, close - start );
+		mPos = close + 1;
+		return true;
+	}
+	while (mPos != mLineEnd && *mPos != ' ' && *mPos != '\t' && *mPos != '\r')  ++mPos;
+	*word = string_view( start, mPos - start );
+	return true;
+}
+
+bool SceneParser::String( unsigned int* offset, string_view* text )
+{
+	string_view word;
+	if (!Word( &word ))  return Error( "Expected a name" );
+	if (text)  *text = word;
+
+	auto existing = mStrings.find( word );
+	if (existing != mStrings.end())
+	{
+		*offset = existing->second;
+		return true;
+	}
+	*offset = static_cast<unsigned int>(mScene->strings.size());
+	mScene->strings.insert( mScene->strings.end(), word.begin(), word.end() );
+	mScene->strings.push_back( '\0' );
+	mStrings[word] = *offset;
+	return true;
+}
+
+bool SceneParser::Float( float* value )
+{
+	string_view word;
+	if (!Word( &word ))  return Error( "Expected a number" );
+	const char* end = word.data() + word.size();
+	if (gen::ParseText( word.data(), end, *value ) != end)  return Error( "Invalid number" );
+	return true;
+}
+
+bool SceneParser::Angle( float* radians )
+{
+	if (!Float( radians ))  return false;
+	*radians = gen::ToRadians( *radians );
+	return true;
+}
+
+bool SceneParser::Unsigned( unsigned int* value )
+{
+	string_view word;
+	if (!Word( &word ))  return Error( "Expected a number" );
+	from_chars_result result = from_chars( word.data(), word.data() + word.size(), *value );
+	if (result.ec != errc() || result.ptr != word.data() + word.size())  return Error( "Invalid number" );
+	return true;
+}
+
+bool SceneParser::Vector( gen::CVector3* value )
+{
+	const char* end = gen::ParseText( mPos, mLineEnd, *value );
+	if (!end)  return Error( "Expected a vector (x, y, z)" );
+	mPos = end;
+	return true;
+}
+
+bool SceneParser::Angles( gen::CVector3* radians )
+{
+	if (!Vector( radians ))  return false;
+	*radians = gen::CVector3( gen::ToRadians( radians->x ), gen::ToRadians( radians->y ), gen::ToRadians( radians->z ) );
+	return true;
+}
+
+bool SceneParser::Name( const char* const* names, unsigned int count, unsigned int* value, const char* what )
+{
+	string_view word;
+	if (Word( &word ))
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			if (word == names[i])
+			{
+				*value = i;
+				return true;
+			}
+		}
+	}
+	return Error( string( "Expected a " ) + what );
+}
+
+// Eight keys: turn up, down, left, right, clockwise, anti-clockwise, move forward, backward
+bool SceneParser::Controls( int* index )
+{
+	string_view word;
+	if (!Word( &word ) || word.size() != 8)  return Error( "Expected eight control keys" );
+	SSceneControls controls;
+	for (int key = 0; key < 8; ++key)
+	{
+		controls.keys[key] = KeyFromChar( word[key] );
+		if (controls.keys[key] == 0)  return Error( "Invalid control key" );
+	}
+	*index = static_cast<int>(mScene->controls.size());
+	mScene->controls.push_back( controls );
+	return true;
+}
+
+// Centre model, radius and speed in degrees per second
+bool SceneParser::Orbit( int* index )
+{
+	SSceneOrbit orbit;
+	if (!Reference( mModels, "model", &orbit.centre ) || !Float( &orbit.radius ) || !Angle( &orbit.speed ))  return false;
+	*index = static_cast<int>(mScene->orbits.size());
+	mScene->orbits.push_back( orbit );
+	return true;
+}
+
+bool SceneParser::Reference( unordered_map<string_view, int>& names, const char* what, int* index )
+{
+	string_view word;
+	if (!Word( &word ))  return Error( string( "Expected a " ) + what + " name" );
+	auto object = names.find( word );
+	if (object == names.end())  return Error( string( "No " ) + what + " called " + string( word ) + " above" );
+	*index = object->second;
+	return true;
+}
+
+bool SceneParser::EndOfLine()
+{
+	string_view word;
+	if (Word( &word ))  return Error( "Unexpected " + string( word ) );
+	return true;
+}
+
+bool SceneParser::Error( const string& message )
+{
+	return SceneError( mError, mFileName + "(" + to_string( mLine ) + "): " + message );
+}
+
+
+///////////////////////////////
+// Objects
+
+bool SceneParser::Parse()
+{
+	while (NextLine())
+	{
+		// Indented lines set properties of the current object, others are global settings or start
+		// an object (the same word can be both, e.g. the material of a model)
+		bool property = mPos != mLineEnd && (*mPos == ' ' || *mPos == '\t');
+		string_view keyword;
+		if (!Word( &keyword ))  continue; // Blank line
+
+		bool ok = true;
+		if (!property)
+		{
+			bool handled = false;
+			ok = Global( keyword, &handled ) && (handled || BeginObject( keyword, &handled ));
+			if (ok && !handled)  ok = Error( "Unknown setting " + string( keyword ) + " (properties must be indented)" );
+		}
+		else
+		{
+			switch (mObject)
+			{
+				case kMaterial: ok = MaterialProperty( keyword ); break;
+				case kModel:    ok = ModelProperty( keyword );    break;
+				case kLight:    ok = LightProperty( keyword );    break;
+				case kCamera:   ok = CameraProperty( keyword );   break;
+				case kPortal:   ok = PortalProperty( keyword );   break;
+				default:        ok = Error( "Property " + string( keyword ) + " is not in an object" );
+			}
+		}
+		if (!ok || !EndOfLine())  return false;
+	}
+	return true;
+}
+
+// Settings for the whole scene
+bool SceneParser::Global( string_view keyword, bool* handled )
+{
+	*handled = true;
+	if      (keyword == "background")  return Vector( &mScene->backgroundColour );
+	else if (keyword == "ambient")     return Vector( &mScene->ambientColour );
+	else if (keyword == "lightmodel")  return String( &mScene->lightGeometry );
+	else if (keyword == "lightmap")    return String( &mScene->lightMap );
+	*handled = false;
+	return true;
+}
+
+// Start a new object with its defaults
+bool SceneParser::BeginObject( string_view keyword, bool* handled )
+{
+	// Names of objects that can be referred to must be unique within their type. The views are of
+	// the text rather than the string table, which moves as it grows
+	string_view name;
+	auto AddName = [&]( unordered_map<string_view, int>& names, int index )
+	{
+		if (names.count( name ))  return Error( "There is already a " + string( keyword ) + " called " + string( name ) );
+		names[name] = index;
+		return true;
+	};
+
+	*handled = true;
+	if (keyword == "material")
+	{
+		SSceneMaterial material;
+		material.diffuseMap = kNoSceneString;
+		material.normalMap = kNoSceneString;
+		material.technique = VertexLit;
+		material.tintColour = gen::CVector3( 1.0f, 1.0f, 1.0f );
+		material.effectsAlways = 0;
+		if (!String( &material.name, &name ) || !AddName( mMaterials, static_cast<int>(mScene->materials.size()) ))  return false;
+		mScene->materials.push_back( material );
+		mObject = kMaterial;
+	}
+	else if (keyword == "model")
+	{
+		SSceneModel model;
+		model.geometry = kNoSceneString;
+		model.material = kNoSceneObject;
+		model.flags = 0;
+		model.position = gen::CVector3::kOrigin;
+		model.rotation = gen::CVector3::kZero;
+		model.scale = gen::CVector3( 1.0f, 1.0f, 1.0f );
+		model.controls = kNoSceneObject;
+		model.orbit = kNoSceneObject;
+		if (!String( &model.name, &name ) || !AddName( mModels, static_cast<int>(mScene->models.size()) ))  return false;
+		mScene->models.push_back( model );
+		mObject = kModel;
+	}
+	else if (keyword == "light")
+	{
+		SSceneLight light;
+		if (!String( &light.name ))  return false;
+		light.type = point;
+		light.colour = gen::CVector3( 1.0f, 1.0f, 1.0f );
+		light.power = 1.0f;
+		light.direction = gen::CVector3( 0.0f, 0.0f, 1.0f );
+		light.angle = gen::ToRadians( 30.0f );
+		light.position = gen::CVector3::kOrigin;
+		light.scale = 1.0f;
+		light.animation = kSceneLightStill;
+		light.animationRate = 0.0f;
+		light.orbit = kNoSceneObject;
+		mScene->lights.push_back( light );
+		mObject = kLight;
+	}
+	else if (keyword == "camera")
+	{
+		SSceneCamera camera;
+		camera.position = gen::CVector3::kOrigin;
+		camera.rotation = gen::CVector3::kZero;
+		camera.fov = gen::kfPi / 4.0f;
+		camera.nearClip = 0.1f;
+		camera.farClip = 10000.0f;
+		camera.controls = kNoSceneObject;
+		if (!String( &camera.name, &name ) || !AddName( mCameras, static_cast<int>(mScene->cameras.size()) ))  return false;
+		mScene->cameras.push_back( camera );
+		mObject = kCamera;
+	}
+	else if (keyword == "portal")
+	{
+		SScenePortal portal;
+		if (!String( &portal.name ))  return false;
+		portal.geometry = kNoSceneString;
+		portal.camera = kNoSceneObject;
+		portal.width = 1024;
+		portal.height = 1024;
+		portal.position = gen::CVector3::kOrigin;
+		portal.rotation = gen::CVector3::kZero;
+		portal.controls = kNoSceneObject;
+		mScene->portals.push_back( portal );
+		mObject = kPortal;
+	}
+	else
+	{
+		*handled = false;
+	}
+	return true;
+}
+
+bool SceneParser::MaterialProperty( string_view keyword )
+{
+	SSceneMaterial& material = mScene->materials.back();
+	if      (keyword == "technique")  return Name( TechniqueNames, kNumTechniques, &material.technique, "technique" );
+	else if (keyword == "diffuse")    return String( &material.diffuseMap );
+	else if (keyword == "normal")     return String( &material.normalMap );
+	else if (keyword == "tint")       return Vector( &material.tintColour );
+	else if (keyword == "effects")
+	{
+		static const char* always[] = { "always" };
+		unsigned int unused;
+		material.effectsAlways = 1;
+		return Name( always, 1, &unused, "\"always\"" );
+	}
+	return Error( "Unknown material setting " + string( keyword ) );
+}
+
+bool SceneParser::ModelProperty( string_view keyword )
+{
+	SSceneModel& model = mScene->models.back();
+	if      (keyword == "geometry")    return String( &model.geometry );
+	else if (keyword == "material")    return Reference( mMaterials, "material", &model.material );
+	else if (keyword == "tangents")    { model.flags |= kSceneModelTangents;    return true; }
+	else if (keyword == "progressive") { model.flags |= kSceneModelProgressive; return true; }
+	else if (keyword == "position")    return Vector( &model.position );
+	else if (keyword == "rotation")    return Angles( &model.rotation );
+	else if (keyword == "controls")    return Controls( &model.controls );
+	else if (keyword == "orbit")       return Orbit( &model.orbit );
+	else if (keyword == "scale")
+	{
+		// A single number or a vector
+		const char* start = mPos;
+		if (gen::ParseText( mPos, mLineEnd, model.scale ))  return Vector( &model.scale );
+		mPos = start;
+		float scale;
+		if (!Float( &scale ))  return false;
+		model.scale = gen::CVector3( scale, scale, scale );
+		return true;
+	}
+	return Error( "Unknown model setting " + string( keyword ) );
+}
+
+bool SceneParser::LightProperty( string_view keyword )
+{
+	SSceneLight& light = mScene->lights.back();
+	if      (keyword == "type")      return Name( LightTypeNames, kNumLightTypes, &light.type, "light type" );
+	else if (keyword == "colour")    return Vector( &light.colour );
+	else if (keyword == "power")     return Float( &light.power );
+	else if (keyword == "direction") return Vector( &light.direction );
+	else if (keyword == "angle")     return Angle( &light.angle );
+	else if (keyword == "position")  return Vector( &light.position );
+	else if (keyword == "scale")     return Float( &light.scale );
+	else if (keyword == "orbit")     return Orbit( &light.orbit );
+	else if (keyword == "animate")
+	{
+		// Animation and its rate: hue cycles need a rate in degrees per second, pulses are optionally
+		// faster or slower than one per pi seconds
+		if (!Name( AnimationNames, kNumAnimations, &light.animation, "light animation" ))  return false;
+		const char* start = mPos;
+		string_view word;
+		light.animationRate = 1.0f;
+		if (!Word( &word ))  return light.animation != kSceneLightHueCycle || Error( "Expected a rate" );
+		mPos = start;
+		return Float( &light.animationRate );
+	}
+	return Error( "Unknown light setting " + string( keyword ) );
+}
+
+bool SceneParser::CameraProperty( string_view keyword )
+{
+	SSceneCamera& camera = mScene->cameras.back();
+	if      (keyword == "position")  return Vector( &camera.position );
+	else if (keyword == "rotation")  return Angles( &camera.rotation );
+	else if (keyword == "fov")       return Angle( &camera.fov );
+	else if (keyword == "near")      return Float( &camera.nearClip );
+	else if (keyword == "far")       return Float( &camera.farClip );
+	else if (keyword == "controls")  return Controls( &camera.controls );
+	return Error( "Unknown camera setting " + string( keyword ) );
+}
+
+bool SceneParser::PortalProperty( string_view keyword )
+{
+	SScenePortal& portal = mScene->portals.back();
+	if      (keyword == "geometry")  return String( &portal.geometry );
+	else if (keyword == "camera")    return Reference( mCameras, "camera", &portal.camera );
+	else if (keyword == "size")      return Unsigned( &portal.width ) && Unsigned( &portal.height );
+	else if (keyword == "position")  return Vector( &portal.position );
+	else if (keyword == "rotation")  return Angles( &portal.rotation );
+	else if (keyword == "controls")  return Controls( &portal.controls );
+	return Error( "Unknown portal setting " + string( keyword ) );
+}
+
+
+///////////////////////////////
+// Loading
+
+// Read a scene from text in memory, fileName is only used in error descriptions
+bool ParseSceneText( const char* text, size_t length, const string& fileName, SceneDescription* scene, string* error )
+{
+	*scene = SceneDescription();
+	scene->backgroundColour = gen::CVector3::kZero;
+	scene->ambientColour = gen::CVector3::kZero;
+	scene->lightGeometry = kNoSceneString;
+	scene->lightMap = kNoSceneString;
+
+	SceneParser parser( text, length, fileName, scene, error );
+	if (!parser.Parse())  return false;
+	if (!ValidateScene( *scene, error ))
+	{
+		if (error)  *error = fileName + ": " + *error;
+		return false;
+	}
+	return true;
+}
+
+// Read a scene from its text form
+bool LoadSceneText( const string& fileName, SceneDescription* scene, string* error )
+{
+	vector<char> text;
+	if (!ReadWholeFile( fileName, &text, error ))  return false;
+	return ParseSceneText( text.empty() ? "" : &text[0], text.size(), fileName, scene, error );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Text form - writing
+//--------------------------------------------------------------------------------------
+
+// Appends a scene in text form to a single buffer, which is written to the file in one go
+class SceneWriter
+{
+public:
+	SceneWriter( const SceneDescription& scene, string* error ) : mScene( scene ), mError( error ), mOk( true ) {}
+
+	bool Write( string* text );
+
+private:
+	void Line( const char* keyword, bool indent = true );
+	void String( unsigned int offset );
+	void Float( float value );
+	void Vector( const gen::CVector3& value );
+	void Angles( const gen::CVector3& radians );
+	void Controls( int index );
+	void Orbit( int index );
+
+	const SceneDescription& mScene;
+	string* mError;
+	string mText;
+	bool mOk;
+};
+
+// Start a line with a keyword, indented for object properties
+void SceneWriter::Line( const char* keyword, bool indent )
+{
+	mText += indent ? "\n  " : "\n";
+	mText += keyword;
+}
+
+// Strings containing spaces or comments are quoted, those that cannot be written at all fail
+void SceneWriter::String( unsigned int offset )
+{
+	const char* text = mScene.String( offset );
+	if (strpbrk( text, "\"\n" ))
+	{
+		mOk = SceneError( mError, string( "Cannot write the name " ) + text );
+		return;
+	}
+	bool quote = *text == '\0' || strpbrk( text, " \t\r#" );
+	mText += ' ';
+	if (quote)  mText += '"';
+	mText += text;
+	if (quote)  mText += '"';
+}
+
+void SceneWriter::Float( float value )
+{
+	char buffer[gen::kMaxTextPerFloat];
+	mText += ' ';
+	mText.append( buffer, gen::FormatText( buffer, buffer + sizeof(buffer), value ) );
+}
+
+void SceneWriter::Vector( const gen::CVector3& value )
+{
+	char buffer[gen::kMaxTextPerFloat * 3];
+	mText += ' ';
+	mText.append( buffer, gen::FormatText( buffer, buffer + sizeof(buffer), value ) );
+}
+
+void SceneWriter::Angles( const gen::CVector3& radians )
+{
+	Vector( gen::CVector3( gen::ToDegrees( radians.x ), gen::ToDegrees( radians.y ), gen::ToDegrees( radians.z ) ) );
+}
+
+void SceneWriter::Controls( int index )
+{
+	if (index == kNoSceneObject)  return;
+	Line( "controls" );
+	mText += ' ';
+	for (int key = 0; key < 8; ++key)
+	{
+		char c = CharFromKey( mScene.controls[index].keys[key] );
+		if (c == 0)
+		{
+			mOk = SceneError( mError, "Cannot write a control key" );
+			return;
+		}
+		mText += c;
+	}
+}
+
+void SceneWriter::Orbit( int index )
+{
+	if (index == kNoSceneObject)  return;
+	const SSceneOrbit& orbit = mScene.orbits[index];
+	Line( "orbit" );
+	String( mScene.models[orbit.centre].name );
+	Float( orbit.radius );
+	Float( gen::ToDegrees( orbit.speed ) );
+}
+
+bool SceneWriter::Write( string* text )
+{
+	mText.clear();
+	mText += "# Scene";
+	Line( "background", false );  Vector( mScene.backgroundColour );
+	Line( "ambient", false );     Vector( mScene.ambientColour );
+	if (mScene.lightGeometry != kNoSceneString)  { Line( "lightmodel", false );  String( mScene.lightGeometry ); }
+	if (mScene.lightMap != kNoSceneString)       { Line( "lightmap", false );    String( mScene.lightMap ); }
+
+	// Objects in the order that references between them need: materials, models, lights, cameras
+	// then portals. Properties at their defaults are still written, so the file shows all settings
+	for (size_t i = 0; i < mScene.materials.size(); ++i)
+	{
+		const SSceneMaterial& material = mScene.materials[i];
+		mText += '\n';
+		Line( "material", false );  String( material.name );
+		Line( "technique" );        mText += ' ';  mText += TechniqueNames[material.technique];
+		if (material.diffuseMap != kNoSceneString)  { Line( "diffuse" );  String( material.diffuseMap ); }
+		if (material.normalMap != kNoSceneString)   { Line( "normal" );   String( material.normalMap ); }
+		Line( "tint" );  Vector( material.tintColour );
+		if (material.effectsAlways)  Line( "effects always" );
+	}
+
+	for (size_t i = 0; i < mScene.models.size(); ++i)
+	{
+		const SSceneModel& model = mScene.models[i];
+		mText += '\n';
+		Line( "model", false );  String( model.name );
+		Line( "geometry" );      String( model.geometry );
+		if (model.material != kNoSceneObject)  { Line( "material" );  String( mScene.materials[model.material].name ); }
+		if (model.flags & kSceneModelTangents)     Line( "tangents" );
+		if (model.flags & kSceneModelProgressive)  Line( "progressive" );
+		Line( "position" );  Vector( model.position );
+		Line( "rotation" );  Angles( model.rotation );
+		Line( "scale" );     Vector( model.scale );
+		Controls( model.controls );
+		Orbit( model.orbit );
+	}
+
+	for (size_t i = 0; i < mScene.lights.size(); ++i)
+	{
+		const SSceneLight& light = mScene.lights[i];
+		mText += '\n';
+		Line( "light", false );  String( light.name );
+		Line( "type" );          mText += ' ';  mText += LightTypeNames[light.type];
+		Line( "colour" );        Vector( light.colour );
+		Line( "power" );         Float( light.power );
+		Line( "direction" );     Vector( light.direction );
+		Line( "angle" );         Float( gen::ToDegrees( light.angle ) );
+		Line( "position" );      Vector( light.position );
+		Line( "scale" );         Float( light.scale );
+		if (light.animation != kSceneLightStill)
+		{
+			Line( "animate" );  mText += ' ';  mText += AnimationNames[light.animation];
+			Float( light.animationRate );
+		}
+		Orbit( light.orbit );
+	}
+
+	for (size_t i = 0; i < mScene.cameras.size(); ++i)
+	{
+		const SSceneCamera& camera = mScene.cameras[i];
+		mText += '\n';
+		Line( "camera", false );  String( camera.name );
+		Line( "position" );       Vector( camera.position );
+		Line( "rotation" );       Angles( camera.rotation );
+		Line( "fov" );            Float( gen::ToDegrees( camera.fov ) );
+		Line( "near" );           Float( camera.nearClip );
+		Line( "far" );            Float( camera.farClip );
+		Controls( camera.controls );
+	}
+
+	for (size_t i = 0; i < mScene.portals.size(); ++i)
+	{
+		const SScenePortal& portal = mScene.portals[i];
+		mText += '\n';
+		Line( "portal", false );  String( portal.name );
+		Line( "geometry" );       String( portal.geometry );
+		Line( "camera" );         String( mScene.cameras[portal.camera].name );
+		Line( "size" );           mText += ' ' + to_string( portal.width ) + ' ' + to_string( portal.height );
+		Line( "position" );       Vector( portal.position );
+		Line( "rotation" );       Angles( portal.rotation );
+		Controls( portal.controls );
+	}
+	mText += '\n';
+
+	text->swap( mText );
+	return mOk;
+}
+
+// Write a scene in text form
+bool SaveSceneText( const string& fileName, const SceneDescription& scene, string* error )
+{
+	if (!ValidateScene( scene, error ))  return false;
+	string text;
+	SceneWriter writer( scene, error );
+	if (!writer.Write( &text ))  return false;
+
+	FILE* file = fopen( fileName.c_str(), "wb" );
+	if (!file)
+	{
+		return SceneError( error, fileName + ": Cannot create file" );
+	}
+	bool ok = fwrite( text.data(), 1, text.size(), file ) == text.size();
+	ok = (fclose( file ) == 0) && ok;
+	return ok || SceneError( error, fileName + ": Cannot write file" );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Binary form
+//--------------------------------------------------------------------------------------
+// A header followed by the scene's arrays exactly as they are in memory, in the order of the
+// header's counts. Element sizes and a byte order mark are stored so a file from another
+// platform, or from a build with different scene structures, is rejected rather than misread
+
+static const char         kBinaryMagic[4] = { 'S', 'C', 'N', 'B' };
+static const unsigned int kBinaryVersion = 1;
+static const unsigned int kByteOrderMark = 0x01020304;
+
+// Arrays in the file, in order
+enum ESceneArray { kStrings, kMaterials, kModels, kLights, kCameras, kPortals, kControls, kOrbits, kNumSceneArrays };
+
+struct SSceneBinaryHeader
+{
+	char          magic[4];
+	unsigned int  version;
+	unsigned int  byteOrder;
+	unsigned int  elementSizes[kNumSceneArrays];
+	unsigned int  counts[kNumSceneArrays];
+	gen::CVector3 backgroundColour;
+	gen::CVector3 ambientColour;
+	unsigned int  lightGeometry;
+	unsigned int  lightMap;
+};
+
+// Sizes of the elements of each array
+static void GetElementSizes( unsigned int* sizes )
+{
+	sizes[kStrings]   = sizeof(char);
+	sizes[kMaterials] = sizeof(SSceneMaterial);
+	sizes[kModels]    = sizeof(SSceneModel);
+	sizes[kLights]    = sizeof(SSceneLight);
+	sizes[kCameras]   = sizeof(SSceneCamera);
+	sizes[kPortals]   = sizeof(SScenePortal);
+	sizes[kControls]  = sizeof(SSceneControls);
+	sizes[kOrbits]    = sizeof(SSceneOrbit);
+}
+
+// Copy an array out of the file data, advancing through the data
+template <class T>
+static void ReadArray( const char*& data, unsigned int count, vector<T>* array )
+{
+	array->resize( count );
+	if (count > 0)  memcpy( &(*array)[0], data, count * sizeof(T) );
+	data += count * sizeof(T);
+}
+
+template <class T>
+static bool WriteArray( FILE* file, const vector<T>& array )
+{
+	return array.empty() || fwrite( &array[0], sizeof(T), array.size(), file ) == array.size();
+}
+
+// Read the compiled binary form of a scene
+bool LoadSceneBinary( const string& fileName, SceneDescription* scene, string* error )
+{
+	vector<char> data;
+	if (!ReadWholeFile( fileName, &data, error ))  return false;
+
+	// Check the header matches this platform and the file holds all the arrays it lists
+	SSceneBinaryHeader header;
+	unsigned int elementSizes[kNumSceneArrays];
+	GetElementSizes( elementSizes );
+	if (data.size() < sizeof(header))
+	{
+		return SceneError( error, fileName + ": Not a compiled scene" );
+	}
+	memcpy( &header, &data[0], sizeof(header) );
+	if (memcmp( header.magic, kBinaryMagic, sizeof(kBinaryMagic) ) != 0 || header.version != kBinaryVersion ||
+	    header.byteOrder != kByteOrderMark || memcmp( header.elementSizes, elementSizes, sizeof(elementSizes) ) != 0)
+	{
+		return SceneError( error, fileName + ": Compiled scene is from another version or platform" );
+	}
+	unsigned long long size = sizeof(header);
+	for (int array = 0; array < kNumSceneArrays; ++array)
+	{
+		size += static_cast<unsigned long long>(header.counts[array]) * elementSizes[array];
+	}
+	if (size != data.size())
+	{
+		return SceneError( error, fileName + ": Compiled scene is the wrong size" );
+	}
+
+	const char* arrays = &data[0] + sizeof(header);
+	scene->backgroundColour = header.backgroundColour;
+	scene->ambientColour = header.ambientColour;
+	scene->lightGeometry = header.lightGeometry;
+	scene->lightMap = header.lightMap;
+	ReadArray( arrays, header.counts[kStrings],   &scene->strings );
+	ReadArray( arrays, header.counts[kMaterials], &scene->materials );
+	ReadArray( arrays, header.counts[kModels],    &scene->models );
+	ReadArray( arrays, header.counts[kLights],    &scene->lights );
+	ReadArray( arrays, header.counts[kCameras],   &scene->cameras );
+	ReadArray( arrays, header.counts[kPortals],   &scene->portals );
+	ReadArray( arrays, header.counts[kControls],  &scene->controls );
+	ReadArray( arrays, header.counts[kOrbits],    &scene->orbits );
+
+	if (!ValidateScene( *scene, error ))
+	{
+		if (error)  *error = fileName + ": " + *error;
+		*scene = SceneDescription();
+		return false;
+	}
+	return true;
+}
+
+// Write the compiled binary form of a scene
+bool SaveSceneBinary( const string& fileName, const SceneDescription& scene, string* error )
+{
+	SSceneBinaryHeader header = {};
+	memcpy( header.magic, kBinaryMagic, sizeof(kBinaryMagic) );
+	header.version = kBinaryVersion;
+	header.byteOrder = kByteOrderMark;
+	GetElementSizes( header.elementSizes );
+	header.counts[kStrings]   = static_cast<unsigned int>(scene.strings.size());
+	header.counts[kMaterials] = static_cast<unsigned int>(scene.materials.size());
+	header.counts[kModels]    = static_cast<unsigned int>(scene.models.size());
+	header.counts[kLights]    = static_cast<unsigned int>(scene.lights.size());
+	header.counts[kCameras]   = static_cast<unsigned int>(scene.cameras.size());
+	header.counts[kPortals]   = static_cast<unsigned int>(scene.portals.size());
+	header.counts[kControls]  = static_cast<unsigned int>(scene.controls.size());
+	header.counts[kOrbits]    = static_cast<unsigned int>(scene.orbits.size());
+	header.backgroundColour = scene.backgroundColour;
+	header.ambientColour = scene.ambientColour;
+	header.lightGeometry = scene.lightGeometry;
+	header.lightMap = scene.lightMap;
+
+	FILE* file = fopen( fileName.c_str(), "wb" );
+	if (!file)
+	{
+		return SceneError( error, fileName + ": Cannot create file" );
+	}
+	bool ok = fwrite( &header, sizeof(header), 1, file ) == 1 &&
+	          WriteArray( file, scene.strings ) && WriteArray( file, scene.materials ) &&
+	          WriteArray( file, scene.models ) && WriteArray( file, scene.lights ) &&
+	          WriteArray( file, scene.cameras ) && WriteArray( file, scene.portals ) &&
+	          WriteArray( file, scene.controls ) && WriteArray( file, scene.orbits );
+	ok = (fclose( file ) == 0) && ok;
+	if (!ok)
+	{
+		remove( fileName.c_str() ); // Do not leave a partial file to be loaded next time
+		return SceneError( error, fileName + ": Cannot write file" );
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Loading
+//--------------------------------------------------------------------------------------
+
+// Load a scene, using its compiled binary form if that is at least as new as the text form
+bool LoadScene( const string& textFileName, const string& binaryFileName, SceneDescription* scene, string* error )
+{
+	// A binary form that is missing, out of date or unreadable (e.g. written by another platform)
+	// is rebuilt from the text. Failing to write it is not an error, the text is read each time
+	error_code textTimeError, binaryTimeError;
+	filesystem::file_time_type textTime = filesystem::last_write_time( textFileName, textTimeError );
+	filesystem::file_time_type binaryTime = filesystem::last_write_time( binaryFileName, binaryTimeError );
+	if (!binaryTimeError && (textTimeError || binaryTime >= textTime) && LoadSceneBinary( binaryFileName, scene ))
+	{
+		return true;
+	}
+
+	if (!LoadSceneText( textFileName, scene, error ))  return false;
+	SaveSceneBinary( binaryFileName, *scene );
+	return true;
+}
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------------------
+//	Scene description files - the models, materials, lights, cameras and portal of a
+//	scene, kept out of the code so the scene can be changed without recompiling.
+//	Scenes are written in a text form (.scene) and compiled to a binary form (.sceneb)
+//	that loads with a single read
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_SCENE_FILE_H_INCLUDED
+#define CO2409_SCENE_FILE_H_INCLUDED
+
+#include "CVector3.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+//--------------------------------------------------------------------------------------
+// Scene description
+//--------------------------------------------------------------------------------------
+// All the elements are plain data with no pointers, so the binary form is just the arrays
+// below written out in turn. Names and file names are offsets into a single table of null
+// terminated strings, each different string stored once, so a scene of any size needs no
+// allocation per object. Objects refer to each other by index, and a text scene can only
+// refer to objects declared above the reference, so it is read in one pass
+
+// Types of light and techniques to render with, also used by the scene itself
+enum ELightType { point, directional, spot };
+enum EID3D10EffectTechnique { Parallax, VertexLit, AdditiveTintTex, VertexAdditive };
+
+// Offset of no string, and index of no object
+const unsigned int kNoSceneString = 0xffffffff;
+const int          kNoSceneObject = -1;
+
+// Keys to turn and move an object with, in the order of Model::Control (up, down, left, right,
+// clockwise, anti-clockwise, forward, backward). Key codes as EKeyCode in Input.h
+struct SSceneControls
+{
+	unsigned int keys[8];
+};
+
+// Circular path around another model, in the XZ plane
+struct SSceneOrbit
+{
+	int   centre; // Index of the model at the centre
+	float radius;
+	float speed;  // Radians per second
+};
+
+// Textures and technique shared by any number of models
+struct SSceneMaterial
+{
+	unsigned int  name;
+	unsigned int  diffuseMap; // Diffuse/specular map, kNoSceneString if none
+	unsigned int  normalMap;  // Normal/depth map, kNoSceneString if none
+	unsigned int  technique;  // EID3D10EffectTechnique
+	gen::CVector3 tintColour;
+	unsigned int  effectsAlways; // Non-zero to apply the mover and wiggle effects even when they are switched off
+};
+
+// Model flags
+const unsigned int kSceneModelTangents    = 1; // Generate tangents (for normal or parallax mapping)
+const unsigned int kSceneModelProgressive = 2; // Show the geometry progressively as it loads (for large models)
+
+struct SSceneModel
+{
+	unsigned int  name;
+	unsigned int  geometry; // File name
+	int           material;
+	unsigned int  flags;
+	gen::CVector3 position;
+	gen::CVector3 rotation; // Radians
+	gen::CVector3 scale;
+	int           controls; // Index into the controls, kNoSceneObject if none
+	int           orbit;    // Index into the orbits, kNoSceneObject if none
+};
+
+// Light animations
+enum ESceneLightAnimation
+{
+	kSceneLightStill,
+	kSceneLightPulse,    // Colour brightens and fades
+	kSceneLightHueCycle, // Hue of the colour rotates, at the given animation rate
+};
+
+struct SSceneLight
+{
+	unsigned int  name;
+	unsigned int  type; // ELightType
+	gen::CVector3 colour;
+	float         power;
+	gen::CVector3 direction; // Directional and spot lights
+	float         angle;     // Spot lights, radians
+	gen::CVector3 position;
+	float         scale;     // Size of the model displaying the light
+	unsigned int  animation; // ESceneLightAnimation
+	float         animationRate;
+	int           orbit;
+};
+
+struct SSceneCamera
+{
+	unsigned int  name;
+	gen::CVector3 position;
+	gen::CVector3 rotation; // Radians
+	float         fov;      // Radians
+	float         nearClip;
+	float         farClip;
+	int           controls;
+};
+
+// Model showing the view of another camera, rendered to a texture of the given size
+struct SScenePortal
+{
+	unsigned int  name;
+	unsigned int  geometry;
+	int           camera;
+	unsigned int  width;
+	unsigned int  height;
+	gen::CVector3 position;
+	gen::CVector3 rotation; // Radians
+	int           controls;
+};
+
+// A complete scene. The first camera is the main view
+struct SceneDescription
+{
+	gen::CVector3 backgroundColour;
+	gen::CVector3 ambientColour;
+	unsigned int  lightGeometry; // Model and texture displayed at each light
+	unsigned int  lightMap;
+
+	vector<char>           strings;
+	vector<SSceneMaterial> materials;
+	vector<SSceneModel>    models;
+	vector<SSceneLight>    lights;
+	vector<SSceneCamera>   cameras;
+	vector<SScenePortal>   portals;
+	vector<SSceneControls> controls;
+	vector<SSceneOrbit>    orbits;
+
+	// The string at the given offset, "" for kNoSceneString
+	const char* String( unsigned int offset ) const
+	{
+		return offset == kNoSceneString ? "" : &strings[offset];
+	}
+};
+
+
+//--------------------------------------------------------------------------------------
+// Loading / saving
+//--------------------------------------------------------------------------------------
+// Errors are returned as false with a description of the problem in error (for text files the
+// description gives the line number). The description is unchanged on success
+
+// Load a scene, using its compiled binary form if that is at least as new as the text form.
+// Otherwise the text form is read and the binary form is written for next time
+bool LoadScene( const string& textFileName, const string& binaryFileName, SceneDescription* scene, string* error = NULL );
+
+// Read a scene from its text form
+bool LoadSceneText( const string& fileName, SceneDescription* scene, string* error = NULL );
+
+// Read a scene from text in memory, fileName is only used in error descriptions
+bool ParseSceneText( const char* text, size_t length, const string& fileName, SceneDescription* scene, string* error = NULL );
+
+// Write a scene in text form. Floats are written with the fewest digits that read back to the same
+// value, but angles are written in degrees so may differ in the last bit when read back
+bool SaveSceneText( const string& fileName, const SceneDescription& scene, string* error = NULL );
+
+// Read / write the compiled binary form of a scene. The binary form is specific to the platform
+// that wrote it, a file from another platform or version fails to load (so is rebuilt by LoadScene)
+bool LoadSceneBinary( const string& fileName, SceneDescription* scene, string* error = NULL );
+bool SaveSceneBinary( const string& fileName, const SceneDescription& scene, string* error = NULL );
+
+
+#endif // End of header guard (see top of file)
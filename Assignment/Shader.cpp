@@ -50,9 +50,12 @@ ID3D10EffectVectorVariable* AmbientColourVar = NULL;
 ID3D10EffectVectorVariable* CameraPosVar     = NULL; // Camera position used for specular light
 ID3D10EffectScalarVariable* SpecularPowerVar = NULL;
 
-// Textures - two textures in the pixel shader now - diffuse/specular map and normal/depth map
-ID3D10EffectShaderResourceVariable* DiffuseMapVar = NULL;
-ID3D10EffectShaderResourceVariable* NormalMapVar  = NULL;
+// Textures - three textures in the pixel shader now - diffuse/specular map, normal map and depth map
+ID3D10EffectShaderResourceVariable* DiffuseMapVar   = NULL;
+ID3D10EffectShaderResourceVariable* NormalMapVar    = NULL;
+ID3D10EffectShaderResourceVariable* DepthMapVar     = NULL;
+ID3D10EffectScalarVariable*         DiffuseSliceVar = NULL; // The maps are texture arrays, these select the slice to use
+ID3D10EffectScalarVariable*         NormalSliceVar  = NULL;
 
 // Miscellaneous variables to send values from C++ to shaders
 ID3D10EffectScalarVariable* ParallaxDepthVar = NULL; // To set the depth of the parallax mapping effect
@@ -128,9 +131,12 @@ bool InitShaders()
 	TintColourVar    = Effect->GetVariableByName( "TintColour"    )->AsVector();
 
 	// Also access the texture used in the shader in the same way (note that this variable is a "Shader Resource")
-	// Both diffuse and normal maps have variables
+	// Diffuse, normal and depth maps all have variables
 	DiffuseMapVar    = Effect->GetVariableByName("DiffuseMap"     )->AsShaderResource();
 	NormalMapVar     = Effect->GetVariableByName("NormalMap"      )->AsShaderResource();
+	DepthMapVar      = Effect->GetVariableByName("DepthMap"       )->AsShaderResource();
+	DiffuseSliceVar  = Effect->GetVariableByName("DiffuseSlice"   )->AsScalar();
+	NormalSliceVar   = Effect->GetVariableByName("NormalSlice"    )->AsScalar();
 
 	// Effects
 	MoverVar         = Effect->GetVariableByName("Mover"          )->AsScalar();
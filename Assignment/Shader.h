@@ -47,6 +47,9 @@ extern ID3D10EffectScalarVariable* SpecularPowerVar;
 // Textures - variables used to send values from C++ to shader (fx file) variables
 extern ID3D10EffectShaderResourceVariable* DiffuseMapVar;
 extern ID3D10EffectShaderResourceVariable* NormalMapVar;
+extern ID3D10EffectShaderResourceVariable* DepthMapVar;
+extern ID3D10EffectScalarVariable*         DiffuseSliceVar; // The maps are texture arrays, these select the slice to use
+extern ID3D10EffectScalarVariable*         NormalSliceVar;
 
 // Miscellaneous variables to send values from C++ to shaders 
 extern ID3D10EffectScalarVariable* ParallaxDepthVar;
@@ -0,0 +1,146 @@
+//--------------------------------------------------------------------------------------
+//	Creation of Direct3D textures from images loaded into memory (see Image\Image.h)
+//--------------------------------------------------------------------------------------
+
+#include "Texture.h"
+#include "Device.h"
+
+// Create a texture from a loaded image and return a shader resource view of it
+bool CreateTexture( const Image& image, ID3D10ShaderResourceView** textureView, unsigned int firstMip )
+{
+	*textureView = NULL;
+	if (firstMip >= image.mips.size())
+	{
+		return false;
+	}
+
+	// Single level uncompressed images get a full mip chain, which needs the texture to be usable as
+	// a render target. Images that already have mip levels are used as they are
+	bool generateMips = image.mips.size() == 1 && !IsBlockCompressed( image.format );
+	unsigned int numMips = static_cast<unsigned int>(image.mips.size()) - firstMip;
+	if (generateMips)
+	{
+		numMips = 1;
+		for (unsigned int size = max( image.width, image.height ); size > 1; size /= 2)  ++numMips;
+	}
+
+	D3D10_TEXTURE2D_DESC textureDesc;
+	textureDesc.Width = image.mips[firstMip].width;
+	textureDesc.Height = image.mips[firstMip].height;
+	textureDesc.MipLevels = numMips;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = static_cast<DXGI_FORMAT>(image.format); // Image formats use DXGI values
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D10_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D10_BIND_SHADER_RESOURCE | (generateMips ? D3D10_BIND_RENDER_TARGET : 0);
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = generateMips ? D3D10_RESOURCE_MISC_GENERATE_MIPS : 0;
+
+	// Initial data must be given for every mip level or none, so when generating mips the top level
+	// is uploaded after creation
+	D3D10_SUBRESOURCE_DATA initData[16];
+	for (unsigned int mip = 0; mip < numMips && mip < 16; ++mip)
+	{
+		initData[mip].pSysMem = image.MipData( firstMip + mip );
+		initData[mip].SysMemPitch = image.mips[firstMip + mip].rowPitch;
+		initData[mip].SysMemSlicePitch = 0;
+	}
+	ID3D10Texture2D* texture;
+	if (FAILED( Device->CreateTexture2D( &textureDesc, generateMips ? NULL : initData, &texture ) ))
+	{
+		return false;
+	}
+	if (generateMips)
+	{
+		Device->UpdateSubresource( texture, 0, NULL, image.MipData( 0 ), image.mips[0].rowPitch, 0 );
+	}
+
+	// The view covers all mip levels
+	D3D10_SHADER_RESOURCE_VIEW_DESC viewDesc;
+	viewDesc.Format = textureDesc.Format;
+	viewDesc.ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2D;
+	viewDesc.Texture2D.MostDetailedMip = 0;
+	viewDesc.Texture2D.MipLevels = numMips;
+	HRESULT result = Device->CreateShaderResourceView( texture, &viewDesc, textureView );
+	texture->Release(); // The view holds a reference to the texture
+	if (FAILED( result ))
+	{
+		*textureView = NULL;
+		return false;
+	}
+
+	if (generateMips)
+	{
+		Device->GenerateMips( *textureView );
+	}
+	return true;
+}
+
+// Create a texture array from loaded images, one image in each slice, and return a shader resource
+// view of the whole array
+bool CreateTextureArray( const vector<const Image*>& images, ID3D10ShaderResourceView** textureView, unsigned int firstMip )
+{
+	*textureView = NULL;
+	if (images.empty() || firstMip >= images[0]->mips.size())
+	{
+		return false;
+	}
+	const Image& first = *images[0];
+	for (size_t slice = 1; slice < images.size(); ++slice)
+	{
+		if (images[slice]->format != first.format || images[slice]->width != first.width ||
+		    images[slice]->height != first.height || images[slice]->mips.size() != first.mips.size())
+		{
+			return false;
+		}
+	}
+
+	unsigned int numMips = static_cast<unsigned int>(first.mips.size()) - firstMip;
+	D3D10_TEXTURE2D_DESC textureDesc;
+	textureDesc.Width = first.mips[firstMip].width;
+	textureDesc.Height = first.mips[firstMip].height;
+	textureDesc.MipLevels = numMips;
+	textureDesc.ArraySize = static_cast<unsigned int>(images.size());
+	textureDesc.Format = static_cast<DXGI_FORMAT>(first.format);
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D10_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D10_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	// Initial data is given for each mip level of the first slice, then each level of the next etc.
+	vector<D3D10_SUBRESOURCE_DATA> initData( images.size() * numMips );
+	for (size_t slice = 0; slice < images.size(); ++slice)
+	{
+		for (unsigned int mip = 0; mip < numMips; ++mip)
+		{
+			D3D10_SUBRESOURCE_DATA& data = initData[D3D10CalcSubresource( mip, static_cast<unsigned int>(slice), numMips )];
+			data.pSysMem = images[slice]->MipData( firstMip + mip );
+			data.SysMemPitch = images[slice]->mips[firstMip + mip].rowPitch;
+			data.SysMemSlicePitch = 0;
+		}
+	}
+	ID3D10Texture2D* texture;
+	if (FAILED( Device->CreateTexture2D( &textureDesc, &initData[0], &texture ) ))
+	{
+		return false;
+	}
+
+	D3D10_SHADER_RESOURCE_VIEW_DESC viewDesc;
+	viewDesc.Format = textureDesc.Format;
+	viewDesc.ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2DARRAY;
+	viewDesc.Texture2DArray.MostDetailedMip = 0;
+	viewDesc.Texture2DArray.MipLevels = numMips;
+	viewDesc.Texture2DArray.FirstArraySlice = 0;
+	viewDesc.Texture2DArray.ArraySize = textureDesc.ArraySize;
+	HRESULT result = Device->CreateShaderResourceView( texture, &viewDesc, textureView );
+	texture->Release(); // The view holds a reference to the texture
+	if (FAILED( result ))
+	{
+		*textureView = NULL;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,26 @@
+//--------------------------------------------------------------------------------------
+//	Creation of Direct3D textures from images loaded into memory (see Image\Image.h)
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_TEXTURE_H_INCLUDED
+#define CO2409_TEXTURE_H_INCLUDED
+
+#include <d3d10.h>
+#include "Image.h"
+
+// Create a texture from a loaded image and return a shader resource view of it. The mip levels in
+// the image from firstMip down are used, so a texture can be created without its most detailed
+// levels (the texture is then smaller than the image). Uncompressed images with a single level get
+// a full mip chain generated on the GPU, as D3DX did when loading texture files. Returns false if
+// the image is empty, firstMip is not one of its levels or creation fails
+bool CreateTexture( const Image& image, ID3D10ShaderResourceView** textureView, unsigned int firstMip = 0 );
+
+// Create a texture array from loaded images, one image in each slice, and return a shader resource
+// view of the whole array. The images must have the same size, format and number of mip levels, the
+// levels from firstMip down are used (mips are not generated). Returns false if there are no images,
+// they do not match or creation fails
+bool CreateTextureArray( const vector<const Image*>& images, ID3D10ShaderResourceView** textureView, unsigned int firstMip = 0 );
+
+
+#endif // End of header guard (see top of file)
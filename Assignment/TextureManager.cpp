@@ -0,0 +1,621 @@
+//--------------------------------------------------------------------------------------
+//	The texture manager keeps the scene's texture maps within a memory budget. Textures of the
+//	same size and format are packed into texture arrays, so models with different textures can
+//	be drawn without binding a new texture. Each array only has the mip levels its textures
+//	need on the GPU, decided by the on-screen size of the models using them. More detailed
+//	levels are streamed in from file on a background thread and the least recently used arrays
+//	give up their detail when the budget is full
+//--------------------------------------------------------------------------------------
+
+#include "TextureManager.h"
+#include "Device.h"
+#include "Texture.h"
+#include "ImageCompress.h"
+#include "ImageMips.h"
+#include <algorithm>
+#include <float.h>
+
+// Most arrays loading in the background at once. Kept low so the detail loaded is decided by
+// recent requests rather than a long queue of old ones
+static const unsigned int MAX_LOADS_IN_PROGRESS = 2;
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - textures on the GPU are kept within the given number of bytes where possible
+TextureManager::TextureManager( size_t budget, unsigned int tailSize )
+{
+	mBudget = budget;
+	mResidentBytes = 0;
+	mReservedBytes = 0;
+	mTailSize = tailSize;
+	mFrame = 0;
+
+	mStopLoading = false;
+	mLoadsInProgress = 0;
+	mLoadThread = thread( [this]() { BackgroundLoad(); } );
+}
+
+// Destructor - stops any background loading and releases all textures
+TextureManager::~TextureManager()
+{
+	{
+		lock_guard<mutex> lock( mLoadMutex );
+		mStopLoading = true;
+	}
+	mLoadSignal.notify_all();
+	if (mLoadThread.joinable())  mLoadThread.join();
+
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		for (int map = 0; map < MAX_MAPS; ++map)
+		{
+			if (mArrays[i].views[map])  mArrays[i].views[map]->Release();
+		}
+	}
+}
+
+
+/////////////////////////////
+// Texture loading
+
+// Add a texture file of the given kind, returning an identifier for the texture
+int TextureManager::Add( const string& fileName, MapType type )
+{
+	for (unsigned int i = 0; i < mTextures.size(); ++i)
+	{
+		if (mTextures[i].fileName == fileName && mTextures[i].type == type)
+		{
+			return i;
+		}
+	}
+
+	Texture texture;
+	texture.fileName = fileName;
+	texture.type = type;
+	texture.array = -1;
+	texture.slice = 0;
+	texture.uvPerPixel = FLT_MAX;
+	mTextures.push_back( texture );
+	return static_cast<int>(mTextures.size()) - 1;
+}
+
+// Load all added textures, with as much detail as fits in the budget
+bool TextureManager::LoadAll()
+{
+	// Decode the files in parallel
+	vector<string> fileNames;
+	for (unsigned int i = 0; i < mTextures.size(); ++i)
+	{
+		fileNames.push_back( mTextures[i].fileName );
+	}
+	vector<Image> sources;
+	bool success = LoadImageFiles( fileNames, &sources );
+
+	// Mip chains for uncompressed files are made together, diffuse maps filtered in linear colour
+	// space and normal maps renormalised with the depth filtered separately. Compressed files keep
+	// their own mips
+	vector<Image*> mipImages;
+	vector<MipContent> mipContents;
+	for (unsigned int i = 0; i < mTextures.size(); ++i)
+	{
+		if (sources[i].format == ImageFormatRGBA8 && sources[i].mips.size() == 1)
+		{
+			mipImages.push_back( &sources[i] );
+			mipContents.push_back( mTextures[i].type == DiffuseSpecular ? MipContentColour : MipContentNormalDepth );
+		}
+	}
+	GenerateMips( mipImages, mipContents );
+
+	// Compress the maps and pack the textures into arrays
+	vector<Image> maps( mTextures.size() * MAX_MAPS );
+	for (unsigned int i = 0; i < mTextures.size(); ++i)
+	{
+		if (sources[i].mips.empty() || !PrepareMaps( sources[i], mTextures[i].type, &maps[i * MAX_MAPS], 0 ))
+		{
+			success = false;
+			continue;
+		}
+		sources[i] = Image(); // Free the source as we go
+		PackTexture( i, &maps[i * MAX_MAPS] );
+	}
+
+	// Start with full detail in every array, then drop the most detailed level of the largest array
+	// until they all fit in the budget
+	size_t totalBytes = 0;
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		totalBytes += ArrayBytes( mArrays[i], 0 );
+	}
+	while (totalBytes > mBudget)
+	{
+		int largest = -1;
+		size_t largestBytes = 0;
+		for (unsigned int i = 0; i < mArrays.size(); ++i)
+		{
+			const TextureArray& array = mArrays[i];
+			size_t bytes = ArrayBytes( array, array.residentMip );
+			if (array.residentMip < array.tailMip && bytes > largestBytes)
+			{
+				largest = i;
+				largestBytes = bytes;
+			}
+		}
+		if (largest < 0)
+		{
+			break; // Only the tail levels are left, which are kept however full the budget
+		}
+		TextureArray& array = mArrays[largest];
+		totalBytes -= largestBytes - ArrayBytes( array, array.residentMip + 1 );
+		++array.residentMip;
+	}
+
+	// Create the arrays with the chosen detail, gathering the maps of each slice
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		TextureArray& array = mArrays[i];
+		vector<Image> arrayMaps( array.textures.size() * MAX_MAPS );
+		for (unsigned int slice = 0; slice < array.textures.size(); ++slice)
+		{
+			for (int map = 0; map < MAX_MAPS; ++map)
+			{
+				swap( arrayMaps[slice * MAX_MAPS + map], maps[array.textures[slice] * MAX_MAPS + map] );
+			}
+		}
+		if (!CreateViews( array, arrayMaps, array.residentMip ))
+		{
+			array.failed = true;
+			success = false;
+		}
+	}
+	return success;
+}
+
+
+/////////////////////////////
+// Streaming
+
+// Request detail for a texture this frame, given the distance in texture coordinates a single
+// pixel covers where the texture is seen closest
+void TextureManager::Request( int texture, float uvPerPixel )
+{
+	if (texture < 0 || texture >= static_cast<int>(mTextures.size()))
+	{
+		return;
+	}
+	if (uvPerPixel < mTextures[texture].uvPerPixel)  mTextures[texture].uvPerPixel = uvPerPixel;
+}
+
+// Update textures once per frame: use any newly loaded detail, then start loading the detail
+// requested since the last update
+bool TextureManager::Update()
+{
+	bool success = true;
+
+	// Create textures for loads finished in the background. The space for them was reserved when the
+	// load started, even if the detail is no longer needed it is used until the space is wanted
+	vector<LoadJob> finishedLoads;
+	{
+		lock_guard<mutex> lock( mLoadMutex );
+		finishedLoads.swap( mFinishedLoads );
+	}
+	for (unsigned int i = 0; i < finishedLoads.size(); ++i)
+	{
+		LoadJob& job = finishedLoads[i];
+		TextureArray& array = mArrays[job.array];
+		mReservedBytes -= job.reservedBytes;
+		--mLoadsInProgress;
+		array.loading = false;
+		if (!job.success || !CreateViews( array, job.maps, job.firstMip ))
+		{
+			array.failed = true;
+			success = false;
+		}
+	}
+
+	// Work out the detail each array needs from the requests for its textures since the last update.
+	// Arrays not requested only need their tail, but keep their detail until the space is needed
+	vector<int> needDetail;
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		TextureArray& array = mArrays[i];
+		array.wantedMip = array.tailMip;
+		for (unsigned int slice = 0; slice < array.textures.size(); ++slice)
+		{
+			Texture& texture = mTextures[array.textures[slice]];
+			if (texture.uvPerPixel != FLT_MAX)
+			{
+				array.wantedMip = min( array.wantedMip, MipForUVs( array, texture.uvPerPixel ) );
+				array.lastUsedFrame = mFrame;
+				texture.uvPerPixel = FLT_MAX;
+			}
+		}
+		if (array.wantedMip < array.residentMip && array.views[0] && !array.loading && !array.failed)
+		{
+			needDetail.push_back( i );
+		}
+	}
+
+	// Start loading the arrays furthest from the detail they need. If the budget is too full even
+	// after evicting unneeded detail, load as much as fits
+	sort( needDetail.begin(), needDetail.end(), [this]( int a, int b )
+	{
+		return mArrays[a].residentMip - mArrays[a].wantedMip > mArrays[b].residentMip - mArrays[b].wantedMip;
+	});
+	for (unsigned int i = 0; i < needDetail.size() && mLoadsInProgress < MAX_LOADS_IN_PROGRESS; ++i)
+	{
+		TextureArray& array = mArrays[needDetail[i]];
+		size_t residentBytes = ArrayBytes( array, array.residentMip );
+		for (unsigned int mip = array.wantedMip; mip < array.residentMip; ++mip)
+		{
+			size_t extraBytes = ArrayBytes( array, mip ) - residentBytes;
+			if (MakeSpace( extraBytes, needDetail[i] ))
+			{
+				StartLoad( needDetail[i], mip, extraBytes );
+				break;
+			}
+		}
+	}
+
+	++mFrame;
+	return success;
+}
+
+
+/////////////////////////////
+// Usage
+
+// Shader resource view of the texture array holding a texture's map
+ID3D10ShaderResourceView* TextureManager::Map( int texture, int map )
+{
+	int array = Array( texture );
+	if (array < 0 || map < 0 || map >= MAX_MAPS)
+	{
+		return NULL;
+	}
+	return mArrays[array].views[map];
+}
+
+// Slice of its texture array holding a texture
+unsigned int TextureManager::Slice( int texture )
+{
+	if (texture < 0 || texture >= static_cast<int>(mTextures.size()))
+	{
+		return 0;
+	}
+	return mTextures[texture].slice;
+}
+
+// Texture array holding a texture, -1 if the texture has not loaded
+int TextureManager::Array( int texture )
+{
+	if (texture < 0 || texture >= static_cast<int>(mTextures.size()))
+	{
+		return -1;
+	}
+	return mTextures[texture].array;
+}
+
+// Most detailed mip level of a texture currently on the GPU
+unsigned int TextureManager::ResidentMip( int texture )
+{
+	int array = Array( texture );
+	return array < 0 ? 0 : mArrays[array].residentMip;
+}
+
+
+/////////////////////////////
+// Private functions
+
+// Prepare the compressed maps with full mip chains for a loaded texture file
+bool TextureManager::PrepareMaps( const Image& source, MapType type, Image* maps, unsigned int numThreads )
+{
+	if (type == DiffuseSpecular)
+	{
+		return CompressDiffuseSpecular( source, &maps[0], numThreads );
+	}
+	return CompressNormalDepth( source, &maps[0], &maps[1], numThreads );
+}
+
+// Add a texture to the array holding others of the same kind, size and formats, or a new array
+void TextureManager::PackTexture( int texture, const Image* maps )
+{
+	MapType type = mTextures[texture].type;
+	unsigned int numMaps = type == NormalDepth ? 2 : 1;
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		TextureArray& array = mArrays[i];
+		bool matches = array.type == type && array.width == maps[0].width && array.height == maps[0].height &&
+		               array.numMips == maps[0].mips.size();
+		for (unsigned int map = 0; map < numMaps && matches; ++map)
+		{
+			matches = array.formats[map] == maps[map].format;
+		}
+		if (matches)
+		{
+			mTextures[texture].array = i;
+			mTextures[texture].slice = static_cast<unsigned int>(array.textures.size());
+			array.textures.push_back( texture );
+			return;
+		}
+	}
+
+	TextureArray array;
+	array.type = type;
+	array.width = maps[0].width;
+	array.height = maps[0].height;
+	array.numMips = static_cast<unsigned int>(maps[0].mips.size());
+	array.numMaps = numMaps;
+	for (int map = 0; map < MAX_MAPS; ++map)
+	{
+		array.formats[map] = map < static_cast<int>(numMaps) ? maps[map].format : ImageFormatUnknown;
+		array.views[map] = NULL;
+	}
+	array.textures.push_back( texture );
+
+	// The tail starts at the first level no larger than the tail size. An array's most detailed level
+	// must be a whole number of blocks for block compressed formats, so the tail may start earlier
+	// for narrow textures
+	array.tailMip = 0;
+	while (array.tailMip + 1 < array.numMips && max( array.width, array.height ) >> array.tailMip > mTailSize)
+	{
+		++array.tailMip;
+	}
+	while (array.tailMip > 0 && IsBlockCompressed( array.formats[0] ) &&
+	       (((array.width >> array.tailMip) & 3) != 0 || ((array.height >> array.tailMip) & 3) != 0))
+	{
+		--array.tailMip;
+	}
+	array.residentMip = 0;
+	array.wantedMip = 0;
+	array.lastUsedFrame = 0;
+	array.loading = false;
+	array.failed = false;
+
+	mTextures[texture].array = static_cast<int>(mArrays.size());
+	mTextures[texture].slice = 0;
+	mArrays.push_back( array );
+}
+
+// Bytes on the GPU for all maps of an array with levels from firstMip down
+size_t TextureManager::ArrayBytes( const TextureArray& array, unsigned int firstMip )
+{
+	size_t bytes = 0;
+	for (unsigned int map = 0; map < array.numMaps; ++map)
+	{
+		for (unsigned int mip = firstMip; mip < array.numMips; ++mip)
+		{
+			unsigned int width = max( array.width >> mip, 1u );
+			unsigned int height = max( array.height >> mip, 1u );
+			bytes += static_cast<size_t>(ImageRowPitch( array.formats[map], width )) * ImageRowCount( array.formats[map], height );
+		}
+	}
+	return bytes * array.textures.size();
+}
+
+// Most detailed mip level needed when a pixel covers the given distance in texture coordinates.
+// The GPU samples the level where a pixel covers about one texel, blending towards the more
+// detailed level when it covers less than two
+unsigned int TextureManager::MipForUVs( const TextureArray& array, float uvPerPixel )
+{
+	if (uvPerPixel <= 0.0f)
+	{
+		return 0;
+	}
+	float texelsPerPixel = uvPerPixel * max( array.width, array.height );
+	unsigned int mip = 0;
+	while (texelsPerPixel >= 2.0f && mip < array.tailMip)
+	{
+		texelsPerPixel *= 0.5f;
+		++mip;
+	}
+	return mip;
+}
+
+// Create the views of an array from the prepared maps of each slice, with levels from firstMip down
+bool TextureManager::CreateViews( TextureArray& array, const vector<Image>& maps, unsigned int firstMip )
+{
+	// The files must still match the array, in case they changed since it was created
+	ID3D10ShaderResourceView* views[MAX_MAPS] = { NULL, NULL };
+	bool success = maps.size() == array.textures.size() * MAX_MAPS;
+	for (unsigned int map = 0; map < array.numMaps && success; ++map)
+	{
+		vector<const Image*> images;
+		for (unsigned int slice = 0; slice < array.textures.size() && success; ++slice)
+		{
+			const Image& image = maps[slice * MAX_MAPS + map];
+			success = image.format == array.formats[map] && image.width == array.width && image.height == array.height &&
+			          image.mips.size() == array.numMips;
+			images.push_back( &image );
+		}
+		success = success && CreateTextureArray( images, &views[map], firstMip );
+	}
+	if (!success)
+	{
+		for (int map = 0; map < MAX_MAPS; ++map)
+		{
+			if (views[map])  views[map]->Release();
+		}
+		return false;
+	}
+	SetViews( array, views, firstMip );
+	return true;
+}
+
+// Replace an array's views with new ones holding levels from firstMip down
+void TextureManager::SetViews( TextureArray& array, ID3D10ShaderResourceView** views, unsigned int firstMip )
+{
+	if (array.views[0])  mResidentBytes -= ArrayBytes( array, array.residentMip );
+	for (int map = 0; map < MAX_MAPS; ++map)
+	{
+		if (array.views[map])  array.views[map]->Release();
+		array.views[map] = views[map];
+	}
+	array.residentMip = firstMip;
+	mResidentBytes += ArrayBytes( array, firstMip );
+}
+
+// Drop an array's levels above the given one by copying the rest into smaller textures on the GPU
+bool TextureManager::Evict( TextureArray& array, unsigned int firstMip )
+{
+	ID3D10ShaderResourceView* views[MAX_MAPS] = { NULL, NULL };
+	bool success = true;
+	for (unsigned int map = 0; map < array.numMaps && success; ++map)
+	{
+		ID3D10Resource* resource;
+		array.views[map]->GetResource( &resource );
+		ID3D10Texture2D* oldTexture = static_cast<ID3D10Texture2D*>(resource);
+
+		// Same texture settings apart from the size and number of levels
+		D3D10_TEXTURE2D_DESC textureDesc;
+		oldTexture->GetDesc( &textureDesc );
+		unsigned int oldMips = textureDesc.MipLevels;
+		textureDesc.Width = max( array.width >> firstMip, 1u );
+		textureDesc.Height = max( array.height >> firstMip, 1u );
+		textureDesc.MipLevels = array.numMips - firstMip;
+		ID3D10Texture2D* newTexture;
+		success = SUCCEEDED( Device->CreateTexture2D( &textureDesc, NULL, &newTexture ) );
+		if (success)
+		{
+			for (unsigned int slice = 0; slice < textureDesc.ArraySize; ++slice)
+			{
+				for (unsigned int mip = 0; mip < textureDesc.MipLevels; ++mip)
+				{
+					Device->CopySubresourceRegion( newTexture, D3D10CalcSubresource( mip, slice, textureDesc.MipLevels ), 0, 0, 0, oldTexture,
+					                               D3D10CalcSubresource( mip + firstMip - array.residentMip, slice, oldMips ), NULL );
+				}
+			}
+			D3D10_SHADER_RESOURCE_VIEW_DESC viewDesc;
+			viewDesc.Format = textureDesc.Format;
+			viewDesc.ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2DARRAY;
+			viewDesc.Texture2DArray.MostDetailedMip = 0;
+			viewDesc.Texture2DArray.MipLevels = textureDesc.MipLevels;
+			viewDesc.Texture2DArray.FirstArraySlice = 0;
+			viewDesc.Texture2DArray.ArraySize = textureDesc.ArraySize;
+			success = SUCCEEDED( Device->CreateShaderResourceView( newTexture, &viewDesc, &views[map] ) );
+			newTexture->Release(); // The view holds a reference to the texture
+		}
+		oldTexture->Release();
+	}
+	if (!success)
+	{
+		for (int map = 0; map < MAX_MAPS; ++map)
+		{
+			if (views[map])  views[map]->Release();
+		}
+		return false;
+	}
+	SetViews( array, views, firstMip );
+	return true;
+}
+
+// Evict detail that other arrays no longer need until the given number of bytes fits in the
+// budget, least recently used arrays first
+bool TextureManager::MakeSpace( size_t bytes, int forArray )
+{
+	if (mResidentBytes + mReservedBytes + bytes <= mBudget)
+	{
+		return true;
+	}
+
+	// Check there is enough to evict before evicting anything. Arrays loading are left alone as
+	// their new detail has already been budgeted from their current detail
+	size_t evictableBytes = 0;
+	for (unsigned int i = 0; i < mArrays.size(); ++i)
+	{
+		const TextureArray& array = mArrays[i];
+		if (static_cast<int>(i) != forArray && array.views[0] && !array.loading && array.residentMip < array.wantedMip)
+		{
+			evictableBytes += ArrayBytes( array, array.residentMip ) - ArrayBytes( array, array.wantedMip );
+		}
+	}
+	if (mResidentBytes + mReservedBytes + bytes > mBudget + evictableBytes)
+	{
+		return false;
+	}
+
+	while (mResidentBytes + mReservedBytes + bytes > mBudget)
+	{
+		int leastRecent = -1;
+		for (unsigned int i = 0; i < mArrays.size(); ++i)
+		{
+			const TextureArray& array = mArrays[i];
+			if (static_cast<int>(i) != forArray && array.views[0] && !array.loading && array.residentMip < array.wantedMip &&
+			    (leastRecent < 0 || array.lastUsedFrame < mArrays[leastRecent].lastUsedFrame))
+			{
+				leastRecent = i;
+			}
+		}
+		if (leastRecent < 0 || !Evict( mArrays[leastRecent], mArrays[leastRecent].wantedMip ))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Start loading the textures of the given array with levels from firstMip down on the background thread
+void TextureManager::StartLoad( int array, unsigned int firstMip, size_t reservedBytes )
+{
+	LoadJob job;
+	job.array = array;
+	for (unsigned int slice = 0; slice < mArrays[array].textures.size(); ++slice)
+	{
+		job.fileNames.push_back( mTextures[mArrays[array].textures[slice]].fileName );
+	}
+	job.type = mArrays[array].type;
+	job.firstMip = firstMip;
+	job.reservedBytes = reservedBytes;
+	job.success = false;
+
+	mArrays[array].loading = true;
+	mReservedBytes += reservedBytes;
+	++mLoadsInProgress;
+	{
+		lock_guard<mutex> lock( mLoadMutex );
+		mLoadQueue.push_back( move( job ) );
+	}
+	mLoadSignal.notify_one();
+}
+
+// Background thread function, loading queued texture files until the manager is destroyed. The
+// thread only touches the jobs, all Direct3D work is done by Update on the main thread
+void TextureManager::BackgroundLoad()
+{
+	for (;;)
+	{
+		LoadJob job;
+		{
+			unique_lock<mutex> lock( mLoadMutex );
+			mLoadSignal.wait( lock, [this]() { return mStopLoading || !mLoadQueue.empty(); } );
+			if (mStopLoading)
+			{
+				return;
+			}
+			job = move( mLoadQueue.front() );
+			mLoadQueue.pop_front();
+		}
+
+		// Prepare on this thread alone to leave the other cores to the game. Errors must not escape
+		// the thread, report them as a failed load
+		try
+		{
+			job.maps.resize( job.fileNames.size() * MAX_MAPS );
+			job.success = true;
+			for (size_t slice = 0; slice < job.fileNames.size() && job.success; ++slice)
+			{
+				Image source;
+				job.success = LoadImageFile( job.fileNames[slice], &source ) &&
+				              PrepareMaps( source, job.type, &job.maps[slice * MAX_MAPS], 1 );
+			}
+		}
+		catch (...)
+		{
+			job.success = false;
+		}
+
+		lock_guard<mutex> lock( mLoadMutex );
+		mFinishedLoads.push_back( move( job ) );
+	}
+}
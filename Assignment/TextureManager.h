@@ -0,0 +1,241 @@
+//--------------------------------------------------------------------------------------
+//	The texture manager keeps the scene's texture maps within a memory budget. Textures of the
+//	same size and format are packed into texture arrays, so models with different textures can
+//	be drawn without binding a new texture. Each array only has the mip levels its textures
+//	need on the GPU, decided by the on-screen size of the models using them. More detailed
+//	levels are streamed in from file on a background thread and the least recently used arrays
+//	give up their detail when the budget is full
+//--------------------------------------------------------------------------------------
+
+// Header guard - prevents this file being included more than once
+#ifndef CO2409_TEXTURE_MANAGER_H_INCLUDED
+#define CO2409_TEXTURE_MANAGER_H_INCLUDED
+
+#include <d3d10.h>
+#include "Image.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+class TextureManager
+{
+//-------------------------------------
+// Public types
+//-------------------------------------
+public:
+	// The kind of map in a texture file, which decides how it is prepared (see ImageCompress.h)
+	enum MapType
+	{
+		DiffuseSpecular, // A single BC1 or BC3 map
+		NormalDepth,     // A BC5 normal map (map 0) and BC4 depth map (map 1) split from one file
+	};
+
+
+//-------------------------------------
+// Public member functions
+//-------------------------------------
+public:
+
+	//-------------------------------------
+	// Constructors / Destructors
+
+	// Constructor - textures on the GPU are kept within the given number of bytes where possible.
+	// Mip levels no larger than tailSize are always kept, however full the budget
+	TextureManager( size_t budget, unsigned int tailSize = 64 );
+
+	// Destructor - stops any background loading and releases all textures
+	~TextureManager();
+
+
+	//-------------------------------------
+	// Texture loading
+
+	// Add a texture file of the given kind, returning an identifier for the texture. Adding the same
+	// file and kind again returns the same texture. All textures must be added before LoadAll
+	int Add( const string& fileName, MapType type );
+
+	// Load all added textures, with as much detail as fits in the budget. Files are loaded and
+	// prepared in parallel, then packed into texture arrays. Returns false if any file failed to load
+	bool LoadAll();
+
+
+	//-------------------------------------
+	// Streaming
+
+	// Request detail for a texture this frame. Give the distance in texture coordinates (UVs) that a
+	// single pixel covers where the texture is seen closest, or 0 for full detail. Call for every
+	// use of a texture in a frame, the largest detail requested is kept
+	void Request( int texture, float uvPerPixel );
+
+	// Update textures once per frame: use any newly loaded detail, then start loading the detail
+	// requested since the last update, making space in the budget if necessary. Returns false if a
+	// texture file failed to load in the background (the texture keeps the detail it has)
+	bool Update();
+
+
+	//-------------------------------------
+	// Usage
+
+	// Shader resource view of the texture array holding a texture's map, for normal/depth textures
+	// map 0 is the normal map and map 1 the depth map. Views change as detail is loaded or evicted
+	// so get them each frame. Returns NULL if the texture has not loaded
+	ID3D10ShaderResourceView* Map( int texture, int map = 0 );
+
+	// Slice of its texture array holding a texture
+	unsigned int Slice( int texture );
+
+	// Texture array holding a texture, -1 if the texture has not loaded. Textures in the same array
+	// share the same views, so drawing them one after another needs no new textures bound
+	int Array( int texture );
+
+	// Number of texture arrays the textures were packed into
+	unsigned int NumArrays()  { return static_cast<unsigned int>(mArrays.size()); }
+
+	// Bytes used by textures on the GPU, and the budget they are kept within
+	size_t ResidentBytes()  { return mResidentBytes; }
+	size_t Budget()         { return mBudget; }
+
+	// Most detailed mip level of a texture currently on the GPU (0 for full detail)
+	unsigned int ResidentMip( int texture );
+
+
+//-------------------------------------
+// Private types
+//-------------------------------------
+private:
+	// Maximum maps in a texture (for normal/depth textures)
+	static const int MAX_MAPS = 2;
+
+	// A texture file and where its maps are packed
+	struct Texture
+	{
+		string       fileName;
+		MapType      type;
+		int          array; // -1 until loaded
+		unsigned int slice;
+
+		// Smallest UVs per pixel requested since the last update
+		float        uvPerPixel;
+	};
+
+	// A texture array holding one or more textures of the same kind, size, format and mip levels
+	struct TextureArray
+	{
+		MapType      type;
+		unsigned int width;
+		unsigned int height;
+		unsigned int numMips;
+		unsigned int numMaps;
+		ImageFormat  formats[MAX_MAPS];
+
+		// Texture in each slice
+		vector<int>  textures;
+
+		// Views of the maps on the GPU, which hold mip levels from residentMip down. Levels from
+		// tailMip down are never evicted
+		ID3D10ShaderResourceView* views[MAX_MAPS];
+		unsigned int residentMip;
+		unsigned int tailMip;
+
+		// The most detailed level requested for any of the textures since the last update, and the
+		// frame one was last requested
+		unsigned int wantedMip;
+		unsigned int lastUsedFrame;
+
+		// Is more detail being streamed in, and has loading failed
+		bool         loading;
+		bool         failed;
+	};
+
+	// Texture files loading on the background thread, all the textures in one array. The bytes
+	// they need on the GPU are reserved in the budget until they are finished
+	struct LoadJob
+	{
+		int            array;
+		vector<string> fileNames;
+		MapType        type;
+		unsigned int   firstMip;
+		size_t         reservedBytes;
+		bool           success;
+		vector<Image>  maps; // Maps of each slice in turn
+	};
+
+
+//-------------------------------------
+// Private member functions
+//-------------------------------------
+private:
+	// Prevent copying
+	TextureManager( const TextureManager& );
+	TextureManager& operator=( const TextureManager& );
+
+	// Prepare the compressed maps with full mip chains for a loaded texture file
+	static bool PrepareMaps( const Image& source, MapType type, Image* maps, unsigned int numThreads );
+
+	// Add a texture to the array holding others of the same kind, size and formats, or a new array
+	// if there are none. The maps are the texture's prepared maps
+	void PackTexture( int texture, const Image* maps );
+
+	// Bytes on the GPU for all maps of an array with levels from firstMip down
+	size_t ArrayBytes( const TextureArray& array, unsigned int firstMip );
+
+	// Most detailed mip level needed when a pixel covers the given distance in texture coordinates
+	unsigned int MipForUVs( const TextureArray& array, float uvPerPixel );
+
+	// Create the views of an array from the prepared maps of each slice, with levels from firstMip
+	// down. Returns false if the textures could not be created
+	bool CreateViews( TextureArray& array, const vector<Image>& maps, unsigned int firstMip );
+
+	// Replace an array's views with new ones holding levels from firstMip down
+	void SetViews( TextureArray& array, ID3D10ShaderResourceView** views, unsigned int firstMip );
+
+	// Drop an array's levels above the given one by copying the rest into smaller textures on the
+	// GPU. Returns false if the new textures could not be created
+	bool Evict( TextureArray& array, unsigned int firstMip );
+
+	// Evict detail from other arrays until the given number of bytes fits in the budget. Only detail
+	// that arrays no longer need is evicted, least recently used arrays first. Returns false
+	// (evicting nothing) if there is not enough to evict
+	bool MakeSpace( size_t bytes, int forArray );
+
+	// Start loading the textures of the given array with levels from firstMip down on the background thread
+	void StartLoad( int array, unsigned int firstMip, size_t reservedBytes );
+
+	// Background thread function, loading queued texture files until the manager is destroyed
+	void BackgroundLoad();
+
+
+//-------------------------------------
+// Private member variables
+//-------------------------------------
+private:
+	vector<Texture>         mTextures;
+	vector<TextureArray>    mArrays;
+
+	// Budget and bytes used on the GPU. Bytes reserved for loads in progress count towards the budget
+	size_t                  mBudget;
+	size_t                  mResidentBytes;
+	size_t                  mReservedBytes;
+	unsigned int            mTailSize;
+
+	// Frame count from Update, for least recently used eviction
+	unsigned int            mFrame;
+
+	// Texture files are loaded and prepared on a background thread, one array at a time. Jobs are queued
+	// for the thread and returned finished to be picked up by Update on the main thread, which does
+	// all the Direct3D work
+	thread                  mLoadThread;
+	mutex                   mLoadMutex;
+	condition_variable      mLoadSignal;
+	deque<LoadJob>          mLoadQueue;
+	vector<LoadJob>         mFinishedLoads;
+	bool                    mStopLoading;
+	unsigned int            mLoadsInProgress;
+};
+
+
+#endif // End of header guard (see top of file)